@@ -3,4 +3,19 @@ LOCAL_PATH:= $(call my-dir)
 include $(LOCAL_PATH)/ie.mk
 include $(LOCAL_PATH)/graph-trans.mk
 include $(LOCAL_PATH)/myriad.mk
+include $(LOCAL_PATH)/compress-weights.mk
+include $(LOCAL_PATH)/blob-reference.mk
+include $(LOCAL_PATH)/compile-benchmark.mk
+include $(LOCAL_PATH)/executor-benchmark.mk
+include $(LOCAL_PATH)/async-request-benchmark.mk
+include $(LOCAL_PATH)/weights-load-benchmark.mk
+include $(LOCAL_PATH)/binary-network-benchmark.mk
+include $(LOCAL_PATH)/allocator-benchmark.mk
+include $(LOCAL_PATH)/network-clone-benchmark.mk
+include $(LOCAL_PATH)/blob-transform-benchmark.mk
+include $(LOCAL_PATH)/graph-traversal-benchmark.mk
+include $(LOCAL_PATH)/completion-queue-benchmark.mk
+include $(LOCAL_PATH)/gtest.mk
+include $(LOCAL_PATH)/graph-transformer-tests.mk
+include $(LOCAL_PATH)/inference-engine-tests.mk
 #include $(LOCAL_PATH)/prebuild.mk
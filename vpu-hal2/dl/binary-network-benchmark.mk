@@ -0,0 +1,26 @@
+LOCAL_PATH := $(call my-dir)
+include $(CLEAR_VARS)
+
+LOCAL_MODULE := vpu_binary_network_benchmark
+LOCAL_PROPRIETARY_MODULE := true
+LOCAL_MODULE_OWNER := intel
+LOCAL_MULTILIB := 64
+
+LOCAL_SRC_FILES := \
+	inference-engine/src/vpu/tools/binary_network_benchmark/main.cpp
+
+LOCAL_C_INCLUDES += \
+	$(LOCAL_PATH)/inference-engine/include \
+	$(LOCAL_PATH)/inference-engine/include/vpu \
+	$(LOCAL_PATH)/inference-engine/include/cpp \
+	$(LOCAL_PATH)/inference-engine/src/inference_engine \
+	$(LOCAL_PATH)/inference-engine/src/inference_engine/cpp_interfaces \
+	$(LOCAL_PATH)/inference-engine/src/vpu/tools/common
+
+LOCAL_CFLAGS += -std=c++11 -Wall -Wno-unknown-pragmas -Wno-strict-overflow -fPIC -Wformat -Wformat-security -fstack-protector-all
+LOCAL_CFLAGS += -Wno-unused-variable -Wno-unused-parameter -Wno-non-virtual-dtor -Wno-missing-field-initializers -fexceptions -frtti -Wno-error
+LOCAL_CFLAGS += -DIMPLEMENT_INFERENCE_ENGINE_API -std=gnu++11 -D_FORTIFY_SOURCE=2 -fPIE
+
+LOCAL_SHARED_LIBRARIES := libinference_engine liblog
+
+include $(BUILD_EXECUTABLE)
@@ -9,6 +9,7 @@ LOCAL_MULTILIB := both
 #LOCAL_MULTILIB := 64
 LOCAL_SRC_FILES := \
 	inference-engine/src/vpu/graph_transformer/graph_transformer_impl.cpp \
+	inference-engine/src/vpu/graph_transformer/reference_executor.cpp \
 	inference-engine/src/vpu/graph_transformer/hw/common.cpp \
 	inference-engine/src/vpu/graph_transformer/hw/convolution.cpp \
 	inference-engine/src/vpu/graph_transformer/hw/fc.cpp \
@@ -22,6 +23,7 @@ LOCAL_SRC_FILES := \
 	inference-engine/src/vpu/graph_transformer/optimizations/convert_order.cpp \
 	inference-engine/src/vpu/graph_transformer/optimizations/eliminate_copy.cpp \
 	inference-engine/src/vpu/graph_transformer/optimizations/eliminate_reshape.cpp \
+	inference-engine/src/vpu/graph_transformer/optimizations/fuse_stages.cpp \
 	inference-engine/src/vpu/graph_transformer/optimizations/pack_memory.cpp \
 	inference-engine/src/vpu/graph_transformer/optimizations/pack_postops.cpp \
 	inference-engine/src/vpu/graph_transformer/stages/batch_norm.cpp \
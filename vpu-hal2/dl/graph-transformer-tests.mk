@@ -0,0 +1,35 @@
+LOCAL_PATH := $(call my-dir)
+include $(CLEAR_VARS)
+
+LOCAL_MODULE := vpu_graph_transformer_tests
+LOCAL_PROPRIETARY_MODULE := true
+LOCAL_MODULE_OWNER := intel
+LOCAL_MULTILIB := 64
+
+LOCAL_SRC_FILES := \
+	inference-engine/src/vpu/tests/graph_transformer_tests/main.cpp \
+	inference-engine/src/vpu/tests/graph_transformer_tests/graph_transformer_test_utils.cpp \
+	inference-engine/src/vpu/tests/graph_transformer_tests/blob_data_tests.cpp \
+	inference-engine/src/vpu/tests/graph_transformer_tests/eliminate_copy_tests.cpp \
+	inference-engine/src/vpu/tests/graph_transformer_tests/fuse_stages_tests.cpp \
+	inference-engine/src/vpu/tests/graph_transformer_tests/optimizations_tests.cpp
+
+LOCAL_C_INCLUDES += \
+	$(LOCAL_PATH)/inference-engine/include \
+	$(LOCAL_PATH)/inference-engine/include/vpu \
+	$(LOCAL_PATH)/inference-engine/include/cpp \
+	$(LOCAL_PATH)/inference-engine/src/inference_engine \
+	$(LOCAL_PATH)/inference-engine/src/inference_engine/cpp_interfaces \
+	$(LOCAL_PATH)/inference-engine/src/vpu/common \
+	$(LOCAL_PATH)/inference-engine/src/vpu/graph_transformer \
+	$(LOCAL_PATH)/inference-engine/src/vpu/tools/common \
+	$(LOCAL_PATH)/inference-engine/thirdparty/mkl-dnn/tests/gtests
+
+LOCAL_CFLAGS += -std=c++11 -Wall -Wno-unknown-pragmas -Wno-strict-overflow -fPIC -Wformat -Wformat-security -fstack-protector-all
+LOCAL_CFLAGS += -Wno-unused-variable -Wno-unused-parameter -Wno-non-virtual-dtor -Wno-missing-field-initializers -fexceptions -frtti -Wno-error
+LOCAL_CFLAGS += -DENABLE_VPU -DENABLE_MYRIAD -DAKS -DIMPLEMENT_INFERENCE_ENGINE_API -std=gnu++11 -D_FORTIFY_SOURCE=2 -fPIE
+
+LOCAL_STATIC_LIBRARIES := libgraph_transformer libvpu_common libvpu_gtest
+LOCAL_SHARED_LIBRARIES := libinference_engine liblog
+
+include $(BUILD_EXECUTABLE)
@@ -0,0 +1,19 @@
+LOCAL_PATH := $(call my-dir)
+include $(CLEAR_VARS)
+
+LOCAL_MODULE := libvpu_gtest
+LOCAL_PROPRIETARY_MODULE := true
+LOCAL_MODULE_OWNER := intel
+LOCAL_MULTILIB := 64
+
+LOCAL_CPP_EXTENSION := .cc
+LOCAL_SRC_FILES := \
+	inference-engine/thirdparty/mkl-dnn/tests/gtests/gtest/src/gtest-all.cc
+
+LOCAL_C_INCLUDES += \
+	$(LOCAL_PATH)/inference-engine/thirdparty/mkl-dnn/tests/gtests \
+	$(LOCAL_PATH)/inference-engine/thirdparty/mkl-dnn/tests/gtests/gtest
+
+LOCAL_CFLAGS += -std=c++11 -Wall -fPIC -fexceptions -frtti -Wno-error -fPIE
+
+include $(BUILD_STATIC_LIBRARY)
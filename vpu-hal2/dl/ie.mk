@@ -10,22 +10,30 @@ LOCAL_MULTILIB := both
 LOCAL_SRC_FILES := \
 	inference-engine/src/inference_engine/ie_layers.cpp \
 	inference-engine/src/inference_engine/ade_util.cpp \
+	inference-engine/src/inference_engine/binary_format_parser.cpp \
 	inference-engine/src/inference_engine/blob_factory.cpp \
+	inference-engine/src/inference_engine/blob_transform.cpp \
 	inference-engine/src/inference_engine/cnn_network_impl.cpp \
 	inference-engine/src/inference_engine/cpp_interfaces/ie_executor_manager.cpp \
 	inference-engine/src/inference_engine/cpp_interfaces/ie_task.cpp \
 	inference-engine/src/inference_engine/cpp_interfaces/ie_task_executor.cpp \
 	inference-engine/src/inference_engine/cpp_interfaces/ie_task_with_stages.cpp \
+	inference-engine/src/inference_engine/cpp_interfaces/ie_work_stealing_executor.cpp \
 	inference-engine/src/inference_engine/file_utils.cpp \
 	inference-engine/src/inference_engine/graph_transformer.cpp \
 	inference-engine/src/inference_engine/ie_cnn_net_reader_impl.cpp \
+	inference-engine/src/inference_engine/ie_completion_queue.cpp \
 	inference-engine/src/inference_engine/ie_data.cpp \
 	inference-engine/src/inference_engine/ie_device.cpp \
 	inference-engine/src/inference_engine/ie_graph_splitter.cpp \
 	inference-engine/src/inference_engine/ie_layouts.cpp \
+	inference-engine/src/inference_engine/ie_trace.cpp \
 	inference-engine/src/inference_engine/ie_util_internal.cpp \
 	inference-engine/src/inference_engine/ie_utils.cpp \
 	inference-engine/src/inference_engine/ie_version.cpp \
+	inference-engine/src/inference_engine/indexed_graph.cpp \
+	inference-engine/src/inference_engine/mmap_allocator.cpp \
+	inference-engine/src/inference_engine/pool_allocator.cpp \
 	inference-engine/src/inference_engine/precision_utils.cpp \
 	inference-engine/src/inference_engine/system_alllocator.cpp \
 	inference-engine/src/inference_engine/v2_format_parser.cpp \
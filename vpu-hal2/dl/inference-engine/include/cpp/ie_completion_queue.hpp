@@ -0,0 +1,123 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @brief A header file for the completion queue wrapper class
+ * @file ie_completion_queue.hpp
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "ie_icompletion_queue.hpp"
+#include "cpp/ie_infer_request.hpp"
+#include "details/ie_exception_conversion.hpp"
+
+namespace InferenceEngine {
+
+/**
+ * @class CompletionQueue
+ * @brief Wrapper of ICompletionQueue, waits for the asynchronous inferences of the attached requests:
+ * @code
+ * CompletionQueue queue;
+ * for (auto &request : requests) {
+ *     queue.Attach(request);
+ *     request.StartAsync();
+ * }
+ * CompletionQueue::Completion completion;
+ * while (queue.WaitAny(completion)) {
+ *     // completion.request is ready for its next inference
+ * }
+ * @endcode
+ */
+class CompletionQueue {
+    ICompletionQueue::Ptr actual;
+
+public:
+    typedef ICompletionQueue::Completion Completion;
+    typedef std::shared_ptr<CompletionQueue> Ptr;
+
+    CompletionQueue() : actual(shared_from_irelease(CreateCompletionQueue())) {
+        if (!actual) THROW_IE_EXCEPTION << "Failed to create a completion queue";
+    }
+
+    /**
+     * @brief Attaches the request, see IInferRequest::SetCompletionQueue
+     */
+    void Attach(InferRequest &request) {
+        request.SetCompletionQueue(actual);
+    }
+
+    /**
+     * @brief Detaches the request, its inferences still running may push it to the queue
+     */
+    static void Detach(InferRequest &request) {
+        request.SetCompletionQueue(nullptr);
+    }
+
+    /**
+     * @brief Waits for a completion and takes it
+     * @param completion The completion taken
+     * @param millis_timeout Maximum duration in milliseconds to block for, see ICompletionQueue::WaitSome
+     * @return false if no completion was queued before the timeout
+     */
+    bool WaitAny(Completion &completion, int64_t millis_timeout = IInferRequest::WaitMode::RESULT_READY) {
+        size_t count = 0;
+        ResponseDesc resp;
+        auto res = actual->WaitSome(&completion, 1, count, millis_timeout, &resp);
+        if (res == RESULT_NOT_READY) return false;
+        if (res != OK) THROW_IE_EXCEPTION << resp.msg;
+        return true;
+    }
+
+    /**
+     * @brief Waits for completions and takes up to maxCount of them, in the order they completed
+     * @param maxCount Maximum number of completions to take
+     * @param millis_timeout Maximum duration in milliseconds to block for, see ICompletionQueue::WaitSome
+     * @return The completions taken, none if no completion was queued before the timeout
+     */
+    std::vector<Completion> WaitSome(size_t maxCount,
+                                     int64_t millis_timeout = IInferRequest::WaitMode::RESULT_READY) {
+        std::vector<Completion> completions(maxCount);
+        size_t count = 0;
+        ResponseDesc resp;
+        auto res = actual->WaitSome(completions.data(), maxCount, count, millis_timeout, &resp);
+        if (res != OK && res != RESULT_NOT_READY) THROW_IE_EXCEPTION << resp.msg;
+        completions.resize(count);
+        return completions;
+    }
+
+    /**
+     * @brief Pushes a completion of the application, see ICompletionQueue::Push
+     */
+    void Push(const IInferRequest::Ptr &request, StatusCode status) {
+        CALL_STATUS_FNC(Push, request, status);
+    }
+
+    /**
+     * @brief Number of the completions queued and not taken yet
+     */
+    size_t Size() const {
+        return actual->Size();
+    }
+
+    /**
+     * @brief ICompletionQueue pointer to be used directly in IInferRequest::SetCompletionQueue
+     */
+    operator ICompletionQueue::Ptr &() {
+        return actual;
+    }
+};
+
+}  // namespace InferenceEngine
@@ -176,6 +176,14 @@ public:
         actual->SetCompletionCallback(callWrapper);
     }
 
+    /**
+     * @brief Attaches the request to a completion queue, see IInferRequest::SetCompletionQueue
+     * @param queue The queue, nullptr detaches the request
+     */
+    void SetCompletionQueue(const std::shared_ptr<ICompletionQueue> &queue) {
+        CALL_STATUS_FNC(SetCompletionQueue, queue);
+    }
+
     /**
      * @brief  IInferRequest pointer to be used directly in CreateInferRequest functions
      */
@@ -67,6 +67,8 @@ public:
     /**
      * @brief Loads and sets the weights buffer directly from the IR .bin file.
      * This method can be called more than once to reflect updates in the .bin.
+     * With IE_MMAP_WEIGHTS=1 in the environment the file is mapped instead of read, it must not be rewritten
+     * or truncated while the network lives then.
      * @param filepath Full path to the .bin file
      * @param resp Response message
      * @return Result code
@@ -0,0 +1,87 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @brief a header file for ICompletionQueue interface
+ * @file ie_icompletion_queue.hpp
+ */
+
+#pragma once
+
+#include "ie_common.h"
+#include "ie_api.h"
+#include "ie_iinfer_request.hpp"
+#include <details/ie_irelease.hpp>
+#include <memory>
+
+namespace InferenceEngine {
+
+/**
+ * @class ICompletionQueue
+ * @brief Queue of the completed asynchronous inferences of the requests attached to it,
+ * see IInferRequest::SetCompletionQueue. One thread can wait for any of hundreds of requests:
+ * a completion wakes one waiter, whatever the number of requests attached
+ */
+class ICompletionQueue : public details::IRelease {
+public:
+    typedef std::shared_ptr<ICompletionQueue> Ptr;
+
+    /**
+     * @brief A completed inference
+     */
+    struct Completion {
+        // the request, ready for the next inference
+        IInferRequest::Ptr request;
+        // OK, or the error of the inference, IInferRequest::Wait gives its message
+        StatusCode status;
+    };
+
+    /**
+     * @brief Pushes a completion, called by the requests attached to the queue when their inferences complete.
+     * The application may push its own, e.g. with a null request to wake a waiter
+     * @param request The completed request
+     * @param status Status of the inference
+     * @param resp Optional: a pointer to an already allocated object to contain extra information of a failure (if occurred)
+     * @return Enumeration of the resulted action: OK (0) for success
+     */
+    virtual StatusCode Push(const IInferRequest::Ptr &request, StatusCode status, ResponseDesc *resp) noexcept = 0;
+
+    /**
+     * @brief Waits for completions and takes up to maxCount of them, in the order they completed.
+     * Blocks until a completion is queued or millis_timeout has elapsed, whichever comes first
+     * @param completions Array of maxCount completions to fill
+     * @param maxCount Maximum number of completions to take, at least 1
+     * @param count Number of the completions taken
+     * @param millis_timeout Maximum duration in milliseconds to block for, or a value of IInferRequest::WaitMode:
+     * * STATUS_ONLY - takes the queued completions without blocking
+     * * RESULT_READY - blocks until a completion is queued
+     * @param resp Optional: a pointer to an already allocated object to contain extra information of a failure (if occurred)
+     * @return OK (0) if completions were taken, RESULT_NOT_READY if none was queued before the timeout
+     */
+    virtual StatusCode WaitSome(Completion *completions, size_t maxCount, size_t &count, int64_t millis_timeout,
+                                ResponseDesc *resp) noexcept = 0;
+
+    /**
+     * @brief Number of the completions queued and not taken yet
+     */
+    virtual size_t Size() const noexcept = 0;
+};
+
+/**
+ * @brief Creates an empty completion queue
+ * @return The completion queue, to release with Release()
+ */
+INFERENCE_ENGINE_API(ICompletionQueue*) CreateCompletionQueue() noexcept;
+
+}  // namespace InferenceEngine
@@ -28,6 +28,8 @@
 
 namespace InferenceEngine {
 
+class ICompletionQueue;
+
 /**
  * @class IInferRequest
  * @brief This is an interface of asynchronous infer request
@@ -131,6 +133,16 @@ public:
      * @return Enumeration of the resulted action: OK (0) for success
      */
     virtual StatusCode SetUserData(void *data, ResponseDesc *resp) noexcept = 0;
+
+    /**
+     * @brief Attaches the request to a completion queue: each asynchronous inference of the request pushes it
+     * to the queue when it completes, successfully or not, after the completion callback if one is set
+     * @param queue The queue, replaces the one attached before. It is held weakly, the completions are dropped
+     * once it is released. nullptr detaches the request
+     * @param resp Optional: a pointer to an already allocated object to contain extra information of a failure (if occurred)
+     * @return Enumeration of the resulted action: OK (0) for success
+     */
+    virtual StatusCode SetCompletionQueue(const std::shared_ptr<ICompletionQueue> &queue, ResponseDesc *resp) noexcept = 0;
 };
 
 }  // namespace InferenceEngine
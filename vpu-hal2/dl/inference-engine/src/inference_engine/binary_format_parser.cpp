@@ -0,0 +1,592 @@
+﻿//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <functional>
+#include <pugixml.hpp>
+#include "binary_format_parser.h"
+#include "xml_parse_utils.h"
+
+using namespace InferenceEngine;
+using namespace InferenceEngine::details;
+
+const char BinaryFormatParser::MAGIC[4] = {'I', 'E', 'B', 'N'};
+const uint32_t BinaryFormatParser::FORMAT_VERSION;
+
+namespace {
+
+class BinaryWriter {
+public:
+    explicit BinaryWriter(std::vector<uint8_t>& data) : _data(data) {}
+
+    template<typename T>
+    void operator()(const T& value) {
+        auto bytes = reinterpret_cast<const uint8_t*>(&value);
+        _data.insert(_data.end(), bytes, bytes + sizeof(T));
+    }
+
+    template<typename T>
+    void operator()(const std::vector<T>& values) {
+        (*this)(static_cast<uint32_t>(values.size()));
+        for (const auto& value : values) {
+            (*this)(value);
+        }
+    }
+
+    void operator()(const std::string& value) {
+        (*this)(static_cast<uint32_t>(value.size()));
+        _data.insert(_data.end(), value.begin(), value.end());
+    }
+
+    void operator()(const Precision& precision) {
+        (*this)(static_cast<int32_t>(static_cast<Precision::ePrecision>(precision)));
+    }
+
+private:
+    std::vector<uint8_t>& _data;
+};
+
+// The fewest bytes a value takes in a binary network
+template<typename T>
+size_t encodedSize(const T*) { return sizeof(T); }
+template<typename T>
+size_t encodedSize(const std::vector<T>*) { return sizeof(uint32_t); }
+inline size_t encodedSize(const std::string*) { return sizeof(uint32_t); }
+inline size_t encodedSize(const Precision*) { return sizeof(int32_t); }
+
+class BinaryReader {
+public:
+    BinaryReader(const uint8_t* data, size_t size) : _data(data), _size(size) {}
+
+    template<typename T>
+    void operator()(T& value) {
+        check(sizeof(T));
+        std::memcpy(&value, _data + _offset, sizeof(T));
+        _offset += sizeof(T);
+    }
+
+    template<typename T>
+    void operator()(std::vector<T>& values) {
+        values.resize(readCount(encodedSize(static_cast<const T*>(nullptr))));
+        for (auto& value : values) {
+            (*this)(value);
+        }
+    }
+
+    void operator()(std::string& value) {
+        auto size = read<uint32_t>();
+        check(size);
+        value.assign(reinterpret_cast<const char*>(_data + _offset), size);
+        _offset += size;
+    }
+
+    void operator()(Precision& precision) {
+        precision = static_cast<Precision::ePrecision>(read<int32_t>());
+    }
+
+    template<typename T>
+    T read() {
+        T value;
+        (*this)(value);
+        return value;
+    }
+
+    // A count of the elements that follow, checked against the bytes left so that a corrupt
+    // count fails before anything is allocated for it
+    uint32_t readCount(size_t elementSize) {
+        auto offset = _offset;
+        auto count = read<uint32_t>();
+        if (count > (_size - _offset) / elementSize)
+            THROW_IE_EXCEPTION << "binary network has a count of " << count << " at offset " << offset
+                               << " that exceeds its size";
+        return count;
+    }
+
+    size_t offset() const {
+        return _offset;
+    }
+
+private:
+    void check(size_t size) const {
+        if (size > _size - _offset)
+            THROW_IE_EXCEPTION << "binary network is truncated at offset " << _offset;
+    }
+
+    const uint8_t* _data;
+    size_t _size;
+    size_t _offset = 0;
+};
+
+// The typed fields the creators of V2FormatParser parse, read and written by the same Visit
+template<class LT>
+struct LayerFields {
+    template<class Archive>
+    static void Visit(LT& layer, Archive& archive) {}
+};
+
+template<>
+struct LayerFields<PowerLayer> {
+    template<class Archive>
+    static void Visit(PowerLayer& layer, Archive& archive) {
+        archive(layer.offset);
+        archive(layer.power);
+        archive(layer.scale);
+    }
+};
+
+template<>
+struct LayerFields<ConvolutionLayer> {
+    template<class Archive>
+    static void Visit(ConvolutionLayer& layer, Archive& archive) {
+        archive(layer._out_depth);
+        archive(layer._kernel_x);
+        archive(layer._kernel_y);
+        archive(layer._stride_x);
+        archive(layer._stride_y);
+        archive(layer._padding_x);
+        archive(layer._padding_y);
+        archive(layer._dilation_x);
+        archive(layer._dilation_y);
+        archive(layer._group);
+    }
+};
+
+template<>
+struct LayerFields<DeconvolutionLayer> {
+    template<class Archive>
+    static void Visit(DeconvolutionLayer& layer, Archive& archive) {
+        archive(layer._out_depth);
+        archive(layer._kernel_x);
+        archive(layer._kernel_y);
+        archive(layer._stride_x);
+        archive(layer._stride_y);
+        archive(layer._padding_x);
+        archive(layer._padding_y);
+        archive(layer._dilation_x);
+        archive(layer._dilation_y);
+        archive(layer._group);
+    }
+};
+
+template<>
+struct LayerFields<PoolingLayer> {
+    template<class Archive>
+    static void Visit(PoolingLayer& layer, Archive& archive) {
+        archive(layer._kernel_x);
+        archive(layer._kernel_y);
+        archive(layer._stride_x);
+        archive(layer._stride_y);
+        archive(layer._padding_x);
+        archive(layer._padding_y);
+        archive(layer._type);
+        archive(layer._exclude_pad);
+    }
+};
+
+template<>
+struct LayerFields<FullyConnectedLayer> {
+    template<class Archive>
+    static void Visit(FullyConnectedLayer& layer, Archive& archive) {
+        archive(layer._out_num);
+    }
+};
+
+template<>
+struct LayerFields<NormLayer> {
+    template<class Archive>
+    static void Visit(NormLayer& layer, Archive& archive) {
+        archive(layer._size);
+        archive(layer._k);
+        archive(layer._alpha);
+        archive(layer._beta);
+        archive(layer._isAcrossMaps);
+    }
+};
+
+template<>
+struct LayerFields<SoftMaxLayer> {
+    template<class Archive>
+    static void Visit(SoftMaxLayer& layer, Archive& archive) {
+        archive(layer.axis);
+    }
+};
+
+template<>
+struct LayerFields<ReLULayer> {
+    template<class Archive>
+    static void Visit(ReLULayer& layer, Archive& archive) {
+        archive(layer.negative_slope);
+    }
+};
+
+#ifdef AKS
+template<>
+struct LayerFields<TanHLayer> {
+    template<class Archive>
+    static void Visit(TanHLayer& layer, Archive& archive) {
+        archive(layer.negative_slope);
+    }
+};
+
+template<>
+struct LayerFields<SigmoidLayer> {
+    template<class Archive>
+    static void Visit(SigmoidLayer& layer, Archive& archive) {
+        archive(layer.negative_slope);
+    }
+};
+#endif
+
+template<>
+struct LayerFields<ClampLayer> {
+    template<class Archive>
+    static void Visit(ClampLayer& layer, Archive& archive) {
+        archive(layer.min_value);
+        archive(layer.max_value);
+    }
+};
+
+template<>
+struct LayerFields<SplitLayer> {
+    template<class Archive>
+    static void Visit(SplitLayer& layer, Archive& archive) {
+        archive(layer._axis);
+    }
+};
+
+template<>
+struct LayerFields<ConcatLayer> {
+    template<class Archive>
+    static void Visit(ConcatLayer& layer, Archive& archive) {
+        archive(layer._axis);
+    }
+};
+
+template<>
+struct LayerFields<EltwiseLayer> {
+    template<class Archive>
+    static void Visit(EltwiseLayer& layer, Archive& archive) {
+        archive(layer._operation);
+        archive(layer.coeff);
+    }
+};
+
+template<>
+struct LayerFields<ScaleShiftLayer> {
+    template<class Archive>
+    static void Visit(ScaleShiftLayer& layer, Archive& archive) {
+        archive(layer._broadcast);
+    }
+};
+
+template<>
+struct LayerFields<CropLayer> {
+    template<class Archive>
+    static void Visit(CropLayer& layer, Archive& archive) {
+        archive(layer.axis);
+        archive(layer.offset);
+        archive(layer.dim);
+    }
+};
+
+template<>
+struct LayerFields<ReshapeLayer> {
+    template<class Archive>
+    static void Visit(ReshapeLayer& layer, Archive& archive) {
+        archive(layer.shape);
+        archive(layer.axis);
+        archive(layer.num_axes);
+    }
+};
+
+template<>
+struct LayerFields<TileLayer> {
+    template<class Archive>
+    static void Visit(TileLayer& layer, Archive& archive) {
+        archive(layer.axis);
+        archive(layer.tiles);
+    }
+};
+
+template<>
+struct LayerFields<BatchNormalizationLayer> {
+    template<class Archive>
+    static void Visit(BatchNormalizationLayer& layer, Archive& archive) {
+        archive(layer.epsilon);
+    }
+};
+
+struct LayerKind {
+    std::function<CNNLayer*(const LayerParams&)> create;
+    std::function<void(CNNLayer&, BinaryWriter&)> write;
+    std::function<void(CNNLayer&, BinaryReader&)> read;
+};
+
+template<class LT>
+LayerKind layerKind() {
+    auto cast = [](CNNLayer& layer) -> LT& {
+        auto typed = dynamic_cast<LT*>(&layer);
+        if (!typed) THROW_IE_EXCEPTION << "Layer " << layer.name << " of type " << layer.type << " has a wrong class";
+        return *typed;
+    };
+    return {
+        [](const LayerParams& prms) { return new LT(prms); },
+        [cast](CNNLayer& layer, BinaryWriter& writer) { LayerFields<LT>::Visit(cast(layer), writer); },
+        [cast](CNNLayer& layer, BinaryReader& reader) { LayerFields<LT>::Visit(cast(layer), reader); }
+    };
+}
+
+// The classes of the types, as V2FormatParser::getCreators creates them
+const LayerKind& getLayerKind(const std::string& type) {
+    static const std::map<std::string, LayerKind> kinds = {
+            {"Power", layerKind<PowerLayer>()},
+            {"Convolution", layerKind<ConvolutionLayer>()},
+            {"Deconvolution", layerKind<DeconvolutionLayer>()},
+            {"Pooling", layerKind<PoolingLayer>()},
+            {"InnerProduct", layerKind<FullyConnectedLayer>()},
+            {"FullyConnected", layerKind<FullyConnectedLayer>()},
+            {"LRN", layerKind<NormLayer>()},
+            {"Norm", layerKind<NormLayer>()},
+            {"Softmax", layerKind<SoftMaxLayer>()},
+            {"SoftMax", layerKind<SoftMaxLayer>()},
+            {"ReLU", layerKind<ReLULayer>()},
+#ifdef AKS
+            {"TanH", layerKind<TanHLayer>()},
+            {"Sigmoid", layerKind<SigmoidLayer>()},
+#endif
+            {"Clamp", layerKind<ClampLayer>()},
+            {"Split", layerKind<SplitLayer>()},
+            {"Slice", layerKind<SplitLayer>()},
+            {"Concat", layerKind<ConcatLayer>()},
+            {"Eltwise", layerKind<EltwiseLayer>()},
+            {"ScaleShift", layerKind<ScaleShiftLayer>()},
+            {"Crop", layerKind<CropLayer>()},
+            {"Reshape", layerKind<ReshapeLayer>()},
+            {"Tile", layerKind<TileLayer>()},
+            {"BatchNormalization", layerKind<BatchNormalizationLayer>()},
+    };
+    static const LayerKind genericKind = layerKind<GenericLayer>();
+
+    auto kind = kinds.find(type);
+    return kind == kinds.end() ? genericKind : kind->second;
+}
+
+template<class Archive>
+void visitPort(LayerParseParameters::LayerPortData& port, Archive& archive) {
+    archive(port.portId);
+    archive(port.precision);
+    archive(port.dims);
+}
+
+template<class Archive>
+void visitSegment(WeightSegment& segment, Archive& archive) {
+    archive(segment.precision);
+    archive(segment.start);
+    archive(segment.size);
+}
+
+// The bytes visitPort reads at least, visitSegment and a pre-process channel read exactly
+const size_t minPortSize = sizeof(int) + sizeof(int32_t) + sizeof(uint32_t);
+const size_t segmentSize = sizeof(int32_t) + 2 * sizeof(size_t);
+const size_t channelSize = 2 * sizeof(float) + segmentSize;
+
+}  // namespace
+
+BinaryFormatParser::BinaryFormatParser() : V2FormatParser(2) {}
+
+bool BinaryFormatParser::IsBinaryNetwork(const void* data, size_t size) {
+    return size >= sizeof(MAGIC) && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+CNNNetworkImplPtr BinaryFormatParser::Parse(const void* data, size_t size) {
+    if (!IsBinaryNetwork(data, size)) THROW_IE_EXCEPTION << "not a binary network";
+    BinaryReader reader(static_cast<const uint8_t*>(data) + sizeof(MAGIC), size - sizeof(MAGIC));
+    auto version = reader.read<uint32_t>();
+    if (version != FORMAT_VERSION)
+        THROW_IE_EXCEPTION << "cannot parse binary network version " << version << ", expected " << FORMAT_VERSION;
+
+    auto name = reader.read<std::string>();
+    auto precision = reader.read<Precision>();
+    BeginNetwork(name, precision);
+
+    auto layers = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < layers; i++) {
+        auto location = "offset " + std::to_string(reader.offset() + sizeof(MAGIC));
+        LayerParseParameters lprms;
+        reader(lprms.layerId);
+        reader(lprms.prms.type);
+        reader(lprms.prms.name);
+        reader(lprms.prms.precision);
+        for (auto ports : {&lprms.inputPorts, &lprms.outputPorts}) {
+            ports->resize(reader.readCount(minPortSize));
+            for (auto& port : *ports) {
+                visitPort(port, reader);
+            }
+        }
+        auto segments = reader.read<uint32_t>();
+        for (uint32_t s = 0; s < segments; s++) {
+            auto segmentName = reader.read<std::string>();
+            visitSegment(lprms.blobs[segmentName], reader);
+        }
+
+        const auto& kind = getLayerKind(lprms.prms.type);
+        CNNLayer::Ptr layer(kind.create(lprms.prms));
+        auto params = reader.read<uint32_t>();
+        for (uint32_t p = 0; p < params; p++) {
+            auto key = reader.read<std::string>();
+            reader(layer->params[key]);
+        }
+        kind.read(*layer, reader);
+
+        AddLayer(layer, lprms, location);
+    }
+
+    auto edges = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < edges; i++) {
+        auto location = "offset " + std::to_string(reader.offset() + sizeof(MAGIC));
+        LayerEdge edge;
+        reader(edge.fromLayer);
+        reader(edge.fromPort);
+        reader(edge.toLayer);
+        reader(edge.toPort);
+        AddEdge(edge, location);
+    }
+
+    SetInputLayers();
+    ValidateLayers();
+
+    auto preProcesses = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < preProcesses; i++) {
+        auto inputName = reader.read<std::string>();
+        auto input = _network->getInput(inputName);
+        if (!input) THROW_IE_EXCEPTION << "pre-process name ref '" << inputName << "' refers to un-existing input";
+        PreProcessInfo& pp = input->getPreProcess();
+        auto& segments = _preProcessSegments[inputName];
+        pp.init(reader.readCount(channelSize));
+        segments.resize(pp.getNumberOfChannels());
+        for (size_t c = 0; c < segments.size(); c++) {
+            reader(pp[c]->meanValue);
+            reader(pp[c]->stdScale);
+            visitSegment(segments[c], reader);
+        }
+        pp.setVariant(static_cast<MeanVariant>(reader.read<int32_t>()));
+    }
+
+    ResolveOutputs();
+    return _network;
+}
+
+void BinaryFormatParser::Write(const V2FormatParser& parser, std::vector<uint8_t>& data) {
+    if (parser._version != 2) THROW_IE_EXCEPTION << "cannot write IR version " << parser._version << " as binary";
+    if (!parser._network) THROW_IE_EXCEPTION << "network must be parsed first";
+
+    BinaryWriter writer(data);
+    data.insert(data.end(), MAGIC, MAGIC + sizeof(MAGIC));
+    writer(FORMAT_VERSION);
+    writer(parser._network->getName());
+    writer(parser._defPrecision);
+
+    writer(static_cast<uint32_t>(parser._layerIds.size()));
+    for (auto id : parser._layerIds) {
+        auto& layer = *parser._layerById.at(id);
+        auto lprms = parser.layersParseInfo.at(layer.name);
+        writer(lprms.layerId);
+        writer(lprms.prms.type);
+        writer(lprms.prms.name);
+        writer(lprms.prms.precision);
+        for (auto ports : {&lprms.inputPorts, &lprms.outputPorts}) {
+            writer(static_cast<uint32_t>(ports->size()));
+            for (auto& port : *ports) {
+                visitPort(port, writer);
+            }
+        }
+        writer(static_cast<uint32_t>(lprms.blobs.size()));
+        for (auto& segment : lprms.blobs) {
+            writer(segment.first);
+            visitSegment(segment.second, writer);
+        }
+
+        writer(static_cast<uint32_t>(layer.params.size()));
+        for (const auto& param : layer.params) {
+            writer(param.first);
+            writer(param.second);
+        }
+        getLayerKind(layer.type).write(layer, writer);
+    }
+
+    writer(static_cast<uint32_t>(parser._edges.size()));
+    for (const auto& edge : parser._edges) {
+        writer(edge.fromLayer);
+        writer(edge.fromPort);
+        writer(edge.toLayer);
+        writer(edge.toPort);
+    }
+
+    writer(static_cast<uint32_t>(parser._preProcessSegments.size()));
+    for (auto& kvp : parser._preProcessSegments) {
+        auto input = parser._network->getInput(kvp.first);
+        if (!input) THROW_IE_EXCEPTION << "Internal error: missing input name " << kvp.first;
+        const PreProcessInfo& pp = input->getPreProcess();
+        auto segments = kvp.second;
+        writer(static_cast<uint32_t>(segments.size()));
+        for (size_t c = 0; c < segments.size(); c++) {
+            writer(pp[c]->meanValue);
+            writer(pp[c]->stdScale);
+            visitSegment(segments[c], writer);
+        }
+        writer(static_cast<int32_t>(pp.getMeanVariant()));
+    }
+}
+
+INFERENCE_ENGINE_API_CPP(void) ConvertToBinaryNetwork(const std::string& xmlPath, const std::string& binaryPath) {
+    pugi::xml_document xmlDoc;
+    pugi::xml_parse_result res = xmlDoc.load_file(xmlPath.c_str());
+    if (res.status != pugi::status_ok)
+        THROW_IE_EXCEPTION << "Error loading xmlfile: " << xmlPath << ", " << res.description();
+
+    pugi::xml_node root = xmlDoc.document_element();
+    int version = XMLParseUtils::GetIntAttr(root, "version", 0);
+    if (version != 2) THROW_IE_EXCEPTION << "cannot convert IR version " << version << ", only IR v2";
+
+    V2FormatParser parser(version);
+    parser.Parse(root);
+
+    std::vector<uint8_t> data;
+    BinaryFormatParser::Write(parser, data);
+
+    std::ofstream file(binaryPath, std::ios::binary);
+    if (!file.write(reinterpret_cast<const char*>(data.data()), data.size()))
+        THROW_IE_EXCEPTION << "cannot write " << binaryPath;
+}
@@ -0,0 +1,75 @@
+﻿//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ie_api.h"
+#include "v2_format_parser.h"
+
+namespace InferenceEngine {
+namespace details {
+
+/**
+ * @brief Reads a binary IR, written by ConvertToBinaryNetwork from an XML IR v2.
+ * The binary IR keeps what V2FormatParser gets out of the XML: the layers with their ports, params, typed
+ * fields and weight segments, the edges and the pre-process, already converted from strings. The network
+ * is built by the same steps as from the XML, and the weights are the .bin file of the XML IR.
+ * Numbers are in the byte order of the host, the binary IR is not portable between byte orders.
+ */
+class BinaryFormatParser : public V2FormatParser {
+public:
+    static const char MAGIC[4];
+    static const uint32_t FORMAT_VERSION = 1;
+
+    BinaryFormatParser();
+
+    static bool IsBinaryNetwork(const void* data, size_t size);
+
+    using V2FormatParser::Parse;
+
+    CNNNetworkImplPtr Parse(const void* data, size_t size);
+
+    /**
+     * @brief Serializes the network parser has parsed from an XML IR v2
+     */
+    static void Write(const V2FormatParser& parser, std::vector<uint8_t>& data);
+};
+
+}  // namespace details
+}  // namespace InferenceEngine
+
+/**
+ * @brief Converts an XML IR v2 to a binary IR, the binary IR uses the weights of the XML IR
+ */
+INFERENCE_ENGINE_API_CPP(void) ConvertToBinaryNetwork(const std::string& xmlPath, const std::string& binaryPath);
@@ -0,0 +1,888 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+#include "blob_transform.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <details/ie_exception.hpp>
+#include "precision_utils.h"
+
+#if defined(__SSE4_2__)
+#include <immintrin.h>
+#define BLOB_TRANSFORM_SSE42
+// built with the target attribute, run if the CPU supports AVX2
+#if defined(__GNUC__) || defined(__clang__)
+#define BLOB_TRANSFORM_AVX2
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace InferenceEngine {
+
+namespace BlobTransform {
+
+namespace {
+
+// Tile of all the channels and TILE_BYTES / channels / 4 pixels, in the cache between the transposes
+const size_t TILE_BYTES = 32 * 1024;
+const size_t TILE_PIXELS_ALIGNMENT = 64;
+
+// Converts n elements: dst = (src - mean) * scale
+typedef void (*RowFn)(const void* src, void* dst, size_t n, float mean, float scale);
+// dst[p * stride + r] = rows[r][p], r < nrows, p < len
+typedef void (*InterleaveFn)(const void* const* rows, size_t nrows, size_t len, void* dst, size_t stride);
+// rows[r][p] = src[p * stride + r], r < nrows, p < len
+typedef void (*DeinterleaveFn)(const void* src, size_t stride, size_t nrows, size_t len, void* const* rows);
+
+struct Kernels {
+    RowFn u8ToF16;
+    RowFn u8ToF32;
+    RowFn f32ToF16;
+    RowFn f32ToF32;
+    // by element size 1, 2, 4
+    InterleaveFn interleave[3];
+    DeinterleaveFn deinterleave[3];
+};
+
+//
+// Scalar kernels, the reference of the others. FP16 is stored as uint16_t
+//
+
+inline float toFloat(uint8_t value) {
+    return static_cast<float>(value);
+}
+
+inline float toFloat(uint16_t value) {
+    return PrecisionUtils::f16tof32(static_cast<ie_fp16>(value));
+}
+
+inline float toFloat(float value) {
+    return value;
+}
+
+template <typename T> T fromFloat(float value);
+
+template <> inline uint16_t fromFloat<uint16_t>(float value) {
+    return static_cast<uint16_t>(PrecisionUtils::f32tof16(value));
+}
+
+template <> inline float fromFloat<float>(float value) {
+    return value;
+}
+
+template <typename S, typename D>
+void convertRowScalar(const void* src, void* dst, size_t n, float mean, float scale) {
+    auto s = static_cast<const S*>(src);
+    auto d = static_cast<D*>(dst);
+    for (size_t i = 0; i < n; ++i) {
+        d[i] = fromFloat<D>((toFloat(s[i]) - mean) * scale);
+    }
+}
+
+template <typename T>
+void interleaveScalar(const void* const* rows, size_t r0, size_t r1, size_t p0, size_t p1, void* dst, size_t stride) {
+    auto d = static_cast<T*>(dst);
+    for (size_t p = p0; p < p1; ++p) {
+        for (size_t r = r0; r < r1; ++r) {
+            d[p * stride + r] = static_cast<const T*>(rows[r])[p];
+        }
+    }
+}
+
+template <typename T>
+void deinterleaveScalar(const void* src, size_t stride, size_t r0, size_t r1, size_t p0, size_t p1, void* const* rows) {
+    auto s = static_cast<const T*>(src);
+    for (size_t r = r0; r < r1; ++r) {
+        auto row = static_cast<T*>(rows[r]);
+        for (size_t p = p0; p < p1; ++p) {
+            row[p] = s[p * stride + r];
+        }
+    }
+}
+
+template <typename T>
+void interleaveScalar(const void* const* rows, size_t nrows, size_t len, void* dst, size_t stride) {
+    interleaveScalar<T>(rows, 0, nrows, 0, len, dst, stride);
+}
+
+template <typename T>
+void deinterleaveScalar(const void* src, size_t stride, size_t nrows, size_t len, void* const* rows) {
+    deinterleaveScalar<T>(src, stride, 0, nrows, 0, len, rows);
+}
+
+const Kernels SCALAR_KERNELS = {
+    convertRowScalar<uint8_t, uint16_t>,
+    convertRowScalar<uint8_t, float>,
+    convertRowScalar<float, uint16_t>,
+    convertRowScalar<float, float>,
+    {interleaveScalar<uint8_t>, interleaveScalar<uint16_t>, interleaveScalar<uint32_t>},
+    {deinterleaveScalar<uint8_t>, deinterleaveScalar<uint16_t>, deinterleaveScalar<uint32_t>},
+};
+
+#ifdef BLOB_TRANSFORM_SSE42
+
+//
+// SSE4.2 kernels
+//
+
+// PrecisionUtils::f32tof16 of 4 values, in the low halves of the 32 bit lanes
+inline __m128i f32ToF16Sse(__m128 x) {
+    const __m128i v = _mm_castps_si128(x);
+    const __m128i expMask = _mm_set1_epi32(0x7F800000);
+    const __m128i s = _mm_and_si128(_mm_srli_epi32(v, 16), _mm_set1_epi32(0x8000));
+    const __m128i a = _mm_and_si128(v, _mm_set1_epi32(0x7FFFFFFF));
+    const __m128i exp = _mm_and_si128(a, expMask);
+
+    // round to nearest by adding a half of the f16 ULP
+    const __m128 halfUlp = _mm_mul_ps(_mm_castsi128_ps(exp), _mm_castsi128_ps(_mm_set1_epi32((127 - 11) << 23)));
+    const __m128 f = _mm_add_ps(_mm_castsi128_ps(a), halfUlp);
+    __m128i r = _mm_or_si128(_mm_srli_epi32(_mm_sub_epi32(_mm_castps_si128(f), _mm_set1_epi32((127 - 15) << 23)), 13), s);
+
+    const __m128 min16 = _mm_castsi128_ps(_mm_set1_epi32((127 - 14) << 23));
+    const __m128 max16 = _mm_castsi128_ps(_mm_set1_epi32(((127 + 15) << 23) | 0x007FE000));
+    r = _mm_blendv_epi8(r, _mm_or_si128(s, _mm_set1_epi32(((15 + 15) << 10) | 0x3FF)),
+                        _mm_castps_si128(_mm_cmpge_ps(f, max16)));
+    r = _mm_blendv_epi8(r, _mm_or_si128(s, _mm_set1_epi32(1 << 10)), _mm_castps_si128(_mm_cmplt_ps(f, min16)));
+    r = _mm_blendv_epi8(r, s, _mm_castps_si128(_mm_cmplt_ps(f, _mm_mul_ps(min16, _mm_set1_ps(0.5f)))));
+
+    // NAN and INF, truncated to 16 bits like the scalar conversion
+    const __m128i isNan = _mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(a, _mm_set1_epi32(0x007FFFFF)),
+                                                           _mm_setzero_si128()), _mm_set1_epi32(-1));
+    const __m128i nanInf = _mm_or_si128(_mm_or_si128(s, _mm_srli_epi32(a, 23 - 10)),
+                                        _mm_and_si128(isNan, _mm_set1_epi32(0x0200)));
+    r = _mm_blendv_epi8(r, nanInf, _mm_cmpeq_epi32(exp, expMask));
+
+    return _mm_and_si128(r, _mm_set1_epi32(0xFFFF));
+}
+
+inline __m128 affineSse(__m128 x, __m128 mean, __m128 scale) {
+    return _mm_mul_ps(_mm_sub_ps(x, mean), scale);
+}
+
+inline __m128 u8ToF32Sse(__m128i bytes) {
+    return _mm_cvtepi32_ps(_mm_cvtepu8_epi32(bytes));
+}
+
+void u8ToF32Sse(const void* src, void* dst, size_t n, float mean, float scale) {
+    auto s = static_cast<const uint8_t*>(src);
+    auto d = static_cast<float*>(dst);
+    const __m128 m = _mm_set1_ps(mean);
+    const __m128 k = _mm_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        _mm_storeu_ps(d + i, affineSse(u8ToF32Sse(bytes), m, k));
+        _mm_storeu_ps(d + i + 4, affineSse(u8ToF32Sse(_mm_srli_si128(bytes, 4)), m, k));
+        _mm_storeu_ps(d + i + 8, affineSse(u8ToF32Sse(_mm_srli_si128(bytes, 8)), m, k));
+        _mm_storeu_ps(d + i + 12, affineSse(u8ToF32Sse(_mm_srli_si128(bytes, 12)), m, k));
+    }
+    convertRowScalar<uint8_t, float>(s + i, d + i, n - i, mean, scale);
+}
+
+void u8ToF16Sse(const void* src, void* dst, size_t n, float mean, float scale) {
+    auto s = static_cast<const uint8_t*>(src);
+    auto d = static_cast<uint16_t*>(dst);
+    const __m128 m = _mm_set1_ps(mean);
+    const __m128 k = _mm_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        const __m128i h0 = f32ToF16Sse(affineSse(u8ToF32Sse(bytes), m, k));
+        const __m128i h1 = f32ToF16Sse(affineSse(u8ToF32Sse(_mm_srli_si128(bytes, 4)), m, k));
+        const __m128i h2 = f32ToF16Sse(affineSse(u8ToF32Sse(_mm_srli_si128(bytes, 8)), m, k));
+        const __m128i h3 = f32ToF16Sse(affineSse(u8ToF32Sse(_mm_srli_si128(bytes, 12)), m, k));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), _mm_packus_epi32(h0, h1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i + 8), _mm_packus_epi32(h2, h3));
+    }
+    convertRowScalar<uint8_t, uint16_t>(s + i, d + i, n - i, mean, scale);
+}
+
+void f32ToF16Sse(const void* src, void* dst, size_t n, float mean, float scale) {
+    auto s = static_cast<const float*>(src);
+    auto d = static_cast<uint16_t*>(dst);
+    const __m128 m = _mm_set1_ps(mean);
+    const __m128 k = _mm_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i h0 = f32ToF16Sse(affineSse(_mm_loadu_ps(s + i), m, k));
+        const __m128i h1 = f32ToF16Sse(affineSse(_mm_loadu_ps(s + i + 4), m, k));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), _mm_packus_epi32(h0, h1));
+    }
+    convertRowScalar<float, uint16_t>(s + i, d + i, n - i, mean, scale);
+}
+
+void f32ToF32Sse(const void* src, void* dst, size_t n, float mean, float scale) {
+    auto s = static_cast<const float*>(src);
+    auto d = static_cast<float*>(dst);
+    const __m128 m = _mm_set1_ps(mean);
+    const __m128 k = _mm_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(d + i, affineSse(_mm_loadu_ps(s + i), m, k));
+    }
+    convertRowScalar<float, float>(s + i, d + i, n - i, mean, scale);
+}
+
+template <typename T> __m128i unpackLo(__m128i a, __m128i b);
+template <typename T> __m128i unpackHi(__m128i a, __m128i b);
+template <> inline __m128i unpackLo<uint8_t>(__m128i a, __m128i b) { return _mm_unpacklo_epi8(a, b); }
+template <> inline __m128i unpackHi<uint8_t>(__m128i a, __m128i b) { return _mm_unpackhi_epi8(a, b); }
+template <> inline __m128i unpackLo<uint16_t>(__m128i a, __m128i b) { return _mm_unpacklo_epi16(a, b); }
+template <> inline __m128i unpackHi<uint16_t>(__m128i a, __m128i b) { return _mm_unpackhi_epi16(a, b); }
+template <> inline __m128i unpackLo<uint32_t>(__m128i a, __m128i b) { return _mm_unpacklo_epi32(a, b); }
+template <> inline __m128i unpackHi<uint32_t>(__m128i a, __m128i b) { return _mm_unpackhi_epi32(a, b); }
+
+// Transposes K x K elements, K = 16 / sizeof(T): each round interleaves the rows i and i + K / 2,
+// log2(K) rounds rotate the bits of the row and the column indexes into each other
+template <typename T>
+inline void transposeSse(__m128i* r) {
+    const size_t K = 16 / sizeof(T);
+    __m128i t[K];
+    for (size_t round = 1; round < K; round *= 2) {
+        for (size_t i = 0; i < K / 2; ++i) {
+            t[2 * i] = unpackLo<T>(r[i], r[i + K / 2]);
+            t[2 * i + 1] = unpackHi<T>(r[i], r[i + K / 2]);
+        }
+        std::copy(t, t + K, r);
+    }
+}
+
+// Masks of _mm_shuffle_epi8 between nrows planes of 16 bytes and nrows interleaved registers
+struct ShuffleMasks {
+    __m128i masks[4][4];
+
+    // interleave - masks[o][c] takes the bytes of the output register o from the plane c,
+    // deinterleave - masks[c][i] takes the bytes of the plane c from the input register i
+    ShuffleMasks(size_t elementSize, size_t nrows, bool interleave) {
+        alignas(16) uint8_t bytes[16];
+        for (size_t x = 0; x < nrows; ++x) {
+            for (size_t y = 0; y < nrows; ++y) {
+                for (size_t k = 0; k < 16; ++k) {
+                    size_t b = k % elementSize;
+                    if (interleave) {
+                        size_t element = (x * 16 + k) / elementSize;
+                        bool fromPlane = element % nrows == y;
+                        bytes[k] = fromPlane ? static_cast<uint8_t>(element / nrows * elementSize + b) : 0x80;
+                    } else {
+                        size_t pos = (k / elementSize * nrows + x) * elementSize + b;
+                        bytes[k] = pos / 16 == y ? static_cast<uint8_t>(pos % 16) : 0x80;
+                    }
+                }
+                masks[x][y] = _mm_load_si128(reinterpret_cast<const __m128i*>(bytes));
+            }
+        }
+    }
+};
+
+// Interleaves C = 2 to 4 rows into a dense destination, stride == C, returns the pixels interleaved
+template <typename T, size_t C>
+size_t interleaveShuffleSse(const void* const* rows, size_t len, void* dst) {
+    const size_t K = 16 / sizeof(T);
+    const ShuffleMasks shuffle(sizeof(T), C, true);
+    const T* planes[C];
+    std::copy(rows, rows + C, reinterpret_cast<const void**>(planes));
+    auto d = static_cast<T*>(dst);
+    size_t p = 0;
+    for (; p + K <= len; p += K) {
+        __m128i in[C];
+        for (size_t c = 0; c < C; ++c) {
+            in[c] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes[c] + p));
+        }
+        for (size_t o = 0; o < C; ++o) {
+            __m128i out = _mm_shuffle_epi8(in[0], shuffle.masks[o][0]);
+            for (size_t c = 1; c < C; ++c) {
+                out = _mm_or_si128(out, _mm_shuffle_epi8(in[c], shuffle.masks[o][c]));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + p * C + o * K), out);
+        }
+    }
+    return p;
+}
+
+template <typename T, size_t C>
+size_t deinterleaveShuffleSse(const void* src, size_t len, void* const* rows) {
+    const size_t K = 16 / sizeof(T);
+    const ShuffleMasks shuffle(sizeof(T), C, false);
+    T* planes[C];
+    std::copy(rows, rows + C, reinterpret_cast<void**>(planes));
+    auto s = static_cast<const T*>(src);
+    size_t p = 0;
+    for (; p + K <= len; p += K) {
+        __m128i in[C];
+        for (size_t i = 0; i < C; ++i) {
+            in[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + p * C + i * K));
+        }
+        for (size_t c = 0; c < C; ++c) {
+            __m128i plane = _mm_shuffle_epi8(in[0], shuffle.masks[c][0]);
+            for (size_t i = 1; i < C; ++i) {
+                plane = _mm_or_si128(plane, _mm_shuffle_epi8(in[i], shuffle.masks[c][i]));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(planes[c] + p), plane);
+        }
+    }
+    return p;
+}
+
+template <typename T>
+size_t interleaveShuffleSse(const void* const* rows, size_t nrows, size_t len, void* dst) {
+    switch (nrows) {
+    case 2:
+        return interleaveShuffleSse<T, 2>(rows, len, dst);
+    case 3:
+        return interleaveShuffleSse<T, 3>(rows, len, dst);
+    default:
+        return interleaveShuffleSse<T, 4>(rows, len, dst);
+    }
+}
+
+template <typename T>
+size_t deinterleaveShuffleSse(const void* src, size_t nrows, size_t len, void* const* rows) {
+    switch (nrows) {
+    case 2:
+        return deinterleaveShuffleSse<T, 2>(src, len, rows);
+    case 3:
+        return deinterleaveShuffleSse<T, 3>(src, len, rows);
+    default:
+        return deinterleaveShuffleSse<T, 4>(src, len, rows);
+    }
+}
+
+template <typename T>
+void interleaveSse(const void* const* rows, size_t nrows, size_t len, void* dst, size_t stride) {
+    const size_t K = 16 / sizeof(T);
+    if (nrows == stride && nrows >= 2 && nrows <= 4 && nrows < K) {
+        size_t p = interleaveShuffleSse<T>(rows, nrows, len, dst);
+        interleaveScalar<T>(rows, 0, nrows, p, len, dst, stride);
+        return;
+    }
+
+    auto d = static_cast<T*>(dst);
+    __m128i r[K];
+    size_t row = 0;
+    for (; row + K <= nrows; row += K) {
+        // the pointers in locals, the stores of the vectors may alias the array
+        const T* tile[K];
+        std::copy(rows + row, rows + row + K, reinterpret_cast<const void**>(tile));
+        size_t p = 0;
+        for (; p + K <= len; p += K) {
+            for (size_t i = 0; i < K; ++i) {
+                r[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tile[i] + p));
+            }
+            transposeSse<T>(r);
+            for (size_t i = 0; i < K; ++i) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(d + (p + i) * stride + row), r[i]);
+            }
+        }
+        interleaveScalar<T>(rows, row, row + K, p, len, dst, stride);
+    }
+    interleaveScalar<T>(rows, row, nrows, 0, len, dst, stride);
+}
+
+template <typename T>
+void deinterleaveSse(const void* src, size_t stride, size_t nrows, size_t len, void* const* rows) {
+    const size_t K = 16 / sizeof(T);
+    if (nrows == stride && nrows >= 2 && nrows <= 4 && nrows < K) {
+        size_t p = deinterleaveShuffleSse<T>(src, nrows, len, rows);
+        deinterleaveScalar<T>(src, stride, 0, nrows, p, len, rows);
+        return;
+    }
+
+    auto s = static_cast<const T*>(src);
+    __m128i r[K];
+    size_t row = 0;
+    for (; row + K <= nrows; row += K) {
+        T* tile[K];
+        std::copy(rows + row, rows + row + K, reinterpret_cast<void**>(tile));
+        size_t p = 0;
+        for (; p + K <= len; p += K) {
+            for (size_t i = 0; i < K; ++i) {
+                r[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + (p + i) * stride + row));
+            }
+            transposeSse<T>(r);
+            for (size_t i = 0; i < K; ++i) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(tile[i] + p), r[i]);
+            }
+        }
+        deinterleaveScalar<T>(src, stride, row, row + K, p, len, rows);
+    }
+    deinterleaveScalar<T>(src, stride, row, nrows, 0, len, rows);
+}
+
+const Kernels SSE42_KERNELS = {
+    u8ToF16Sse,
+    u8ToF32Sse,
+    f32ToF16Sse,
+    f32ToF32Sse,
+    {interleaveSse<uint8_t>, interleaveSse<uint16_t>, interleaveSse<uint32_t>},
+    {deinterleaveSse<uint8_t>, deinterleaveSse<uint16_t>, deinterleaveSse<uint32_t>},
+};
+
+#endif  // BLOB_TRANSFORM_SSE42
+
+#ifdef BLOB_TRANSFORM_AVX2
+
+//
+// AVX2 kernels: the precision conversions and the transposes of 32 bit elements,
+// the SSE4.2 ones for the 8 and 16 bit elements
+//
+
+// f32ToF16Sse of 8 values
+AVX2_TARGET inline __m256i f32ToF16Avx2(__m256 x) {
+    const __m256i v = _mm256_castps_si256(x);
+    const __m256i expMask = _mm256_set1_epi32(0x7F800000);
+    const __m256i s = _mm256_and_si256(_mm256_srli_epi32(v, 16), _mm256_set1_epi32(0x8000));
+    const __m256i a = _mm256_and_si256(v, _mm256_set1_epi32(0x7FFFFFFF));
+    const __m256i exp = _mm256_and_si256(a, expMask);
+
+    const __m256 halfUlp = _mm256_mul_ps(_mm256_castsi256_ps(exp),
+                                         _mm256_castsi256_ps(_mm256_set1_epi32((127 - 11) << 23)));
+    const __m256 f = _mm256_add_ps(_mm256_castsi256_ps(a), halfUlp);
+    __m256i r = _mm256_or_si256(
+        _mm256_srli_epi32(_mm256_sub_epi32(_mm256_castps_si256(f), _mm256_set1_epi32((127 - 15) << 23)), 13), s);
+
+    const __m256 min16 = _mm256_castsi256_ps(_mm256_set1_epi32((127 - 14) << 23));
+    const __m256 max16 = _mm256_castsi256_ps(_mm256_set1_epi32(((127 + 15) << 23) | 0x007FE000));
+    r = _mm256_blendv_epi8(r, _mm256_or_si256(s, _mm256_set1_epi32(((15 + 15) << 10) | 0x3FF)),
+                           _mm256_castps_si256(_mm256_cmp_ps(f, max16, _CMP_GE_OQ)));
+    r = _mm256_blendv_epi8(r, _mm256_or_si256(s, _mm256_set1_epi32(1 << 10)),
+                           _mm256_castps_si256(_mm256_cmp_ps(f, min16, _CMP_LT_OQ)));
+    r = _mm256_blendv_epi8(r, s, _mm256_castps_si256(
+        _mm256_cmp_ps(f, _mm256_mul_ps(min16, _mm256_set1_ps(0.5f)), _CMP_LT_OQ)));
+
+    const __m256i isNan = _mm256_andnot_si256(_mm256_cmpeq_epi32(_mm256_and_si256(a, _mm256_set1_epi32(0x007FFFFF)),
+                                                                 _mm256_setzero_si256()), _mm256_set1_epi32(-1));
+    const __m256i nanInf = _mm256_or_si256(_mm256_or_si256(s, _mm256_srli_epi32(a, 23 - 10)),
+                                           _mm256_and_si256(isNan, _mm256_set1_epi32(0x0200)));
+    r = _mm256_blendv_epi8(r, nanInf, _mm256_cmpeq_epi32(exp, expMask));
+
+    return _mm256_and_si256(r, _mm256_set1_epi32(0xFFFF));
+}
+
+// 16 FP16 values of two f32ToF16Avx2 results, in order
+AVX2_TARGET inline __m256i packF16Avx2(__m256i lo, __m256i hi) {
+    return _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xD8);
+}
+
+AVX2_TARGET inline __m256 affineAvx2(__m256 x, __m256 mean, __m256 scale) {
+    return _mm256_mul_ps(_mm256_sub_ps(x, mean), scale);
+}
+
+AVX2_TARGET inline __m256 u8ToF32Avx2(const uint8_t* src) {
+    return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src))));
+}
+
+AVX2_TARGET void u8ToF32Avx2(const void* src, void* dst, size_t n, float mean, float scale) {
+    auto s = static_cast<const uint8_t*>(src);
+    auto d = static_cast<float*>(dst);
+    const __m256 m = _mm256_set1_ps(mean);
+    const __m256 k = _mm256_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm256_storeu_ps(d + i, affineAvx2(u8ToF32Avx2(s + i), m, k));
+        _mm256_storeu_ps(d + i + 8, affineAvx2(u8ToF32Avx2(s + i + 8), m, k));
+    }
+    convertRowScalar<uint8_t, float>(s + i, d + i, n - i, mean, scale);
+}
+
+AVX2_TARGET void u8ToF16Avx2(const void* src, void* dst, size_t n, float mean, float scale) {
+    auto s = static_cast<const uint8_t*>(src);
+    auto d = static_cast<uint16_t*>(dst);
+    const __m256 m = _mm256_set1_ps(mean);
+    const __m256 k = _mm256_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256i h0 = f32ToF16Avx2(affineAvx2(u8ToF32Avx2(s + i), m, k));
+        const __m256i h1 = f32ToF16Avx2(affineAvx2(u8ToF32Avx2(s + i + 8), m, k));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i), packF16Avx2(h0, h1));
+    }
+    convertRowScalar<uint8_t, uint16_t>(s + i, d + i, n - i, mean, scale);
+}
+
+AVX2_TARGET void f32ToF16Avx2(const void* src, void* dst, size_t n, float mean, float scale) {
+    auto s = static_cast<const float*>(src);
+    auto d = static_cast<uint16_t*>(dst);
+    const __m256 m = _mm256_set1_ps(mean);
+    const __m256 k = _mm256_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256i h0 = f32ToF16Avx2(affineAvx2(_mm256_loadu_ps(s + i), m, k));
+        const __m256i h1 = f32ToF16Avx2(affineAvx2(_mm256_loadu_ps(s + i + 8), m, k));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i), packF16Avx2(h0, h1));
+    }
+    convertRowScalar<float, uint16_t>(s + i, d + i, n - i, mean, scale);
+}
+
+AVX2_TARGET void f32ToF32Avx2(const void* src, void* dst, size_t n, float mean, float scale) {
+    auto s = static_cast<const float*>(src);
+    auto d = static_cast<float*>(dst);
+    const __m256 m = _mm256_set1_ps(mean);
+    const __m256 k = _mm256_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(d + i, affineAvx2(_mm256_loadu_ps(s + i), m, k));
+    }
+    convertRowScalar<float, float>(s + i, d + i, n - i, mean, scale);
+}
+
+// Transposes 8 x 8 32 bit elements: the 4 x 4 blocks in the 128 bit lanes, then the lanes
+AVX2_TARGET inline void transposeAvx2(__m256* r) {
+    __m256 t[8], u[8];
+    for (size_t i = 0; i < 4; ++i) {
+        t[2 * i] = _mm256_unpacklo_ps(r[2 * i], r[2 * i + 1]);
+        t[2 * i + 1] = _mm256_unpackhi_ps(r[2 * i], r[2 * i + 1]);
+    }
+    for (size_t i = 0; i < 2; ++i) {
+        u[4 * i] = _mm256_shuffle_ps(t[4 * i], t[4 * i + 2], 0x44);
+        u[4 * i + 1] = _mm256_shuffle_ps(t[4 * i], t[4 * i + 2], 0xEE);
+        u[4 * i + 2] = _mm256_shuffle_ps(t[4 * i + 1], t[4 * i + 3], 0x44);
+        u[4 * i + 3] = _mm256_shuffle_ps(t[4 * i + 1], t[4 * i + 3], 0xEE);
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        r[i] = _mm256_permute2f128_ps(u[i], u[i + 4], 0x20);
+        r[i + 4] = _mm256_permute2f128_ps(u[i], u[i + 4], 0x31);
+    }
+}
+
+AVX2_TARGET void interleaveAvx2(const void* const* rows, size_t nrows, size_t len, void* dst, size_t stride) {
+    if (nrows < 8) {
+        interleaveSse<uint32_t>(rows, nrows, len, dst, stride);
+        return;
+    }
+
+    auto d = static_cast<float*>(dst);
+    __m256 r[8];
+    size_t row = 0;
+    for (; row + 8 <= nrows; row += 8) {
+        const float* tile[8];
+        std::copy(rows + row, rows + row + 8, reinterpret_cast<const void**>(tile));
+        size_t p = 0;
+        for (; p + 8 <= len; p += 8) {
+            for (size_t i = 0; i < 8; ++i) {
+                r[i] = _mm256_loadu_ps(tile[i] + p);
+            }
+            transposeAvx2(r);
+            for (size_t i = 0; i < 8; ++i) {
+                _mm256_storeu_ps(d + (p + i) * stride + row, r[i]);
+            }
+        }
+        interleaveScalar<uint32_t>(rows, row, row + 8, p, len, dst, stride);
+    }
+    if (row < nrows) {
+        // the rest of the rows, 4 at a time
+        interleaveSse<uint32_t>(rows + row, nrows - row, len, d + row, stride);
+    }
+}
+
+AVX2_TARGET void deinterleaveAvx2(const void* src, size_t stride, size_t nrows, size_t len, void* const* rows) {
+    if (nrows < 8) {
+        deinterleaveSse<uint32_t>(src, stride, nrows, len, rows);
+        return;
+    }
+
+    auto s = static_cast<const float*>(src);
+    __m256 r[8];
+    size_t row = 0;
+    for (; row + 8 <= nrows; row += 8) {
+        float* tile[8];
+        std::copy(rows + row, rows + row + 8, reinterpret_cast<void**>(tile));
+        size_t p = 0;
+        for (; p + 8 <= len; p += 8) {
+            for (size_t i = 0; i < 8; ++i) {
+                r[i] = _mm256_loadu_ps(s + (p + i) * stride + row);
+            }
+            transposeAvx2(r);
+            for (size_t i = 0; i < 8; ++i) {
+                _mm256_storeu_ps(tile[i] + p, r[i]);
+            }
+        }
+        deinterleaveScalar<uint32_t>(src, stride, row, row + 8, p, len, rows);
+    }
+    if (row < nrows) {
+        deinterleaveSse<uint32_t>(s + row, stride, nrows - row, len, rows + row);
+    }
+}
+
+const Kernels AVX2_KERNELS = {
+    u8ToF16Avx2,
+    u8ToF32Avx2,
+    f32ToF16Avx2,
+    f32ToF32Avx2,
+    {interleaveSse<uint8_t>, interleaveSse<uint16_t>, interleaveAvx2},
+    {deinterleaveSse<uint8_t>, deinterleaveSse<uint16_t>, deinterleaveAvx2},
+};
+
+#endif  // BLOB_TRANSFORM_AVX2
+
+const Kernels& getKernels(Isa isa) {
+    switch (isa) {
+#ifdef BLOB_TRANSFORM_AVX2
+    case AVX2:
+        return AVX2_KERNELS;
+#endif
+#ifdef BLOB_TRANSFORM_SSE42
+    case SSE42:
+        return SSE42_KERNELS;
+#endif
+    default:
+        return SCALAR_KERNELS;
+    }
+}
+
+//
+// Tensors
+//
+
+struct Tensor {
+    enum Kind { PLANAR, INTERLEAVED, BLOCKED };
+
+    Kind kind;
+    size_t block = 1;
+    size_t elementSize;
+};
+
+size_t elementSizeOf(const Precision& precision) {
+    switch (precision) {
+    case Precision::U8:
+        return 1;
+    case Precision::FP16:
+        return 2;
+    case Precision::FP32:
+        return 4;
+    default:
+        THROW_IE_EXCEPTION << "Unsupported precision " << precision.name() << " of a blob to convert";
+    }
+}
+
+size_t log2Of(size_t elementSize) {
+    return elementSize == 1 ? 0 : elementSize == 2 ? 1 : 2;
+}
+
+Tensor parseTensor(const TensorDesc& desc) {
+    const auto& dims = desc.getDims();
+    if (dims.size() != 4) {
+        THROW_IE_EXCEPTION << "Only 4D blobs are converted, the blob has " << dims.size() << " dims";
+    }
+
+    Tensor tensor;
+    tensor.elementSize = elementSizeOf(desc.getPrecision());
+    const auto& blocking = desc.getBlockingDesc();
+    switch (desc.getLayout()) {
+    case NCHW:
+        tensor.kind = Tensor::PLANAR;
+        break;
+    case NHWC:
+        tensor.kind = Tensor::INTERLEAVED;
+        break;
+    case BLOCKED: {
+        tensor.kind = Tensor::BLOCKED;
+        tensor.block = blocking.getBlockDims().size() == 5 ? blocking.getBlockDims()[4] : 0;
+        SizeVector blockedDims = {dims[0], (dims[1] + tensor.block - 1) / tensor.block, dims[2], dims[3], tensor.block};
+        if ((tensor.block != 8 && tensor.block != 16) || blocking.getBlockDims() != blockedDims ||
+            blocking.getOrder() != SizeVector{0, 1, 2, 3, 1}) {
+            THROW_IE_EXCEPTION << "Only nChw8c and nChw16c blocked blobs are converted";
+        }
+        break;
+    }
+    default:
+        THROW_IE_EXCEPTION << "Unsupported layout " << static_cast<int>(desc.getLayout()) << " of a blob to convert";
+    }
+
+    // the strides of the descriptors built from the dims and a layout are the dense ones of their blocked dims
+    if (blocking.getOffsetPadding() != 0 || (!blocking.getStrides().empty() &&
+        blocking.getStrides() != BlockingDesc(blocking.getBlockDims(), blocking.getOrder()).getStrides())) {
+        THROW_IE_EXCEPTION << "Only dense blobs are converted";
+    }
+    return tensor;
+}
+
+}  // namespace
+
+Isa getBestIsa() {
+#ifdef BLOB_TRANSFORM_AVX2
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    if (avx2) return AVX2;
+#endif
+#ifdef BLOB_TRANSFORM_SSE42
+    return SSE42;
+#else
+    return SCALAR;
+#endif
+}
+
+const char* getIsaName(Isa isa) {
+    switch (isa) {
+    case SCALAR:
+        return "scalar";
+    case SSE42:
+        return "sse4.2";
+    case AVX2:
+        return "avx2";
+    default:
+        return getIsaName(getBestIsa());
+    }
+}
+
+TensorDesc makeBlockedDesc(const Precision& precision, const SizeVector& dims, size_t block) {
+    if (dims.size() != 4 || (block != 8 && block != 16)) {
+        THROW_IE_EXCEPTION << "Only nChw8c and nChw16c blocked descriptors are made";
+    }
+    SizeVector blockedDims = {dims[0], (dims[1] + block - 1) / block, dims[2], dims[3], block};
+    return TensorDesc(precision, dims, BlockingDesc(blockedDims, {0, 1, 2, 3, 1}));
+}
+
+void convert(const TensorDesc& srcDesc, const void* src, const TensorDesc& dstDesc, void* dst,
+             const float* mean, const float* scale, Isa isa) {
+    if (srcDesc.getDims() != dstDesc.getDims()) {
+        THROW_IE_EXCEPTION << "The blobs to convert have different dims";
+    }
+    const auto srcTensor = parseTensor(srcDesc);
+    const auto dstTensor = parseTensor(dstDesc);
+    const auto srcPrecision = srcDesc.getPrecision();
+    const auto dstPrecision = dstDesc.getPrecision();
+    const bool isAffine = nullptr != mean || nullptr != scale;
+    if (dstPrecision == Precision::U8 && (srcPrecision != Precision::U8 || isAffine)) {
+        THROW_IE_EXCEPTION << "Only U8 blobs are converted to U8, with no mean and scale";
+    }
+
+    const auto& dims = srcDesc.getDims();
+    const size_t N = dims[0], C = dims[1], HW = dims[2] * dims[3];
+    const size_t es = srcTensor.elementSize, ed = dstTensor.elementSize;
+    auto srcBytes = static_cast<const uint8_t*>(src);
+    auto dstBytes = static_cast<uint8_t*>(dst);
+
+    const bool isCopy = srcPrecision == dstPrecision && !isAffine;
+    // a copy, if there are no padded channels to zero
+    if (isCopy && srcTensor.kind == dstTensor.kind && srcTensor.block == dstTensor.block && C % srcTensor.block == 0) {
+        std::memcpy(dst, src, N * C * HW * es);
+        return;
+    }
+    if (N * C * HW == 0) return;
+
+    if (isa == AUTO || isa > getBestIsa()) {
+        isa = getBestIsa();
+    }
+    const auto& kernels = getKernels(isa);
+    RowFn convertRow = nullptr;
+    if (srcPrecision == Precision::U8 && dstPrecision == Precision::FP16) {
+        convertRow = kernels.u8ToF16;
+    } else if (srcPrecision == Precision::U8 && dstPrecision == Precision::FP32) {
+        convertRow = kernels.u8ToF32;
+    } else if (srcPrecision == Precision::FP32 && dstPrecision == Precision::FP16) {
+        convertRow = kernels.f32ToF16;
+    } else if (srcPrecision == Precision::FP32 && dstPrecision == Precision::FP32) {
+        convertRow = kernels.f32ToF32;
+    } else if (srcPrecision == Precision::FP16 && dstPrecision == Precision::FP16) {
+        convertRow = convertRowScalar<uint16_t, uint16_t>;
+    } else if (srcPrecision == Precision::FP16 && dstPrecision == Precision::FP32) {
+        convertRow = convertRowScalar<uint16_t, float>;
+    }
+
+    // rows of the tiles, the channels rounded up to the blocks
+    const size_t block = std::max(srcTensor.block, dstTensor.block);
+    const size_t tileRows = (C + block - 1) / block * block;
+    size_t tilePixels = std::max(TILE_BYTES / (tileRows * std::max(es, ed)), TILE_PIXELS_ALIGNMENT);
+    tilePixels = std::min(tilePixels / TILE_PIXELS_ALIGNMENT * TILE_PIXELS_ALIGNMENT, HW);
+
+    std::vector<uint8_t> srcTile(srcTensor.kind != Tensor::PLANAR ? tileRows * tilePixels * es : 0);
+    std::vector<uint8_t> dstTile(dstTensor.kind != Tensor::PLANAR && !isCopy ? tileRows * tilePixels * ed : 0);
+    std::vector<uint8_t> zeros(dstTensor.kind == Tensor::BLOCKED ? tilePixels * ed : 0);
+    std::vector<void*> srcTileRows(tileRows);
+    std::vector<const void*> srcRows(tileRows);
+    std::vector<const void*> dstRows(tileRows, zeros.data());
+    for (size_t c = 0; c < tileRows && !srcTile.empty(); ++c) {
+        srcRows[c] = srcTileRows[c] = srcTile.data() + c * tilePixels * es;
+    }
+
+    const auto deinterleave = kernels.deinterleave[log2Of(es)];
+    const auto interleave = kernels.interleave[log2Of(ed)];
+    const size_t srcBlocks = (C + srcTensor.block - 1) / srcTensor.block;
+    const size_t dstBlocks = (C + dstTensor.block - 1) / dstTensor.block;
+    for (size_t n = 0; n < N; ++n) {
+        for (size_t p = 0; p < HW; p += tilePixels) {
+            const size_t len = std::min(tilePixels, HW - p);
+
+            // the source channels as planar rows, straight in the destination if it's a planar copy
+            if (isCopy && dstTensor.kind == Tensor::PLANAR && srcTensor.kind != Tensor::PLANAR) {
+                for (size_t c = 0; c < C; ++c) {
+                    srcRows[c] = srcTileRows[c] = dstBytes + ((n * C + c) * HW + p) * ed;
+                }
+            }
+            if (srcTensor.kind == Tensor::PLANAR) {
+                for (size_t c = 0; c < C; ++c) {
+                    srcRows[c] = srcBytes + ((n * C + c) * HW + p) * es;
+                }
+            } else if (srcTensor.kind == Tensor::INTERLEAVED) {
+                deinterleave(srcBytes + (n * HW + p) * C * es, C, C, len, srcTileRows.data());
+            } else {
+                const size_t B = srcTensor.block;
+                for (size_t cb = 0; cb < srcBlocks; ++cb) {
+                    deinterleave(srcBytes + ((n * srcBlocks + cb) * HW + p) * B * es, B, B, len, &srcTileRows[cb * B]);
+                }
+            }
+
+            // converted to the destination precision, in place if the destination is planar
+            for (size_t c = 0; c < C; ++c) {
+                void* row = dstTensor.kind == Tensor::PLANAR ? dstBytes + ((n * C + c) * HW + p) * ed
+                                                             : dstTile.data() + c * tilePixels * ed;
+                if (!isCopy) {
+                    convertRow(srcRows[c], row, len, mean ? mean[c] : 0.f, scale ? scale[c] : 1.f);
+                    dstRows[c] = row;
+                } else if (dstTensor.kind == Tensor::PLANAR) {
+                    if (row != srcRows[c]) std::memcpy(row, srcRows[c], len * es);
+                } else {
+                    dstRows[c] = srcRows[c];
+                }
+            }
+
+            // the destination layout, the channels past C of the last block are zeros
+            if (dstTensor.kind == Tensor::INTERLEAVED) {
+                interleave(dstRows.data(), C, len, dstBytes + (n * HW + p) * C * ed, C);
+            } else if (dstTensor.kind == Tensor::BLOCKED) {
+                const size_t B = dstTensor.block;
+                for (size_t cb = 0; cb < dstBlocks; ++cb) {
+                    interleave(&dstRows[cb * B], B, len, dstBytes + ((n * dstBlocks + cb) * HW + p) * B * ed, B);
+                }
+            }
+        }
+    }
+}
+
+void convert(const Blob& src, Blob& dst, const float* mean, const float* scale, Isa isa) {
+    convert(src.getTensorDesc(), src.cbuffer().as<const void*>(), dst.getTensorDesc(), dst.buffer().as<void*>(),
+            mean, scale, isa);
+}
+
+}  // namespace BlobTransform
+
+}  // namespace InferenceEngine
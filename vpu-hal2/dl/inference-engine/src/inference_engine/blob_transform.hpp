@@ -0,0 +1,108 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+#pragma once
+
+#include <cstddef>
+#include "ie_api.h"
+#include "ie_blob.h"
+#include "ie_layouts.h"
+
+namespace InferenceEngine {
+
+namespace BlobTransform {
+
+/**
+ * @brief Instruction sets of the conversion kernels
+ */
+enum Isa {
+    SCALAR,
+    // SSE4.2, the baseline of the x86_64 Android ABI
+    SSE42,
+    // AVX2 kernels, when the CPU supports them, SSE4.2 ones for the rest
+    AVX2,
+    // the best one of the CPU
+    AUTO
+};
+
+/**
+ * @brief The best instruction set the library is built with and the CPU supports
+ */
+INFERENCE_ENGINE_API_CPP(Isa) getBestIsa();
+
+INFERENCE_ENGINE_API_CPP(const char*) getIsaName(Isa isa);
+
+/**
+ * @brief Converts a 4D tensor to another layout and precision, with an optional mean and scale per channel:
+ * dst = (src - mean[c]) * scale[c].
+ *
+ * The layouts are NCHW (planar), NHWC (interleaved) and BLOCKED nChw8c and nChw16c: blocked dims
+ * {N, C / B rounded up, H, W, B} with order {0, 1, 2, 3, 1}, the channels past C are written as zeros.
+ * The precisions are U8 to U8, FP16 or FP32, FP16 to FP16 or FP32, and FP32 to FP16 or FP32.
+ * FP32 is rounded to FP16 like PrecisionUtils::f32tof16 and the kernels of all the instruction sets
+ * give the same results. The mean and the scale apply to FP16 and FP32 destinations only.
+ *
+ * The tensor is converted in tiles of all its channels and a few hundred pixels, read and written
+ * once: a transpose to planar rows if the source is not planar, the precision conversion of the rows,
+ * a transpose to the destination layout if it's not planar.
+ *
+ * @param srcDesc - tensor descriptor of src, dense
+ * @param src - source tensor
+ * @param dstDesc - tensor descriptor of dst, dense, the dims of srcDesc
+ * @param dst - destination tensor, not overlapping src
+ * @param mean - C values subtracted from the channels, none if nullptr
+ * @param scale - C values the channels are multiplied by, none if nullptr
+ * @param isa - instruction set of the kernels, the best one supported is used if it's not supported
+ */
+INFERENCE_ENGINE_API_CPP(void) convert(const TensorDesc& srcDesc, const void* src,
+                                       const TensorDesc& dstDesc, void* dst,
+                                       const float* mean = nullptr, const float* scale = nullptr,
+                                       Isa isa = AUTO);
+
+/**
+ * @brief Converts src to the layout and precision of dst, see the overload with tensor descriptors
+ */
+INFERENCE_ENGINE_API_CPP(void) convert(const Blob& src, Blob& dst,
+                                       const float* mean = nullptr, const float* scale = nullptr,
+                                       Isa isa = AUTO);
+
+/**
+ * @brief Tensor descriptor of a blocked nChw<block>c tensor
+ * @param precision - precision of the tensor
+ * @param dims - NCHW dims
+ * @param block - channels in a block, 8 or 16
+ */
+INFERENCE_ENGINE_API_CPP(TensorDesc) makeBlockedDesc(const Precision& precision, const SizeVector& dims,
+                                                     size_t block);
+
+}  // namespace BlobTransform
+
+}  // namespace InferenceEngine
@@ -80,7 +80,7 @@ StatusCode CNNNetworkImpl::addOutput(const std::string& layerName, size_t output
 
 void CNNNetworkImpl::resolveOutput() {
     // check orphan nodes...
-    for (auto kvp : _data) {
+    for (const auto& kvp : _data) {
         if (!kvp.second->isInitialized())
             THROW_IE_EXCEPTION << "data name [" << kvp.first << "] dimensions is not known";
 
@@ -18,6 +18,7 @@
 #include <map>
 #include <string>
 #include "ie_iinfer_request.hpp"
+#include "ie_icompletion_queue.hpp"
 #include "cpp_interfaces/exception2status.hpp"
 #include "ie_profiling.hpp"
 
@@ -77,6 +78,10 @@ public:
         TO_STATUS(_impl->SetUserData(data));
     }
 
+    StatusCode SetCompletionQueue(const ICompletionQueue::Ptr &queue, ResponseDesc *resp) noexcept override {
+        TO_STATUS(_impl->SetCompletionQueue(queue));
+    }
+
     void Release() noexcept override {
         delete this;
     }
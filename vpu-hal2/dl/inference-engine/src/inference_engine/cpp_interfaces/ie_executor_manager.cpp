@@ -37,10 +37,16 @@
 
 namespace InferenceEngine {
 
-ITaskExecutor::Ptr ExecutorManagerImpl::getExecutor(std::string id) {
+ITaskExecutor::Ptr ExecutorManagerImpl::getExecutor(std::string id, const TaskExecutorConfig &config) {
+    std::lock_guard<std::mutex> lock(mutex);
     auto foundEntry = executors.find(id);
     if (foundEntry == executors.end()) {
-        auto newExec = std::make_shared<TaskExecutor>(id);
+        ITaskExecutor::Ptr newExec;
+        if (config.type == TaskExecutorConfig::WORK_STEALING) {
+            newExec = std::make_shared<WorkStealingTaskExecutor>(config, id);
+        } else {
+            newExec = std::make_shared<TaskExecutor>(id);
+        }
         executors[id] = newExec;
         return newExec;
     }
@@ -49,17 +55,19 @@ ITaskExecutor::Ptr ExecutorManagerImpl::getExecutor(std::string id) {
 
 // for tests purposes
 size_t ExecutorManagerImpl::getExecutorsNumber() {
+    std::lock_guard<std::mutex> lock(mutex);
     return executors.size();
 }
 
 void ExecutorManagerImpl::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
     executors.clear();
 }
 
 ExecutorManager *ExecutorManager::_instance = nullptr;
 
-ITaskExecutor::Ptr ExecutorManager::getExecutor(std::string id) {
-    return _impl.getExecutor(id);
+ITaskExecutor::Ptr ExecutorManager::getExecutor(std::string id, const TaskExecutorConfig &config) {
+    return _impl.getExecutor(id, config);
 }
 
 size_t ExecutorManager::getExecutorsNumber() {
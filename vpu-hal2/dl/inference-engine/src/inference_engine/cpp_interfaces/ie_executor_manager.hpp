@@ -33,9 +33,11 @@
 #pragma once
 
 #include <string>
+#include <mutex>
 #include <unordered_map>
 #include "ie_api.h"
 #include "cpp_interfaces/ie_itask_executor.hpp"
+#include "cpp_interfaces/ie_work_stealing_executor.hpp"
 
 namespace InferenceEngine {
 
@@ -47,7 +49,7 @@ namespace InferenceEngine {
  */
 class ExecutorManagerImpl {
 public:
-    ITaskExecutor::Ptr getExecutor(std::string id);
+    ITaskExecutor::Ptr getExecutor(std::string id, const TaskExecutorConfig &config = TaskExecutorConfig());
 
     // for tests purposes
     size_t getExecutorsNumber();
@@ -55,6 +57,7 @@ public:
     void clear();
 
 private:
+    std::mutex mutex;
     std::unordered_map<std::string, ITaskExecutor::Ptr> executors;
 };
 
@@ -82,8 +85,9 @@ public:
     /**
      * @brief Returns executor by unique identificator
      * @param id unique identificator of device (Usually string representation of TargetDevice)
+     * @param config type of the executor created for the id by the first call, TaskExecutor by default
      */
-    ITaskExecutor::Ptr getExecutor(std::string id);
+    ITaskExecutor::Ptr getExecutor(std::string id, const TaskExecutorConfig &config = TaskExecutorConfig());
 
     // for tests purposes
     size_t getExecutorsNumber();
@@ -19,6 +19,7 @@
 #include <thread>
 #include <queue>
 #include <ie_profiling.hpp>
+#include <ie_trace.hpp>
 #include "details/ie_exception.hpp"
 #include "exception2status.hpp"
 #include "ie_task_synchronizer.hpp"
@@ -27,19 +28,20 @@
 
 namespace InferenceEngine {
 
-Task::Task() : _status(TS_INITIAL) {
+Task::Task() : _status(TS_INITIAL), _isOnWait(false) {
     _function = [&]() {
         _status = TS_DONE;
         return;
     };
 }
 
-Task::Task(std::function<void()> function) : _status(TS_INITIAL), _function(function) {
+Task::Task(std::function<void()> function) : _function(function), _status(TS_INITIAL), _isOnWait(false) {
     if (!function) THROW_IE_EXCEPTION << "Failed to create Task object with null function";
 }
 
 Task::Status Task::runNoThrowNoBusyCheck() noexcept {
     IE_PROFILING_AUTO_SCOPE(TaskExecution);
+    IE_TRACE_SCOPE("executor", "Task")
     try {
         _exceptionPtr = nullptr;
         _function();
@@ -63,33 +65,38 @@ Task::Status Task::runWithSynchronizer(TaskSynchronizer::Ptr &taskSynchronizer)
 Task::Status Task::wait(int64_t millis_timeout) {
     _isOnWait = true;
     std::exception_ptr exceptionPtr;
+    // the status the wait ended with, the task may be occupied again right after it is done
+    auto status = _status.load();
     try {
-        std::unique_lock<std::mutex> lock(_taskStatusMutex);
-        if (_status != TS_INITIAL) {
+        // nothing to wait for, skip the lock
+        if (status != TS_INITIAL && status != TS_DONE && status != TS_ERROR) {
+            std::unique_lock<std::mutex> lock(_taskStatusMutex);
             auto predicate = [&]() -> bool { return _status == TS_DONE || _status == TS_ERROR; };
             if (millis_timeout < 0) {
                 _isTaskDoneCondVar.wait(lock, predicate);
             } else {
                 _isTaskDoneCondVar.wait_for(lock, std::chrono::milliseconds(millis_timeout), predicate);
             }
+            status = _status;
         }
     } catch (...) {
         exceptionPtr = std::current_exception();
     }
     if (exceptionPtr) std::rethrow_exception(exceptionPtr);
     _isOnWait = false;
-    return _status;
+    return status;
 }
 
 bool Task::occupy() {
-    std::unique_lock<std::mutex> guard(_taskStatusMutex);
-    if (_status == Task::TS_BUSY) return false;
-    _status = TS_BUSY;
+    // nobody waits for TS_BUSY, so no need to notify under the lock
+    auto status = _status.load();
+    do {
+        if (status == Task::TS_BUSY) return false;
+    } while (!_status.compare_exchange_weak(status, TS_BUSY));
     return true;
 }
 
 Task::Status Task::getStatus() {
-    std::unique_lock<std::mutex> guard(_taskStatusMutex);
     return _status;
 }
 
@@ -17,6 +17,7 @@
 #include <vector>
 #include <mutex>
 #include <memory>
+#include <atomic>
 #include <condition_variable>
 #include <thread>
 #include <queue>
@@ -96,12 +97,13 @@ protected:
 
 protected:
     std::function<void()> _function;
-    Status _status;
+    // Read without the lock, the lock only orders the final status against the waiters
+    std::atomic<Status> _status;
     std::exception_ptr _exceptionPtr = nullptr;
     std::mutex _taskStatusMutex;
     std::condition_variable _isTaskDoneCondVar;
 
-    bool _isOnWait = false;
+    std::atomic<bool> _isOnWait;
 };
 
 }  // namespace InferenceEngine
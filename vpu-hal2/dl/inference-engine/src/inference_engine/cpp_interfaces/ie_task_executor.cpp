@@ -20,6 +20,7 @@
 #include <thread>
 #include <queue>
 #include <ie_profiling.hpp>
+#include <ie_trace.hpp>
 #include "details/ie_exception.hpp"
 #include "ie_task.hpp"
 #include "ie_task_executor.hpp"
@@ -28,6 +29,7 @@ namespace InferenceEngine {
 
 TaskExecutor::TaskExecutor(std::string name) : _isStopped(false), _name(name) {
     _thread = std::make_shared<std::thread>([&] {
+        Tracer::setThreadName(_name);
         while (!_isStopped) {
             bool isQueueEmpty;
             Task::Ptr currentTask;
@@ -16,67 +16,71 @@
 
 #include <vector>
 #include <memory>
+#include <atomic>
 #include <mutex>
 #include <condition_variable>
 #include <thread>
-#include <queue>
 #include "details/ie_exception.hpp"
 
 namespace InferenceEngine {
 
 #define MAX_NUMBER_OF_TASKS_IN_QUEUE 10
 
+/**
+ * @brief Runs the tasks one-by-one in the order they called lock().
+ * A ticket lock: lock() takes the next ticket and returns at once when it is served, the mutex and
+ * the condition variable are only used by the tasks that have to wait for their turn.
+ */
 class TaskSynchronizer {
 public:
     typedef std::shared_ptr<TaskSynchronizer> Ptr;
 
-    TaskSynchronizer() : _taskCount(0) {}
+    TaskSynchronizer() : _nextTicket(0), _servedTicket(0), _waitingTasks(0) {}
 
     virtual void lock() {
-        auto taskID = _addTaskToQueue();
-        _waitInQueue(taskID);
+        auto ticket = _addTaskToQueue();
+        if (ticket != _servedTicket) {
+            _waitInQueue(ticket);
+        }
     }
 
     virtual void unlock() {
-        std::unique_lock<std::mutex> lockTask(_taskMutex);
-        if (!_taskQueue.empty()) {
-            {
-                std::lock_guard<std::mutex> lock(_queueMutex);
-                _taskQueue.pop();
-            }
+        if (_servedTicket == _nextTicket) return;
+        _servedTicket++;
+        // a waiting task counts itself before it checks _servedTicket
+        if (_waitingTasks > 0) {
+            std::lock_guard<std::mutex> lock(_taskMutex);
             _taskCondVar.notify_all();
         }
     }
 
     size_t queueSize() const {
-        return _taskQueue.size();
+        return _nextTicket - _servedTicket;
     }
 
 private:
-    unsigned int _taskCount;
-    std::queue<unsigned int> _taskQueue;
-    std::mutex _queueMutex;
+    std::atomic<unsigned int> _nextTicket;
+    std::atomic<unsigned int> _servedTicket;
+    std::atomic<unsigned int> _waitingTasks;
     std::mutex _taskMutex;
     std::condition_variable _taskCondVar;
 
 protected:
-    virtual unsigned int _getTaskID() {
-        return _taskCount++;
-    }
-
     virtual unsigned int _addTaskToQueue() {
-        std::lock_guard<std::mutex> lock(_queueMutex);
-        auto taskID = _getTaskID();
-        if (!_taskQueue.empty() && _taskQueue.size() >= MAX_NUMBER_OF_TASKS_IN_QUEUE) {
-            THROW_IE_EXCEPTION << "Failed to add more than " << MAX_NUMBER_OF_TASKS_IN_QUEUE << " tasks to queue";
-        }
-        _taskQueue.push(taskID);
-        return taskID;
+        auto ticket = _nextTicket.load();
+        do {
+            if (ticket - _servedTicket >= MAX_NUMBER_OF_TASKS_IN_QUEUE) {
+                THROW_IE_EXCEPTION << "Failed to add more than " << MAX_NUMBER_OF_TASKS_IN_QUEUE << " tasks to queue";
+            }
+        } while (!_nextTicket.compare_exchange_weak(ticket, ticket + 1));
+        return ticket;
     }
 
-    virtual void _waitInQueue(unsigned int taskID) {
+    virtual void _waitInQueue(unsigned int ticket) {
         std::unique_lock<std::mutex> lock(_taskMutex);
-        _taskCondVar.wait(lock, [&]() { return taskID == _taskQueue.front(); });
+        _waitingTasks++;
+        _taskCondVar.wait(lock, [&]() { return ticket == _servedTicket; });
+        _waitingTasks--;
     }
 };
 
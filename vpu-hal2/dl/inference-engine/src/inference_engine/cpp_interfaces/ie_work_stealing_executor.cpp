@@ -0,0 +1,179 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <algorithm>
+#include <iostream>
+#include <exception>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#include "ie_trace.hpp"
+#include "ie_task.hpp"
+#include "ie_work_stealing_executor.hpp"
+
+namespace InferenceEngine {
+
+namespace {
+
+// Worker of the calling thread, tasks started from a worker go to its queue
+thread_local const WorkStealingTaskExecutor *currentExecutor = nullptr;
+thread_local size_t currentWorker = 0;
+
+void bindToCpu(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    // 0 - the calling thread
+    sched_setaffinity(0, sizeof(set), &set);
+#endif
+}
+
+}  // namespace
+
+WorkStealingTaskExecutor::WorkStealingTaskExecutor(const TaskExecutorConfig &config, std::string name)
+        : _nextWorker(0), _queuedTasks(0), _pendingTasks(0), _sleepingWorkers(0), _isStopped(false),
+          _spinCount(config.spinCount), _name(name) {
+    unsigned int workers = config.workers;
+    if (workers == 0) {
+        workers = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    // all the queues exist before the workers steal from them
+    for (unsigned int i = 0; i < workers; i++) {
+        _workers.emplace_back(new Worker());
+    }
+    for (unsigned int i = 0; i < workers; i++) {
+        int cpu = config.cpus.empty() ? -1 : config.cpus[i % config.cpus.size()];
+        _workers[i]->thread = std::thread(&WorkStealingTaskExecutor::run, this, i, cpu);
+    }
+}
+
+WorkStealingTaskExecutor::~WorkStealingTaskExecutor() {
+    // the worker would wait for its own task and join itself, there is no way out of a destructor
+    // but terminating the process, in release builds as well
+    if (currentExecutor == this) {
+        std::cerr << "WorkStealingTaskExecutor " << _name << " is destroyed by its own worker " << currentWorker
+                  << std::endl;
+        std::terminate();
+    }
+    {
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _doneCondVar.wait(lock, [this]() { return _pendingTasks == 0; });
+        _isStopped = true;
+        _sleepCondVar.notify_all();
+    }
+    for (auto &worker : _workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+bool WorkStealingTaskExecutor::startTask(Task::Ptr task) {
+    if (!task->occupy()) return false;
+    size_t index = currentExecutor == this ? currentWorker : _nextWorker++ % _workers.size();
+    _pendingTasks++;
+    // counted first, a worker may find the count ahead of the queues but never behind
+    _queuedTasks++;
+    {
+        auto &worker = *_workers[index];
+        std::lock_guard<std::mutex> lock(worker.queueMutex);
+        worker.taskQueue.push_back(task);
+    }
+    // a worker going to sleep counts itself before it checks _queuedTasks
+    if (_sleepingWorkers > 0) {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _sleepCondVar.notify_one();
+    }
+    return true;
+}
+
+size_t WorkStealingTaskExecutor::getWorkersNumber() const {
+    return _workers.size();
+}
+
+Task::Ptr WorkStealingTaskExecutor::popTask(Worker &worker) {
+    if (worker.taskQueue.empty()) return nullptr;
+    auto task = worker.taskQueue.front();
+    worker.taskQueue.pop_front();
+    _queuedTasks--;
+    return task;
+}
+
+Task::Ptr WorkStealingTaskExecutor::takeTask(size_t index) {
+    if (_queuedTasks == 0) return nullptr;
+    for (size_t i = 0; i < _workers.size(); i++) {
+        auto &worker = *_workers[(index + i) % _workers.size()];
+        // a busy queue of another worker is left to its owner or the next thief
+        std::unique_lock<std::mutex> lock(worker.queueMutex, std::defer_lock);
+        if (i == 0) {
+            lock.lock();
+        } else if (!lock.try_lock()) {
+            continue;
+        }
+        if (auto task = popTask(worker)) {
+            return task;
+        }
+    }
+    // the queued tasks are behind the busy locks, wait for them instead of spinning on try_lock
+    for (size_t i = 1; i < _workers.size() && _queuedTasks > 0; i++) {
+        auto &worker = *_workers[(index + i) % _workers.size()];
+        std::lock_guard<std::mutex> lock(worker.queueMutex);
+        if (auto task = popTask(worker)) {
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+void WorkStealingTaskExecutor::run(size_t index, int cpu) {
+    if (cpu >= 0) {
+        bindToCpu(cpu);
+    }
+    currentExecutor = this;
+    currentWorker = index;
+    Tracer::setThreadName(_name + "_" + std::to_string(index));
+    while (true) {
+        auto task = takeTask(index);
+        for (unsigned int spin = 0; !task && spin < _spinCount && !_isStopped; spin++) {
+            std::this_thread::yield();
+            task = takeTask(index);
+        }
+        if (!task) {
+            std::unique_lock<std::mutex> lock(_sleepMutex);
+            _sleepingWorkers++;
+            _sleepCondVar.wait(lock, [this]() { return _queuedTasks > 0 || _isStopped; });
+            _sleepingWorkers--;
+            if (_isStopped && _queuedTasks == 0)
+                break;
+            continue;
+        }
+        task->runNoThrowNoBusyCheck();
+        task.reset();
+        if (--_pendingTasks == 0) {
+            // notify dtor, that all tasks were completed
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            _doneCondVar.notify_all();
+        }
+    }
+}
+
+}  // namespace InferenceEngine
@@ -0,0 +1,113 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "ie_api.h"
+#include "cpp_interfaces/ie_task.hpp"
+#include "cpp_interfaces/ie_itask_executor.hpp"
+
+namespace InferenceEngine {
+
+/**
+ * @brief Describes the task executor ExecutorManager creates for an id
+ */
+struct TaskExecutorConfig {
+    enum Type {
+        // One thread running the tasks one-by-one, TaskExecutor
+        SERIAL,
+        // Pool of threads running the tasks concurrently, WorkStealingTaskExecutor
+        WORK_STEALING
+    };
+
+    Type type = SERIAL;
+    // Worker threads, 0 - one per hardware thread
+    unsigned int workers = 0;
+    // CPUs the workers are bound to in turn, no affinity if empty
+    std::vector<int> cpus;
+    // Polls of the queues by an idle worker before it sleeps
+    unsigned int spinCount = 64;
+};
+
+/**
+ * @class WorkStealingTaskExecutor
+ * @brief Runs the tasks concurrently on a pool of workers, each one with its own queue.
+ * Tasks started from outside the pool are spread over the queues in turn, tasks started from a worker
+ * go to its own queue. Idle workers take the oldest task of their queue, then of the queues of the
+ * other workers, so the tasks start in about the order they were started with and none is starved.
+ * The queues locked by other workers are skipped first and waited for only if no free queue had a task.
+ * A worker polls the queues spinCount times before it sleeps, and startTask only wakes a worker up
+ * when one sleeps.
+ */
+class INFERENCE_ENGINE_API_CLASS(WorkStealingTaskExecutor) : public ITaskExecutor {
+public:
+    typedef std::shared_ptr<WorkStealingTaskExecutor> Ptr;
+
+    explicit WorkStealingTaskExecutor(const TaskExecutorConfig &config = TaskExecutorConfig(),
+                                      std::string name = "Default");
+
+    /**
+     * @brief Waits for all the started tasks to be done and stops the workers
+     * @note must not be called from a task of this executor, it terminates the process then
+     */
+    ~WorkStealingTaskExecutor();
+
+    /**
+     * @brief Add task for execution and wake a sleeping worker up if any.
+     * @note can be called from multiple threads and from the tasks, tasks can run concurrently.
+     * @param task - shared pointer to the task to start
+     *  @return true if succeed to add task, otherwise - false
+     */
+    bool startTask(Task::Ptr task) override;
+
+    size_t getWorkersNumber() const;
+
+private:
+    struct Worker {
+        std::mutex queueMutex;
+        std::deque<Task::Ptr> taskQueue;
+        std::thread thread;
+    };
+
+    void run(size_t index, int cpu);
+
+    // Oldest task of the queue or nullptr, called with the queue mutex held
+    Task::Ptr popTask(Worker &worker);
+
+    Task::Ptr takeTask(size_t index);
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::atomic<size_t> _nextWorker;
+    // Tasks in the queues, and tasks in the queues or running
+    std::atomic<size_t> _queuedTasks;
+    std::atomic<size_t> _pendingTasks;
+
+    std::mutex _sleepMutex;
+    std::condition_variable _sleepCondVar;
+    std::condition_variable _doneCondVar;
+    std::atomic<unsigned int> _sleepingWorkers;
+    std::atomic<bool> _isStopped;
+    unsigned int _spinCount;
+    std::string _name;
+};
+
+}  // namespace InferenceEngine
@@ -46,6 +46,10 @@ public:
         _userData = data;
     }
 
+    void SetCompletionQueue(const ICompletionQueue::Ptr &queue) {
+        _completionQueue = queue;
+    }
+
     /**
      * @brief Set weak pointer to the corresponding public interface: IInferRequest. This allow to pass it to
      * IInferRequest::CompletionCallback
@@ -58,6 +62,7 @@ public:
 protected:
     IInferRequest::WeakPtr _publicInterface;
     InferenceEngine::IInferRequest::CompletionCallback _callback;
+    std::weak_ptr<ICompletionQueue> _completionQueue;
     void *_userData;
 };
 
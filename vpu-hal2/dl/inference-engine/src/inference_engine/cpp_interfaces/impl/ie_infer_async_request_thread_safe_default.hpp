@@ -16,20 +16,35 @@
 
 #include <memory>
 #include <map>
-#include <list>
+#include <array>
+#include <vector>
 #include <string>
 #include <mutex>
 #include <exception>
+#include <algorithm>
+#include <thread>
+#include <atomic>
 #include <cpp_interfaces/interface/ie_iinfer_async_request_internal.hpp>
 #include <cpp_interfaces/ie_task_with_stages.hpp>
 #include <cpp_interfaces/ie_task_executor.hpp>
 #include <cpp_interfaces/exception2status.hpp>
+#include <ie_trace.hpp>
 #include "ie_infer_async_request_thread_safe_internal.hpp"
 
 namespace InferenceEngine {
 
+/**
+ * @brief Runs the sync request on the request executor and the callback on the callback executor.
+ * The staged tasks are kept in a fixed ring and reused, a new task is only needed when StartAsync is called
+ * while the previous one still runs its callback. Tasks the ring has no room for go to an overflow list.
+ * With the tracer enabled, each inference gets a trace request id its stages record their scopes with.
+ * With a completion queue, the last stage releases the request and pushes it to the queue. The push and a
+ * restart of the request are serialized, so the queue only gets requests no other thread has started again.
+ */
 class AsyncInferRequestThreadSafeDefault : public AsyncInferRequestThreadSafeInternal {
 public:
+    static constexpr size_t ASYNC_TASK_RING_SIZE = 4;
+
     typedef std::shared_ptr<AsyncInferRequestThreadSafeDefault> Ptr;
 
     explicit AsyncInferRequestThreadSafeDefault(IInferRequestInternal::Ptr request,
@@ -51,20 +66,18 @@ public:
 
     void waitAllAsyncTasks() {
         try {
-            while (!_listAsyncTasks.empty()) {
-                _listAsyncTasks.remove_if([this](StagedTask::Ptr task) -> bool {
-                    auto sts = task->getStatus();
-                    return !task->isOnWait() && (Task::Status::TS_DONE == sts || Task::Status::TS_ERROR == sts ||
-                                                 Task::Status::TS_INITIAL == sts);
-                });
-                auto findIter = std::find_if(_listAsyncTasks.begin(), _listAsyncTasks.end(),
-                                             [this](StagedTask::Ptr task) { return !task->isOnWait(); });
-                if (findIter != _listAsyncTasks.end()) {
-                    try {
-                        (*findIter)->wait(-1);
-                    } catch (...) {}
+            bool isPending = true;
+            while (isPending) {
+                isPending = false;
+                for (auto &task : _asyncTasks) {
+                    isPending |= waitAsyncTask(task);
+                }
+                for (auto &task : _overflowAsyncTasks) {
+                    isPending |= waitAsyncTask(task);
                 }
+                if (isPending) std::this_thread::yield();
             }
+            _overflowAsyncTasks.clear();
         } catch (...) {}
     }
 
@@ -72,17 +85,26 @@ public:
         IE_PROFILING_AUTO_SCOPE(initNextAsyncTask)
         // Most probably was called from callback (or when callback was started) or it was a sync task before, so new task is required
         if (_currentTask->getStatus() == Task::Status::TS_POSTPONED || _currentTask == _syncTask) {
-            auto findIter = std::find_if(_listAsyncTasks.begin(), _listAsyncTasks.end(),
-                                         [this](StagedTask::Ptr task) -> bool {
-                                             return (!task->isOnWait()) && (task != _currentTask) &&
-                                                    (Task::Status::TS_DONE == task->getStatus() ||
-                                                     Task::Status::TS_ERROR == task->getStatus());
-                                         });
-            if (findIter == _listAsyncTasks.end()) {
+            _asyncTask = nullptr;
+            for (size_t i = 0; i < ASYNC_TASK_RING_SIZE && !_asyncTask; i++) {
+                auto &task = _asyncTasks[_nextAsyncTask];
+                _nextAsyncTask = (_nextAsyncTask + 1) % ASYNC_TASK_RING_SIZE;
+                if (!task) {
+                    task = createAsyncRequestTask();
+                    _asyncTask = task;
+                } else if (isAsyncTaskFree(task)) {
+                    _asyncTask = task;
+                }
+            }
+            if (!_asyncTask) {
+                // callbacks still running on every task of the ring, e.g. StartAsync from callbacks run concurrently
+                _overflowAsyncTasks.erase(std::remove_if(_overflowAsyncTasks.begin(), _overflowAsyncTasks.end(),
+                                                         [this](const StagedTask::Ptr &task) {
+                                                             return isAsyncTaskFree(task);
+                                                         }),
+                                          _overflowAsyncTasks.end());
                 _asyncTask = createAsyncRequestTask();
-                _listAsyncTasks.push_back(_asyncTask);
-            } else {
-                _asyncTask = *findIter;
+                _overflowAsyncTasks.push_back(_asyncTask);
             }
         }
         _asyncTask->resetStages();
@@ -93,41 +115,75 @@ public:
         if (!_requestExecutor->startTask(_currentTask)) THROW_IE_EXCEPTION << REQUEST_BUSY_str;
     }
 
+    void StartAsync() override {
+        {
+            // the restart bumps the ticket the pending completion is checked against, see pushToCompletionQueue
+            std::lock_guard<std::mutex> lock(_completionMutex);
+            if (!occupyRequest()) THROW_IE_EXCEPTION << REQUEST_BUSY_str;
+            _asyncStartCount++;
+        }
+        try {
+            StartAsync_ThreadUnsafe();
+        } catch (...) {
+            setIsRequestBusy(false);
+            std::rethrow_exception(std::current_exception());
+        }
+    }
+
     void StartAsync_ThreadUnsafe() override {
         initNextAsyncTask();
+        _traceRequestId = Tracer::isEnabled() ? Tracer::newRequestId() : 0;
+        IE_TRACE_BEGIN("request", "Queued", _traceRequestId)
         startAsyncTask();
     }
 
     virtual StagedTask::Ptr createAsyncRequestTask() {
         return std::make_shared<StagedTask>([this]() {
             auto asyncTaskCopy = _asyncTask;
+            size_t asyncStart = _asyncStartCount;
+            bool isReleased = false;
             try {
                 switch (asyncTaskCopy->getStage()) {
                     case 2: {
-                        _syncRequest->Infer();
+                        IE_TRACE_REQUEST_SCOPE(_traceRequestId)
+                        IE_TRACE_END("request", "Queued", _traceRequestId)
+                        {
+                            IE_TRACE_SCOPE("request", "Infer")
+                            _syncRequest->Infer();
+                        }
                         asyncTaskCopy->stageDone();
                         if (_callback) {
+                            IE_TRACE_BEGIN("request", "CallbackQueued", _traceRequestId)
                             _callbackExecutor->startTask(asyncTaskCopy);
                         } else {
                             asyncTaskCopy->stageDone();
+                            pushToCompletionQueue(OK, asyncStart, isReleased);
                         }
                     }
                         break;
                     case 1: {
+                        // read before the request is released to the next inference
+                        IE_TRACE_REQUEST_SCOPE(_traceRequestId)
+                        IE_TRACE_END("request", "CallbackQueued", _traceRequestId)
+                        IE_TRACE_SCOPE("request", "Callback")
                         auto requestPtr = _publicInterface.lock();
                         if (!requestPtr) {
                             THROW_IE_EXCEPTION << "Failed to run callback: can't get pointer to request";
                         }
                         setIsRequestBusy(false);
+                        isReleased = true;
                         _callback(requestPtr, Task::TaskStatus2StatusCode(asyncTaskCopy->getStatus()));
                         asyncTaskCopy->stageDone();
+                        pushToCompletionQueue(OK, asyncStart, isReleased);
                     }
                         break;
                     default:
                         break;
                 }
             } catch (...) {
-                setIsRequestBusy(false);
+                if (!pushToCompletionQueue(GENERAL_ERROR, asyncStart, isReleased) && !isReleased) {
+                    setIsRequestBusy(false);
+                }
                 std::rethrow_exception(std::current_exception());
             }
         }, 2);
@@ -145,7 +201,9 @@ public:
             status = taskCopy->getStatus();
         } else {
             status = taskCopy->wait(millis_timeout);
-            setIsRequestBusy(false);
+            // the callback and the completion queue release the request themselves, by now another
+            // thread may have started the next inference on it
+            if (!_callback && !_completionQueue.lock()) setIsRequestBusy(false);
         }
 
         taskCopy->checkException();
@@ -153,6 +211,9 @@ public:
     }
 
     void Infer_ThreadUnsafe() override {
+        _traceRequestId = Tracer::isEnabled() ? Tracer::newRequestId() : 0;
+        IE_TRACE_REQUEST_SCOPE(_traceRequestId)
+        IE_TRACE_SCOPE("request", "Infer")
         _currentTask = _syncTask;
         auto status = _currentTask->runWithSynchronizer(_requestSynchronizer);
         if (status == Task::Status::TS_BUSY)
@@ -176,6 +237,10 @@ public:
         _callback = callback;
     }
 
+    void SetCompletionQueue_ThreadUnsafe(const ICompletionQueue::Ptr &queue) override {
+        _completionQueue = queue;
+    }
+
     void GetUserData_ThreadUnsafe(void **data) override {
         if (data == nullptr) THROW_IE_EXCEPTION << NOT_ALLOCATED_str;
         *data = _userData;
@@ -190,6 +255,29 @@ public:
     }
 
 protected:
+    /**
+     * @brief Releases the request and pushes it to its completion queue, if it has one, called by the last
+     * stage of the async task. The error of a failed inference is thrown by Wait.
+     * The check, the release and the push are done under the lock StartAsync takes to occupy the request, so
+     * that a request started again in between is neither released nor pushed
+     * @param asyncStart - number of StartAsync calls when the stage began, nothing is pushed if the request
+     * has been started again since
+     * @param isReleased - the request was released before the callback, nothing is pushed if another thread
+     * took it since
+     * @return true if the request was pushed
+     */
+    bool pushToCompletionQueue(StatusCode status, size_t asyncStart, bool isReleased) {
+        auto queue = _completionQueue.lock();
+        if (!queue) return false;
+        auto requestPtr = _publicInterface.lock();
+        if (!requestPtr) return false;
+        std::lock_guard<std::mutex> lock(_completionMutex);
+        if (asyncStart != _asyncStartCount || (isReleased && isRequestBusy())) return false;
+        setIsRequestBusy(false);
+        queue->Push(requestPtr, status, nullptr);
+        return true;
+    }
+
     ITaskExecutor::Ptr _requestExecutor;
     ITaskExecutor::Ptr _callbackExecutor;
     TaskSynchronizer::Ptr _requestSynchronizer;
@@ -197,10 +285,39 @@ protected:
     Task::Ptr _syncTask;
     StagedTask::Ptr _asyncTask;
     Task::Ptr _currentTask;
-    std::list<StagedTask::Ptr> _listAsyncTasks;
+    std::array<StagedTask::Ptr, ASYNC_TASK_RING_SIZE> _asyncTasks;
+    size_t _nextAsyncTask = 0;
+    std::vector<StagedTask::Ptr> _overflowAsyncTasks;
     InferenceEngine::IInferRequest::CompletionCallback _callback;
+    std::weak_ptr<ICompletionQueue> _completionQueue;
+    std::atomic<size_t> _asyncStartCount{0};
+    std::mutex _completionMutex;
     InferenceEngine::IInferRequest::WeakPtr _publicInterface;
     void *_userData;
+    uint64_t _traceRequestId = 0;
+
+private:
+    bool isAsyncTaskFree(const StagedTask::Ptr &task) const {
+        if (task->isOnWait() || task == _currentTask) return false;
+        auto status = task->getStatus();
+        return Task::Status::TS_DONE == status || Task::Status::TS_ERROR == status;
+    }
+
+    /**
+     * @brief Waits for the task unless another thread already waits for it
+     * @return true if the task may still be running
+     */
+    bool waitAsyncTask(const StagedTask::Ptr &task) {
+        if (!task) return false;
+        auto status = task->getStatus();
+        if (task->isOnWait()) return true;
+        if (Task::Status::TS_DONE == status || Task::Status::TS_ERROR == status ||
+            Task::Status::TS_INITIAL == status) return false;
+        try {
+            task->wait(-1);
+        } catch (...) {}
+        return false;
+    }
 };
 
 }  // namespace InferenceEngine
@@ -17,6 +17,7 @@
 #include <memory>
 #include <map>
 #include <string>
+#include <atomic>
 #include <cpp_interfaces/ie_task.hpp>
 #include "cpp_interfaces/interface/ie_iinfer_async_request_internal.hpp"
 #include "cpp_interfaces/impl/ie_infer_request_internal.hpp"
@@ -25,17 +26,16 @@ namespace InferenceEngine {
 
 /**
  * @brief Wrapper of async request to support thread-safe execution.
+ * @note The busy flag is an atomic, StartAsync and Infer take the request with a single compare-exchange
+ * so two threads can't both pass the check
  */
 class AsyncInferRequestThreadSafeInternal : public IAsyncInferRequestInternal {
-    bool _isRequestBusy = false;
-    std::mutex _isBusyMutex;
+    std::atomic<bool> _isRequestBusy;
 
 public:
     typedef std::shared_ptr<AsyncInferRequestThreadSafeInternal> Ptr;
 
-    AsyncInferRequestThreadSafeInternal() {
-        setIsRequestBusy(false);
-    }
+    AsyncInferRequestThreadSafeInternal() : _isRequestBusy(false) {}
 
 protected:
     virtual bool isRequestBusy() const {
@@ -43,14 +43,21 @@ protected:
     }
 
     virtual void setIsRequestBusy(bool isBusy) {
-        std::unique_lock<std::mutex> lock(_isBusyMutex);
         _isRequestBusy = isBusy;
     }
 
+    /**
+     * @brief Makes the request busy if it is not
+     * @return false if the request is already busy
+     */
+    bool occupyRequest() {
+        bool isBusy = false;
+        return _isRequestBusy.compare_exchange_strong(isBusy, true);
+    }
+
 public:
     void StartAsync() override {
-        if (isRequestBusy()) THROW_IE_EXCEPTION << REQUEST_BUSY_str;
-        setIsRequestBusy(true);
+        if (!occupyRequest()) THROW_IE_EXCEPTION << REQUEST_BUSY_str;
         try {
             StartAsync_ThreadUnsafe();
         } catch (...) {
@@ -74,9 +81,13 @@ public:
         SetCompletionCallback_ThreadUnsafe(callback);
     }
 
-    void Infer() override {
+    void SetCompletionQueue(const ICompletionQueue::Ptr &queue) override {
         if (isRequestBusy()) THROW_IE_EXCEPTION << REQUEST_BUSY_str;
-        setIsRequestBusy(true);
+        SetCompletionQueue_ThreadUnsafe(queue);
+    }
+
+    void Infer() override {
+        if (!occupyRequest()) THROW_IE_EXCEPTION << REQUEST_BUSY_str;
         try {
             Infer_ThreadUnsafe();
         } catch (...) {
@@ -113,6 +124,8 @@ public:
 
     virtual void SetCompletionCallback_ThreadUnsafe(IInferRequest::CompletionCallback callback) = 0;
 
+    virtual void SetCompletionQueue_ThreadUnsafe(const ICompletionQueue::Ptr &queue) = 0;
+
     virtual void Infer_ThreadUnsafe() = 0;
 
     virtual void
@@ -18,6 +18,7 @@
 #include <map>
 #include <string>
 #include <ie_iinfer_request.hpp>
+#include <ie_icompletion_queue.hpp>
 #include "ie_iinfer_request_internal.hpp"
 
 namespace InferenceEngine {
@@ -66,6 +67,12 @@ public:
      * * @return Enumeration of the resulted action: OK (0) for success.
      */
     virtual void SetCompletionCallback(IInferRequest::CompletionCallback callback) = 0;
+
+    /**
+     * @brief Set the completion queue the request is pushed to when an asynchronous inference completes
+     * @param queue - the queue, held weakly, nullptr detaches the request
+     */
+    virtual void SetCompletionQueue(const ICompletionQueue::Ptr &queue) = 0;
 };
 
 }  // namespace InferenceEngine
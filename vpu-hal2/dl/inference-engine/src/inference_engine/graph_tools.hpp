@@ -42,6 +42,7 @@
 #include <memory>
 #include <functional>
 #include "layer_transform.hpp"
+#include "indexed_graph.hpp"
 
 
 #include "ie_icnn_network.hpp"
@@ -51,113 +52,29 @@ namespace InferenceEngine {
 namespace details {
 
 /**
- * @brief implementation of DFS with visiting checking to avoid multientry
- * @param visited - set to store visited layers
- * @param layer - current layer to start DFS from
- * @param visit - user callback on visited node
- * @param visitBefore - indicates when callback is happened before all child nodes or after
- * @return false if cycle detected
- */
-template<class T>
-inline bool DFS(std::unordered_map<CNNLayer *, bool> &visited,
-                const InferenceEngine::CNNLayerPtr &layer,
-                const T &visit,
-                bool visitBefore) {
-    if (layer == nullptr) {
-        return true;
-    }
-
-    if (visitBefore) visit(layer);
-    visited[layer.get()] = false;
-    for (auto &od : layer->outData) {
-        for (auto nl : od->getInputTo()) {
-            auto i = visited.find(nl.second.get());
-            if (i != visited.end()) {
-                /**
-                 * cycle detected we entered still not completed node
-                 */
-                if (!i->second) {
-                    return false;
-                }
-                continue;
-            }
-            if (!DFS(visited, nl.second, visit, visitBefore)) {
-                return false;
-            }
-        }
-    }
-    if (!visitBefore) visit(layer);
-    visited[layer.get()] = true;
-    return true;
-}
-
-
-/**
- * @brief implementation of DFS in unordered graph, mean next layers not just child but also parents
- * @param visited - set to store visited layers
- * @param layer - current layer to start UnorderedDFS from
- * @param visit - user callback on visited node
- * @param visitBefore - indicates when callback is happened before all child nodes or after
- */
-template<class T>
-inline void UnorderedDFS(std::unordered_set<CNNLayer *> &visited,
-                const InferenceEngine::CNNLayerPtr &layer,
-                const T &visit,
-                bool visitBefore) {
-    if (layer == nullptr) {
-        return;
-    }
-    if (visited.end() != visited.find(layer.get())) {
-        return;
-    }
-
-    if (visitBefore) visit(layer);
-    visited.insert(layer.get());
-
-    // visit childs
-    for (auto &od : layer->outData) {
-        for (auto nl : od->getInputTo()) {
-            UnorderedDFS(visited, nl.second, visit, visitBefore);
-        }
-    }
-
-    // visit parents
-    for (auto && input  : layer->insData) {
-        UnorderedDFS(visited, input.lock()->getCreatorLayer().lock(), visit, visitBefore);
-    }
-
-    if (!visitBefore) visit(layer);
-}
-
-/**
- * @brief implementation of DFS with visiting checking to avoid multyentry
- * @param visited - set to store visited layers
- * @param layer - current layer to start DFS from
+ * @brief implementation of BFS with visiting checking to avoid multientry
+ * @param layer - current layer to start BFS from
  * @param visit - user callback on visited node
+ * @param maxDepth - levels to visit, -1 for all of them
  */
 template<class T>
-inline void BFS(InferenceEngine::CNNLayerPtr layer, const T &visit, int maxDepth) {
-    std::set<InferenceEngine::CNNLayer*> visited;
-    std::list<InferenceEngine::CNNLayerPtr> nextLayers;
-    nextLayers.push_back(layer);
-
-    int layersOnLevel = 1;
-    for (; !nextLayers.empty() && maxDepth != 0;) {
-        visit(*nextLayers.begin());
-        for (auto &od : (*nextLayers.begin())->outData) {
-            for (auto nl : od->getInputTo()) {
-                if (visited.find(nl.second.get()) == visited.end()) {
-                    nextLayers.push_back(nl.second);
-                    visited.insert(nl.second.get());
+inline void BFS(const InferenceEngine::CNNLayerPtr &layer, const T &visit, int maxDepth) {
+    std::unordered_set<InferenceEngine::CNNLayer*> visited = {layer.get()};
+    std::vector<InferenceEngine::CNNLayerPtr> level = {layer}, nextLevel;
+
+    for (; !level.empty() && maxDepth != 0; maxDepth--) {
+        for (auto &current : level) {
+            visit(current);
+            for (auto &od : current->outData) {
+                for (auto &nl : od->getInputTo()) {
+                    if (visited.insert(nl.second.get()).second) {
+                        nextLevel.push_back(nl.second);
+                    }
                 }
             }
         }
-        nextLayers.pop_front();
-        // move to nextLayer
-        if (!--layersOnLevel) {
-            layersOnLevel = nextLayers.size();
-            maxDepth--;
-        }
+        level.swap(nextLevel);
+        nextLevel.clear();
     }
 }
 
@@ -175,8 +92,8 @@ inline bool CNNNetDFS(const InferenceEngine::CNNLayerPtr &layer, const T &visit,
         return true;
     }
 
-    std::unordered_map < CNNLayer *, bool> visited;
-    return details::DFS(visited, layer, visit, visitBefore);
+    details::IndexedGraph graph({layer}, false);
+    return graph.dfs(graph.heads(), visit, visitBefore);
 }
 
 /**
@@ -191,13 +108,8 @@ inline bool CNNNetForestDFS(const Forest &heads, const T &visit, bool bVisitBefo
         return true;
     }
 
-    std::unordered_map< CNNLayer *, bool> visited;
-    for (auto & layer : heads) {
-        if (!details::DFS(visited, layer, visit, bVisitBefore)) {
-            return false;
-        }
-    }
-    return true;
+    details::IndexedGraph graph(std::vector<CNNLayerPtr>(heads.begin(), heads.end()), false);
+    return graph.dfs(graph.heads(), visit, bVisitBefore);
 }
 
 /**
@@ -312,48 +224,45 @@ using CNNLayerSet = std::set<CNNLayerPtr, LayerNameLess>;
  * @return set of input layers
  */
 inline CNNLayerSet CNNNetGetAllInputLayers(ICNNNetwork &network) {
-    InputsDataMap inputs;
-    network.getInputsInfo(inputs);
+    details::IndexedGraph graph(network);
 
     CNNLayerSet inputLayers;
-    std::unordered_set<CNNLayer *> allLayers;
-
-    if (inputs.empty())
-        return inputLayers;
-
-    auto & secondLayers = inputs.begin()->second->getInputData()->getInputTo();
-    if (secondLayers.empty())
-        return inputLayers;
-
-    details::UnorderedDFS(allLayers, secondLayers.begin()->second, [&](CNNLayerPtr layer){
-       if (layer->insData.empty()) {
-           inputLayers.insert(layer);
-       }
-    }, false);
+    for (auto id : graph.inputLayers()) {
+        inputLayers.insert(graph.layer(id));
+    }
     return inputLayers;
 }
 
-
 /**
  * Sort network layers topologically
- * @param network
+ * @param graph - indexed network, to share between the passes
  * @return sorted vector
  * @throws if sorting not possible - for example if loop detected
  */
-inline std::vector<CNNLayerPtr> CNNNetSortTopologically(ICNNNetwork & network) {
-    std::vector<CNNLayerPtr> stackOfVisited;
-    auto res = CNNNetForestDFS(CNNNetGetAllInputLayers(network), [&](CNNLayerPtr  current){
-        stackOfVisited.push_back(current);
-    }, false);
-
-    if (!res) {
+inline std::vector<CNNLayerPtr> CNNNetSortTopologically(const details::IndexedGraph & graph) {
+    std::vector<size_t> order;
+    if (!graph.sortTopologically(graph.inputLayers(), order)) {
         THROW_IE_EXCEPTION << "Sorting not possible, due to existed loop.";
     }
 
-    std::reverse(std::begin(stackOfVisited), std::end(stackOfVisited));
+    std::vector<CNNLayerPtr> sorted;
+    sorted.reserve(order.size());
+    for (auto id : order) {
+        sorted.push_back(graph.layer(id));
+    }
+    return sorted;
+}
 
-    return stackOfVisited;
+/**
+ * Sort network layers topologically
+ * @param network
+ * @return sorted vector
+ * @throws if sorting not possible - for example if loop detected
+ */
+inline std::vector<CNNLayerPtr> CNNNetSortTopologically(ICNNNetwork & network) {
+    return CNNNetSortTopologically(details::IndexedGraph(network));
 }
+
 /**
  * @brief copy Data from original graph, and insert into new graph, using layers remap information
  * @param input
@@ -34,11 +34,15 @@
 #include <sstream>
 #include <memory>
 #include <map>
+#include <vector>
+#include <cstdlib>
 
 #include "debug.h"
 #include "parsers.h"
 #include "ie_cnn_net_reader_impl.h"
 #include "v2_format_parser.h"
+#include "binary_format_parser.h"
+#include "mmap_allocator.hpp"
 #include <file_utils.h>
 #include <ie_plugin.hpp>
 #include "xml_parse_utils.h"
@@ -82,6 +86,12 @@ int CNNNetReaderImpl::GetFileVersion(pugi::xml_node& root) {
 }
 
 StatusCode CNNNetReaderImpl::ReadNetwork(const void* model, size_t size, ResponseDesc* resp) noexcept {
+    if (BinaryFormatParser::IsBinaryNetwork(model, size)) {
+        if (ReadBinaryNetwork(model, size) != OK) {
+            return DescriptionBuffer(resp) << "Error reading network: " << description;
+        }
+        return OK;
+    }
     pugi::xml_document xmlDoc;
     pugi::xml_parse_result res = xmlDoc.load_buffer(model, size);
     if (res.status != pugi::status_ok) {
@@ -107,19 +117,42 @@ StatusCode CNNNetReaderImpl::ReadWeights(const char* filepath, ResponseDesc* res
 
     size_t ulFileSize = static_cast<size_t>(fileSize);
 
-    TBlob<uint8_t>::Ptr weightsPtr(new TBlob<uint8_t>(Precision::U8, C, {ulFileSize}));
-    weightsPtr->allocate();
-    try {
-        FileUtils::readAllFile(filepath, weightsPtr->buffer(), ulFileSize);
+    // the layer blobs are proxies of the weights, mapped they are only read when used. The file must not be
+    // rewritten or truncated while the network lives then, so the mapping is asked for with IE_MMAP_WEIGHTS=1
+    TBlob<uint8_t>::Ptr weightsPtr;
+    const char* mapWeights = std::getenv("IE_MMAP_WEIGHTS");
+    if (mapWeights != nullptr && std::string(mapWeights) == "1") {
+        weightsPtr.reset(new TBlob<uint8_t>(Precision::U8, C, {ulFileSize},
+                                            shared_from_irelease(new MmapAllocator(filepath))));
+        weightsPtr->allocate();
     }
-    catch (const InferenceEngineException& iee) {
-        return DescriptionBuffer(resp) << iee.what();
+    if (weightsPtr == nullptr || weightsPtr->buffer() == nullptr) {
+        weightsPtr.reset(new TBlob<uint8_t>(Precision::U8, C, {ulFileSize}));
+        weightsPtr->allocate();
+        try {
+            FileUtils::readAllFile(filepath, weightsPtr->buffer(), ulFileSize);
+        }
+        catch (const InferenceEngineException& iee) {
+            return DescriptionBuffer(resp) << iee.what();
+        }
     }
 
     return SetWeights(weightsPtr, resp);
 }
 
 StatusCode CNNNetReaderImpl::ReadNetwork(const char* filepath, ResponseDesc* resp) noexcept {
+    char magic[sizeof(BinaryFormatParser::MAGIC)] = {};
+    std::ifstream file(filepath, std::ios::binary);
+    if (file.read(magic, sizeof(magic)) && BinaryFormatParser::IsBinaryNetwork(magic, sizeof(magic))) {
+        file.seekg(0);
+        std::vector<char> model((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (ReadBinaryNetwork(model.data(), model.size()) != OK) {
+            return DescriptionBuffer(resp) << "Error reading network: " << description;
+        }
+        return OK;
+    }
+    file.close();
+
     pugi::xml_document xmlDoc;
     pugi::xml_parse_result res = xmlDoc.load_file(filepath);
     if (res.status != pugi::status_ok) {
@@ -178,6 +211,27 @@ StatusCode CNNNetReaderImpl::ReadNetwork(pugi::xml_document& xmlDoc) {
     return OK;
 }
 
+StatusCode CNNNetReaderImpl::ReadBinaryNetwork(const void* model, size_t size) {
+    description.clear();
+
+    try {
+        // binary networks are converted from IR v2
+        version = 2;
+        auto parser = std::make_shared<BinaryFormatParser>();
+        network = parser->Parse(model, size);
+        _parser = parser;
+        name = network->getName();
+
+        parseSuccess = true;
+    } catch (const InferenceEngineException& e) {
+        description = e.what();
+        parseSuccess = false;
+        return GENERAL_ERROR;
+    }
+
+    return OK;
+}
+
 INFERENCE_ENGINE_API(InferenceEngine::ICNNNetReader*) InferenceEngine::CreateCNNNetReader() noexcept {
     return new CNNNetReaderImpl;
 }
@@ -95,6 +95,8 @@ private:
 
     StatusCode ReadNetwork(pugi::xml_document &xmlDoc);
 
+    StatusCode ReadBinaryNetwork(const void *model, size_t size);
+
     std::string description;
     std::string name;
     InferenceEngine::details::CNNNetworkImplPtr network;
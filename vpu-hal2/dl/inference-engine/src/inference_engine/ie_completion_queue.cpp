@@ -0,0 +1,141 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+#include <ie_icompletion_queue.hpp>
+
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+
+#include "cpp_interfaces/exception2status.hpp"
+
+namespace InferenceEngine {
+
+namespace {
+
+/**
+ * @brief The completions are queued under a mutex, a push wakes one waiter only and notifies nobody when no
+ * thread waits, so the cost of a completion doesn't depend on the number of requests or waiters
+ */
+class CompletionQueueImpl : public ICompletionQueue {
+public:
+    StatusCode Push(const IInferRequest::Ptr &request, StatusCode status, ResponseDesc *resp) noexcept override {
+        TO_STATUS(push(request, status));
+    }
+
+    StatusCode WaitSome(Completion *completions, size_t maxCount, size_t &count, int64_t millis_timeout,
+                        ResponseDesc *resp) noexcept override {
+        count = 0;
+        if (completions == nullptr || maxCount == 0) {
+            return DescriptionBuffer(PARAMETER_MISMATCH, resp) << "No room for the completions";
+        }
+        if (millis_timeout < IInferRequest::WaitMode::RESULT_READY) {
+            return DescriptionBuffer(PARAMETER_MISMATCH, resp) << "Timeout can't be less "
+                                                               << IInferRequest::WaitMode::RESULT_READY;
+        }
+        NO_EXCEPT_CALL_RETURN_STATUS(waitSome(completions, maxCount, count, millis_timeout));
+    }
+
+    size_t Size() const noexcept override {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _completions.size();
+    }
+
+    void Release() noexcept override {
+        delete this;
+    }
+
+private:
+    void push(const IInferRequest::Ptr &request, StatusCode status) {
+        bool isWaitedFor = false;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _completions.push_back({request, status});
+            isWaitedFor = _waiters > 0;
+        }
+        if (isWaitedFor) _completionQueued.notify_one();
+    }
+
+    StatusCode waitSome(Completion *completions, size_t maxCount, size_t &count, int64_t millis_timeout) {
+        // the requests the array held are released out of the lock, their destructors may wait for a push
+        for (size_t i = 0; i < maxCount; i++) {
+            completions[i].request.reset();
+        }
+
+        bool isLeftForOthers = false;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (_completions.empty() && millis_timeout != IInferRequest::WaitMode::STATUS_ONLY) {
+                auto predicate = [this]() { return !_completions.empty(); };
+                _waiters++;
+                if (millis_timeout < 0) {
+                    _completionQueued.wait(lock, predicate);
+                } else {
+                    _completionQueued.wait_for(lock, std::chrono::milliseconds(millis_timeout), predicate);
+                }
+                _waiters--;
+            }
+            if (_completions.empty()) return RESULT_NOT_READY;
+
+            for (; count < maxCount && !_completions.empty(); count++) {
+                completions[count] = std::move(_completions.front());
+                _completions.pop_front();
+            }
+            isLeftForOthers = !_completions.empty() && _waiters > 0;
+        }
+        // each push woke one waiter, hand the completions this one left to another
+        if (isLeftForOthers) _completionQueued.notify_one();
+        return OK;
+    }
+
+protected:
+    ~CompletionQueueImpl() override = default;
+
+private:
+    mutable std::mutex _mutex;
+    std::condition_variable _completionQueued;
+    std::deque<Completion> _completions;
+    size_t _waiters = 0;
+};
+
+}  // namespace
+
+INFERENCE_ENGINE_API(ICompletionQueue*) CreateCompletionQueue() noexcept {
+    try {
+        return new CompletionQueueImpl();
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+}  // namespace InferenceEngine
@@ -196,6 +196,14 @@ void topoVisitSubgraph(std::vector<SubgraphDesc>& subgraphs,
 void sortSubgraphs(std::vector<LayersSet>& subgraphs) {
     std::vector<SubgraphDesc> descs(subgraphs.size());
 
+    // subgraph of each layer, the subgraphs don't share layers
+    std::unordered_map<const CNNLayer*, std::size_t> subgraphOf;
+    for (auto i : util::iota(subgraphs.size())) {
+        for (auto&& layer : subgraphs[i]) {
+            subgraphOf.emplace(layer.get(), i);
+        }
+    }
+
     for (auto i : util::iota(subgraphs.size())) {
         auto& subgraph = subgraphs[i];
         assert(!subgraph.empty());
@@ -206,13 +214,9 @@ void sortSubgraphs(std::vector<LayersSet>& subgraphs) {
                 assert(nullptr != data);
                 auto prevLayer = data->creatorLayer.lock();
                 if (nullptr != prevLayer) {
-                    for (auto j : util::iota(subgraphs.size())) {
-                        if (i != j) {
-                            if (util::contains(subgraphs[j], prevLayer)) {
-                                descs[i].dependsOn.insert(j);
-                                break;
-                            }
-                        }
+                    auto it = subgraphOf.find(prevLayer.get());
+                    if (it != subgraphOf.end() && it->second != i) {
+                        descs[i].dependsOn.insert(it->second);
                     }
                 }
             }
@@ -0,0 +1,270 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+#include "ie_trace.hpp"
+
+#include <cstdlib>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <map>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "details/ie_exception.hpp"
+
+namespace InferenceEngine {
+
+std::atomic<bool> Tracer::_enabled(false);
+
+namespace {
+
+// Written by its thread only, read by flush, the thread and flush own the buffer together
+struct ThreadBuffer {
+    explicit ThreadBuffer(uint32_t id) : threadId(id), events(new TraceEvent[Tracer::RING_SIZE]) {}
+
+    const uint32_t threadId;
+    std::string name;
+    std::unique_ptr<TraceEvent[]> events;
+    std::atomic<size_t> head{0};
+    std::atomic<size_t> tail{0};
+    std::atomic<size_t> dropped{0};
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    // names of the threads flushed, the buffers of exited threads are dropped once empty
+    std::map<uint32_t, std::string> threadNames;
+    uint32_t nextThreadId = 1;
+};
+
+Registry &registry() {
+    // never destroyed, the threads may record after the static objects are gone
+    static Registry *instance = new Registry();
+    return *instance;
+}
+
+thread_local std::shared_ptr<ThreadBuffer> threadBuffer;
+thread_local std::string threadName;
+thread_local uint64_t currentRequest = 0;
+
+std::atomic<uint64_t> nextRequestId(1);
+
+ThreadBuffer &getThreadBuffer() {
+    if (!threadBuffer) {
+        auto &instance = registry();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        threadBuffer = std::make_shared<ThreadBuffer>(instance.nextThreadId++);
+        threadBuffer->name = threadName;
+        instance.buffers.push_back(threadBuffer);
+    }
+    return *threadBuffer;
+}
+
+void writeString(std::ostream &out, const std::string &value) {
+    out << '"';
+    for (auto c : value) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+int processId() {
+#ifndef _WIN32
+    return static_cast<int>(getpid());
+#else
+    return 1;
+#endif
+}
+
+// Enables the tracer for IE_TRACE_FILE and exports to it when the library unloads
+struct TraceFile {
+    TraceFile() {
+        auto fileName = std::getenv("IE_TRACE_FILE");
+        if (fileName != nullptr && *fileName != '\0') {
+            _fileName = fileName;
+            Tracer::enable(true);
+        }
+    }
+
+    ~TraceFile() {
+        if (_fileName.empty()) return;
+        try {
+            Tracer::exportChromeTrace(_fileName);
+        } catch (...) {}
+    }
+
+private:
+    std::string _fileName;
+};
+
+TraceFile traceFile;
+
+}  // namespace
+
+void Tracer::enable(bool enabled) noexcept {
+    _enabled.store(enabled, std::memory_order_relaxed);
+}
+
+uint64_t Tracer::now() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracer::record(char phase, const char *category, const char *name, uint64_t requestId,
+                    uint64_t timestamp) noexcept {
+    try {
+        auto &buffer = getThreadBuffer();
+        auto head = buffer.head.load(std::memory_order_relaxed);
+        if (head - buffer.tail.load(std::memory_order_acquire) >= RING_SIZE) {
+            buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        auto &event = buffer.events[head & (RING_SIZE - 1)];
+        event.category = category;
+        event.name = name;
+        event.timestamp = timestamp;
+        event.requestId = requestId;
+        event.threadId = buffer.threadId;
+        event.phase = phase;
+        buffer.head.store(head + 1, std::memory_order_release);
+    } catch (...) {}
+}
+
+uint64_t Tracer::newRequestId() noexcept {
+    return nextRequestId.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t Tracer::currentRequestId() noexcept {
+    return currentRequest;
+}
+
+void Tracer::setCurrentRequestId(uint64_t requestId) noexcept {
+    currentRequest = requestId;
+}
+
+void Tracer::setThreadName(const std::string &name) {
+    threadName = name;
+    if (threadBuffer) {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        threadBuffer->name = name;
+    }
+}
+
+size_t Tracer::flush(std::vector<TraceEvent> &events) {
+    auto &instance = registry();
+    std::lock_guard<std::mutex> lock(instance.mutex);
+    size_t dropped = 0;
+    for (auto &buffer : instance.buffers) {
+        auto tail = buffer->tail.load(std::memory_order_relaxed);
+        auto head = buffer->head.load(std::memory_order_acquire);
+        for (; tail != head; tail++) {
+            events.push_back(buffer->events[tail & (RING_SIZE - 1)]);
+        }
+        buffer->tail.store(tail, std::memory_order_release);
+        dropped += buffer->dropped.exchange(0, std::memory_order_relaxed);
+        if (!buffer->name.empty()) {
+            instance.threadNames[buffer->threadId] = buffer->name;
+        }
+    }
+    // only the registry holds the buffers of the exited threads, they were just drained
+    instance.buffers.erase(std::remove_if(instance.buffers.begin(), instance.buffers.end(),
+                                          [](const std::shared_ptr<ThreadBuffer> &buffer) {
+                                              return buffer.use_count() == 1;
+                                          }),
+                           instance.buffers.end());
+    return dropped;
+}
+
+void Tracer::writeChromeTrace(std::ostream &out, const std::vector<TraceEvent> &events) {
+    auto pid = processId();
+    std::map<uint32_t, std::string> threadNames;
+    {
+        auto &instance = registry();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        threadNames = instance.threadNames;
+    }
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool isFirst = true;
+    auto separator = [&]() {
+        out << (isFirst ? "\n" : ",\n");
+        isFirst = false;
+    };
+    for (const auto &threadName : threadNames) {
+        separator();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << threadName.first
+            << ",\"args\":{\"name\":";
+        writeString(out, threadName.second);
+        out << "}}";
+    }
+    out << std::fixed << std::setprecision(3);
+    for (const auto &event : events) {
+        separator();
+        // the scopes of a request are async events: they may begin and end on different threads
+        char phase = event.requestId ? static_cast<char>(event.phase - 'A' + 'a') : event.phase;
+        out << "{\"name\":";
+        writeString(out, event.name);
+        out << ",\"cat\":";
+        writeString(out, event.category);
+        out << ",\"ph\":\"" << phase << "\",\"ts\":" << event.timestamp / 1000.0 << ",\"pid\":" << pid
+            << ",\"tid\":" << event.threadId;
+        if (event.requestId) {
+            out << ",\"id\":" << event.requestId << ",\"args\":{\"request\":" << event.requestId << "}";
+        }
+        out << "}";
+    }
+    out << "\n]}\n";
+}
+
+void Tracer::exportChromeTrace(const std::string &fileName) {
+    std::vector<TraceEvent> events;
+    flush(events);
+    std::ofstream file(fileName);
+    if (!file) THROW_IE_EXCEPTION << "Failed to create " << fileName;
+    writeChromeTrace(file, events);
+    if (!file) THROW_IE_EXCEPTION << "Failed to write " << fileName;
+}
+
+}  // namespace InferenceEngine
@@ -0,0 +1,183 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ostream>
+#include "ie_api.h"
+
+namespace InferenceEngine {
+
+/**
+ * @brief A scope of the trace begins ('B') or ends ('E')
+ */
+struct TraceEvent {
+    // string literals, the events keep the pointers
+    const char *category;
+    const char *name;
+    // nanoseconds of std::chrono::steady_clock
+    uint64_t timestamp;
+    // inference the event belongs to, 0 if none
+    uint64_t requestId;
+    uint32_t threadId;
+    char phase;
+};
+
+/**
+ * @brief Records the trace events of the process to a ring buffer of each thread, without locks.
+ * The events are only recorded while the tracer is enabled, disabled a scope costs a relaxed load.
+ * A full ring drops the events until it is flushed. Setting IE_TRACE_FILE to a file name enables
+ * the tracer at startup and exports the events there at exit.
+ */
+class INFERENCE_ENGINE_API_CLASS(Tracer) {
+public:
+    static const size_t RING_SIZE = 1 << 16;
+
+    static bool isEnabled() noexcept {
+        return _enabled.load(std::memory_order_relaxed);
+    }
+
+    static void enable(bool enabled) noexcept;
+
+    static uint64_t now() noexcept;
+
+    static void record(char phase, const char *category, const char *name, uint64_t requestId,
+                       uint64_t timestamp) noexcept;
+
+    static void begin(const char *category, const char *name, uint64_t requestId) noexcept {
+        if (isEnabled()) record('B', category, name, requestId, now());
+    }
+
+    static void end(const char *category, const char *name, uint64_t requestId) noexcept {
+        if (isEnabled()) record('E', category, name, requestId, now());
+    }
+
+    static uint64_t newRequestId() noexcept;
+
+    /**
+     * @brief Request of the scopes of the calling thread
+     */
+    static uint64_t currentRequestId() noexcept;
+
+    static void setCurrentRequestId(uint64_t requestId) noexcept;
+
+    /**
+     * @brief Names the calling thread in the exported traces
+     */
+    static void setThreadName(const std::string &name);
+
+    /**
+     * @brief Moves the recorded events of all the threads to events
+     * @return number of events dropped by full rings since the last flush
+     */
+    static size_t flush(std::vector<TraceEvent> &events);
+
+    /**
+     * @brief Writes the events in the Chrome trace_event JSON format, the events of a request as async events
+     * so the inference shows on its own row across the threads
+     */
+    static void writeChromeTrace(std::ostream &out, const std::vector<TraceEvent> &events);
+
+    /**
+     * @brief Flushes the events and writes them to fileName in the Chrome trace_event JSON format
+     */
+    static void exportChromeTrace(const std::string &fileName);
+
+private:
+    static std::atomic<bool> _enabled;
+};
+
+/**
+ * @brief Records the begin and the end of a scope of the current request
+ */
+class TraceScope {
+public:
+    TraceScope(const char *category, const char *name) noexcept
+            : _category(category), _name(name), _isActive(Tracer::isEnabled()), _requestId(0) {
+        if (_isActive) {
+            _requestId = Tracer::currentRequestId();
+            Tracer::record('B', _category, _name, _requestId, Tracer::now());
+        }
+    }
+
+    ~TraceScope() {
+        if (_isActive) {
+            Tracer::record('E', _category, _name, _requestId, Tracer::now());
+        }
+    }
+
+private:
+    const char *_category;
+    const char *_name;
+    bool _isActive;
+    uint64_t _requestId;
+};
+
+/**
+ * @brief Makes the scopes of the calling thread belong to a request
+ */
+class TraceRequestScope {
+public:
+    explicit TraceRequestScope(uint64_t requestId) noexcept : _previousId(Tracer::currentRequestId()) {
+        Tracer::setCurrentRequestId(requestId);
+    }
+
+    ~TraceRequestScope() {
+        Tracer::setCurrentRequestId(_previousId);
+    }
+
+private:
+    uint64_t _previousId;
+};
+
+#define IE_TRACE_CONCAT_(A, B) A##B
+#define IE_TRACE_CONCAT(A, B) IE_TRACE_CONCAT_(A, B)
+
+#ifndef DISABLE_PROFILING_TRACE
+#define IE_TRACE_SCOPE(CATEGORY, NAME) \
+    InferenceEngine::TraceScope IE_TRACE_CONCAT(__ie_trace_scope_, __LINE__)(CATEGORY, NAME);
+#define IE_TRACE_REQUEST_SCOPE(ID) \
+    InferenceEngine::TraceRequestScope IE_TRACE_CONCAT(__ie_trace_request_, __LINE__)(ID);
+// for the scopes ending on another thread
+#define IE_TRACE_BEGIN(CATEGORY, NAME, ID) InferenceEngine::Tracer::begin(CATEGORY, NAME, ID);
+#define IE_TRACE_END(CATEGORY, NAME, ID) InferenceEngine::Tracer::end(CATEGORY, NAME, ID);
+#else
+#define IE_TRACE_SCOPE(CATEGORY, NAME)
+#define IE_TRACE_REQUEST_SCOPE(ID)
+#define IE_TRACE_BEGIN(CATEGORY, NAME, ID)
+#define IE_TRACE_END(CATEGORY, NAME, ID)
+#endif
+
+}  // namespace InferenceEngine
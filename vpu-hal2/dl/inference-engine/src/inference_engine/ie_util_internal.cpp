@@ -17,6 +17,7 @@
 #include "graph_tools.hpp"
 #include "caseless.hpp"
 #include "ie_utils.hpp"
+#include "blob_factory.hpp"
 
 #include <ie_layers.h>
 
@@ -29,78 +30,32 @@
 #include <memory>
 #include <utility>
 #include <iomanip>
+#include <cstring>
 
 namespace InferenceEngine {
 
-namespace {
-template<typename Visitor>
-void groupSubgraphsHelper(const InferenceEngine::CNNLayerPtr& layer,
-                          Visitor&& visitor) {
-    for (auto&& out : layer->outData) {
-        for (auto&& out_link : out->getInputTo()) {
-            auto& nextLayer = out_link.second;
-            if (nullptr != nextLayer &&
-                visitor(layer, nextLayer)) {
-                groupSubgraphsHelper(nextLayer, std::forward<Visitor>(visitor));
-            }
+std::vector<std::vector<CNNLayerPtr> >
+groupSubgraphs(const details::IndexedGraph& graph,
+               std::function<bool(const CNNLayerPtr&,
+                                  const CNNLayerPtr&)> splitter) {
+    std::vector<std::vector<CNNLayerPtr>> ret;
+    for (const auto& ids : graph.groupSubgraphs(splitter)) {
+        std::vector<CNNLayerPtr> subgraph;
+        subgraph.reserve(ids.size());
+        for (auto id : ids) {
+            subgraph.push_back(graph.layer(id));
         }
+        ret.emplace_back(std::move(subgraph));
     }
+
+    return ret;
 }
-}  // namespace
 
 std::vector<std::vector<CNNLayerPtr> >
 groupSubgraphs(ICNNNetwork& network,
                std::function<bool(const CNNLayerPtr&,
                                   const CNNLayerPtr&)> splitter) {
-    // TODO splitter std::function is heavy and can be replaced with
-    // llvm::function_ref-like lightweight callable when we add one
-    std::unordered_set<InferenceEngine::CNNLayerPtr> visitedObjects;
-    std::deque<InferenceEngine::CNNLayerPtr> layersToCheck;
-    InputsDataMap inputs;
-    network.getInputsInfo(inputs);
-    for (auto&& input : inputs) {
-        auto data = input.second->getInputData();
-        for (auto&& to : data->getInputTo()) {
-            auto nextLayer = to.second;
-            assert(nullptr != nextLayer);
-            layersToCheck.push_front(nextLayer);
-        }
-    }
-
-    std::vector<std::vector<InferenceEngine::CNNLayerPtr>> ret;
-
-    while (!layersToCheck.empty()) {
-        auto layer = layersToCheck.back();
-        layersToCheck.pop_back();
-        if (visitedObjects.find(layer) == visitedObjects.end()) {
-            visitedObjects.insert(layer);
-            std::vector<InferenceEngine::CNNLayerPtr> subgraph;
-            subgraph.push_back(layer);
-            groupSubgraphsHelper(layer,
-                                 [&](const InferenceEngine::CNNLayerPtr& layer1,
-                                     const InferenceEngine::CNNLayerPtr& layer2) {
-                if (visitedObjects.find(layer2) == visitedObjects.end()) {
-                    if (splitter(layer1, layer2)) {
-                        // Layer belongs to different subgraph
-                        // Do not add it to visited objects list here,
-                        // because we need to visit it during next while iteration
-                        layersToCheck.push_front(layer2);
-                        return false;
-                    } else {
-                        // Layer belongs to same subgraph
-                        // add it to list
-                        subgraph.push_back(layer2);
-                        visitedObjects.insert(layer2);
-                        return true;
-                    }
-                }
-                return false;
-            });
-            ret.emplace_back(std::move(subgraph));
-        }
-    }
-
-    return ret;
+    return groupSubgraphs(details::IndexedGraph(network, false), splitter);
 }
 
 
@@ -166,8 +121,10 @@ CNNLayerPtr clonelayer(const CNNLayer& source) {
 }
 
 details::CNNNetworkImplPtr cloneNet(const ICNNNetwork &network) {
+    auto& source = const_cast<ICNNNetwork&>(network);
     std::vector<CNNLayerPtr> layers;
-    details::CNNNetworkIterator i(const_cast<ICNNNetwork *>(&network));
+    layers.reserve(source.layerCount());
+    details::CNNNetworkIterator i(&source);
     while (i != details::CNNNetworkIterator()) {
         layers.push_back(*i);
         i++;
@@ -177,13 +134,95 @@ details::CNNNetworkImplPtr cloneNet(const ICNNNetwork &network) {
     // going over output layers and duplicatig them:
     OutputsDataMap outputs;
     network.getOutputsInfo(outputs);
-    for (auto o : outputs) {
+    for (const auto& o : outputs) {
         net->addOutput(o.first);
     }
 
+    char name[1024] = {};
+    source.getName(name, sizeof(name));
+    net->setName(name);
+    net->setPrecision(source.getPrecision());
+    net->setTargetDevice(source.getTargetDevice());
+
+    // the channels are copied, the mean images are reused like the blobs
+    InputsDataMap inputs;
+    network.getInputsInfo(inputs);
+    for (const auto& input : inputs) {
+        auto clonedInput = net->getInput(input.first);
+        if (nullptr == clonedInput) continue;
+        auto& preProcess = input.second->getPreProcess();
+        auto& clonedPreProcess = clonedInput->getPreProcess();
+        if (preProcess.getNumberOfChannels() != 0) {
+            clonedPreProcess.init(preProcess.getNumberOfChannels());
+            for (size_t c = 0; c < preProcess.getNumberOfChannels(); c++) {
+                *clonedPreProcess[c] = *preProcess[c];
+            }
+        }
+        clonedPreProcess.setVariant(preProcess.getMeanVariant());
+    }
+
     return net;
 }
 
+Blob::Ptr cloneBlob(const Blob& source) {
+    auto cloned = make_blob_with_precision(source.getTensorDesc());
+    cloned->allocate();
+    if (cloned->byteSize() != source.byteSize()) {
+        THROW_IE_EXCEPTION << "Failed to clone blob of " << source.byteSize() << " bytes";
+    }
+    std::memcpy(cloned->buffer().as<uint8_t*>(), source.cbuffer().as<const uint8_t*>(), source.byteSize());
+    return cloned;
+}
+
+CopyOnWriteNetwork::CopyOnWriteNetwork(const details::CNNNetworkImplPtr& network) : _network(network) {
+    if (nullptr == _network) {
+        THROW_IE_EXCEPTION << "Network is empty";
+    }
+}
+
+CopyOnWriteNetwork::CopyOnWriteNetwork(const ICNNNetwork& network)
+        : _source(dynamic_cast<const details::CNNNetworkImpl*>(&network)) {
+    if (nullptr == _source) {
+        _network = cloneNet(network);
+    }
+}
+
+details::CNNNetworkImpl& CopyOnWriteNetwork::mutate() {
+    if (isShared()) {
+        _network = cloneNet(static_cast<const ICNNNetwork&>(get()));
+        _source = nullptr;
+    }
+    return *_network;
+}
+
+Blob::Ptr CopyOnWriteNetwork::mutableBlob(const std::string& layerName, const std::string& blobName) {
+    auto& layers = mutate().allLayers();
+    auto layer = layers.find(layerName);
+    if (layer == layers.end()) {
+        THROW_IE_EXCEPTION << "Layer " << layerName << " not found in network";
+    }
+    auto blob = layer->second->blobs.find(blobName);
+    if (blob == layer->second->blobs.end() || nullptr == blob->second) {
+        THROW_IE_EXCEPTION << "Layer " << layerName << " has no blob " << blobName;
+    }
+
+    // any other reference to the blob is from the layers of other networks or from the users
+    auto weightable = dynamic_cast<WeightableLayer*>(layer->second.get());
+    long references = 1;
+    if (nullptr != weightable) {
+        references += (weightable->_weights == blob->second) + (weightable->_biases == blob->second);
+    }
+    if (blob->second.use_count() > references) {
+        blob->second = cloneBlob(*blob->second);
+    }
+    // the parser gives WeightableLayer its own copies of the weights and biases, they become the blob itself
+    if (nullptr != weightable) {
+        if (blobName == "weights") weightable->_weights = blob->second;
+        if (blobName == "biases") weightable->_biases = blob->second;
+    }
+    return blob->second;
+}
+
 
 details::CNNNetworkImplPtr cloneNet(const std::vector<CNNLayerPtr>& layers,
                                     std::function<CNNLayerPtr(const CNNLayer&)> layerCloner) {
@@ -194,17 +233,25 @@ details::CNNNetworkImplPtr cloneNet(const std::vector<CNNLayerPtr>& layers,
     // Src to cloned data map
     std::unordered_map<InferenceEngine::DataPtr, InferenceEngine::DataPtr> dataMap;
     std::vector<InferenceEngine::DataPtr> clonedDatas;
+    dataMap.reserve(layers.size() * 2);
+    clonedDatas.reserve(layers.size() * 2);
+
+    // looked up for every consumer of every output
+    std::unordered_set<CNNLayer*> layersSet;
+    layersSet.reserve(layers.size());
+    for (auto&& layer : layers) {
+        layersSet.insert(layer.get());
+    }
 
     auto createDataImpl = [&](const InferenceEngine::DataPtr& data) {
         assert(nullptr != data);
-        if (!contains(dataMap, data)) {
-            auto clonedData = cloneData(*data);
-            dataMap[data] = clonedData;
+        auto& clonedData = dataMap[data];
+        if (nullptr == clonedData) {
+            clonedData = cloneData(*data);
             clonedDatas.push_back(clonedData);
             net->getData(clonedData->getName()) = clonedData;
-            return clonedData;
         }
-        return dataMap[data];
+        return clonedData;
     };
 
     for (auto&& srcLayer : layers) {
@@ -239,7 +286,7 @@ details::CNNNetworkImplPtr cloneNet(const std::vector<CNNLayerPtr>& layers,
                 auto layer = inp.second;
                 // TODO(amalyshe) is it the best place to check priorbox and remove
                 // such edge from outputs?
-                if (std::find(layers.begin(), layers.end(), layer) == layers.end() &&
+                if (!contains(layersSet, layer.get()) &&
                     !(CaselessEq<std::string>()(layer->type, "priorbox") ||
                       CaselessEq<std::string>()(layer->type, "PriorBoxClustered"))) {
                     net->addOutput(data->getName());
@@ -291,6 +338,36 @@ void backward(const CNNLayerPtr& layer, std::deque<InferenceEngine::CNNLayerPtr>
 void traverse(InferenceEngine::ICNNNetwork& network,
               std::function<void(InferenceEngine::CNNLayerPtr& layer)> apply,
               std::function<void(const InferenceEngine::CNNLayerPtr& layer, std::deque<InferenceEngine::CNNLayerPtr>& layers)> expand) {
+    // forward and backward run over the indexed network, in the same order
+    using Expand = void (*)(const CNNLayerPtr&, std::deque<CNNLayerPtr>&);
+    auto expandFunction = expand.target<Expand>();
+    if (nullptr != expandFunction && (*expandFunction == forward || *expandFunction == backward)) {
+        const bool isForward = *expandFunction == forward;
+        details::IndexedGraph graph(network, !isForward);
+        std::vector<bool> visited(graph.size(), false);
+        std::vector<size_t> layersToCheck;
+        for (auto head : graph.heads()) {
+            if (!visited[head]) {
+                visited[head] = true;
+                layersToCheck.push_back(head);
+            }
+        }
+
+        for (size_t i = 0; i < layersToCheck.size(); ++i) {
+            size_t id = layersToCheck[i];
+            auto layer = graph.layer(id);
+            apply(layer);
+            for (auto next : isForward ? graph.successors(id) : graph.predecessors(id)) {
+                const auto& nextLayer = graph.layer(next);
+                if (!visited[next] && (isForward || (nextLayer->type != "Input" && nextLayer->type != "input"))) {
+                    visited[next] = true;
+                    layersToCheck.push_back(next);
+                }
+            }
+        }
+        return;
+    }
+
     std::vector<InferenceEngine::CNNLayerPtr> layers;
 
     InferenceEngine::InputsDataMap inputs;
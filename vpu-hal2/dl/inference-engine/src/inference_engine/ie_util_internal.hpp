@@ -25,6 +25,7 @@
 
 #include <cpp/ie_cnn_network.h>
 #include <cnn_network_impl.hpp>
+#include <indexed_graph.hpp>
 
 namespace InferenceEngine {
 
@@ -56,6 +57,20 @@ groupSubgraphs(InferenceEngine::ICNNNetwork& network,
                std::function<bool(const InferenceEngine::CNNLayerPtr&,
                                   const InferenceEngine::CNNLayerPtr&)> splitter);
 
+/**
+ * @brief Split graph into subgraphs using provided splitter object
+ *
+ * @param graph - Source network, indexed once for the passes run on it
+ * @param splitter - Splitter object, take two adjacent layers, must return true
+ * if layers must go to different subgraphs
+ *
+ * @return list of subgraphs
+ */
+INFERENCE_ENGINE_API_CPP(std::vector<std::vector<InferenceEngine::CNNLayerPtr>>)
+groupSubgraphs(const details::IndexedGraph& graph,
+               std::function<bool(const InferenceEngine::CNNLayerPtr&,
+                                  const InferenceEngine::CNNLayerPtr&)> splitter);
+
 /**
  * @brief Creates data object copy unconnected to any graph
  * @param source - source data object
@@ -85,12 +100,73 @@ cloneNet(const std::vector<InferenceEngine::CNNLayerPtr>& layers,
 
 /**
  * Clones the whole network. All layers and data objects will be cloned
+ * with the name, precision, target device and pre-processing of the inputs
  *
  * Blobs inside layers are reused
  * */
 INFERENCE_ENGINE_API_CPP(InferenceEngine::details::CNNNetworkImplPtr)
 cloneNet(const InferenceEngine::ICNNNetwork &network);
 
+/**
+ * @brief Creates blob object copy with its own memory
+ * @param source - source blob object
+ * @return Shared pointer to new blob object
+ */
+INFERENCE_ENGINE_API_CPP(Blob::Ptr) cloneBlob(const Blob& source);
+
+/**
+ * @brief Copy of a network sharing the layers, data objects and blobs with the network it's made from
+ * until it's modified.
+ *
+ * Copies cost a pointer copy. The network is cloned with cloneNet on the first call of mutate() if anything
+ * else still holds it: another copy, or the owner of the network the first copy was made from, which is
+ * never modified this way. A copy of a network it doesn't hold is cloned on its first mutate() as well.
+ * Blobs stay shared with the clones, mutableBlob() copies a blob before it's written.
+ * A copy can be used from one thread at a time, different copies from different threads.
+ */
+class INFERENCE_ENGINE_API_CLASS(CopyOnWriteNetwork) {
+public:
+    explicit CopyOnWriteNetwork(const details::CNNNetworkImplPtr& network);
+
+    /**
+     * @brief Reads network without holding it, the caller keeps it alive and unchanged as long as this copy
+     * reads it. Networks other than CNNNetworkImpl are cloned right away.
+     */
+    explicit CopyOnWriteNetwork(const ICNNNetwork& network);
+
+    /**
+     * @brief Network for the read-only passes, layers and data objects reached from it must not be modified
+     */
+    const details::CNNNetworkImpl& get() const {
+        return nullptr != _network ? *_network : *_source;
+    }
+
+    /**
+     * @brief Network only this copy holds, cloned if it's shared
+     */
+    details::CNNNetworkImpl& mutate();
+
+    /**
+     * @brief Blob of a layer of mutate() only this copy holds, copied if it's shared
+     * @param layerName - name of the layer
+     * @param blobName - name of the blob in CNNLayer::blobs, "weights" and "biases" also update
+     * WeightableLayer::_weights and _biases
+     */
+    Blob::Ptr mutableBlob(const std::string& layerName, const std::string& blobName);
+
+    /**
+     * @brief true if mutate() would clone the network
+     */
+    bool isShared() const {
+        return nullptr == _network || _network.use_count() > 1;
+    }
+
+private:
+    details::CNNNetworkImplPtr _network;
+    // network of the caller until the first mutate(), if _network is empty
+    const details::CNNNetworkImpl* _source = nullptr;
+};
+
 namespace traverse {
 
 INFERENCE_ENGINE_API_CPP(void)
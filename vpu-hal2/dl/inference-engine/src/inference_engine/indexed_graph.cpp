@@ -0,0 +1,219 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+#include "indexed_graph.hpp"
+
+#include <deque>
+#include <string>
+#include <algorithm>
+
+namespace InferenceEngine {
+namespace details {
+
+const size_t IndexedGraph::npos;
+
+IndexedGraph::IndexedGraph(const ICNNNetwork& network, bool undirected) {
+    InputsDataMap inputs;
+    network.getInputsInfo(inputs);
+
+    std::vector<CNNLayerPtr> heads;
+    for (const auto& input : inputs) {
+        for (const auto& consumer : input.second->getInputData()->getInputTo()) {
+            heads.push_back(consumer.second);
+        }
+    }
+    index(heads, undirected, const_cast<ICNNNetwork&>(network).layerCount());
+}
+
+IndexedGraph::IndexedGraph(const std::vector<CNNLayerPtr>& heads, bool undirected) {
+    index(heads, undirected, heads.size());
+}
+
+void IndexedGraph::index(const std::vector<CNNLayerPtr>& heads, bool undirected, size_t expectedSize) {
+    _ids.reserve(expectedSize);
+    _layers.reserve(expectedSize);
+    _successorOffsets.reserve(expectedSize + 1);
+    _predecessorOffsets.reserve(expectedSize + 1);
+
+    auto add = [&](const CNNLayerPtr& layer) {
+        auto it = _ids.emplace(layer.get(), _layers.size());
+        if (it.second) {
+            _layers.push_back(layer);
+        }
+        return it.first->second;
+    };
+
+    for (const auto& head : heads) {
+        if (head != nullptr) {
+            _heads.push_back(add(head));
+        }
+    }
+
+    // the layers are indexed in the order they're found, their successors are known when they're reached,
+    // and so are their predecessors when the creators of their inputs are added too
+    _successorOffsets.push_back(0);
+    _predecessorOffsets.push_back(0);
+    for (size_t id = 0; id < _layers.size(); ++id) {
+        // a reference to _layers[id] is invalidated by the layers added
+        CNNLayer* layer = _layers[id].get();
+        for (const auto& data : layer->outData) {
+            for (const auto& consumer : data->getInputTo()) {
+                if (consumer.second != nullptr) {
+                    _successors.push_back(add(consumer.second));
+                }
+            }
+        }
+        _successorOffsets.push_back(_successors.size());
+
+        if (undirected) {
+            for (const auto& data : layer->insData) {
+                auto locked = data.lock();
+                auto creator = locked ? locked->getCreatorLayer().lock() : nullptr;
+                if (creator != nullptr) {
+                    _predecessors.push_back(add(creator));
+                }
+            }
+            _predecessorOffsets.push_back(_predecessors.size());
+        }
+    }
+    if (undirected) {
+        return;
+    }
+
+    // only the edges found forwards are indexed, the predecessors are the reversed successors
+    _predecessorOffsets.assign(_layers.size() + 1, 0);
+    for (auto next : _successors) {
+        ++_predecessorOffsets[next + 1];
+    }
+    for (size_t id = 0; id < _layers.size(); ++id) {
+        _predecessorOffsets[id + 1] += _predecessorOffsets[id];
+    }
+    _predecessors.resize(_successors.size());
+    std::vector<size_t> cursors(_predecessorOffsets.begin(), _predecessorOffsets.end() - 1);
+    for (size_t id = 0; id < _layers.size(); ++id) {
+        for (auto next : successors(id)) {
+            _predecessors[cursors[next]++] = id;
+        }
+    }
+}
+
+size_t IndexedGraph::id(const CNNLayer* layer) const {
+    auto it = _ids.find(layer);
+    return it == _ids.end() ? npos : it->second;
+}
+
+std::vector<size_t> IndexedGraph::inputLayers() const {
+    std::vector<size_t> inputs;
+    for (size_t id = 0; id < size(); ++id) {
+        if (_layers[id]->insData.empty()) {
+            inputs.push_back(id);
+        }
+    }
+    std::sort(inputs.begin(), inputs.end(), [this](size_t lhs, size_t rhs) {
+        return _layers[lhs]->name < _layers[rhs]->name;
+    });
+    return inputs;
+}
+
+bool IndexedGraph::sortTopologically(const std::vector<size_t>& roots, std::vector<size_t>& order) const {
+    order.clear();
+    order.reserve(size());
+    bool sorted = depthFirst(roots, [&](size_t id) {
+        order.push_back(id);
+    }, false);
+    std::reverse(order.begin(), order.end());
+    return sorted;
+}
+
+std::vector<bool> IndexedGraph::reachable(const std::vector<size_t>& from, bool forward) const {
+    std::vector<bool> reached(size(), false);
+    std::vector<size_t> stack;
+    for (auto id : from) {
+        if (!reached[id]) {
+            reached[id] = true;
+            stack.push_back(id);
+        }
+    }
+    while (!stack.empty()) {
+        size_t id = stack.back();
+        stack.pop_back();
+        for (auto next : forward ? successors(id) : predecessors(id)) {
+            if (!reached[next]) {
+                reached[next] = true;
+                stack.push_back(next);
+            }
+        }
+    }
+    return reached;
+}
+
+std::vector<std::vector<size_t>> IndexedGraph::groupSubgraphs(
+        const std::function<bool(const CNNLayerPtr&, const CNNLayerPtr&)>& splitter) const {
+    std::vector<bool> visited(size(), false);
+    std::deque<size_t> layersToCheck;
+    for (auto head : _heads) {
+        layersToCheck.push_front(head);
+    }
+
+    std::vector<std::vector<size_t>> subgraphs;
+    std::vector<std::pair<size_t, const size_t*>> stack;
+    while (!layersToCheck.empty()) {
+        size_t first = layersToCheck.back();
+        layersToCheck.pop_back();
+        if (visited[first]) continue;
+
+        visited[first] = true;
+        std::vector<size_t> subgraph = {first};
+        // pre-order DFS over the edges the splitter keeps, the layers across the others start new subgraphs
+        stack.emplace_back(first, successors(first).begin());
+        while (!stack.empty()) {
+            size_t current = stack.back().first;
+            if (stack.back().second == successors(current).end()) {
+                stack.pop_back();
+                continue;
+            }
+            size_t next = *stack.back().second++;
+            if (visited[next]) continue;
+            if (splitter(_layers[current], _layers[next])) {
+                layersToCheck.push_front(next);
+            } else {
+                subgraph.push_back(next);
+                visited[next] = true;
+                stack.emplace_back(next, successors(next).begin());
+            }
+        }
+        subgraphs.emplace_back(std::move(subgraph));
+    }
+    return subgraphs;
+}
+
+}  // namespace details
+}  // namespace InferenceEngine
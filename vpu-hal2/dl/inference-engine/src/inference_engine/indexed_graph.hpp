@@ -0,0 +1,203 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include "ie_api.h"
+#include "ie_icnn_network.hpp"
+#include "ie_layers.h"
+
+namespace InferenceEngine {
+namespace details {
+
+/**
+ * @brief Read-only view of the layers of a network with dense ids and the edges in compressed rows (CSR),
+ * built once and shared by the passes run on the network.
+ *
+ * The ids follow the order the layers are found from the heads. The successors of a layer follow its outData
+ * and their inputTo maps, the predecessors its insData, an edge per data object and consumer. The traversals
+ * are iterative and run in O(V + E) over vectors of flags: no hashing of the layers, no comparison of the names
+ * and no recursion, deep networks don't overflow the stack. The view isn't updated if the network is modified.
+ */
+class INFERENCE_ENGINE_API_CLASS(IndexedGraph) {
+public:
+    static const size_t npos = static_cast<size_t>(-1);
+
+    struct Range {
+        const size_t* first;
+        const size_t* last;
+
+        const size_t* begin() const {
+            return first;
+        }
+
+        const size_t* end() const {
+            return last;
+        }
+
+        size_t size() const {
+            return last - first;
+        }
+    };
+
+    /**
+     * @brief Indexes the layers connected to the inputs of the network
+     * @param network - network to index, the heads are the consumers of its inputs
+     * @param undirected - follow the edges backwards too, else only the layers reachable from the heads are indexed
+     */
+    explicit IndexedGraph(const ICNNNetwork& network, bool undirected = true);
+
+    /**
+     * @brief Indexes the layers reachable from the heads
+     * @param heads - layers to start from, null ones are skipped
+     * @param undirected - follow the edges backwards too
+     */
+    IndexedGraph(const std::vector<CNNLayerPtr>& heads, bool undirected);
+
+    size_t size() const {
+        return _layers.size();
+    }
+
+    const CNNLayerPtr& layer(size_t id) const {
+        return _layers[id];
+    }
+
+    /**
+     * @brief id of the layer, npos if it isn't indexed
+     */
+    size_t id(const CNNLayer* layer) const;
+
+    Range successors(size_t id) const {
+        return {_successors.data() + _successorOffsets[id], _successors.data() + _successorOffsets[id + 1]};
+    }
+
+    /**
+     * @brief ids of the creators of the inputs of the layer, in the order of CNNLayer::insData if the graph is
+     * undirected, else the indexed producers of the edges found forwards, by id
+     */
+    Range predecessors(size_t id) const {
+        return {_predecessors.data() + _predecessorOffsets[id], _predecessors.data() + _predecessorOffsets[id + 1]};
+    }
+
+    /**
+     * @brief ids of the heads, in the order they were given
+     */
+    const std::vector<size_t>& heads() const {
+        return _heads;
+    }
+
+    /**
+     * @brief ids of the layers with no inputs: Input, Const, Memory, ordered by name
+     */
+    std::vector<size_t> inputLayers() const;
+
+    /**
+     * @brief Topological order, the reverse post-order of a DFS from the roots
+     * @param roots - ids of the layers to start from
+     * @param order - ids of the layers reachable from the roots
+     * @return false if a cycle is reachable from the roots
+     */
+    bool sortTopologically(const std::vector<size_t>& roots, std::vector<size_t>& order) const;
+
+    /**
+     * @brief Flags of the layers reachable from the given ones, included
+     * @param from - ids of the layers to start from
+     * @param forward - follow the successors, else the predecessors
+     */
+    std::vector<bool> reachable(const std::vector<size_t>& from, bool forward = true) const;
+
+    /**
+     * @brief groupSubgraphs of the layers reachable from the heads
+     * @return ids of the layers of each subgraph
+     */
+    std::vector<std::vector<size_t>> groupSubgraphs(
+        const std::function<bool(const CNNLayerPtr&, const CNNLayerPtr&)>& splitter) const;
+
+    /**
+     * @brief DFS from the roots, a layer reachable from several roots is visited once
+     * @param visit - callback on a layer, with its CNNLayerPtr
+     * @param visitBefore - visit a layer before its successors, else after them
+     * @return false if a cycle is found
+     */
+    template <class T>
+    bool dfs(const std::vector<size_t>& roots, const T& visit, bool visitBefore) const {
+        return depthFirst(roots, [&](size_t id) { visit(_layers[id]); }, visitBefore);
+    }
+
+private:
+    void index(const std::vector<CNNLayerPtr>& heads, bool undirected, size_t expectedSize);
+
+    template <class T>
+    bool depthFirst(const std::vector<size_t>& roots, const T& visit, bool visitBefore) const {
+        // not visited, on the stack, done
+        enum : uint8_t { NEW, OPEN, DONE };
+        std::vector<uint8_t> state(size(), NEW);
+        std::vector<std::pair<size_t, const size_t*>> stack;
+        for (auto root : roots) {
+            if (state[root] != NEW) continue;
+            if (visitBefore) visit(root);
+            state[root] = OPEN;
+            stack.emplace_back(root, successors(root).begin());
+            while (!stack.empty()) {
+                size_t current = stack.back().first;
+                if (stack.back().second != successors(current).end()) {
+                    size_t next = *stack.back().second++;
+                    if (state[next] == OPEN) return false;
+                    if (state[next] == DONE) continue;
+                    if (visitBefore) visit(next);
+                    state[next] = OPEN;
+                    stack.emplace_back(next, successors(next).begin());
+                } else {
+                    if (!visitBefore) visit(current);
+                    state[current] = DONE;
+                    stack.pop_back();
+                }
+            }
+        }
+        return true;
+    }
+
+    std::vector<CNNLayerPtr> _layers;
+    std::unordered_map<const CNNLayer*, size_t> _ids;
+    std::vector<size_t> _heads;
+    std::vector<size_t> _successorOffsets;
+    std::vector<size_t> _successors;
+    std::vector<size_t> _predecessorOffsets;
+    std::vector<size_t> _predecessors;
+};
+
+}  // namespace details
+}  // namespace InferenceEngine
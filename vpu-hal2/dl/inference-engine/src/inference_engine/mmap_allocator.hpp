@@ -0,0 +1,67 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+#pragma once
+
+#include <string>
+#include "ie_allocator.hpp"
+
+/**
+ * @brief Maps a file into the memory of a blob instead of reading it.
+ * The mapping is private: pages a plugin writes to are copied on write and never reach the file,
+ * pages nobody touches are never read. alloc(size) maps the whole file, which must be size bytes long,
+ * one mapping per allocator, and returns nullptr if the file can't be mapped.
+ * @note The file must not change while the blob lives: the pages not read yet come from the file as it
+ * is when they are read, a rewritten file silently changes them and a truncated one raises SIGBUS.
+ * Replace the file by renaming a new one over it instead.
+ */
+class MmapAllocator : public InferenceEngine::IAllocator {
+ public:
+    explicit MmapAllocator(const std::string &fileName) : _fileName(fileName) {}
+
+    void Release() noexcept override {
+        delete this;
+    }
+
+    void * lock(void * handle, InferenceEngine::LockOp = InferenceEngine::LOCK_FOR_WRITE) noexcept override {
+        return handle;
+    }
+
+    void unlock(void * a) noexcept override {}
+
+    void * alloc(size_t size) noexcept override;
+
+    bool   free(void* handle) noexcept override;
+
+ private:
+    std::string _fileName;
+    size_t _size = 0;
+};
@@ -0,0 +1,404 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+#include "pool_allocator.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#else
+#include <malloc.h>
+#endif
+
+namespace {
+
+const uint32_t BLOCK_MAGIC = 0x504f4f4c;
+const uint32_t UNPOOLED = ~0u;
+// Blocks a thread keeps for each size class, up to THREAD_CACHE_MAX_SIZE bytes each
+const size_t THREAD_CACHE_BLOCKS = 8;
+const size_t THREAD_CACHE_MAX_SIZE = 256 * 1024;
+// Idle bytes of a pool beyond which the freed blocks go back to the system
+const size_t MAX_IDLE_BYTES = 256 * 1024 * 1024;
+
+// In front of the data of each block, ALIGNMENT bytes so the data stays aligned
+struct BlockHeader {
+    uint32_t magic;
+    uint32_t sizeClass;
+    bool isPinnedPool;
+    bool isMapped;
+    bool isLocked;
+    // asked for by the blob, of the data, and of the whole allocation
+    size_t size;
+    size_t blockSize;
+    size_t reservedSize;
+};
+
+static_assert(sizeof(BlockHeader) <= PoolAllocator::ALIGNMENT, "BlockHeader must fit in front of the data");
+
+BlockHeader *headerOf(void *data) {
+    return reinterpret_cast<BlockHeader *>(static_cast<uint8_t *>(data) - PoolAllocator::ALIGNMENT);
+}
+
+void *dataOf(BlockHeader *block) {
+    return reinterpret_cast<uint8_t *>(block) + PoolAllocator::ALIGNMENT;
+}
+
+// Powers of two from ALIGNMENT to MAX_POOLED_SIZE and the sizes half way, no block wastes more than a third
+const std::vector<size_t> &sizeClasses() {
+    static const std::vector<size_t> sizes = []() {
+        std::vector<size_t> result;
+        for (size_t size = PoolAllocator::ALIGNMENT; size <= PoolAllocator::MAX_POOLED_SIZE; size *= 2) {
+            result.push_back(size);
+            if (size + size / 2 <= PoolAllocator::MAX_POOLED_SIZE) {
+                result.push_back(size + size / 2);
+            }
+        }
+        return result;
+    }();
+    return sizes;
+}
+
+// Counters of one thread, summed up by getStatistics
+struct Counters {
+    std::atomic<size_t> allocations{0};
+    std::atomic<size_t> hits{0};
+    std::atomic<size_t> frees{0};
+    // a block may be freed by another thread than the one allocating it
+    std::atomic<int64_t> bytesInUse{0};
+
+    void add(const Counters &other) {
+        allocations.fetch_add(other.allocations.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        hits.fetch_add(other.hits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        frees.fetch_add(other.frees.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        bytesInUse.fetch_add(other.bytesInUse.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+};
+
+template<typename T, typename V>
+void increase(std::atomic<T> &counter, V value) {
+    counter.fetch_add(static_cast<T>(value), std::memory_order_relaxed);
+}
+
+template<typename T, typename V>
+void decrease(std::atomic<T> &counter, V value) {
+    counter.fetch_sub(static_cast<T>(value), std::memory_order_relaxed);
+}
+
+class Pool {
+public:
+    explicit Pool(bool pinned) : _pinned(pinned), _classes(new SizeClass[sizeClasses().size()]) {}
+
+    BlockHeader *take(uint32_t sizeClass) {
+        auto &pool = _classes[sizeClass];
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        if (pool.blocks.empty()) return nullptr;
+        auto block = pool.blocks.back();
+        pool.blocks.pop_back();
+        decrease(_idleBytes, block->reservedSize);
+        return block;
+    }
+
+    void give(BlockHeader *block) {
+        if (_idleBytes.load(std::memory_order_relaxed) + block->reservedSize > MAX_IDLE_BYTES) {
+            release(block);
+            return;
+        }
+        auto &pool = _classes[block->sizeClass];
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        pool.blocks.push_back(block);
+        increase(_idleBytes, block->reservedSize);
+    }
+
+    BlockHeader *create(size_t blockSize, uint32_t sizeClass) {
+        size_t reservedSize = blockSize + PoolAllocator::ALIGNMENT;
+        void *base = nullptr;
+        bool isMapped = false;
+        bool isLocked = false;
+#ifndef _WIN32
+        if (blockSize >= PoolAllocator::HUGE_PAGE_SIZE) {
+            // mapped with a huge page of slack, so the block starts on a huge page
+            reservedSize = (reservedSize + PoolAllocator::HUGE_PAGE_SIZE - 1) & ~(PoolAllocator::HUGE_PAGE_SIZE - 1);
+            size_t mappedSize = reservedSize + PoolAllocator::HUGE_PAGE_SIZE;
+            auto mapped = static_cast<uint8_t *>(mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE,
+                                                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+            if (mapped == MAP_FAILED) return nullptr;
+            auto address = reinterpret_cast<uintptr_t>(mapped);
+            auto aligned = reinterpret_cast<uint8_t *>((address + PoolAllocator::HUGE_PAGE_SIZE - 1) &
+                                                       ~static_cast<uintptr_t>(PoolAllocator::HUGE_PAGE_SIZE - 1));
+            if (aligned != mapped) {
+                munmap(mapped, aligned - mapped);
+            }
+            if (mapped + mappedSize != aligned + reservedSize) {
+                munmap(aligned + reservedSize, mapped + mappedSize - aligned - reservedSize);
+            }
+#ifdef MADV_HUGEPAGE
+            madvise(aligned, reservedSize, MADV_HUGEPAGE);
+#endif
+            base = aligned;
+            isMapped = true;
+        } else if (posix_memalign(&base, PoolAllocator::ALIGNMENT, reservedSize) != 0) {
+            return nullptr;
+        }
+        if (_pinned) {
+            if (mlock(base, reservedSize) == 0) {
+                isLocked = true;
+                increase(_bytesPinned, reservedSize);
+            } else {
+                increase(_pinFailures, 1);
+            }
+        }
+#else
+        base = _aligned_malloc(reservedSize, PoolAllocator::ALIGNMENT);
+        if (base == nullptr) return nullptr;
+#endif
+        auto block = new (base) BlockHeader();
+        block->magic = BLOCK_MAGIC;
+        block->sizeClass = sizeClass;
+        block->isPinnedPool = _pinned;
+        block->isMapped = isMapped;
+        block->isLocked = isLocked;
+        block->blockSize = blockSize;
+        block->reservedSize = reservedSize;
+        increase(_bytesReserved, reservedSize);
+        return block;
+    }
+
+    void release(BlockHeader *block) {
+        size_t reservedSize = block->reservedSize;
+        decrease(_bytesReserved, reservedSize);
+        block->magic = 0;
+#ifndef _WIN32
+        if (block->isLocked) {
+            munlock(block, reservedSize);
+            decrease(_bytesPinned, reservedSize);
+        }
+        if (block->isMapped) {
+            munmap(block, reservedSize);
+        } else {
+            std::free(block);
+        }
+#else
+        _aligned_free(block);
+#endif
+    }
+
+    void trim() {
+        for (size_t i = 0; i < sizeClasses().size(); i++) {
+            std::vector<BlockHeader *> blocks;
+            {
+                std::lock_guard<std::mutex> lock(_classes[i].mutex);
+                blocks.swap(_classes[i].blocks);
+            }
+            for (auto block : blocks) {
+                decrease(_idleBytes, block->reservedSize);
+                release(block);
+            }
+        }
+    }
+
+    void addThread(Counters *counters) {
+        std::lock_guard<std::mutex> lock(_countersMutex);
+        _threadCounters.push_back(counters);
+    }
+
+    void removeThread(Counters *counters) {
+        std::lock_guard<std::mutex> lock(_countersMutex);
+        _exitedThreads.add(*counters);
+        _threadCounters.erase(std::remove(_threadCounters.begin(), _threadCounters.end(), counters),
+                              _threadCounters.end());
+    }
+
+    PoolAllocatorStatistics getStatistics() {
+        Counters total;
+        {
+            std::lock_guard<std::mutex> lock(_countersMutex);
+            total.add(_exitedThreads);
+            for (auto counters : _threadCounters) {
+                total.add(*counters);
+            }
+        }
+        PoolAllocatorStatistics statistics;
+        statistics.allocations = total.allocations;
+        statistics.hits = total.hits;
+        statistics.frees = total.frees;
+        statistics.bytesInUse = static_cast<size_t>(std::max<int64_t>(total.bytesInUse, 0));
+        statistics.bytesReserved = _bytesReserved;
+        statistics.bytesPinned = _bytesPinned;
+        statistics.pinFailures = _pinFailures;
+        return statistics;
+    }
+
+private:
+    struct SizeClass {
+        std::mutex mutex;
+        std::vector<BlockHeader *> blocks;
+    };
+
+    bool _pinned;
+    std::unique_ptr<SizeClass[]> _classes;
+    std::atomic<size_t> _idleBytes{0};
+    std::atomic<size_t> _bytesReserved{0};
+    std::atomic<size_t> _bytesPinned{0};
+    std::atomic<size_t> _pinFailures{0};
+
+    std::mutex _countersMutex;
+    std::vector<Counters *> _threadCounters;
+    Counters _exitedThreads;
+};
+
+Pool &poolOf(bool pinned) {
+    // never destroyed, the thread caches give their blocks back when their threads exit
+    static Pool *pools[2] = {new Pool(false), new Pool(true)};
+    return *pools[pinned ? 1 : 0];
+}
+
+// Blocks and counters of one thread for one pool
+class ThreadCache {
+public:
+    explicit ThreadCache(bool pinned) : _pool(poolOf(pinned)), _blocks(sizeClasses().size()) {
+        _pool.addThread(&counters);
+    }
+
+    ~ThreadCache() {
+        for (auto &blocks : _blocks) {
+            for (auto block : blocks) {
+                _pool.give(block);
+            }
+        }
+        _pool.removeThread(&counters);
+    }
+
+    BlockHeader *take(uint32_t sizeClass) {
+        auto &blocks = _blocks[sizeClass];
+        if (blocks.empty()) return nullptr;
+        auto block = blocks.back();
+        blocks.pop_back();
+        return block;
+    }
+
+    bool give(BlockHeader *block) {
+        auto &blocks = _blocks[block->sizeClass];
+        if (block->blockSize > THREAD_CACHE_MAX_SIZE || blocks.size() >= THREAD_CACHE_BLOCKS) return false;
+        blocks.push_back(block);
+        return true;
+    }
+
+    Pool &pool() {
+        return _pool;
+    }
+
+    Counters counters;
+
+private:
+    Pool &_pool;
+    std::vector<std::vector<BlockHeader *>> _blocks;
+};
+
+ThreadCache &threadCache(bool pinned) {
+    if (pinned) {
+        static thread_local ThreadCache pinnedCache(true);
+        return pinnedCache;
+    }
+    static thread_local ThreadCache cache(false);
+    return cache;
+}
+
+}  // namespace
+
+void * PoolAllocator::alloc(size_t size) noexcept {
+    try {
+        size = std::max<size_t>(size, 1);
+        auto &cache = threadCache(_pinned);
+        auto &pool = cache.pool();
+        increase(cache.counters.allocations, 1);
+
+        const auto &sizes = sizeClasses();
+        auto sizeClass = std::lower_bound(sizes.begin(), sizes.end(), size);
+        BlockHeader *block = nullptr;
+        if (sizeClass != sizes.end()) {
+            auto index = static_cast<uint32_t>(sizeClass - sizes.begin());
+            block = cache.take(index);
+            if (block == nullptr) {
+                block = pool.take(index);
+            }
+            if (block != nullptr) {
+                increase(cache.counters.hits, 1);
+            } else {
+                block = pool.create(*sizeClass, index);
+            }
+        } else {
+            block = pool.create(size, UNPOOLED);
+        }
+        if (block == nullptr) return nullptr;
+
+        block->size = size;
+        increase(cache.counters.bytesInUse, size);
+        return dataOf(block);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+bool PoolAllocator::free(void* handle) noexcept {
+    if (handle == nullptr) return false;
+    auto block = headerOf(handle);
+    if (block->magic != BLOCK_MAGIC) return false;
+    try {
+        auto &cache = threadCache(block->isPinnedPool);
+        increase(cache.counters.frees, 1);
+        decrease(cache.counters.bytesInUse, block->size);
+        if (block->sizeClass == UNPOOLED) {
+            cache.pool().release(block);
+        } else if (!cache.give(block)) {
+            cache.pool().give(block);
+        }
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+PoolAllocatorStatistics PoolAllocator::getStatistics(bool pinned) {
+    return poolOf(pinned).getStatistics();
+}
+
+void PoolAllocator::trim(bool pinned) {
+    poolOf(pinned).trim();
+}
@@ -0,0 +1,101 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+#pragma once
+
+#include <cstddef>
+#include "ie_api.h"
+#include "ie_allocator.hpp"
+
+/**
+ * @brief Counters of the blocks of a PoolAllocator pool, since the start of the process
+ */
+struct PoolAllocatorStatistics {
+    size_t allocations = 0;
+    // allocations served by a block of a thread cache or of the pool
+    size_t hits = 0;
+    size_t frees = 0;
+    // bytes the blobs asked for, and bytes of the blocks held in use or idle in the pool
+    size_t bytesInUse = 0;
+    size_t bytesReserved = 0;
+    size_t bytesPinned = 0;
+    size_t pinFailures = 0;
+
+    double hitRate() const {
+        return allocations ? static_cast<double>(hits) / allocations : 0.0;
+    }
+
+    // share of the reserved bytes no blob uses: rounding to the size classes and idle blocks
+    double fragmentation() const {
+        return bytesReserved ? 1.0 - static_cast<double>(bytesInUse) / bytesReserved : 0.0;
+    }
+};
+
+/**
+ * @brief Allocates the blobs from pools of blocks of a few size classes, aligned to ALIGNMENT bytes.
+ * A freed block goes back to a cache of the thread freeing it, then to the pool of its size class, and serves
+ * the next allocation of that class without going to the heap. Blocks of HUGE_PAGE_SIZE and more are mapped
+ * and advised to use transparent huge pages, sizes over MAX_POOLED_SIZE are mapped for each allocation.
+ * The pools are shared by all the allocators of the process, one for pinned blocks, locked in RAM by mlock
+ * when they are created, and one for the others.
+ */
+class INFERENCE_ENGINE_API_CLASS(PoolAllocator) : public InferenceEngine::IAllocator {
+ public:
+    static const size_t ALIGNMENT = 64;
+    static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+    static const size_t MAX_POOLED_SIZE = 64 * 1024 * 1024;
+
+    explicit PoolAllocator(bool pinned = false) : _pinned(pinned) {}
+
+    void Release() noexcept override {
+        delete this;
+    }
+
+    void * lock(void * handle, InferenceEngine::LockOp = InferenceEngine::LOCK_FOR_WRITE) noexcept override {
+        return handle;
+    }
+
+    void unlock(void * a) noexcept override {}
+
+    void * alloc(size_t size) noexcept override;
+
+    bool   free(void* handle) noexcept override;
+
+    static PoolAllocatorStatistics getStatistics(bool pinned = false);
+
+    /**
+     * @brief Gives the idle blocks of the pool back to the system, the thread caches keep theirs
+     */
+    static void trim(bool pinned = false);
+
+ private:
+    bool _pinned;
+};
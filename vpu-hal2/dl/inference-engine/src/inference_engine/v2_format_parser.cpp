@@ -185,12 +185,121 @@ V2FormatParser::V2FormatParser(int version): _version(version) {
     BaseCreator::version_ = version;
 }
 
-CNNNetworkImplPtr V2FormatParser::Parse(pugi::xml_node& root) {
+void V2FormatParser::BeginNetwork(const std::string& name, Precision precision) {
     _network.reset(new CNNNetworkImpl());
 
-    _network->setName(GetStrAttr(root, "name", ""));
-    _defPrecision = Precision::FromStr(GetStrAttr(root, "precision", "UNSPECIFIED"));
+    _network->setName(name);
+    _defPrecision = precision;
     _network->setPrecision(_defPrecision);
+}
+
+void V2FormatParser::AddLayer(const CNNLayer::Ptr& layer, const LayerParseParameters& lprms,
+                              const std::string& location) {
+    layersParseInfo[layer->name] = lprms;
+    _network->addLayer(layer);
+    _layerById[lprms.layerId] = layer;
+    _layerIds.push_back(lprms.layerId);
+
+    if (equal(layer->type, "input")) {
+        _inputLayers.push_back(layer);
+    }
+
+    // the precision of the network is the one of all the layers, if not given
+    if (_defPrecision == Precision::UNSPECIFIED && _network->getPrecision() != Precision::MIXED) {
+        if (!_network->getPrecision()) {
+            _network->setPrecision(lprms.prms.precision);
+        }
+        if (_network->getPrecision() != lprms.prms.precision) {
+            _network->setPrecision(Precision::MIXED);
+        }
+    }
+
+    for (const auto& outPort : lprms.outputPorts) {
+        const std::string outId = details::stringFormat("%d.%d", lprms.layerId, outPort.portId);
+        const std::string outName = lprms.outputPorts.size() == 1 ? lprms.prms.name
+            : details::stringFormat("%s.%d", lprms.prms.name.c_str(), outPort.portId);
+        DataPtr& ptr = _network->getData(outName.c_str());
+        if (!ptr) {
+            ptr.reset(new Data(outName, outPort.dims, outPort.precision, TensorDesc::getLayoutByDims(outPort.dims)));
+            ptr->setDims(outPort.dims);
+        }
+        _portsToData[outId] = ptr;
+
+        if (ptr->getCreatorLayer().lock())
+            THROW_IE_EXCEPTION << "two layers set to the same output [" << outName << "], conflict at "
+                               << location;
+
+        ptr->getCreatorLayer() = layer;
+        layer->outData.push_back(ptr);
+    }
+}
+
+void V2FormatParser::AddEdge(const LayerEdge& edge, const std::string& location) {
+    auto dataId = details::stringFormat("%d.%d", edge.fromLayer, edge.fromPort);
+    auto targetLayer = _layerById[edge.toLayer];
+    if (!targetLayer)
+        THROW_IE_EXCEPTION << "Layer ID " << edge.toLayer << " was not found while connecting edge at " << location;
+
+    SetLayerInput(*_network, dataId, targetLayer, edge.toPort);
+    _edges.push_back(edge);
+}
+
+void V2FormatParser::SetInputLayers() {
+    // version 2: inputs are marked as input layers
+    for (auto inLayer : _inputLayers) {
+        if (inLayer->outData.size() != 1) {
+            THROW_IE_EXCEPTION << "Input layer must have 1 output.\n"
+                "See documentation for details, "
+                "'Notice On Using Model Optimizer tool' in UseOfTheInferenceEngine.html.\n"
+                "You need to modify prototxt and generate new IR.";
+        }
+        InputInfo::Ptr info(new InputInfo());
+        info->setInputData(*inLayer->outData.begin());
+        Precision inputPrecision = info->getInputPrecision();
+        if (inputPrecision == Precision::Q78)
+            info->setInputPrecision(Precision::I16);
+        if (inputPrecision == Precision::FP16)
+            info->setInputPrecision(Precision::FP32);
+
+        _network->setInputInfo(info);
+    }
+}
+
+void V2FormatParser::ValidateLayers() {
+    if (!_network->allLayers().size())
+        THROW_IE_EXCEPTION << "Incorrect model! Network doesn't contain layers.";
+
+    // check all input ports are occupied
+    for (const auto& kvp : _network->allLayers()) {
+        const CNNLayer::Ptr& layer = kvp.second;
+        const LayerParseParameters& parseInfo = layersParseInfo[layer->name];
+        size_t inSize = layer->insData.size();
+        if (inSize != parseInfo.inputPorts.size())
+            THROW_IE_EXCEPTION << "Layer " << layer->name << " does not have any edge connected to it";
+
+        for (unsigned i = 0; i < inSize; i++) {
+            if (!layer->insData[i].lock()) {
+                THROW_IE_EXCEPTION << "Layer " << layer->name.c_str() << " input port "
+                                   << parseInfo.inputPorts[i].portId << " is not connected to any data";
+            }
+        }
+        layer->validateLayer();
+    }
+}
+
+void V2FormatParser::ResolveOutputs() {
+    _network->resolveOutput();
+
+    // Set default output precision to FP32 (for back-compatibility)
+    OutputsDataMap outputsInfo;
+    _network->getOutputsInfo(outputsInfo);
+    for (auto outputInfo : outputsInfo) {
+        outputInfo.second->setPrecision(Precision::FP32);
+    }
+}
+
+CNNNetworkImplPtr V2FormatParser::Parse(pugi::xml_node& root) {
+    BeginNetwork(GetStrAttr(root, "name", ""), Precision::FromStr(GetStrAttr(root, "precision", "UNSPECIFIED")));
     // parse the input Data
     DataPtr inputData;
     if (_version == 1) {
@@ -203,11 +312,6 @@ CNNNetworkImplPtr V2FormatParser::Parse(pugi::xml_node& root) {
 
     // parse the graph layers
     auto allLayersNode = root.child("layers");
-    std::vector< CNNLayer::Ptr> inputLayers;
-
-    int nodeCnt = 0;
-    std::map<int, CNNLayer::Ptr> layerById;
-    bool identifyNetworkPrecision = _defPrecision == Precision::UNSPECIFIED;
     for (auto node = allLayersNode.child("layer"); !node.empty(); node = node.next_sibling("layer")) {
         LayerParseParameters lprms;
         ParseGenericParams(node, lprms);
@@ -215,67 +319,26 @@ CNNNetworkImplPtr V2FormatParser::Parse(pugi::xml_node& root) {
         CNNLayer::Ptr layer(CreateLayer(node, lprms));
         if (!layer) THROW_IE_EXCEPTION << "Don't know how to create Layer type: " << lprms.prms.type;
 
-        layersParseInfo[layer->name] = lprms;
-        _network->addLayer(layer);
-        layerById[lprms.layerId] = layer;
-
-        if (equal(layer->type, "input")) {
-            inputLayers.push_back(layer);
-        }
-
-        if (identifyNetworkPrecision) {
-            if (!_network->getPrecision()) {
-                _network->setPrecision(lprms.prms.precision);
-            }
-            if (_network->getPrecision() != lprms.prms.precision) {
-                _network->setPrecision(Precision::MIXED);
-                identifyNetworkPrecision = false;
-            }
-        }
-
-        for (const auto& outPort : lprms.outputPorts) {
-            const std::string outId = details::stringFormat("%d.%d", lprms.layerId, outPort.portId);
-            const std::string outName = lprms.outputPorts.size() == 1 ? lprms.prms.name
-                : details::stringFormat("%s.%d", lprms.prms.name.c_str(), outPort.portId);
-            DataPtr& ptr = _network->getData(outName.c_str());
-            if (!ptr) {
-                ptr.reset(new Data(outName, outPort.dims, outPort.precision, TensorDesc::getLayoutByDims(outPort.dims)));
-                ptr->setDims(outPort.dims);
-            }
-            _portsToData[outId] = ptr;
-
-            if (ptr->getCreatorLayer().lock())
-                THROW_IE_EXCEPTION << "two layers set to the same output [" << outName << "], conflict at offset "
-                                   << node.offset_debug();
-
-            ptr->getCreatorLayer() = layer;
-            layer->outData.push_back(ptr);
-        }
-        nodeCnt++;
+        AddLayer(layer, lprms, "offset " + std::to_string(node.offset_debug()));
     }
 
     // connect the edges
     pugi::xml_node edges = root.child("edges");
 
     FOREACH_CHILD(_ec, edges, "edge") {
-        int fromLayer = GetIntAttr(_ec, "from-layer");
-        int fromPort = GetIntAttr(_ec, "from-port");
-        int toLayer = GetIntAttr(_ec, "to-layer");
-        int toPort = GetIntAttr(_ec, "to-port");
-
-        auto dataId = details::stringFormat("%d.%d", fromLayer, fromPort);
-        auto targetLayer = layerById[toLayer];
-        if (!targetLayer)
-            THROW_IE_EXCEPTION << "Layer ID " << toLayer << " was not found while connecting edge at offset "
-                               << _ec.offset_debug();
-
-        SetLayerInput(*_network, dataId, targetLayer, toPort);
+        LayerEdge edge;
+        edge.fromLayer = GetIntAttr(_ec, "from-layer");
+        edge.fromPort = GetIntAttr(_ec, "from-port");
+        edge.toLayer = GetIntAttr(_ec, "to-layer");
+        edge.toPort = GetIntAttr(_ec, "to-port");
+
+        AddEdge(edge, "offset " + std::to_string(_ec.offset_debug()));
     }
 
     if (_version == 1) {
         // a hacK: set input to the first layer that is not connected...
         bool inputWasSet = false;
-        for (auto& kvp : layerById) {
+        for (auto& kvp : _layerById) {
             CNNLayer::Ptr& layer = kvp.second;
             const LayerParseParameters& parseInfo = layersParseInfo[layer->name];
             size_t inSize = layer->insData.size();
@@ -304,63 +367,14 @@ CNNNetworkImplPtr V2FormatParser::Parse(pugi::xml_node& root) {
             break;
         }
         if (!inputWasSet) THROW_IE_EXCEPTION << "network does not have any input layer";
-    } else {  // version 2: inputs are marked as input layers
-        auto prepareInputLayer = [](vector<CNNLayer::Ptr> layers,
-                                    function<void(const InputInfo::Ptr&)> register_input) {
-            for (auto inLayer : layers) {
-                if (inLayer->outData.size() != 1) {
-                    THROW_IE_EXCEPTION << "Input layer must have 1 output.\n"
-                        "See documentation for details, "
-                        "'Notice On Using Model Optimizer tool' in UseOfTheInferenceEngine.html.\n"
-                        "You need to modify prototxt and generate new IR.";
-                }
-                InputInfo::Ptr info(new InputInfo());
-                info->setInputData(*inLayer->outData.begin());
-                Precision inputPrecision = info->getInputPrecision();
-                if (inputPrecision == Precision::Q78)
-                    info->setInputPrecision(Precision::I16);
-                if (inputPrecision == Precision::FP16)
-                    info->setInputPrecision(Precision::FP32);
-
-                register_input(info);
-            }
-        };
-
-        prepareInputLayer(inputLayers, [&](const InputInfo::Ptr& info) {
-            _network->setInputInfo(info);
-        });
+    } else {
+        SetInputLayers();
     }
 
-
-    if (!_network->allLayers().size())
-        THROW_IE_EXCEPTION << "Incorrect model! Network doesn't contain layers.";
-
-    // check all input ports are occupied
-    for (const auto& kvp : _network->allLayers()) {
-        const CNNLayer::Ptr& layer = kvp.second;
-        const LayerParseParameters& parseInfo = layersParseInfo[layer->name];
-        size_t inSize = layer->insData.size();
-        if (inSize != parseInfo.inputPorts.size())
-            THROW_IE_EXCEPTION << "Layer " << layer->name << " does not have any edge connected to it";
-
-        for (unsigned i = 0; i < inSize; i++) {
-            if (!layer->insData[i].lock()) {
-                THROW_IE_EXCEPTION << "Layer " << layer->name.c_str() << " input port "
-                                   << parseInfo.inputPorts[i].portId << " is not connected to any data";
-            }
-        }
-        layer->validateLayer();
-    }
+    ValidateLayers();
     // parse mean image
     ParsePreProcess(root);
-    _network->resolveOutput();
-
-    // Set default output precision to FP32 (for back-compatibility)
-    OutputsDataMap outputsInfo;
-    _network->getOutputsInfo(outputsInfo);
-    for (auto outputInfo : outputsInfo) {
-        outputInfo.second->setPrecision(Precision::FP32);
-    }
+    ResolveOutputs();
 
     if (_version == 1) {
         int batchSize = GetIntAttr(root, "batch", 1);
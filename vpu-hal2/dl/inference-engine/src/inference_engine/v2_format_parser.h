@@ -86,6 +86,13 @@ public:
     bool shouldCreate(const std::string& nodeType) const { return nodeType.compare(type_) == 0; }
 };
 
+struct LayerEdge {
+    int fromLayer;
+    int fromPort;
+    int toLayer;
+    int toPort;
+};
+
 class V2FormatParser : public IFormatParser {
 public:
     explicit V2FormatParser(int version);
@@ -96,7 +103,9 @@ public:
     void SetWeights(const TBlob<uint8_t>::Ptr& weights) override;
     void ParseDims(SizeVector& dims, const pugi::xml_node &node) const;
 
-private:
+protected:
+    friend class BinaryFormatParser;
+
     int _version;
     Precision _defPrecision;
     std::map<std::string, LayerParseParameters> layersParseInfo;
@@ -104,6 +113,21 @@ private:
 
     CNNNetworkImplPtr _network;
     std::map<std::string, std::vector<WeightSegment>> _preProcessSegments;
+    // layers by id, the ids of the layers and the edges in the order they were added
+    std::map<int, CNNLayer::Ptr> _layerById;
+    std::vector<int> _layerIds;
+    std::vector<LayerEdge> _edges;
+    std::vector<CNNLayer::Ptr> _inputLayers;
+
+    // Steps building the network, shared by the formats, location is where the layer or the edge is in the file
+    void BeginNetwork(const std::string& name, Precision precision);
+    void AddLayer(const CNNLayer::Ptr& layer, const LayerParseParameters& lprms, const std::string& location);
+    void AddEdge(const LayerEdge& edge, const std::string& location);
+    void SetInputLayers();
+    void ValidateLayers();
+    void ResolveOutputs();
+
+private:
     std::vector<BaseCreator*> getCreators() const;
     void ParsePort(LayerParseParameters::LayerPortData& port, pugi::xml_node &node) const;
     void ParseGenericParams(pugi::xml_node& node, LayerParseParameters& layerParsePrms) const;
@@ -45,8 +45,11 @@ MKLDNNPlugin::MKLDNNAsyncInferRequest::~MKLDNNAsyncInferRequest() {
 
 void MKLDNNPlugin::MKLDNNAsyncInferRequest::Infer() {
     auto registeredCallback = _callback;
+    auto registeredCompletionQueue = _completionQueue;
     _callback = nullptr;
+    _completionQueue.reset();
     StartAsync();
     Wait(InferenceEngine::IInferRequest::WaitMode::RESULT_READY);
     _callback = registeredCallback;
+    _completionQueue = registeredCompletionQueue;
 }
@@ -32,11 +32,15 @@
 
 #pragma once
 
+#include <utility>
+#include <vector>
+
 namespace VPU {
 namespace Common {
 
 template<typename T>
 class GraphInfo {
+    std::vector<T> _storage;
     T *_graphInfo;
     unsigned _graphInfoLen;
 
@@ -45,6 +49,12 @@ public:
         if (_graphInfo == nullptr) _graphInfoLen = 0;
     }
 
+    // Owns a copy of the data, which the next request of the graph would overwrite
+    explicit GraphInfo(std::vector<T> graphInfo) : _storage(std::move(graphInfo)) {
+        _graphInfo = _storage.empty() ? nullptr : _storage.data();
+        _graphInfoLen = _storage.size();
+    }
+
     const T *info() const {
         return _graphInfo;
     }
@@ -39,6 +39,7 @@
 #include "GraphInfo.h"
 #include "ie_common.h"
 #include "ie_layouts.h"
+#include "blob_transform.hpp"
 
 // TODO: move implementation to a separate cpp?
 namespace VPU {
@@ -96,44 +97,16 @@ void ConvertBlobToLayout(InferenceEngine::Layout layout, InferenceEngine::Blob::
             InferenceEngine::make_shared_blob<T>(blob->precision(), layout, blob->dims());
     convertedBlobPtr->allocate();
 
-    {
-        auto srcPtr = blob->cbuffer().as<const T*>();
-        auto dstPtr = convertedBlobPtr->buffer().as<T*>();
-        const auto& newDims = blob->getTensorDesc().getDims();
-        auto C = newDims[1];
-        auto H = newDims[2];
-        auto W = newDims[3];
-        if (layout == InferenceEngine::NHWC) {
-            if (blob->layout() != InferenceEngine::Layout::NCHW || newDims.size() != 4 || newDims[0] != 1) {
-                // ConvertLayout expects dimensions in reversed order,
-                // so we use deperecated Blob::dims() method.
-                InferenceEngine::ConvertLayout<T>(blob->layout(), InferenceEngine::NHWC, srcPtr, dstPtr, blob->dims());
-            } else {
-                for (int c = 0; c < C; ++c) {
-                    for (int h = 0; h < H; ++h) {
-                        for (int w = 0; w < W; ++w) {
-                            auto dstInd = c + w * C + h * C * W;
-                            dstPtr[dstInd] = *srcPtr++;
-                        }
-                    }
-                }
-            }
-        } else if (layout == InferenceEngine::NCHW) {
-            if (blob->layout() != InferenceEngine::Layout::NHWC || newDims.size() != 4 || newDims[0] != 1) {
-                InferenceEngine::ConvertLayout<T>(blob->layout(), InferenceEngine::NCHW, srcPtr, dstPtr, blob->dims());
-            } else {
-                for (int c = 0; c < C; ++c) {
-                    for (int h = 0; h < H; ++h) {
-                        int offs = h * C * W + c;
-                        for (int w = 0; w < W; ++w) {
-                            auto srcInd = w * C + offs;
-                            *dstPtr = srcPtr[srcInd];
-                            ++dstPtr;
-                        }
-                    }
-                }
-            }
-        }
+    auto isConvertible = [](InferenceEngine::Layout l) {
+        return l == InferenceEngine::NCHW || l == InferenceEngine::NHWC;
+    };
+    if (blob->getTensorDesc().getDims().size() == 4 && isConvertible(blob->layout()) && isConvertible(layout)) {
+        InferenceEngine::BlobTransform::convert(*blob, *convertedBlobPtr);
+    } else {
+        // ConvertLayout expects dimensions in reversed order,
+        // so we use deperecated Blob::dims() method.
+        InferenceEngine::ConvertLayout<T>(blob->layout(), layout, blob->cbuffer().as<const T*>(),
+                                          convertedBlobPtr->buffer().as<T*>(), blob->dims());
     }
     blob.swap(convertedBlobPtr);
 }
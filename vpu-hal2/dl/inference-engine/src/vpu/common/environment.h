@@ -49,6 +49,9 @@ struct Environment {
     }
 
     std::vector<BlobMetaData> blobMetaData;
+    // Inputs and outputs of the compiled blob, the infer requests find the network ones by name
+    std::vector<BlobDataInfo> blobInputs;
+    std::vector<BlobDataInfo> blobOutputs;
 
     ParsedConfig parsedConfig;
     unsigned int platform;
@@ -71,6 +71,72 @@ LogLevel ParsedConfig::parseLogLevel(const std::string &option) {
     return logLevel;
 }
 
+ThermalPolicy ParsedConfig::parseThermalPolicy(const std::string &option) {
+    if (option.compare(VPU_THERMAL_POLICY_BALANCE) == 0) {
+        return ThermalPolicy::Balance;
+    } else if (option.compare(VPU_THERMAL_POLICY_PACE) == 0) {
+        return ThermalPolicy::Pace;
+    }
+    return ThermalPolicy::None;
+}
+
+int ParsedConfig::parseGraphsPerDevice(const std::string &option) {
+    int graphs = 0;
+    try {
+        graphs = std::stoi(option);
+    } catch (const std::exception &) {
+        THROW_IE_EXCEPTION << "Incorrect value for KEY_VPU_GRAPHS_PER_DEVICE option";
+    }
+    if (graphs < 1 || graphs > MAX_GRAPHS_PER_DEVICE) {
+        THROW_IE_EXCEPTION << "Incorrect value for KEY_VPU_GRAPHS_PER_DEVICE option";
+    }
+    return graphs;
+}
+
+unsigned int ParsedConfig::parseCallbackThreads(const std::string &option) {
+    int threads = -1;
+    try {
+        threads = std::stoi(option);
+    } catch (const std::exception &) {
+        THROW_IE_EXCEPTION << "Incorrect value for KEY_VPU_CALLBACK_THREADS option";
+    }
+    if (threads < 0 || threads > MAX_CALLBACK_THREADS) {
+        THROW_IE_EXCEPTION << "Incorrect value for KEY_VPU_CALLBACK_THREADS option";
+    }
+    return threads;
+}
+
+std::vector<int> ParsedConfig::parseCpuList(const std::string &option) {
+    std::vector<std::string> elems;
+    parseStringList(option, elems);
+
+    std::vector<int> cpus;
+    for (const auto &elem : elems) {
+        int cpu = -1;
+        try {
+            cpu = std::stoi(elem);
+        } catch (const std::exception &) {
+            THROW_IE_EXCEPTION << "Incorrect value for KEY_VPU_CALLBACK_CPUS option";
+        }
+        if (cpu < 0) {
+            THROW_IE_EXCEPTION << "Incorrect value for KEY_VPU_CALLBACK_CPUS option";
+        }
+        cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+BlobAllocator ParsedConfig::parseBlobAllocator(const std::string &option) {
+    if (option.compare(VPU_BLOB_ALLOCATOR_SYSTEM) == 0) {
+        return BlobAllocator::System;
+    } else if (option.compare(VPU_BLOB_ALLOCATOR_POOL) == 0) {
+        return BlobAllocator::Pool;
+    } else if (option.compare(VPU_BLOB_ALLOCATOR_POOL_PINNED) == 0) {
+        return BlobAllocator::PoolPinned;
+    }
+    THROW_IE_EXCEPTION << "Incorrect value for KEY_VPU_BLOB_ALLOCATOR option";
+}
+
 ParsedConfig::ParsedConfig(const int platform, const std::map<std::string, std::string> &_config) {
     auto config = getDefaultConfig(platform);
     for (auto &option : _config) {
@@ -102,6 +168,10 @@ ParsedConfig::ParsedConfig(const int platform, const std::map<std::string, std::
     blobConfig.useCmxBuffers = parseOptimizationOption(config[VPU_CONFIG_KEY(USE_CMX_BUFFERS)]);
     exclusiveAsyncRequests = parseOptimizationOption(config[CONFIG_KEY(EXCLUSIVE_ASYNC_REQUESTS)]);
     printReceiveTensorTime = parseOptimizationOption(config[VPU_CONFIG_KEY(PRINT_RECEIVE_TENSOR_TIME)]);
+    partitionCmx = parseOptimizationOption(config[VPU_CONFIG_KEY(PARTITION_CMX)]);
+    callbackThreads = parseCallbackThreads(config[VPU_CONFIG_KEY(CALLBACK_THREADS)]);
+    callbackCpus = parseCpuList(config[VPU_CONFIG_KEY(CALLBACK_CPUS)]);
+    blobAllocator = parseBlobAllocator(config[VPU_CONFIG_KEY(BLOB_ALLOCATOR)]);
 
     blobConfig.cmxBufferStart = stoi(config[VPU_CONFIG_KEY(CMX_BUFFER_START)]);
     blobConfig.cmxBufferSize = stoi(config[VPU_CONFIG_KEY(CMX_BUFFER_SIZE)]);
@@ -109,6 +179,7 @@ ParsedConfig::ParsedConfig(const int platform, const std::map<std::string, std::
     parseStringList(config[VPU_CONFIG_KEY(NONE_LAYERS)], blobConfig.NoneLayers);
     parseStringList(config[VPU_CONFIG_KEY(HW_WHITE_LIST)], blobConfig.hwWhiteList);
     parseStringList(config[VPU_CONFIG_KEY(HW_BLACK_LIST)], blobConfig.hwBlackList);
+    parseStringList(config[VPU_CONFIG_KEY(FUSION_BLACK_LIST)], blobConfig.fusionBlackList);
 
     float norm = stof(config[VPU_CONFIG_KEY(INPUT_NORM)]);
     blobConfig.inputScale = 1.f / norm;
@@ -194,6 +265,33 @@ void ParsedConfig::validate(const std::map<std::string, std::string> &_config, c
     if (norm == 0.0f) {
         THROW_IE_EXCEPTION << "Incorrect zero value for KEY_VPU_INPUT_NORM option";
     }
+
+    auto thermalPolicy = config[VPU_CONFIG_KEY(THERMAL_POLICY)];
+    if (thermalPolicy.compare(VPU_THERMAL_POLICY_NONE) != 0 &&
+        thermalPolicy.compare(VPU_THERMAL_POLICY_BALANCE) != 0 &&
+        thermalPolicy.compare(VPU_THERMAL_POLICY_PACE) != 0) {
+        THROW_IE_EXCEPTION << "Incorrect value for KEY_VPU_THERMAL_POLICY option";
+    }
+    float thermalTarget = stof(config[VPU_CONFIG_KEY(THERMAL_TARGET)]);
+    if (thermalTarget <= 0.0f) {
+        THROW_IE_EXCEPTION << "Incorrect value for KEY_VPU_THERMAL_TARGET option";
+    }
+    int thermalSamplePeriod = stoi(config[VPU_CONFIG_KEY(THERMAL_SAMPLE_PERIOD_MS)]);
+    if (thermalSamplePeriod <= 0) {
+        THROW_IE_EXCEPTION << "Incorrect value for KEY_VPU_THERMAL_SAMPLE_PERIOD_MS option";
+    }
+
+    parseGraphsPerDevice(config[VPU_CONFIG_KEY(GRAPHS_PER_DEVICE)]);
+    if (!isOptimizationOption(config[VPU_CONFIG_KEY(PARTITION_CMX)])) {
+        THROW_IE_EXCEPTION << "Incorrect value for KEY_VPU_PARTITION_CMX option";
+    }
+    if (!isOptimizationOption(config[VPU_CONFIG_KEY(RESIDENCY_DAEMON)])) {
+        THROW_IE_EXCEPTION << "Incorrect value for KEY_VPU_RESIDENCY_DAEMON option";
+    }
+
+    parseCallbackThreads(config[VPU_CONFIG_KEY(CALLBACK_THREADS)]);
+    parseCpuList(config[VPU_CONFIG_KEY(CALLBACK_CPUS)]);
+    parseBlobAllocator(config[VPU_CONFIG_KEY(BLOB_ALLOCATOR)]);
 }
 
 std::map<std::string, std::string> ParsedConfig::getDefaultConfig(const int platform) {
@@ -213,13 +311,23 @@ std::map<std::string, std::string> ParsedConfig::getDefaultConfig(const int plat
                 {VPU_CONFIG_KEY(INPUT_BIAS),       "0.0"},
                 {VPU_CONFIG_KEY(IGNORE_UNKNOWN_LAYERS),  CONFIG_VALUE(NO)},
                 {VPU_CONFIG_KEY(NONE_LAYERS),      ""},
+                {VPU_CONFIG_KEY(FUSION_BLACK_LIST), ""},
                 {VPU_CONFIG_KEY(HW_STAGES_OPTIMIZATION), CONFIG_VALUE(NO)},
                 {VPU_CONFIG_KEY(USE_CMX_BUFFERS),        CONFIG_VALUE(YES)},
                 {VPU_CONFIG_KEY(HW_WHITE_LIST),    ""},
                 {VPU_CONFIG_KEY(HW_BLACK_LIST),    ""},
                 {VPU_CONFIG_KEY(CMX_BUFFER_START), "0"},
                 {VPU_CONFIG_KEY(CMX_BUFFER_SIZE),  "1048576"},
-                {VPU_CONFIG_KEY(PRINT_RECEIVE_TENSOR_TIME),    CONFIG_VALUE(NO)}
+                {VPU_CONFIG_KEY(PRINT_RECEIVE_TENSOR_TIME),    CONFIG_VALUE(NO)},
+                {VPU_CONFIG_KEY(THERMAL_POLICY),   VPU_THERMAL_POLICY_NONE},
+                {VPU_CONFIG_KEY(THERMAL_TARGET),   "75"},
+                {VPU_CONFIG_KEY(THERMAL_SAMPLE_PERIOD_MS), "1000"},
+                {VPU_CONFIG_KEY(GRAPHS_PER_DEVICE), "2"},
+                {VPU_CONFIG_KEY(PARTITION_CMX), CONFIG_VALUE(NO)},
+                {VPU_CONFIG_KEY(RESIDENCY_DAEMON), CONFIG_VALUE(YES)},
+                {VPU_CONFIG_KEY(CALLBACK_THREADS), "0"},
+                {VPU_CONFIG_KEY(CALLBACK_CPUS), ""},
+                {VPU_CONFIG_KEY(BLOB_ALLOCATOR), VPU_BLOB_ALLOCATOR_SYSTEM}
         };
     } else if (platform == MYRIAD_2) {
         return {{VPU_CONFIG_KEY(FIRST_SHAVE),      "0"},
@@ -237,13 +345,23 @@ std::map<std::string, std::string> ParsedConfig::getDefaultConfig(const int plat
                 {VPU_CONFIG_KEY(INPUT_BIAS),       "0.0"},
                 {VPU_CONFIG_KEY(IGNORE_UNKNOWN_LAYERS),  CONFIG_VALUE(NO)},
                 {VPU_CONFIG_KEY(NONE_LAYERS),      ""},
+                {VPU_CONFIG_KEY(FUSION_BLACK_LIST), ""},
                 {VPU_CONFIG_KEY(HW_STAGES_OPTIMIZATION), CONFIG_VALUE(NO)},
                 {VPU_CONFIG_KEY(USE_CMX_BUFFERS),        CONFIG_VALUE(NO)},
                 {VPU_CONFIG_KEY(HW_WHITE_LIST),    ""},
                 {VPU_CONFIG_KEY(HW_BLACK_LIST),    ""},
                 {VPU_CONFIG_KEY(CMX_BUFFER_START), "0"},
                 {VPU_CONFIG_KEY(CMX_BUFFER_SIZE),  "0"},
-                {VPU_CONFIG_KEY(PRINT_RECEIVE_TENSOR_TIME),    CONFIG_VALUE(NO)}
+                {VPU_CONFIG_KEY(PRINT_RECEIVE_TENSOR_TIME),    CONFIG_VALUE(NO)},
+                {VPU_CONFIG_KEY(THERMAL_POLICY),   VPU_THERMAL_POLICY_NONE},
+                {VPU_CONFIG_KEY(THERMAL_TARGET),   "75"},
+                {VPU_CONFIG_KEY(THERMAL_SAMPLE_PERIOD_MS), "1000"},
+                {VPU_CONFIG_KEY(GRAPHS_PER_DEVICE), "2"},
+                {VPU_CONFIG_KEY(PARTITION_CMX), CONFIG_VALUE(NO)},
+                {VPU_CONFIG_KEY(RESIDENCY_DAEMON), CONFIG_VALUE(YES)},
+                {VPU_CONFIG_KEY(CALLBACK_THREADS), "0"},
+                {VPU_CONFIG_KEY(CALLBACK_CPUS), ""},
+                {VPU_CONFIG_KEY(BLOB_ALLOCATOR), VPU_BLOB_ALLOCATOR_SYSTEM}
         };
     } else {
         return {{CONFIG_KEY(EXCLUSIVE_ASYNC_REQUESTS),   CONFIG_VALUE(NO)},
@@ -259,7 +377,17 @@ std::map<std::string, std::string> ParsedConfig::getDefaultConfig(const int plat
                 {VPU_CONFIG_KEY(INPUT_BIAS),       "0.0"},
                 {VPU_CONFIG_KEY(IGNORE_UNKNOWN_LAYERS),  CONFIG_VALUE(NO)},
                 {VPU_CONFIG_KEY(NONE_LAYERS),      ""},
-                {VPU_CONFIG_KEY(PRINT_RECEIVE_TENSOR_TIME),    CONFIG_VALUE(NO)}
+                {VPU_CONFIG_KEY(FUSION_BLACK_LIST), ""},
+                {VPU_CONFIG_KEY(PRINT_RECEIVE_TENSOR_TIME),    CONFIG_VALUE(NO)},
+                {VPU_CONFIG_KEY(THERMAL_POLICY),   VPU_THERMAL_POLICY_NONE},
+                {VPU_CONFIG_KEY(THERMAL_TARGET),   "75"},
+                {VPU_CONFIG_KEY(THERMAL_SAMPLE_PERIOD_MS), "1000"},
+                {VPU_CONFIG_KEY(GRAPHS_PER_DEVICE), "2"},
+                {VPU_CONFIG_KEY(PARTITION_CMX), CONFIG_VALUE(NO)},
+                {VPU_CONFIG_KEY(RESIDENCY_DAEMON), CONFIG_VALUE(YES)},
+                {VPU_CONFIG_KEY(CALLBACK_THREADS), "0"},
+                {VPU_CONFIG_KEY(CALLBACK_CPUS), ""},
+                {VPU_CONFIG_KEY(BLOB_ALLOCATOR), VPU_BLOB_ALLOCATOR_SYSTEM}
         };
     }
 }
@@ -34,6 +34,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include <graph_transformer.hpp>
 #include <vpu/vpu_plugin_config.hpp>
 #include <vpu_plugin_config_private.hpp>
@@ -42,9 +43,24 @@
 #define MYRIAD_2 2450
 #define UNKNOWN_DEVICE 0
 
+#define MAX_GRAPHS_PER_DEVICE 32
+#define MAX_CALLBACK_THREADS 64
+
 namespace VPU {
 namespace Common {
 
+enum class ThermalPolicy {
+    None,
+    Balance,
+    Pace
+};
+
+enum class BlobAllocator {
+    System,
+    Pool,
+    PoolPinned
+};
+
 struct ParsedConfig {
     explicit ParsedConfig(const int platform, const std::map<std::string, std::string> &_config = std::map<std::string, std::string>());
 
@@ -52,8 +68,17 @@ struct ParsedConfig {
 
     bool printReceiveTensorTime = false;
     bool exclusiveAsyncRequests = false;
+    bool partitionCmx = false;
+    unsigned int callbackThreads = 0;
+    std::vector<int> callbackCpus;
+    BlobAllocator blobAllocator = BlobAllocator::System;
 
     static LogLevel parseLogLevel(const std::string &option);
+    static ThermalPolicy parseThermalPolicy(const std::string &option);
+    static int parseGraphsPerDevice(const std::string &option);
+    static unsigned int parseCallbackThreads(const std::string &option);
+    static std::vector<int> parseCpuList(const std::string &option);
+    static BlobAllocator parseBlobAllocator(const std::string &option);
 
     // throw exception in the case of error
     static void validate(const std::map<std::string, std::string> &_config, const int platform = UNKNOWN_DEVICE);
@@ -41,5 +41,38 @@ DECLARE_VPU_CONFIG_KEY(CMX_BUFFER_SIZE);
 DECLARE_VPU_CONFIG_KEY(HW_WHITE_LIST);
 DECLARE_VPU_CONFIG_KEY(HW_BLACK_LIST);
 
+DECLARE_VPU_CONFIG_KEY(FUSION_BLACK_LIST);
+
+// Thermal aware scheduling of the MYRIAD plugin: NONE, BALANCE (load networks on the
+// coolest device, the device is not chosen again per inference) or PACE (space the submissions
+// to stay under THERMAL_TARGET degrees C)
+DECLARE_VPU_CONFIG_KEY(THERMAL_POLICY);
+DECLARE_VPU_CONFIG_VALUE(THERMAL_POLICY_NONE);
+DECLARE_VPU_CONFIG_VALUE(THERMAL_POLICY_BALANCE);
+DECLARE_VPU_CONFIG_VALUE(THERMAL_POLICY_PACE);
+DECLARE_VPU_CONFIG_KEY(THERMAL_TARGET);
+DECLARE_VPU_CONFIG_KEY(THERMAL_SAMPLE_PERIOD_MS);
+
+// Graphs the MYRIAD plugin loads on one device, beyond 2 only while the device has memory left
+DECLARE_VPU_CONFIG_KEY(GRAPHS_PER_DEVICE);
+// Splits the CMX buffer and SHAVE ranges between the graphs of a device
+DECLARE_VPU_CONFIG_KEY(PARTITION_CMX);
+// Attaches the graphs through ncs_residencyd when the daemon is running (YES by default),
+// the devices are booted by the plugin otherwise
+DECLARE_VPU_CONFIG_KEY(RESIDENCY_DAEMON);
+
+// Workers of the pool running the completion callbacks of all the MYRIAD networks, 0 runs the
+// callbacks of each network one-by-one on its own thread. CALLBACK_CPUS binds the workers in turn
+// to a comma separated list of CPUs.
+DECLARE_VPU_CONFIG_KEY(CALLBACK_THREADS);
+DECLARE_VPU_CONFIG_KEY(CALLBACK_CPUS);
+
+// Allocator of the input and output blobs of the MYRIAD infer requests: SYSTEM (the heap), POOL (aligned
+// blocks reused between the requests) or POOL_PINNED (pool blocks locked in RAM)
+DECLARE_VPU_CONFIG_KEY(BLOB_ALLOCATOR);
+DECLARE_VPU_CONFIG_VALUE(BLOB_ALLOCATOR_SYSTEM);
+DECLARE_VPU_CONFIG_VALUE(BLOB_ALLOCATOR_POOL);
+DECLARE_VPU_CONFIG_VALUE(BLOB_ALLOCATOR_POOL_PINNED);
+
 }  // namespace VPUConfigParams
 }  // namespace InferenceEngine
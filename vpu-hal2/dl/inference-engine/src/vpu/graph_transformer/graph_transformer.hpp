@@ -35,6 +35,7 @@
 #include <cstdint>
 #include <string>
 #include <vector>
+#include <map>
 #include <memory>
 #include <ie_icnn_network.hpp>
 #include <vpu_logger.h>
@@ -57,9 +58,35 @@ struct BlobConfig {
     std::vector<std::string> NoneLayers;
     std::vector<std::string> hwWhiteList;
     std::vector<std::string> hwBlackList;
+    std::vector<std::string> fusionBlackList;
     bool ignoreUnknownLayers;
 };
 
+// Input or output of a blob, the device buffer of the blob inputs (outputs) holds it at the offset
+struct BlobDataInfo {
+    std::string name;
+    uint32_t offset = 0;
+    uint32_t size = 0;
+};
+
+// Data of the blob buffer section written from the network, e.g. weights or biases. allowLossy marks the
+// Convolution/FullyConnected weights an offline tool may quantize.
+struct WeightsChunkInfo {
+    uint32_t offset;  // from the start of the buffer section data
+    uint32_t size;
+    bool allowLossy;
+};
+
+// Compile time statistics of one GraphTransformer pass
+struct PassStatistics {
+    std::string name;
+    double timeMs = 0.0;
+    size_t stagesIn = 0;
+    size_t stagesOut = 0;
+    // Pass specific counters (bytes written, allocator iterations, ...)
+    std::map<std::string, uint64_t> counters;
+};
+
 class IGraphTransformer {
 public:
     virtual ~IGraphTransformer() = default;
@@ -68,8 +95,20 @@ public:
                           std::vector<char>& blob,
                           std::vector<BlobMetaData>& metadata,
                           size_t& numStages) = 0;
+
+    // Statistics of the passes executed by the last generate call
+    virtual const std::vector<PassStatistics>& getPassStatistics() const = 0;
+
+    // Inputs (outputs) of the blob of the last generate call, in the order of their offsets
+    virtual const std::vector<BlobDataInfo>& getInputsInfo() const = 0;
+    virtual const std::vector<BlobDataInfo>& getOutputsInfo() const = 0;
+
+    // Data written to the buffer section of the blob of the last generate call, one chunk per data
+    virtual const std::vector<WeightsChunkInfo>& getWeightsChunks() const = 0;
 };
 
+std::string passStatisticsToJson(const std::string& networkName, const std::vector<PassStatistics>& stats);
+
 std::shared_ptr<IGraphTransformer> createGraphTransformer(const BlobConfig& blobConfig,
                                                           const Common::LoggerPtr& log);
 
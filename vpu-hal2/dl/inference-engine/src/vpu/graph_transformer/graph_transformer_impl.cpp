@@ -43,6 +43,9 @@
 #include <fstream>
 #include <utility>
 #include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
 #include <precision_utils.h>
 #include <caseless.hpp>
 
@@ -411,8 +414,11 @@ bool isHwStage(const VpuStageHandle& stage) {
 }
 
 GraphTransformerImpl::GraphTransformerImpl(const BlobConfig &blobConfig,
-                                           const Common::LoggerPtr &log)
-    : _blobConfig(blobConfig), _log(log) {
+                                           const Common::LoggerPtr &log,
+                                           bool allowStridedViews,
+                                           const std::unordered_set<std::string>& stridedViewsBlackList)
+    : _blobConfig(blobConfig), _log(log), _allowStridedViews(allowStridedViews),
+      _stridedViewsBlackList(stridedViewsBlackList) {
 }
 
 void GraphTransformerImpl::checkBatchDefault(const CNNLayerPtr& layer,
@@ -545,38 +551,53 @@ void GraphTransformerImpl::generate(ICNNNetwork& network,
     (void)autoDumper;
 #endif
 
-    parseNetwork(network);
+    _passStats.clear();
 
-    parseInputAndOutputData();
-    addInputConvertStages();
-    addPreProcessStages();
+    runPass("parseNetwork", [&]() {
+        parseNetwork(network);
+        addPassCounter("layers", _orderedLayers.size());
+    });
+
+    runPass("parseInputAndOutputData", [&]() { parseInputAndOutputData(); });
+    runPass("addInputConvertStages", [&]() { addInputConvertStages(); });
+    runPass("addPreProcessStages", [&]() { addPreProcessStages(); });
 
-    generateStages();
+    runPass("generateStages", [&]() { generateStages(); });
 
-    addOutputConvertStages();
+    runPass("addOutputConvertStages", [&]() { addOutputConvertStages(); });
 
-    packPostOps();
+    runPass("fuseStages", [&]() { fuseStages(); });
+    runPass("packPostOps", [&]() { packPostOps(); });
     // this optimization must be before addConvertOrderStages();
     // because it can wrap reshape with additional convert order stages
     if (_blobConfig.reshapeOptimization) {
-        eliminateReshapeStages();
+        runPass("eliminateReshapeStages", [&]() { eliminateReshapeStages(); });
     }
     if (_blobConfig.hwOptimization) {
-        addHWStages();
+        runPass("addHWStages", [&]() { addHWStages(); });
         if (_blobConfig.copyOptimization) {
-            packHWConcat();
+            runPass("packHWConcat", [&]() { packHWConcat(); });
         }
     }
-    addConvertOrderStages();
+    runPass("addConvertOrderStages", [&]() { addConvertOrderStages(); });
     if (_blobConfig.copyOptimization) {
-        eliminateCopyStages();
+        runPass("eliminateCopyStages", [&]() {
+            eliminateCopyStages();
+            addPassCounter("eliminated_copy_bytes", _eliminatedCopyBytes);
+            addPassCounter("aliased_views", _aliasedViews);
+        });
+        LOG_INFO("[VPU] GraphTransformer : network %s : eliminated %u Copy stages (%zu bytes), %u aliased views",
+                 _networkName.c_str(), _eliminatedCopyStages, _eliminatedCopyBytes, _aliasedViews);
     }
     if (_blobConfig.hwOptimization) {
-        fillHWDescriptors();
+        runPass("fillHWDescriptors", [&]() { fillHWDescriptors(); });
     }
-    packMemory();
+    runPass("packMemory", [&]() { packMemory(); });
 
-    finalize(blob);
+    runPass("finalize", [&]() {
+        finalize(blob);
+        addPassCounter("bytes_written", blob.size());
+    });
 
 #ifndef NDEBUG
     if (auto dumpFileName = std::getenv("IE_VPU_DUMP_BLOB_FILE_NAME")) {
@@ -598,6 +619,55 @@ void GraphTransformerImpl::generate(ICNNNetwork& network,
     }
 }
 
+void GraphTransformerImpl::runPass(const char* name, const std::function<void()>& pass) {
+    PassStatistics stats;
+    stats.name = name;
+    stats.stagesIn = numActiveStages();
+    _passStats.push_back(stats);
+
+    _passActive = true;
+
+    auto finish = [this](std::chrono::high_resolution_clock::time_point start, bool failed) {
+        auto& cur = _passStats.back();
+        cur.timeMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        cur.stagesOut = numActiveStages();
+        if (failed) {
+            cur.counters["failed"] = 1;
+        }
+
+        _passActive = false;
+
+        LOG_DEBUG("[VPU] GraphTransformer : pass %s : %.3f ms, stages %u -> %u",
+                  cur.name.c_str(), cur.timeMs,
+                  static_cast<uint32_t>(cur.stagesIn), static_cast<uint32_t>(cur.stagesOut));
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    try {
+        pass();
+    } catch (...) {
+        finish(start, true);
+        throw;
+    }
+    finish(start, false);
+}
+
+void GraphTransformerImpl::addPassCounter(const char* name, uint64_t value) {
+    if (!_passActive)
+        return;
+
+    _passStats.back().counters[name] += value;
+}
+
+size_t GraphTransformerImpl::numActiveStages() const {
+    size_t num = 0;
+    for (const auto& stage : _stages) {
+        if (!stage->optimized)
+            ++num;
+    }
+    return num;
+}
+
 void GraphTransformerImpl::generateStages() {
     for (const auto& layer : _orderedLayers) {
         assert(layer != nullptr);
@@ -790,6 +860,30 @@ void GraphTransformerImpl::dumpInternalGraphToDot(const std::string& fileName) c
 }
 #endif
 
+// Only Convolution/FullyConnected weights are allowed to be stored with lossy compression,
+// the rest constant data (biases, scales, HW descriptors) must be preserved exactly.
+bool GraphTransformerImpl::isLossyCompressible(const VpuDataHandle& data) const {
+    if (data->consumers.empty())
+        return false;
+
+    for (const auto& consumer : data->consumers) {
+        if (consumer->type != kConv &&
+            consumer->type != kIm2ColConvolution &&
+            consumer->type != kDepthConv &&
+            consumer->type != kFC &&
+            consumer->type != kDeconvolution &&
+            consumer->type != kMyriadXHwConvolution &&
+            consumer->type != kMyriadXHwFCL) {
+            return false;
+        }
+
+        if (consumer->inputs.size() < 2 || consumer->inputs[1] != data)
+            return false;
+    }
+
+    return true;
+}
+
 void GraphTransformerImpl::finalize(std::vector<char>& blob) {
     ElfN_Ehdr elfHdr = {};
     // TODO : what do this numbers mean?
@@ -799,9 +893,9 @@ void GraphTransformerImpl::finalize(std::vector<char>& blob) {
     elfHdr.e_ehsize = 8 * sizeof(elfHdr);
 
     mv_blob_header blobHdr = {};
-    blobHdr.magic_number = 8708;
-    blobHdr.blob_ver_major = 2;
-    blobHdr.blob_ver_minor = 1;
+    blobHdr.magic_number = BLOB_MAGIC_NUMBER;
+    blobHdr.blob_ver_major = BLOB_VERSION_MAJOR;
+    blobHdr.blob_ver_minor = BLOB_VERSION_MINOR;
     // TODO : can only choose number of SHAVEs
     blobHdr.num_shaves = _blobConfig.lastShave - _blobConfig.firstShave + 1;
     blobHdr.bss_mem_size = _bssMemSize;
@@ -811,8 +905,24 @@ void GraphTransformerImpl::finalize(std::vector<char>& blob) {
 
     auto dataSecPreFill = dataSecOffset - (sizeof(elfHdr) + sizeof(blobHdr));
 
+    std::vector<char> blobData(_blobTotalDataSize, 0);
+    _weightsChunks.clear();
+    for (const auto& data : _datas) {
+        assert(data != nullptr);
+
+        if (data->index == IndexBlob && data->writer != nullptr) {
+            data->writer->write(&blobData[data->offset]);
+
+            WeightsChunkInfo chunk;
+            chunk.offset = data->offset;
+            chunk.size = static_cast<uint32_t>(data->writer->byteSize());
+            chunk.allowLossy = isLossyCompressible(data);
+            _weightsChunks.push_back(chunk);
+        }
+    }
+
     mv_buffer_section_header bufSecHdr = {};
-    bufSecHdr.buffer_section_size = sizeof(bufSecHdr) + _blobTotalDataSize;
+    bufSecHdr.buffer_section_size = sizeof(bufSecHdr) + blobData.size();
 
     std::vector<mv_reloc_info> blobBufRelocInfo;
     std::vector<mv_reloc_info> blobWorkRelocInfo;
@@ -821,6 +931,8 @@ void GraphTransformerImpl::finalize(std::vector<char>& blob) {
 
     uint32_t inputSize = 0;
     uint32_t outputSize = 0;
+    _inputsInfo.clear();
+    _outputsInfo.clear();
     for (const auto& data : _datas) {
         assert(data != nullptr);
 
@@ -834,15 +946,29 @@ void GraphTransformerImpl::finalize(std::vector<char>& blob) {
             blobBufRelocInfo.push_back(info);
         } else if (data->index == IndexInput) {
             if (data->parent == nullptr) {
-                inputSize += data->dims.totalSize() * getDataTypeSize(data->type);
+                BlobDataInfo info;
+                info.name = data->name;
+                info.offset = data->offset;
+                info.size = data->dims.totalSize() * getDataTypeSize(data->type);
+                _inputsInfo.push_back(info);
+                inputSize += info.size;
             }
         } else if (data->index == IndexOutput) {
             if (data->parent == nullptr) {
-                outputSize += data->dims.totalSize() * getDataTypeSize(data->type);
+                BlobDataInfo info;
+                info.name = data->name;
+                info.offset = data->offset;
+                info.size = data->dims.totalSize() * getDataTypeSize(data->type);
+                _outputsInfo.push_back(info);
+                outputSize += info.size;
             }
         }
     }
 
+    auto byOffset = [](const BlobDataInfo& a, const BlobDataInfo& b) { return a.offset < b.offset; };
+    std::sort(_inputsInfo.begin(), _inputsInfo.end(), byOffset);
+    std::sort(_outputsInfo.begin(), _outputsInfo.end(), byOffset);
+
     auto relocSecOffset = dataSecOffset + bufSecHdr.buffer_section_size;
 
     mv_relocation_section_header mvRelocSecHdr = {};
@@ -929,16 +1055,8 @@ void GraphTransformerImpl::finalize(std::vector<char>& blob) {
     std::copy_n(&bufSecHdr, 1, reinterpret_cast<mv_buffer_section_header*>(&blob[curBlobOffset]));
     curBlobOffset += sizeof(bufSecHdr);
 
-    for (const auto& data : _datas) {
-        assert(data != nullptr);
-
-        if (data->index == IndexBlob) {
-            if (data->writer != nullptr) {
-                data->writer->write(&blob[curBlobOffset] + data->offset);
-            }
-        }
-    }
-    curBlobOffset += _blobTotalDataSize;
+    std::copy(blobData.begin(), blobData.end(), &blob[curBlobOffset]);
+    curBlobOffset += blobData.size();
 
     std::copy_n(&mvRelocSecHdr, 1, reinterpret_cast<mv_relocation_section_header*>(&blob[curBlobOffset]));
     curBlobOffset += sizeof(mvRelocSecHdr);
@@ -1145,9 +1263,173 @@ void ScaleWeightsWriter::write(void* dst) const {
     }
 }
 
+namespace {
+
+// Compiles the network with Concat/Split aliasing first. If the memory allocator can't place
+// the longer living buffers, only the views whose data held memory at the failure are turned
+// back into plain copies, and the compilation is retried until it succeeds or no view is left.
+class GraphTransformerWithFallback : public IGraphTransformer {
+public:
+    GraphTransformerWithFallback(const BlobConfig& blobConfig,
+                                 const Common::LoggerPtr& log)
+        : _blobConfig(blobConfig), _log(log) {
+    }
+
+    void generate(ICNNNetwork& network,
+                  std::vector<char>& blob,
+                  std::vector<BlobMetaData>& metaData,
+                  size_t& numStages) override {
+        _passStats.clear();
+        _inputsInfo.clear();
+        _outputsInfo.clear();
+        _weightsChunks.clear();
+
+        std::unordered_set<std::string> stridedViewsBlackList;
+        for (;;) {
+            auto impl = std::make_shared<GraphTransformerImpl>(_blobConfig, _log, true, stridedViewsBlackList);
+            try {
+                generateImpl(impl, network, blob, metaData, numStages);
+                return;
+            } catch (const InferenceEngine::details::InferenceEngineException& e) {
+                const auto& failedViews = impl->getFailedStridedViews();
+                if (failedViews.empty())
+                    throw;
+
+                LOG_WARNING("[VPU] GraphTransformer : %s, retry with %u of %u aliased Concat/Split views as copies",
+                            e.what(), static_cast<uint32_t>(failedViews.size()),
+                            static_cast<uint32_t>(impl->getStridedViews().size()));
+
+                stridedViewsBlackList.insert(failedViews.begin(), failedViews.end());
+            }
+
+            blob.clear();
+            metaData.clear();
+        }
+    }
+
+    const std::vector<PassStatistics>& getPassStatistics() const override {
+        return _passStats;
+    }
+
+    const std::vector<BlobDataInfo>& getInputsInfo() const override {
+        return _inputsInfo;
+    }
+
+    const std::vector<BlobDataInfo>& getOutputsInfo() const override {
+        return _outputsInfo;
+    }
+
+    const std::vector<WeightsChunkInfo>& getWeightsChunks() const override {
+        return _weightsChunks;
+    }
+
+private:
+    // Failed attempt passes stay in the statistics, the failed pass has "failed" counter
+    void generateImpl(const std::shared_ptr<GraphTransformerImpl>& impl,
+                      ICNNNetwork& network,
+                      std::vector<char>& blob,
+                      std::vector<BlobMetaData>& metaData,
+                      size_t& numStages) {
+        struct StatsCollector {
+            GraphTransformerWithFallback* self;
+            const std::shared_ptr<GraphTransformerImpl>& impl;
+            ~StatsCollector() {
+                const auto& stats = impl->getPassStatistics();
+                self->_passStats.insert(self->_passStats.end(), stats.begin(), stats.end());
+            }
+        } collector{this, impl};
+
+        impl->generate(network, blob, metaData, numStages);
+
+        _inputsInfo = impl->getInputsInfo();
+        _outputsInfo = impl->getOutputsInfo();
+        _weightsChunks = impl->getWeightsChunks();
+
+        double totalMs = 0.0;
+        for (const auto& stats : impl->getPassStatistics()) {
+            totalMs += stats.timeMs;
+        }
+        LOG_INFO("[VPU] GraphTransformer : network %s compiled in %.3f ms", impl->networkName().c_str(), totalMs);
+
+        if (auto statsFileName = std::getenv("IE_VPU_COMPILE_STATS_FILE_NAME")) {
+            std::ofstream file(statsFileName);
+            if (!file.is_open()) {
+                THROW_IE_EXCEPTION << "[VPU] Cannot open file " << statsFileName << " for writing";
+            }
+            file << passStatisticsToJson(impl->networkName(), impl->getPassStatistics());
+        }
+    }
+
+    BlobConfig _blobConfig;
+    Common::LoggerPtr _log;
+    std::vector<PassStatistics> _passStats;
+    std::vector<BlobDataInfo> _inputsInfo;
+    std::vector<BlobDataInfo> _outputsInfo;
+    std::vector<WeightsChunkInfo> _weightsChunks;
+};
+
+std::string jsonEscape(const std::string& str) {
+    std::ostringstream os;
+    for (auto c : str) {
+        switch (c) {
+        case '"':
+            os << "\\\"";
+            break;
+        case '\\':
+            os << "\\\\";
+            break;
+        case '\n':
+            os << "\\n";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+            } else {
+                os << c;
+            }
+            break;
+        }
+    }
+    return os.str();
+}
+
+}  // namespace
+
 std::shared_ptr<IGraphTransformer> VPU::createGraphTransformer(const BlobConfig& blobConfig,
                                                                const Common::LoggerPtr& log) {
-    return std::make_shared<GraphTransformerImpl>(blobConfig, log);
+    return std::make_shared<GraphTransformerWithFallback>(blobConfig, log);
+}
+
+std::string VPU::passStatisticsToJson(const std::string& networkName, const std::vector<PassStatistics>& stats) {
+    double totalMs = 0.0;
+    for (const auto& pass : stats) {
+        totalMs += pass.timeMs;
+    }
+
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(3);
+    os << "{\"network\":\"" << jsonEscape(networkName) << "\",\"total_ms\":" << totalMs << ",\"passes\":[";
+    for (size_t i = 0; i < stats.size(); ++i) {
+        const auto& pass = stats[i];
+
+        os << (i > 0 ? "," : "")
+           << "{\"name\":\"" << jsonEscape(pass.name) << "\""
+           << ",\"time_ms\":" << pass.timeMs
+           << ",\"stages_in\":" << pass.stagesIn
+           << ",\"stages_out\":" << pass.stagesOut
+           << ",\"counters\":{";
+
+        bool first = true;
+        for (const auto& counter : pass.counters) {
+            os << (first ? "" : ",") << "\"" << jsonEscape(counter.first) << "\":" << counter.second;
+            first = false;
+        }
+
+        os << "}}";
+    }
+    os << "]}";
+
+    return os.str();
 }
 
 #ifdef AKS
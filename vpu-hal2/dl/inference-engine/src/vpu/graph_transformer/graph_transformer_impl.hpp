@@ -41,6 +41,7 @@
 #include <unordered_set>
 #include <string>
 #include <tuple>
+#include <functional>
 #include <precision_utils.h>
 #ifdef AKS
 #include <array>
@@ -796,13 +797,31 @@ struct VpuMyriadXHwPoolingStage : VpuStage {
 class GraphTransformerImpl : public IGraphTransformer {
 public:
     GraphTransformerImpl(const BlobConfig& blobConfig,
-                         const Common::LoggerPtr& log);
+                         const Common::LoggerPtr& log,
+                         bool allowStridedViews = true,
+                         const std::unordered_set<std::string>& stridedViewsBlackList = {});
 
     void generate(ICNNNetwork& network,
                   std::vector<char>& blob,
                   std::vector<BlobMetaData>& metaData,
                   size_t& numStages) override;
 
+    const std::vector<PassStatistics>& getPassStatistics() const override { return _passStats; }
+
+    const std::vector<BlobDataInfo>& getInputsInfo() const override { return _inputsInfo; }
+    const std::vector<BlobDataInfo>& getOutputsInfo() const override { return _outputsInfo; }
+
+    const std::vector<WeightsChunkInfo>& getWeightsChunks() const override { return _weightsChunks; }
+
+    const std::string& networkName() const { return _networkName; }
+
+    // Copy stages replaced by strided Concat/Split views, in the order of aliasing
+    const std::vector<std::string>& getStridedViews() const { return _stridedViewNames; }
+
+    // Copy stages whose strided views held memory when packMemory failed, the network
+    // can still be compiled with them in stridedViewsBlackList (kept as copies).
+    const std::unordered_set<std::string>& getFailedStridedViews() const { return _failedStridedViews; }
+
 public:
     void parseConvolution(const CNNLayerPtr& layer, const std::vector<VpuDataHandle>& inputs, const std::vector<VpuDataHandle>& outputs);
     void parsePooling(const CNNLayerPtr& layer, const std::vector<VpuDataHandle>& inputs, const std::vector<VpuDataHandle>& outputs);
@@ -857,6 +876,7 @@ private:
 
     void addOutputConvertStages();
 
+    void fuseStages();
     void packPostOps();
     void addHWStages();
     void packHWConcat();
@@ -866,10 +886,17 @@ private:
     void fillHWDescriptors();
     void packMemory();
 
+    bool isLossyCompressible(const VpuDataHandle& data) const;
     void finalize(std::vector<char>& blob);
 
     void getMetaData(std::vector<BlobMetaData>& metaData);
 
+    // Runs one pipeline pass and records its PassStatistics
+    void runPass(const char* name, const std::function<void()>& pass);
+    // Adds the value to the counter of the pass being executed
+    void addPassCounter(const char* name, uint64_t value);
+    size_t numActiveStages() const;
+
 private:
     using DataId = const void*;
 
@@ -929,6 +956,20 @@ private:
                                   const std::vector<VpuDataHandle>& outputs,
                                   const std::list<VpuStagePtr>::iterator* pos = nullptr);
 
+    bool fuseAffineChain(const std::list<VpuStagePtr>::iterator& stageIt);
+    bool fuseAffineIntoWeights(const std::list<VpuStagePtr>::iterator& stageIt);
+    bool fuseScaleBias(const std::list<VpuStagePtr>::iterator& stageIt);
+
+    void removeStage(const VpuStageHandle& stage);
+
+    VpuStageHandle addFusedScaleShiftStage(const std::string& name,
+                                           const CNNLayerPtr& layer,
+                                           const VpuDataHandle& input,
+                                           const VpuDataHandle& output,
+                                           const std::vector<float>& scale,
+                                           const std::vector<float>& shift,
+                                           const std::list<VpuStagePtr>::iterator& stageIt);
+
     using PostOpInfo = std::tuple<VpuStageHandle, VpuDataHandle, std::string>;
     PostOpInfo getPostOpInfoForHW(const VpuStagePtr& mainStage);
 
@@ -950,10 +991,32 @@ private:
     VpuDataHandle reshapeZYXToYXZ(const VpuDataHandle& origData);
     VpuDataHandle reshapeYXZToZYX(const VpuDataHandle& origData);
 
+    void markCopyEliminated(const VpuStageHandle& copyStage);
+    bool aliasReshapedCopy(const VpuStageHandle& copyStage);
+    bool aliasSubDataCopy(const VpuStageHandle& copyStage);
+    bool isStridedViewAllowed(const VpuStageHandle& copyStage) const;
+    void addStridedView(const VpuStageHandle& copyStage, const VpuDataHandle& view);
+
 private:
     BlobConfig _blobConfig;
     Common::LoggerPtr _log;
 
+    bool _allowStridedViews = true;
+    std::unordered_set<std::string> _stridedViewsBlackList;
+    std::vector<std::string> _stridedViewNames;
+    std::vector<VpuDataHandle> _stridedViewDatas;
+    std::unordered_set<std::string> _failedStridedViews;
+    uint32_t _aliasedViews = 0;
+    uint32_t _eliminatedCopyStages = 0;
+    size_t _eliminatedCopyBytes = 0;
+
+    std::vector<PassStatistics> _passStats;
+    bool _passActive = false;
+
+    std::vector<BlobDataInfo> _inputsInfo;
+    std::vector<BlobDataInfo> _outputsInfo;
+    std::vector<WeightsChunkInfo> _weightsChunks;
+
     std::string _networkName;
     InputsDataMap _networkInputs;
     OutputsDataMap _networkOutputs;
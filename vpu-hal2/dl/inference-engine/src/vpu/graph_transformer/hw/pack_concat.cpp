@@ -33,6 +33,7 @@
 #include "common.hpp"
 #include <vector>
 #include <unordered_set>
+#include <algorithm>
 
 namespace {
 
@@ -121,11 +122,11 @@ void GraphTransformerImpl::packHWConcat() {
             processedStages.insert(subData->producer.get());
         }
 
-        bool isAllInputsCHW = true;
+        // Inputs produced by SW stages in HWC layout.
+        // They are converted directly into the CHW Concat output (mixed Concat).
+        std::unordered_set<VpuStage*> swCopyStages;
+        bool isMixedSupported = true;
         for (auto curCopyStage : concatStages) {
-            if (!isAllInputsCHW)
-                break;
-
             auto curInput = curCopyStage->inputs[0];
             assert(curInput != nullptr);
 
@@ -139,15 +140,38 @@ void GraphTransformerImpl::packHWConcat() {
                 }
             });
 
+            bool isInputCHW = true;
             for (auto producer : producers) {
                 if (!isStageCHW(producer)) {
-                    isAllInputsCHW = false;
+                    isInputCHW = false;
                     break;
                 }
             }
+
+            if (!isInputCHW) {
+                if (curInput->parent != nullptr || !curInput->subData.empty() || curInput->order != orderYXZ ||
+                    !isStridedViewAllowed(curCopyStage))
+                    isMixedSupported = false;
+
+                swCopyStages.insert(curCopyStage.get());
+            }
+        }
+        if (!swCopyStages.empty()) {
+            // Mixed Concat is worth only if the HW inputs are in majority and
+            // the result goes to HW stages, otherwise keep it in HWC layout.
+            if (!isMixedSupported || 2 * swCopyStages.size() >= concatStages.size())
+                continue;
+
+            bool hasHwConsumer = false;
+            for (auto consumer : concatOutput->consumers) {
+                if (isHwStage(consumer)) {
+                    hasHwConsumer = true;
+                    break;
+                }
+            }
+            if (!hasHwConsumer)
+                continue;
         }
-        if (!isAllInputsCHW)
-            continue;
 
         concatOutput->order = orderZYX;
         concatOutput->strides = calcStrides(concatOutput->dims, concatOutput->type, concatOutput->order, 16u);
@@ -163,6 +187,30 @@ void GraphTransformerImpl::packHWConcat() {
             auto curOutput = curCopyStage->outputs[0];
             assert(curOutput != nullptr);
 
+            if (swCopyStages.find(curCopyStage.get()) != swCopyStages.end()) {
+                // [HWC] -> Copy -> [Concat CHW part]
+                // translate it to
+                // [HWC] -> ConvertOrder -> [Concat CHW part]
+
+                auto copyIt = std::find_if(_stages.begin(), _stages.end(),
+                    [curCopyStage](const VpuStagePtr& s) { return s.get() == curCopyStage.get(); });
+                assert(copyIt != _stages.end());
+
+                curInput->consumers.erase(curCopyStage);
+                curOutput->producer = nullptr;
+                curOutput->producerOutInd = -1;
+                curCopyStage->optimized = true;
+
+                auto cvtStage = addConvertStage(copyIt, curInput, curOutput);
+                cvtStage->requiredOutputAlignment[0] = 16u;
+
+                // ConvertOrder writes a strided view of the Concat output,
+                // the compilation must be retried without it if the memory allocation fails
+                addStridedView(curCopyStage, curOutput);
+
+                continue;
+            }
+
             if (curInput->subData.empty()) {
                 auto curInputProducer = curInput->producer;
                 if (curInputProducer == nullptr) {
@@ -180,7 +228,7 @@ void GraphTransformerImpl::packHWConcat() {
                     curOutput->producer = curInputProducer;
                     curOutput->producerOutInd = curInputProducerOutInd;
 
-                    curCopyStage->optimized = true;
+                    markCopyEliminated(curCopyStage);
                 } else {
                     // The HW stage will write the output with some padding,
                     // so we need to preserve Copy stage to avoid conflicts
@@ -230,7 +278,7 @@ void GraphTransformerImpl::packHWConcat() {
 
                 curInput->subData.clear();
 
-                curCopyStage->optimized = true;
+                markCopyEliminated(curCopyStage);
             }
         }
     }
@@ -34,6 +34,8 @@
 #include <cassert>
 #include <set>
 #include <list>
+#include <unordered_set>
+#include <unordered_map>
 
 #ifdef NNLOG
 #include <android/log.h>
@@ -99,8 +101,14 @@ void GraphTransformerImpl::parseNetwork(ICNNNetwork& network) {
 
     // Traversing the topology
 
-    std::set<DataPtr> availableData;
+    // raw pointers in hash sets, and the layers in the queue counted instead of searched for
+    std::unordered_set<const Data*> availableData;
     std::list<CNNLayerPtr> layersToHandle;
+    std::unordered_map<const CNNLayer*, size_t> queuedCount;
+    auto enqueue = [&](const CNNLayerPtr& layer) {
+        layersToHandle.push_back(layer);
+        queuedCount[layer.get()]++;
+    };
 
     // init by layers connected to inputs
     // layers that are not reachable from inputs will be ignored
@@ -109,14 +117,14 @@ void GraphTransformerImpl::parseNetwork(ICNNNetwork& network) {
         auto inputData = inputInfo.second->getInputData();
         assert(inputData != nullptr);
 
-        availableData.insert(inputData);
+        availableData.insert(inputData.get());
         for (const auto& layerInfo : inputData->inputTo) {
             assert(layerInfo.second != nullptr);
-            layersToHandle.push_back(layerInfo.second);
+            enqueue(layerInfo.second);
         }
     }
 
-    std::set<CNNLayerPtr> parsedLayers;
+    std::unordered_set<const CNNLayer*> parsedLayers;
     _orderedLayers.clear();
 
     size_t loopTracker = 0;
@@ -129,45 +137,43 @@ void GraphTransformerImpl::parseNetwork(ICNNNetwork& network) {
         }
 
         layersToHandle.pop_front();
+        queuedCount[layer.get()]--;
 
         bool allInputsAvailable = true;
         for (const auto& in : layer->insData) {
             auto inData = in.lock();
             assert(inData != nullptr);
 
-            if (availableData.find(inData) == availableData.end()) {
+            if (availableData.find(inData.get()) == availableData.end()) {
                 allInputsAvailable = false;
                 break;
             }
         }
 
         if (!allInputsAvailable) {
-            auto it = std::find(layersToHandle.begin(), layersToHandle.end(), layer);
-            if (it == layersToHandle.end()) {
-                layersToHandle.push_back(layer);
+            if (queuedCount[layer.get()] == 0) {
+                enqueue(layer);
             }
             loopTracker++;
             continue;
         }
 
-        if (parsedLayers.find(layer) == parsedLayers.end()) {
+        if (parsedLayers.insert(layer.get()).second) {
             _orderedLayers.push_back(layer);
-            parsedLayers.insert(layer);
         }
 
         // adding children to the list to verify
         for (const auto& out : layer->outData) {
             assert(out != nullptr);
-            availableData.insert(out);
+            availableData.insert(out.get());
 
             // new data added -> have to reset loop tracking
             loopTracker = 0;
 
             for (const auto& layerInfo : out->inputTo) {
                 assert(layerInfo.second != nullptr);
-                auto it = std::find(layersToHandle.begin(), layersToHandle.end(), layerInfo.second);
-                if (it == layersToHandle.end()) {
-                    layersToHandle.push_back(layerInfo.second);
+                if (queuedCount[layerInfo.second.get()] == 0) {
+                    enqueue(layerInfo.second);
                 }
             }
         }
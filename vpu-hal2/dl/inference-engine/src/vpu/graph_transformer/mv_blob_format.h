@@ -36,6 +36,12 @@
 
 namespace VPU {
 
+const uint32_t BLOB_MAGIC_NUMBER = 8708;
+const uint32_t BLOB_VERSION_MAJOR = 2;
+const uint32_t BLOB_VERSION_MINOR = 1;
+// Buffer section holds compressed weights (see mv_weights_chunk_header)
+const uint32_t BLOB_VERSION_MINOR_COMPRESSED_WEIGHTS = 2;
+
 const uint32_t EI_NIDENT = 2;  // 16?
 
 PACKED(ElfN_Ehdr {
@@ -69,9 +75,49 @@ PACKED(mv_blob_header {
 
 PACKED(mv_buffer_section_header {
     uint32_t buffer_section_size;
-    uint8_t unused[12];
+    // Fields below are used only by blob version 2.2, they are zero in version 2.1
+    uint32_t compression_flags;
+    uint32_t decompressed_size;
+    uint32_t chunk_count;
 };)
 
+enum mvWeightsCompressionFlags {
+    WEIGHTS_COMPRESSED = 0x1
+};
+
+enum mvWeightsCodec {
+    // Chunk is stored as is
+    WEIGHTS_CODEC_RAW = 0,
+    // Lossless: FP16 values are split into low and high byte planes,
+    // each plane is coded with canonical Huffman code (see mv_weights_plane_header)
+    WEIGHTS_CODEC_FP16_HUFFMAN = 1,
+    // Lossy: 256 entries FP16 palette followed by 8-bit index per value
+    WEIGHTS_CODEC_U8_PALETTE = 2
+};
+
+// Compressed buffer section consists of chunk_count headers followed by chunk payloads.
+// Each chunk is decoded to [dst_offset, dst_offset + dst_size) of the decompressed buffer,
+// so the relocation table refers to the same offsets as in uncompressed blob.
+PACKED(mv_weights_chunk_header {
+    uint32_t dst_offset;
+    uint32_t dst_size;
+    uint32_t src_offset;  // from the end of the chunk headers table
+    uint32_t src_size;
+    uint32_t codec;
+};)
+
+// WEIGHTS_CODEC_FP16_HUFFMAN payload is two planes (low bytes, then high bytes), each one is
+// mv_weights_plane_header followed by bitstream (MSB first) of bitstream_size bytes.
+// Code lengths of the 256 symbols are packed as 4-bit values (low nibble first), 0 means unused symbol.
+const uint32_t WEIGHTS_HUFFMAN_MAX_CODE_LENGTH = 15;
+
+PACKED(mv_weights_plane_header {
+    uint8_t code_lengths[128];
+    uint32_t bitstream_size;
+};)
+
+const uint32_t WEIGHTS_PALETTE_SIZE = 256;
+
 PACKED(mv_relocation_section_header {
     uint32_t relocation_buffer_size;
     uint32_t blob_buffer_reloc_offset;
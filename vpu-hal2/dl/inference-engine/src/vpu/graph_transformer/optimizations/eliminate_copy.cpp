@@ -32,6 +32,185 @@
 
 #include "graph_transformer_impl.hpp"
 
+namespace {
+
+// SW stages which take the output strides from the blob descriptor
+// and thus can write directly into a sub-view of bigger data.
+bool supportsStridedOutput(const VpuStageHandle& stage) {
+    auto type = stage->type;
+    return type == kConv || type == kDeconvolution || type == kBias ||
+           type == kRelu || type == kReluX || type == kLeakyRelu ||
+           type == kBiasRelu || type == kConvertOrder || type == kIm2ColConvolution;
+}
+
+// SW stages which take the input strides from the blob descriptor
+// and thus can read directly from a sub-view of bigger data.
+// Only the kernels, which already read strided views in the non-optimized graph, are listed :
+// Copy (Split/Slice/Crop sub-views) and ConvertOrder (HW aligned data). The compute kernels
+// (including im2col convolution) may assume dense input lines, so they still get a dense copy.
+bool supportsStridedInput(const VpuStageHandle& stage) {
+    return stage->type == kCopy || stage->type == kConvertOrder;
+}
+
+bool isSameLayout(const VpuDataHandle& first, const VpuDataHandle& second) {
+    if (first->type != second->type || first->order != second->order)
+        return false;
+
+    if (first->dims.count() != second->dims.count())
+        return false;
+
+    for (size_t i = 0; i < first->dims.count(); ++i) {
+        if (first->dims[i] != second->dims[i])
+            return false;
+    }
+
+    return true;
+}
+
+// The innermost dimension must be dense, only outer strides can be changed by the view.
+bool hasDenseInnerDim(const VpuDataHandle& data) {
+    auto innerDim = data->order == orderZYX ? Dim::X : Dim::Z;
+    return data->strides[innerDim] == getDataTypeSize(data->type);
+}
+
+}  // namespace
+
+void GraphTransformerImpl::markCopyEliminated(const VpuStageHandle& copyStage) {
+    assert(copyStage->type == kCopy);
+
+    auto output = copyStage->outputs[0];
+    assert(output != nullptr);
+
+    copyStage->optimized = true;
+
+    ++_eliminatedCopyStages;
+    _eliminatedCopyBytes += output->dims.totalSize() * getDataTypeSize(output->type);
+}
+
+// [X] -> Producer -> [input] -> [input@reshaped] -> Copy -> [output@reshaped] -> [output]
+// translate it to
+// [X] -> Producer -> [output]
+// when both reshapes describe the same layout and Producer can write strided output.
+bool GraphTransformerImpl::aliasReshapedCopy(const VpuStageHandle& copyStage) {
+    auto input = copyStage->inputs[0]->parent;
+    auto output = copyStage->outputs[0]->parent;
+    if (input == nullptr || output == nullptr)
+        return false;
+
+    if (input->parent != nullptr || input->index != IndexBSS ||
+        input->subData.size() != 1 || !input->consumers.empty())
+        return false;
+
+    auto producer = input->producer;
+    if (producer == nullptr || producer->optimized || producer->parentOp != nullptr || producer->postOp != nullptr)
+        return false;
+
+    if (!supportsStridedOutput(producer))
+        return false;
+
+    if (!isSameLayout(input, output) || !hasDenseInnerDim(output))
+        return false;
+
+    if (output->order == orderZYX &&
+        output->strides[Dim::Y] % producer->requiredOutputAlignment[input->producerOutInd] != 0)
+        return false;
+
+    auto inputReshaped = copyStage->inputs[0];
+    auto outputReshaped = copyStage->outputs[0];
+
+    inputReshaped->consumers.erase(copyStage);
+    outputReshaped->producer = nullptr;
+    outputReshaped->producerOutInd = -1;
+
+    producer->outputs[input->producerOutInd] = output;
+    output->producer = producer;
+    output->producerOutInd = input->producerOutInd;
+    input->producer = nullptr;
+    input->producerOutInd = -1;
+
+    markCopyEliminated(copyStage);
+    addStridedView(copyStage, output);
+
+    return true;
+}
+
+// [parent] -> [input] -> Copy -> [output] -> Consumers
+// translate it to
+// [parent] -> [input] -> Consumers
+// when all consumers can read strided input (Split/Slice outputs).
+bool GraphTransformerImpl::aliasSubDataCopy(const VpuStageHandle& copyStage) {
+    auto input = copyStage->inputs[0];
+    auto output = copyStage->outputs[0];
+
+    if (input->parent == nullptr)
+        return false;
+
+    if (output->index != IndexBSS || output->parent != nullptr || !output->subData.empty())
+        return false;
+
+    if (output->consumers.empty())
+        return false;
+
+    if (!isSameLayout(input, output) || !hasDenseInnerDim(input))
+        return false;
+
+    for (const auto& consumer : output->consumers) {
+        if (consumer->optimized || consumer->parentOp != nullptr || !supportsStridedInput(consumer))
+            return false;
+
+        for (size_t i = 0; i < consumer->inputs.size(); ++i) {
+            if (consumer->inputs[i] != output)
+                continue;
+
+            if (consumer->requiredInputOrder[i] != input->order)
+                return false;
+
+            if (input->order == orderZYX &&
+                input->strides[Dim::Y] % consumer->requiredInputAlignment[i] != 0)
+                return false;
+        }
+
+        // In-place consumers would write into the parent data
+        for (const auto& consumerOutput : consumer->outputs) {
+            if (consumerOutput == output)
+                return false;
+        }
+    }
+
+    input->consumers.erase(copyStage);
+
+    for (const auto& consumer : output->consumers) {
+        for (auto& consumerInput : consumer->inputs) {
+            if (consumerInput == output) {
+                consumerInput = input;
+            }
+        }
+
+        input->consumers.insert(consumer);
+    }
+
+    output->consumers.clear();
+    output->producer = nullptr;
+    output->producerOutInd = -1;
+
+    markCopyEliminated(copyStage);
+    addStridedView(copyStage, input);
+
+    return true;
+}
+
+bool GraphTransformerImpl::isStridedViewAllowed(const VpuStageHandle& copyStage) const {
+    return _allowStridedViews && _stridedViewsBlackList.find(copyStage->name) == _stridedViewsBlackList.end();
+}
+
+// The view makes the whole Concat/Split data live as long as any of its parts,
+// packMemory reports the views whose data held memory when it failed.
+void GraphTransformerImpl::addStridedView(const VpuStageHandle& copyStage, const VpuDataHandle& view) {
+    _stridedViewNames.push_back(copyStage->name);
+    _stridedViewDatas.push_back(view);
+    ++_aliasedViews;
+}
+
 void GraphTransformerImpl::eliminateCopyStages() {
     for (auto& stage : _stages) {
         if (stage->optimized)
@@ -44,6 +223,12 @@ void GraphTransformerImpl::eliminateCopyStages() {
             auto output = stage->outputs[0];
             assert(output != nullptr);
 
+            if (isStridedViewAllowed(stage)) {
+                if (aliasReshapedCopy(stage) || aliasSubDataCopy(stage)) {
+                    continue;
+                }
+            }
+
             if (input->producer == nullptr) {
                 // It might be the following case
                 // [CHW] -> ConvertOrder -> [input@reshaped] -> [input] -> Copy -> [output]
@@ -60,17 +245,14 @@ void GraphTransformerImpl::eliminateCopyStages() {
                         output->subData.insert(inputSubData);
                         output->producer = nullptr;
                         output->producerOutInd = -1;
-                        stage->optimized = true;
+                        markCopyEliminated(stage);
                     }
                 }
 
                 continue;
             }
 
-            auto producerType = input->producer->type;
-            if (producerType != kConv && producerType != kDeconvolution && producerType != kBias &&
-                producerType != kRelu && producerType != kReluX && producerType != kLeakyRelu &&
-                producerType != kBiasRelu && producerType != kConvertOrder && producerType != kIm2ColConvolution) {
+            if (!supportsStridedOutput(input->producer)) {
                 continue;
             }
 
@@ -81,7 +263,7 @@ void GraphTransformerImpl::eliminateCopyStages() {
                 input->producer->outputs[input->producerOutInd] = output;
                 output->producer = input->producer;
                 output->producerOutInd = input->producerOutInd;
-                stage->optimized = true;
+                markCopyEliminated(stage);
             } else {
                 // Post-ops are in-place, so input has at least 2 consumers (copy and post-op)
                 if (input->consumers.size() > 2)
@@ -125,7 +307,7 @@ void GraphTransformerImpl::eliminateCopyStages() {
                 postOp->outputs[input->producerOutInd] = output;
                 output->producer = postOp;
                 output->producerOutInd = input->producerOutInd;
-                stage->optimized = true;
+                markCopyEliminated(stage);
             }
         }
     }
@@ -0,0 +1,455 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+
+#include "graph_transformer_impl.hpp"
+#include <vector>
+#include <memory>
+#include <string>
+#include <list>
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+// Per-channel transformation y = scale * x + shift
+struct AffineParams {
+    std::vector<float> scale;
+    std::vector<float> shift;
+};
+
+class FusedValuesWriter : public DataWriter {
+public:
+    explicit FusedValuesWriter(const std::vector<float>& values) : _values(values) {
+    }
+
+    size_t byteSize() const override {
+        return _values.size() * sizeof(ie_fp16);
+    }
+
+    void write(void* dst) const override {
+        auto dstPtr = static_cast<ie_fp16*>(dst);
+        for (size_t i = 0; i < _values.size(); ++i) {
+            dstPtr[i] = PrecisionUtils::f32tof16(_values[i]);
+        }
+    }
+
+private:
+    std::vector<float> _values;
+};
+
+std::vector<float> readDataValues(const VpuDataHandle& data) {
+    assert(data->writer != nullptr);
+    assert(data->type == VpuDataType::FP16);
+
+    std::vector<ie_fp16> fp16Values(data->writer->byteSize() / sizeof(ie_fp16));
+    data->writer->write(fp16Values.data());
+
+    std::vector<float> values(fp16Values.size());
+    for (size_t i = 0; i < fp16Values.size(); ++i) {
+        values[i] = PrecisionUtils::f16tof32(fp16Values[i]);
+    }
+
+    return values;
+}
+
+// Bias post-op works in-place, so it is registered as producer of the main stage output
+VpuStageHandle getMainProducer(const VpuDataHandle& data) {
+    auto producer = data->producer;
+    if (producer != nullptr && producer->type == kBias && producer->parentOp != nullptr) {
+        producer = producer->parentOp;
+    }
+    return producer;
+}
+
+bool getAffineParams(const VpuStageHandle& stage, AffineParams& params) {
+    if (stage == nullptr || stage->optimized)
+        return false;
+
+    auto numChannels = stage->outputs[0]->dims[Dim::Z];
+
+    if (stage->type == kScale) {
+        if (stage->postOp != nullptr && stage->postOp->type != kBias)
+            return false;
+        if (stage->inputs[1]->writer == nullptr)
+            return false;
+
+        params.scale = readDataValues(stage->inputs[1]);
+
+        if (stage->postOp != nullptr) {
+            if (stage->postOp->inputs[1]->writer == nullptr)
+                return false;
+
+            params.shift = readDataValues(stage->postOp->inputs[1]);
+        } else {
+            params.shift.assign(numChannels, 0.0f);
+        }
+    } else if (stage->type == kScaleShift) {
+        if (stage->postOp != nullptr)
+            return false;
+        if (stage->inputs[1]->writer == nullptr || stage->inputs[2]->writer == nullptr)
+            return false;
+
+        params.scale = readDataValues(stage->inputs[1]);
+        params.shift = readDataValues(stage->inputs[2]);
+    } else if (stage->type == kPower) {
+        auto powerStage = stage.staticCast<VpuPowerStage>();
+        if (powerStage->power != 1.0f || stage->postOp != nullptr)
+            return false;
+
+        params.scale.assign(numChannels, powerStage->scale);
+        params.shift.assign(numChannels, powerStage->offset);
+    } else {
+        return false;
+    }
+
+    return params.scale.size() == numChannels && params.shift.size() == numChannels;
+}
+
+// Checks that `data` is an intermediate result, which is read only by `consumer`
+// (except the in-place post-op of its `producer`), so it can be removed from the graph.
+bool isPrivateIntermediate(const VpuDataHandle& data, const VpuStageHandle& producer, const VpuStageHandle& consumer) {
+    if (data->index != IndexBSS)
+        return false;
+    if (data->parent != nullptr || !data->subData.empty())
+        return false;
+
+    for (const auto& dataConsumer : data->consumers) {
+        if (dataConsumer == consumer)
+            continue;
+        if (producer->postOp != nullptr && dataConsumer == producer->postOp)
+            continue;
+        return false;
+    }
+
+    return true;
+}
+
+Blob::Ptr scaleWeights(const Blob::Ptr& weights, const std::vector<float>& scale) {
+    auto channelSize = weights->size() / scale.size();
+
+    const auto& origDesc = weights->getTensorDesc();
+    auto fused = make_shared_blob<ie_fp16>(TensorDesc(Precision::FP16, origDesc.getDims(), origDesc.getLayout()));
+    fused->allocate();
+
+    auto srcPtr = weights->cbuffer().as<const ie_fp16*>();
+    auto dstPtr = fused->buffer().as<ie_fp16*>();
+    for (size_t i = 0; i < weights->size(); ++i) {
+        auto val = PrecisionUtils::f16tof32(srcPtr[i]) * scale[i / channelSize];
+        dstPtr[i] = PrecisionUtils::f32tof16(val);
+    }
+
+    return fused;
+}
+
+Blob::Ptr fuseBiases(const Blob::Ptr& biases, const AffineParams& affine) {
+    auto numChannels = affine.scale.size();
+
+    auto fused = make_shared_blob<ie_fp16>(Precision::FP16, C, SizeVector{numChannels});
+    fused->allocate();
+
+    auto dstPtr = fused->buffer().as<ie_fp16*>();
+    for (size_t i = 0; i < numChannels; ++i) {
+        float val = biases != nullptr ? PrecisionUtils::f16tof32(biases->cbuffer().as<const ie_fp16*>()[i]) : 0.0f;
+        dstPtr[i] = PrecisionUtils::f32tof16(affine.scale[i] * val + affine.shift[i]);
+    }
+
+    return fused;
+}
+
+template <class LayerType>
+std::shared_ptr<LayerType> cloneWithAffine(const std::shared_ptr<LayerType>& layer, const AffineParams& affine) {
+    auto fused = std::make_shared<LayerType>(*layer);
+
+    fused->_weights = scaleWeights(layer->_weights, affine.scale);
+    fused->_biases = fuseBiases(layer->_biases, affine);
+
+    if (fused->blobs.find("weights") != fused->blobs.end())
+        fused->blobs["weights"] = fused->_weights;
+    if (fused->blobs.find("biases") != fused->blobs.end())
+        fused->blobs["biases"] = fused->_biases;
+
+    return fused;
+}
+
+}  // namespace
+
+void GraphTransformerImpl::fuseStages() {
+    typedef bool (GraphTransformerImpl::*fusion_rule_t)(const std::list<VpuStagePtr>::iterator& stageIt);
+
+    struct FusionRule {
+        const char* name;
+        fusion_rule_t apply;
+    };
+
+    // The order is important : affine chains are collapsed first,
+    // so the result can be folded into the preceding Convolution/FC weights.
+    static const FusionRule rules[] = {
+        {"AffineChain",   &GraphTransformerImpl::fuseAffineChain},
+        {"AffineWeights", &GraphTransformerImpl::fuseAffineIntoWeights},
+        {"ScaleBias",     &GraphTransformerImpl::fuseScaleBias},
+    };
+
+    for (const auto& rule : rules) {
+        const auto& blackList = _blobConfig.fusionBlackList;
+        if (std::find(blackList.begin(), blackList.end(), rule.name) != blackList.end()) {
+            LOG_INFO("[VPU] GraphTransformer : fusion rule %s is disabled", rule.name);
+            continue;
+        }
+
+        int numFused = 0;
+        for (auto stageIt = _stages.begin(); stageIt != _stages.end(); ++stageIt) {
+            if ((*stageIt)->optimized)
+                continue;
+
+            if ((this->*rule.apply)(stageIt))
+                ++numFused;
+        }
+
+        LOG_INFO("[VPU] GraphTransformer : fusion rule %s applied %d times", rule.name, numFused);
+        addPassCounter(rule.name, numFused);
+    }
+}
+
+void GraphTransformerImpl::removeStage(const VpuStageHandle& stage) {
+    if (stage->postOp != nullptr) {
+        auto postOp = stage->postOp;
+        stage->postOp = nullptr;
+        postOp->parentOp = nullptr;
+        removeStage(postOp);
+    }
+
+    if (stage->parentOp != nullptr) {
+        stage->parentOp->postOp = nullptr;
+        stage->parentOp = nullptr;
+    }
+
+    for (const auto& input : stage->inputs) {
+        input->consumers.erase(stage);
+
+        // Constant data, which is not used anymore, must not be stored in the blob
+        if (input->index == IndexBlob && input->consumers.empty()) {
+            input->index = IndexNone;
+            input->writer = nullptr;
+        }
+    }
+
+    for (const auto& output : stage->outputs) {
+        if (output->producer == stage) {
+            output->producer = nullptr;
+            output->producerOutInd = -1;
+        }
+    }
+
+    stage->optimized = true;
+}
+
+VpuStageHandle GraphTransformerImpl::addFusedScaleShiftStage(const std::string& name,
+                                                             const CNNLayerPtr& layer,
+                                                             const VpuDataHandle& input,
+                                                             const VpuDataHandle& output,
+                                                             const std::vector<float>& scale,
+                                                             const std::vector<float>& shift,
+                                                             const std::list<VpuStagePtr>::iterator& stageIt) {
+    auto numChannels = static_cast<uint32_t>(scale.size());
+
+    auto weights = addNewData(
+        newDataId(),
+        [name, numChannels, &scale](VpuData* data) {
+            data->name = name + "@weights";
+            data->index = IndexBlob;
+            data->type = VpuDataType::FP16;
+            data->order = orderXYZ;
+            data->dims = VpuDims({1, 1, numChannels});
+            data->strides = calcStrides(data->dims, data->type, data->order);
+            data->writer = std::make_shared<FusedValuesWriter>(scale);
+        });
+
+    auto biases = addNewData(
+        newDataId(),
+        [name, numChannels, &shift](VpuData* data) {
+            data->name = name + "@biases";
+            data->index = IndexBlob;
+            data->type = VpuDataType::FP16;
+            data->order = orderXYZ;
+            data->dims = VpuDims({numChannels, 1, 1});
+            data->strides = calcStrides(data->dims, data->type, data->order);
+            data->writer = std::make_shared<FusedValuesWriter>(shift);
+        });
+
+    return addNewStage<VpuScaleShiftStage>(
+        name,
+        kScaleShift,
+        layer,
+        [](VpuScaleShiftStage* /*stage*/) {
+        },
+        {input, weights, biases},
+        {output},
+        nullptr,
+        &stageIt);
+}
+
+//
+// Scale/ScaleShift/Power(power=1) -> Scale/ScaleShift/Power(power=1)  ==>  ScaleShift
+//
+
+bool GraphTransformerImpl::fuseAffineChain(const std::list<VpuStagePtr>::iterator& stageIt) {
+    VpuStageHandle second = *stageIt;
+
+    AffineParams secondParams;
+    if (!getAffineParams(second, secondParams))
+        return false;
+
+    auto intermediate = second->inputs[0];
+
+    auto first = getMainProducer(intermediate);
+
+    AffineParams firstParams;
+    if (!getAffineParams(first, firstParams))
+        return false;
+
+    if (firstParams.scale.size() != secondParams.scale.size())
+        return false;
+
+    if (!isPrivateIntermediate(intermediate, first, second))
+        return false;
+
+    // s2 * (s1 * x + b1) + b2 = (s2 * s1) * x + (s2 * b1 + b2)
+    AffineParams fused;
+    fused.scale.resize(firstParams.scale.size());
+    fused.shift.resize(firstParams.shift.size());
+    for (size_t i = 0; i < fused.scale.size(); ++i) {
+        fused.scale[i] = secondParams.scale[i] * firstParams.scale[i];
+        fused.shift[i] = secondParams.scale[i] * firstParams.shift[i] + secondParams.shift[i];
+    }
+
+    auto name = first->name + "+" + second->name;
+    auto layer = second->layer;
+    auto input = first->inputs[0];
+    auto output = second->outputs[0];
+
+    removeStage(first);
+    removeStage(second);
+
+    addFusedScaleShiftStage(name, layer, input, output, fused.scale, fused.shift, stageIt);
+
+    return true;
+}
+
+//
+// Convolution/FullyConnected -> Scale/ScaleShift/Power(power=1)  ==>  Convolution/FullyConnected with new weights and biases
+//
+
+bool GraphTransformerImpl::fuseAffineIntoWeights(const std::list<VpuStagePtr>::iterator& stageIt) {
+    VpuStageHandle affineStage = *stageIt;
+
+    AffineParams affine;
+    if (!getAffineParams(affineStage, affine))
+        return false;
+
+    auto intermediate = affineStage->inputs[0];
+
+    auto mainStage = getMainProducer(intermediate);
+    if (mainStage == nullptr || mainStage->optimized)
+        return false;
+
+    if (mainStage->type != kConv && mainStage->type != kIm2ColConvolution &&
+        mainStage->type != kDepthConv && mainStage->type != kFC)
+        return false;
+
+    if (!isPrivateIntermediate(intermediate, mainStage, affineStage))
+        return false;
+
+    CNNLayerPtr fusedLayer;
+    parser_t parser = nullptr;
+    if (auto convLayer = std::dynamic_pointer_cast<ConvolutionLayer>(mainStage->layer)) {
+        // Grouped convolution is split into several stages with the same layer
+        if (convLayer->_group != 1 && mainStage->type != kDepthConv)
+            return false;
+        if (convLayer->_weights == nullptr || convLayer->_weights->size() % affine.scale.size() != 0)
+            return false;
+        if (convLayer->_biases != nullptr && convLayer->_biases->size() != affine.scale.size())
+            return false;
+
+        fusedLayer = cloneWithAffine(convLayer, affine);
+        parser = &GraphTransformerImpl::parseConvolution;
+    } else if (auto fcLayer = std::dynamic_pointer_cast<FullyConnectedLayer>(mainStage->layer)) {
+        if (fcLayer->_weights == nullptr || fcLayer->_weights->size() % affine.scale.size() != 0)
+            return false;
+        if (fcLayer->_biases != nullptr && fcLayer->_biases->size() != affine.scale.size())
+            return false;
+
+        fusedLayer = cloneWithAffine(fcLayer, affine);
+        parser = &GraphTransformerImpl::parseFullyConnected;
+    } else {
+        return false;
+    }
+
+    auto input = mainStage->inputs[0];
+    auto output = affineStage->outputs[0];
+
+    removeStage(mainStage);
+    removeStage(affineStage);
+
+    // Parse the fused layer once again and move the new stages to the position of the removed affine stage
+    auto lastStageIt = std::prev(_stages.end());
+    (this->*parser)(fusedLayer, {input}, {output});
+    _stages.splice(stageIt, _stages, std::next(lastStageIt), _stages.end());
+
+    return true;
+}
+
+//
+// Scale -> Bias  ==>  ScaleShift
+//
+
+bool GraphTransformerImpl::fuseScaleBias(const std::list<VpuStagePtr>::iterator& stageIt) {
+    VpuStageHandle stage = *stageIt;
+
+    if (stage->type != kScale || stage->postOp == nullptr)
+        return false;
+
+    AffineParams affine;
+    if (!getAffineParams(stage, affine))
+        return false;
+
+    auto name = stage->name;
+    auto layer = stage->layer;
+    auto input = stage->inputs[0];
+    auto output = stage->outputs[0];
+
+    removeStage(stage);
+
+    addFusedScaleShiftStage(name, layer, input, output, affine.scale, affine.shift, stageIt);
+
+    return true;
+}
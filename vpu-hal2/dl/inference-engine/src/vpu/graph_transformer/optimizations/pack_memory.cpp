@@ -123,6 +123,7 @@ public:
             auto minMemIt = _memPool.end();
 
             for (auto memPoolIt = _memPool.begin(); memPoolIt != _memPool.end(); ++memPoolIt) {
+                ++_iterations;
                 if (memPoolIt->size >= size) {
                     minMemIt = memPoolIt;
                     break;
@@ -173,6 +174,7 @@ public:
                 bool found = false;
 
                 for (auto memPoolIt = _memPool.begin(); memPoolIt != _memPool.end(); ++memPoolIt) {
+                    ++_iterations;
                     if (newMem.offset + newMem.size == memPoolIt->offset) {
                         // [newMem][*memPoolIt] case
                         // extend newMem to and remove memPoolIt
@@ -214,6 +216,11 @@ public:
         return _memUsed;
     }
 
+    // Number of free list entries visited by allocate/free calls
+    uint64_t iterations() const {
+        return _iterations;
+    }
+
 private:
     bool _memOptimization;
     IndexCodes _index;
@@ -221,6 +228,7 @@ private:
 
     uint32_t _memOffset = 0;
     uint32_t _memUsed = 0;
+    uint64_t _iterations = 0;
 
     std::unordered_map<VpuDataHandle, Chunk, VpuDataHandleHash> _memMap;
     std::list<FreeMemory> _memPool;
@@ -406,6 +414,17 @@ void GraphTransformerImpl::packMemory() {
         return ddrAllocator.allocate(size, padding, inuse, data);
     };
 
+    // Strided views whose data is live (or failed to be allocated) are the candidates to be copied again
+    auto markFailedStridedViews = [this, &findChunk](const VpuDataHandle& failedData) {
+        for (size_t i = 0; i < _stridedViewDatas.size(); ++i) {
+            auto parent = getDataTopParent(_stridedViewDatas[i]);
+            auto chunk = findChunk(parent);
+            if (parent == failedData || (chunk != nullptr && chunk->inuse > 0)) {
+                _failedStridedViews.insert(_stridedViewNames[i]);
+            }
+        }
+    };
+
     // Allocate space for BSS/CMX data
 
     for (auto stageIt = _stages.begin(); stageIt != _stages.end(); ++stageIt) {
@@ -579,6 +598,7 @@ void GraphTransformerImpl::packMemory() {
 
                 chunk = allocateChunk(canUseCMX, bufferSize, paddingSize, consumers.size(), parent);
                 if (chunk == nullptr) {
+                    markFailedStridedViews(parent);
                     THROW_IE_EXCEPTION << "[VPU] Could not allocate memory buffer for " << parent->name;
                 }
 
@@ -622,6 +642,7 @@ void GraphTransformerImpl::packMemory() {
             if (chunk == nullptr) {
                 auto producer = parent->producer;
                 if (producer == nullptr || !producer->optimized) {
+                    markFailedStridedViews(parent);
                     THROW_IE_EXCEPTION << "[VPU] Could not allocate memory buffer for " << input->name;
                 }
 
@@ -699,6 +720,11 @@ void GraphTransformerImpl::packMemory() {
 
     _bssMemSize = ddrAllocator.memUsed() + maxTempBufSize;
 
+    addPassCounter("allocator_iterations", cmxAllocator.iterations() + ddrAllocator.iterations());
+    addPassCounter("bss_bytes", _bssMemSize);
+    addPassCounter("cmx_bytes", cmxAllocator.memUsed());
+    addPassCounter("blob_data_bytes", _blobTotalDataSize);
+
     LOG_INFO("[VPU] GraphTransformer : DDR memory usage = %u CMX memory usage = %u",
              static_cast<uint32_t>(_bssMemSize),
              static_cast<uint32_t>(cmxAllocator.memUsed()));
@@ -0,0 +1,1747 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+
+#include "reference_executor.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <chrono>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <algorithm>
+
+#include <precision_utils.h>
+
+#include "graph_transformer_impl.hpp"
+
+namespace VPU {
+
+namespace {
+
+// Data types of the blob data descriptor (see VpuData::dumpToBlob)
+enum {
+    t_fp16,
+    t_u8f,
+    t_int,
+    t_fp32
+};
+
+// Upper bound of the CMX slice that can be given to a graph
+const uint32_t REFERENCE_CMX_SIZE = 4 * 1024 * 1024;
+
+// Cost model parameters, cycles are counted at SHAVE clock
+const uint64_t SHAVE_OPS_PER_CYCLE = 8;  // one FP16 vector op per SHAVE
+const uint64_t HW_MACS_PER_CYCLE = 256;
+const uint64_t DDR_BYTES_PER_CYCLE = 16;
+const uint64_t SW_STAGE_OVERHEAD = 2000;
+const uint64_t HW_STAGE_OVERHEAD = 500;
+
+enum PriorBox_CodeType {
+    CORNER = 1,
+    CENTER_SIZE,
+    CORNER_SIZE
+};
+
+bool isHwStageType(t_MvTensorOpType type) {
+    return type == kMyriadXHwConvolution ||
+           type == kMyriadXHwFCL ||
+           type == kMyriadXHwPooling;
+}
+
+bool inRange(int32_t coord, int32_t size) {
+    return coord >= 0 && coord < size;
+}
+
+// Left padding for TensorFlow SAME style, Caffe style stores it explicitly
+int32_t calcPad(uint32_t paddStyle, uint32_t pad, uint32_t inSize, uint32_t outSize, uint32_t radix, uint32_t stride, uint32_t dilation) {
+    if (paddStyle != paddStyleTFSame) {
+        return static_cast<int32_t>(pad);
+    }
+
+    int32_t total = static_cast<int32_t>((outSize - 1) * stride + (radix - 1) * dilation + 1) - static_cast<int32_t>(inSize);
+    return std::max(total, 0) / 2;
+}
+
+float sigmoid(float x) {
+    return 1.0f / (1.0f + std::exp(-x));
+}
+
+struct Box {
+    float xmin, ymin, xmax, ymax;
+};
+
+float boxArea(const Box& b) {
+    if (b.xmax < b.xmin || b.ymax < b.ymin) {
+        return 0.0f;
+    }
+    return (b.xmax - b.xmin) * (b.ymax - b.ymin);
+}
+
+float jaccardOverlap(const Box& a, const Box& b) {
+    Box inter;
+    inter.xmin = std::max(a.xmin, b.xmin);
+    inter.ymin = std::max(a.ymin, b.ymin);
+    inter.xmax = std::min(a.xmax, b.xmax);
+    inter.ymax = std::min(a.ymax, b.ymax);
+
+    auto interArea = boxArea(inter);
+    auto unionArea = boxArea(a) + boxArea(b) - interArea;
+    return unionArea > 0.0f ? interArea / unionArea : 0.0f;
+}
+
+Box decodeBox(const Box& prior, const float var[4], const float loc[4], int32_t codeType) {
+    Box box;
+
+    if (codeType == CORNER) {
+        box.xmin = prior.xmin + var[0] * loc[0];
+        box.ymin = prior.ymin + var[1] * loc[1];
+        box.xmax = prior.xmax + var[2] * loc[2];
+        box.ymax = prior.ymax + var[3] * loc[3];
+    } else if (codeType == CENTER_SIZE) {
+        auto priorWidth = prior.xmax - prior.xmin;
+        auto priorHeight = prior.ymax - prior.ymin;
+        auto priorCenterX = (prior.xmin + prior.xmax) / 2.0f;
+        auto priorCenterY = (prior.ymin + prior.ymax) / 2.0f;
+
+        auto centerX = var[0] * loc[0] * priorWidth + priorCenterX;
+        auto centerY = var[1] * loc[1] * priorHeight + priorCenterY;
+        auto width = std::exp(var[2] * loc[2]) * priorWidth;
+        auto height = std::exp(var[3] * loc[3]) * priorHeight;
+
+        box.xmin = centerX - width / 2.0f;
+        box.ymin = centerY - height / 2.0f;
+        box.xmax = centerX + width / 2.0f;
+        box.ymax = centerY + height / 2.0f;
+    } else {
+        auto priorWidth = prior.xmax - prior.xmin;
+        auto priorHeight = prior.ymax - prior.ymin;
+
+        box.xmin = prior.xmin + var[0] * loc[0] * priorWidth;
+        box.ymin = prior.ymin + var[1] * loc[1] * priorHeight;
+        box.xmax = prior.xmax + var[2] * loc[2] * priorWidth;
+        box.ymax = prior.ymax + var[3] * loc[3] * priorHeight;
+    }
+
+    return box;
+}
+
+template <class Reader>
+std::vector<cnnDescriptor> readDescriptors(Reader& reader) {
+    auto numDescriptors = reader.template read<uint32_t>();
+
+    std::vector<cnnDescriptor> descriptors(numDescriptors);
+    for (auto& desc : descriptors) {
+        desc = reader.template read<cnnDescriptor>();
+
+        if (desc.Line0.cm != FP16_COEFF || desc.Line0.dm != MODE_FP16) {
+            THROW_IE_EXCEPTION << "[VPU] Reference executor : only FP16 HW descriptors are supported";
+        }
+    }
+
+    return descriptors;
+}
+
+float readF16(const uint8_t* ptr) {
+    ie_fp16 val;
+    std::memcpy(&val, ptr, sizeof(val));
+    return PrecisionUtils::f16tof32(val);
+}
+
+void writeF16(uint8_t* ptr, float val) {
+    auto f16 = PrecisionUtils::f32tof16(val);
+    std::memcpy(ptr, &f16, sizeof(f16));
+}
+
+}  // namespace
+
+//
+// StageReader
+//
+
+class BlobReferenceExecutor::StageReader {
+public:
+    explicit StageReader(const std::vector<char>& data) : _data(data) {}
+
+    template <typename T>
+    T read() {
+        if (_pos + sizeof(T) > _data.size()) {
+            THROW_IE_EXCEPTION << "[VPU] Reference executor : stage parameters are truncated";
+        }
+
+        T val;
+        std::memcpy(&val, &_data[_pos], sizeof(T));
+        _pos += sizeof(T);
+        return val;
+    }
+
+private:
+    const std::vector<char>& _data;
+    size_t _pos = 0;
+};
+
+//
+// Tensor
+//
+
+uint32_t BlobReferenceExecutor::Tensor::elemSize() const {
+    switch (dataType) {
+    case t_fp16:
+        return 2;
+    case t_u8f:
+        return 1;
+    default:
+        return 4;
+    }
+}
+
+float BlobReferenceExecutor::Tensor::get(uint32_t x, uint32_t y, uint32_t z) const {
+    auto p = ptr + x * strides[0] + y * strides[1] + z * strides[2];
+
+    switch (dataType) {
+    case t_fp16:
+        return readF16(p);
+    case t_u8f:
+        return static_cast<float>(*p);
+    case t_int: {
+        int32_t val;
+        std::memcpy(&val, p, sizeof(val));
+        return static_cast<float>(val);
+    }
+    default: {
+        float val;
+        std::memcpy(&val, p, sizeof(val));
+        return val;
+    }
+    }
+}
+
+void BlobReferenceExecutor::Tensor::set(uint32_t x, uint32_t y, uint32_t z, float val) const {
+    auto p = ptr + x * strides[0] + y * strides[1] + z * strides[2];
+
+    switch (dataType) {
+    case t_fp16:
+        writeF16(p, val);
+        break;
+    case t_u8f:
+        *p = static_cast<uint8_t>(std::min(std::max(std::round(val), 0.0f), 255.0f));
+        break;
+    case t_int: {
+        auto i = static_cast<int32_t>(val);
+        std::memcpy(p, &i, sizeof(i));
+        break;
+    }
+    default:
+        std::memcpy(p, &val, sizeof(val));
+        break;
+    }
+}
+
+float BlobReferenceExecutor::Tensor::getLinear(uint32_t ind) const {
+    return get(ind % dims[0], (ind / dims[0]) % dims[1], ind / (dims[0] * dims[1]));
+}
+
+void BlobReferenceExecutor::Tensor::setLinear(uint32_t ind, float val) const {
+    set(ind % dims[0], (ind / dims[0]) % dims[1], ind / (dims[0] * dims[1]), val);
+}
+
+//
+// Blob parsing
+//
+
+BlobReferenceExecutor::BlobReferenceExecutor(const std::vector<char>& blob) {
+    initHandlers();
+    parseBlob(blob);
+}
+
+void BlobReferenceExecutor::initHandlers() {
+    _handlers[kNone0] = &BlobReferenceExecutor::runNone;
+
+    _handlers[kCopy] = &BlobReferenceExecutor::runCopy;
+    _handlers[kReshape] = &BlobReferenceExecutor::runCopy;
+    _handlers[kToPlaneMajor] = &BlobReferenceExecutor::runCopy;
+    _handlers[kConvertOrder] = &BlobReferenceExecutor::runCopy;
+    _handlers[kHwFcRelayout] = &BlobReferenceExecutor::runCopy;
+    _handlers[kCopyMakeBorderCHW] = &BlobReferenceExecutor::runCopyMakeBorder;
+
+    _handlers[kConvert_u8f16] = &BlobReferenceExecutor::runConvert;
+    _handlers[kConvert_f32f16] = &BlobReferenceExecutor::runConvert;
+    _handlers[kConvert_f16f32] = &BlobReferenceExecutor::runConvert;
+
+    _handlers[kConv] = &BlobReferenceExecutor::runConv;
+    _handlers[kIm2ColConvolution] = &BlobReferenceExecutor::runConv;
+    _handlers[kDepthConv] = &BlobReferenceExecutor::runConv;
+    _handlers[kDeconvolution] = &BlobReferenceExecutor::runDeconv;
+    _handlers[kFC] = &BlobReferenceExecutor::runFC;
+
+    _handlers[kMaxPool] = &BlobReferenceExecutor::runPool;
+    _handlers[kAvgPool] = &BlobReferenceExecutor::runPool;
+
+    _handlers[kRelu] = &BlobReferenceExecutor::runRelu;
+    _handlers[kLeakyRelu] = &BlobReferenceExecutor::runRelu;
+    _handlers[kBiasRelu] = &BlobReferenceExecutor::runRelu;
+    _handlers[kBiasLeakyRelu] = &BlobReferenceExecutor::runRelu;
+    _handlers[kCHWBiasRelu] = &BlobReferenceExecutor::runRelu;
+    _handlers[kCHWBiasLeakyRelu] = &BlobReferenceExecutor::runRelu;
+    _handlers[kPRelu] = &BlobReferenceExecutor::runPRelu;
+    _handlers[kElu] = &BlobReferenceExecutor::runElu;
+    _handlers[kSigmoid] = &BlobReferenceExecutor::runActivation;
+    _handlers[kTanh] = &BlobReferenceExecutor::runActivation;
+
+    _handlers[kBias] = &BlobReferenceExecutor::runEltwise;
+    _handlers[kCHWBias] = &BlobReferenceExecutor::runEltwise;
+    _handlers[kSum] = &BlobReferenceExecutor::runEltwise;
+    _handlers[kProd] = &BlobReferenceExecutor::runEltwise;
+    _handlers[kMax] = &BlobReferenceExecutor::runEltwise;
+
+    _handlers[kScale] = &BlobReferenceExecutor::runScale;
+    _handlers[kCHWScale] = &BlobReferenceExecutor::runScale;
+    _handlers[kScaleShift] = &BlobReferenceExecutor::runScale;
+    _handlers[kCHWScaleShift] = &BlobReferenceExecutor::runScale;
+    _handlers[kPower] = &BlobReferenceExecutor::runPower;
+    _handlers[kCHWPower] = &BlobReferenceExecutor::runPower;
+
+    _handlers[kSoftMax] = &BlobReferenceExecutor::runSoftMax;
+    _handlers[kLRN] = &BlobReferenceExecutor::runLRN;
+    _handlers[kCrop] = &BlobReferenceExecutor::runCrop;
+    _handlers[kTile] = &BlobReferenceExecutor::runTile;
+    _handlers[kPermute] = &BlobReferenceExecutor::runPermute;
+    _handlers[kNormalize] = &BlobReferenceExecutor::runNormalize;
+    _handlers[kRegionYolo] = &BlobReferenceExecutor::runRegionYolo;
+    _handlers[kReorgYolo] = &BlobReferenceExecutor::runReorgYolo;
+    _handlers[kDetectionOutput] = &BlobReferenceExecutor::runDetectionOutput;
+    _handlers[kCTCDecoder] = &BlobReferenceExecutor::runCTCDecoder;
+
+    _handlers[kMyriadXHwConvolution] = &BlobReferenceExecutor::runHwConvolution;
+    _handlers[kMyriadXHwPooling] = &BlobReferenceExecutor::runHwPooling;
+    _handlers[kMyriadXHwFCL] = &BlobReferenceExecutor::runHwFullyConnected;
+}
+
+void BlobReferenceExecutor::parseBlob(const std::vector<char>& blob) {
+    if (blob.size() < sizeof(ElfN_Ehdr) + sizeof(mv_blob_header)) {
+        THROW_IE_EXCEPTION << "[VPU] Reference executor : blob is too small";
+    }
+
+    mv_blob_header blobHdr;
+    std::memcpy(&blobHdr, &blob[sizeof(ElfN_Ehdr)], sizeof(blobHdr));
+
+    if (blobHdr.magic_number != BLOB_MAGIC_NUMBER) {
+        THROW_IE_EXCEPTION << "[VPU] Reference executor : wrong blob magic number " << blobHdr.magic_number;
+    }
+    // blobs with compressed weights are expanded by vpu_compress_weights, like a firmware decoder would
+    if (blobHdr.blob_ver_major != BLOB_VERSION_MAJOR || blobHdr.blob_ver_minor != BLOB_VERSION_MINOR) {
+        THROW_IE_EXCEPTION << "[VPU] Reference executor : unsupported blob version "
+                           << blobHdr.blob_ver_major << "." << blobHdr.blob_ver_minor;
+    }
+
+    if (blobHdr.file_size > blob.size()) {
+        THROW_IE_EXCEPTION << "[VPU] Reference executor : blob is truncated";
+    }
+
+    _numShaves = std::max(blobHdr.num_shaves, 1u);
+
+    // Buffer section
+
+    auto dataBegin = blobHdr.buffer_section_offset + sizeof(mv_buffer_section_header);
+    auto dataEnd = blobHdr.relocation_section_offset;
+    _blobData.assign(blob.begin() + dataBegin, blob.begin() + dataEnd);
+
+    // Relocation section
+
+    mv_relocation_section_header relocHdr;
+    std::memcpy(&relocHdr, &blob[blobHdr.relocation_section_offset], sizeof(relocHdr));
+
+    _blobRelocs.resize(relocHdr.blob_buffer_reloc_size / sizeof(mv_reloc_info));
+    std::memcpy(_blobRelocs.data(), &blob[relocHdr.blob_buffer_reloc_offset], _blobRelocs.size() * sizeof(mv_reloc_info));
+
+    _workRelocs.resize(relocHdr.work_buffer_reloc_size / sizeof(mv_reloc_info));
+    std::memcpy(_workRelocs.data(), &blob[relocHdr.work_buffer_reloc_offset], _workRelocs.size() * sizeof(mv_reloc_info));
+
+    _bss.resize(blobHdr.bss_mem_size);
+    _cmx.resize(REFERENCE_CMX_SIZE);
+
+    // Stage section
+
+    auto stageSecOffset = blobHdr.stage_section_offset;
+
+    mv_stage_section_header stageSecHdr;
+    std::memcpy(&stageSecHdr, &blob[stageSecOffset], sizeof(stageSecHdr));
+
+    _inputSize = stageSecHdr.input_size;
+    _outputSize = stageSecHdr.output_size;
+    _input.resize(_inputSize);
+    _output.resize(_outputSize);
+
+    _stages.resize(stageSecHdr.stage_count);
+
+    uint32_t curOffset = sizeof(stageSecHdr);
+    for (uint32_t i = 0; i < stageSecHdr.stage_count; ++i) {
+        if (curOffset + sizeof(mv_stage_header) > stageSecHdr.stage_section_size) {
+            THROW_IE_EXCEPTION << "[VPU] Reference executor : stage " << i << " is out of the stage section";
+        }
+
+        mv_stage_header stageHdr;
+        std::memcpy(&stageHdr, &blob[stageSecOffset + curOffset], sizeof(stageHdr));
+
+        auto nextOffset = stageHdr.next_stage != 0 ? stageHdr.next_stage : stageSecHdr.stage_section_size;
+        auto paramsBegin = curOffset + sizeof(mv_stage_header);
+        if (nextOffset <= paramsBegin || nextOffset > stageSecHdr.stage_section_size) {
+            THROW_IE_EXCEPTION << "[VPU] Reference executor : stage " << i << " has wrong size";
+        }
+
+        if (stageHdr.stage_type >= OP_TYPE_COUNT_) {
+            THROW_IE_EXCEPTION << "[VPU] Reference executor : stage " << i << " has unknown type " << stageHdr.stage_type;
+        }
+
+        auto& stage = _stages[i];
+        stage.type = static_cast<t_MvTensorOpType>(stageHdr.stage_type);
+        stage.params.assign(blob.begin() + stageSecOffset + paramsBegin, blob.begin() + stageSecOffset + nextOffset);
+
+        curOffset = nextOffset;
+    }
+}
+
+BlobReferenceExecutor::Tensor BlobReferenceExecutor::readTensor(StageReader& reader) {
+    Tensor tensor;
+
+    for (auto& dim : tensor.dims) {
+        dim = reader.read<uint32_t>();
+    }
+    for (auto& stride : tensor.strides) {
+        stride = reader.read<uint32_t>();
+    }
+
+    auto reloc = reader.read<uint32_t>();
+    tensor.index = reader.read<uint32_t>();
+    tensor.dataType = reader.read<uint32_t>();
+    tensor.order = reader.read<uint32_t>();
+
+    if (tensor.index == IndexNone || tensor.total() == 0) {
+        tensor.ptr = nullptr;
+        return tensor;
+    }
+
+    uint32_t extent = tensor.elemSize();
+    for (int i = 0; i < 3; ++i) {
+        extent += (tensor.dims[i] - 1) * tensor.strides[i];
+    }
+
+    tensor.ptr = resolve(tensor.index, reloc, extent);
+
+    _stageBytes += static_cast<uint64_t>(tensor.total()) * tensor.elemSize();
+
+    return tensor;
+}
+
+uint8_t* BlobReferenceExecutor::resolve(uint32_t index, uint32_t reloc, uint32_t size) {
+    std::vector<uint8_t>* area = nullptr;
+    uint32_t offset = reloc;
+
+    switch (index) {
+    case IndexInput:
+        area = &_input;
+        break;
+    case IndexOutput:
+        area = &_output;
+        break;
+    case IndexBlob:
+        if (reloc >= _blobRelocs.size()) {
+            THROW_IE_EXCEPTION << "[VPU] Reference executor : wrong blob relocation index " << reloc;
+        }
+        area = &_blobData;
+        offset = _blobRelocs[reloc].offset;
+        break;
+    case IndexBSS:
+    case IndexCMX: {
+        if (reloc >= _workRelocs.size()) {
+            THROW_IE_EXCEPTION << "[VPU] Reference executor : wrong work relocation index " << reloc;
+        }
+        const auto& info = _workRelocs[reloc];
+        area = info.location == IndexCMX ? &_cmx : &_bss;
+        offset = info.offset;
+        break;
+    }
+    default:
+        THROW_IE_EXCEPTION << "[VPU] Reference executor : unknown data index " << index;
+    }
+
+    if (static_cast<uint64_t>(offset) + size > area->size()) {
+        THROW_IE_EXCEPTION << "[VPU] Reference executor : data [" << offset << ", " << offset + size
+                           << ") is out of " << mvDataIndexToStr(static_cast<IndexCodes>(index))
+                           << " area of " << area->size() << " bytes";
+    }
+
+    return area->data() + offset;
+}
+
+//
+// Execution
+//
+
+void BlobReferenceExecutor::infer(const void* input, void* output) {
+    std::memcpy(_input.data(), input, _inputSize);
+    std::fill(_output.begin(), _output.end(), 0);
+    std::fill(_bss.begin(), _bss.end(), 0);
+    std::fill(_cmx.begin(), _cmx.end(), 0);
+
+    _stagesInfo.clear();
+    _stagesInfo.reserve(_stages.size());
+
+    for (const auto& stage : _stages) {
+        auto handler = _handlers[stage.type];
+        if (handler == nullptr) {
+            THROW_IE_EXCEPTION << "[VPU] Reference executor : unsupported stage type " << mvTensorOpTypeToStr(stage.type);
+        }
+
+        ReferenceStageInfo info;
+        info.type = stage.type;
+
+        StageReader reader(stage.params);
+        _stageBytes = 0;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        (this->*handler)(reader, info);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        info.numBytes = _stageBytes;
+        info.hostTimeMs = std::chrono::duration<double, std::milli>(end - start).count();
+        info.estimatedCycles = estimateCycles(info);
+
+        _stagesInfo.push_back(info);
+    }
+
+    std::memcpy(output, _output.data(), _outputSize);
+}
+
+uint64_t BlobReferenceExecutor::estimateCycles(const ReferenceStageInfo& info) const {
+    if (info.type == kNone0) {
+        return 0;
+    }
+
+    uint64_t computeCycles = 0;
+    uint64_t overhead = 0;
+    if (isHwStageType(info.type)) {
+        computeCycles = info.numOps / HW_MACS_PER_CYCLE;
+        overhead = HW_STAGE_OVERHEAD;
+    } else {
+        computeCycles = info.numOps / (SHAVE_OPS_PER_CYCLE * _numShaves);
+        overhead = SW_STAGE_OVERHEAD;
+    }
+
+    auto memoryCycles = info.numBytes / DDR_BYTES_PER_CYCLE;
+
+    return overhead + std::max(computeCycles, memoryCycles);
+}
+
+uint64_t BlobReferenceExecutor::estimatedCycles() const {
+    uint64_t total = 0;
+    for (const auto& info : _stagesInfo) {
+        total += info.estimatedCycles;
+    }
+    return total;
+}
+
+double BlobReferenceExecutor::estimatedTimeMs(double frequencyMHz) const {
+    return static_cast<double>(estimatedCycles()) / (frequencyMHz * 1000.0);
+}
+
+//
+// SW stages
+//
+
+void BlobReferenceExecutor::runNone(StageReader& /*reader*/, ReferenceStageInfo& /*info*/) {
+}
+
+void BlobReferenceExecutor::runCopy(StageReader& reader, ReferenceStageInfo& info) {
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+
+    if (input.total() != output.total()) {
+        THROW_IE_EXCEPTION << "[VPU] Reference executor : " << mvTensorOpTypeToStr(info.type)
+                           << " input and output sizes mismatch";
+    }
+
+    bool sameDims = std::equal(std::begin(input.dims), std::end(input.dims), std::begin(output.dims));
+
+    if (sameDims) {
+        for (uint32_t z = 0; z < output.dims[2]; ++z) {
+            for (uint32_t y = 0; y < output.dims[1]; ++y) {
+                for (uint32_t x = 0; x < output.dims[0]; ++x) {
+                    output.set(x, y, z, input.get(x, y, z));
+                }
+            }
+        }
+    } else {
+        for (uint32_t i = 0; i < output.total(); ++i) {
+            output.setLinear(i, input.getLinear(i));
+        }
+    }
+
+    info.numOps = output.total();
+}
+
+void BlobReferenceExecutor::runCopyMakeBorder(StageReader& reader, ReferenceStageInfo& info) {
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+
+    auto offX = static_cast<int32_t>(output.dims[0] - input.dims[0]) / 2;
+    auto offY = static_cast<int32_t>(output.dims[1] - input.dims[1]) / 2;
+
+    for (uint32_t z = 0; z < output.dims[2]; ++z) {
+        for (uint32_t y = 0; y < output.dims[1]; ++y) {
+            for (uint32_t x = 0; x < output.dims[0]; ++x) {
+                auto ix = static_cast<int32_t>(x) - offX;
+                auto iy = static_cast<int32_t>(y) - offY;
+
+                float val = 0.0f;
+                if (inRange(ix, input.dims[0]) && inRange(iy, input.dims[1])) {
+                    val = input.get(ix, iy, z);
+                }
+
+                output.set(x, y, z, val);
+            }
+        }
+    }
+
+    info.numOps = output.total();
+}
+
+void BlobReferenceExecutor::runConvert(StageReader& reader, ReferenceStageInfo& info) {
+    auto scale = reader.read<float>();
+    auto bias = reader.read<float>();
+
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+
+    for (uint32_t z = 0; z < output.dims[2]; ++z) {
+        for (uint32_t y = 0; y < output.dims[1]; ++y) {
+            for (uint32_t x = 0; x < output.dims[0]; ++x) {
+                output.set(x, y, z, input.get(x, y, z) * scale + bias);
+            }
+        }
+    }
+
+    info.numOps = output.total();
+}
+
+void BlobReferenceExecutor::runConv(StageReader& reader, ReferenceStageInfo& info) {
+    auto radixX = reader.read<uint32_t>();
+    auto radixY = reader.read<uint32_t>();
+    auto strideX = reader.read<uint32_t>();
+    auto strideY = reader.read<uint32_t>();
+    auto padX = reader.read<uint32_t>();
+    auto padY = reader.read<uint32_t>();
+    auto paddStyle = reader.read<uint32_t>();
+    auto dilation = reader.read<uint32_t>();
+
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+    auto weights = readTensor(reader);
+    if (info.type == kIm2ColConvolution) {
+        readTensor(reader);  // buffer
+    }
+    readTensor(reader);  // biases
+
+    auto IC = input.dims[2];
+    auto OC = output.dims[2];
+    auto K = radixX * radixY;
+
+    auto isDepth = info.type == kDepthConv;
+    auto isIm2Col = info.type == kIm2ColConvolution;
+    // 3x3 kernels use HWCK weights layout, see DefaultWeightsWriter
+    auto isHWCK = info.type == kConv && radixX == 3 && radixY == 3 && weights.dims[1] > 3;
+
+    auto pX = calcPad(paddStyle, padX, input.dims[0], output.dims[0], radixX, strideX, dilation);
+    auto pY = calcPad(paddStyle, padY, input.dims[1], output.dims[1], radixY, strideY, dilation);
+
+    for (uint32_t oc = 0; oc < OC; ++oc) {
+        auto icBegin = isDepth ? oc : 0;
+        auto icEnd = isDepth ? oc + 1 : IC;
+
+        for (uint32_t oy = 0; oy < output.dims[1]; ++oy) {
+            for (uint32_t ox = 0; ox < output.dims[0]; ++ox) {
+                float sum = 0.0f;
+
+                for (uint32_t ic = icBegin; ic < icEnd; ++ic) {
+                    for (uint32_t ky = 0; ky < radixY; ++ky) {
+                        auto iy = static_cast<int32_t>(oy * strideY + ky * dilation) - pY;
+                        if (!inRange(iy, input.dims[1]))
+                            continue;
+
+                        for (uint32_t kx = 0; kx < radixX; ++kx) {
+                            auto ix = static_cast<int32_t>(ox * strideX + kx * dilation) - pX;
+                            if (!inRange(ix, input.dims[0]))
+                                continue;
+
+                            auto k = ky * radixX + kx;
+
+                            uint32_t wInd = 0;
+                            if (isDepth) {
+                                wInd = oc * K + k;
+                            } else if (isIm2Col) {
+                                wInd = (oc * K + k) * IC + ic;
+                            } else if (isHWCK) {
+                                wInd = (k * OC + oc) * IC + ic;
+                            } else {
+                                wInd = (oc * IC + ic) * K + k;
+                            }
+
+                            sum += input.get(ix, iy, ic) * readF16(weights.ptr + wInd * sizeof(ie_fp16));
+                        }
+                    }
+                }
+
+                output.set(ox, oy, oc, sum);
+            }
+        }
+    }
+
+    info.numOps = static_cast<uint64_t>(output.total()) * (isDepth ? 1 : IC) * K;
+}
+
+void BlobReferenceExecutor::runDeconv(StageReader& reader, ReferenceStageInfo& info) {
+    auto radixX = reader.read<uint32_t>();
+    auto radixY = reader.read<uint32_t>();
+    auto strideX = reader.read<uint32_t>();
+    auto strideY = reader.read<uint32_t>();
+    auto padX = reader.read<uint32_t>();
+    auto padY = reader.read<uint32_t>();
+    reader.read<uint32_t>();  // paddStyle
+    reader.read<uint32_t>();  // dilation
+
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+    auto weights = readTensor(reader);
+    readTensor(reader);  // biases
+
+    auto IC = input.dims[2];
+    auto OC = output.dims[2];
+    auto OW = output.dims[0];
+    auto OH = output.dims[1];
+
+    // Weights are stored with flipped kernel in [k][oc][ic] layout
+    std::vector<float> acc(static_cast<size_t>(OC) * OH * OW, 0.0f);
+
+    for (uint32_t ic = 0; ic < IC; ++ic) {
+        for (uint32_t iy = 0; iy < input.dims[1]; ++iy) {
+            for (uint32_t ix = 0; ix < input.dims[0]; ++ix) {
+                auto val = input.get(ix, iy, ic);
+
+                for (uint32_t ky = 0; ky < radixY; ++ky) {
+                    auto oy = static_cast<int32_t>(iy * strideY + ky) - static_cast<int32_t>(padY);
+                    if (!inRange(oy, OH))
+                        continue;
+
+                    for (uint32_t kx = 0; kx < radixX; ++kx) {
+                        auto ox = static_cast<int32_t>(ix * strideX + kx) - static_cast<int32_t>(padX);
+                        if (!inRange(ox, OW))
+                            continue;
+
+                        auto k = (radixY - 1 - ky) * radixX + (radixX - 1 - kx);
+
+                        for (uint32_t oc = 0; oc < OC; ++oc) {
+                            auto w = readF16(weights.ptr + ((k * OC + oc) * IC + ic) * sizeof(ie_fp16));
+                            acc[(oc * OH + oy) * OW + ox] += val * w;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    for (uint32_t oc = 0; oc < OC; ++oc) {
+        for (uint32_t oy = 0; oy < OH; ++oy) {
+            for (uint32_t ox = 0; ox < OW; ++ox) {
+                output.set(ox, oy, oc, acc[(oc * OH + oy) * OW + ox]);
+            }
+        }
+    }
+
+    info.numOps = static_cast<uint64_t>(input.total()) * OC * radixX * radixY;
+}
+
+void BlobReferenceExecutor::runFC(StageReader& reader, ReferenceStageInfo& info) {
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+    auto weights = readTensor(reader);
+    readTensor(reader);  // biases
+
+    auto N = input.total();
+    auto OC = output.total();
+
+    // Weights are stored as HWCK (see DefaultWeightsWriter), so the input is walked in the same order
+    std::vector<float> in(N);
+    for (uint32_t y = 0, i = 0; y < input.dims[1]; ++y) {
+        for (uint32_t x = 0; x < input.dims[0]; ++x) {
+            for (uint32_t c = 0; c < input.dims[2]; ++c, ++i) {
+                in[i] = input.get(x, y, c);
+            }
+        }
+    }
+
+    for (uint32_t o = 0; o < OC; ++o) {
+        float sum = 0.0f;
+        for (uint32_t i = 0; i < N; ++i) {
+            sum += in[i] * readF16(weights.ptr + (static_cast<size_t>(i) * OC + o) * sizeof(ie_fp16));
+        }
+        output.setLinear(o, sum);
+    }
+
+    info.numOps = static_cast<uint64_t>(output.total()) * N;
+}
+
+void BlobReferenceExecutor::runPool(StageReader& reader, ReferenceStageInfo& info) {
+    auto radixX = reader.read<uint32_t>();
+    auto radixY = reader.read<uint32_t>();
+    auto strideX = reader.read<uint32_t>();
+    auto strideY = reader.read<uint32_t>();
+    auto padX = reader.read<uint32_t>();
+    auto padY = reader.read<uint32_t>();
+    auto paddStyle = reader.read<uint32_t>();
+
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+
+    auto IW = static_cast<int32_t>(input.dims[0]);
+    auto IH = static_cast<int32_t>(input.dims[1]);
+
+    auto pX = calcPad(paddStyle, padX, IW, output.dims[0], radixX, strideX, 1);
+    auto pY = calcPad(paddStyle, padY, IH, output.dims[1], radixY, strideY, 1);
+
+    auto isMax = info.type == kMaxPool;
+
+    for (uint32_t z = 0; z < output.dims[2]; ++z) {
+        for (uint32_t oy = 0; oy < output.dims[1]; ++oy) {
+            for (uint32_t ox = 0; ox < output.dims[0]; ++ox) {
+                auto yStart = static_cast<int32_t>(oy * strideY) - pY;
+                auto xStart = static_cast<int32_t>(ox * strideX) - pX;
+                auto yEnd = std::min(yStart + static_cast<int32_t>(radixY), IH + pY);
+                auto xEnd = std::min(xStart + static_cast<int32_t>(radixX), IW + pX);
+
+                // Caffe divides by the window size including padding
+                auto poolSize = (yEnd - yStart) * (xEnd - xStart);
+
+                yStart = std::max(yStart, 0);
+                xStart = std::max(xStart, 0);
+                yEnd = std::min(yEnd, IH);
+                xEnd = std::min(xEnd, IW);
+
+                float res = isMax ? -std::numeric_limits<float>::max() : 0.0f;
+                for (auto y = yStart; y < yEnd; ++y) {
+                    for (auto x = xStart; x < xEnd; ++x) {
+                        auto val = input.get(x, y, z);
+                        res = isMax ? std::max(res, val) : res + val;
+                    }
+                }
+
+                if (!isMax) {
+                    auto count = paddStyle == paddStyleCaffe ? poolSize : (yEnd - yStart) * (xEnd - xStart);
+                    res = count > 0 ? res / count : 0.0f;
+                }
+
+                output.set(ox, oy, z, res);
+            }
+        }
+    }
+
+    info.numOps = static_cast<uint64_t>(output.total()) * radixX * radixY;
+}
+
+void BlobReferenceExecutor::runRelu(StageReader& reader, ReferenceStageInfo& info) {
+    auto hasBias = reader.read<uint32_t>();
+    auto negativeSlope = reader.read<float>();
+
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+    Tensor bias;
+    if (hasBias) {
+        bias = readTensor(reader);
+    }
+
+    for (uint32_t z = 0; z < output.dims[2]; ++z) {
+        auto b = hasBias ? bias.getLinear(z) : 0.0f;
+
+        for (uint32_t y = 0; y < output.dims[1]; ++y) {
+            for (uint32_t x = 0; x < output.dims[0]; ++x) {
+                auto val = input.get(x, y, z) + b;
+                output.set(x, y, z, val >= 0.0f ? val : val * negativeSlope);
+            }
+        }
+    }
+
+    info.numOps = output.total();
+}
+
+void BlobReferenceExecutor::runPRelu(StageReader& reader, ReferenceStageInfo& info) {
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+    auto weights = readTensor(reader);
+
+    for (uint32_t z = 0; z < output.dims[2]; ++z) {
+        auto slope = weights.getLinear(z);
+
+        for (uint32_t y = 0; y < output.dims[1]; ++y) {
+            for (uint32_t x = 0; x < output.dims[0]; ++x) {
+                auto val = input.get(x, y, z);
+                output.set(x, y, z, val >= 0.0f ? val : val * slope);
+            }
+        }
+    }
+
+    info.numOps = output.total();
+}
+
+void BlobReferenceExecutor::runElu(StageReader& reader, ReferenceStageInfo& info) {
+    auto alpha = reader.read<float>();
+
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+
+    for (uint32_t z = 0; z < output.dims[2]; ++z) {
+        for (uint32_t y = 0; y < output.dims[1]; ++y) {
+            for (uint32_t x = 0; x < output.dims[0]; ++x) {
+                auto val = input.get(x, y, z);
+                output.set(x, y, z, val > 0.0f ? val : alpha * (std::exp(val) - 1.0f));
+            }
+        }
+    }
+
+    info.numOps = output.total();
+}
+
+void BlobReferenceExecutor::runActivation(StageReader& reader, ReferenceStageInfo& info) {
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+
+    for (uint32_t z = 0; z < output.dims[2]; ++z) {
+        for (uint32_t y = 0; y < output.dims[1]; ++y) {
+            for (uint32_t x = 0; x < output.dims[0]; ++x) {
+                auto val = input.get(x, y, z);
+                output.set(x, y, z, info.type == kSigmoid ? sigmoid(val) : std::tanh(val));
+            }
+        }
+    }
+
+    info.numOps = output.total();
+}
+
+void BlobReferenceExecutor::runEltwise(StageReader& reader, ReferenceStageInfo& info) {
+    auto input0 = readTensor(reader);
+    auto output = readTensor(reader);
+    auto input1 = readTensor(reader);
+
+    // Bias is broadcasted per channel
+    auto perChannel = input1.total() != output.total();
+
+    for (uint32_t z = 0; z < output.dims[2]; ++z) {
+        for (uint32_t y = 0; y < output.dims[1]; ++y) {
+            for (uint32_t x = 0; x < output.dims[0]; ++x) {
+                auto a = input0.get(x, y, z);
+                auto b = perChannel ? input1.getLinear(z) : input1.get(x, y, z);
+
+                float res = 0.0f;
+                if (info.type == kProd) {
+                    res = a * b;
+                } else if (info.type == kMax) {
+                    res = std::max(a, b);
+                } else {
+                    res = a + b;
+                }
+
+                output.set(x, y, z, res);
+            }
+        }
+    }
+
+    info.numOps = output.total();
+}
+
+void BlobReferenceExecutor::runScale(StageReader& reader, ReferenceStageInfo& info) {
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+    auto scales = readTensor(reader);
+
+    Tensor shifts;
+    if (info.type == kScaleShift || info.type == kCHWScaleShift) {
+        shifts = readTensor(reader);
+    }
+
+    for (uint32_t z = 0; z < output.dims[2]; ++z) {
+        auto s = scales.getLinear(z);
+        auto b = shifts.empty() ? 0.0f : shifts.getLinear(z);
+
+        for (uint32_t y = 0; y < output.dims[1]; ++y) {
+            for (uint32_t x = 0; x < output.dims[0]; ++x) {
+                output.set(x, y, z, input.get(x, y, z) * s + b);
+            }
+        }
+    }
+
+    info.numOps = output.total();
+}
+
+void BlobReferenceExecutor::runPower(StageReader& reader, ReferenceStageInfo& info) {
+    auto offset = reader.read<float>();
+    auto scale = reader.read<float>();
+    auto power = reader.read<float>();
+
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+
+    for (uint32_t z = 0; z < output.dims[2]; ++z) {
+        for (uint32_t y = 0; y < output.dims[1]; ++y) {
+            for (uint32_t x = 0; x < output.dims[0]; ++x) {
+                auto val = offset + scale * input.get(x, y, z);
+                output.set(x, y, z, power == 1.0f ? val : std::pow(val, power));
+            }
+        }
+    }
+
+    info.numOps = output.total();
+}
+
+void BlobReferenceExecutor::runSoftMax(StageReader& reader, ReferenceStageInfo& info) {
+    auto axis = reader.read<char>();
+    reader.read<char>();
+    reader.read<char>();
+    reader.read<char>();
+
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+
+    int axisInd = axis == 'w' ? 0 : axis == 'h' ? 1 : 2;
+    int inner0 = axisInd == 0 ? 1 : 0;
+    int inner1 = axisInd == 2 ? 1 : 2;
+
+    uint32_t coord[3] = {};
+    std::vector<float> vals(output.dims[axisInd]);
+
+    for (coord[inner1] = 0; coord[inner1] < output.dims[inner1]; ++coord[inner1]) {
+        for (coord[inner0] = 0; coord[inner0] < output.dims[inner0]; ++coord[inner0]) {
+            float maxVal = -std::numeric_limits<float>::max();
+            for (coord[axisInd] = 0; coord[axisInd] < output.dims[axisInd]; ++coord[axisInd]) {
+                vals[coord[axisInd]] = input.get(coord[0], coord[1], coord[2]);
+                maxVal = std::max(maxVal, vals[coord[axisInd]]);
+            }
+
+            float sum = 0.0f;
+            for (auto& val : vals) {
+                val = std::exp(val - maxVal);
+                sum += val;
+            }
+
+            for (coord[axisInd] = 0; coord[axisInd] < output.dims[axisInd]; ++coord[axisInd]) {
+                output.set(coord[0], coord[1], coord[2], vals[coord[axisInd]] / sum);
+            }
+        }
+    }
+
+    info.numOps = static_cast<uint64_t>(output.total()) * 3;
+}
+
+void BlobReferenceExecutor::runLRN(StageReader& reader, ReferenceStageInfo& info) {
+    auto size = static_cast<int32_t>(reader.read<uint32_t>());
+    auto k = PrecisionUtils::f16tof32(reader.read<ie_fp16>());
+    auto alpha = PrecisionUtils::f16tof32(reader.read<ie_fp16>());
+    auto beta = PrecisionUtils::f16tof32(reader.read<ie_fp16>());
+    reader.read<ie_fp16>();
+
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+
+    auto C = static_cast<int32_t>(output.dims[2]);
+    auto prePad = (size - 1) / 2;
+
+    for (uint32_t y = 0; y < output.dims[1]; ++y) {
+        for (uint32_t x = 0; x < output.dims[0]; ++x) {
+            for (int32_t c = 0; c < C; ++c) {
+                auto cStart = std::max(c - prePad, 0);
+                auto cEnd = std::min(c - prePad + size, C);
+
+                float sum = 0.0f;
+                for (auto i = cStart; i < cEnd; ++i) {
+                    auto val = input.get(x, y, i);
+                    sum += val * val;
+                }
+
+                auto scale = k + alpha / size * sum;
+                output.set(x, y, c, input.get(x, y, c) * std::pow(scale, -beta));
+            }
+        }
+    }
+
+    info.numOps = static_cast<uint64_t>(output.total()) * size;
+}
+
+void BlobReferenceExecutor::runCrop(StageReader& reader, ReferenceStageInfo& info) {
+    int32_t offset[3];
+    for (auto& off : offset) {
+        off = reader.read<int32_t>();
+    }
+
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+
+    for (uint32_t z = 0; z < output.dims[2]; ++z) {
+        for (uint32_t y = 0; y < output.dims[1]; ++y) {
+            for (uint32_t x = 0; x < output.dims[0]; ++x) {
+                output.set(x, y, z, input.get(x + offset[0], y + offset[1], z + offset[2]));
+            }
+        }
+    }
+
+    info.numOps = output.total();
+}
+
+void BlobReferenceExecutor::runTile(StageReader& reader, ReferenceStageInfo& info) {
+    reader.read<int32_t>();  // axis
+    reader.read<int32_t>();  // tiles
+
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+
+    for (uint32_t z = 0; z < output.dims[2]; ++z) {
+        for (uint32_t y = 0; y < output.dims[1]; ++y) {
+            for (uint32_t x = 0; x < output.dims[0]; ++x) {
+                output.set(x, y, z, input.get(x % input.dims[0], y % input.dims[1], z % input.dims[2]));
+            }
+        }
+    }
+
+    info.numOps = output.total();
+}
+
+void BlobReferenceExecutor::runPermute(StageReader& reader, ReferenceStageInfo& info) {
+    int32_t order[3];
+    for (auto& ord : order) {
+        ord = reader.read<int32_t>();
+        if (ord < 0 || ord > 2) {
+            THROW_IE_EXCEPTION << "[VPU] Reference executor : wrong Permute order " << ord;
+        }
+    }
+
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+
+    // Orders are given for CHW dimensions, blob dimensions are XYZ (WHC)
+    uint32_t outCoord[3] = {};
+    uint32_t inCoord[3] = {};
+    for (outCoord[2] = 0; outCoord[2] < output.dims[2]; ++outCoord[2]) {
+        for (outCoord[1] = 0; outCoord[1] < output.dims[1]; ++outCoord[1]) {
+            for (outCoord[0] = 0; outCoord[0] < output.dims[0]; ++outCoord[0]) {
+                for (int j = 0; j < 3; ++j) {
+                    inCoord[2 - order[j]] = outCoord[2 - j];
+                }
+
+                output.set(outCoord[0], outCoord[1], outCoord[2], input.get(inCoord[0], inCoord[1], inCoord[2]));
+            }
+        }
+    }
+
+    info.numOps = output.total();
+}
+
+void BlobReferenceExecutor::runNormalize(StageReader& reader, ReferenceStageInfo& info) {
+    auto acrossSpatial = reader.read<int32_t>();
+    auto channelShared = reader.read<int32_t>();
+
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+    auto scales = readTensor(reader);
+
+    const float eps = 1e-10f;
+
+    auto W = output.dims[0];
+    auto H = output.dims[1];
+    auto C = output.dims[2];
+
+    float totalSum = 0.0f;
+    if (acrossSpatial) {
+        for (uint32_t i = 0; i < input.total(); ++i) {
+            auto val = input.getLinear(i);
+            totalSum += val * val;
+        }
+    }
+
+    for (uint32_t y = 0; y < H; ++y) {
+        for (uint32_t x = 0; x < W; ++x) {
+            auto sum = totalSum;
+            if (!acrossSpatial) {
+                for (uint32_t c = 0; c < C; ++c) {
+                    auto val = input.get(x, y, c);
+                    sum += val * val;
+                }
+            }
+
+            auto norm = 1.0f / std::sqrt(sum + eps);
+
+            for (uint32_t c = 0; c < C; ++c) {
+                auto scale = scales.getLinear(channelShared ? 0 : c);
+                output.set(x, y, c, input.get(x, y, c) * norm * scale);
+            }
+        }
+    }
+
+    info.numOps = static_cast<uint64_t>(output.total()) * 3;
+}
+
+void BlobReferenceExecutor::runRegionYolo(StageReader& reader, ReferenceStageInfo& info) {
+    auto classes = reader.read<int32_t>();
+    auto coords = reader.read<int32_t>();
+    auto num = reader.read<int32_t>();
+
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+
+    auto HW = input.dims[0] * input.dims[1];
+    auto entrySize = static_cast<uint32_t>(coords + 1 + classes);
+
+    // YOLOv3 layers keep only masked anchors and use logistic instead of softmax for classes
+    auto doSoftmax = input.dims[2] == static_cast<uint32_t>(num) * entrySize;
+    auto numAnchors = input.dims[2] / entrySize;
+
+    for (uint32_t i = 0; i < input.total(); ++i) {
+        output.setLinear(i, input.getLinear(i));
+    }
+
+    for (uint32_t n = 0; n < numAnchors; ++n) {
+        auto base = n * entrySize * HW;
+
+        for (uint32_t s = 0; s < HW; ++s) {
+            for (uint32_t c : {0u, 1u, static_cast<uint32_t>(coords)}) {
+                auto ind = base + c * HW + s;
+                output.setLinear(ind, sigmoid(input.getLinear(ind)));
+            }
+
+            auto classBase = base + (coords + 1) * HW + s;
+
+            if (doSoftmax) {
+                float maxVal = -std::numeric_limits<float>::max();
+                for (int32_t k = 0; k < classes; ++k) {
+                    maxVal = std::max(maxVal, input.getLinear(classBase + k * HW));
+                }
+
+                float sum = 0.0f;
+                for (int32_t k = 0; k < classes; ++k) {
+                    sum += std::exp(input.getLinear(classBase + k * HW) - maxVal);
+                }
+
+                for (int32_t k = 0; k < classes; ++k) {
+                    auto ind = classBase + k * HW;
+                    output.setLinear(ind, std::exp(input.getLinear(ind) - maxVal) / sum);
+                }
+            } else {
+                for (int32_t k = 0; k < classes; ++k) {
+                    auto ind = classBase + k * HW;
+                    output.setLinear(ind, sigmoid(input.getLinear(ind)));
+                }
+            }
+        }
+    }
+
+    info.numOps = static_cast<uint64_t>(output.total()) * 3;
+}
+
+void BlobReferenceExecutor::runReorgYolo(StageReader& reader, ReferenceStageInfo& info) {
+    auto stride = static_cast<uint32_t>(reader.read<int32_t>());
+
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+
+    auto IW = input.dims[0];
+    auto IH = input.dims[1];
+    auto IC = input.dims[2];
+
+    auto icOff = IC / (stride * stride);
+    auto ihOff = IH * stride;
+    auto iwOff = IW * stride;
+
+    for (uint32_t c = 0; c < IC; ++c) {
+        for (uint32_t h = 0; h < IH; ++h) {
+            for (uint32_t w = 0; w < IW; ++w) {
+                auto dstIndex = (c * IH + h) * IW + w;
+
+                auto oc = c % icOff;
+                auto offset = c / icOff;
+                auto ow = w * stride + offset % stride;
+                auto oh = h * stride + offset / stride;
+
+                auto srcIndex = (oc * ihOff + oh) * iwOff + ow;
+
+                output.setLinear(dstIndex, input.getLinear(srcIndex));
+            }
+        }
+    }
+
+    info.numOps = output.total();
+}
+
+void BlobReferenceExecutor::runDetectionOutput(StageReader& reader, ReferenceStageInfo& info) {
+    auto params = reader.read<DetectionOutputParams>();
+
+    auto locations = readTensor(reader);
+    auto confidence = readTensor(reader);
+    auto priors = readTensor(reader);
+    auto output = readTensor(reader);
+
+    if (!params.share_location) {
+        THROW_IE_EXCEPTION << "[VPU] Reference executor : DetectionOutput supports only shared locations";
+    }
+
+    auto numPriors = params.num_priors;
+    auto numClasses = params.num_classes;
+
+    std::vector<Box> boxes(numPriors);
+    for (int32_t p = 0; p < numPriors; ++p) {
+        Box prior;
+        prior.xmin = priors.getLinear(p * 4 + 0);
+        prior.ymin = priors.getLinear(p * 4 + 1);
+        prior.xmax = priors.getLinear(p * 4 + 2);
+        prior.ymax = priors.getLinear(p * 4 + 3);
+
+        float var[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+        if (!params.variance_encoded_in_target) {
+            for (int i = 0; i < 4; ++i) {
+                var[i] = priors.getLinear(numPriors * 4 + p * 4 + i);
+            }
+        }
+
+        float loc[4];
+        for (int i = 0; i < 4; ++i) {
+            loc[i] = locations.getLinear(p * 4 + i);
+        }
+
+        boxes[p] = decodeBox(prior, var, loc, params.code_type);
+    }
+
+    // (score, (label, prior))
+    std::vector<std::pair<float, std::pair<int32_t, int32_t>>> detections;
+
+    for (int32_t c = 0; c < numClasses; ++c) {
+        if (c == params.background_label_id)
+            continue;
+
+        std::vector<std::pair<float, int32_t>> candidates;
+        for (int32_t p = 0; p < numPriors; ++p) {
+            auto score = confidence.getLinear(p * numClasses + c);
+            if (score > params.confidence_threshold) {
+                candidates.emplace_back(score, p);
+            }
+        }
+
+        std::stable_sort(candidates.begin(), candidates.end(),
+                         [](const std::pair<float, int32_t>& a, const std::pair<float, int32_t>& b) {
+                             return a.first > b.first;
+                         });
+        if (params.top_k > -1 && static_cast<int32_t>(candidates.size()) > params.top_k) {
+            candidates.resize(params.top_k);
+        }
+
+        auto threshold = params.nms_threshold;
+        std::vector<int32_t> kept;
+        for (const auto& cand : candidates) {
+            bool keep = true;
+            for (auto k : kept) {
+                if (jaccardOverlap(boxes[cand.second], boxes[k]) > threshold) {
+                    keep = false;
+                    break;
+                }
+            }
+
+            if (keep) {
+                kept.push_back(cand.second);
+                detections.push_back({cand.first, {c, cand.second}});
+
+                if (params.eta < 1.0f && threshold > 0.5f) {
+                    threshold *= params.eta;
+                }
+            }
+        }
+    }
+
+    std::stable_sort(detections.begin(), detections.end(),
+                     [](const std::pair<float, std::pair<int32_t, int32_t>>& a,
+                        const std::pair<float, std::pair<int32_t, int32_t>>& b) {
+                         return a.first > b.first;
+                     });
+    if (params.keep_top_k > -1 && static_cast<int32_t>(detections.size()) > params.keep_top_k) {
+        detections.resize(params.keep_top_k);
+    }
+
+    auto maxDetections = output.total() / 7;
+    detections.resize(std::min<size_t>(detections.size(), maxDetections));
+
+    for (uint32_t i = 0; i < output.total(); ++i) {
+        output.setLinear(i, 0.0f);
+    }
+
+    for (size_t i = 0; i < detections.size(); ++i) {
+        const auto& det = detections[i];
+        const auto& box = boxes[det.second.second];
+
+        float vals[7] = {0.0f, static_cast<float>(det.second.first), det.first, box.xmin, box.ymin, box.xmax, box.ymax};
+        for (int j = 0; j < 7; ++j) {
+            output.setLinear(i * 7 + j, vals[j]);
+        }
+    }
+
+    // Image id -1 marks the end of detections list
+    if (detections.size() < maxDetections) {
+        output.setLinear(detections.size() * 7, -1.0f);
+    }
+
+    info.numOps = static_cast<uint64_t>(numPriors) * numClasses * 4;
+}
+
+void BlobReferenceExecutor::runCTCDecoder(StageReader& reader, ReferenceStageInfo& info) {
+    auto probs = readTensor(reader);
+    auto seqInd = readTensor(reader);
+    auto output = readTensor(reader);
+
+    // Probabilities are [T][C] with the last class used as blank
+    auto C = probs.dims[0];
+    auto T = probs.total() / C;
+    auto blank = C - 1;
+
+    for (uint32_t i = 0; i < output.total(); ++i) {
+        output.setLinear(i, -1.0f);
+    }
+
+    uint32_t outInd = 0;
+    uint32_t prevClass = blank;
+    for (uint32_t t = 0; t < T && outInd < output.total(); ++t) {
+        if (t > 0 && seqInd.getLinear(t) == 0.0f)
+            break;
+
+        uint32_t maxClass = 0;
+        float maxProb = probs.getLinear(t * C);
+        for (uint32_t c = 1; c < C; ++c) {
+            auto prob = probs.getLinear(t * C + c);
+            if (prob > maxProb) {
+                maxProb = prob;
+                maxClass = c;
+            }
+        }
+
+        if (maxClass != blank && maxClass != prevClass) {
+            output.setLinear(outInd++, static_cast<float>(maxClass));
+        }
+
+        prevClass = maxClass;
+    }
+
+    info.numOps = probs.total();
+}
+
+//
+// HW stages
+//
+// Descriptor addresses are offsets relative to the stage input/output/taps/biases data,
+// the same way the firmware patches them with the relocated data addresses.
+//
+
+void BlobReferenceExecutor::runHwParallelCopy(StageReader& reader, uint32_t hasParallelCopy, ReferenceStageInfo& info) {
+    if (!hasParallelCopy)
+        return;
+
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+
+    for (uint32_t z = 0; z < output.dims[2]; ++z) {
+        for (uint32_t y = 0; y < output.dims[1]; ++y) {
+            for (uint32_t x = 0; x < output.dims[0]; ++x) {
+                output.set(x, y, z, input.get(x, y, z));
+            }
+        }
+    }
+
+    info.numOps += output.total();
+}
+
+void BlobReferenceExecutor::runHwConvolution(StageReader& reader, ReferenceStageInfo& info) {
+    auto hasParallelCopy = reader.read<uint32_t>();
+    auto descriptors = readDescriptors(reader);
+
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+    auto taps = readTensor(reader);
+    auto biases = readTensor(reader);
+
+    for (const auto& desc : descriptors) {
+        const auto& cp = desc.Line1.ConvolutionPooling;
+        const auto& conv = desc.Line2.ConvolutionPooling;
+        const auto& pool = desc.Line3.ConvolutionPooling;
+
+        auto IW = static_cast<int32_t>(cp.inputWidth + 1);
+        auto IH = static_cast<int32_t>(cp.inputHeight + 1);
+        uint32_t IC = cp.inputChannels + 1;
+        uint32_t OC = cp.outputChannels + 1;
+        uint32_t KX = conv.kernelWidth + 1;
+        uint32_t KY = conv.kernelHeight + 1;
+        uint32_t stride = conv.chStride + 1;
+
+        auto withPool = desc.Line0.type == TYPE_CONVPOOL && pool.poolEn;
+        uint32_t poolKX = withPool ? pool.poolKernelWidth + 1 : 1;
+        uint32_t poolKY = withPool ? pool.poolKernelHeight + 1 : 1;
+
+        auto padX = conv.padEn ? static_cast<int32_t>(KX - 1) / 2 : 0;
+        auto padY = conv.padEn ? static_cast<int32_t>(KY - 1) / 2 : 0;
+
+        auto OW = desc.Line10.ConvolutionPooling.outputX;
+        auto OH = output.dims[1];
+
+        // The descriptor has no field for the fused pooling stride, the HW pools non-overlapping
+        // windows (stride equal to the kernel size). Overlapping windows would need more outputs
+        // than the convolution result can feed, so such descriptors can't come from the compiler.
+        if (withPool) {
+            auto convOW = (IW + 2 * padX - static_cast<int32_t>(KX)) / static_cast<int32_t>(stride) + 1;
+            if (OW == 0 || static_cast<int32_t>((OW - 1) * poolKX) >= convOW) {
+                THROW_IE_EXCEPTION << "[VPU] Reference executor : fused pooling with stride different from "
+                                   << "the kernel size " << poolKX << "x" << poolKY << " is not supported";
+            }
+        }
+
+        auto dataBase = input.ptr + desc.Line4.dataBaseAddr;
+        auto dataChStr = desc.Line5.dataChStr;
+        auto dataLnStr = desc.Line5.dataLnStr;
+
+        auto outBase = output.ptr + desc.Line8.outBaseAddr;
+        auto outChStr = desc.Line8.outChStr;
+        auto outLnStr = desc.Line7.ConvolutionPooling.outLnStr;
+
+        auto coeffBase = taps.ptr + desc.Line6.Convolution.coeffBaseAddr;
+        auto coeffChStrOut = desc.Line6.Convolution.coeffChStrOut;
+        auto coeffChStrIn = desc.Line7.ConvolutionPooling.coeffChStrIn;
+
+        auto convAt = [&](uint32_t oc, int32_t cx, int32_t cy) {
+            float sum = 0.0f;
+
+            for (uint32_t ic = 0; ic < IC; ++ic) {
+                for (uint32_t ky = 0; ky < KY; ++ky) {
+                    auto iy = cy * static_cast<int32_t>(stride) + static_cast<int32_t>(ky) - padY;
+                    if (!inRange(iy, IH))
+                        continue;
+
+                    for (uint32_t kx = 0; kx < KX; ++kx) {
+                        auto ix = cx * static_cast<int32_t>(stride) + static_cast<int32_t>(kx) - padX;
+                        if (!inRange(ix, IW))
+                            continue;
+
+                        auto in = readF16(dataBase + ic * dataChStr + iy * dataLnStr + ix * sizeof(ie_fp16));
+                        auto w = readF16(coeffBase + (oc / 8) * coeffChStrOut + ic * coeffChStrIn +
+                                         ((ky * KX + kx) * 8 + oc % 8) * sizeof(ie_fp16));
+
+                        sum += in * w;
+                    }
+                }
+            }
+
+            return sum;
+        };
+
+        for (uint32_t oc = 0; oc < OC; ++oc) {
+            auto bias = biases.empty() ? 0.0f : readF16(biases.ptr + desc.Line11.biasBaseAddr + oc * sizeof(ie_fp16));
+
+            for (uint32_t oy = 0; oy < OH; ++oy) {
+                for (uint32_t ox = 0; ox < OW; ++ox) {
+                    float res = -std::numeric_limits<float>::max();
+
+                    for (uint32_t py = 0; py < poolKY; ++py) {
+                        for (uint32_t px = 0; px < poolKX; ++px) {
+                            // Convolution result is stored in FP16 before pooling
+                            auto val = PrecisionUtils::f16tof32(PrecisionUtils::f32tof16(
+                                convAt(oc, ox * poolKX + px, oy * poolKY + py) + bias));
+                            res = std::max(res, val);
+                        }
+                    }
+
+                    if (desc.Line4.reluEn && res < 0.0f) {
+                        res = desc.Line4.a1 != 0 ? res * desc.Line4.a0 / desc.Line4.a1 : 0.0f;
+                    }
+
+                    writeF16(outBase + oc * outChStr + oy * outLnStr + ox * sizeof(ie_fp16), res);
+                }
+            }
+        }
+
+        info.numOps += static_cast<uint64_t>(OC) * OW * OH * poolKX * poolKY * IC * KX * KY;
+    }
+
+    runHwParallelCopy(reader, hasParallelCopy, info);
+}
+
+void BlobReferenceExecutor::runHwPooling(StageReader& reader, ReferenceStageInfo& info) {
+    auto hasParallelCopy = reader.read<uint32_t>();
+    auto descriptors = readDescriptors(reader);
+
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+    readTensor(reader);  // taps
+    readTensor(reader);  // biases
+
+    for (const auto& desc : descriptors) {
+        const auto& cp = desc.Line1.ConvolutionPooling;
+        const auto& conv = desc.Line2.ConvolutionPooling;
+        const auto& pool = desc.Line3.ConvolutionPooling;
+
+        auto IW = static_cast<int32_t>(cp.inputWidth + 1);
+        auto IH = static_cast<int32_t>(cp.inputHeight + 1);
+        uint32_t C = cp.outputChannels + 1;
+        uint32_t KX = pool.poolKernelWidth + 1;
+        uint32_t KY = pool.poolKernelHeight + 1;
+        auto stride = static_cast<int32_t>(conv.chStride + 1);
+
+        auto isMax = pool.poolType == POOL_MAX;
+
+        // Max pooling pads with repeated edges only on the requested sides,
+        // out of range positions are skipped for it and count as zeros for average pooling
+        int32_t padX = 0, padY = 0;
+        if (conv.padEn) {
+            if (isMax) {
+                padX = (conv.padType & PAD_REPEAT_LEFT_EDGE) ? std::max<int32_t>(1, (KX - 1) / 2) : 0;
+                padY = (conv.padType & PAD_REPEAT_TOP_EDGE) ? std::max<int32_t>(1, (KY - 1) / 2) : 0;
+            } else {
+                padX = static_cast<int32_t>(KX - 1) / 2;
+                padY = static_cast<int32_t>(KY - 1) / 2;
+            }
+        }
+
+        auto avgScale = PrecisionUtils::f16tof32(static_cast<ie_fp16>(pool.avgPoolX));
+
+        auto OW = desc.Line10.ConvolutionPooling.outputX;
+        auto OH = output.dims[1];
+
+        auto dataBase = input.ptr + desc.Line4.dataBaseAddr;
+        auto outBase = output.ptr + desc.Line8.outBaseAddr;
+
+        for (uint32_t c = 0; c < C; ++c) {
+            for (uint32_t oy = 0; oy < OH; ++oy) {
+                for (uint32_t ox = 0; ox < OW; ++ox) {
+                    float res = isMax ? -std::numeric_limits<float>::max() : 0.0f;
+
+                    for (uint32_t ky = 0; ky < KY; ++ky) {
+                        auto iy = static_cast<int32_t>(oy) * stride + static_cast<int32_t>(ky) - padY;
+                        if (!inRange(iy, IH))
+                            continue;
+
+                        for (uint32_t kx = 0; kx < KX; ++kx) {
+                            auto ix = static_cast<int32_t>(ox) * stride + static_cast<int32_t>(kx) - padX;
+                            if (!inRange(ix, IW))
+                                continue;
+
+                            auto val = readF16(dataBase + c * desc.Line5.dataChStr + iy * desc.Line5.dataLnStr + ix * sizeof(ie_fp16));
+                            res = isMax ? std::max(res, val) : res + val;
+                        }
+                    }
+
+                    if (!isMax) {
+                        res *= avgScale;
+                    }
+                    if (desc.Line4.reluEn && res < 0.0f) {
+                        res = 0.0f;
+                    }
+
+                    writeF16(outBase + c * desc.Line8.outChStr + oy * desc.Line7.ConvolutionPooling.outLnStr + ox * sizeof(ie_fp16), res);
+                }
+            }
+        }
+
+        info.numOps += static_cast<uint64_t>(C) * OW * OH * KX * KY;
+    }
+
+    runHwParallelCopy(reader, hasParallelCopy, info);
+}
+
+void BlobReferenceExecutor::runHwFullyConnected(StageReader& reader, ReferenceStageInfo& info) {
+    auto hasParallelCopy = reader.read<uint32_t>();
+    auto descriptors = readDescriptors(reader);
+
+    auto input = readTensor(reader);
+    auto output = readTensor(reader);
+    auto taps = readTensor(reader);
+    auto biases = readTensor(reader);
+
+    // Accumulator survives between the descriptors with acc flag set
+    std::vector<float> acc;
+    bool accumulate = false;
+
+    for (const auto& desc : descriptors) {
+        const auto& fc = desc.Line1.FullyConnected;
+
+        uint32_t numInputs = fc.inputWidth + 1;
+        uint32_t numOutputs = fc.vectors + 1;
+
+        if (!accumulate) {
+            acc.assign(numOutputs, 0.0f);
+        }
+
+        auto dataBase = input.ptr + desc.Line4.dataBaseAddr;
+        auto vectorBase = taps.ptr + desc.Line6.FullyConnected.vectorBaseAddr;
+        auto vectorStrOut = desc.Line6.FullyConnected.vectorStrOut;
+
+        for (uint32_t o = 0; o < numOutputs; ++o) {
+            float sum = 0.0f;
+            for (uint32_t i = 0; i < numInputs; ++i) {
+                auto in = readF16(dataBase + i * desc.Line5.dataLnStr);
+                auto w = readF16(vectorBase + (o / 8) * vectorStrOut + i * 8 * sizeof(ie_fp16) + (o % 8) * sizeof(ie_fp16));
+                sum += in * w;
+            }
+            acc[o] += sum;
+        }
+
+        info.numOps += static_cast<uint64_t>(numInputs) * numOutputs;
+
+        accumulate = desc.Line10.FullyConnected.acc != 0;
+        if (accumulate)
+            continue;
+
+        auto outBase = output.ptr + desc.Line8.outBaseAddr;
+        auto numActual = std::min<uint32_t>(numOutputs, desc.Line3.FullyConnected.actualOutChannels + 1);
+
+        for (uint32_t o = 0; o < numActual; ++o) {
+            auto res = acc[o];
+            if (!biases.empty()) {
+                res += readF16(biases.ptr + desc.Line11.biasBaseAddr + o * sizeof(ie_fp16));
+            }
+            if (desc.Line4.reluEn && res < 0.0f) {
+                res = 0.0f;
+            }
+
+            writeF16(outBase + o * desc.Line7.FullyConnected.outLnStr, res);
+        }
+    }
+
+    runHwParallelCopy(reader, hasParallelCopy, info);
+}
+
+}  // namespace VPU
@@ -0,0 +1,183 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mv_common.h"
+#include "mv_blob_format.h"
+
+namespace VPU {
+
+// Estimated device cost and measured host time of one blob stage.
+struct ReferenceStageInfo {
+    t_MvTensorOpType type = kNone0;
+    uint64_t numOps = 0;        // multiply-accumulates for conv/FC, elementwise operations otherwise
+    uint64_t numBytes = 0;      // bytes read and written by the stage
+    uint64_t estimatedCycles = 0;
+    double hostTimeMs = 0.0;
+};
+
+// Host interpreter of the blobs produced by GraphTransformer.
+//
+// Parses the blob headers, relocation tables and stage list and executes the stages
+// on the CPU. Values are kept in FP16 storage, the arithmetic is done in FP32 and
+// rounded to FP16 on store, the same way the SHAVE kernels do. HW stages are emulated
+// from their descriptors, so the descriptor addresses and strides are checked as well.
+//
+// Supported stage types:
+//  - data movement : None, Copy, Reshape, ToPlaneMajor, ConvertOrder, HwFcRelayout,
+//    CopyMakeBorderCHW, Convert (u8/f32 <-> f16), Crop, Tile, Permute
+//  - convolutions : Conv, Im2ColConvolution, DepthConv, Deconvolution, FC
+//  - pooling and activations : MaxPool, AvgPool, Relu, LeakyRelu, (CHW)BiasRelu,
+//    (CHW)BiasLeakyRelu, PRelu, Elu, Sigmoid, Tanh
+//  - elementwise : (CHW)Bias, Sum, Prod, Max, (CHW)Scale, (CHW)ScaleShift, (CHW)Power
+//  - SoftMax, LRN, Normalize, RegionYolo, ReorgYolo, DetectionOutput, CTCDecoder
+//  - MyriadX HW convolution (with fused pooling), pooling and fully connected
+// GraphTransformer doesn't emit ReluX, Relayout, Square, InnerLRN and HwPostOps stages and
+// precomputes PriorBox into the blob data, so they have no handler: infer() throws on them.
+//
+// The per-stage cost is a simple analytic estimate (compute vs memory bound), it is intended
+// to compare two blobs of the same network rather than to predict absolute device latency.
+class BlobReferenceExecutor {
+public:
+    explicit BlobReferenceExecutor(const std::vector<char>& blob);
+
+    // Sizes of the device input/output buffers (as sent to/received from the FIFOs)
+    uint32_t inputSize() const { return _inputSize; }
+    uint32_t outputSize() const { return _outputSize; }
+
+    void infer(const void* input, void* output);
+
+    const std::vector<ReferenceStageInfo>& stagesInfo() const { return _stagesInfo; }
+    uint64_t estimatedCycles() const;
+
+    // Estimated time of the whole blob on the device at the given SHAVE clock
+    double estimatedTimeMs(double frequencyMHz = 600.0) const;
+
+private:
+    struct Tensor {
+        uint8_t* ptr = nullptr;
+        uint32_t dims[3] = {};
+        uint32_t strides[3] = {};
+        uint32_t index = IndexNone;
+        uint32_t dataType = 0;
+        uint32_t order = orderYXZ;
+
+        bool empty() const { return ptr == nullptr; }
+        uint32_t total() const { return dims[0] * dims[1] * dims[2]; }
+        uint32_t elemSize() const;
+
+        float get(uint32_t x, uint32_t y, uint32_t z) const;
+        void set(uint32_t x, uint32_t y, uint32_t z, float val) const;
+
+        // Access by index in logical CHW order (x is the innermost dimension)
+        float getLinear(uint32_t ind) const;
+        void setLinear(uint32_t ind, float val) const;
+    };
+
+    class StageReader;
+
+    struct Stage {
+        t_MvTensorOpType type = kNone0;
+        std::vector<char> params;
+    };
+
+    using StageHandler = void (BlobReferenceExecutor::*)(StageReader& reader, ReferenceStageInfo& info);
+
+    void parseBlob(const std::vector<char>& blob);
+    void initHandlers();
+
+    Tensor readTensor(StageReader& reader);
+    uint8_t* resolve(uint32_t index, uint32_t reloc, uint32_t size);
+
+    void runNone(StageReader& reader, ReferenceStageInfo& info);
+    void runCopy(StageReader& reader, ReferenceStageInfo& info);
+    void runCopyMakeBorder(StageReader& reader, ReferenceStageInfo& info);
+    void runConvert(StageReader& reader, ReferenceStageInfo& info);
+    void runConv(StageReader& reader, ReferenceStageInfo& info);
+    void runDeconv(StageReader& reader, ReferenceStageInfo& info);
+    void runFC(StageReader& reader, ReferenceStageInfo& info);
+    void runPool(StageReader& reader, ReferenceStageInfo& info);
+    void runRelu(StageReader& reader, ReferenceStageInfo& info);
+    void runPRelu(StageReader& reader, ReferenceStageInfo& info);
+    void runElu(StageReader& reader, ReferenceStageInfo& info);
+    void runActivation(StageReader& reader, ReferenceStageInfo& info);
+    void runEltwise(StageReader& reader, ReferenceStageInfo& info);
+    void runScale(StageReader& reader, ReferenceStageInfo& info);
+    void runPower(StageReader& reader, ReferenceStageInfo& info);
+    void runSoftMax(StageReader& reader, ReferenceStageInfo& info);
+    void runLRN(StageReader& reader, ReferenceStageInfo& info);
+    void runCrop(StageReader& reader, ReferenceStageInfo& info);
+    void runTile(StageReader& reader, ReferenceStageInfo& info);
+    void runPermute(StageReader& reader, ReferenceStageInfo& info);
+    void runNormalize(StageReader& reader, ReferenceStageInfo& info);
+    void runRegionYolo(StageReader& reader, ReferenceStageInfo& info);
+    void runReorgYolo(StageReader& reader, ReferenceStageInfo& info);
+    void runDetectionOutput(StageReader& reader, ReferenceStageInfo& info);
+    void runCTCDecoder(StageReader& reader, ReferenceStageInfo& info);
+    void runHwConvolution(StageReader& reader, ReferenceStageInfo& info);
+    void runHwPooling(StageReader& reader, ReferenceStageInfo& info);
+    void runHwFullyConnected(StageReader& reader, ReferenceStageInfo& info);
+
+    void runHwParallelCopy(StageReader& reader, uint32_t hasParallelCopy, ReferenceStageInfo& info);
+
+    uint64_t estimateCycles(const ReferenceStageInfo& info) const;
+
+    uint32_t _numShaves = 1;
+    uint32_t _inputSize = 0;
+    uint32_t _outputSize = 0;
+
+    std::vector<uint8_t> _blobData;
+    std::vector<mv_reloc_info> _blobRelocs;
+    std::vector<mv_reloc_info> _workRelocs;
+
+    std::vector<uint8_t> _bss;
+    std::vector<uint8_t> _cmx;
+
+    std::vector<uint8_t> _input;
+    std::vector<uint8_t> _output;
+
+    // Bytes of all tensors referenced by the stage being executed
+    uint64_t _stageBytes = 0;
+
+    std::vector<Stage> _stages;
+    std::vector<ReferenceStageInfo> _stagesInfo;
+
+    StageHandler _handlers[OP_TYPE_COUNT_] = {};
+};
+
+}  // namespace VPU
@@ -405,6 +405,10 @@ void HDDLInferRequest::SetCompletionCallback_ThreadUnsafe(IInferRequest::Complet
     AsyncInferRequestInternal::SetCompletionCallback(callback);
 }
 
+void HDDLInferRequest::SetCompletionQueue_ThreadUnsafe(const ICompletionQueue::Ptr &queue) {
+    AsyncInferRequestInternal::SetCompletionQueue(queue);
+}
+
 void HDDLInferRequest::GetUserData_ThreadUnsafe(void **data) {
     AsyncInferRequestInternal::GetUserData(data);
 }
@@ -418,10 +422,20 @@ void *HDDLInferRequest::HDDLCallback() {
         CopyToExternalOutputs();
     }
 
+    bool isRestarted = false;
     if (_callback && _publicInterface.lock()) {
         setIsRequestBusy(false);
         auto status = Wait(IInferRequest::WaitMode::STATUS_ONLY);
         _callback(_publicInterface.lock(), status);
+        isRestarted = isRequestBusy();
+    }
+
+    // not pushed if the callback started the next inference
+    auto queue = _completionQueue.lock();
+    auto requestPtr = _publicInterface.lock();
+    if (queue && requestPtr && !isRestarted) {
+        setIsRequestBusy(false);
+        queue->Push(requestPtr, Wait(IInferRequest::WaitMode::STATUS_ONLY), nullptr);
     }
     return nullptr;
 }
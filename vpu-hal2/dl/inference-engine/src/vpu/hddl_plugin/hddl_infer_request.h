@@ -86,6 +86,10 @@ public:
         InferenceEngine::AsyncInferRequestThreadSafeInternal::SetCompletionCallback(callback);
     }
 
+    void SetCompletionQueue(const InferenceEngine::ICompletionQueue::Ptr &queue) override {
+        InferenceEngine::AsyncInferRequestThreadSafeInternal::SetCompletionQueue(queue);
+    }
+
     void GetUserData(void **data) override {
         InferenceEngine::AsyncInferRequestThreadSafeInternal::GetUserData(data);
     }
@@ -110,6 +114,8 @@ public:
 
     void SetCompletionCallback_ThreadUnsafe(InferenceEngine::IInferRequest::CompletionCallback callback) override;
 
+    void SetCompletionQueue_ThreadUnsafe(const InferenceEngine::ICompletionQueue::Ptr &queue) override;
+
     void GetUserData_ThreadUnsafe(void **data) override;
 
     void SetUserData_ThreadUnsafe(void *data) override;
@@ -33,39 +33,62 @@ MyriadAsyncInferRequest::MyriadAsyncInferRequest(MyriadInferRequest::Ptr request
 InferenceEngine::StagedTask::Ptr MyriadAsyncInferRequest::createAsyncRequestTask() {
     return std::make_shared<StagedTask>([this]() {
         auto asyncTaskCopy = _asyncTask;
+        size_t asyncStart = _asyncStartCount;
+        bool isReleased = false;
         try {
             switch (asyncTaskCopy->getStage()) {
                 case 3: {
-                    _request->InferAsync();
+                    IE_TRACE_REQUEST_SCOPE(_traceRequestId)
+                    IE_TRACE_END("request", "Queued", _traceRequestId)
+                    {
+                        IE_TRACE_SCOPE("request", "InferAsync")
+                        _request->InferAsync();
+                    }
                     asyncTaskCopy->stageDone();
+                    IE_TRACE_BEGIN("request", "ResultQueued", _traceRequestId)
                     _taskExecutorGetResult->startTask(asyncTaskCopy);
                 }
                     break;
                 case 2: {
-                    _request->GetResult();
+                    IE_TRACE_REQUEST_SCOPE(_traceRequestId)
+                    IE_TRACE_END("request", "ResultQueued", _traceRequestId)
+                    {
+                        IE_TRACE_SCOPE("request", "GetResult")
+                        _request->GetResult();
+                    }
                     asyncTaskCopy->stageDone();
                     if (_callback) {
+                        IE_TRACE_BEGIN("request", "CallbackQueued", _traceRequestId)
                         _callbackExecutor->startTask(asyncTaskCopy);
                     } else {
                         asyncTaskCopy->stageDone();
+                        pushToCompletionQueue(OK, asyncStart, isReleased);
                     }
                 }
                     break;
                 case 1: {
+                    // read before the request is released to the next inference
+                    IE_TRACE_REQUEST_SCOPE(_traceRequestId)
+                    IE_TRACE_END("request", "CallbackQueued", _traceRequestId)
+                    IE_TRACE_SCOPE("request", "Callback")
                     auto requestPtr = _publicInterface.lock();
                     if (!requestPtr) {
                         THROW_IE_EXCEPTION << "Failed to run callback: can't get pointer to request";
                     }
                     setIsRequestBusy(false);
+                    isReleased = true;
                     _callback(requestPtr, Task::TaskStatus2StatusCode(asyncTaskCopy->getStatus()));
                     asyncTaskCopy->stageDone();
+                    pushToCompletionQueue(OK, asyncStart, isReleased);
                 }
                     break;
                 default:
                     break;
             }
         } catch (...) {
-            setIsRequestBusy(false);
+            if (!pushToCompletionQueue(GENERAL_ERROR, asyncStart, isReleased) && !isReleased) {
+                setIsRequestBusy(false);
+            }
             std::rethrow_exception(std::current_exception());
         }
     }, 3);
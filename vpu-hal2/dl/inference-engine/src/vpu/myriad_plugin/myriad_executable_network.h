@@ -56,6 +56,10 @@ public:
 
     explicit ExecutableNetwork(InferenceEngine::ICNNNetwork &network,
                                std::vector<DevicePtr> &devicePool,
+                               const ThermalMonitorPtr &thermalMonitor,
+                               Common::ThermalPolicy thermalPolicy,
+                               int graphsPerDevice,
+                               bool useResidencyDaemon,
                                const std::map<std::string, std::string> &config) {
         Common::LogLevel logLevel;
         Common::LogLevel vpuLogLevel;
@@ -76,31 +80,64 @@ public:
         _log->init(logLevel);
 
         _executor = std::make_shared<MyriadExecutor>(vpuLogLevel, _log);
-        _device = _executor->openDevice(devicePool);
-        _env = std::make_shared<Common::Environment>(_device->_platform, config);
-        // ignore hardware optimization config for MYRIAD2, it is always disabled
-        if (_device->_platform == MYRIAD_2) {
-            _env->parsedConfig.blobConfig.hwOptimization = false;
-            LOG_INFO("[VPU] hardware optimization config for MYRIAD2 always disabled");
+        _executor->setThermalPolicy(thermalMonitor, thermalPolicy);
+        _device = _executor->openDevice(devicePool, graphsPerDevice, useResidencyDaemon);
+        if (thermalMonitor && !_device->_residency) {
+            thermalMonitor->addDevice(_device->_deviceHandle);
         }
-
-        auto graphTrasnformer = createGraphTransformer(_env->parsedConfig.blobConfig, _log);
-
-        size_t numStages = 0;
-        graphTrasnformer->generate(network, _graphBlob, _env->blobMetaData, numStages);
-
-        LOG_INFO("[VPU] ExecutableNetwork : graphTrasnformer->generate done");
-
         char networkName[1024] = {};
-        network.getName(networkName, sizeof(networkName));
-        LOG_INFO("[VPU] org network name %s", networkName);
-        _executor->allocateGraph(_device, _graphDesc, _graphBlob, numStages, networkName);
+        // the destructor does not run if the constructor throws, the graph slot taken by
+        // openDevice and what allocateGraph has created so far are released here
+        try {
+            _env = std::make_shared<Common::Environment>(_device->_platform, config);
+            // ignore hardware optimization config for MYRIAD2, it is always disabled
+            if (_device->_platform == MYRIAD_2) {
+                _env->parsedConfig.blobConfig.hwOptimization = false;
+                LOG_INFO("[VPU] hardware optimization config for MYRIAD2 always disabled");
+            }
+            if (_env->parsedConfig.partitionCmx) {
+                _executor->partitionCmxBuffer(_device, _env->parsedConfig.blobConfig);
+            }
+
+            auto graphTrasnformer = createGraphTransformer(_env->parsedConfig.blobConfig, _log);
+
+            size_t numStages = 0;
+            graphTrasnformer->generate(network, _graphBlob, _env->blobMetaData, numStages);
+            _env->blobInputs = graphTrasnformer->getInputsInfo();
+            _env->blobOutputs = graphTrasnformer->getOutputsInfo();
+
+            LOG_INFO("[VPU] ExecutableNetwork : graphTrasnformer->generate done");
+
+            network.getName(networkName, sizeof(networkName));
+            LOG_INFO("[VPU] org network name %s", networkName);
+            _executor->allocateGraph(_device, _graphDesc, _graphBlob, numStages, networkName);
+        } catch (...) {
+            _executor->deallocateGraph(_device, _graphDesc);
+            throw;
+        }
         LOG_INFO("[VPU] _executor->allocateGraph");
         if (_env->parsedConfig.exclusiveAsyncRequests) {
             InferenceEngine::ExecutorManager *executorManager = InferenceEngine::ExecutorManager::getInstance();
             _taskExecutor = executorManager->getExecutor(
                     InferenceEngine::TargetDeviceInfo::name(InferenceEngine::TargetDevice::eMYRIAD));
         }
+        if (_env->parsedConfig.callbackThreads > 0) {
+            // the start and GetResult stages stay serial, the outputs are read in the order of the inferences
+            InferenceEngine::TaskExecutorConfig callbackConfig;
+            callbackConfig.type = InferenceEngine::TaskExecutorConfig::WORK_STEALING;
+            callbackConfig.workers = _env->parsedConfig.callbackThreads;
+            callbackConfig.cpus = _env->parsedConfig.callbackCpus;
+            // the executor of an id keeps the config it was created with, networks configured differently
+            // get their own pool
+            std::stringstream callbackId;
+            callbackId << InferenceEngine::TargetDeviceInfo::name(InferenceEngine::TargetDevice::eMYRIAD)
+                       << "_Callbacks" << callbackConfig.workers;
+            for (int cpu : callbackConfig.cpus) {
+                callbackId << "_" << cpu;
+            }
+            InferenceEngine::ExecutorManager *executorManager = InferenceEngine::ExecutorManager::getInstance();
+            _callbackExecutor = executorManager->getExecutor(callbackId.str(), callbackConfig);
+        }
 
         for (size_t i = 0; i < _maxTaskExecutorGetResultCount; i++) {
             std::stringstream idStream;
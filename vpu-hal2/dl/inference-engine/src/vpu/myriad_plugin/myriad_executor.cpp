@@ -29,6 +29,8 @@
 // this notice or any other notice embedded in Materials by Intel or Intel's
 // suppliers or licensors in any way.
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -45,6 +47,7 @@
 
 #include "myriad_executor.h"
 #include <cpp_interfaces/exception2status.hpp>
+#include <ie_trace.hpp>
 
 #ifdef NNLOG
 #include <android/log.h>
@@ -81,18 +84,108 @@ MyriadExecutor::MyriadExecutor(const LogLevel& vpuLogLevel, const LoggerPtr& log
     }
 }
 
-DevicePtr MyriadExecutor::openDevice(std::vector<DevicePtr> &devicePool) {
+void MyriadExecutor::setThermalPolicy(const ThermalMonitorPtr &thermalMonitor, ThermalPolicy thermalPolicy) {
+    _thermalMonitor = thermalMonitor;
+    _thermalPolicy = thermalMonitor ? thermalPolicy : ThermalPolicy::None;
+}
+
+// Graphs beyond DEVICE_MAX_GRAPHS are only loaded while the device has room for
+// one more graph of the average size of the loaded ones
+static bool hasMemoryForGraph(const DevicePtr &device) {
+    if (device->_executors < DEVICE_MAX_GRAPHS) {
+        return true;
+    }
+    int memorySize = 0;
+    int memoryUsed = 0;
+    unsigned int dataLength = sizeof(int);
+    if (NC_OK != ncDeviceGetOption(device->_deviceHandle, NC_OPTION_CLASS0, NC_RO_DEVICE_MEMORY_SIZE,
+                                   &memorySize, &dataLength) ||
+        NC_OK != ncDeviceGetOption(device->_deviceHandle, NC_OPTION_CLASS0, NC_RO_DEVICE_CURRENT_MEMORY_USED,
+                                   &memoryUsed, &dataLength)) {
+        return false;
+    }
+    return memorySize - memoryUsed >= memoryUsed / device->_executors;
+}
+
+// Index in devicePool of the first empty device, or of the first one which can take one
+// more graph when attach is set, or of the coolest one with the BALANCE thermal policy.
+// -1 if there is none.
+static int findDevice(const std::vector<DevicePtr> &devicePool, bool attach,
+                      const ThermalMonitorPtr &thermalMonitor, ThermalPolicy thermalPolicy) {
+    std::vector<int> candidates;
+    std::vector<deviceHandle_t *> handles;
+    for (int deviceIdx = 0; deviceIdx < devicePool.size(); deviceIdx++) {
+        auto &device = devicePool[deviceIdx];
+        if (attach ? device->_executors < device->_maxGraphs && hasMemoryForGraph(device)
+                   : device->_executors == 0) {
+            candidates.push_back(deviceIdx);
+            handles.push_back(devicePool[deviceIdx]->_deviceHandle);
+        }
+    }
+    if (candidates.empty()) {
+        return -1;
+    }
+    if (thermalPolicy != ThermalPolicy::Balance) {
+        return candidates.front();
+    }
+    return candidates[thermalMonitor->selectCoolest(handles)];
+}
+
+// Number of graphs the device takes: graphsPerDevice within the limit of the firmware
+static int deviceMaxGraphs(deviceHandle_t *deviceHandle, int graphsPerDevice) {
+    int maxGraphs = 0;
+    unsigned int dataLength = sizeof(maxGraphs);
+    if (NC_OK == ncDeviceGetOption(deviceHandle, NC_OPTION_CLASS0, NC_RO_DEVICE_MAX_GRAPH_NUM,
+                                   &maxGraphs, &dataLength) && maxGraphs > 0) {
+        graphsPerDevice = std::min(graphsPerDevice, maxGraphs);
+    }
+    return std::min(graphsPerDevice, MAX_GRAPHS_PER_DEVICE);
+}
+
+DevicePtr &MyriadExecutor::acquireGraphSlot(DevicePtr &device) {
+    _graphSlot = 0;
+    while (device->_graphSlots & (1u << _graphSlot)) {
+        _graphSlot++;
+    }
+    device->_graphSlots |= 1u << _graphSlot;
+    device->_executors += 1;
+    return device;
+}
+
+void MyriadExecutor::releaseGraphSlot(const DevicePtr &device) {
+    if (_graphSlot < 0) {
+        return;
+    }
+    device->_executors -= 1;
+    device->_graphSlots &= ~(1u << _graphSlot);
+    _graphSlot = -1;
+}
+
+DevicePtr MyriadExecutor::openDevice(std::vector<DevicePtr> &devicePool, int graphsPerDevice,
+                                     bool useResidencyDaemon) {
     std::lock_guard<std::mutex> lock(device_mutex);
     ncStatus_t statusInit = NC_ERROR;
     ncStatus_t statusOpen = NC_ERROR;
 
-    // check already booted but empty devices
-    int deviceIdx = -1;
-    while (++deviceIdx < devicePool.size()) {
-        if (devicePool[deviceIdx]->_executors == 0) {
-            devicePool[deviceIdx]->_executors = 1;
-            return devicePool[deviceIdx];
+    // the daemon owns the devices it booted, the graph is placed by it on allocateGraph
+    if (useResidencyDaemon && ncResidencyDaemonAvailable(nullptr)) {
+        auto device = std::make_shared<DeviceDesc>();
+        device->_residency = true;
+#ifdef AKS
+        device->_platform = 2450; //fixed for Myriad 2450
+#endif
+        if (device->_platform == UNKNOWN_DEVICE) {
+            THROW_IE_EXCEPTION << "Unknown device";
         }
+        LOG_INFO("MyriadExecutor::openDevice ncs_residencyd is running, the graph will be attached through it");
+        return device;
+    }
+
+    // check already booted but empty devices
+    int deviceIdx = findDevice(devicePool, false, _thermalMonitor, _thermalPolicy);
+    if (deviceIdx >= 0) {
+        devicePool[deviceIdx]->_maxGraphs = deviceMaxGraphs(devicePool[deviceIdx]->_deviceHandle, graphsPerDevice);
+        return acquireGraphSlot(devicePool[deviceIdx]);
     }
 
     // try to boot next device if any
@@ -113,21 +206,19 @@ DevicePtr MyriadExecutor::openDevice(std::vector<DevicePtr> &devicePool) {
 #ifdef AKS
                 device._platform = 2450; //fixed for Myriad 2450
 #endif
-                device._executors = 1;
                 device._deviceIdx = deviceIdx;
+                device._maxGraphs = deviceMaxGraphs(device._deviceHandle, graphsPerDevice);
                 devicePool.push_back(std::make_shared<DeviceDesc>(device));
+                acquireGraphSlot(devicePool.back());
             }
         }
     }
 
     // attach one more executor to already booted device
     if (statusInit != NC_OK) {
-        deviceIdx = -1;
-        while (++deviceIdx < devicePool.size()) {
-            if (devicePool[deviceIdx]->_executors < DEVICE_MAX_GRAPHS) {
-                devicePool[deviceIdx]->_executors += 1;
-                return devicePool[deviceIdx];
-            }
+        deviceIdx = findDevice(devicePool, true, _thermalMonitor, _thermalPolicy);
+        if (deviceIdx >= 0) {
+            return acquireGraphSlot(devicePool[deviceIdx]);
         }
     }
 
@@ -138,6 +229,7 @@ DevicePtr MyriadExecutor::openDevice(std::vector<DevicePtr> &devicePool) {
         THROW_IE_EXCEPTION << "Can not open USB device: " << ncStatusToStr(nullptr, statusOpen);
     }
     if (devicePool[deviceIdx]->_platform == UNKNOWN_DEVICE) {
+        releaseGraphSlot(devicePool[deviceIdx]);
         THROW_IE_EXCEPTION << "Unknown device";
     }
 
@@ -165,10 +257,39 @@ void MyriadExecutor::closeDevices(std::vector<DevicePtr> &devicePool) {
     #endif
 }
 
+void MyriadExecutor::attachResidentGraph(GraphDesc &graphDesc, const std::vector<char> &graphFileContent) {
+    auto residency = std::make_shared<ResidencyAttachment>();
+    ncStatus_t status;
+    {
+        IE_TRACE_SCOPE("hal", "ncResidencyAttach")
+        status = ncResidencyAttach(nullptr, graphFileContent.data(), static_cast<unsigned int>(graphFileContent.size()),
+                                   RESIDENCY_SLOTS, NC_FIFO_FP16, &residency->_graph);
+    }
+    if (status != NC_OK) {
+        THROW_IE_EXCEPTION << "Failed to attach graph through ncs_residencyd: " << ncStatusToStr(nullptr, status);
+    }
+
+    auto info = ncResidencyGetInfo(residency->_graph);
+    graphDesc._inputDesc.assign(info->inputs, info->inputs + info->inputCount);
+    graphDesc._outputDesc.assign(info->outputs, info->outputs + info->outputCount);
+    for (unsigned int slot = 0; slot < info->slots; ++slot) {
+        residency->_freeSlots.push_back(slot);
+    }
+    graphDesc._residency = residency;
+
+    LOG_INFO("MyriadExecutor::allocateGraph %s graph attached on device %d of ncs_residencyd, %u slots",
+             info->resident ? "resident" : "new", info->deviceIndex, info->slots);
+}
+
 void MyriadExecutor::allocateGraph(DevicePtr &device, GraphDesc &graphDesc,
         const std::vector<char> &graphFileContent, size_t numStages, const char* networkName) {
 
     LOG_INFO("MyriadExecutor::allocateGraph");
+    if (device->_residency) {
+        graphDesc._device = device;
+        attachResidentGraph(graphDesc, graphFileContent);
+        return;
+    }
     if (device->_deviceHandle == nullptr) {
         LOG_INFO("MyriadExecutor::allocateGraph _deviceHandle is Null");
         THROW_IE_EXCEPTION << "Failed to allocate graph: MYRIAD device is not opened.";
@@ -184,6 +305,7 @@ void MyriadExecutor::allocateGraph(DevicePtr &device, GraphDesc &graphDesc,
     if (status != NC_OK) {
         THROW_IE_EXCEPTION << "Failed to init graph: " << ncStatusToStr(nullptr, status);
     }
+    graphDesc._device = device;
     int executors = device->_platform == MYRIAD_X ? 2 : 1;
 
     status = ncGraphSetOption(graphDesc._graphHandle, NC_OPTION_CLASS1, NC_RW_GRAPH_EXECUTORS_NUM, &executors, sizeof(executors));
@@ -207,7 +329,7 @@ void MyriadExecutor::allocateGraph(DevicePtr &device, GraphDesc &graphDesc,
     if (status != NC_OK) {
         THROW_IE_EXCEPTION << "Failed to get number of inputs: " << ncStatusToStr(graphDesc._graphHandle, status);
     }
-    if (numInputs != 1) {
+    if (numInputs < 1) {
         THROW_IE_EXCEPTION << "Unsupported number of inputs: " << numInputs;
     }
 
@@ -216,52 +338,68 @@ void MyriadExecutor::allocateGraph(DevicePtr &device, GraphDesc &graphDesc,
     if (status != NC_OK) {
         THROW_IE_EXCEPTION << "Failed to get number of outputs: " << ncStatusToStr(graphDesc._graphHandle, status);
     }
-    if (numOutputs != 1) {
+    if (numOutputs < 1) {
         THROW_IE_EXCEPTION << "Unsupported number of outputs: " << numOutputs;
     }
 
-    status = ncGraphGetOption(graphDesc._graphHandle, NC_OPTION_CLASS0, NC_RO_GRAPH_INPUT_TENSOR_DESCRIPTORS, &graphDesc._inputDesc, &dataLength);
+    ncTensorDescriptor_t *inputDesc = nullptr;
+    status = ncGraphGetOption(graphDesc._graphHandle, NC_OPTION_CLASS0, NC_RO_GRAPH_INPUT_TENSOR_DESCRIPTORS, &inputDesc, &dataLength);
     if (status != NC_OK) {
         THROW_IE_EXCEPTION << "Failed to get input description: " << ncStatusToStr(graphDesc._graphHandle, status);
     }
+    graphDesc._inputDesc.assign(inputDesc, inputDesc + numInputs);
 
-    status = ncGraphGetOption(graphDesc._graphHandle, NC_OPTION_CLASS0, NC_RO_GRAPH_OUTPUT_TENSOR_DESCRIPTORS, &graphDesc._outputDesc, &dataLength);
+    ncTensorDescriptor_t *outputDesc = nullptr;
+    status = ncGraphGetOption(graphDesc._graphHandle, NC_OPTION_CLASS0, NC_RO_GRAPH_OUTPUT_TENSOR_DESCRIPTORS, &outputDesc, &dataLength);
     if (status != NC_OK) {
         THROW_IE_EXCEPTION << "Failed to get output description: " << ncStatusToStr(graphDesc._graphHandle, status);
     }
+    graphDesc._outputDesc.assign(outputDesc, outputDesc + numOutputs);
 
     int fifo_elements = 4;
 
-    status = ncFifoInit(NC_FIFO_HOST_WO, &graphDesc._inputFifoHandle);
-    if (status != NC_OK) {
-        THROW_IE_EXCEPTION << "Failed to init input FIFO: " << ncStatusToStr(graphDesc._graphHandle, status);
-    }
+    for (auto &desc : graphDesc._inputDesc) {
+        fifoHandle_t *fifo = nullptr;
+        status = ncFifoInit(NC_FIFO_HOST_WO, &fifo);
+        if (status != NC_OK) {
+            THROW_IE_EXCEPTION << "Failed to init input FIFO: " << ncStatusToStr(graphDesc._graphHandle, status);
+        }
+        graphDesc._inputFifoHandles.push_back(fifo);
 
-    status = ncFifoCreate(graphDesc._inputFifoHandle, device->_deviceHandle, graphDesc._inputDesc, fifo_elements);
-    if (status != NC_OK) {
-        THROW_IE_EXCEPTION << "Failed to create input FIFO: " << ncStatusToStr(graphDesc._graphHandle, status);
+        status = ncFifoCreate(fifo, device->_deviceHandle, &desc, fifo_elements);
+        if (status != NC_OK) {
+            THROW_IE_EXCEPTION << "Failed to create input FIFO: " << ncStatusToStr(graphDesc._graphHandle, status);
+        }
     }
 
-    status = ncFifoInit(NC_FIFO_HOST_RO, &graphDesc._outputFifoHandle);
-    if (status != NC_OK) {
-        THROW_IE_EXCEPTION << "Failed to init output FIFO: " << ncStatusToStr(graphDesc._graphHandle, status);
-    }
+    for (auto &desc : graphDesc._outputDesc) {
+        fifoHandle_t *fifo = nullptr;
+        status = ncFifoInit(NC_FIFO_HOST_RO, &fifo);
+        if (status != NC_OK) {
+            THROW_IE_EXCEPTION << "Failed to init output FIFO: " << ncStatusToStr(graphDesc._graphHandle, status);
+        }
+        graphDesc._outputFifoHandles.push_back(fifo);
 
-    status = ncFifoCreate(graphDesc._outputFifoHandle, device->_deviceHandle, graphDesc._outputDesc, fifo_elements);
-    if (status != NC_OK) {
-        THROW_IE_EXCEPTION << "Failed to create output FIFO: " << ncStatusToStr(graphDesc._graphHandle, status);
+        status = ncFifoCreate(fifo, device->_deviceHandle, &desc, fifo_elements);
+        if (status != NC_OK) {
+            THROW_IE_EXCEPTION << "Failed to create output FIFO: " << ncStatusToStr(graphDesc._graphHandle, status);
+        }
     }
+
+    LOG_INFO("MyriadExecutor::allocateGraph %d input and %d output FIFOs created", numInputs, numOutputs);
 }
 
-void MyriadExecutor::queueInference(GraphDesc &graphDesc, void *input_data, size_t input_bytes,
-                    void **result_data, size_t *result_bytes) {
+void MyriadExecutor::queueInference(GraphDesc &graphDesc, const std::vector<const void *> &input_data,
+                                    const std::vector<size_t> &input_bytes) {
 #ifndef NDEBUG
     if (auto dumpFileName = std::getenv("IE_VPU_DUMP_INPUT_FILE_NAME")) {
         std::ofstream file(dumpFileName, std::ios_base::binary | std::ios_base::out);
         if (!file.is_open()) {
             THROW_IE_EXCEPTION << "[VPU] Cannot open file " << dumpFileName << " for writing";
         }
-        file.write(static_cast<const char*>(input_data), input_bytes);
+        for (size_t i = 0; i < input_data.size(); ++i) {
+            file.write(static_cast<const char*>(input_data[i]), input_bytes[i]);
+        }
     }
 #endif
 
@@ -269,45 +407,158 @@ void MyriadExecutor::queueInference(GraphDesc &graphDesc, void *input_data, size
     #ifdef NNLOG
     ALOGI("MyriadExecutor::queueInference");
     #endif
-    if (graphDesc._inputDesc->totalSize != input_bytes) {
-        THROW_IE_EXCEPTION << "Input has unexpected size " << input_bytes << ", expected " << graphDesc._inputDesc->totalSize;
+    if (input_data.size() != graphDesc._inputDesc.size() || input_bytes.size() != input_data.size()) {
+        THROW_IE_EXCEPTION << "Got " << input_data.size() << " inputs, expected " << graphDesc._inputDesc.size();
+    }
+    for (size_t i = 0; i < input_data.size(); ++i) {
+        if (graphDesc._inputDesc[i].totalSize != input_bytes[i]) {
+            THROW_IE_EXCEPTION << "Input " << i << " has unexpected size " << input_bytes[i]
+                               << ", expected " << graphDesc._inputDesc[i].totalSize;
+        }
+    }
+
+    if (graphDesc._residency) {
+        queueResidentInference(graphDesc, input_data, input_bytes);
+        return;
+    }
+
+    if (_thermalMonitor && graphDesc._device) {
+        auto thermalStatus = _thermalMonitor->getStatus(graphDesc._device->_deviceHandle);
+        if (thermalStatus.valid &&
+            _lastThrottlingLevel.exchange(thermalStatus.throttlingLevel) != thermalStatus.throttlingLevel) {
+            printThrottlingStatus(graphDesc._device, thermalStatus);
+        }
+        if (_thermalPolicy == ThermalPolicy::Pace) {
+            _thermalMonitor->pace(graphDesc._device->_deviceHandle);
+        }
     }
 
     ncStatus_t status;
 
-    status = ncFifoWriteElem(graphDesc._inputFifoHandle, input_data, graphDesc._inputDesc, nullptr);
-    if (status != NC_OK) {
-        THROW_IE_EXCEPTION << "Failed to write input to FIFO: " << ncStatusToStr(graphDesc._graphHandle, status);
+    for (size_t i = 0; i < input_data.size(); ++i) {
+        {
+            IE_TRACE_SCOPE("hal", "ncFifoWriteElem")
+            status = ncFifoWriteElem(graphDesc._inputFifoHandles[i], input_data[i], &graphDesc._inputDesc[i], nullptr);
+        }
+        if (status != NC_OK) {
+            THROW_IE_EXCEPTION << "Failed to write input " << i << " to FIFO: " << ncStatusToStr(graphDesc._graphHandle, status);
+        }
     }
 
-    status = ncGraphQueueInference(graphDesc._graphHandle, &graphDesc._inputFifoHandle, &graphDesc._outputFifoHandle);
+    {
+        IE_TRACE_SCOPE("hal", "ncGraphQueueInference")
+        status = ncGraphQueueInference(graphDesc._graphHandle, graphDesc._inputFifoHandles.data(), graphDesc._outputFifoHandles.data());
+    }
     if (status != NC_OK) {
         THROW_IE_EXCEPTION << "Failed to queue inference: " << ncStatusToStr(graphDesc._graphHandle, status);
     }
+}
+
+// The slots are taken in the order of the inferences, which the daemon completes in turn
+void MyriadExecutor::queueResidentInference(GraphDesc &graphDesc, const std::vector<const void *> &input_data,
+                                            const std::vector<size_t> &input_bytes) {
+    auto &residency = *graphDesc._residency;
+
+    unsigned int slot = 0;
+    {
+        std::unique_lock<std::mutex> lock(residency._mutex);
+        residency._slotFreed.wait(lock, [&residency] { return !residency._freeSlots.empty(); });
+        slot = residency._freeSlots.front();
+        residency._freeSlots.pop_front();
+    }
 
-    if (result_data != nullptr && result_bytes != nullptr) {
-        getResult(graphDesc, result_data, result_bytes);
+    for (size_t i = 0; i < input_data.size(); ++i) {
+        memcpy(ncResidencyInputBuffer(residency._graph, slot, static_cast<unsigned int>(i)), input_data[i], input_bytes[i]);
+    }
+
+    ncStatus_t status;
+    {
+        IE_TRACE_SCOPE("hal", "ncResidencyQueueInference")
+        status = ncResidencyQueueInference(residency._graph, slot);
+    }
+    if (status != NC_OK) {
+        releaseResidentSlot(residency, slot);
+        THROW_IE_EXCEPTION << "Failed to queue inference: " << ncStatusToStr(nullptr, status);
     }
 }
 
-void MyriadExecutor::getResult(GraphDesc &graphDesc, void **result_data, size_t *result_bytes) {
+// The first output waits for the oldest inference, the last one gives its slot back
+void MyriadExecutor::getResidentResult(GraphDesc &graphDesc, size_t output_idx, void *result_data) {
+    auto &residency = *graphDesc._residency;
+
+    if (output_idx == 0) {
+        unsigned int slot = RESIDENCY_SLOTS;
+        ncStatus_t status;
+        {
+            IE_TRACE_SCOPE("hal", "ncResidencyWaitInference")
+            status = ncResidencyWaitInference(residency._graph, &slot);
+        }
+        if (status != NC_OK) {
+            if (slot < RESIDENCY_SLOTS) {
+                releaseResidentSlot(residency, slot);
+            }
+            THROW_IE_EXCEPTION << "Failed to wait for inference: " << ncStatusToStr(nullptr, status);
+        }
+        residency._resultSlot = slot;
+    }
+
+    memcpy(result_data, ncResidencyOutputBuffer(residency._graph, residency._resultSlot, static_cast<unsigned int>(output_idx)),
+           graphDesc._outputDesc[output_idx].totalSize);
+
+    if (output_idx + 1 == graphDesc._outputDesc.size()) {
+        releaseResidentSlot(residency, residency._resultSlot);
+    }
+}
+
+void MyriadExecutor::releaseResidentSlot(ResidencyAttachment &residency, unsigned int slot) {
+    {
+        std::lock_guard<std::mutex> lock(residency._mutex);
+        residency._freeSlots.push_back(slot);
+    }
+    residency._slotFreed.notify_one();
+}
+
+void MyriadExecutor::getResult(GraphDesc &graphDesc, size_t output_idx, void *result_data, size_t result_bytes) {
     LOG_INFO("Graph result");
 #ifdef NNLOG
     ALOGI("Graph result");
 #endif
-    ncStatus_t status;
-    ncTensorDescriptor_t resDesc = {};
+    if (output_idx >= graphDesc._outputDesc.size()) {
+        THROW_IE_EXCEPTION << "Graph has no output " << output_idx;
+    }
+    if (result_bytes < graphDesc._outputDesc[output_idx].totalSize) {
+        THROW_IE_EXCEPTION << "Output " << output_idx << " has unexpected size " << graphDesc._outputDesc[output_idx].totalSize
+                           << ", expected at most " << result_bytes;
+    }
+
+    if (graphDesc._residency) {
+        getResidentResult(graphDesc, output_idx, result_data);
+        return;
+    }
+
     void *userParam = nullptr;
-    status = ncFifoReadElem(graphDesc._outputFifoHandle, result_data, &resDesc, &userParam);
+    ncStatus_t status;
+    {
+        IE_TRACE_SCOPE("hal", "ncFifoReadElem")
+        status = ncFifoReadElemToBuffer(graphDesc._outputFifoHandles[output_idx], result_data, result_bytes, &userParam);
+    }
     if (status != NC_OK) {
-        THROW_IE_EXCEPTION << "Failed to read output from FIFO: " << ncStatusToStr(graphDesc._graphHandle, status);
+        THROW_IE_EXCEPTION << "Failed to read output " << output_idx << " from FIFO: " << ncStatusToStr(graphDesc._graphHandle, status);
     }
 
-    if (resDesc.totalSize != graphDesc._outputDesc->totalSize) {
-        THROW_IE_EXCEPTION << "Output has unexpected size " << resDesc.totalSize << ", expected " << graphDesc._outputDesc->totalSize;
+    // the device time of the inference, which ended before its first output was read
+    if (output_idx == 0 && InferenceEngine::Tracer::isEnabled()) {
+        auto end = InferenceEngine::Tracer::now();
+        auto perfInfo = getPerfTimeInfo(graphDesc._graphHandle);
+        float deviceMs = 0.0f;
+        for (size_t i = 0; i < perfInfo->numElements(); ++i) {
+            deviceMs += perfInfo->info()[i];
+        }
+        auto requestId = InferenceEngine::Tracer::currentRequestId();
+        InferenceEngine::Tracer::record('B', "device", "Inference", requestId,
+                                        end - static_cast<uint64_t>(deviceMs * 1e6f));
+        InferenceEngine::Tracer::record('E', "device", "Inference", requestId, end);
     }
-
-    *result_bytes = resDesc.totalSize;
 }
 
 void MyriadExecutor::deallocateGraph(DevicePtr &device, GraphDesc &graphDesc) {
@@ -317,19 +568,27 @@ void MyriadExecutor::deallocateGraph(DevicePtr &device, GraphDesc &graphDesc) {
     ALOGI("MyriadExecutor::deallocateGraph");
     #endif
       std::lock_guard<std::mutex> lock(device_mutex);
+    if (graphDesc._residency) {
+        auto res = ncResidencyDetach(graphDesc._residency->_graph);
+        if (res != NC_OK) {
+            LOG_WARNING("ncResidencyDetach result %s", ncStatusToStr(nullptr, res));
+        }
+        graphDesc._residency.reset();
+        return;
+    }
     if (device->_deviceHandle != nullptr) {
-        if (graphDesc._inputFifoHandle != nullptr) {
-            auto res = ncFifoDelete(graphDesc._inputFifoHandle);
+        for (auto fifo : graphDesc._inputFifoHandles) {
+            auto res = ncFifoDelete(fifo);
             if (res != NC_OK)
                 LOG_WARNING("ncFifoDelete result %s", ncStatusToStr(nullptr, res));
-            graphDesc._inputFifoHandle = nullptr;
         }
-        if (graphDesc._outputFifoHandle != nullptr) {
-            auto res = ncFifoDelete(graphDesc._outputFifoHandle);
+        graphDesc._inputFifoHandles.clear();
+        for (auto fifo : graphDesc._outputFifoHandles) {
+            auto res = ncFifoDelete(fifo);
             if (res != NC_OK)
                 LOG_WARNING("ncFifoDelete result %s", ncStatusToStr(nullptr, res));
-            graphDesc._outputFifoHandle = nullptr;
         }
+        graphDesc._outputFifoHandles.clear();
         if (graphDesc._graphHandle != nullptr) {
             auto res = ncGraphDeallocate(graphDesc._graphHandle);
             if (res !=NC_OK) {
@@ -342,8 +601,30 @@ void MyriadExecutor::deallocateGraph(DevicePtr &device, GraphDesc &graphDesc) {
             graphDesc._graphHandle = nullptr;
         }
 
-        device->_executors -= 1;
+        releaseGraphSlot(device);
+    }
+}
+
+void MyriadExecutor::partitionCmxBuffer(const DevicePtr &device, BlobConfig &blobConfig) {
+    if (_graphSlot < 0 || device->_maxGraphs < 2) {
+        return;
     }
+    int slots = device->_maxGraphs;
+
+    // CMX buffers of the graphs must not overlap, the share is kept 1KB aligned
+    uint32_t cmxShare = (blobConfig.cmxBufferSize / slots) & ~1023u;
+    blobConfig.cmxBufferStart += _graphSlot * cmxShare;
+    blobConfig.cmxBufferSize = cmxShare;
+
+    // so are the SHAVEs, the graphs share them in turn when there are fewer SHAVEs than slots
+    uint16_t shaves = blobConfig.lastShave - blobConfig.firstShave + 1;
+    uint16_t shaveShare = std::max(shaves / slots, 1);
+    blobConfig.firstShave += (_graphSlot * shaveShare) % shaves;
+    blobConfig.lastShave = blobConfig.firstShave + shaveShare - 1;
+
+    LOG_INFO("[VPU] graph slot %d of %d: CMX buffer %u bytes at %u, SHAVEs %u-%u",
+             _graphSlot, slots, blobConfig.cmxBufferSize, blobConfig.cmxBufferStart,
+             blobConfig.firstShave, blobConfig.lastShave);
 }
 
 MyriadExecutor::~MyriadExecutor() {
@@ -383,39 +664,27 @@ const char *MyriadExecutor::ncStatusToStr(graphHandle_t *graphHandle, ncStatus_t
 #undef MVNC_STATUS_TO_STR
 }
 
-void MyriadExecutor::printThrottlingStatus() {
-// TODO: enable when needed
-#if 0
-    unsigned int thermal_stats_len = 0;
-    float* thermal_stats;
-    auto status = ncDeviceGetOption(_deviceHandle, NC_OPTION_CLASS0,
-                                    NC_RO_DEVICE_THERMAL_STATS,
-                                    reinterpret_cast<void **>(&thermal_stats),
-                                    &thermal_stats_len);
-    int throttling = static_cast<int>(thermal_stats[0]);
-
-    if (status != NC_OK) {
-        LOG_WARNING("WARNING: Failed to get Throttling and Thermal information with error: %s",
-                    ncStatusToStr(nullptr, status));
-    } else {
-        if (throttling == 0) {
-            LOG_INFO("** Device %d temperature normal (%.1lf C) **",
-                     _deviceIdx, thermal_stats[1]);
-        } else if (throttling == 1) {
-            LOG_INFO("** Device %d temperature high (%.1lf C) - thermal throttling initiated **",
-                     _deviceIdx, thermal_stats[1]);
-        } else if (throttling == 2) {
-            LOG_WARNING("*********************** WARNING *************************\n"\
-                        "  Device %d temperature critical (%.1lf C)\n"               \
-                        "  Aggressive thermal throttling initiated\n"                \
-                        "  Continued use may result in device damage\n"              \
-                        "*********************************************************",
-                        _deviceIdx, thermal_stats[1]);
-        }
+void MyriadExecutor::printThrottlingStatus(const DevicePtr &device, const ThermalStatus &status) {
+    if (status.throttlingLevel == 0) {
+        LOG_INFO("** Device %d temperature normal (%.1lf C) **",
+                 device->_deviceIdx, status.temperature);
+    } else if (status.throttlingLevel == 1) {
+        LOG_INFO("** Device %d temperature high (%.1lf C) - thermal throttling initiated **",
+                 device->_deviceIdx, status.temperature);
+    } else if (status.throttlingLevel == 2) {
+        LOG_WARNING("*********************** WARNING *************************\n"\
+                    "  Device %d temperature critical (%.1lf C)\n"               \
+                    "  Aggressive thermal throttling initiated\n"                \
+                    "  Continued use may result in device damage\n"              \
+                    "*********************************************************",
+                    device->_deviceIdx, status.temperature);
     }
-#endif
 }
 
 std::shared_ptr<GraphInfo<float>> MyriadExecutor::getPerfTimeInfo(graphHandle_t *graphHandle) {
+    // the graphs attached through ncs_residencyd have no handle in the plugin
+    if (graphHandle == nullptr) {
+        return std::make_shared<GraphInfo<float>>(std::vector<float>());
+    }
     return getGraphInfo<float>(graphHandle, NC_OPTION_CLASS0, NC_RO_GRAPH_TIME_TAKEN);
 }
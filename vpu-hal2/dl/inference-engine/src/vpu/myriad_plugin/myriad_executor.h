@@ -31,27 +31,23 @@
 
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <vector>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <condition_variable>
 #include <mvnc.h>
+#include <ncResidency.h>
 #include <iomanip>
 #include <environment.h>
 #include <IExecutor.h>
+#include "myriad_thermal_monitor.h"
 
 namespace VPU {
 namespace MyriadPlugin {
 
-struct GraphDesc {
-    graphHandle_t *_graphHandle = nullptr;
-
-    ncTensorDescriptor_t *_inputDesc = nullptr;
-    ncTensorDescriptor_t *_outputDesc = nullptr;
-
-    fifoHandle_t *_inputFifoHandle = nullptr;
-    fifoHandle_t *_outputFifoHandle = nullptr;
-};
-
 #define DEVICE_MAX_GRAPHS 2
 
 struct DeviceDesc {
@@ -59,19 +55,84 @@ struct DeviceDesc {
     int _platform = UNKNOWN_DEVICE;
     int _deviceIdx = -1;
     deviceHandle_t *_deviceHandle = nullptr;
+
+    // Graphs the device takes, and a bit per slot used by a loaded graph
+    int _maxGraphs = DEVICE_MAX_GRAPHS;
+    uint32_t _graphSlots = 0;
+
+    // The devices of ncs_residencyd, which places the graphs itself (no device handle)
+    bool _residency = false;
 };
 
 typedef std::shared_ptr<DeviceDesc> DevicePtr;
 
+#define RESIDENCY_SLOTS 4
+
+// Graph kept resident by ncs_residencyd. The inferences in flight use the shared memory
+// slots in turn, the outputs are read in the order of the inferences like from the FIFOs.
+struct ResidencyAttachment {
+    ncResidencyGraph_t *_graph = nullptr;
+
+    std::mutex _mutex;
+    std::condition_variable _slotFreed;
+    std::deque<unsigned int> _freeSlots;
+
+    // Slot of the inference the outputs are read from
+    unsigned int _resultSlot = 0;
+};
+
+struct GraphDesc {
+    graphHandle_t *_graphHandle = nullptr;
+    DevicePtr _device;
+
+    // Tensors reported by the device: one per blob input (output) in the order of their offsets
+    // (Environment::blobInputs), or a single tensor all the inputs (outputs) are packed to
+    std::vector<ncTensorDescriptor_t> _inputDesc;
+    std::vector<ncTensorDescriptor_t> _outputDesc;
+
+    // FIFO per tensor
+    std::vector<fifoHandle_t *> _inputFifoHandles;
+    std::vector<fifoHandle_t *> _outputFifoHandles;
+
+    // Set instead of the graph handle and the FIFOs on a device of ncs_residencyd
+    std::shared_ptr<ResidencyAttachment> _residency;
+};
+
 
 class MyriadExecutor {
     Common::LoggerPtr _log;
 
+    ThermalMonitorPtr _thermalMonitor;
+    Common::ThermalPolicy _thermalPolicy = Common::ThermalPolicy::None;
+    std::atomic<int> _lastThrottlingLevel{0};
+
+    // Slot of the graph of the executor on its device
+    int _graphSlot = -1;
+
+    DevicePtr &acquireGraphSlot(DevicePtr &device);
+    void releaseGraphSlot(const DevicePtr &device);
+
+    void attachResidentGraph(GraphDesc &graphDesc, const std::vector<char> &graphFileContent);
+    void queueResidentInference(GraphDesc &graphDesc, const std::vector<const void *> &input_data,
+                                const std::vector<size_t> &input_bytes);
+    void getResidentResult(GraphDesc &graphDesc, size_t output_idx, void *result_data);
+    static void releaseResidentSlot(ResidencyAttachment &residency, unsigned int slot);
+
 public:
     MyriadExecutor(const Common::LogLevel& vpuLogLevel, const Common::LoggerPtr& log);
     ~MyriadExecutor();
 
-    DevicePtr openDevice(std::vector<DevicePtr> &devicePool);
+    // Devices are sampled by the monitor, which drives the policy of openDevice and queueInference
+    void setThermalPolicy(const ThermalMonitorPtr &thermalMonitor, Common::ThermalPolicy thermalPolicy);
+
+    // With useResidencyDaemon the graph is attached through ncs_residencyd if it is running,
+    // the returned device is not added to devicePool then
+    DevicePtr openDevice(std::vector<DevicePtr> &devicePool, int graphsPerDevice = DEVICE_MAX_GRAPHS,
+                         bool useResidencyDaemon = false);
+
+    // Narrows the CMX buffer and SHAVE ranges of blobConfig to the share of the graph slot, so that
+    // the graphs of the device don't compete for them. The blob carries the number of SHAVEs.
+    void partitionCmxBuffer(const DevicePtr &device, BlobConfig &blobConfig);
 
     static void closeDevices(std::vector<DevicePtr> &devicePool);
 
@@ -79,16 +140,18 @@ public:
 
     void deallocateGraph(DevicePtr &device, GraphDesc &graphDesc);
 
-    void queueInference(GraphDesc &graphDesc, void *input_data, size_t input_bytes,
-                        void **result_data, size_t *result_bytes);
+    // Writes a buffer per input tensor to its FIFO and queues the inference
+    void queueInference(GraphDesc &graphDesc, const std::vector<const void *> &input_data,
+                        const std::vector<size_t> &input_bytes);
 
-    void getResult(GraphDesc &graphDesc, void **result_data, size_t *result_bytes);
+    // Reads the next result of the output tensor directly to result_data
+    void getResult(GraphDesc &graphDesc, size_t output_idx, void *result_data, size_t result_bytes);
 
     const char *ncStatusToStr(graphHandle_t *graphHandle, ncStatus_t status);
 
     std::shared_ptr<Common::GraphInfo<float>> getPerfTimeInfo(graphHandle_t *graphHandle);
 
-    void printThrottlingStatus();
+    void printThrottlingStatus(const DevicePtr &device, const ThermalStatus &status);
 
     template<typename T>
     std::shared_ptr<Common::GraphInfo<T>> getGraphInfo(graphHandle_t *graphHandle, ncOptionClass_t opClass, int graphOption) {
@@ -101,7 +164,8 @@ public:
             graphInfoLen = 0;
         }
         graphInfoLen /= sizeof(T);
-        return std::make_shared<Common::GraphInfo<T>>(graphInfo, graphInfoLen);
+        // copied, the next query of the graph overwrites the data
+        return std::make_shared<Common::GraphInfo<T>>(std::vector<T>(graphInfo, graphInfo + graphInfoLen));
     }
 };
 
@@ -29,6 +29,7 @@
 // this notice or any other notice embedded in Materials by Intel or Intel's
 // suppliers or licensors in any way.
 
+#include <algorithm>
 #include <ie_blob.h>
 #include <ie_plugin.hpp>
 #include <description_buffer.hpp>
@@ -36,6 +37,9 @@
 #include <ie_layouts.h>
 
 #include "precision_utils.h"
+#include "pool_allocator.hpp"
+#include "blob_transform.hpp"
+#include "ie_trace.hpp"
 #include "myriad_executable_network.h"
 #include "myriad_infer_request.h"
 #include "common.h"
@@ -49,6 +53,58 @@ using namespace VPU::Common;
 using namespace VPU::MyriadPlugin;
 using namespace InferenceEngine;
 
+template<class T>
+static Blob::Ptr createBlob(Precision precision, Layout layout, const SizeVector &dims,
+                            const std::shared_ptr<IAllocator> &allocator) {
+    if (allocator) {
+        return std::make_shared<TBlob<T>>(precision, layout, dims, allocator);
+    }
+    return InferenceEngine::make_shared_blob<T, const SizeVector>(precision, layout, dims);
+}
+
+// The network inputs (outputs) are found in the blob by name, the device holds them in the order
+// of the blob, one per tensor or all packed to a single one
+static void checkBlobData(const std::vector<VPU::BlobDataInfo> &blobData, const std::vector<ncTensorDescriptor_t> &deviceDesc,
+                          const BlobMap &blobs, const char *kind) {
+    if (blobData.size() != blobs.size()) {
+        THROW_IE_EXCEPTION << "Graph has " << blobData.size() << " " << kind << "s, network has " << blobs.size();
+    }
+    for (const auto &info : blobData) {
+        if (blobs.find(info.name) == blobs.end()) {
+            THROW_IE_EXCEPTION << "Network has no " << kind << " " << info.name << " of the graph";
+        }
+    }
+
+    if (deviceDesc.size() == blobData.size()) {
+        for (size_t i = 0; i < blobData.size(); ++i) {
+            if (deviceDesc[i].totalSize != blobData[i].size) {
+                THROW_IE_EXCEPTION << "Device " << kind << " tensor " << i << " has " << deviceDesc[i].totalSize
+                                   << " bytes, " << kind << " " << blobData[i].name << " has " << blobData[i].size;
+            }
+        }
+    } else if (deviceDesc.size() == 1) {
+        size_t packedSize = 0;
+        for (const auto &info : blobData) {
+            packedSize = std::max(packedSize, static_cast<size_t>(info.offset) + info.size);
+        }
+        if (deviceDesc[0].totalSize != packedSize) {
+            THROW_IE_EXCEPTION << "Device " << kind << " tensor has " << deviceDesc[0].totalSize
+                               << " bytes, the packed " << kind << "s of the graph have " << packedSize;
+        }
+    } else {
+        THROW_IE_EXCEPTION << "Device has " << deviceDesc.size() << " " << kind << " tensors, graph has "
+                           << blobData.size() << " " << kind << "s";
+    }
+}
+
+// The blob of the request must have the size of the graph data
+static void checkBlobSize(const Blob::Ptr &blob, const VPU::BlobDataInfo &info, const char *kind) {
+    if (blob->byteSize() != info.size) {
+        THROW_IE_EXCEPTION << PARAMETER_MISMATCH_str << "Blob of " << kind << " " << info.name << " has "
+                           << blob->byteSize() << " bytes, the graph expects " << info.size;
+    }
+}
+
 MyriadInferRequest::MyriadInferRequest(GraphDesc &graphDesc,
                                         InferenceEngine::InputsDataMap networkInputs,
                                         InferenceEngine::OutputsDataMap networkOutputs,
@@ -62,6 +118,13 @@ MyriadInferRequest::MyriadInferRequest(GraphDesc &graphDesc,
 
     _deviceLayout = _env->parsedConfig.blobConfig.hwOptimization ? NCHW : NHWC;
 
+    // the default allocator of the blobs if none
+    std::shared_ptr<IAllocator> allocator;
+    if (_env->parsedConfig.blobAllocator != BlobAllocator::System) {
+        bool pinned = _env->parsedConfig.blobAllocator == BlobAllocator::PoolPinned;
+        allocator = shared_from_irelease(new PoolAllocator(pinned));
+    }
+
     // allocate inputs
     for (auto &networkInput : _networkInputs) {
       #ifdef NNLOG
@@ -75,13 +138,13 @@ MyriadInferRequest::MyriadInferRequest(GraphDesc &graphDesc,
         Blob::Ptr inputBlob;
         switch (precision) {
             case Precision::FP32:
-                inputBlob = InferenceEngine::make_shared_blob<float, const SizeVector>(Precision::FP32, layout, dims);
+                inputBlob = createBlob<float>(Precision::FP32, layout, dims, allocator);
                 break;
             case Precision::FP16:
-                inputBlob = InferenceEngine::make_shared_blob<ie_fp16, const SizeVector>(Precision::FP16, layout, dims);
+                inputBlob = createBlob<ie_fp16>(Precision::FP16, layout, dims, allocator);
                 break;
             case Precision::U8:
-                inputBlob = InferenceEngine::make_shared_blob<uint8_t, const SizeVector>(Precision::U8, layout, dims);
+                inputBlob = createBlob<uint8_t>(Precision::U8, layout, dims, allocator);
                 break;
             default:
                 THROW_IE_EXCEPTION << PARAMETER_MISMATCH_str << "Unsupported input precision: "
@@ -104,10 +167,10 @@ MyriadInferRequest::MyriadInferRequest(GraphDesc &graphDesc,
         Blob::Ptr outputBlob;
         switch (precision) {
             case Precision::FP32:
-                outputBlob = InferenceEngine::make_shared_blob<float, const SizeVector>(Precision::FP32, layout, dims);
+                outputBlob = createBlob<float>(Precision::FP32, layout, dims, allocator);
                 break;
             case Precision::FP16:
-                outputBlob = InferenceEngine::make_shared_blob<ie_fp16, const SizeVector>(Precision::FP16, layout, dims);
+                outputBlob = createBlob<ie_fp16>(Precision::FP16, layout, dims, allocator);
                 break;
             default:
                 THROW_IE_EXCEPTION << PARAMETER_MISMATCH_str << "Unsupported output precision: "
@@ -120,6 +183,8 @@ MyriadInferRequest::MyriadInferRequest(GraphDesc &graphDesc,
     if (_networkOutputs.empty() || _networkInputs.empty()) {
         THROW_IE_EXCEPTION << "Internal error: no information about network's output/input";
     }
+    checkBlobData(_env->blobInputs, _graphDesc._inputDesc, _inputs, "input");
+    checkBlobData(_env->blobOutputs, _graphDesc._outputDesc, _outputs, "output");
 }
 
 void MyriadInferRequest::Infer() {
@@ -133,7 +198,7 @@ void MyriadInferRequest::InferAsync() {
   printf("myriad InferAsync\n");
 #endif
   //LOG_DEBUG(" myriad InferAsync");
-
+    IE_TRACE_SCOPE("plugin", "PrepareInputs")
 
     for (auto input : _inputs) {
         auto const inputBlobPtr = input.second;
@@ -149,124 +214,97 @@ void MyriadInferRequest::InferAsync() {
             THROW_IE_EXCEPTION << PARAMETER_MISMATCH_str << "Unsupported output blob precision";
     }
 
-    std::vector<uint8_t> tmpMemory;
-    Blob::Ptr tmpBlob;
-
-    void* inputPtr = nullptr;
-    size_t inputSize = 0;
+    // in the order of the graph inputs
+    const auto& blobInputs = _env->blobInputs;
+    std::vector<const void *> inputPtrs;
+    std::vector<size_t> inputSizes;
 
-    if (_inputs.size() > 1) {
-        inputSize = 0;
-        for (auto input : _inputs) {
-            auto const inputBlobPtr = input.second;
-            size_t byteSize = inputBlobPtr->size() * inputBlobPtr->element_size();
-            inputSize += byteSize;
-        }
+    for (const auto& info : blobInputs) {
+        auto inputBlobPtr = _inputs.at(info.name);
+        checkBlobSize(inputBlobPtr, info, "input");
 
-        tmpMemory.resize(inputSize);
-        auto dst = tmpMemory.data();
-
-        for (auto input : _inputs) {
-            auto inputBlobPtr = input.second;
-            size_t byteSize = inputBlobPtr->size() * inputBlobPtr->element_size();
-            Layout layout = inputBlobPtr->getTensorDesc().getLayout();
-            if (layout != _deviceLayout && (layout == NCHW || layout == NHWC)) {
-                switch (inputBlobPtr->precision()) {
-                    case Precision::U8:
-                        ConvertBlobToLayout<uint8_t>(_deviceLayout, inputBlobPtr);
-                        break;
-                    case Precision::FP16:
-                        ConvertBlobToLayout<ie_fp16>(_deviceLayout, inputBlobPtr);
-                        break;
-                    case Precision::FP32:
-                        ConvertBlobToLayout<float>(_deviceLayout, inputBlobPtr);
-                        break;
-                    default:
-                        THROW_IE_EXCEPTION << "unsupported blob precision for converting layout";
-                        break;
-                }
-            }
-            memcpy(dst, inputBlobPtr->buffer(), byteSize);
-            dst += byteSize;
+        const auto& desc = inputBlobPtr->getTensorDesc();
+        Layout layout = desc.getLayout();
+        if (layout != _deviceLayout && (layout == NCHW || layout == NHWC)) {
+            IE_TRACE_SCOPE("plugin", "ConvertLayout")
+            auto& converted = _convertedInputs[info.name];
+            converted.resize(inputBlobPtr->byteSize());
+            BlobTransform::convert(desc, inputBlobPtr->cbuffer(),
+                                   TensorDesc(desc.getPrecision(), desc.getDims(), _deviceLayout), converted.data());
+            inputPtrs.push_back(converted.data());
+        } else {
+            inputPtrs.push_back(inputBlobPtr->buffer());
         }
+        inputSizes.push_back(info.size);
+    }
 
-        inputPtr = tmpMemory.data();
-    } else {
-        auto dataName = _networkInputs.begin()->first;
-        auto foundInputBlob = _inputs.find(dataName);
-        if (foundInputBlob == _inputs.end())
-            THROW_IE_EXCEPTION << "Error: input [" << dataName << "] is not provided.";
-
-        tmpBlob = foundInputBlob->second;
-        size_t byteSize = tmpBlob->size() * tmpBlob->element_size();
-        Layout layout = tmpBlob->getTensorDesc().getLayout();
-        if (layout != _deviceLayout && (layout == NCHW || layout == NHWC)) {
-            switch (tmpBlob->precision()) {
-                case Precision::U8:
-                    ConvertBlobToLayout<uint8_t>(_deviceLayout, tmpBlob);
-                    break;
-                case Precision::FP16:
-                    ConvertBlobToLayout<ie_fp16>(_deviceLayout, tmpBlob);
-                    break;
-                case Precision::FP32:
-                    ConvertBlobToLayout<float>(_deviceLayout, tmpBlob);
-                    break;
-                default:
-                    THROW_IE_EXCEPTION << "unsupported blob precision for converting layout";
-                    break;
-            }
+    // The graph of the blob has a single input the inputs are packed to at their offsets
+    if (_graphDesc._inputDesc.size() != inputPtrs.size()) {
+        _inputBuffer.resize(_graphDesc._inputDesc[0].totalSize);
+        for (size_t i = 0; i < inputPtrs.size(); ++i) {
+            memcpy(_inputBuffer.data() + blobInputs[i].offset, inputPtrs[i], inputSizes[i]);
         }
 
-        inputPtr = tmpBlob->buffer();
-        inputSize = byteSize;
+        inputPtrs.assign(1, _inputBuffer.data());
+        inputSizes.assign(1, _inputBuffer.size());
     }
 
-    _executor->queueInference(_graphDesc, inputPtr, inputSize, nullptr, nullptr);
+    _executor->queueInference(_graphDesc, inputPtrs, inputSizes);
+}
+
+static bool needLayoutConversion(const Blob::Ptr &blob, Layout deviceLayout) {
+    Layout layout = blob->getTensorDesc().getLayout();
+    SizeVector dims = blob->getTensorDesc().getDims();
+    return layout != deviceLayout && (layout == NCHW || layout == NHWC)
+        && (dims[0] != 1 || dims[1] != 1) && (dims[2] != 1 || dims[3] != 1);
+}
+
+// Copies the output in the device layout to the blob
+void MyriadInferRequest::copyResult(const Blob::Ptr &outputBlobPtr, uint8_t *resultPtr) {
+    IE_TRACE_SCOPE("plugin", "CopyResult")
+    if (needLayoutConversion(outputBlobPtr, _deviceLayout)) {
+        const auto& desc = outputBlobPtr->getTensorDesc();
+        if (desc.getPrecision() != Precision::FP32 && desc.getPrecision() != Precision::FP16) {
+            THROW_IE_EXCEPTION << PARAMETER_MISMATCH_str << "Unsupported output precision: "
+                               << outputBlobPtr->precision() << "! Supported precisions: FP32, FP16";
+        }
+        // converted straight from the device result, with no intermediate blob
+        BlobTransform::convert(TensorDesc(desc.getPrecision(), desc.getDims(), _deviceLayout), resultPtr,
+                               desc, outputBlobPtr->buffer());
+    } else {
+        memcpy(outputBlobPtr->buffer(), resultPtr, outputBlobPtr->byteSize());
+    }
 }
 
 void MyriadInferRequest::GetResult() {
-    void *resultPtr = NULL;
-    size_t resultSize = 0;
+    // in the order of the graph outputs
+    const auto& blobOutputs = _env->blobOutputs;
+    for (const auto& info : blobOutputs) {
+        checkBlobSize(_outputs.at(info.name), info, "output");
+    }
 
-    _executor->getResult(_graphDesc, &resultPtr, &resultSize);
+    // The graph of the blob has a single output the outputs are packed to at their offsets
+    if (_graphDesc._outputDesc.size() != blobOutputs.size()) {
+        _resultBuffer.resize(_graphDesc._outputDesc[0].totalSize);
+        _executor->getResult(_graphDesc, 0, _resultBuffer.data(), _resultBuffer.size());
 
-    size_t resultOffset = 0;
-    for (auto pp : _outputs) {
-        if (resultOffset > resultSize) {
-            THROW_IE_EXCEPTION << "unexpected result data size";
+        for (const auto& info : blobOutputs) {
+            copyResult(_outputs.at(info.name), _resultBuffer.data() + info.offset);
         }
-        auto const outputBlobPtr = pp.second;
-        Layout layout = outputBlobPtr->getTensorDesc().getLayout();
-        SizeVector dims = outputBlobPtr->getTensorDesc().getDims();
-        if (layout != _deviceLayout && (layout == NCHW || layout == NHWC)
-            && (dims[0] != 1 || dims[1] != 1) && (dims[2] != 1 || dims[3] != 1)) {
-            Blob::Ptr tmpBlob = nullptr;
-            switch (outputBlobPtr->precision()) {
-            case Precision::FP32:
-                tmpBlob = InferenceEngine::make_shared_blob<float>(Precision::FP32, _deviceLayout, outputBlobPtr->dims(),
-                                                                   reinterpret_cast<float *>(reinterpret_cast<uint8_t *>(resultPtr) + resultOffset));
-                ConvertBlobToLayout<float>(layout, tmpBlob);
-                break;
-            case Precision::FP16:
-                tmpBlob = InferenceEngine::make_shared_blob<ie_fp16>(Precision::FP16, _deviceLayout, outputBlobPtr->dims(),
-                                                                     reinterpret_cast<short *>(reinterpret_cast<uint8_t *>(resultPtr) + resultOffset));
-                ConvertBlobToLayout<ie_fp16>(layout, tmpBlob);
-                break;
-            default:
-                THROW_IE_EXCEPTION << PARAMETER_MISMATCH_str << "Unsupported output precision: "
-                                   << outputBlobPtr->precision() << "! Supported precisions: FP32, FP16";
+    } else {
+        // Outputs in the device layout are read directly to the blobs
+        for (size_t outputIdx = 0; outputIdx < blobOutputs.size(); ++outputIdx) {
+            auto const outputBlobPtr = _outputs.at(blobOutputs[outputIdx].name);
+            size_t resultSize = blobOutputs[outputIdx].size;
+            if (!needLayoutConversion(outputBlobPtr, _deviceLayout)) {
+                _executor->getResult(_graphDesc, outputIdx, outputBlobPtr->buffer(), resultSize);
+            } else {
+                _resultBuffer.resize(resultSize);
+                _executor->getResult(_graphDesc, outputIdx, _resultBuffer.data(), resultSize);
+                copyResult(outputBlobPtr, _resultBuffer.data());
             }
-            memcpy(outputBlobPtr->buffer(), tmpBlob->cbuffer(), outputBlobPtr->byteSize());
-        } else {
-            memcpy(outputBlobPtr->buffer(), reinterpret_cast<uint8_t *>(resultPtr) + resultOffset, outputBlobPtr->byteSize());
         }
-
-        resultOffset += outputBlobPtr->byteSize();
     }
-
-#if 0
-    _executor->printThrottlingStatus();
-#endif
 }
 
 void MyriadInferRequest::GetPerformanceCounts(std::map<std::string, InferenceEngineProfileInfo> &perfMap) const {
@@ -52,6 +52,15 @@ class MyriadInferRequest : public InferenceEngine::InferRequestInternal {
 
     GraphDesc _graphDesc;
 
+    // Packed inputs/outputs of the graphs with a single input/output tensor,
+    // and outputs converted from the device layout
+    std::vector<uint8_t> _inputBuffer;
+    std::vector<uint8_t> _resultBuffer;
+    // Inputs converted to the device layout, reused by the next requests
+    std::map<std::string, std::vector<uint8_t>> _convertedInputs;
+
+    void copyResult(const InferenceEngine::Blob::Ptr &outputBlobPtr, uint8_t *resultPtr);
+
 public:
     typedef std::shared_ptr<MyriadInferRequest> Ptr;
 
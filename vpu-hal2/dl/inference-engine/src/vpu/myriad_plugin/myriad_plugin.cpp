@@ -93,7 +93,24 @@ if (supportedDevice == InferenceEngine::TargetDevice::eMYRIAD)
     for (auto i = config.begin(); i != config.end(); i++) {
         configCopy[i->first] = i->second;
     }
-    return std::make_shared<ExecutableNetwork>(network, _devicePool, configCopy);
+
+    auto thermalPolicy = Common::ParsedConfig::parseThermalPolicy(configCopy[VPU_CONFIG_KEY(THERMAL_POLICY)]);
+    if (thermalPolicy != Common::ThermalPolicy::None && !_thermalMonitor) {
+        // the sample period and the temperature target are the ones of this network
+        Common::ParsedConfig::validate(configCopy);
+        _thermalMonitor = std::make_shared<ThermalMonitor>(
+                std::chrono::milliseconds(std::stoi(configCopy[VPU_CONFIG_KEY(THERMAL_SAMPLE_PERIOD_MS)])),
+                std::stof(configCopy[VPU_CONFIG_KEY(THERMAL_TARGET)]));
+        for (auto &device : _devicePool) {
+            if (device->_deviceHandle != nullptr) {
+                _thermalMonitor->addDevice(device->_deviceHandle);
+            }
+        }
+    }
+    auto graphsPerDevice = Common::ParsedConfig::parseGraphsPerDevice(configCopy[VPU_CONFIG_KEY(GRAPHS_PER_DEVICE)]);
+    auto useResidencyDaemon = configCopy[VPU_CONFIG_KEY(RESIDENCY_DAEMON)] == CONFIG_VALUE(YES);
+    return std::make_shared<ExecutableNetwork>(network, _devicePool, _thermalMonitor, thermalPolicy,
+                                               graphsPerDevice, useResidencyDaemon, configCopy);
 }
 
 void Engine::SetConfig(const std::map<std::string, std::string> &config) {
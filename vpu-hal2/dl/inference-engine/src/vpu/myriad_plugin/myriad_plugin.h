@@ -55,11 +55,16 @@ public:
 
 
     ~Engine() {
+        if (_thermalMonitor) {
+            _thermalMonitor->stop();
+        }
         MyriadExecutor::closeDevices(_devicePool);
     }
 
 private:
     std::vector<DevicePtr> _devicePool;
+    // created by the first network loaded with a thermal policy, samples all the devices from then on
+    ThermalMonitorPtr _thermalMonitor;
 };
 
 }  // namespace MyriadPlugin
@@ -0,0 +1,183 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2017 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+
+#include <algorithm>
+#include <utility>
+
+#include "myriad_thermal_monitor.h"
+
+using namespace VPU::MyriadPlugin;
+
+namespace {
+
+// Pacing control: the submission interval of a device doubles (from the step) at each
+// sample above the target or throttled, and halves once the device is back under the
+// target by the hysteresis
+const std::chrono::microseconds PACE_STEP(1000);
+const std::chrono::microseconds PACE_MAX_INTERVAL(200000);
+const float PACE_HYSTERESIS = 2.f;
+
+}  // namespace
+
+ThermalMonitor::ThermalMonitor(std::chrono::milliseconds samplePeriod, float targetTemperature) :
+        _samplePeriod(samplePeriod), _targetTemperature(targetTemperature) {
+    _thread = std::thread(&ThermalMonitor::samplingLoop, this);
+}
+
+ThermalMonitor::~ThermalMonitor() {
+    stop();
+}
+
+void ThermalMonitor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wakeUp.notify_all();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void ThermalMonitor::addDevice(deviceHandle_t *device) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_stop || !_devices.emplace(device, DeviceState()).second) {
+            return;
+        }
+    }
+    sample(device);
+}
+
+ThermalStatus ThermalMonitor::getStatus(deviceHandle_t *device) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _devices.find(device);
+    return it == _devices.end() ? ThermalStatus() : it->second.status;
+}
+
+size_t ThermalMonitor::selectCoolest(const std::vector<deviceHandle_t *> &devices) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto key = [this](deviceHandle_t *device) {
+        auto it = _devices.find(device);
+        if (it == _devices.end() || !it->second.status.valid) {
+            return std::make_pair(0, 0.f);
+        }
+        return std::make_pair(it->second.status.throttlingLevel, it->second.status.temperature);
+    };
+    size_t coolest = 0;
+    for (size_t i = 1; i < devices.size(); i++) {
+        if (key(devices[i]) < key(devices[coolest])) {
+            coolest = i;
+        }
+    }
+    return coolest;
+}
+
+void ThermalMonitor::pace(deviceHandle_t *device) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto it = _devices.find(device);
+    if (it == _devices.end()) {
+        return;
+    }
+    auto &state = it->second;
+    auto now = std::chrono::steady_clock::now();
+    auto slot = std::max(now, state.nextSubmission);
+    state.nextSubmission = slot + state.status.submissionInterval;
+    if (slot == now) {
+        return;
+    }
+    state.status.pacedSubmissions++;
+    state.status.pacedTime += std::chrono::duration_cast<std::chrono::microseconds>(slot - now);
+    lock.unlock();
+    std::this_thread::sleep_until(slot);
+}
+
+void ThermalMonitor::sample(deviceHandle_t *device) {
+    int throttlingLevel = 0;
+    float temperature = 0.f;
+    bool ok;
+    {
+        std::lock_guard<std::mutex> lock(_sampleMutex);
+        unsigned int length = sizeof(throttlingLevel);
+        ok = ncDeviceGetOption(device, NC_OPTION_CLASS0, NC_RO_DEVICE_THERMAL_THROTTLING_LEVEL,
+                               &throttlingLevel, &length) == NC_OK;
+        float *stats = nullptr;
+        length = 0;
+        ok = ok && ncDeviceGetOption(device, NC_OPTION_CLASS0, NC_RO_DEVICE_THERMAL_STATS,
+                                     reinterpret_cast<void *>(&stats), &length) == NC_OK;
+        if (ok && stats != nullptr && length >= sizeof(float)) {
+            temperature = stats[0];
+        } else {
+            ok = false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _devices.find(device);
+    if (it == _devices.end()) {
+        return;
+    }
+    auto &status = it->second.status;
+    if (!ok) {
+        status.failedSamples++;
+        return;
+    }
+    status.valid = true;
+    status.temperature = temperature;
+    status.maxTemperature = status.samples == 0 ? temperature : std::max(status.maxTemperature, temperature);
+    status.throttlingLevel = throttlingLevel;
+    status.samples++;
+    if (throttlingLevel != 0) {
+        status.throttledSamples++;
+    }
+
+    auto &interval = status.submissionInterval;
+    if (throttlingLevel != 0 || temperature > _targetTemperature) {
+        interval = std::min(interval.count() == 0 ? PACE_STEP : interval * 2, PACE_MAX_INTERVAL);
+    } else if (temperature < _targetTemperature - PACE_HYSTERESIS) {
+        interval = interval < 2 * PACE_STEP ? std::chrono::microseconds(0) : interval / 2;
+    }
+}
+
+void ThermalMonitor::samplingLoop() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_wakeUp.wait_for(lock, _samplePeriod, [this] { return _stop; })) {
+        std::vector<deviceHandle_t *> devices;
+        for (auto &device : _devices) {
+            devices.push_back(device.first);
+        }
+        lock.unlock();
+        for (auto device : devices) {
+            sample(device);
+        }
+        lock.lock();
+    }
+}
@@ -0,0 +1,117 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2017 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <mvnc.h>
+
+namespace VPU {
+namespace MyriadPlugin {
+
+// Last thermal sample of a device and the counters of the monitor
+struct ThermalStatus {
+    bool valid = false;             // the device has been sampled at least once
+    float temperature = 0.f;        // degrees C, first reading of NC_RO_DEVICE_THERMAL_STATS
+    float maxTemperature = 0.f;
+    int throttlingLevel = 0;        // 0 normal, 1 TEMP_LIM_LOWER and 2 TEMP_LIM_HIGHER reached
+
+    uint64_t samples = 0;
+    uint64_t throttledSamples = 0;  // samples with a non zero throttling level
+    uint64_t failedSamples = 0;
+
+    // Pacing: minimal interval between two submissions to the device, and what it has cost
+    std::chrono::microseconds submissionInterval{0};
+    uint64_t pacedSubmissions = 0;
+    std::chrono::microseconds pacedTime{0};
+};
+
+// Samples the temperature and the throttling level of the registered devices
+// periodically on its own thread. The samples drive two scheduling policies:
+// selectCoolest() picks the device new load should go to, and pace() spaces the
+// submissions to a device so that it stays under the temperature target.
+// The monitor only depends on mvnc, the devices must stay open until stop().
+class ThermalMonitor {
+public:
+    ThermalMonitor(std::chrono::milliseconds samplePeriod, float targetTemperature);
+    ~ThermalMonitor();
+
+    // Starts sampling the device, the first sample is taken before returning
+    void addDevice(deviceHandle_t *device);
+
+    // Stops the sampling thread, must be called before the devices are closed
+    void stop();
+
+    ThermalStatus getStatus(deviceHandle_t *device) const;
+
+    // Index of the device with the lowest throttling level, then the lowest
+    // temperature. Devices which have not been sampled yet count as cold.
+    // The plugin only calls it when a network is loaded.
+    size_t selectCoolest(const std::vector<deviceHandle_t *> &devices) const;
+
+    // Blocks until the next submission slot of the device
+    void pace(deviceHandle_t *device);
+
+    float targetTemperature() const { return _targetTemperature; }
+
+private:
+    struct DeviceState {
+        ThermalStatus status;
+        std::chrono::steady_clock::time_point nextSubmission;
+    };
+
+    void sample(deviceHandle_t *device);
+    void samplingLoop();
+
+    const std::chrono::milliseconds _samplePeriod;
+    const float _targetTemperature;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _wakeUp;
+    std::map<deviceHandle_t *, DeviceState> _devices;
+    bool _stop = false;
+
+    // serializes the device reads of addDevice() and of the sampling thread
+    std::mutex _sampleMutex;
+    std::thread _thread;
+};
+
+typedef std::shared_ptr<ThermalMonitor> ThermalMonitorPtr;
+
+}  // namespace MyriadPlugin
+}  // namespace VPU
@@ -0,0 +1,120 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+// The inputs and outputs GraphTransformer reports for a blob, the plugins place the
+// network inputs and outputs in the device buffers by them.
+
+#include <set>
+#include <gtest/gtest.h>
+#include <reference_executor.hpp>
+#include "graph_transformer_test_utils.hpp"
+
+using namespace InferenceEngine;
+using namespace VPU::Tests;
+using VPU::Tools::NetworkBuilder;
+
+namespace {
+
+// The data are packed one after another in the order of their offsets
+template <class DataMap>
+void checkBlobData(const std::vector<VPU::BlobDataInfo>& blobData, const DataMap& networkData, uint32_t deviceSize) {
+    ASSERT_EQ(blobData.size(), networkData.size());
+
+    std::set<std::string> names;
+    uint32_t offset = 0;
+    for (const auto& info : blobData) {
+        auto it = networkData.find(info.name);
+        ASSERT_TRUE(it != networkData.end()) << info.name << " is not a network name";
+        ASSERT_TRUE(names.insert(info.name).second) << info.name << " is reported twice";
+
+        const auto& desc = it->second->getTensorDesc();
+        size_t size = desc.getPrecision().size();
+        for (auto dim : desc.getDims()) {
+            size *= dim;
+        }
+        ASSERT_EQ(info.size, size) << info.name;
+        ASSERT_EQ(info.offset, offset) << info.name;
+        offset += info.size;
+    }
+    ASSERT_EQ(offset, deviceSize);
+}
+
+void checkNetworkData(bool hw) {
+    NetworkBuilder builder("blob_data");
+    auto branch1 = builder.conv(builder.input(8, 8, 8), 8, 3, 1, 1);
+    auto branch2 = builder.conv(builder.input(4, 8, 8), 8, 1, 1, 0);
+    auto cur = builder.relu(builder.concat({branch1, branch2}));
+    builder.conv(cur, 8, 1, 1, 0);
+    builder.pool(cur, 2, 2, 0);
+
+    CNNNetReader reader;
+    builder.build(reader);
+    auto& network = reader.getNetwork();
+
+    auto inputsInfo = network.getInputsInfo();
+    auto outputsInfo = network.getOutputsInfo();
+    ASSERT_EQ(inputsInfo.size(), 2u);
+    ASSERT_EQ(outputsInfo.size(), 2u);
+
+    // different element sizes, the offsets and sizes are in bytes
+    inputsInfo.begin()->second->setPrecision(Precision::FP16);
+    inputsInfo.rbegin()->second->setPrecision(Precision::FP32);
+    outputsInfo.begin()->second->setPrecision(Precision::FP32);
+    outputsInfo.rbegin()->second->setPrecision(Precision::FP16);
+
+    std::map<std::string, std::string> config;
+    config[VPU_CONFIG_KEY(HW_STAGES_OPTIMIZATION)] = hw ? CONFIG_VALUE(YES) : CONFIG_VALUE(NO);
+    VPU::Common::ParsedConfig parsedConfig(MYRIAD_X, config);
+
+    auto log = std::make_shared<VPU::Common::Logger>();
+    log->init(VPU::Common::eLOGNONE);
+
+    auto transformer = VPU::createGraphTransformer(parsedConfig.blobConfig, log);
+    std::vector<char> blob;
+    std::vector<VPU::BlobMetaData> metaData;
+    size_t numStages = 0;
+    transformer->generate(network, blob, metaData, numStages);
+
+    VPU::BlobReferenceExecutor executor(blob);
+    checkBlobData(transformer->getInputsInfo(), inputsInfo, executor.inputSize());
+    checkBlobData(transformer->getOutputsInfo(), outputsInfo, executor.outputSize());
+}
+
+}  // namespace
+
+TEST(BlobData, InputsAndOutputs) {
+    checkNetworkData(false);
+}
+
+TEST(BlobData, HwInputsAndOutputs) {
+    checkNetworkData(true);
+}
@@ -0,0 +1,153 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+// Split/Slice/Concat views, which eliminateCopyStages aliases instead of copying,
+// must give the same result as the dense copies.
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include "graph_transformer_test_utils.hpp"
+
+using namespace InferenceEngine;
+using namespace VPU::Tests;
+using VPU::Tools::NetworkBuilder;
+
+namespace {
+
+void checkStridedViews(const NetworkBuilder& builder, bool hw, bool expectAliased) {
+    TestNetwork network(builder);
+
+    CompileOptions options;
+    options.platform = MYRIAD_X;
+    options.hw = hw;
+
+    auto aliased = network.compile(options);
+    auto numAliased = aliased.counter("eliminateCopyStages", "aliased_views");
+    if (expectAliased) {
+        ASSERT_TRUE(numAliased > 0) << "no view was aliased";
+    } else {
+        ASSERT_TRUE(numAliased == 0) << numAliased << " views were aliased";
+    }
+
+    options.allowStridedViews = false;
+
+    auto dense = network.compile(options);
+    ASSERT_TRUE(dense.counter("eliminateCopyStages", "aliased_views") == 0);
+
+    checkOutputsNear(network.infer(dense), network.infer(aliased), FP16_TOLERANCE);
+}
+
+// The Split/Slice parts are concatenated again, so the Concat copies read the views directly
+NetworkBuilder splitConcat(const char* splitType) {
+    NetworkBuilder builder(std::string("split_concat_") + splitType);
+    auto cur = builder.relu(builder.conv(builder.input(8, 16, 16), 16, 3, 1, 1));
+    auto parts = builder.split(cur, {4, 12}, splitType);
+    auto branch = builder.relu(builder.conv(parts[1], 8, 3, 1, 1));
+    builder.conv(builder.concat({branch, parts[0]}), 16, 1, 1, 0);
+    return builder;
+}
+
+// Concat of the Split parts in the other order reads and writes the views at once
+NetworkBuilder splitSwapConcat() {
+    NetworkBuilder builder("split_swap_concat");
+    auto cur = builder.relu(builder.conv(builder.input(8, 12, 12), 16, 3, 1, 1));
+    auto parts = builder.split(cur, {8, 8});
+    builder.conv(builder.concat({parts[1], parts[0]}), 8, 1, 1, 0);
+    return builder;
+}
+
+// Convolutions read the Split parts, they need dense inputs
+NetworkBuilder splitConvolutions() {
+    NetworkBuilder builder("split_convolutions");
+    auto cur = builder.relu(builder.conv(builder.input(8, 16, 16), 16, 3, 1, 1));
+    auto parts = builder.split(cur, {8, 8});
+    auto branch1 = builder.relu(builder.conv(parts[0], 8, 1, 1, 0));
+    auto branch2 = builder.relu(builder.conv(parts[1], 8, 3, 1, 1));
+    builder.conv(builder.concat({branch1, branch2}), 16, 1, 1, 0);
+    return builder;
+}
+
+}  // namespace
+
+TEST(EliminateCopy, SplitConcat) {
+    checkStridedViews(splitConcat("Split"), false, true);
+}
+
+TEST(EliminateCopy, SliceConcat) {
+    checkStridedViews(splitConcat("Slice"), false, true);
+}
+
+TEST(EliminateCopy, SplitSwapConcat) {
+    checkStridedViews(splitSwapConcat(), false, true);
+}
+
+TEST(EliminateCopy, SplitConvolutions) {
+    checkStridedViews(splitConvolutions(), false, false);
+}
+
+TEST(EliminateCopy, HwSplitConvolutions) {
+    checkStridedViews(splitConvolutions(), true, false);
+}
+
+// Concat of HW outputs and a SW output goes to a HW convolution,
+// packHWConcat converts the SW part directly into the CHW view of the Concat output
+TEST(EliminateCopy, HwMixedConcat) {
+    NetworkBuilder builder("hw_mixed_concat");
+    auto cur = builder.input(16, 16, 16);
+    auto branch1 = builder.relu(builder.conv(cur, 16, 3, 1, 1));
+    auto branch2 = builder.relu(builder.conv(cur, 16, 1, 1, 0));
+    auto branch3 = builder.power(cur, 1.0f, 0.5f, 0.25f);
+    builder.conv(builder.concat({branch1, branch2, branch3}), 16, 1, 1, 0);
+
+    checkStridedViews(builder, true, true);
+}
+
+// A black listed view stays a copy, the other views are still aliased
+TEST(EliminateCopy, StridedViewsBlackList) {
+    TestNetwork network(splitSwapConcat());
+
+    CompileOptions options;
+    options.platform = MYRIAD_X;
+
+    auto aliased = network.compile(options);
+    ASSERT_TRUE(aliased.stridedViews.size() > 1) << aliased.stridedViews.size() << " views were aliased";
+
+    const auto& copied = aliased.stridedViews.front();
+    options.stridedViewsBlackList.insert(copied);
+
+    auto partial = network.compile(options);
+    ASSERT_TRUE(partial.stridedViews.size() == aliased.stridedViews.size() - 1);
+    ASSERT_TRUE(std::find(partial.stridedViews.begin(), partial.stridedViews.end(), copied) == partial.stridedViews.end());
+    ASSERT_TRUE(partial.counter("eliminateCopyStages", "aliased_views") == partial.stridedViews.size());
+
+    checkOutputsNear(network.infer(aliased), network.infer(partial), FP16_TOLERANCE);
+}
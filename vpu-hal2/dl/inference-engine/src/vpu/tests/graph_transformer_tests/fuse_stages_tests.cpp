@@ -0,0 +1,113 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+// Every fusion rule must fire on its pattern and keep the result of the blob compiled
+// with the rule disabled in FUSION_BLACK_LIST.
+
+#include <string>
+
+#include <gtest/gtest.h>
+#include "graph_transformer_test_utils.hpp"
+
+using namespace InferenceEngine;
+using namespace VPU::Tests;
+using VPU::Tools::NetworkBuilder;
+
+namespace {
+
+// Every rule replaces several stages with one
+void checkFusion(const NetworkBuilder& builder, const std::string& rule, bool hw = false) {
+    TestNetwork network(builder);
+
+    CompileOptions options;
+    options.platform = MYRIAD_X;
+    options.hw = hw;
+
+    auto fused = network.compile(options);
+    ASSERT_TRUE(fused.counter("fuseStages", rule) > 0) << "rule " << rule << " wasn't applied";
+
+    options.config[VPU_CONFIG_KEY(FUSION_BLACK_LIST)] = rule;
+
+    auto ref = network.compile(options);
+    ASSERT_TRUE(ref.counter("fuseStages", rule) == 0) << "rule " << rule << " wasn't disabled";
+    ASSERT_TRUE(fused.stagesAfter("fuseStages") < ref.stagesAfter("fuseStages"));
+
+    checkOutputsNear(network.infer(ref), network.infer(fused), FP16_TOLERANCE);
+}
+
+}  // namespace
+
+// BatchNormalization is parsed to Scale with Bias post-op
+TEST(FuseStages, ConvolutionScaleBias) {
+    NetworkBuilder builder("conv_batch_norm");
+    builder.relu(builder.batchNorm(builder.conv(builder.input(8, 16, 16), 16, 3, 1, 1)));
+
+    checkFusion(builder, "AffineWeights");
+}
+
+TEST(FuseStages, HwConvolutionScaleBias) {
+    NetworkBuilder builder("conv_batch_norm");
+    builder.relu(builder.batchNorm(builder.conv(builder.input(8, 16, 16), 16, 3, 1, 1)));
+
+    checkFusion(builder, "AffineWeights", true);
+}
+
+TEST(FuseStages, FullyConnectedScaleShift) {
+    NetworkBuilder builder("fc_scale_shift");
+    builder.scaleShift(builder.fc(builder.input(16, 4, 4), 32));
+
+    checkFusion(builder, "AffineWeights");
+}
+
+TEST(FuseStages, PowerScale) {
+    NetworkBuilder builder("power_scale");
+    auto cur = builder.relu(builder.conv(builder.input(8, 8, 8), 16, 1, 1, 0));
+    builder.scaleShift(builder.power(cur, 1.0f, 0.5f, 0.25f), false);
+
+    checkFusion(builder, "AffineChain");
+}
+
+TEST(FuseStages, ScaleScale) {
+    NetworkBuilder builder("scale_scale");
+    auto cur = builder.relu(builder.conv(builder.input(8, 8, 8), 16, 1, 1, 0));
+    builder.scaleShift(builder.scaleShift(cur));
+
+    checkFusion(builder, "AffineChain");
+}
+
+// Without a producer to fold into, BatchNormalization becomes a single ScaleShift
+TEST(FuseStages, ScaleBias) {
+    NetworkBuilder builder("batch_norm");
+    builder.batchNorm(builder.input(16, 8, 8));
+
+    checkFusion(builder, "ScaleBias");
+}
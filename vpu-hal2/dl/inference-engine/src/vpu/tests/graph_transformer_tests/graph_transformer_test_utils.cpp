@@ -0,0 +1,180 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+#include "graph_transformer_test_utils.hpp"
+
+#include <cmath>
+#include <random>
+#include <algorithm>
+
+#include <graph_transformer_impl.hpp>
+#include <reference_executor.hpp>
+#include <gtest/gtest.h>
+
+using namespace InferenceEngine;
+using namespace InferenceEngine::VPUConfigParams;
+
+namespace VPU {
+namespace Tests {
+
+namespace {
+
+// Converts between NCHW and the SW device layout (see MyriadInferRequest), HW graphs use NCHW
+std::vector<float> convertLayout(const std::vector<float>& src, const SizeVector& dims, bool toDevice, bool hw) {
+    if (dims.size() != 4 || hw) {
+        return src;
+    }
+
+    auto N = dims[0], C = dims[1], H = dims[2], W = dims[3];
+
+    std::vector<float> dst(src.size());
+    for (size_t n = 0; n < N; ++n) {
+        for (size_t c = 0; c < C; ++c) {
+            for (size_t h = 0; h < H; ++h) {
+                for (size_t w = 0; w < W; ++w) {
+                    auto nchw = ((n * C + c) * H + h) * W + w;
+                    auto nhwc = ((n * H + h) * W + w) * C + c;
+                    if (toDevice) {
+                        dst[nhwc] = src[nchw];
+                    } else {
+                        dst[nchw] = src[nhwc];
+                    }
+                }
+            }
+        }
+    }
+    return dst;
+}
+
+}  // namespace
+
+uint64_t CompiledNetwork::counter(const std::string& pass, const std::string& name) const {
+    uint64_t value = 0;
+    for (const auto& stats : passes) {
+        if (stats.name != pass)
+            continue;
+
+        auto it = stats.counters.find(name);
+        if (it != stats.counters.end()) {
+            value += it->second;
+        }
+    }
+    return value;
+}
+
+size_t CompiledNetwork::stagesAfter(const std::string& pass) const {
+    for (const auto& stats : passes) {
+        if (stats.name == pass) {
+            return stats.stagesOut;
+        }
+    }
+    THROW_IE_EXCEPTION << "Pass " << pass << " was not executed";
+}
+
+TestNetwork::TestNetwork(const Tools::NetworkBuilder& builder) {
+    builder.build(_reader);
+
+    auto inputsInfo = _reader.getNetwork().getInputsInfo();
+    auto outputsInfo = _reader.getNetwork().getOutputsInfo();
+    if (inputsInfo.size() != 1 || outputsInfo.size() != 1) {
+        THROW_IE_EXCEPTION << "Only single input and output are supported";
+    }
+
+    auto inputInfo = inputsInfo.begin()->second;
+    auto outputInfo = outputsInfo.begin()->second;
+
+    inputInfo->setPrecision(Precision::FP32);
+    inputInfo->setLayout(NCHW);
+    outputInfo->setPrecision(Precision::FP32);
+
+    _inputDims = inputInfo->getTensorDesc().getDims();
+    _outputDims = outputInfo->getTensorDesc().getDims();
+}
+
+CompiledNetwork TestNetwork::compile(const CompileOptions& options) {
+    auto config = options.config;
+    if (options.platform == MYRIAD_X) {
+        config[VPU_CONFIG_KEY(HW_STAGES_OPTIMIZATION)] = options.hw ? CONFIG_VALUE(YES) : CONFIG_VALUE(NO);
+    }
+
+    Common::ParsedConfig parsedConfig(options.platform, config);
+
+    auto log = std::make_shared<Common::Logger>();
+    log->init(Common::eLOGNONE);
+
+    GraphTransformerImpl transformer(parsedConfig.blobConfig, log, options.allowStridedViews, options.stridedViewsBlackList);
+
+    CompiledNetwork compiled;
+    std::vector<BlobMetaData> metaData;
+    transformer.generate(_reader.getNetwork(), compiled.blob, metaData, compiled.numStages);
+
+    compiled.passes = transformer.getPassStatistics();
+    compiled.stridedViews = transformer.getStridedViews();
+    compiled.hw = options.hw && options.platform == MYRIAD_X;
+
+    return compiled;
+}
+
+std::vector<float> TestNetwork::infer(const CompiledNetwork& compiled) const {
+    BlobReferenceExecutor executor(compiled.blob);
+
+    std::vector<float> input(executor.inputSize() / sizeof(float));
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::generate(input.begin(), input.end(), [&]() { return dist(gen); });
+
+    auto deviceInput = convertLayout(input, _inputDims, true, compiled.hw);
+
+    std::vector<float> deviceOutput(executor.outputSize() / sizeof(float));
+    executor.infer(deviceInput.data(), deviceOutput.data());
+
+    return convertLayout(deviceOutput, _outputDims, false, compiled.hw);
+}
+
+void checkOutputsNear(const std::vector<float>& ref, const std::vector<float>& out, float tolerance) {
+    ASSERT_TRUE(ref.size() == out.size()) << ": " << out.size() << " vs " << ref.size() << " values";
+    ASSERT_TRUE(!ref.empty());
+
+    float range = 0.0f;
+    for (auto val : ref) {
+        range = std::max(range, std::fabs(val));
+    }
+    ASSERT_TRUE(range > 0.0f) << ": reference output is zero";
+
+    for (size_t i = 0; i < ref.size(); ++i) {
+        ASSERT_TRUE(std::fabs(out[i] - ref[i]) <= tolerance * range)
+                << ": value " << i << " is " << out[i] << ", expected " << ref[i] << " (output range " << range << ")";
+    }
+}
+
+}  // namespace Tests
+}  // namespace VPU
@@ -0,0 +1,95 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_set>
+
+#include <inference_engine.hpp>
+#include <graph_transformer.hpp>
+#include <parsed_config.h>
+#include <network_builder.hpp>
+
+namespace VPU {
+namespace Tests {
+
+struct CompileOptions {
+    int platform = MYRIAD_2;
+    bool hw = false;
+    bool allowStridedViews = true;
+    std::unordered_set<std::string> stridedViewsBlackList;
+    std::map<std::string, std::string> config;
+};
+
+struct CompiledNetwork {
+    std::vector<char> blob;
+    std::vector<PassStatistics> passes;
+    size_t numStages = 0;
+    bool hw = false;
+    std::vector<std::string> stridedViews;
+
+    // Value of the pass counter, 0 if the pass didn't report it
+    uint64_t counter(const std::string& pass, const std::string& name) const;
+
+    // Number of stages left after the pass
+    size_t stagesAfter(const std::string& pass) const;
+};
+
+// Network with FP32 NCHW input and FP32 output, compiled by GraphTransformerImpl
+// and executed on the host reference executor.
+class TestNetwork {
+public:
+    explicit TestNetwork(const Tools::NetworkBuilder& builder);
+
+    CompiledNetwork compile(const CompileOptions& options);
+
+    // Runs the blob with the same pseudo-random input each time, the output is in NCHW order
+    std::vector<float> infer(const CompiledNetwork& compiled) const;
+
+private:
+    InferenceEngine::CNNNetReader _reader;
+    InferenceEngine::SizeVector _inputDims;
+    InferenceEngine::SizeVector _outputDims;
+};
+
+// Checks that the outputs match within tolerance relative to the reference output range
+void checkOutputsNear(const std::vector<float>& ref, const std::vector<float>& out, float tolerance);
+
+// FP16 result of a few layers compiled in different ways
+const float FP16_TOLERANCE = 1e-2f;
+
+}  // namespace Tests
+}  // namespace VPU
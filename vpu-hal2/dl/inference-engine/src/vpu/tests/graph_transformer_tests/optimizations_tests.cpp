@@ -0,0 +1,133 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+// Blobs compiled with all optimizations (HW stages, memory/copy/reshape optimizations, fusion)
+// must produce the same result as the plain SW blob.
+
+#include <gtest/gtest.h>
+#include "graph_transformer_test_utils.hpp"
+
+using namespace InferenceEngine;
+using namespace VPU::Tests;
+using VPU::Tools::NetworkBuilder;
+
+namespace {
+
+CompileOptions unoptimized() {
+    CompileOptions options;
+    options.platform = MYRIAD_X;
+    options.hw = false;
+    options.allowStridedViews = false;
+    options.config[VPU_CONFIG_KEY(COPY_OPTIMIZATION)] = CONFIG_VALUE(NO);
+    options.config[VPU_CONFIG_KEY(RESHAPE_OPTIMIZATION)] = CONFIG_VALUE(NO);
+    options.config[VPU_CONFIG_KEY(MEMORY_OPTIMIZATION)] = CONFIG_VALUE(NO);
+    options.config[VPU_CONFIG_KEY(FUSION_BLACK_LIST)] = "AffineChain,AffineWeights,ScaleBias";
+    return options;
+}
+
+CompileOptions optimized(bool hw) {
+    CompileOptions options;
+    options.platform = MYRIAD_X;
+    options.hw = hw;
+    return options;
+}
+
+void checkOptimizedMatches(const NetworkBuilder& builder, bool hw) {
+    TestNetwork network(builder);
+
+    auto ref = network.compile(unoptimized());
+    auto opt = network.compile(optimized(hw));
+
+    checkOutputsNear(network.infer(ref), network.infer(opt), FP16_TOLERANCE);
+}
+
+}  // namespace
+
+// Conv -> ReLU -> MaxPool 2x2 stride 2 is a single HW convolution with fused pooling
+TEST(Optimizations, HwConvolutionWithFusedPooling) {
+    NetworkBuilder builder("conv_pool");
+    auto cur = builder.input(16, 32, 32);
+    cur = builder.pool(builder.relu(builder.conv(cur, 32, 3, 1, 1)), 2, 2, 0);
+    builder.conv(cur, 16, 1, 1, 0);
+
+    checkOptimizedMatches(builder, true);
+}
+
+// Overlapping pooling windows can't be fused into the HW convolution
+TEST(Optimizations, HwConvolutionWithOverlappingPooling) {
+    NetworkBuilder builder("conv_overlapping_pool");
+    auto cur = builder.input(16, 31, 31);
+    cur = builder.pool(builder.relu(builder.conv(cur, 32, 3, 1, 1)), 3, 2, 0);
+    builder.conv(cur, 16, 1, 1, 0);
+
+    checkOptimizedMatches(builder, true);
+}
+
+TEST(Optimizations, HwStridedConvolutionAndAveragePooling) {
+    NetworkBuilder builder("strided_conv_avg_pool");
+    auto cur = builder.input(8, 40, 40);
+    cur = builder.relu(builder.conv(cur, 24, 5, 2, 2));
+    builder.pool(cur, 3, 1, 1, "avg");
+
+    checkOptimizedMatches(builder, true);
+}
+
+TEST(Optimizations, HwFullyConnected) {
+    NetworkBuilder builder("conv_fc");
+    auto cur = builder.input(16, 8, 8);
+    cur = builder.relu(builder.conv(cur, 16, 3, 1, 1));
+    builder.fc(builder.relu(builder.fc(cur, 64)), 10);
+
+    checkOptimizedMatches(builder, true);
+}
+
+TEST(Optimizations, SwInceptionModule) {
+    NetworkBuilder builder("inception_module");
+    auto cur = builder.relu(builder.conv(builder.input(8, 24, 24), 16, 3, 1, 1));
+    auto branch1 = builder.relu(builder.conv(cur, 8, 1, 1, 0));
+    auto branch2 = builder.relu(builder.conv(builder.relu(builder.conv(cur, 8, 1, 1, 0)), 12, 3, 1, 1));
+    auto branch3 = builder.relu(builder.conv(builder.pool(cur, 3, 1, 1), 8, 1, 1, 0));
+    builder.conv(builder.concat({branch1, branch2, branch3}), 16, 1, 1, 0);
+
+    checkOptimizedMatches(builder, false);
+}
+
+TEST(Optimizations, HwInceptionModule) {
+    NetworkBuilder builder("inception_module");
+    auto cur = builder.relu(builder.conv(builder.input(8, 24, 24), 16, 3, 1, 1));
+    auto branch1 = builder.relu(builder.conv(cur, 8, 1, 1, 0));
+    auto branch2 = builder.relu(builder.conv(builder.relu(builder.conv(cur, 8, 1, 1, 0)), 12, 3, 1, 1));
+    auto branch3 = builder.relu(builder.conv(builder.pool(cur, 3, 1, 1), 8, 1, 1, 0));
+    builder.conv(builder.concat({branch1, branch2, branch3}), 16, 1, 1, 0);
+
+    checkOptimizedMatches(builder, true);
+}
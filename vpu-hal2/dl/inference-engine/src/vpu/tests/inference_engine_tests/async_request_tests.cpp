@@ -0,0 +1,272 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstring>
+#include <condition_variable>
+
+#include <gtest/gtest.h>
+
+#include <cpp_interfaces/ie_task_executor.hpp>
+#include <cpp_interfaces/ie_task_synchronizer.hpp>
+#include <cpp_interfaces/base/ie_infer_async_request_base.hpp>
+#include <cpp_interfaces/impl/ie_infer_async_request_thread_safe_default.hpp>
+
+using namespace InferenceEngine;
+
+namespace {
+
+const int REQUESTS = 4;
+const int ITERATIONS = 2000;
+const int CHAIN = 500;
+const int INFER_US = 5;
+
+class SpinInferRequest : public IInferRequestInternal {
+public:
+    SpinInferRequest() : infers(0) {}
+
+    void Infer() override {
+        auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(INFER_US);
+        while (std::chrono::steady_clock::now() < end) {}
+        infers++;
+    }
+
+    void GetPerformanceCounts(std::map<std::string, InferenceEngineProfileInfo>& perfMap) const override {}
+
+    void SetBlob(const char* name, const Blob::Ptr& data) override {}
+
+    void GetBlob(const char* name, Blob::Ptr& data) override {}
+
+    std::atomic<size_t> infers;
+};
+
+// What the callback of a request finds in its user data
+struct Request {
+    std::shared_ptr<SpinInferRequest> sync;
+    IInferRequest::Ptr request;
+
+    std::atomic<size_t> started{0};
+    std::atomic<size_t> inferred{0};
+    std::atomic<size_t> callbacks{0};
+    std::atomic<size_t> errors{0};
+    std::atomic<int> chain{0};
+
+    std::mutex mutex;
+    std::condition_variable chainDone;
+    bool isChainDone = false;
+};
+
+// The executors are shared by the requests like the ones of an executable network
+struct Network {
+    ITaskExecutor::Ptr requestExecutor = std::make_shared<TaskExecutor>("request");
+    ITaskExecutor::Ptr callbackExecutor = std::make_shared<TaskExecutor>("callback");
+    TaskSynchronizer::Ptr synchronizer = std::make_shared<TaskSynchronizer>();
+
+    std::vector<std::unique_ptr<Request>> requests;
+
+    explicit Network(int numRequests) {
+        for (int r = 0; r < numRequests; ++r) {
+            std::unique_ptr<Request> request(new Request());
+            request->sync = std::make_shared<SpinInferRequest>();
+            auto impl = std::make_shared<AsyncInferRequestThreadSafeDefault>(request->sync, requestExecutor,
+                                                                             synchronizer, callbackExecutor);
+            request->request.reset(new InferRequestBase<AsyncInferRequestThreadSafeDefault>(impl),
+                                   [](IInferRequest* p) { p->Release(); });
+            impl->SetPointerToPublicInterface(request->request);
+            EXPECT_TRUE(request->request->SetUserData(request.get(), nullptr) == OK);
+            requests.push_back(std::move(request));
+        }
+    }
+};
+
+// The public API reports a busy request as GENERAL_ERROR with REQUEST_BUSY_str in the message
+StatusCode checkBusy(StatusCode status, const ResponseDesc& resp) {
+    if (status == GENERAL_ERROR && std::strstr(resp.msg, REQUEST_BUSY_str.c_str())) return REQUEST_BUSY;
+    return status;
+}
+
+StatusCode startAsync(IInferRequest::Ptr& request) {
+    ResponseDesc resp;
+    return checkBusy(request->StartAsync(&resp), resp);
+}
+
+StatusCode infer(IInferRequest::Ptr& request) {
+    ResponseDesc resp;
+    return checkBusy(request->Infer(&resp), resp);
+}
+
+Request* getRequest(IInferRequest::Ptr& context) {
+    void* data = nullptr;
+    if (context->GetUserData(&data, nullptr) != OK || !data) {
+        THROW_IE_EXCEPTION << "Failed to get the user data of a request";
+    }
+    return static_cast<Request*>(data);
+}
+
+void countingCallback(IInferRequest::Ptr context, StatusCode code) {
+    auto request = getRequest(context);
+    // the callback runs before the last stage of its task is done
+    if (code != OK && code != RESULT_NOT_READY) request->errors++;
+    request->callbacks++;
+}
+
+// Starts the request again until its chain is done
+void chainCallback(IInferRequest::Ptr context, StatusCode code) {
+    auto request = getRequest(context);
+    if (code != OK && code != RESULT_NOT_READY) request->errors++;
+    request->callbacks++;
+    if (request->chain.fetch_sub(1) > 1) {
+        if (startAsync(context) == OK) {
+            request->started++;
+        } else {
+            request->errors++;
+        }
+        return;
+    }
+    std::lock_guard<std::mutex> lock(request->mutex);
+    request->isChainDone = true;
+    request->chainDone.notify_all();
+}
+
+template <typename Body>
+void runThreads(int threads, const Body& body) {
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back(body, t);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+// The callbacks of the last started tasks may still be queued when the threads are joined
+void waitCallbacks(Request& request) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (request.callbacks < request.started && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+}
+
+}  // namespace
+
+// Two threads per request race StartAsync+Wait and Infer, half of the requests have a callback:
+// every accepted call must run the sync request once and call back once, the others are REQUEST_BUSY
+TEST(AsyncRequest, ConcurrentStartAsyncWaitInfer) {
+    Network network(REQUESTS);
+    for (int r = 1; r < REQUESTS; r += 2) {
+        network.requests[r]->request->SetCompletionCallback(countingCallback);
+    }
+
+    std::atomic<size_t> busy(0);
+    runThreads(2 * REQUESTS, [&](int t) {
+        auto& request = *network.requests[t / 2];
+        bool hasCallback = (t / 2) % 2;
+        for (int i = 0; i < ITERATIONS; ++i) {
+            StatusCode status;
+            if (hasCallback || i % 4) {
+                status = startAsync(request.request);
+                if (status == OK) {
+                    request.started++;
+                    if (request.request->Wait(IInferRequest::WaitMode::RESULT_READY, nullptr) != OK) {
+                        request.errors++;
+                    }
+                }
+            } else {
+                status = infer(request.request);
+                if (status == OK) request.inferred++;
+            }
+            if (status == REQUEST_BUSY) {
+                busy++;
+                std::this_thread::yield();
+            } else if (status != OK) {
+                request.errors++;
+            }
+        }
+    });
+
+    for (int r = 0; r < REQUESTS; ++r) {
+        auto& request = *network.requests[r];
+        bool hasCallback = r % 2;
+        if (hasCallback) {
+            waitCallbacks(request);
+        }
+        ASSERT_TRUE(request.request->Wait(IInferRequest::WaitMode::RESULT_READY, nullptr) == OK) << "request " << r;
+
+        ASSERT_TRUE(request.errors == 0) << "request " << r << ": " << request.errors << " errors";
+        ASSERT_TRUE(request.started + request.inferred > 0) << "request " << r << " never ran";
+        ASSERT_TRUE(request.sync->infers == request.started + request.inferred)
+            << "request " << r << ": " << request.sync->infers << " runs for " << request.started
+            << " StartAsync and " << request.inferred << " Infer";
+        if (hasCallback) {
+            ASSERT_TRUE(request.callbacks == request.started)
+                << "request " << r << ": " << request.callbacks << " callbacks for " << request.started << " StartAsync";
+        }
+    }
+}
+
+// The callbacks start their request again, while all the requests share the executors
+TEST(AsyncRequest, CallbackChains) {
+    Network network(REQUESTS);
+    for (auto& request : network.requests) {
+        request->request->SetCompletionCallback(chainCallback);
+    }
+
+    runThreads(REQUESTS, [&](int r) {
+        auto& request = *network.requests[r];
+        request.chain = CHAIN;
+        if (startAsync(request.request) != OK) {
+            request.errors++;
+            return;
+        }
+        request.started++;
+        std::unique_lock<std::mutex> lock(request.mutex);
+        request.chainDone.wait_for(lock, std::chrono::seconds(30), [&]() { return request.isChainDone; });
+    });
+
+    for (int r = 0; r < REQUESTS; ++r) {
+        auto& request = *network.requests[r];
+        ASSERT_TRUE(request.request->Wait(IInferRequest::WaitMode::RESULT_READY, nullptr) == OK) << "request " << r;
+
+        ASSERT_TRUE(request.errors == 0) << "request " << r << ": " << request.errors << " errors";
+        ASSERT_TRUE(request.isChainDone) << "request " << r << ": chain stopped after " << request.callbacks;
+        ASSERT_TRUE(request.started == CHAIN && request.callbacks == CHAIN && request.sync->infers == CHAIN)
+            << "request " << r << ": " << request.started << " started, " << request.sync->infers << " runs, "
+            << request.callbacks << " callbacks for a chain of " << CHAIN;
+    }
+}
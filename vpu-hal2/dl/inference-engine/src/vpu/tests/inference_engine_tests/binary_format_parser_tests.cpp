@@ -0,0 +1,149 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <inference_engine.hpp>
+#include "binary_format_parser.h"
+
+using namespace InferenceEngine;
+using namespace InferenceEngine::details;
+
+namespace {
+
+const char NETWORK_NAME[] = "input_only";
+
+// Binary network of a single Input layer "data", converted from its XML IR
+std::vector<uint8_t> createBinaryNetwork() {
+    const std::string xmlPath = "binary_format_parser_tests.xml";
+    const std::string binaryPath = "binary_format_parser_tests.iebn";
+    {
+        std::ofstream xml(xmlPath);
+        xml << "<?xml version=\"1.0\" ?>"
+            << "<net name=\"" << NETWORK_NAME << "\" version=\"2\" batch=\"1\"><layers>"
+            << "<layer id=\"0\" name=\"data\" precision=\"FP32\" type=\"Input\"><output><port id=\"0\">"
+            << "<dim>1</dim><dim>4</dim><dim>8</dim><dim>8</dim></port></output></layer>"
+            << "</layers><edges></edges></net>";
+    }
+    ConvertToBinaryNetwork(xmlPath, binaryPath);
+
+    std::ifstream binary(binaryPath, std::ios::binary);
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(binary)), std::istreambuf_iterator<char>());
+    binary.close();
+    std::remove(xmlPath.c_str());
+    std::remove(binaryPath.c_str());
+    EXPECT_TRUE(data.size() > sizeof(BinaryFormatParser::MAGIC) &&
+                std::memcmp(data.data(), BinaryFormatParser::MAGIC, sizeof(BinaryFormatParser::MAGIC)) == 0);
+    return data;
+}
+
+// Offset of the input port count of the layer, after the header and the id, type, name
+// and precision of the layer
+size_t inputPortsOffset() {
+    return sizeof(BinaryFormatParser::MAGIC) + 4 + 4 + std::strlen(NETWORK_NAME) + 4 + 4 +
+           4 + 4 + std::strlen("Input") + 4 + std::strlen("data") + 4;
+}
+
+void put(std::vector<uint8_t>& data, size_t offset, uint32_t value) {
+    std::memcpy(data.data() + offset, &value, sizeof(value));
+}
+
+void append(std::vector<uint8_t>& data, uint32_t value) {
+    data.resize(data.size() + sizeof(value));
+    put(data, data.size() - sizeof(value), value);
+}
+
+// The message of the parse error, empty if data parses
+std::string parseError(const std::vector<uint8_t>& data) {
+    try {
+        CNNNetReader reader;
+        reader.ReadNetwork(data.data(), data.size());
+    } catch (const InferenceEngineException& error) {
+        return error.what();
+    }
+    return "";
+}
+
+bool isCountError(const std::string& error) {
+    return error.find("exceeds its size") != std::string::npos;
+}
+
+}  // namespace
+
+TEST(BinaryFormatParser, ParsesWrittenNetwork) {
+    auto error = parseError(createBinaryNetwork());
+    ASSERT_TRUE(error.empty()) << error;
+}
+
+TEST(BinaryFormatParser, RejectsTruncatedNetwork) {
+    auto data = createBinaryNetwork();
+    data.resize(inputPortsOffset() + 2);
+
+    auto error = parseError(data);
+    ASSERT_TRUE(error.find("truncated") != std::string::npos) << error;
+}
+
+TEST(BinaryFormatParser, RejectsPortCountBeyondTheData) {
+    auto data = createBinaryNetwork();
+    put(data, inputPortsOffset(), 0x40000000u);
+
+    auto error = parseError(data);
+    ASSERT_TRUE(isCountError(error)) << error;
+}
+
+TEST(BinaryFormatParser, RejectsDimsCountBeyondTheData) {
+    auto data = createBinaryNetwork();
+    // the output port follows the empty inputs and the output count, then its id and precision
+    put(data, inputPortsOffset() + 4 + 4 + 4 + 4, 0xffffffffu);
+
+    auto error = parseError(data);
+    ASSERT_TRUE(isCountError(error)) << error;
+}
+
+TEST(BinaryFormatParser, RejectsChannelCountBeyondTheData) {
+    auto data = createBinaryNetwork();
+    // one pre-process of "data" in place of none, the network ends with the pre-process count
+    put(data, data.size() - 4, 1);
+    append(data, std::strlen("data"));
+    data.insert(data.end(), {'d', 'a', 't', 'a'});
+    append(data, 0xffffffffu);
+
+    auto error = parseError(data);
+    ASSERT_TRUE(isCountError(error)) << error;
+}
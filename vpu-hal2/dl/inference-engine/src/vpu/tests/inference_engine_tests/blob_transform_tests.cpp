@@ -0,0 +1,256 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <inference_engine.hpp>
+#include "blob_transform.hpp"
+#include "precision_utils.h"
+
+using namespace InferenceEngine;
+
+namespace {
+
+const std::vector<std::pair<Precision, Precision>> PRECISIONS = {
+    {Precision::U8, Precision::U8}, {Precision::U8, Precision::FP16}, {Precision::U8, Precision::FP32},
+    {Precision::FP16, Precision::FP16}, {Precision::FP16, Precision::FP32},
+    {Precision::FP32, Precision::FP16}, {Precision::FP32, Precision::FP32},
+};
+
+// Odd widths and channels for the tails of the vector loops, more pixels than a tile for the tiling
+const std::vector<SizeVector> SHAPES = {
+    {2, 3, 5, 7}, {1, 1, 4, 9}, {1, 2, 3, 70}, {1, 4, 8, 40}, {1, 8, 6, 5},
+    {1, 16, 2, 33}, {1, 17, 3, 11}, {3, 24, 7, 9}, {1, 32, 1, 37}, {1, 3, 27, 31},
+};
+
+// 0 for NCHW and NHWC, else the block of the channels
+struct LayoutKind {
+    const char* name;
+    Layout layout;
+    size_t block;
+};
+
+const LayoutKind LAYOUTS[] = {{"NCHW", NCHW, 0}, {"NHWC", NHWC, 0}, {"nChw8c", BLOCKED, 8}, {"nChw16c", BLOCKED, 16}};
+
+std::vector<BlobTransform::Isa> simdIsas() {
+    std::vector<BlobTransform::Isa> isas;
+    for (auto isa : {BlobTransform::SSE42, BlobTransform::AVX2}) {
+        if (isa <= BlobTransform::getBestIsa()) isas.push_back(isa);
+    }
+    return isas;
+}
+
+TensorDesc makeDesc(Precision precision, const SizeVector& dims, const LayoutKind& kind) {
+    return kind.block ? BlobTransform::makeBlockedDesc(precision, dims, kind.block) : TensorDesc(precision, dims, kind.layout);
+}
+
+size_t byteSize(const TensorDesc& desc) {
+    size_t size = desc.getPrecision().size();
+    for (auto dim : desc.getBlockingDesc().getBlockDims()) {
+        size *= dim;
+    }
+    return size;
+}
+
+size_t offset(const SizeVector& dims, const LayoutKind& kind, size_t n, size_t c, size_t h, size_t w) {
+    const size_t C = dims[1], H = dims[2], W = dims[3];
+    if (kind.layout == NCHW) return ((n * C + c) * H + h) * W + w;
+    if (kind.layout == NHWC) return ((n * H + h) * W + w) * C + c;
+    const size_t B = kind.block, blocks = (C + B - 1) / B;
+    return (((n * blocks + c / B) * H + h) * W + w) * B + c % B;
+}
+
+float load(Precision precision, const uint8_t* data, size_t index) {
+    switch (precision) {
+    case Precision::U8:
+        return data[index];
+    case Precision::FP16:
+        return PrecisionUtils::f16tof32(reinterpret_cast<const ie_fp16*>(data)[index]);
+    default:
+        return reinterpret_cast<const float*>(data)[index];
+    }
+}
+
+// Element by element, the copies keep the bits
+void referenceConvert(const SizeVector& dims, Precision srcPrecision, const LayoutKind& srcKind, const uint8_t* src,
+                      Precision dstPrecision, const LayoutKind& dstKind, uint8_t* dst,
+                      const float* mean, const float* scale) {
+    const size_t es = srcPrecision.size(), ed = dstPrecision.size();
+    for (size_t n = 0; n < dims[0]; ++n) {
+        for (size_t c = 0; c < dims[1]; ++c) {
+            for (size_t h = 0; h < dims[2]; ++h) {
+                for (size_t w = 0; w < dims[3]; ++w) {
+                    size_t s = offset(dims, srcKind, n, c, h, w), d = offset(dims, dstKind, n, c, h, w);
+                    if (srcPrecision == dstPrecision && !mean && !scale) {
+                        std::memcpy(dst + d * ed, src + s * es, es);
+                        continue;
+                    }
+                    float value = (load(srcPrecision, src, s) - (mean ? mean[c] : 0.f)) * (scale ? scale[c] : 1.f);
+                    if (dstPrecision == Precision::FP16) {
+                        reinterpret_cast<ie_fp16*>(dst)[d] = PrecisionUtils::f32tof16(value);
+                    } else {
+                        reinterpret_cast<float*>(dst)[d] = value;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void fillRandom(Precision precision, std::vector<uint8_t>& data, std::mt19937& random) {
+    std::uniform_real_distribution<float> values(-300.f, 300.f);
+    if (precision == Precision::U8) {
+        for (auto& byte : data) byte = static_cast<uint8_t>(random());
+    } else if (precision == Precision::FP16) {
+        auto fp16 = reinterpret_cast<ie_fp16*>(data.data());
+        for (size_t i = 0; i < data.size() / 2; ++i) fp16[i] = PrecisionUtils::f32tof16(values(random));
+    } else {
+        auto fp32 = reinterpret_cast<float*>(data.data());
+        for (size_t i = 0; i < data.size() / 4; ++i) fp32[i] = values(random);
+    }
+}
+
+// Calls check(srcDesc, src, dstDesc, mean, scale, what) for every shape, precision pair, layout pair,
+// with and without a mean and a scale, on random data
+template <typename Check>
+void forEachConversion(const Check& check) {
+    std::mt19937 random(42);
+    for (const auto& dims : SHAPES) {
+        std::vector<float> mean(dims[1]), scale(dims[1]);
+        for (size_t c = 0; c < dims[1]; ++c) {
+            mean[c] = 10.f * c + 0.5f;
+            scale[c] = 1.f / (c + 3.f);
+        }
+
+        for (const auto& precision : PRECISIONS) {
+            for (const auto& srcKind : LAYOUTS) {
+                auto srcDesc = makeDesc(precision.first, dims, srcKind);
+                std::vector<uint8_t> src(byteSize(srcDesc));
+                fillRandom(precision.first, src, random);
+
+                for (const auto& dstKind : LAYOUTS) {
+                    auto dstDesc = makeDesc(precision.second, dims, dstKind);
+                    for (bool affine : {false, true}) {
+                        // the mean and the scale apply to FP16 and FP32 destinations only
+                        if (affine && precision.second == Precision::U8) continue;
+
+                        std::ostringstream what;
+                        what << precision.first << " " << srcKind.name << " to " << precision.second << " "
+                             << dstKind.name << (affine ? " with mean and scale" : "") << ", dims "
+                             << dims[0] << "x" << dims[1] << "x" << dims[2] << "x" << dims[3];
+                        check(dims, srcKind, srcDesc, src, dstKind, dstDesc,
+                              affine ? mean.data() : nullptr, affine ? scale.data() : nullptr, what.str());
+                    }
+                }
+            }
+        }
+    }
+}
+
+std::vector<uint8_t> convert(const TensorDesc& srcDesc, const std::vector<uint8_t>& src, const TensorDesc& dstDesc,
+                             const float* mean, const float* scale, BlobTransform::Isa isa) {
+    // not a value of the results, so the bytes the kernels don't write show up
+    std::vector<uint8_t> dst(byteSize(dstDesc), 0xAB);
+    BlobTransform::convert(srcDesc, src.data(), dstDesc, dst.data(), mean, scale, isa);
+    return dst;
+}
+
+}  // namespace
+
+TEST(BlobTransform, ScalarMatchesReference) {
+    forEachConversion([](const SizeVector& dims, const LayoutKind& srcKind, const TensorDesc& srcDesc,
+                         const std::vector<uint8_t>& src, const LayoutKind& dstKind, const TensorDesc& dstDesc,
+                         const float* mean, const float* scale, const std::string& what) {
+        // the padding channels of the blocked layouts are zeros
+        std::vector<uint8_t> expected(byteSize(dstDesc), 0);
+        referenceConvert(dims, srcDesc.getPrecision(), srcKind, src.data(), dstDesc.getPrecision(), dstKind,
+                         expected.data(), mean, scale);
+        ASSERT_TRUE(convert(srcDesc, src, dstDesc, mean, scale, BlobTransform::SCALAR) == expected) << what;
+    });
+}
+
+// The SIMD kernels give the scalar results bit exact
+TEST(BlobTransform, SimdMatchesScalar) {
+    auto isas = simdIsas();
+    if (isas.empty()) {
+        std::cout << "the CPU supports no SIMD instruction set of BlobTransform" << std::endl;
+        return;
+    }
+
+    forEachConversion([&isas](const SizeVector&, const LayoutKind&, const TensorDesc& srcDesc,
+                              const std::vector<uint8_t>& src, const LayoutKind&, const TensorDesc& dstDesc,
+                              const float* mean, const float* scale, const std::string& what) {
+        auto expected = convert(srcDesc, src, dstDesc, mean, scale, BlobTransform::SCALAR);
+        for (auto isa : isas) {
+            ASSERT_TRUE(convert(srcDesc, src, dstDesc, mean, scale, isa) == expected)
+                << what << ", " << BlobTransform::getIsaName(isa);
+        }
+    });
+}
+
+// FP32 to FP16 rounding of every instruction set like PrecisionUtils::f32tof16, including the denormals,
+// the overflows, the infinities and the NANs
+TEST(BlobTransform, Fp32ToFp16Rounding) {
+    std::vector<float> values;
+    for (uint64_t bits = 0; bits <= 0xFFFFFFFFull; bits += 4099) {
+        uint32_t pattern = static_cast<uint32_t>(bits);
+        float value;
+        std::memcpy(&value, &pattern, sizeof(value));
+        values.push_back(value);
+    }
+    for (float value : {0.f, -0.f, 65504.f, 65519.f, 65520.f, -65520.f, 6.1035156e-05f, 2.9802322e-08f,
+                        2.9802326e-08f, 5.9604645e-08f, INFINITY, -INFINITY, NAN}) {
+        values.push_back(value);
+    }
+
+    std::vector<ie_fp16> expected(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        expected[i] = PrecisionUtils::f32tof16(values[i]);
+    }
+
+    auto isas = simdIsas();
+    isas.insert(isas.begin(), BlobTransform::SCALAR);
+    SizeVector dims = {1, 1, 1, values.size()};
+    for (auto isa : isas) {
+        std::vector<ie_fp16> actual(values.size());
+        BlobTransform::convert(TensorDesc(Precision::FP32, dims, NCHW), values.data(),
+                               TensorDesc(Precision::FP16, dims, NCHW), actual.data(), nullptr, nullptr, isa);
+        ASSERT_TRUE(actual == expected) << BlobTransform::getIsaName(isa);
+    }
+}
@@ -0,0 +1,311 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+#include <map>
+#include <string>
+#include <vector>
+#include <thread>
+#include <sstream>
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include <inference_engine.hpp>
+#include "ie_util_internal.hpp"
+
+using namespace InferenceEngine;
+using namespace InferenceEngine::details;
+
+namespace {
+
+const size_t CHANNELS = 4;
+const size_t SPATIAL = 8;
+const int LAYERS = 7;
+
+std::string dims() {
+    std::ostringstream port;
+    port << "<dim>1</dim><dim>" << CHANNELS << "</dim><dim>" << SPATIAL << "</dim><dim>" << SPATIAL << "</dim>";
+    return port.str();
+}
+
+// Input followed by Convolution and ReLU layers in turn: conv1, relu2, conv3, ...
+CNNNetworkImplPtr createNetwork() {
+    std::ostringstream xml, edges;
+    std::vector<float> weights;
+    xml << "<?xml version=\"1.0\" ?>" << std::endl
+        << "<net name=\"conv_relu\" version=\"2\" batch=\"1\">" << std::endl << "<layers>" << std::endl
+        << "<layer id=\"0\" name=\"data\" precision=\"FP32\" type=\"Input\"><output><port id=\"0\">" << dims()
+        << "</port></output></layer>" << std::endl;
+
+    for (int l = 1; l < LAYERS; ++l) {
+        if (l % 2) {
+            size_t offset = weights.size() * sizeof(float);
+            size_t weightsSize = CHANNELS * CHANNELS * 3 * 3 * sizeof(float);
+            size_t biasesSize = CHANNELS * sizeof(float);
+            for (size_t i = 0; i < (weightsSize + biasesSize) / sizeof(float); ++i) {
+                weights.push_back(static_cast<float>((i + l) % 17) / 100.f);
+            }
+            xml << "<layer id=\"" << l << "\" name=\"conv" << l << "\" precision=\"FP32\" type=\"Convolution\">"
+                << "<data stride-x=\"1\" stride-y=\"1\" pad-x=\"1\" pad-y=\"1\" kernel-x=\"3\" kernel-y=\"3\" output=\""
+                << CHANNELS << "\" group=\"1\"/>"
+                << "<input><port id=\"0\">" << dims() << "</port></input>"
+                << "<output><port id=\"1\">" << dims() << "</port></output>"
+                << "<blobs><weights offset=\"" << offset << "\" size=\"" << weightsSize << "\"/>"
+                << "<biases offset=\"" << offset + weightsSize << "\" size=\"" << biasesSize << "\"/></blobs></layer>"
+                << std::endl;
+        } else {
+            xml << "<layer id=\"" << l << "\" name=\"relu" << l << "\" precision=\"FP32\" type=\"ReLU\">"
+                << "<data negative_slope=\"0.1\"/>"
+                << "<input><port id=\"0\">" << dims() << "</port></input>"
+                << "<output><port id=\"1\">" << dims() << "</port></output></layer>" << std::endl;
+        }
+        edges << "<edge from-layer=\"" << l - 1 << "\" from-port=\"" << (l == 1 ? 0 : 1)
+              << "\" to-layer=\"" << l << "\" to-port=\"0\"/>" << std::endl;
+    }
+    xml << "</layers>" << std::endl << "<edges>" << std::endl << edges.str() << "</edges>" << std::endl
+        << "</net>" << std::endl;
+
+    auto model = xml.str();
+    auto blob = make_shared_blob<uint8_t>(Precision::U8, C, {weights.size() * sizeof(float)});
+    blob->allocate();
+    std::memcpy(blob->buffer().as<uint8_t*>(), weights.data(), blob->byteSize());
+
+    CNNNetReader reader;
+    reader.ReadNetwork(model.data(), model.size());
+    reader.SetWeights(blob);
+    return cloneNet(static_cast<ICNNNetwork&>(reader.getNetwork()));
+}
+
+// Text of everything the mutations of the tests can change in a network
+std::string describe(const CNNNetworkImpl& network) {
+    std::ostringstream text;
+    text << network.getName() << " batch " << network.getBatchSize() << std::endl;
+
+    OutputsDataMap outputs;
+    network.getOutputsInfo(outputs);
+    for (const auto& output : outputs) {
+        text << "output " << output.first << std::endl;
+    }
+
+    for (const auto& named : network.allLayers()) {
+        const auto& layer = named.second;
+        text << layer->type << " " << layer->name << " {";
+        for (const auto& param : layer->params) {
+            text << param.first << "=" << param.second << " ";
+        }
+        text << "} out:";
+        for (const auto& data : layer->outData) {
+            text << " " << data->name;
+            for (auto dim : data->getDims()) {
+                text << "x" << dim;
+            }
+        }
+        if (auto relu = std::dynamic_pointer_cast<ReLULayer>(layer)) {
+            text << " relu " << relu->negative_slope;
+        }
+        for (const auto& blob : layer->blobs) {
+            text << " " << blob.first;
+            auto data = blob.second->cbuffer().as<const float*>();
+            for (size_t i = 0; i < blob.second->size(); ++i) {
+                text << " " << data[i];
+            }
+        }
+        text << std::endl;
+    }
+    return text.str();
+}
+
+void setNegativeSlope(CNNNetworkImpl& network, float slope) {
+    for (const auto& layer : network.allLayers()) {
+        if (auto relu = std::dynamic_pointer_cast<ReLULayer>(layer.second)) {
+            relu->negative_slope = slope;
+            relu->params["negative_slope"] = std::to_string(slope);
+        }
+    }
+}
+
+Blob::Ptr layerBlob(const CNNNetworkImpl& network, const std::string& layer, const std::string& blob) {
+    return network.allLayers().at(layer)->blobs.at(blob);
+}
+
+}  // namespace
+
+TEST(CopyOnWriteNetwork, CopiesShareTheNetwork) {
+    auto original = createNetwork();
+
+    CopyOnWriteNetwork copy(original);
+    auto copyOfCopy = copy;
+
+    ASSERT_TRUE(&copy.get() == original.get() && &copyOfCopy.get() == original.get());
+    ASSERT_TRUE(copy.isShared() && copyOfCopy.isShared());
+}
+
+TEST(CopyOnWriteNetwork, MutateClonesSharedNetworkOnce) {
+    auto original = createNetwork();
+    auto expected = describe(*original);
+
+    CopyOnWriteNetwork copy(original);
+    auto& cloned = copy.mutate();
+
+    ASSERT_TRUE(&cloned != original.get());
+    ASSERT_TRUE(!copy.isShared());
+    ASSERT_TRUE(&copy.mutate() == &cloned) << "the network is cloned again";
+    ASSERT_TRUE(describe(cloned) == expected) << "the clone differs:\n" << describe(cloned);
+
+    // blobs stay shared until they are written
+    ASSERT_TRUE(layerBlob(cloned, "conv1", "weights") == layerBlob(*original, "conv1", "weights"));
+}
+
+TEST(CopyOnWriteNetwork, NetworkHeldByOneCopyIsNotCloned) {
+    CopyOnWriteNetwork copy(createNetwork());
+    auto network = &copy.get();
+
+    ASSERT_TRUE(!copy.isShared());
+    ASSERT_TRUE(&copy.mutate() == network);
+}
+
+TEST(CopyOnWriteNetwork, NetworkReadByReferenceIsClonedOnMutation) {
+    auto original = createNetwork();
+    auto expected = describe(*original);
+
+    CopyOnWriteNetwork copy(static_cast<const ICNNNetwork&>(*original));
+    CopyOnWriteNetwork copyOfCopy(copy);
+    ASSERT_TRUE(&copy.get() == original.get() && original.use_count() == 1) << "the network is cloned or held";
+    ASSERT_TRUE(copy.isShared() && copyOfCopy.isShared());
+
+    auto& cloned = copy.mutate();
+    setNegativeSlope(cloned, 0.f);
+    ASSERT_TRUE(&cloned != original.get());
+    ASSERT_TRUE(!copy.isShared());
+    ASSERT_TRUE(&copyOfCopy.get() == original.get()) << "the other copy doesn't read the original";
+    ASSERT_TRUE(describe(*original) == expected) << "the original is modified:\n" << describe(*original);
+}
+
+TEST(CopyOnWriteNetwork, MutationsDoNotReachTheOriginal) {
+    auto original = createNetwork();
+    auto expected = describe(*original);
+
+    CopyOnWriteNetwork copy(original);
+    setNegativeSlope(copy.mutate(), 0.f);
+    copy.mutate().setBatchSize(2);
+    copy.mutate().addOutput("relu2");
+
+    ASSERT_TRUE(describe(*original) == expected) << "the original is modified:\n" << describe(*original);
+    ASSERT_TRUE(describe(copy.get()) != expected);
+    ASSERT_TRUE(copy.get().getBatchSize() == 2);
+}
+
+TEST(CopyOnWriteNetwork, MutableBlobCopiesSharedBlob) {
+    auto original = createNetwork();
+    auto expected = describe(*original);
+    auto originalWeights = layerBlob(*original, "conv1", "weights");
+
+    // the IR parser gives _weights a blob of its own, the fused layers share it with blobs
+    auto originalConv = std::dynamic_pointer_cast<WeightableLayer>(original->allLayers().at("conv1"));
+    ASSERT_TRUE(originalConv != nullptr);
+    originalConv->_weights = originalWeights;
+
+    CopyOnWriteNetwork copy(original);
+    // a blob held outside of the network counts as shared, so keep a plain pointer only
+    auto weights = copy.mutableBlob("conv1", "weights").get();
+    ASSERT_TRUE(weights != originalWeights.get()) << "the shared blob is not copied";
+    ASSERT_TRUE(weights->byteSize() == originalWeights->byteSize());
+    ASSERT_TRUE(std::memcmp(weights->cbuffer().as<const void*>(), originalWeights->cbuffer().as<const void*>(),
+                            weights->byteSize()) == 0) << "the copy of the blob differs";
+    ASSERT_TRUE(copy.mutableBlob("conv1", "weights").get() == weights) << "the blob is copied again";
+
+    weights->buffer().as<float*>()[0] = 42.f;
+
+    auto conv = std::dynamic_pointer_cast<WeightableLayer>(copy.get().allLayers().at("conv1"));
+    ASSERT_TRUE(conv && conv->_weights.get() == weights) << "WeightableLayer::_weights is not the copy";
+    ASSERT_TRUE(describe(*original) == expected) << "the blob of the original is modified";
+    ASSERT_TRUE(layerBlob(copy.get(), "conv3", "weights") == layerBlob(*original, "conv3", "weights"))
+        << "the other blobs are copied too";
+}
+
+TEST(CopyOnWriteNetwork, CopyOfModifiedCopyIsIsolated) {
+    auto original = createNetwork();
+    auto expected = describe(*original);
+
+    CopyOnWriteNetwork copy(original);
+    setNegativeSlope(copy.mutate(), 0.f);
+    copy.mutableBlob("conv1", "weights")->buffer().as<float*>()[0] = 42.f;
+    auto modified = describe(copy.get());
+
+    auto copyOfCopy = copy;
+    ASSERT_TRUE(copy.isShared() && copyOfCopy.isShared());
+    copyOfCopy.mutableBlob("conv1", "weights")->buffer().as<float*>()[0] = 0.f;
+    setNegativeSlope(copyOfCopy.mutate(), 0.5f);
+
+    ASSERT_TRUE(describe(copy.get()) == modified) << "the first copy is modified";
+    ASSERT_TRUE(describe(*original) == expected) << "the original is modified";
+    ASSERT_TRUE(!copy.isShared()) << "the first copy doesn't hold its network alone again";
+}
+
+// Each thread mutates its own copy, like the plugins loading the same network at once
+TEST(CopyOnWriteNetwork, ConcurrentCopiesAreIsolated) {
+    const int THREADS = 8;
+    auto original = createNetwork();
+    auto expected = describe(*original);
+
+    CopyOnWriteNetwork source(original);
+    std::vector<CopyOnWriteNetwork> copies(THREADS, source);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&copies, t]() {
+            auto& copy = copies[t];
+            if (t % 2) {
+                copy.mutableBlob("conv" + std::to_string(1 + 2 * (t % 3)), "weights")->buffer().as<float*>()[0] =
+                    static_cast<float>(t);
+                setNegativeSlope(copy.mutate(), static_cast<float>(t));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_TRUE(describe(*original) == expected) << "the original is modified";
+    for (int t = 0; t < THREADS; ++t) {
+        const auto& network = copies[t].get();
+        if (t % 2 == 0) {
+            ASSERT_TRUE(&network == original.get()) << "copy " << t << " is cloned without a mutation";
+            continue;
+        }
+        auto relu = std::dynamic_pointer_cast<ReLULayer>(network.allLayers().at("relu2"));
+        auto conv = "conv" + std::to_string(1 + 2 * (t % 3));
+        ASSERT_TRUE(relu && relu->negative_slope == static_cast<float>(t))
+            << "copy " << t << " sees the mutation of another copy";
+        ASSERT_TRUE(layerBlob(network, conv, "weights")->cbuffer().as<const float*>()[0] == static_cast<float>(t))
+            << "copy " << t << " sees the blob of another copy";
+    }
+}
@@ -0,0 +1,105 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <cpp_interfaces/ie_work_stealing_executor.hpp>
+
+using namespace InferenceEngine;
+
+namespace {
+
+const int WORKERS = 4;
+const int TASKS = 2000;
+const int TASK_US = 20;
+
+}  // namespace
+
+// All the tasks are started by one worker into its own queue, the other workers steal them
+// while the owner and the other thieves hold the queue lock
+TEST(WorkStealingExecutor, StealsFromBusyQueue) {
+    for (unsigned int spinCount : {0u, 64u}) {
+        TaskExecutorConfig config;
+        config.type = TaskExecutorConfig::WORK_STEALING;
+        config.workers = WORKERS;
+        config.spinCount = spinCount;
+
+        std::atomic<int> done(0);
+        std::mutex threadsMutex;
+        std::set<std::thread::id> threads;
+        {
+            WorkStealingTaskExecutor executor(config, "test");
+
+            auto work = [&]() {
+                auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(TASK_US);
+                while (std::chrono::steady_clock::now() < end) {}
+                {
+                    std::lock_guard<std::mutex> lock(threadsMutex);
+                    threads.insert(std::this_thread::get_id());
+                }
+                done++;
+            };
+            auto spawner = std::make_shared<Task>([&]() {
+                for (int i = 0; i < TASKS; i++) {
+                    ASSERT_TRUE(executor.startTask(std::make_shared<Task>(work)));
+                }
+            });
+            ASSERT_TRUE(executor.startTask(spawner));
+        }
+
+        ASSERT_EQ(done, TASKS) << "spin count " << spinCount;
+        ASSERT_GT(threads.size(), 1u) << "spin count " << spinCount << " : no task was stolen";
+    }
+}
+
+// Joining the workers from one of them would deadlock
+TEST(WorkStealingExecutorDeathTest, DestroyedByItsWorker) {
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+
+    ASSERT_DEATH({
+        TaskExecutorConfig config;
+        config.type = TaskExecutorConfig::WORK_STEALING;
+        config.workers = 2;
+
+        auto executor = new WorkStealingTaskExecutor(config, "test");
+        executor->startTask(std::make_shared<Task>([executor]() { delete executor; }));
+        std::this_thread::sleep_for(std::chrono::seconds(10));
+    }, "destroyed by its own worker");
+}
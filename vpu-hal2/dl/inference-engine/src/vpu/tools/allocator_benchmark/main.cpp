@@ -0,0 +1,162 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+
+// Compares the allocators of the blobs of the infer requests:
+//
+//   vpu_allocator_benchmark [-t <threads>] [-n <blobs per thread>] [-l <live blobs per thread>]
+//
+// Every thread allocates blobs of the sizes of the inputs and outputs of typical networks, writes
+// them, and frees the oldest one once it holds -l blobs. The blobs go to the default allocator (the heap),
+// then to PoolAllocator, then to pinned PoolAllocator. Reports the blobs per second, the share of the
+// blobs aligned to PoolAllocator::ALIGNMENT, and the counters of the pools with the last blobs still live.
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <deque>
+#include <random>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+#include <inference_engine.hpp>
+#include "pool_allocator.hpp"
+#include "benchmark_harness.hpp"
+
+using namespace InferenceEngine;
+using namespace VPU::Tools;
+
+namespace {
+
+// classification output, 300x300 U8 and 224x224 FP32 inputs, detection output, 1080p FP16 input
+const size_t BLOB_SIZES[] = {1000 * sizeof(float), 300 * 300 * 3, 224 * 224 * 3 * sizeof(float),
+                             100 * 7 * sizeof(float), 1920 * 1080 * 3 * 2};
+
+struct Options {
+    int threads = 4;
+    int blobs = 20000;
+    int liveBlobs = 4;
+};
+
+struct Result {
+    double seconds;
+    size_t aligned;
+    size_t blobs;
+    PoolAllocatorStatistics statistics;
+};
+
+using LiveBlobs = std::deque<TBlob<uint8_t>::Ptr>;
+
+size_t runThread(const Options& options, const std::shared_ptr<IAllocator>& allocator, int seed, LiveBlobs& live) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<size_t> sizes(0, sizeof(BLOB_SIZES) / sizeof(BLOB_SIZES[0]) - 1);
+    size_t aligned = 0;
+    for (int i = 0; i < options.blobs; ++i) {
+        auto size = BLOB_SIZES[sizes(gen)];
+        auto blob = allocator ? std::make_shared<TBlob<uint8_t>>(Precision::U8, C, SizeVector{size}, allocator)
+                              : make_shared_blob<uint8_t>(Precision::U8, C, {size});
+        blob->allocate();
+        auto data = blob->buffer().as<uint8_t*>();
+        if (data == nullptr) THROW_IE_EXCEPTION << "Failed to allocate " << size << " bytes";
+        if (reinterpret_cast<uintptr_t>(data) % PoolAllocator::ALIGNMENT == 0) {
+            aligned++;
+        }
+        // the first bytes like a small output, every page like an input
+        std::memset(data, i, std::min<size_t>(size, 4096));
+        for (size_t offset = 4096; offset < size; offset += 4096) {
+            data[offset] = static_cast<uint8_t>(i);
+        }
+        live.push_back(blob);
+        if (live.size() > static_cast<size_t>(options.liveBlobs)) {
+            live.pop_front();
+        }
+    }
+    return aligned;
+}
+
+Result run(const Options& options, const std::shared_ptr<IAllocator>& allocator, bool pinned = false) {
+    std::vector<LiveBlobs> live(options.threads);
+    std::atomic<size_t> aligned(0);
+    Result result;
+    result.seconds = runThreads(options.threads, [&](int t) {
+        aligned += runThread(options, allocator, t, live[t]);
+    });
+    result.aligned = aligned;
+    result.blobs = static_cast<size_t>(options.threads) * options.blobs;
+    result.statistics = PoolAllocator::getStatistics(pinned);
+    return result;
+}
+
+void printResult(const char* name, const Result& result) {
+    std::cout << "  " << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(0)
+              << std::setw(10) << result.blobs / result.seconds << " blobs/s  " << std::setprecision(1)
+              << std::setw(6) << 1e9 * result.seconds / result.blobs << " ns/blob  " << std::setw(5)
+              << 100.0 * result.aligned / result.blobs << "% aligned" << std::defaultfloat << std::endl;
+}
+
+void printStatistics(const PoolAllocatorStatistics& statistics) {
+    std::cout << "  " << std::setw(12) << "" << std::fixed << std::setprecision(1) << "hit rate "
+              << 100.0 * statistics.hitRate() << "%, " << statistics.allocations << " allocations, reserved "
+              << statistics.bytesReserved / 1024 << " KB, fragmentation " << 100.0 * statistics.fragmentation()
+              << "%, pinned " << statistics.bytesPinned / 1024 << " KB, " << statistics.pinFailures
+              << " pin failures" << std::defaultfloat << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    CommandLine commandLine("vpu_allocator_benchmark", "[-t <threads>] [-n <blobs per thread>] [-l <live blobs per thread>]");
+    commandLine.add("-t", options.threads, 1)
+               .add("-n", options.blobs, 1)
+               .add("-l", options.liveBlobs, 1);
+
+    return runBenchmark(argc, argv, commandLine, [&]() {
+        std::cout << options.threads << " threads, " << options.blobs << " blobs each, " << options.liveBlobs
+                  << " live" << std::endl;
+        printResult("system", run(options, nullptr));
+
+        for (bool pinned : {false, true}) {
+            std::shared_ptr<IAllocator> allocator = shared_from_irelease(new PoolAllocator(pinned));
+            auto result = run(options, allocator, pinned);
+            printResult(pinned ? "pool pinned" : "pool", result);
+            printStatistics(result.statistics);
+            PoolAllocator::trim(pinned);
+        }
+        return 0;
+    });
+}
@@ -0,0 +1,376 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+
+
+
+// Measures the overhead of the async infer requests of the Inference Engine and stresses them:
+//
+//   vpu_async_request_benchmark [-w <infer us>] [-n <requests per thread>] [-stress <seconds>] [-trace <file>]
+//
+// The requests are AsyncInferRequestThreadSafeDefault over a sync request spinning for the infer time,
+// 0 us by default, so the numbers are the overhead of StartAsync and Wait, of the callbacks and of the
+// TaskSynchronizer of Infer, with 1 to 8 requests sharing the executors like the requests of a network.
+//
+// -stress runs the requests for the given time from two threads each, racing StartAsync, Wait, Infer and
+// StartAsync from the callbacks, and checks that every started request was inferred once and called back once.
+//
+// -trace enables the Tracer during the runs and writes the events to the file in the Chrome trace_event format.
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <map>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <thread>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+
+#include <cpp_interfaces/ie_task_executor.hpp>
+#include <cpp_interfaces/ie_task_synchronizer.hpp>
+#include <cpp_interfaces/base/ie_infer_async_request_base.hpp>
+#include <cpp_interfaces/impl/ie_infer_async_request_thread_safe_default.hpp>
+#include <ie_trace.hpp>
+
+#include "benchmark_harness.hpp"
+
+using namespace InferenceEngine;
+using namespace VPU::Tools;
+
+namespace {
+
+const int REQUESTS[] = {1, 2, 4, 8};
+
+const int STRESS_REQUESTS = 8;
+const int STRESS_CHAIN = 16;
+
+struct Options {
+    int inferUs = 0;
+    int iterations = 20000;
+    int stressSeconds = 0;
+    std::string traceFile;
+};
+
+class SpinInferRequest : public IInferRequestInternal {
+public:
+    explicit SpinInferRequest(int inferUs) : _inferUs(inferUs), infers(0) {}
+
+    void Infer() override {
+        IE_TRACE_SCOPE("plugin", "Spin")
+        auto end = Clock::now() + std::chrono::microseconds(_inferUs);
+        while (Clock::now() < end) {}
+        infers++;
+    }
+
+    void GetPerformanceCounts(std::map<std::string, InferenceEngineProfileInfo>& perfMap) const override {}
+
+    void SetBlob(const char* name, const Blob::Ptr& data) override {}
+
+    void GetBlob(const char* name, Blob::Ptr& data) override {}
+
+private:
+    int _inferUs;
+
+public:
+    std::atomic<size_t> infers;
+};
+
+// What the callback of a request finds in its user data
+struct Request {
+    std::shared_ptr<SpinInferRequest> sync;
+    IInferRequest::Ptr request;
+
+    std::atomic<size_t> started{0};
+    std::atomic<size_t> callbacks{0};
+    std::atomic<int> chain{0};
+    std::atomic<size_t> errors{0};
+
+    std::mutex mutex;
+    std::condition_variable chainDone;
+    bool isChainDone = false;
+};
+
+// Shared by the requests like the executors of an executable network
+struct Network {
+    ITaskExecutor::Ptr requestExecutor = std::make_shared<TaskExecutor>("request");
+    ITaskExecutor::Ptr callbackExecutor = std::make_shared<TaskExecutor>("callback");
+    TaskSynchronizer::Ptr synchronizer = std::make_shared<TaskSynchronizer>();
+};
+
+std::unique_ptr<Request> createRequest(const Network& network, int inferUs) {
+    std::unique_ptr<Request> request(new Request());
+    request->sync = std::make_shared<SpinInferRequest>(inferUs);
+    auto impl = std::make_shared<AsyncInferRequestThreadSafeDefault>(request->sync, network.requestExecutor,
+                                                                     network.synchronizer, network.callbackExecutor);
+    request->request.reset(new InferRequestBase<AsyncInferRequestThreadSafeDefault>(impl),
+                           [](IInferRequest* p) { p->Release(); });
+    impl->SetPointerToPublicInterface(request->request);
+    if (request->request->SetUserData(request.get(), nullptr) != OK) {
+        THROW_IE_EXCEPTION << "Failed to set the user data of a request";
+    }
+    return request;
+}
+
+// The public API reports a busy request as GENERAL_ERROR with REQUEST_BUSY_str in the message
+StatusCode checkBusy(StatusCode status, const ResponseDesc& resp) {
+    if (status == GENERAL_ERROR && std::strstr(resp.msg, REQUEST_BUSY_str.c_str())) return REQUEST_BUSY;
+    return status;
+}
+
+StatusCode startAsync(IInferRequest::Ptr& request) {
+    ResponseDesc resp;
+    return checkBusy(request->StartAsync(&resp), resp);
+}
+
+StatusCode infer(IInferRequest::Ptr& request) {
+    ResponseDesc resp;
+    return checkBusy(request->Infer(&resp), resp);
+}
+
+Request* getRequest(IInferRequest::Ptr& context) {
+    void* data = nullptr;
+    if (context->GetUserData(&data, nullptr) != OK || !data) {
+        THROW_IE_EXCEPTION << "Failed to get the user data of a request";
+    }
+    return static_cast<Request*>(data);
+}
+
+// Starts the request again until its chain is done, StartAsync from another thread may win the request
+void chainCallback(IInferRequest::Ptr context, StatusCode code) {
+    auto request = getRequest(context);
+    request->callbacks++;
+    // the callback runs before the last stage of its task is done
+    if (code != OK && code != RESULT_NOT_READY) request->errors++;
+    if (request->chain.fetch_sub(1) > 1) {
+        auto status = startAsync(context);
+        if (status == OK) {
+            request->started++;
+            return;
+        }
+        if (status != REQUEST_BUSY) request->errors++;
+        request->chain++;
+        return;
+    }
+    std::lock_guard<std::mutex> lock(request->mutex);
+    request->isChainDone = true;
+    request->chainDone.notify_all();
+}
+
+void runChain(Request& request, int length) {
+    {
+        std::lock_guard<std::mutex> lock(request.mutex);
+        request.isChainDone = false;
+    }
+    request.chain = length;
+    StatusCode status;
+    while ((status = startAsync(request.request)) == REQUEST_BUSY) {
+        std::this_thread::yield();
+    }
+    if (status != OK) THROW_IE_EXCEPTION << "StartAsync failed with " << status;
+    request.started++;
+    std::unique_lock<std::mutex> lock(request.mutex);
+    request.chainDone.wait(lock, [&]() { return request.isChainDone; });
+}
+
+void printResult(const char* name, int requests, double perSecond, const std::vector<double>& latencyUs) {
+    printRowHeader(std::cout, requests, name, 18);
+    std::cout << std::fixed << std::setprecision(0) << std::setw(10) << perSecond << " /s" << std::defaultfloat;
+    printPercentiles(std::cout, "", latencyUs);
+    std::cout << std::endl;
+}
+
+void benchmark(int requestsNumber, const Options& options) {
+    Network network;
+    std::vector<std::unique_ptr<Request>> requests;
+    for (int r = 0; r < requestsNumber; ++r) {
+        requests.push_back(createRequest(network, options.inferUs));
+    }
+
+    // StartAsync and Wait, the latency is the round trip less the infer time
+    std::vector<std::vector<double>> latencyUs(requestsNumber);
+    auto elapsed = runThreads(requestsNumber, [&](int r) {
+        auto& request = requests[r]->request;
+        auto& times = latencyUs[r];
+        times.reserve(options.iterations);
+        for (int i = 0; i < options.iterations; ++i) {
+            auto start = Clock::now();
+            if (request->StartAsync(nullptr) != OK ||
+                request->Wait(IInferRequest::WaitMode::RESULT_READY, nullptr) != OK) {
+                THROW_IE_EXCEPTION << "Failed to run request " << r;
+            }
+            times.push_back(toUs(Clock::now() - start) - options.inferUs);
+        }
+    });
+    auto all = mergeSamples(latencyUs);
+    printResult("StartAsync+Wait", requestsNumber, all.size() / elapsed, all);
+
+    // StartAsync from the callbacks, every start takes a task of the ring
+    for (auto& request : requests) {
+        request->request->SetCompletionCallback(chainCallback);
+    }
+    elapsed = runThreads(requestsNumber, [&](int r) {
+        runChain(*requests[r], options.iterations);
+    });
+    printResult("callback chain", requestsNumber, requestsNumber * options.iterations / elapsed, {});
+
+    // Infer, the requests take turns through the TaskSynchronizer
+    std::vector<std::vector<double>> inferUs(requestsNumber);
+    elapsed = runThreads(requestsNumber, [&](int r) {
+        auto& request = requests[r]->request;
+        auto& times = inferUs[r];
+        times.reserve(options.iterations);
+        for (int i = 0; i < options.iterations; ++i) {
+            auto start = Clock::now();
+            if (request->Infer(nullptr) != OK) {
+                THROW_IE_EXCEPTION << "Failed to infer request " << r;
+            }
+            times.push_back(toUs(Clock::now() - start) - options.inferUs);
+        }
+    });
+    all = mergeSamples(inferUs);
+    printResult("Infer", requestsNumber, all.size() / elapsed, all);
+}
+
+bool stress(const Options& options) {
+    Network network;
+    std::vector<std::unique_ptr<Request>> requests;
+    for (int r = 0; r < STRESS_REQUESTS; ++r) {
+        requests.push_back(createRequest(network, options.inferUs));
+        // half of the requests are waited for, half are called back
+        if (r % 2) {
+            requests.back()->request->SetCompletionCallback(chainCallback);
+        }
+    }
+
+    std::atomic<size_t> infers(0);
+    std::atomic<size_t> busy(0);
+    auto deadline = Clock::now() + std::chrono::seconds(options.stressSeconds);
+    runThreads(2 * STRESS_REQUESTS, [&](int t) {
+        auto& request = *requests[t / 2];
+        bool isChained = (t / 2) % 2;
+        bool isIntruder = t % 2;
+        for (size_t i = 0; Clock::now() < deadline; ++i) {
+            StatusCode status;
+            if (isChained && !isIntruder) {
+                runChain(request, STRESS_CHAIN);
+                continue;
+            }
+            if (isChained || i % 4) {
+                status = startAsync(request.request);
+                if (status == OK) {
+                    request.started++;
+                    // the callbacks of a chain may start the request again, only the waited for requests wait
+                    if (!isChained && request.request->Wait(IInferRequest::WaitMode::RESULT_READY, nullptr) != OK) {
+                        request.errors++;
+                    }
+                }
+            } else {
+                status = infer(request.request);
+                if (status == OK) infers++;
+            }
+            if (status == REQUEST_BUSY) {
+                busy++;
+                std::this_thread::yield();
+            } else if (status != OK) {
+                request.errors++;
+            }
+        }
+    });
+
+    // the intruders may have started a chain again after its last callback
+    auto drainDeadline = Clock::now() + std::chrono::seconds(5);
+    for (auto& request : requests) {
+        while (request->callbacks < request->started && Clock::now() < drainDeadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        request->request->Wait(IInferRequest::WaitMode::RESULT_READY, nullptr);
+    }
+
+    size_t started = 0, inferred = 0, errors = 0, lostCallbacks = 0;
+    for (int r = 0; r < STRESS_REQUESTS; ++r) {
+        auto& request = *requests[r];
+        started += request.started;
+        inferred += request.sync->infers;
+        errors += request.errors;
+        if (r % 2 && request.callbacks != request.started) {
+            lostCallbacks += std::max(request.callbacks, request.started) - std::min(request.callbacks, request.started);
+        }
+    }
+    bool isPassed = errors == 0 && lostCallbacks == 0 && inferred == started + infers;
+    std::cout << "stress: " << started << " started, " << infers << " inferred, " << busy << " busy, "
+              << inferred << " run, " << errors << " errors, " << lostCallbacks << " lost callbacks: "
+              << (isPassed ? "PASSED" : "FAILED") << std::endl;
+    return isPassed;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    CommandLine commandLine("vpu_async_request_benchmark",
+                            "[-w <infer us>] [-n <requests per thread>] [-stress <seconds>] [-trace <file>]");
+    commandLine.add("-w", options.inferUs, 0)
+               .add("-n", options.iterations, 1)
+               .add("-stress", options.stressSeconds, 1)
+               .add("-trace", options.traceFile);
+
+    return runBenchmark(argc, argv, commandLine, [&]() {
+        Tracer::enable(!options.traceFile.empty());
+        if (options.stressSeconds) {
+            bool isOk = stress(options);
+            if (!options.traceFile.empty()) {
+                Tracer::exportChromeTrace(options.traceFile);
+            }
+            return isOk ? 0 : 1;
+        }
+
+        std::cout << "requests  call              " << options.inferUs << " us infer, overhead" << std::endl;
+        for (auto requests : REQUESTS) {
+            benchmark(requests, options);
+        }
+        if (!options.traceFile.empty()) {
+            std::vector<TraceEvent> events;
+            auto dropped = Tracer::flush(events);
+            std::ofstream file(options.traceFile);
+            Tracer::writeChromeTrace(file, events);
+            std::cout << events.size() << " trace events written to " << options.traceFile << ", " << dropped
+                      << " dropped" << std::endl;
+        }
+        return 0;
+    });
+}
@@ -0,0 +1,268 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+
+// Converts IR v2 networks to the binary network format and measures the startup time of both:
+//
+//   vpu_binary_network_benchmark [-m <model.xml>]... [-g <layers>] [-d <dir>] [-n <iterations>]
+//
+// Every model is converted to <model>.iebn next to it, then read by CNNNetReader::ReadNetwork from the
+// XML and from the binary file, with the weights. The two networks must be the same: layers, parameters,
+// typed fields, data and weights.
+// -g writes a synthetic IR of a chain of <layers> Convolution and ReLU layers to -d, 4000 layers by default
+// when no model is given.
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+#include <inference_engine.hpp>
+#include "binary_format_parser.h"
+#include "benchmark_harness.hpp"
+
+using namespace InferenceEngine;
+using namespace VPU::Tools;
+
+namespace {
+
+const size_t CHANNELS = 8;
+const size_t SPATIAL = 16;
+
+struct Options {
+    std::vector<std::string> models;
+    int generateLayers = 0;
+    std::string dir = ".";
+    int iterations = 5;
+};
+
+std::string baseOf(const std::string& model) {
+    auto pos = model.rfind('.');
+    return pos == std::string::npos ? model : model.substr(0, pos);
+}
+
+std::string dims(size_t channels) {
+    std::ostringstream port;
+    port << "<dim>1</dim><dim>" << channels << "</dim><dim>" << SPATIAL << "</dim><dim>" << SPATIAL << "</dim>";
+    return port.str();
+}
+
+// Chain of 3x3 CHANNELS x CHANNELS Convolution layers, each one followed by a ReLU
+std::string generateModel(int layers, const std::string& dir) {
+    auto name = "synthetic_conv_relu_" + std::to_string(layers);
+    auto model = dir + "/" + name + ".xml";
+
+    std::ofstream xml(model);
+    std::ofstream bin(baseOf(model) + ".bin", std::ios::binary);
+    if (!xml || !bin) THROW_IE_EXCEPTION << "Failed to create " << model;
+
+    std::ostringstream edges;
+    xml << "<?xml version=\"1.0\" ?>" << std::endl
+        << "<net name=\"" << name << "\" version=\"2\" batch=\"1\">" << std::endl << "<layers>" << std::endl
+        << "<layer id=\"0\" name=\"data\" precision=\"FP32\" type=\"Input\"><output><port id=\"0\">" << dims(CHANNELS)
+        << "</port></output></layer>" << std::endl;
+
+    std::vector<float> values(CHANNELS * CHANNELS * 3 * 3);
+    size_t offset = 0;
+    for (int l = 1; l < layers; ++l) {
+        if (l % 2) {
+            for (size_t i = 0; i < values.size(); ++i) {
+                values[i] = static_cast<float>((i + l) % 17) / 100.f;
+            }
+            size_t weightsSize = values.size() * sizeof(float);
+            size_t biasesSize = CHANNELS * sizeof(float);
+            bin.write(reinterpret_cast<const char*>(values.data()), weightsSize + biasesSize);
+
+            xml << "<layer id=\"" << l << "\" name=\"conv" << l << "\" precision=\"FP32\" type=\"Convolution\">"
+                << "<data stride-x=\"1\" stride-y=\"1\" pad-x=\"1\" pad-y=\"1\" kernel-x=\"3\" kernel-y=\"3\" output=\""
+                << CHANNELS << "\" group=\"1\"/>"
+                << "<input><port id=\"0\">" << dims(CHANNELS) << "</port></input>"
+                << "<output><port id=\"1\">" << dims(CHANNELS) << "</port></output>"
+                << "<blobs><weights offset=\"" << offset << "\" size=\"" << weightsSize << "\"/>"
+                << "<biases offset=\"" << offset + weightsSize << "\" size=\"" << biasesSize << "\"/></blobs></layer>"
+                << std::endl;
+            offset += weightsSize + biasesSize;
+        } else {
+            xml << "<layer id=\"" << l << "\" name=\"relu" << l << "\" precision=\"FP32\" type=\"ReLU\">"
+                << "<data negative_slope=\"0.1\"/>"
+                << "<input><port id=\"0\">" << dims(CHANNELS) << "</port></input>"
+                << "<output><port id=\"1\">" << dims(CHANNELS) << "</port></output></layer>" << std::endl;
+        }
+        edges << "<edge from-layer=\"" << l - 1 << "\" from-port=\"" << (l == 1 ? 0 : 1)
+              << "\" to-layer=\"" << l << "\" to-port=\"0\"/>" << std::endl;
+    }
+    xml << "</layers>" << std::endl << "<edges>" << std::endl << edges.str() << "</edges>" << std::endl
+        << "</net>" << std::endl;
+    if (!bin) THROW_IE_EXCEPTION << "Failed to write " << baseOf(model) << ".bin";
+
+    std::cout << "generated " << model << ": " << layers << " layers" << std::endl;
+    return model;
+}
+
+size_t fileSize(const std::string& fileName) {
+    std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+    return file ? static_cast<size_t>(file.tellg()) : 0;
+}
+
+double readNetwork(CNNNetReader& reader, const std::string& network, const std::string& weights) {
+    auto start = Clock::now();
+    reader.ReadNetwork(network);
+    auto ms = toMs(Clock::now() - start);
+    reader.ReadWeights(weights);
+    return ms;
+}
+
+// Text of everything the parsers set in a layer
+std::string describe(const CNNLayerPtr& layer) {
+    std::ostringstream text;
+    text << layer->type << " " << layer->name << " " << layer->precision.name() << " {";
+    for (const auto& param : layer->params) {
+        text << param.first << "=" << param.second << " ";
+    }
+    text << "} in:";
+    for (const auto& data : layer->insData) {
+        text << " " << data.lock()->name;
+    }
+    text << " out:";
+    for (const auto& data : layer->outData) {
+        text << " " << data->name << " " << data->getPrecision().name();
+        for (auto dim : data->getDims()) {
+            text << "x" << dim;
+        }
+    }
+    if (auto conv = std::dynamic_pointer_cast<ConvolutionLayer>(layer)) {
+        text << " conv " << conv->_kernel_x << "," << conv->_kernel_y << " " << conv->_stride_x << ","
+             << conv->_stride_y << " " << conv->_padding_x << "," << conv->_padding_y << " "
+             << conv->_dilation_x << "," << conv->_dilation_y << " " << conv->_out_depth << " " << conv->_group;
+    }
+    if (auto pool = std::dynamic_pointer_cast<PoolingLayer>(layer)) {
+        text << " pool " << pool->_kernel_x << "," << pool->_kernel_y << " " << pool->_stride_x << ","
+             << pool->_stride_y << " " << pool->_padding_x << "," << pool->_padding_y << " " << pool->_type
+             << " " << pool->_exclude_pad;
+    }
+    if (auto relu = std::dynamic_pointer_cast<ReLULayer>(layer)) {
+        text << " relu " << relu->negative_slope;
+    }
+    if (auto fc = std::dynamic_pointer_cast<FullyConnectedLayer>(layer)) {
+        text << " fc " << fc->_out_num;
+    }
+    if (auto weightable = std::dynamic_pointer_cast<WeightableLayer>(layer)) {
+        for (const auto& blob : {weightable->_weights, weightable->_biases}) {
+            if (blob) {
+                auto data = blob->cbuffer().as<const uint8_t*>();
+                uint64_t sum = 0;
+                for (size_t i = 0; i < blob->byteSize(); ++i) {
+                    sum = sum * 31 + data[i];
+                }
+                text << " blob " << blob->byteSize() << ":" << sum;
+            }
+        }
+    }
+    return text.str();
+}
+
+void compare(CNNNetReader& xml, CNNNetReader& binary) {
+    auto& xmlNetwork = xml.getNetwork();
+    auto& binaryNetwork = binary.getNetwork();
+    if (xml.getName() != binary.getName()) THROW_IE_EXCEPTION << "The names of the networks differ";
+    if (static_cast<ICNNNetwork&>(xmlNetwork).layerCount() != static_cast<ICNNNetwork&>(binaryNetwork).layerCount())
+        THROW_IE_EXCEPTION << "The layer counts differ";
+
+    for (auto layer : xmlNetwork) {
+        auto expected = describe(layer);
+        auto actual = describe(binaryNetwork.getLayerByName(layer->name.c_str()));
+        if (expected != actual)
+            THROW_IE_EXCEPTION << "Layer " << layer->name << " differs:\n" << expected << "\n" << actual;
+    }
+
+    std::map<std::string, std::string> outputs;
+    for (const auto& output : xmlNetwork.getOutputsInfo()) {
+        outputs[output.first] = output.second->name;
+    }
+    for (const auto& output : binaryNetwork.getOutputsInfo()) {
+        if (outputs[output.first] != output.second->name) THROW_IE_EXCEPTION << "The outputs differ";
+        outputs.erase(output.first);
+    }
+    if (!outputs.empty()) THROW_IE_EXCEPTION << "The outputs differ";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    CommandLine commandLine("vpu_binary_network_benchmark", "[-m <model.xml>]... [-g <layers>] [-d <dir>] [-n <iterations>]");
+    commandLine.add("-m", options.models)
+               .add("-g", options.generateLayers, 2)
+               .add("-d", options.dir)
+               .add("-n", options.iterations, 1);
+
+    return runBenchmark(argc, argv, commandLine, [&]() {
+        if (options.models.empty() && !options.generateLayers) {
+            options.generateLayers = 4000;
+        }
+        if (options.generateLayers) {
+            options.models.push_back(generateModel(options.generateLayers, options.dir));
+        }
+
+        for (const auto& model : options.models) {
+            auto weights = baseOf(model) + ".bin";
+            auto binary = baseOf(model) + ".iebn";
+            ConvertToBinaryNetwork(model, binary);
+
+            double best[2] = {};
+            for (int i = 0; i < options.iterations; ++i) {
+                CNNNetReader xml, binaryReader;
+                auto xmlMs = readNetwork(xml, model, weights);
+                auto binaryMs = readNetwork(binaryReader, binary, weights);
+                if (i == 0) {
+                    compare(xml, binaryReader);
+                }
+                best[0] = i == 0 ? xmlMs : std::min(best[0], xmlMs);
+                best[1] = i == 0 ? binaryMs : std::min(best[1], binaryMs);
+            }
+
+            std::cout << model << ", best of " << options.iterations << std::endl << std::fixed << std::setprecision(1)
+                      << "  xml     " << std::setw(8) << fileSize(model) / 1024 << " KB  ReadNetwork " << std::setw(8)
+                      << best[0] << " ms" << std::endl
+                      << "  binary  " << std::setw(8) << fileSize(binary) / 1024 << " KB  ReadNetwork " << std::setw(8)
+                      << best[1] << " ms  " << best[0] / best[1] << "x" << std::defaultfloat << std::endl;
+        }
+        return 0;
+    });
+}
@@ -0,0 +1,323 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+
+
+// Executes the blob generated for the given network on the host reference executor,
+// prints estimated per-stage device cost and optionally compares the result with the CPU plugin:
+//
+//   vpu_blob_reference -m <model.xml> [-p MYRIAD_2|MYRIAD_X] [-hw] [-i <input.bin>] [-c KEY=VALUE]... [-cpu]
+//
+// The input file holds raw FP32 values in NCHW layout, random input is used without it.
+// Config options (-c) allow to compare the cost of the same network with different optimizations.
+
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <random>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+#include <inference_engine.hpp>
+#include <graph_transformer.hpp>
+#include <graph_transformer_impl.hpp>
+#include <reference_executor.hpp>
+#include <parsed_config.h>
+
+using namespace InferenceEngine;
+using namespace InferenceEngine::VPUConfigParams;
+
+namespace {
+
+struct Options {
+    std::string model;
+    std::string input;
+    int platform = MYRIAD_2;
+    bool hw = false;
+    bool compareWithCpu = false;
+    std::map<std::string, std::string> config;
+};
+
+void printUsage() {
+    std::cout << "Usage: vpu_blob_reference -m <model.xml> [-p MYRIAD_2|MYRIAD_X] [-hw] [-i <input.bin>] [-c KEY=VALUE]... [-cpu]" << std::endl;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-m" && i + 1 < argc) {
+            options.model = argv[++i];
+        } else if (arg == "-i" && i + 1 < argc) {
+            options.input = argv[++i];
+        } else if (arg == "-p" && i + 1 < argc) {
+            std::string platform = argv[++i];
+            if (platform == "MYRIAD_X") {
+                options.platform = MYRIAD_X;
+            } else if (platform == "MYRIAD_2") {
+                options.platform = MYRIAD_2;
+            } else {
+                return false;
+            }
+        } else if (arg == "-hw") {
+            options.hw = true;
+        } else if (arg == "-c" && i + 1 < argc) {
+            std::string option = argv[++i];
+            auto pos = option.find('=');
+            if (pos == std::string::npos) {
+                return false;
+            }
+            options.config[option.substr(0, pos)] = option.substr(pos + 1);
+        } else if (arg == "-cpu") {
+            options.compareWithCpu = true;
+        } else {
+            return false;
+        }
+    }
+
+    return !options.model.empty();
+}
+
+std::vector<char> compile(ICNNNetwork& network, const Options& options) {
+    auto config = options.config;
+    if (options.platform == MYRIAD_X) {
+        config[VPU_CONFIG_KEY(HW_STAGES_OPTIMIZATION)] = options.hw ? CONFIG_VALUE(YES) : CONFIG_VALUE(NO);
+    }
+
+    VPU::Common::ParsedConfig parsedConfig(options.platform, config);
+
+    auto log = std::make_shared<VPU::Common::Logger>();
+    log->init(VPU::Common::eLOGNONE);
+
+    std::vector<char> blob;
+    std::vector<VPU::BlobMetaData> metaData;
+    size_t numStages = 0;
+    VPU::createGraphTransformer(parsedConfig.blobConfig, log)->generate(network, blob, metaData, numStages);
+
+    return blob;
+}
+
+std::vector<float> readInput(const Options& options, size_t size) {
+    std::vector<float> input(size);
+
+    if (options.input.empty()) {
+        std::mt19937 gen(0);
+        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+        std::generate(input.begin(), input.end(), [&]() { return dist(gen); });
+        return input;
+    }
+
+    std::ifstream file(options.input, std::ios_base::binary | std::ios_base::ate);
+    if (!file.is_open()) {
+        THROW_IE_EXCEPTION << "Can't open input file " << options.input;
+    }
+
+    if (static_cast<size_t>(file.tellg()) != size * sizeof(float)) {
+        THROW_IE_EXCEPTION << "Input file contains " << static_cast<size_t>(file.tellg()) / sizeof(float)
+                           << " values, network expects " << size;
+    }
+
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(input.data()), input.size() * sizeof(float));
+    return input;
+}
+
+// Converts between NCHW and the device layout (see MyriadInferRequest)
+std::vector<float> convertLayout(const std::vector<float>& src, const SizeVector& dims, bool toDevice, bool hw) {
+    if (dims.size() != 4 || hw) {
+        return src;
+    }
+
+    auto N = dims[0], C = dims[1], H = dims[2], W = dims[3];
+
+    std::vector<float> dst(src.size());
+    for (size_t n = 0; n < N; ++n) {
+        for (size_t c = 0; c < C; ++c) {
+            for (size_t h = 0; h < H; ++h) {
+                for (size_t w = 0; w < W; ++w) {
+                    auto nchw = ((n * C + c) * H + h) * W + w;
+                    auto nhwc = ((n * H + h) * W + w) * C + c;
+                    if (toDevice) {
+                        dst[nhwc] = src[nchw];
+                    } else {
+                        dst[nchw] = src[nhwc];
+                    }
+                }
+            }
+        }
+    }
+    return dst;
+}
+
+std::vector<float> inferOnCpu(ICNNNetwork& network, const std::vector<float>& input) {
+    PluginDispatcher dispatcher({"/vendor/lib64", "/vendor/lib", "/system/lib64", "/system/lib", "", "./"});
+    InferencePlugin plugin(dispatcher.getSuitablePlugin(TargetDevice::eCPU));
+
+    InputsDataMap inputsInfo;
+    network.getInputsInfo(inputsInfo);
+    OutputsDataMap outputsInfo;
+    network.getOutputsInfo(outputsInfo);
+
+    auto executableNetwork = plugin.LoadNetwork(network, {});
+    auto request = executableNetwork.CreateInferRequest();
+
+    auto inputBlob = request.GetBlob(inputsInfo.begin()->first);
+    std::copy(input.begin(), input.end(), inputBlob->buffer().as<float*>());
+
+    request.Infer();
+
+    auto outputBlob = request.GetBlob(outputsInfo.begin()->first);
+    auto outputPtr = outputBlob->cbuffer().as<const float*>();
+    return std::vector<float>(outputPtr, outputPtr + outputBlob->size());
+}
+
+void reportCost(const VPU::BlobReferenceExecutor& executor) {
+    struct TypeCost {
+        size_t count = 0;
+        uint64_t cycles = 0;
+    };
+    std::map<std::string, TypeCost> typesCost;
+
+    std::cout << std::left << std::setw(6) << "#" << std::setw(24) << "type"
+              << std::right << std::setw(14) << "ops" << std::setw(12) << "bytes"
+              << std::setw(12) << "cycles" << std::setw(12) << "host ms" << std::endl;
+
+    const auto& stagesInfo = executor.stagesInfo();
+    for (size_t i = 0; i < stagesInfo.size(); ++i) {
+        const auto& info = stagesInfo[i];
+        auto typeName = mvTensorOpTypeToStr(info.type);
+
+        std::cout << std::left << std::setw(6) << i << std::setw(24) << typeName
+                  << std::right << std::setw(14) << info.numOps << std::setw(12) << info.numBytes
+                  << std::setw(12) << info.estimatedCycles
+                  << std::setw(12) << std::fixed << std::setprecision(3) << info.hostTimeMs << std::defaultfloat << std::endl;
+
+        auto& typeCost = typesCost[typeName];
+        ++typeCost.count;
+        typeCost.cycles += info.estimatedCycles;
+    }
+
+    std::cout << std::endl << "Estimated cycles per stage type:" << std::endl;
+    for (const auto& p : typesCost) {
+        std::cout << "    " << std::left << std::setw(24) << p.first << std::right
+                  << std::setw(6) << p.second.count << std::setw(14) << p.second.cycles << std::endl;
+    }
+
+    std::cout << std::endl << "Total : " << stagesInfo.size() << " stages, " << executor.estimatedCycles()
+              << " cycles, ~" << std::fixed << std::setprecision(3) << executor.estimatedTimeMs() << " ms at 600 MHz"
+              << std::defaultfloat << std::endl;
+}
+
+void reportAccuracy(const std::vector<float>& ref, const std::vector<float>& out) {
+    if (ref.size() != out.size()) {
+        std::cout << "Output size mismatch : " << out.size() << " vs " << ref.size() << std::endl;
+        return;
+    }
+
+    double errSum = 0.0, refSum = 0.0, maxErr = 0.0;
+    for (size_t i = 0; i < ref.size(); ++i) {
+        errSum += (out[i] - ref[i]) * (out[i] - ref[i]);
+        refSum += ref[i] * ref[i];
+        maxErr = std::max(maxErr, static_cast<double>(std::fabs(out[i] - ref[i])));
+    }
+
+    auto refTop = std::max_element(ref.begin(), ref.end()) - ref.begin();
+    auto outTop = std::max_element(out.begin(), out.end()) - out.begin();
+
+    std::cout << "Reference executor vs CPU plugin:" << std::endl;
+    std::cout << "    max abs error : " << maxErr << std::endl;
+    std::cout << "    relative L2 error : " << std::sqrt(errSum / std::max(refSum, 1e-30)) << std::endl;
+    std::cout << "    top-1 : " << refTop << " vs " << outTop << (refTop == outTop ? " (match)" : " (MISMATCH)") << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    try {
+        CNNNetReader reader;
+        reader.ReadNetwork(options.model);
+        reader.ReadWeights(options.model.substr(0, options.model.rfind('.')) + ".bin");
+        auto& network = reader.getNetwork();
+
+        auto inputsInfo = network.getInputsInfo();
+        auto outputsInfo = network.getOutputsInfo();
+
+        if (inputsInfo.size() != 1 || outputsInfo.size() != 1) {
+            THROW_IE_EXCEPTION << "Only networks with single input and single output are supported";
+        }
+
+        auto inputInfo = inputsInfo.begin()->second;
+        auto outputInfo = outputsInfo.begin()->second;
+
+        inputInfo->setPrecision(Precision::FP32);
+        inputInfo->setLayout(NCHW);
+        outputInfo->setPrecision(Precision::FP32);
+
+        auto blob = compile(network, options);
+
+        VPU::BlobReferenceExecutor executor(blob);
+
+        auto inputDims = inputInfo->getTensorDesc().getDims();
+        auto outputDims = outputInfo->getTensorDesc().getDims();
+
+        auto input = readInput(options, executor.inputSize() / sizeof(float));
+        auto deviceInput = convertLayout(input, inputDims, true, options.hw);
+
+        std::vector<float> deviceOutput(executor.outputSize() / sizeof(float));
+        executor.infer(deviceInput.data(), deviceOutput.data());
+
+        auto output = convertLayout(deviceOutput, outputDims, false, options.hw);
+
+        std::cout << "Blob : " << blob.size() << " bytes" << std::endl << std::endl;
+        reportCost(executor);
+
+        if (options.compareWithCpu) {
+            std::cout << std::endl;
+            reportAccuracy(inferOnCpu(network, input), output);
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
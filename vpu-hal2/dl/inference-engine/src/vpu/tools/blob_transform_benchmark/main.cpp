@@ -0,0 +1,432 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+
+// Checks and measures BlobTransform::convert, the layout and precision conversion of the blobs:
+//
+//   vpu_blob_transform_benchmark [-c <channels>] [-s <height> <width>] [-n <iterations>]
+//
+// The checks compare every instruction set the CPU supports with a reference converting element by element,
+// bit exact, over the NCHW, NHWC, nChw8c and nChw16c layouts, the supported precisions, with and without
+// a mean and a scale, and odd shapes. The FP32 to FP16 rounding is also compared with PrecisionUtils::f32tof16
+// over a sweep of the FP32 bit patterns.
+//
+// The measurements convert a <channels> x <height> x <width> frame, 3 x 1080 x 1920 by default, and print
+// the GB/s of the bytes read and written, the best of <iterations> runs, for the previous implementations:
+//   legacy        - the loops of ConvertBlobToLayout, followed by a precision conversion pass
+//   ConvertLayout - InferenceEngine::ConvertLayout, for the layout only conversions
+// and for BlobTransform::convert with each instruction set.
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+
+#include <inference_engine.hpp>
+#include "blob_transform.hpp"
+#include "precision_utils.h"
+#include "benchmark_harness.hpp"
+
+using namespace InferenceEngine;
+using namespace VPU::Tools;
+
+namespace {
+
+struct Options {
+    size_t channels = 3;
+    size_t height = 1080;
+    size_t width = 1920;
+    int iterations = 10;
+};
+
+std::vector<BlobTransform::Isa> supportedIsas() {
+    std::vector<BlobTransform::Isa> isas;
+    for (auto isa : {BlobTransform::SCALAR, BlobTransform::SSE42, BlobTransform::AVX2}) {
+        if (isa <= BlobTransform::getBestIsa()) isas.push_back(isa);
+    }
+    return isas;
+}
+
+// Layouts by name, 0 for NCHW and NHWC, else the block of the channels
+struct LayoutKind {
+    const char* name;
+    Layout layout;
+    size_t block;
+};
+
+const LayoutKind LAYOUTS[] = {{"NCHW", NCHW, 0}, {"NHWC", NHWC, 0}, {"nChw8c", BLOCKED, 8}, {"nChw16c", BLOCKED, 16}};
+
+TensorDesc makeDesc(Precision precision, const SizeVector& dims, const LayoutKind& kind) {
+    return kind.block ? BlobTransform::makeBlockedDesc(precision, dims, kind.block) : TensorDesc(precision, dims, kind.layout);
+}
+
+size_t byteSize(const TensorDesc& desc) {
+    size_t size = desc.getPrecision().size();
+    for (auto dim : desc.getBlockingDesc().getBlockDims()) {
+        size *= dim;
+    }
+    return size;
+}
+
+size_t offset(const SizeVector& dims, const LayoutKind& kind, size_t n, size_t c, size_t h, size_t w) {
+    const size_t C = dims[1], H = dims[2], W = dims[3];
+    if (kind.layout == NCHW) return ((n * C + c) * H + h) * W + w;
+    if (kind.layout == NHWC) return ((n * H + h) * W + w) * C + c;
+    const size_t B = kind.block, blocks = (C + B - 1) / B;
+    return (((n * blocks + c / B) * H + h) * W + w) * B + c % B;
+}
+
+float load(Precision precision, const uint8_t* data, size_t index) {
+    switch (precision) {
+    case Precision::U8:
+        return data[index];
+    case Precision::FP16:
+        return PrecisionUtils::f16tof32(reinterpret_cast<const ie_fp16*>(data)[index]);
+    default:
+        return reinterpret_cast<const float*>(data)[index];
+    }
+}
+
+// Element by element, the copies keep the bits
+void referenceConvert(const SizeVector& dims, Precision srcPrecision, const LayoutKind& srcKind, const uint8_t* src,
+                      Precision dstPrecision, const LayoutKind& dstKind, uint8_t* dst,
+                      const float* mean, const float* scale) {
+    const size_t es = srcPrecision.size(), ed = dstPrecision.size();
+    for (size_t n = 0; n < dims[0]; ++n) {
+        for (size_t c = 0; c < dims[1]; ++c) {
+            for (size_t h = 0; h < dims[2]; ++h) {
+                for (size_t w = 0; w < dims[3]; ++w) {
+                    size_t s = offset(dims, srcKind, n, c, h, w), d = offset(dims, dstKind, n, c, h, w);
+                    if (srcPrecision == dstPrecision && !mean && !scale) {
+                        std::memcpy(dst + d * ed, src + s * es, es);
+                        continue;
+                    }
+                    float value = (load(srcPrecision, src, s) - (mean ? mean[c] : 0.f)) * (scale ? scale[c] : 1.f);
+                    if (dstPrecision == Precision::FP16) {
+                        reinterpret_cast<ie_fp16*>(dst)[d] = PrecisionUtils::f32tof16(value);
+                    } else {
+                        reinterpret_cast<float*>(dst)[d] = value;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void fillRandom(Precision precision, std::vector<uint8_t>& data, std::mt19937& random) {
+    std::uniform_real_distribution<float> values(-300.f, 300.f);
+    if (precision == Precision::U8) {
+        for (auto& byte : data) byte = static_cast<uint8_t>(random());
+    } else if (precision == Precision::FP16) {
+        auto fp16 = reinterpret_cast<ie_fp16*>(data.data());
+        for (size_t i = 0; i < data.size() / 2; ++i) fp16[i] = PrecisionUtils::f32tof16(values(random));
+    } else {
+        auto fp32 = reinterpret_cast<float*>(data.data());
+        for (size_t i = 0; i < data.size() / 4; ++i) fp32[i] = values(random);
+    }
+}
+
+// Every layout pair, precision pair, mean and scale, shape and instruction set against the reference
+void verifyConversions() {
+    const std::vector<SizeVector> shapes = {
+        {2, 3, 5, 7}, {1, 1, 4, 9}, {1, 2, 3, 70}, {1, 4, 8, 40}, {1, 8, 6, 5},
+        {1, 16, 2, 33}, {1, 17, 3, 11}, {3, 24, 7, 9}, {1, 32, 1, 37},
+    };
+    const std::vector<std::pair<Precision, Precision>> precisions = {
+        {Precision::U8, Precision::U8}, {Precision::U8, Precision::FP16}, {Precision::U8, Precision::FP32},
+        {Precision::FP16, Precision::FP16}, {Precision::FP16, Precision::FP32},
+        {Precision::FP32, Precision::FP16}, {Precision::FP32, Precision::FP32},
+    };
+
+    std::mt19937 random(42);
+    size_t conversions = 0;
+    for (const auto& dims : shapes) {
+        std::vector<float> mean(dims[1]), scale(dims[1]);
+        for (size_t c = 0; c < dims[1]; ++c) {
+            mean[c] = 10.f * c + 0.5f;
+            scale[c] = 1.f / (c + 3.f);
+        }
+
+        for (const auto& precision : precisions) {
+            for (const auto& srcKind : LAYOUTS) {
+                auto srcDesc = makeDesc(precision.first, dims, srcKind);
+                std::vector<uint8_t> src(byteSize(srcDesc));
+                fillRandom(precision.first, src, random);
+
+                for (const auto& dstKind : LAYOUTS) {
+                    auto dstDesc = makeDesc(precision.second, dims, dstKind);
+                    for (bool affine : {false, true}) {
+                        if (affine && precision.second == Precision::U8) continue;
+                        const float* m = affine ? mean.data() : nullptr;
+                        const float* k = affine ? scale.data() : nullptr;
+
+                        std::vector<uint8_t> expected(byteSize(dstDesc), 0);
+                        referenceConvert(dims, precision.first, srcKind, src.data(), precision.second, dstKind,
+                                         expected.data(), m, k);
+                        for (auto isa : supportedIsas()) {
+                            std::vector<uint8_t> actual(expected.size(), 0xAB);
+                            BlobTransform::convert(srcDesc, src.data(), dstDesc, actual.data(), m, k, isa);
+
+                            std::ostringstream what;
+                            what << precision.first << " " << srcKind.name << " to " << precision.second << " "
+                                 << dstKind.name << (affine ? " with mean and scale" : "") << ", dims "
+                                 << dims[0] << "x" << dims[1] << "x" << dims[2] << "x" << dims[3] << ", "
+                                 << BlobTransform::getIsaName(isa);
+                            check(actual == expected, what.str());
+                            ++conversions;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // FP32 to FP16 rounding, including the denormals, the overflows, the infinities and the NANs
+    std::vector<float> values;
+    for (uint64_t bits = 0; bits <= 0xFFFFFFFFull; bits += 4099) {
+        uint32_t pattern = static_cast<uint32_t>(bits);
+        float value;
+        std::memcpy(&value, &pattern, sizeof(value));
+        values.push_back(value);
+    }
+    for (float value : {0.f, -0.f, 65504.f, 65519.f, 65520.f, -65520.f, 6.1035156e-05f, 2.9802322e-08f,
+                        2.9802326e-08f, 5.9604645e-08f, INFINITY, -INFINITY, NAN}) {
+        values.push_back(value);
+    }
+    std::vector<ie_fp16> expected(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        expected[i] = PrecisionUtils::f32tof16(values[i]);
+    }
+    for (auto isa : supportedIsas()) {
+        std::vector<ie_fp16> actual(values.size());
+        SizeVector dims = {1, 1, 1, values.size()};
+        BlobTransform::convert(TensorDesc(Precision::FP32, dims, NCHW), values.data(),
+                               TensorDesc(Precision::FP16, dims, NCHW), actual.data(), nullptr, nullptr, isa);
+        check(actual == expected, std::string("FP32 to FP16 rounding, ") + BlobTransform::getIsaName(isa));
+    }
+
+    std::cout << conversions << " conversions and " << values.size() << " FP16 roundings checked, instruction sets:";
+    for (auto isa : supportedIsas()) {
+        std::cout << " " << BlobTransform::getIsaName(isa);
+    }
+    std::cout << std::endl;
+}
+
+//
+// The previous implementations
+//
+
+// The loops of ConvertBlobToLayout, a single image
+template <typename T>
+void legacyLayout(const SizeVector& dims, Layout from, const T* src, T* dst) {
+    const size_t C = dims[1], H = dims[2], W = dims[3];
+    if (from == NCHW) {
+        for (size_t c = 0; c < C; ++c) {
+            for (size_t h = 0; h < H; ++h) {
+                for (size_t w = 0; w < W; ++w) {
+                    dst[c + w * C + h * C * W] = *src++;
+                }
+            }
+        }
+    } else {
+        for (size_t c = 0; c < C; ++c) {
+            for (size_t h = 0; h < H; ++h) {
+                size_t offs = h * C * W + c;
+                for (size_t w = 0; w < W; ++w) {
+                    *dst++ = src[w * C + offs];
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+void legacyConvert(const SizeVector& dims, Layout from, Layout to, Precision toPrecision,
+                   const void* src, void* dst, std::vector<uint8_t>& tmp, const float* mean, const float* scale) {
+    const size_t size = dims[1] * dims[2] * dims[3], plane = dims[2] * dims[3];
+    const T* converted = static_cast<const T*>(src);
+    if (from != to) {
+        tmp.resize(size * sizeof(T));
+        legacyLayout<T>(dims, from, converted, reinterpret_cast<T*>(tmp.data()));
+        converted = reinterpret_cast<const T*>(tmp.data());
+    }
+    for (size_t i = 0; i < size; ++i) {
+        size_t c = to == NCHW ? i / plane : i % dims[1];
+        float value = (static_cast<float>(converted[i]) - (mean ? mean[c] : 0.f)) * (scale ? scale[c] : 1.f);
+        if (toPrecision == Precision::FP16) {
+            static_cast<ie_fp16*>(dst)[i] = PrecisionUtils::f32tof16(value);
+        } else {
+            static_cast<float*>(dst)[i] = value;
+        }
+    }
+}
+
+struct Case {
+    const char* name;
+    Precision srcPrecision;
+    Layout srcLayout;
+    Precision dstPrecision;
+    size_t dstBlock;
+    Layout dstLayout;
+    bool affine;
+};
+
+double gbps(size_t bytes, double seconds) {
+    return bytes / seconds / 1e9;
+}
+
+void benchmark(const Options& options) {
+    const SizeVector dims = {1, options.channels, options.height, options.width};
+    const std::vector<Case> cases = {
+        {"U8 NHWC to NCHW", Precision::U8, NHWC, Precision::U8, 0, NCHW, false},
+        {"U8 NCHW to NHWC", Precision::U8, NCHW, Precision::U8, 0, NHWC, false},
+        {"FP16 NHWC to NCHW", Precision::FP16, NHWC, Precision::FP16, 0, NCHW, false},
+        {"FP16 NCHW to NHWC", Precision::FP16, NCHW, Precision::FP16, 0, NHWC, false},
+        {"FP32 NHWC to NCHW", Precision::FP32, NHWC, Precision::FP32, 0, NCHW, false},
+        {"FP32 NCHW to NHWC", Precision::FP32, NCHW, Precision::FP32, 0, NHWC, false},
+        {"U8 NHWC to FP16 NCHW, mean", Precision::U8, NHWC, Precision::FP16, 0, NCHW, true},
+        {"U8 NHWC to FP32 NCHW, mean", Precision::U8, NHWC, Precision::FP32, 0, NCHW, true},
+        {"FP32 NCHW to FP16 NCHW", Precision::FP32, NCHW, Precision::FP16, 0, NCHW, false},
+        {"FP32 NHWC to FP16 NCHW", Precision::FP32, NHWC, Precision::FP16, 0, NCHW, false},
+        {"FP32 NCHW to nChw8c", Precision::FP32, NCHW, Precision::FP32, 8, BLOCKED, false},
+        {"FP32 NCHW to nChw16c", Precision::FP32, NCHW, Precision::FP32, 16, BLOCKED, false},
+    };
+
+    std::vector<float> mean(options.channels, 127.5f), scale(options.channels, 1.f / 128.f);
+    std::mt19937 random(7);
+    std::vector<uint8_t> tmp;
+
+    std::cout << dims[1] << "x" << dims[2] << "x" << dims[3] << ", GB/s of the bytes read and written, best of "
+              << options.iterations << std::endl;
+    std::cout << std::left << std::setw(30) << "conversion" << std::right << std::setw(10) << "legacy"
+              << std::setw(15) << "ConvertLayout";
+    for (auto isa : supportedIsas()) {
+        std::cout << std::setw(10) << BlobTransform::getIsaName(isa);
+    }
+    std::cout << std::endl;
+
+    for (const auto& c : cases) {
+        auto srcDesc = TensorDesc(c.srcPrecision, dims, c.srcLayout);
+        auto dstDesc = c.dstBlock ? BlobTransform::makeBlockedDesc(c.dstPrecision, dims, c.dstBlock)
+                                  : TensorDesc(c.dstPrecision, dims, c.dstLayout);
+        std::vector<uint8_t> src(byteSize(srcDesc)), dst(byteSize(dstDesc));
+        fillRandom(c.srcPrecision, src, random);
+        const size_t bytes = src.size() + dst.size();
+        const float* m = c.affine ? mean.data() : nullptr;
+        const float* k = c.affine ? scale.data() : nullptr;
+
+        std::cout << std::left << std::setw(30) << c.name << std::right << std::fixed << std::setprecision(2);
+        if (c.dstBlock) {
+            std::cout << std::setw(10) << "-";
+        } else {
+            std::function<void()> legacy;
+            if (c.srcPrecision == c.dstPrecision && !c.affine) {
+                legacy = [&]() {
+                    if (c.srcPrecision == Precision::U8) {
+                        legacyLayout<uint8_t>(dims, c.srcLayout, src.data(), dst.data());
+                    } else if (c.srcPrecision == Precision::FP16) {
+                        legacyLayout<ie_fp16>(dims, c.srcLayout, reinterpret_cast<const ie_fp16*>(src.data()),
+                                              reinterpret_cast<ie_fp16*>(dst.data()));
+                    } else {
+                        legacyLayout<float>(dims, c.srcLayout, reinterpret_cast<const float*>(src.data()),
+                                            reinterpret_cast<float*>(dst.data()));
+                    }
+                };
+            } else {
+                legacy = [&]() {
+                    if (c.srcPrecision == Precision::U8) {
+                        legacyConvert<uint8_t>(dims, c.srcLayout, c.dstLayout, c.dstPrecision, src.data(),
+                                               dst.data(), tmp, m, k);
+                    } else {
+                        legacyConvert<float>(dims, c.srcLayout, c.dstLayout, c.dstPrecision, src.data(),
+                                             dst.data(), tmp, m, k);
+                    }
+                };
+            }
+            std::cout << std::setw(10) << gbps(bytes, measureBest(options.iterations, legacy));
+        }
+
+        if (c.srcPrecision == c.dstPrecision && !c.affine && !c.dstBlock) {
+            // ConvertLayout takes the dims in the reversed order
+            SizeVector reversed(dims.rbegin(), dims.rend());
+            auto convertLayout = [&]() {
+                if (c.srcPrecision == Precision::U8) {
+                    ConvertLayout<uint8_t>(c.srcLayout, c.dstLayout, src.data(), dst.data(), reversed);
+                } else if (c.srcPrecision == Precision::FP16) {
+                    ConvertLayout<ie_fp16>(c.srcLayout, c.dstLayout, reinterpret_cast<const ie_fp16*>(src.data()),
+                                           reinterpret_cast<ie_fp16*>(dst.data()), reversed);
+                } else {
+                    ConvertLayout<float>(c.srcLayout, c.dstLayout, reinterpret_cast<const float*>(src.data()),
+                                         reinterpret_cast<float*>(dst.data()), reversed);
+                }
+            };
+            std::cout << std::setw(15) << gbps(bytes, measureBest(std::min(options.iterations, 3), convertLayout));
+        } else {
+            std::cout << std::setw(15) << "-";
+        }
+
+        for (auto isa : supportedIsas()) {
+            double seconds = measureBest(options.iterations, [&]() {
+                BlobTransform::convert(srcDesc, src.data(), dstDesc, dst.data(), m, k, isa);
+            });
+            std::cout << std::setw(10) << gbps(bytes, seconds);
+        }
+        std::cout << std::defaultfloat << std::endl;
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    CommandLine commandLine("vpu_blob_transform_benchmark", "[-c <channels>] [-s <height> <width>] [-n <iterations>]");
+    commandLine.add("-c", options.channels, size_t(1))
+               .add("-s", 2, [&](const std::vector<std::string>& values) {
+                    options.height = std::max(std::stoi(values[0]), 1);
+                    options.width = std::max(std::stoi(values[1]), 1);
+                })
+               .add("-n", options.iterations, 1);
+
+    return runBenchmark(argc, argv, commandLine, [&]() {
+        verifyConversions();
+        benchmark(options);
+        return 0;
+    });
+}
@@ -0,0 +1,240 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <functional>
+#include <type_traits>
+
+#include <details/ie_exception.hpp>
+
+namespace VPU {
+namespace Tools {
+
+// Shared by the benchmark tools: command line, timing and output of the results
+
+using Clock = std::chrono::steady_clock;
+
+inline double toUs(Clock::duration duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+inline double toMs(Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+inline double toSeconds(Clock::duration duration) {
+    return std::chrono::duration<double>(duration).count();
+}
+
+// The benchmarks check their results before timing them
+inline void check(bool condition, const std::string& what) {
+    if (!condition) THROW_IE_EXCEPTION << "Check failed: " << what;
+}
+
+// Best time of the runs, in seconds
+inline double measureBest(int iterations, const std::function<void()>& run) {
+    double best = 0;
+    for (int i = 0; i < iterations; ++i) {
+        auto start = Clock::now();
+        run();
+        double seconds = toSeconds(Clock::now() - start);
+        best = i == 0 ? seconds : std::min(best, seconds);
+    }
+    return best;
+}
+
+// Runs body(t) on each of the threads, the wall time in seconds.
+// The first exception of the threads is rethrown once they are all joined.
+template <typename Body>
+double runThreads(int threads, const Body& body) {
+    std::vector<std::thread> workers;
+    std::vector<std::exception_ptr> errors(threads);
+    auto start = Clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&body, &errors, t]() {
+            try {
+                body(t);
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    auto seconds = toSeconds(Clock::now() - start);
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+    return seconds;
+}
+
+inline std::vector<double> mergeSamples(const std::vector<std::vector<double>>& perThread) {
+    std::vector<double> all;
+    for (const auto& samples : perThread) {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+    return all;
+}
+
+// Prints "  <label> p50 <us> us, p99 <us> us" of the samples, nothing when there are none
+inline void printPercentiles(std::ostream& os, const std::string& label, std::vector<double> samplesUs) {
+    if (samplesUs.empty()) {
+        return;
+    }
+    std::sort(samplesUs.begin(), samplesUs.end());
+    auto p50 = samplesUs[samplesUs.size() / 2];
+    auto p99 = samplesUs[std::min(samplesUs.size() - 1, samplesUs.size() * 99 / 100)];
+    os << std::fixed << std::setprecision(1) << "  " << (label.empty() ? "" : label + " ") << "p50 "
+       << std::setw(7) << p50 << " us, p99 " << std::setw(8) << p99 << " us" << std::defaultfloat;
+}
+
+// Prints "<requests>  <name>" starting the rows of the benchmarks run with 1..N requests in flight
+inline void printRowHeader(std::ostream& os, int requests, const std::string& name, int nameWidth) {
+    os << std::setw(8) << requests << "  " << std::left << std::setw(nameWidth) << name << std::right;
+}
+
+// Command line of "-<name> <values>" options, each bound to a variable of the tool
+class CommandLine {
+public:
+    using Handler = std::function<void(const std::vector<std::string>&)>;
+
+    // usage is the part of the usage line after the tool name
+    CommandLine(const std::string& tool, const std::string& usage) : _tool(tool), _usage(usage) {}
+
+    // Option taking arity values, arity < 0 takes the values until the next option
+    CommandLine& add(const std::string& name, int arity, const Handler& handler) {
+        _options.push_back({name, arity, handler});
+        return *this;
+    }
+
+    // Integer option, values below minValue are raised to it
+    template <typename T, typename = typename std::enable_if<std::is_integral<T>::value>::type>
+    CommandLine& add(const std::string& name, T& value, T minValue) {
+        return add(name, 1, [&value, minValue](const std::vector<std::string>& values) {
+            value = static_cast<T>(std::max<long long>(std::stoll(values[0]), minValue));
+        });
+    }
+
+    CommandLine& add(const std::string& name, std::string& value) {
+        return add(name, 1, [&value](const std::vector<std::string>& values) { value = values[0]; });
+    }
+
+    // Option which may be repeated, "-m a -m b"
+    CommandLine& add(const std::string& name, std::vector<std::string>& values) {
+        return add(name, 1, [&values](const std::vector<std::string>& v) { values.push_back(v[0]); });
+    }
+
+    // Option with the list of integers up to the next option, "-r 8 64 256"
+    CommandLine& add(const std::string& name, std::vector<int>& list, int minValue) {
+        return add(name, -1, [&list, minValue](const std::vector<std::string>& values) {
+            for (const auto& value : values) {
+                list.push_back(std::max(std::stoi(value), minValue));
+            }
+        });
+    }
+
+    // false on an unknown option, a missing value or a value which isn't a number
+    bool parse(int argc, char* argv[]) const {
+        for (int i = 1; i < argc; ++i) {
+            auto option = std::find_if(_options.begin(), _options.end(),
+                                       [&](const Option& o) { return o.name == argv[i]; });
+            if (option == _options.end()) {
+                return false;
+            }
+            std::vector<std::string> values;
+            if (option->arity < 0) {
+                while (i + 1 < argc && argv[i + 1][0] != '-') {
+                    values.push_back(argv[++i]);
+                }
+            } else {
+                if (i + option->arity >= argc) {
+                    return false;
+                }
+                values.assign(argv + i + 1, argv + i + 1 + option->arity);
+                i += option->arity;
+            }
+            if (values.empty()) {
+                return false;
+            }
+            try {
+                option->handler(values);
+            } catch (const std::logic_error&) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void printUsage() const {
+        std::cout << "Usage: " << _tool << " " << _usage << std::endl;
+    }
+
+private:
+    struct Option {
+        std::string name;
+        int arity;
+        Handler handler;
+    };
+
+    std::string _tool;
+    std::string _usage;
+    std::vector<Option> _options;
+};
+
+// main() of the tools: parses the command line and runs the benchmark, the exceptions are
+// reported and end the tool with 1, otherwise its exit code is the one of the benchmark
+inline int runBenchmark(int argc, char* argv[], const CommandLine& commandLine, const std::function<int()>& benchmark) {
+    if (!commandLine.parse(argc, argv)) {
+        commandLine.printUsage();
+        return 1;
+    }
+    try {
+        return benchmark();
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+}
+
+}  // namespace Tools
+}  // namespace VPU
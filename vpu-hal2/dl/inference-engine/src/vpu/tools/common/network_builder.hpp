@@ -0,0 +1,259 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <random>
+#include <sstream>
+#include <numeric>
+#include <algorithm>
+#include <functional>
+
+#include <inference_engine.hpp>
+#include <precision_utils.h>
+
+namespace VPU {
+namespace Tools {
+
+// Builds FP16 IR v2 networks with random weights for the VPU tools and tests.
+// All layers work with a single image, dimensions are given in CHW order.
+class NetworkBuilder {
+public:
+    struct Port {
+        int layer;
+        int port;
+        std::vector<size_t> dims;
+    };
+
+    explicit NetworkBuilder(const std::string& name, uint32_t seed = 0) : _name(name), _gen(seed) {}
+
+    Port input(size_t c, size_t h, size_t w) {
+        auto id = addLayer("data", "Input", "", {}, {{c, h, w}}, "");
+        return {id, 0, {c, h, w}};
+    }
+
+    Port conv(const Port& in, size_t outC, size_t kernel, size_t stride, size_t pad,
+              size_t group = 1, bool withBiases = true) {
+        auto outH = (in.dims[1] + 2 * pad - kernel) / stride + 1;
+        auto outW = (in.dims[2] + 2 * pad - kernel) / stride + 1;
+
+        std::ostringstream data;
+        data << "<data stride-x=\"" << stride << "\" stride-y=\"" << stride
+             << "\" pad-x=\"" << pad << "\" pad-y=\"" << pad
+             << "\" kernel-x=\"" << kernel << "\" kernel-y=\"" << kernel
+             << "\" output=\"" << outC << "\" group=\"" << group << "\"/>";
+
+        auto numWeights = outC * in.dims[0] / group * kernel * kernel;
+        auto blobs = addBlobs(numWeights, withBiases ? outC : 0);
+        return output(addLayer("conv", "Convolution", data.str(), {in}, {{outC, outH, outW}}, blobs), {outC, outH, outW});
+    }
+
+    Port relu(const Port& in) {
+        return output(addLayer("relu", "ReLU", "", {in}, {in.dims}, ""), in.dims);
+    }
+
+    Port pool(const Port& in, size_t kernel, size_t stride, size_t pad, const char* method = "max") {
+        auto outH = (in.dims[1] + 2 * pad - kernel + stride - 1) / stride + 1;
+        auto outW = (in.dims[2] + 2 * pad - kernel + stride - 1) / stride + 1;
+
+        std::ostringstream data;
+        data << "<data kernel-x=\"" << kernel << "\" kernel-y=\"" << kernel
+             << "\" stride-x=\"" << stride << "\" stride-y=\"" << stride
+             << "\" pad-x=\"" << pad << "\" pad-y=\"" << pad
+             << "\" pool-method=\"" << method << "\" exclude-pad=\"false\"/>";
+
+        std::vector<size_t> dims = {in.dims[0], outH, outW};
+        return output(addLayer("pool", "Pooling", data.str(), {in}, {dims}, ""), dims);
+    }
+
+    Port concat(const std::vector<Port>& ins) {
+        size_t c = 0;
+        for (const auto& in : ins) {
+            c += in.dims[0];
+        }
+
+        std::vector<size_t> dims = {c, ins[0].dims[1], ins[0].dims[2]};
+        return output(addLayer("concat", "Concat", "<data axis=\"1\"/>", ins, {dims}, ""), dims);
+    }
+
+    // Splits the channels into the given parts, type is "Split" or "Slice"
+    std::vector<Port> split(const Port& in, const std::vector<size_t>& channels, const char* type = "Split") {
+        std::vector<std::vector<size_t>> outDims;
+        for (auto c : channels) {
+            outDims.push_back({c, in.dims[1], in.dims[2]});
+        }
+
+        auto id = addLayer("split", type, "<data axis=\"1\"/>", {in}, outDims, "");
+
+        std::vector<Port> outs;
+        for (size_t i = 0; i < outDims.size(); ++i) {
+            outs.push_back({id, static_cast<int>(1 + i), outDims[i]});
+        }
+        return outs;
+    }
+
+    Port fc(const Port& in, size_t outSize, bool withBiases = true) {
+        std::ostringstream data;
+        data << "<data out-size=\"" << outSize << "\"/>";
+
+        auto numWeights = std::accumulate(in.dims.begin(), in.dims.end(), outSize, std::multiplies<size_t>());
+        auto blobs = addBlobs(numWeights, withBiases ? outSize : 0);
+        return output(addLayer("fc", "FullyConnected", data.str(), {in}, {{outSize}}, blobs), {outSize});
+    }
+
+    Port softmax(const Port& in) {
+        return output(addLayer("prob", "SoftMax", "<data axis=\"1\"/>", {in}, {in.dims}, ""), in.dims);
+    }
+
+    // Per-channel scale with optional shift
+    Port scaleShift(const Port& in, bool withBiases = true) {
+        auto c = in.dims[0];
+        auto blobs = addBlobs(c, withBiases ? c : 0, 0.5f, 1.5f);
+        return output(addLayer("scale", "ScaleShift", "", {in}, {in.dims}, blobs), in.dims);
+    }
+
+    // Weights hold variance (must be positive), biases hold mean
+    Port batchNorm(const Port& in) {
+        auto c = in.dims[0];
+        auto blobs = addBlobs(c, c, 0.5f, 2.0f);
+        return output(addLayer("bn", "BatchNormalization", "<data epsilon=\"0.00001\"/>", {in}, {in.dims}, blobs), in.dims);
+    }
+
+    Port power(const Port& in, float power, float scale, float shift) {
+        std::ostringstream data;
+        data << "<data power=\"" << power << "\" scale=\"" << scale << "\" shift=\"" << shift << "\"/>";
+        return output(addLayer("power", "Power", data.str(), {in}, {in.dims}, ""), in.dims);
+    }
+
+    // operation is "sum", "mul" or "max"
+    Port eltwise(const std::vector<Port>& ins, const char* operation) {
+        std::ostringstream data;
+        data << "<data operation=\"" << operation << "\"/>";
+        return output(addLayer("eltwise", "Eltwise", data.str(), ins, {ins[0].dims}, ""), ins[0].dims);
+    }
+
+    std::string xml() const {
+        std::ostringstream xml;
+        xml << "<?xml version=\"1.0\" ?>" << std::endl
+            << "<net name=\"" << _name << "\" version=\"2\" batch=\"1\">" << std::endl
+            << "<layers>" << std::endl << _layers.str() << "</layers>" << std::endl
+            << "<edges>" << std::endl << _edges.str() << "</edges>" << std::endl
+            << "</net>" << std::endl;
+        return xml.str();
+    }
+
+    void build(InferenceEngine::CNNNetReader& reader) const {
+        using namespace InferenceEngine;
+
+        auto xmlStr = xml();
+        reader.ReadNetwork(xmlStr.data(), xmlStr.size());
+
+        auto weights = make_shared_blob<uint8_t>(Precision::U8, C, {_weights.size() * sizeof(InferenceEngine::ie_fp16)});
+        weights->allocate();
+        std::copy_n(reinterpret_cast<const uint8_t*>(_weights.data()), _weights.size() * sizeof(InferenceEngine::ie_fp16), weights->buffer().as<uint8_t*>());
+        reader.SetWeights(weights);
+    }
+
+private:
+    // Single output layers have the output port right after the inputs
+    Port output(int id, const std::vector<size_t>& dims) const {
+        return {id, static_cast<int>(_numInputs[id]), dims};
+    }
+
+    static void writePort(std::ostream& os, int id, const std::vector<size_t>& dims) {
+        os << "<port id=\"" << id << "\"><dim>1</dim>";
+        for (auto d : dims) {
+            os << "<dim>" << d << "</dim>";
+        }
+        os << "</port>";
+    }
+
+    std::string addBlobs(size_t numWeights, size_t numBiases, float minVal = -0.1f, float maxVal = 0.1f) {
+        std::ostringstream blobs;
+        blobs << "<blobs><weights offset=\"" << _weights.size() * sizeof(InferenceEngine::ie_fp16) << "\" size=\"" << numWeights * sizeof(InferenceEngine::ie_fp16) << "\"/>";
+        appendRandom(numWeights, minVal, maxVal);
+        if (numBiases > 0) {
+            blobs << "<biases offset=\"" << _weights.size() * sizeof(InferenceEngine::ie_fp16) << "\" size=\"" << numBiases * sizeof(InferenceEngine::ie_fp16) << "\"/>";
+            appendRandom(numBiases, -0.1f, 0.1f);
+        }
+        blobs << "</blobs>";
+        return blobs.str();
+    }
+
+    void appendRandom(size_t count, float minVal, float maxVal) {
+        std::uniform_real_distribution<float> dist(minVal, maxVal);
+        for (size_t i = 0; i < count; ++i) {
+            _weights.push_back(InferenceEngine::PrecisionUtils::f32tof16(dist(_gen)));
+        }
+    }
+
+    int addLayer(const std::string& prefix, const std::string& type, const std::string& data,
+                 const std::vector<Port>& ins, const std::vector<std::vector<size_t>>& outDims, const std::string& blobs) {
+        auto id = _numLayers++;
+
+        _layers << "<layer id=\"" << id << "\" name=\"" << prefix << id << "\" precision=\"FP16\" type=\"" << type << "\">" << data;
+
+        if (!ins.empty()) {
+            _layers << "<input>";
+            for (size_t i = 0; i < ins.size(); ++i) {
+                writePort(_layers, static_cast<int>(i), ins[i].dims);
+                _edges << "<edge from-layer=\"" << ins[i].layer << "\" from-port=\"" << ins[i].port
+                       << "\" to-layer=\"" << id << "\" to-port=\"" << i << "\"/>" << std::endl;
+            }
+            _layers << "</input>";
+        }
+
+        _layers << "<output>";
+        for (size_t i = 0; i < outDims.size(); ++i) {
+            writePort(_layers, static_cast<int>(ins.size() + i), outDims[i]);
+        }
+        _layers << "</output>" << blobs << "</layer>" << std::endl;
+
+        _numInputs.push_back(ins.size());
+
+        return id;
+    }
+
+    std::string _name;
+    int _numLayers = 0;
+    std::vector<size_t> _numInputs;
+    std::ostringstream _layers;
+    std::ostringstream _edges;
+    std::vector<InferenceEngine::ie_fp16> _weights;
+    std::mt19937 _gen;
+};
+
+}  // namespace Tools
+}  // namespace VPU
@@ -0,0 +1,395 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+
+
+// Measures GraphTransformer compile time per pass without a device attached:
+//
+//   vpu_compile_benchmark [-p MYRIAD_2|MYRIAD_X] [-hw] [-n <iterations>] [-m <model.xml>]...
+//                         [-o <results.json>] [-baseline <results.json>]
+//
+// Built-in synthetic networks are always compiled, real IRs (AlexNet, GoogLeNet, MobileNet, SSD, ...)
+// are added with -m. The best time of all iterations is reported for every pass, along with the blob size.
+// With -baseline the tool returns non-zero exit code if the output of any pass differs from the baseline:
+// the pass list, the stage counts and the pass counters (fusions, eliminated copies, allocator
+// iterations, blob size, ...). These don't depend on the host, the times are printed next to the
+// baseline ones for information only.
+//
+// baseline.json and baseline_myriadx_hw.json next to this file are the results of the default
+// and `-p MYRIAD_X -hw` runs on the synthetic networks, regenerate them after intended changes with
+//
+//   vpu_compile_benchmark -n 20 -o baseline.json
+//   vpu_compile_benchmark -p MYRIAD_X -hw -n 20 -o baseline_myriadx_hw.json
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+#include <inference_engine.hpp>
+#include <graph_transformer.hpp>
+#include <parsed_config.h>
+#include <network_builder.hpp>
+
+using namespace InferenceEngine;
+using namespace InferenceEngine::VPUConfigParams;
+using VPU::Tools::NetworkBuilder;
+
+namespace {
+
+struct Options {
+    std::vector<std::string> models;
+    std::string output;
+    std::string baseline;
+    int platform = MYRIAD_2;
+    bool hw = false;
+    int iterations = 5;
+};
+
+void printUsage() {
+    std::cout << "Usage: vpu_compile_benchmark [-p MYRIAD_2|MYRIAD_X] [-hw] [-n <iterations>] [-m <model.xml>]..." << std::endl
+              << "                             [-o <results.json>] [-baseline <results.json>]" << std::endl;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-m" && i + 1 < argc) {
+            options.models.push_back(argv[++i]);
+        } else if (arg == "-o" && i + 1 < argc) {
+            options.output = argv[++i];
+        } else if (arg == "-baseline" && i + 1 < argc) {
+            options.baseline = argv[++i];
+        } else if (arg == "-n" && i + 1 < argc) {
+            options.iterations = std::stoi(argv[++i]);
+            if (options.iterations < 1) {
+                return false;
+            }
+        } else if (arg == "-p" && i + 1 < argc) {
+            std::string platform = argv[++i];
+            if (platform == "MYRIAD_X") {
+                options.platform = MYRIAD_X;
+            } else if (platform == "MYRIAD_2") {
+                options.platform = MYRIAD_2;
+            } else {
+                return false;
+            }
+        } else if (arg == "-hw") {
+            options.hw = true;
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//
+// Synthetic networks
+//
+
+// Plain chain of convolutions, similar to VGG
+void buildSyntheticConvNet(CNNNetReader& reader) {
+    NetworkBuilder builder("synthetic_convnet");
+
+    auto cur = builder.input(3, 224, 224);
+    size_t channels = 16;
+    for (int block = 0; block < 5; ++block) {
+        for (int i = 0; i < 3; ++i) {
+            cur = builder.relu(builder.conv(cur, channels, 3, 1, 1));
+        }
+        cur = builder.pool(cur, 2, 2, 0);
+        channels *= 2;
+    }
+    cur = builder.relu(builder.fc(cur, 256));
+    cur = builder.softmax(builder.fc(cur, 100));
+
+    builder.build(reader);
+}
+
+// Inception-like modules, stresses Concat/Copy elimination and memory packing
+void buildSyntheticInception(CNNNetReader& reader) {
+    NetworkBuilder builder("synthetic_inception");
+
+    auto cur = builder.input(3, 112, 112);
+    cur = builder.relu(builder.conv(cur, 32, 3, 2, 1));
+
+    for (int module = 0; module < 8; ++module) {
+        auto branch1 = builder.relu(builder.conv(cur, 16, 1, 1, 0));
+        auto branch2 = builder.relu(builder.conv(builder.relu(builder.conv(cur, 16, 1, 1, 0)), 24, 3, 1, 1));
+        auto branch3 = builder.relu(builder.conv(builder.relu(builder.conv(cur, 8, 1, 1, 0)), 8, 5, 1, 2));
+        auto branch4 = builder.relu(builder.conv(builder.pool(cur, 3, 1, 1), 16, 1, 1, 0));
+        cur = builder.concat({branch1, branch2, branch3, branch4});
+
+        if (module % 3 == 2) {
+            cur = builder.pool(cur, 3, 2, 0);
+        }
+    }
+
+    cur = builder.pool(cur, cur.dims[1], 1, 0, "avg");
+    cur = builder.softmax(builder.fc(cur, 100));
+
+    builder.build(reader);
+}
+
+//
+// Benchmark
+//
+
+struct NetworkResult {
+    std::string name;
+    std::vector<VPU::PassStatistics> passes;
+    size_t blobSize = 0;
+};
+
+NetworkResult benchmark(const std::string& name, ICNNNetwork& network, const Options& options) {
+    std::map<std::string, std::string> config;
+    if (options.platform == MYRIAD_X) {
+        config[VPU_CONFIG_KEY(HW_STAGES_OPTIMIZATION)] = options.hw ? CONFIG_VALUE(YES) : CONFIG_VALUE(NO);
+    }
+    VPU::Common::ParsedConfig parsedConfig(options.platform, config);
+
+    auto log = std::make_shared<VPU::Common::Logger>();
+    log->init(VPU::Common::eLOGNONE);
+
+    NetworkResult result;
+    result.name = name;
+
+    // The first iteration is a warm-up
+    for (int iter = 0; iter <= options.iterations; ++iter) {
+        auto transformer = VPU::createGraphTransformer(parsedConfig.blobConfig, log);
+
+        std::vector<char> blob;
+        std::vector<VPU::BlobMetaData> metaData;
+        size_t numStages = 0;
+        transformer->generate(network, blob, metaData, numStages);
+
+        const auto& passes = transformer->getPassStatistics();
+        if (iter == 0) {
+            result.blobSize = blob.size();
+            continue;
+        }
+
+        if (result.passes.empty()) {
+            result.passes = passes;
+            continue;
+        }
+
+        if (passes.size() != result.passes.size()) {
+            THROW_IE_EXCEPTION << "Network " << name << " has unstable pass list";
+        }
+        for (size_t i = 0; i < passes.size(); ++i) {
+            if (passes[i].stagesOut != result.passes[i].stagesOut || passes[i].counters != result.passes[i].counters) {
+                THROW_IE_EXCEPTION << "Network " << name << " has unstable output of pass " << passes[i].name;
+            }
+            result.passes[i].timeMs = std::min(result.passes[i].timeMs, passes[i].timeMs);
+        }
+    }
+
+    return result;
+}
+
+std::string resultsToJson(const std::vector<NetworkResult>& results) {
+    std::ostringstream os;
+    os << "{\"networks\":[" << std::endl;
+    for (size_t i = 0; i < results.size(); ++i) {
+        os << VPU::passStatisticsToJson(results[i].name, results[i].passes)
+           << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    os << "]}" << std::endl;
+    return os.str();
+}
+
+struct ParsedResult {
+    double totalMs = 0.0;
+    // "name stages_in -> stages_out {counters}" of every pass, without the time
+    std::vector<std::string> passes;
+};
+
+// network -> result, reads the files written by resultsToJson
+std::map<std::string, ParsedResult> parseResults(const std::string& text) {
+    std::map<std::string, ParsedResult> parsed;
+
+    const std::string networkKey = "{\"network\":\"";
+    const std::regex totalRegex("\"total_ms\":([0-9.eE+-]+)");
+    const std::regex passRegex("\\{\"name\":\"([^\"]*)\",\"time_ms\":[0-9.eE+-]+,"
+                               "\"stages_in\":([0-9]+),\"stages_out\":([0-9]+),\"counters\":(\\{[^}]*\\})\\}");
+
+    size_t pos = text.find(networkKey);
+    while (pos != std::string::npos) {
+        auto next = text.find(networkKey, pos + networkKey.size());
+        auto section = text.substr(pos, next == std::string::npos ? std::string::npos : next - pos);
+
+        auto nameBegin = networkKey.size();
+        auto name = section.substr(nameBegin, section.find('"', nameBegin) - nameBegin);
+
+        auto& result = parsed[name];
+
+        std::smatch total;
+        if (std::regex_search(section, total, totalRegex)) {
+            result.totalMs = std::stod(total[1].str());
+        }
+
+        for (std::sregex_iterator it(section.begin(), section.end(), passRegex), end; it != end; ++it) {
+            result.passes.push_back((*it)[1].str() + " " + (*it)[2].str() + " -> " + (*it)[3].str() + " " + (*it)[4].str());
+        }
+
+        pos = next;
+    }
+
+    return parsed;
+}
+
+bool checkBaseline(const std::vector<NetworkResult>& results, const Options& options) {
+    std::ifstream file(options.baseline);
+    if (!file.is_open()) {
+        THROW_IE_EXCEPTION << "Can't open baseline file " << options.baseline;
+    }
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+
+    auto baseline = parseResults(buffer.str());
+    auto current = parseResults(resultsToJson(results));
+
+    bool ok = true;
+    for (const auto& base : baseline) {
+        if (current.find(base.first) == current.end()) {
+            std::cout << "MISMATCH " << base.first << " : not compiled" << std::endl;
+            ok = false;
+        }
+    }
+
+    for (const auto& result : current) {
+        auto baseIt = baseline.find(result.first);
+        if (baseIt == baseline.end()) {
+            std::cout << result.first << " : no baseline" << std::endl;
+            continue;
+        }
+
+        const auto& basePasses = baseIt->second.passes;
+        const auto& passes = result.second.passes;
+        for (size_t i = 0; i < std::max(basePasses.size(), passes.size()); ++i) {
+            auto basePass = i < basePasses.size() ? basePasses[i] : "<none>";
+            auto pass = i < passes.size() ? passes[i] : "<none>";
+            if (pass != basePass) {
+                std::cout << "MISMATCH " << result.first << " : " << basePass << " (baseline) -> " << pass << std::endl;
+                ok = false;
+            }
+        }
+
+        std::cout << result.first << " : " << std::fixed << std::setprecision(3) << result.second.totalMs
+                  << " ms, baseline " << baseIt->second.totalMs << " ms" << std::defaultfloat << std::endl;
+    }
+
+    return ok;
+}
+
+void printResult(const NetworkResult& result) {
+    double totalMs = 0.0;
+
+    std::cout << result.name << ":" << std::endl;
+    for (const auto& pass : result.passes) {
+        std::cout << "    " << std::left << std::setw(28) << pass.name << std::right
+                  << std::fixed << std::setprecision(3) << std::setw(10) << pass.timeMs << " ms" << std::defaultfloat
+                  << std::setw(8) << pass.stagesIn << " -> " << std::setw(5) << pass.stagesOut;
+        for (const auto& counter : pass.counters) {
+            std::cout << "  " << counter.first << "=" << counter.second;
+        }
+        std::cout << std::endl;
+
+        totalMs += pass.timeMs;
+    }
+    std::cout << "    total " << std::fixed << std::setprecision(3) << totalMs << " ms" << std::defaultfloat
+              << ", blob " << result.blobSize << " bytes" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    try {
+        std::vector<NetworkResult> results;
+
+        {
+            CNNNetReader reader;
+            buildSyntheticConvNet(reader);
+            results.push_back(benchmark("synthetic_convnet", reader.getNetwork(), options));
+        }
+        {
+            CNNNetReader reader;
+            buildSyntheticInception(reader);
+            results.push_back(benchmark("synthetic_inception", reader.getNetwork(), options));
+        }
+
+        for (const auto& model : options.models) {
+            CNNNetReader reader;
+            reader.ReadNetwork(model);
+            reader.ReadWeights(model.substr(0, model.rfind('.')) + ".bin");
+
+            auto name = model.substr(model.find_last_of("/\\") + 1);
+            results.push_back(benchmark(name, reader.getNetwork(), options));
+        }
+
+        for (const auto& result : results) {
+            printResult(result);
+        }
+
+        if (!options.output.empty()) {
+            std::ofstream file(options.output);
+            if (!file.is_open()) {
+                THROW_IE_EXCEPTION << "Can't open output file " << options.output;
+            }
+            file << resultsToJson(results);
+        }
+
+        if (!options.baseline.empty() && !checkBaseline(results, options)) {
+            return 2;
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
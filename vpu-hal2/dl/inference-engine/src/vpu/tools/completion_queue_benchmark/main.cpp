@@ -0,0 +1,401 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+
+// Checks the completion queue of the async infer requests and measures it against per-request Wait polling:
+//
+//   vpu_completion_queue_benchmark [-r <requests>...] [-w <infer us>] [-n <inferences per request>] [-e <executors>]
+//
+// The requests are AsyncInferRequestThreadSafeDefault over a sync request sleeping for the infer time, 2000 us
+// by default and up to twice longer depending on the request, so they complete out of the order they started,
+// spread over <executors> request executors, 16 by default. One thread drives 8, 64, 256 and 512 requests by
+// default, starting each one again <inferences per request> times, 10 by default, with:
+//   Wait polling   - Wait(STATUS_ONLY) over all the requests, yielding when none completed
+//   Wait in turn   - Wait(RESULT_READY) on each request in the order they were started
+//   WaitAny        - CompletionQueue::WaitAny
+//   WaitSome       - CompletionQueue::WaitSome of up to 32 completions
+// and prints the inferences per second, the CPU time of the driving thread per inference and the latency from
+// the end of an inference to the driving thread taking it, in us.
+//
+// The checks first run the requests on a single executor and compare the order of the completions with the
+// order the inferences ended, then check the timeouts, the failed inferences, the completion callbacks,
+// the callbacks starting the next inference, the detached requests and the released queue.
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <map>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+
+#include <time.h>
+
+#include <cpp_interfaces/ie_task_executor.hpp>
+#include <cpp_interfaces/ie_task_synchronizer.hpp>
+#include <cpp_interfaces/base/ie_infer_async_request_base.hpp>
+#include <cpp_interfaces/impl/ie_infer_async_request_thread_safe_default.hpp>
+#include <cpp/ie_completion_queue.hpp>
+#include "benchmark_harness.hpp"
+
+using namespace InferenceEngine;
+using namespace VPU::Tools;
+
+namespace {
+
+const size_t WAIT_SOME_COMPLETIONS = 32;
+
+struct Options {
+    std::vector<int> requests;
+    int inferUs = 2000;
+    int iterations = 10;
+    int executors = 16;
+};
+
+double threadCpuUs() {
+    timespec time = {};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return time.tv_sec * 1e6 + time.tv_nsec / 1e3;
+}
+
+//
+// Requests
+//
+
+class SleepInferRequest : public IInferRequestInternal {
+public:
+    SleepInferRequest(int inferUs, std::atomic<size_t>& endCounter) : _inferUs(inferUs), _endCounter(endCounter) {}
+
+    void Infer() override {
+        std::this_thread::sleep_for(std::chrono::microseconds(_inferUs));
+        endedAt = Clock::now().time_since_epoch().count();
+        endOrder = ++_endCounter;
+        if (isFailing) THROW_IE_EXCEPTION << "Failing inference";
+    }
+
+    void GetPerformanceCounts(std::map<std::string, InferenceEngineProfileInfo>& perfMap) const override {}
+
+    void SetBlob(const char* name, const Blob::Ptr& data) override {}
+
+    void GetBlob(const char* name, Blob::Ptr& data) override {}
+
+private:
+    int _inferUs;
+    std::atomic<size_t>& _endCounter;
+
+public:
+    std::atomic<Clock::rep> endedAt{0};
+    std::atomic<size_t> endOrder{0};
+    std::atomic<bool> isFailing{false};
+};
+
+struct Request {
+    size_t index = 0;
+    std::shared_ptr<SleepInferRequest> sync;
+    IInferRequest::Ptr request;
+    InferRequest wrapper;
+    int remaining = 0;
+};
+
+struct Network {
+    std::vector<ITaskExecutor::Ptr> requestExecutors;
+    ITaskExecutor::Ptr callbackExecutor = std::make_shared<TaskExecutor>("callback");
+    TaskSynchronizer::Ptr synchronizer = std::make_shared<TaskSynchronizer>();
+    std::atomic<size_t> endCounter{0};
+    std::vector<std::unique_ptr<Request>> requests;
+
+    Network(int requestCount, int executors, int inferUs) {
+        for (int e = 0; e < executors; ++e) {
+            requestExecutors.push_back(std::make_shared<TaskExecutor>("request" + std::to_string(e)));
+        }
+        for (int r = 0; r < requestCount; ++r) {
+            std::unique_ptr<Request> request(new Request());
+            request->index = r;
+            // up to twice the infer time, the requests complete out of order
+            request->sync = std::make_shared<SleepInferRequest>(inferUs + inferUs * (r * 7 % 16) / 16, endCounter);
+            auto impl = std::make_shared<AsyncInferRequestThreadSafeDefault>(
+                    request->sync, requestExecutors[r % executors], synchronizer, callbackExecutor);
+            request->request.reset(new InferRequestBase<AsyncInferRequestThreadSafeDefault>(impl),
+                                   [](IInferRequest* p) { p->Release(); });
+            impl->SetPointerToPublicInterface(request->request);
+            request->wrapper = InferRequest(request->request);
+            if (request->request->SetUserData(request.get(), nullptr) != OK) {
+                THROW_IE_EXCEPTION << "Failed to set the user data of a request";
+            }
+            requests.push_back(std::move(request));
+        }
+    }
+
+    Request& of(const IInferRequest::Ptr& request) {
+        void* data = nullptr;
+        if (request == nullptr || request->GetUserData(&data, nullptr) != OK || data == nullptr) {
+            THROW_IE_EXCEPTION << "Failed to get the user data of a request";
+        }
+        return *static_cast<Request*>(data);
+    }
+};
+
+//
+// Checks
+//
+
+void checkOrder() {
+    const int requests = 16;
+    Network network(requests, 1, 200);
+    CompletionQueue queue;
+    for (auto& request : network.requests) {
+        queue.Attach(request->wrapper);
+        request->wrapper.StartAsync();
+    }
+
+    std::vector<size_t> endOrders;
+    CompletionQueue::Completion completion;
+    while (endOrders.size() < requests) {
+        check(queue.WaitAny(completion, 5000), "every inference completes");
+        check(completion.status == OK, "the inferences succeed");
+        endOrders.push_back(network.of(completion.request).sync->endOrder);
+    }
+    for (size_t i = 0; i < endOrders.size(); ++i) {
+        check(endOrders[i] == i + 1, "the completions are in the order the inferences ended");
+    }
+
+    // the requests were released to the next inference
+    for (auto& request : network.requests) {
+        request->wrapper.StartAsync();
+    }
+    size_t completed = 0;
+    while (completed < requests) {
+        auto completions = queue.WaitSome(requests, 5000);
+        check(!completions.empty(), "WaitSome takes the completions");
+        completed += completions.size();
+    }
+    check(queue.Size() == 0 && queue.WaitSome(requests, IInferRequest::WaitMode::STATUS_ONLY).empty(),
+          "the queue is empty once the completions are taken");
+
+    auto start = Clock::now();
+    check(!queue.WaitAny(completion, 20), "WaitAny times out on an empty queue");
+    check(toUs(Clock::now() - start) >= 19000, "WaitAny blocks until the timeout");
+
+    // a null request wakes the waiter
+    std::thread pusher([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        queue.Push(nullptr, OK);
+    });
+    check(queue.WaitAny(completion) && completion.request == nullptr, "Push wakes a waiter");
+    pusher.join();
+}
+
+std::atomic<int> callbacks(0);
+std::atomic<int> restartingCallbacks(0);
+
+void countingCallback(IInferRequest::Ptr request, StatusCode) {
+    callbacks++;
+}
+
+void restartingCallback(IInferRequest::Ptr request, StatusCode) {
+    // the first callback starts the next inference, its completion is the only one pushed
+    if (restartingCallbacks++ == 0 && request->StartAsync(nullptr) != OK) {
+        THROW_IE_EXCEPTION << "Failed to start the request from its callback";
+    }
+}
+
+void checkCompletions() {
+    Network network(2, 2, 200);
+    auto& request = network.requests[0]->request;
+    auto queue = std::make_shared<CompletionQueue>();
+    CompletionQueue::Completion completion;
+    queue->Attach(network.requests[0]->wrapper);
+
+    // a failed inference is pushed, Wait gives its error, the request can start again
+    network.requests[0]->sync->isFailing = true;
+    network.requests[0]->wrapper.StartAsync();
+    check(queue->WaitAny(completion, 5000), "a failed inference completes");
+    check(completion.status == GENERAL_ERROR, "a failed inference is pushed with its error");
+    ResponseDesc resp;
+    check(request->Wait(IInferRequest::WaitMode::RESULT_READY, &resp) == GENERAL_ERROR &&
+          std::string(resp.msg).find("Failing inference") != std::string::npos, "Wait gives the error");
+    network.requests[0]->sync->isFailing = false;
+    network.requests[0]->wrapper.StartAsync();
+    check(queue->WaitAny(completion, 5000) && completion.status == OK, "a failed request starts again");
+
+    // the completion is pushed after the callback
+    check(request->SetCompletionCallback(countingCallback) == OK, "SetCompletionCallback");
+    network.requests[0]->wrapper.StartAsync();
+    check(queue->WaitAny(completion, 5000) && callbacks == 1, "the completion follows the callback");
+
+    // the callback starting the next inference doesn't push the first one
+    check(request->SetCompletionCallback(restartingCallback) == OK, "SetCompletionCallback");
+    network.requests[0]->wrapper.StartAsync();
+    check(queue->WaitAny(completion, 5000) && restartingCallbacks == 2, "the restarted inference completes");
+    check(!queue->WaitAny(completion, 50), "the restarted inference is pushed once");
+
+    // a detached request isn't pushed
+    CompletionQueue::Detach(network.requests[0]->wrapper);
+    network.requests[0]->wrapper.StartAsync();
+    check(request->Wait(IInferRequest::WaitMode::RESULT_READY, nullptr) == OK, "a detached request completes");
+    check(!queue->WaitAny(completion, 50), "a detached request isn't pushed");
+
+    // the requests hold the queue weakly
+    queue->Attach(network.requests[1]->wrapper);
+    queue.reset();
+    network.requests[1]->wrapper.StartAsync();
+    check(network.requests[1]->request->Wait(IInferRequest::WaitMode::RESULT_READY, nullptr) == OK,
+          "a request completes once its queue is released");
+}
+
+//
+// Measurements
+//
+
+struct Result {
+    double perSecond;
+    double cpuUsPerInference;
+    std::vector<double> latencyUs;
+};
+
+void start(Request& request) {
+    request.remaining--;
+    request.wrapper.StartAsync();
+}
+
+// runs the requests, the driver takes the completed requests and gives the number taken
+Result run(Network& network, int iterations, const std::function<size_t(std::vector<Request*>&)>& driver) {
+    size_t total = network.requests.size() * iterations;
+    Result result;
+    result.latencyUs.reserve(total);
+
+    auto startTime = Clock::now();
+    double startCpu = threadCpuUs();
+    for (auto& request : network.requests) {
+        request->remaining = iterations;
+        start(*request);
+    }
+    std::vector<Request*> completed;
+    for (size_t done = 0; done < total;) {
+        completed.clear();
+        done += driver(completed);
+        auto now = Clock::now().time_since_epoch().count();
+        for (auto request : completed) {
+            result.latencyUs.push_back(toUs(Clock::duration(now - request->sync->endedAt)));
+            if (request->remaining > 0) start(*request);
+        }
+    }
+    result.cpuUsPerInference = (threadCpuUs() - startCpu) / total;
+    result.perSecond = total / toSeconds(Clock::now() - startTime);
+    return result;
+}
+
+void printResult(const char* name, int requests, const Result& result) {
+    printRowHeader(std::cout, requests, name, 14);
+    std::cout << std::fixed << std::setprecision(0) << std::setw(8) << result.perSecond << " /s"
+              << std::setprecision(1) << std::setw(8) << result.cpuUsPerInference << " us cpu" << std::defaultfloat;
+    printPercentiles(std::cout, "latency", result.latencyUs);
+    std::cout << std::endl;
+}
+
+void benchmark(int requests, const Options& options) {
+    Network network(requests, options.executors, options.inferUs);
+
+    printResult("Wait polling", requests, run(network, options.iterations, [&](std::vector<Request*>& completed) {
+        for (auto& request : network.requests) {
+            if (request->remaining >= 0 &&
+                request->request->Wait(IInferRequest::WaitMode::STATUS_ONLY, nullptr) == OK) {
+                // releases the request
+                request->wrapper.Wait(IInferRequest::WaitMode::RESULT_READY);
+                completed.push_back(request.get());
+                if (request->remaining == 0) request->remaining = -1;
+            }
+        }
+        if (completed.empty()) std::this_thread::yield();
+        return completed.size();
+    }));
+
+    size_t next = 0;
+    printResult("Wait in turn", requests, run(network, options.iterations, [&](std::vector<Request*>& completed) {
+        auto& request = network.requests[next++ % network.requests.size()];
+        request->wrapper.Wait(IInferRequest::WaitMode::RESULT_READY);
+        completed.push_back(request.get());
+        return completed.size();
+    }));
+
+    CompletionQueue queue;
+    for (auto& request : network.requests) {
+        queue.Attach(request->wrapper);
+    }
+    CompletionQueue::Completion completion;
+    printResult("WaitAny", requests, run(network, options.iterations, [&](std::vector<Request*>& completed) {
+        if (!queue.WaitAny(completion)) THROW_IE_EXCEPTION << "WaitAny failed";
+        if (completion.status != OK) THROW_IE_EXCEPTION << "An inference failed";
+        completed.push_back(&network.of(completion.request));
+        return completed.size();
+    }));
+
+    printResult("WaitSome", requests, run(network, options.iterations, [&](std::vector<Request*>& completed) {
+        for (const auto& c : queue.WaitSome(WAIT_SOME_COMPLETIONS)) {
+            if (c.status != OK) THROW_IE_EXCEPTION << "An inference failed";
+            completed.push_back(&network.of(c.request));
+        }
+        return completed.size();
+    }));
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    CommandLine commandLine("vpu_completion_queue_benchmark",
+                            "[-r <requests>...] [-w <infer us>] [-n <inferences per request>] [-e <executors>]");
+    commandLine.add("-r", options.requests, 1)
+               .add("-w", options.inferUs, 0)
+               .add("-n", options.iterations, 1)
+               .add("-e", options.executors, 1);
+
+    return runBenchmark(argc, argv, commandLine, [&]() {
+        if (options.requests.empty()) {
+            options.requests = {8, 64, 256, 512};
+        }
+        checkOrder();
+        checkCompletions();
+        std::cout << "checks: PASSED" << std::endl;
+
+        std::cout << "requests  driver          " << options.inferUs << " us infer, " << options.executors
+                  << " executors" << std::endl;
+        for (auto requests : options.requests) {
+            benchmark(requests, options);
+        }
+        return 0;
+    });
+}
@@ -0,0 +1,280 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+
+// Reports the blob size reduction of the weights compression modes
+// and the accuracy impact of the lossy palette mode on the given network:
+//
+//   vpu_compress_weights -m <model.xml> [-p MYRIAD_2|MYRIAD_X] [-hw] [-i <input.bin>]
+//
+// Without input only the weights error is reported, with raw FP32 input (fed as is, in the
+// device layout) the blobs with and without compression are additionally executed on the host
+// reference executor.
+// The MYRIAD firmware can't decode compressed weights, so the compression lives in this tool only :
+// the reported ratio is what a firmware decoder would save, not a saving of the current runtime.
+
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+#include <inference_engine.hpp>
+#include <precision_utils.h>
+#include <graph_transformer.hpp>
+#include <mv_blob_format.h>
+#include <reference_executor.hpp>
+#include <parsed_config.h>
+
+#include "weights_compression.hpp"
+
+using namespace InferenceEngine;
+using namespace InferenceEngine::VPUConfigParams;
+
+namespace {
+
+struct Options {
+    std::string model;
+    std::string input;
+    int platform = MYRIAD_2;
+    bool hw = false;
+};
+
+void printUsage() {
+    std::cout << "Usage: vpu_compress_weights -m <model.xml> [-p MYRIAD_2|MYRIAD_X] [-hw] [-i <input.bin>]" << std::endl;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-m" && i + 1 < argc) {
+            options.model = argv[++i];
+        } else if (arg == "-i" && i + 1 < argc) {
+            options.input = argv[++i];
+        } else if (arg == "-p" && i + 1 < argc) {
+            std::string platform = argv[++i];
+            if (platform == "MYRIAD_X") {
+                options.platform = MYRIAD_X;
+            } else if (platform == "MYRIAD_2") {
+                options.platform = MYRIAD_2;
+            } else {
+                return false;
+            }
+        } else if (arg == "-hw") {
+            options.hw = true;
+        } else {
+            return false;
+        }
+    }
+
+    return !options.model.empty();
+}
+
+const char* compressionName(VPU::WeightsCompression compression) {
+    switch (compression) {
+    case VPU::WeightsCompression::Lossless:
+        return "LOSSLESS";
+    case VPU::WeightsCompression::Palette8:
+        return "PALETTE8";
+    default:
+        return "NONE";
+    }
+}
+
+std::vector<char> compile(ICNNNetwork& network, const Options& options, std::vector<VPU::WeightsChunkInfo>& chunks) {
+    std::map<std::string, std::string> config;
+    if (options.platform == MYRIAD_X) {
+        config[VPU_CONFIG_KEY(HW_STAGES_OPTIMIZATION)] = options.hw ? CONFIG_VALUE(YES) : CONFIG_VALUE(NO);
+    }
+    VPU::Common::ParsedConfig parsedConfig(options.platform, config);
+
+    auto log = std::make_shared<VPU::Common::Logger>();
+    log->init(VPU::Common::eLOGNONE);
+
+    std::vector<char> blob;
+    std::vector<VPU::BlobMetaData> metaData;
+    size_t numStages = 0;
+    auto transformer = VPU::createGraphTransformer(parsedConfig.blobConfig, log);
+    transformer->generate(network, blob, metaData, numStages);
+
+    chunks = transformer->getWeightsChunks();
+    return blob;
+}
+
+// Returns the buffer section data of uncompressed blob
+std::vector<ie_fp16> getWeights(const std::vector<char>& blob) {
+    VPU::mv_blob_header blobHdr;
+    std::memcpy(&blobHdr, &blob[sizeof(VPU::ElfN_Ehdr)], sizeof(blobHdr));
+
+    auto begin = blobHdr.buffer_section_offset + sizeof(VPU::mv_buffer_section_header);
+    auto end = blobHdr.relocation_section_offset;
+
+    std::vector<ie_fp16> weights((end - begin) / sizeof(ie_fp16));
+    std::memcpy(weights.data(), &blob[begin], weights.size() * sizeof(ie_fp16));
+    return weights;
+}
+
+void reportWeightsError(const std::vector<char>& refBlob, const std::vector<char>& blob) {
+    std::vector<char> expanded;
+    VPU::decompressBlob(blob, expanded);
+
+    if (expanded.size() != refBlob.size()) {
+        std::cout << "    decoded blob size mismatch : " << expanded.size() << " vs " << refBlob.size() << std::endl;
+        return;
+    }
+
+    auto refWeights = getWeights(refBlob);
+    auto weights = getWeights(expanded);
+
+    size_t numChanged = 0;
+    double errSum = 0.0, refSum = 0.0, maxErr = 0.0;
+    for (size_t i = 0; i < refWeights.size(); ++i) {
+        auto ref = PrecisionUtils::f16tof32(refWeights[i]);
+        auto val = PrecisionUtils::f16tof32(weights[i]);
+
+        numChanged += refWeights[i] != weights[i];
+        errSum += (val - ref) * (val - ref);
+        refSum += ref * ref;
+        maxErr = std::max(maxErr, static_cast<double>(std::fabs(val - ref)));
+    }
+
+    auto sectionsEqual = std::equal(refBlob.begin(), refBlob.end(), expanded.begin());
+
+    std::cout << "    decoded blob matches reference : " << (sectionsEqual ? "yes" : "no") << std::endl;
+    if (numChanged != 0) {
+        std::cout << "    changed values : " << numChanged << " of " << refWeights.size() << std::endl;
+        std::cout << "    max abs error : " << maxErr << std::endl;
+        std::cout << "    RMS error : " << std::sqrt(errSum / refWeights.size()) << std::endl;
+        std::cout << "    SNR : " << 10.0 * std::log10(refSum / std::max(errSum, 1e-30)) << " dB" << std::endl;
+    }
+}
+
+// Output of the blob on the host reference executor, in the device layout
+std::vector<float> infer(const std::vector<char>& blob, const std::vector<float>& input) {
+    std::vector<char> expanded;
+    VPU::decompressBlob(blob, expanded);
+
+    VPU::BlobReferenceExecutor executor(expanded);
+    if (executor.inputSize() != input.size() * sizeof(float)) {
+        THROW_IE_EXCEPTION << "Input file contains " << input.size() << " values, network expects "
+                           << executor.inputSize() / sizeof(float);
+    }
+
+    std::vector<float> output(executor.outputSize() / sizeof(float));
+    executor.infer(input.data(), output.data());
+    return output;
+}
+
+void reportAccuracy(const std::vector<char>& refBlob, const std::vector<char>& blob, const Options& options) {
+    std::ifstream file(options.input, std::ios_base::binary | std::ios_base::ate);
+    if (!file.is_open()) {
+        THROW_IE_EXCEPTION << "Can't open input file " << options.input;
+    }
+
+    std::vector<float> input(static_cast<size_t>(file.tellg()) / sizeof(float));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(input.data()), input.size() * sizeof(float));
+
+    auto ref = infer(refBlob, input);
+    auto out = infer(blob, input);
+
+    double errSum = 0.0, refSum = 0.0, maxErr = 0.0;
+    for (size_t i = 0; i < ref.size(); ++i) {
+        errSum += (out[i] - ref[i]) * (out[i] - ref[i]);
+        refSum += ref[i] * ref[i];
+        maxErr = std::max(maxErr, static_cast<double>(std::fabs(out[i] - ref[i])));
+    }
+
+    auto refTop = std::max_element(ref.begin(), ref.end()) - ref.begin();
+    auto outTop = std::max_element(out.begin(), out.end()) - out.begin();
+
+    std::cout << "Network output on the reference executor, PALETTE8 vs NONE:" << std::endl;
+    std::cout << "    max abs error : " << maxErr << std::endl;
+    std::cout << "    relative L2 error : " << std::sqrt(errSum / std::max(refSum, 1e-30)) << std::endl;
+    std::cout << "    top-1 : " << refTop << " vs " << outTop << (refTop == outTop ? " (match)" : " (MISMATCH)") << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    try {
+        CNNNetReader reader;
+        reader.ReadNetwork(options.model);
+        reader.ReadWeights(options.model.substr(0, options.model.rfind('.')) + ".bin");
+        auto& network = reader.getNetwork();
+
+        // the reference executor reads and writes FP32 data
+        auto inputsInfo = network.getInputsInfo();
+        auto outputsInfo = network.getOutputsInfo();
+        inputsInfo.begin()->second->setPrecision(Precision::FP32);
+        outputsInfo.begin()->second->setPrecision(Precision::FP32);
+
+        std::vector<VPU::WeightsChunkInfo> chunks;
+        auto refBlob = compile(network, options, chunks);
+        std::cout << compressionName(VPU::WeightsCompression::None) << " : " << refBlob.size() << " bytes" << std::endl;
+
+        std::vector<char> paletteBlob;
+        for (auto compression : {VPU::WeightsCompression::Lossless, VPU::WeightsCompression::Palette8}) {
+            std::vector<char> blob;
+            VPU::compressBlob(refBlob, chunks, compression, blob);
+
+            std::cout << compressionName(compression) << " : " << blob.size() << " bytes, ratio "
+                      << std::fixed << std::setprecision(3) << static_cast<double>(refBlob.size()) / blob.size()
+                      << std::defaultfloat << std::endl;
+            reportWeightsError(refBlob, blob);
+
+            if (compression == VPU::WeightsCompression::Palette8) {
+                paletteBlob.swap(blob);
+            }
+        }
+
+        if (!options.input.empty()) {
+            reportAccuracy(refBlob, paletteBlob, options);
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
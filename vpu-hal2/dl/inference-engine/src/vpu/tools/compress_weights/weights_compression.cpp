@@ -0,0 +1,699 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+
+#include "weights_compression.hpp"
+#include <cstring>
+#include <cmath>
+#include <array>
+#include <vector>
+#include <queue>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <ie_common.h>
+#include <precision_utils.h>
+#include "mv_blob_format.h"
+
+using namespace InferenceEngine;
+
+namespace VPU {
+
+namespace {
+
+const size_t NUM_SYMBOLS = 256;
+const size_t MIN_COMPRESSED_CHUNK_SIZE = 256;
+
+//
+// Canonical Huffman code
+//
+
+using CodeLengths = std::array<uint8_t, NUM_SYMBOLS>;
+
+void buildCodeLengths(const std::vector<uint8_t>& plane, CodeLengths& lengths) {
+    std::array<size_t, NUM_SYMBOLS> freq = {};
+    for (auto val : plane) {
+        ++freq[val];
+    }
+
+    using QueueItem = std::pair<size_t, int>;
+
+    for (;;) {
+        lengths.fill(0);
+
+        std::vector<int> parent;
+        std::array<int, NUM_SYMBOLS> leafNode;
+        std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+
+        for (size_t sym = 0; sym < NUM_SYMBOLS; ++sym) {
+            leafNode[sym] = -1;
+            if (freq[sym] == 0)
+                continue;
+
+            leafNode[sym] = static_cast<int>(parent.size());
+            queue.push({freq[sym], leafNode[sym]});
+            parent.push_back(-1);
+        }
+
+        if (queue.empty())
+            return;
+
+        if (queue.size() == 1) {
+            lengths[plane[0]] = 1;
+            return;
+        }
+
+        while (queue.size() > 1) {
+            auto first = queue.top();
+            queue.pop();
+            auto second = queue.top();
+            queue.pop();
+
+            auto node = static_cast<int>(parent.size());
+            parent.push_back(-1);
+            parent[first.second] = node;
+            parent[second.second] = node;
+
+            queue.push({first.first + second.first, node});
+        }
+
+        uint32_t maxLength = 0;
+        for (size_t sym = 0; sym < NUM_SYMBOLS; ++sym) {
+            if (leafNode[sym] < 0)
+                continue;
+
+            uint32_t length = 0;
+            for (auto node = leafNode[sym]; parent[node] >= 0; node = parent[node]) {
+                ++length;
+            }
+
+            maxLength = std::max(maxLength, length);
+            lengths[sym] = static_cast<uint8_t>(std::min(length, WEIGHTS_HUFFMAN_MAX_CODE_LENGTH + 1));
+        }
+
+        if (maxLength <= WEIGHTS_HUFFMAN_MAX_CODE_LENGTH)
+            return;
+
+        // Flatten the distribution until the code fits into the maximal code length
+        for (auto& val : freq) {
+            val = (val + 1) / 2;
+        }
+    }
+}
+
+// The same code assignment as in DEFLATE : shorter codes go first, ties are ordered by symbol value
+void buildCodes(const CodeLengths& lengths, std::array<uint16_t, NUM_SYMBOLS>& codes) {
+    std::array<uint32_t, WEIGHTS_HUFFMAN_MAX_CODE_LENGTH + 1> count = {};
+    for (auto len : lengths) {
+        ++count[len];
+    }
+    count[0] = 0;
+
+    std::array<uint32_t, WEIGHTS_HUFFMAN_MAX_CODE_LENGTH + 1> nextCode = {};
+    uint32_t code = 0;
+    for (uint32_t len = 1; len <= WEIGHTS_HUFFMAN_MAX_CODE_LENGTH; ++len) {
+        code = (code + count[len - 1]) << 1;
+        nextCode[len] = code;
+    }
+
+    for (size_t sym = 0; sym < NUM_SYMBOLS; ++sym) {
+        if (lengths[sym] != 0) {
+            codes[sym] = static_cast<uint16_t>(nextCode[lengths[sym]]++);
+        }
+    }
+}
+
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<char>& dst) : _dst(dst) {
+    }
+
+    void write(uint32_t code, uint32_t length) {
+        for (uint32_t i = length; i > 0; --i) {
+            _cur = static_cast<uint8_t>((_cur << 1) | ((code >> (i - 1)) & 1));
+            if (++_numBits == 8) {
+                _dst.push_back(static_cast<char>(_cur));
+                _cur = 0;
+                _numBits = 0;
+            }
+        }
+    }
+
+    void flush() {
+        if (_numBits != 0) {
+            _dst.push_back(static_cast<char>(_cur << (8 - _numBits)));
+            _cur = 0;
+            _numBits = 0;
+        }
+    }
+
+private:
+    std::vector<char>& _dst;
+    uint8_t _cur = 0;
+    uint32_t _numBits = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* src, size_t size) : _src(src), _size(size) {
+    }
+
+    uint32_t read() {
+        if (_pos >= _size * 8) {
+            THROW_IE_EXCEPTION << "[VPU] Compressed weights : bitstream is truncated";
+        }
+
+        auto bit = (_src[_pos / 8] >> (7 - _pos % 8)) & 1;
+        ++_pos;
+        return bit;
+    }
+
+private:
+    const uint8_t* _src;
+    size_t _size;
+    size_t _pos = 0;
+};
+
+void encodePlane(const std::vector<uint8_t>& plane, std::vector<char>& dst) {
+    CodeLengths lengths;
+    buildCodeLengths(plane, lengths);
+
+    std::array<uint16_t, NUM_SYMBOLS> codes = {};
+    buildCodes(lengths, codes);
+
+    mv_weights_plane_header planeHdr = {};
+    for (size_t sym = 0; sym < NUM_SYMBOLS; ++sym) {
+        planeHdr.code_lengths[sym / 2] |= static_cast<uint8_t>(lengths[sym] << (4 * (sym % 2)));
+    }
+
+    auto hdrOffset = dst.size();
+    dst.resize(dst.size() + sizeof(planeHdr));
+
+    auto bitstreamOffset = dst.size();
+    BitWriter writer(dst);
+    for (auto sym : plane) {
+        writer.write(codes[sym], lengths[sym]);
+    }
+    writer.flush();
+
+    planeHdr.bitstream_size = static_cast<uint32_t>(dst.size() - bitstreamOffset);
+    std::memcpy(&dst[hdrOffset], &planeHdr, sizeof(planeHdr));
+}
+
+// Returns number of consumed bytes
+size_t decodePlane(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstStep, size_t numValues) {
+    mv_weights_plane_header planeHdr;
+    if (srcSize < sizeof(planeHdr)) {
+        THROW_IE_EXCEPTION << "[VPU] Compressed weights : plane header is truncated";
+    }
+    std::memcpy(&planeHdr, src, sizeof(planeHdr));
+
+    if (planeHdr.bitstream_size > srcSize - sizeof(planeHdr)) {
+        THROW_IE_EXCEPTION << "[VPU] Compressed weights : plane bitstream is truncated";
+    }
+
+    std::array<uint32_t, WEIGHTS_HUFFMAN_MAX_CODE_LENGTH + 1> count = {};
+    for (size_t sym = 0; sym < NUM_SYMBOLS; ++sym) {
+        ++count[(planeHdr.code_lengths[sym / 2] >> (4 * (sym % 2))) & 0xF];
+    }
+    count[0] = 0;
+
+    int left = 1;
+    for (uint32_t len = 1; len <= WEIGHTS_HUFFMAN_MAX_CODE_LENGTH; ++len) {
+        left <<= 1;
+        left -= static_cast<int>(count[len]);
+        if (left < 0) {
+            THROW_IE_EXCEPTION << "[VPU] Compressed weights : invalid Huffman code lengths";
+        }
+    }
+
+    // Symbols ordered by code length, then by value
+    std::array<uint8_t, NUM_SYMBOLS> symbols = {};
+    std::array<uint32_t, WEIGHTS_HUFFMAN_MAX_CODE_LENGTH + 2> offsets = {};
+    for (uint32_t len = 1; len <= WEIGHTS_HUFFMAN_MAX_CODE_LENGTH; ++len) {
+        offsets[len + 1] = offsets[len] + count[len];
+    }
+    for (size_t sym = 0; sym < NUM_SYMBOLS; ++sym) {
+        auto len = (planeHdr.code_lengths[sym / 2] >> (4 * (sym % 2))) & 0xF;
+        if (len != 0) {
+            symbols[offsets[len]++] = static_cast<uint8_t>(sym);
+        }
+    }
+
+    BitReader reader(src + sizeof(planeHdr), planeHdr.bitstream_size);
+    for (size_t i = 0; i < numValues; ++i) {
+        int code = 0;
+        int first = 0;
+        int index = 0;
+
+        uint32_t len = 1;
+        for (; len <= WEIGHTS_HUFFMAN_MAX_CODE_LENGTH; ++len) {
+            code |= static_cast<int>(reader.read());
+
+            auto curCount = static_cast<int>(count[len]);
+            if (code - curCount < first) {
+                dst[i * dstStep] = symbols[index + (code - first)];
+                break;
+            }
+
+            index += curCount;
+            first += curCount;
+            first <<= 1;
+            code <<= 1;
+        }
+
+        if (len > WEIGHTS_HUFFMAN_MAX_CODE_LENGTH) {
+            THROW_IE_EXCEPTION << "[VPU] Compressed weights : invalid Huffman code";
+        }
+    }
+
+    return sizeof(planeHdr) + planeHdr.bitstream_size;
+}
+
+void encodeFP16Huffman(const char* src, size_t size, std::vector<char>& dst) {
+    auto numValues = size / sizeof(ie_fp16);
+
+    std::vector<uint8_t> plane(numValues);
+    for (size_t byteInd = 0; byteInd < sizeof(ie_fp16); ++byteInd) {
+        for (size_t i = 0; i < numValues; ++i) {
+            plane[i] = static_cast<uint8_t>(src[i * sizeof(ie_fp16) + byteInd]);
+        }
+
+        encodePlane(plane, dst);
+    }
+}
+
+void decodeFP16Huffman(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+    auto numValues = dstSize / sizeof(ie_fp16);
+
+    size_t srcPos = 0;
+    for (size_t byteInd = 0; byteInd < sizeof(ie_fp16); ++byteInd) {
+        srcPos += decodePlane(src + srcPos, srcSize - srcPos, dst + byteInd, sizeof(ie_fp16), numValues);
+    }
+}
+
+//
+// Palette
+//
+
+// 1D k-means over the histogram of FP16 values
+void encodeU8Palette(const char* src, size_t size, std::vector<char>& dst) {
+    auto numValues = size / sizeof(ie_fp16);
+    auto srcPtr = reinterpret_cast<const ie_fp16*>(src);
+
+    std::vector<uint32_t> hist(1 << 16, 0);
+    for (size_t i = 0; i < numValues; ++i) {
+        ++hist[static_cast<uint16_t>(srcPtr[i])];
+    }
+
+    std::vector<std::pair<float, uint32_t>> uniqueValues;
+    for (uint32_t bits = 0; bits < hist.size(); ++bits) {
+        if (hist[bits] == 0)
+            continue;
+
+        auto val = PrecisionUtils::f16tof32(static_cast<ie_fp16>(bits));
+        if (val != val) {
+            THROW_IE_EXCEPTION << "[VPU] Compressed weights : NaN value can't be palettized";
+        }
+
+        uniqueValues.push_back({val, bits});
+    }
+    std::sort(uniqueValues.begin(), uniqueValues.end());
+
+    std::vector<float> centers;
+    if (uniqueValues.size() <= WEIGHTS_PALETTE_SIZE) {
+        for (const auto& val : uniqueValues) {
+            centers.push_back(val.first);
+        }
+    } else {
+        // Initialize the centers with the quantiles
+        size_t accum = 0;
+        size_t nextCenter = 0;
+        for (const auto& val : uniqueValues) {
+            accum += hist[val.second];
+            while (nextCenter < WEIGHTS_PALETTE_SIZE && accum * WEIGHTS_PALETTE_SIZE >= (2 * nextCenter + 1) * numValues / 2) {
+                centers.push_back(val.first);
+                ++nextCenter;
+            }
+        }
+        centers.erase(std::unique(centers.begin(), centers.end()), centers.end());
+
+        const int NUM_ITERATIONS = 16;
+        for (int iter = 0; iter < NUM_ITERATIONS; ++iter) {
+            std::vector<double> sum(centers.size(), 0.0);
+            std::vector<size_t> count(centers.size(), 0);
+
+            size_t centerInd = 0;
+            for (const auto& val : uniqueValues) {
+                while (centerInd + 1 < centers.size() &&
+                       std::abs(centers[centerInd + 1] - val.first) <= std::abs(centers[centerInd] - val.first)) {
+                    ++centerInd;
+                }
+
+                sum[centerInd] += static_cast<double>(val.first) * hist[val.second];
+                count[centerInd] += hist[val.second];
+            }
+
+            for (size_t i = 0; i < centers.size(); ++i) {
+                if (count[i] != 0) {
+                    centers[i] = static_cast<float>(sum[i] / count[i]);
+                }
+            }
+            std::sort(centers.begin(), centers.end());
+        }
+    }
+
+    std::vector<ie_fp16> palette(WEIGHTS_PALETTE_SIZE, 0);
+    for (size_t i = 0; i < centers.size(); ++i) {
+        palette[i] = PrecisionUtils::f32tof16(centers[i]);
+    }
+
+    // Map each FP16 value to the nearest palette entry
+    std::vector<uint8_t> lut(1 << 16, 0);
+    size_t centerInd = 0;
+    for (const auto& val : uniqueValues) {
+        while (centerInd + 1 < centers.size() &&
+               std::abs(centers[centerInd + 1] - val.first) <= std::abs(centers[centerInd] - val.first)) {
+            ++centerInd;
+        }
+        lut[val.second] = static_cast<uint8_t>(centerInd);
+    }
+
+    auto offset = dst.size();
+    dst.resize(offset + WEIGHTS_PALETTE_SIZE * sizeof(ie_fp16) + numValues);
+    std::memcpy(&dst[offset], palette.data(), WEIGHTS_PALETTE_SIZE * sizeof(ie_fp16));
+
+    auto indices = reinterpret_cast<uint8_t*>(&dst[offset + WEIGHTS_PALETTE_SIZE * sizeof(ie_fp16)]);
+    for (size_t i = 0; i < numValues; ++i) {
+        indices[i] = lut[static_cast<uint16_t>(srcPtr[i])];
+    }
+}
+
+void decodeU8Palette(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+    auto numValues = dstSize / sizeof(ie_fp16);
+    if (srcSize != WEIGHTS_PALETTE_SIZE * sizeof(ie_fp16) + numValues) {
+        THROW_IE_EXCEPTION << "[VPU] Compressed weights : invalid palette chunk size";
+    }
+
+    std::vector<ie_fp16> palette(WEIGHTS_PALETTE_SIZE);
+    std::memcpy(palette.data(), src, WEIGHTS_PALETTE_SIZE * sizeof(ie_fp16));
+
+    auto indices = src + WEIGHTS_PALETTE_SIZE * sizeof(ie_fp16);
+    for (size_t i = 0; i < numValues; ++i) {
+        std::memcpy(dst + i * sizeof(ie_fp16), &palette[indices[i]], sizeof(ie_fp16));
+    }
+}
+
+uint32_t encodeChunk(const char* src, size_t size, bool allowLossy, WeightsCompression mode, std::vector<char>& dst) {
+    auto offset = dst.size();
+
+    if (mode != WeightsCompression::None && size >= MIN_COMPRESSED_CHUNK_SIZE && size % sizeof(ie_fp16) == 0) {
+        if (mode == WeightsCompression::Palette8 && allowLossy) {
+            encodeU8Palette(src, size, dst);
+            if (dst.size() - offset < size)
+                return WEIGHTS_CODEC_U8_PALETTE;
+            dst.resize(offset);
+        }
+
+        encodeFP16Huffman(src, size, dst);
+        if (dst.size() - offset < size)
+            return WEIGHTS_CODEC_FP16_HUFFMAN;
+        dst.resize(offset);
+    }
+
+    dst.insert(dst.end(), src, src + size);
+    return WEIGHTS_CODEC_RAW;
+}
+
+}  // namespace
+
+void compressWeights(const std::vector<char>& raw,
+                     const std::vector<WeightsChunkInfo>& chunks,
+                     WeightsCompression mode,
+                     std::vector<char>& compressed,
+                     WeightsCompressionStats* stats) {
+    std::vector<mv_weights_chunk_header> headers;
+    headers.reserve(chunks.size());
+
+    std::vector<char> payload;
+    payload.reserve(raw.size());
+
+    WeightsCompressionStats curStats;
+    curStats.rawSize = raw.size();
+    curStats.numChunks = chunks.size();
+
+    for (const auto& chunk : chunks) {
+        if (static_cast<size_t>(chunk.offset) + chunk.size > raw.size()) {
+            THROW_IE_EXCEPTION << "[VPU] Compressed weights : chunk is out of the buffer section";
+        }
+
+        // Keep chunk payloads 4 bytes aligned for the device decoder
+        payload.resize((payload.size() + 3) & ~static_cast<size_t>(3), 0);
+
+        mv_weights_chunk_header hdr = {};
+        hdr.dst_offset = chunk.offset;
+        hdr.dst_size = chunk.size;
+        hdr.src_offset = static_cast<uint32_t>(payload.size());
+        hdr.codec = encodeChunk(&raw[chunk.offset], chunk.size, chunk.allowLossy, mode, payload);
+        hdr.src_size = static_cast<uint32_t>(payload.size() - hdr.src_offset);
+        headers.push_back(hdr);
+
+        if (hdr.codec == WEIGHTS_CODEC_FP16_HUFFMAN)
+            ++curStats.numHuffmanChunks;
+        else if (hdr.codec == WEIGHTS_CODEC_U8_PALETTE)
+            ++curStats.numPaletteChunks;
+    }
+
+    auto headersSize = headers.size() * sizeof(mv_weights_chunk_header);
+
+    compressed.resize(headersSize + payload.size());
+    if (!headers.empty()) {
+        std::memcpy(compressed.data(), headers.data(), headersSize);
+    }
+    std::copy(payload.begin(), payload.end(), compressed.begin() + headersSize);
+
+    curStats.compressedSize = compressed.size();
+    if (stats != nullptr) {
+        *stats = curStats;
+    }
+}
+
+void decompressWeights(const char* compressed,
+                       size_t compressedSize,
+                       uint32_t numChunks,
+                       std::vector<char>& raw,
+                       size_t rawSize) {
+    auto headersSize = static_cast<size_t>(numChunks) * sizeof(mv_weights_chunk_header);
+    if (headersSize > compressedSize) {
+        THROW_IE_EXCEPTION << "[VPU] Compressed weights : chunk table is truncated";
+    }
+
+    raw.assign(rawSize, 0);
+
+    auto payload = reinterpret_cast<const uint8_t*>(compressed) + headersSize;
+    auto payloadSize = compressedSize - headersSize;
+
+    for (uint32_t chunkInd = 0; chunkInd < numChunks; ++chunkInd) {
+        mv_weights_chunk_header hdr;
+        std::memcpy(&hdr, compressed + chunkInd * sizeof(hdr), sizeof(hdr));
+
+        if (static_cast<size_t>(hdr.dst_offset) + hdr.dst_size > rawSize ||
+            static_cast<size_t>(hdr.src_offset) + hdr.src_size > payloadSize) {
+            THROW_IE_EXCEPTION << "[VPU] Compressed weights : chunk " << chunkInd << " is out of range";
+        }
+
+        auto src = payload + hdr.src_offset;
+        auto dst = reinterpret_cast<uint8_t*>(&raw[hdr.dst_offset]);
+
+        switch (hdr.codec) {
+        case WEIGHTS_CODEC_RAW:
+            if (hdr.src_size != hdr.dst_size) {
+                THROW_IE_EXCEPTION << "[VPU] Compressed weights : invalid raw chunk size";
+            }
+            std::memcpy(dst, src, hdr.dst_size);
+            break;
+        case WEIGHTS_CODEC_FP16_HUFFMAN:
+            decodeFP16Huffman(src, hdr.src_size, dst, hdr.dst_size);
+            break;
+        case WEIGHTS_CODEC_U8_PALETTE:
+            decodeU8Palette(src, hdr.src_size, dst, hdr.dst_size);
+            break;
+        default:
+            THROW_IE_EXCEPTION << "[VPU] Compressed weights : unknown codec " << hdr.codec;
+        }
+    }
+}
+
+bool isBlobWeightsCompressed(const std::vector<char>& blob) {
+    if (blob.size() < sizeof(ElfN_Ehdr) + sizeof(mv_blob_header))
+        return false;
+
+    mv_blob_header blobHdr;
+    std::memcpy(&blobHdr, &blob[sizeof(ElfN_Ehdr)], sizeof(blobHdr));
+
+    return blobHdr.magic_number == BLOB_MAGIC_NUMBER &&
+           blobHdr.blob_ver_major == BLOB_VERSION_MAJOR &&
+           blobHdr.blob_ver_minor == BLOB_VERSION_MINOR_COMPRESSED_WEIGHTS;
+}
+
+namespace {
+
+// Replaces the buffer section data of `src`, the sections after it are moved
+void replaceBufferSection(const std::vector<char>& src,
+                          mv_blob_header blobHdr,
+                          const mv_buffer_section_header& newBufSecHdr,
+                          const std::vector<char>& newData,
+                          std::vector<char>& dst) {
+    mv_buffer_section_header bufSecHdr;
+    if (static_cast<size_t>(blobHdr.buffer_section_offset) + sizeof(bufSecHdr) > src.size()) {
+        THROW_IE_EXCEPTION << "[VPU] Compressed weights : buffer section is out of the blob";
+    }
+    std::memcpy(&bufSecHdr, &src[blobHdr.buffer_section_offset], sizeof(bufSecHdr));
+
+    auto oldBufSecEnd = static_cast<size_t>(blobHdr.buffer_section_offset) + bufSecHdr.buffer_section_size;
+    if (bufSecHdr.buffer_section_size < sizeof(bufSecHdr) || oldBufSecEnd > src.size() ||
+        blobHdr.relocation_section_offset != oldBufSecEnd) {
+        THROW_IE_EXCEPTION << "[VPU] Compressed weights : invalid buffer section";
+    }
+
+    auto delta = static_cast<int64_t>(newBufSecHdr.buffer_section_size) - static_cast<int64_t>(bufSecHdr.buffer_section_size);
+
+    dst.clear();
+    dst.reserve(static_cast<size_t>(static_cast<int64_t>(src.size()) + delta));
+    dst.insert(dst.end(), src.begin(), src.begin() + blobHdr.buffer_section_offset);
+    dst.insert(dst.end(), reinterpret_cast<const char*>(&newBufSecHdr), reinterpret_cast<const char*>(&newBufSecHdr) + sizeof(newBufSecHdr));
+    dst.insert(dst.end(), newData.begin(), newData.end());
+    dst.insert(dst.end(), src.begin() + oldBufSecEnd, src.end());
+
+    blobHdr.file_size = static_cast<uint32_t>(blobHdr.file_size + delta);
+    blobHdr.relocation_section_offset = static_cast<uint32_t>(blobHdr.relocation_section_offset + delta);
+    blobHdr.stage_section_offset = static_cast<uint32_t>(blobHdr.stage_section_offset + delta);
+    std::memcpy(&dst[sizeof(ElfN_Ehdr)], &blobHdr, sizeof(blobHdr));
+
+    mv_relocation_section_header relocSecHdr;
+    std::memcpy(&relocSecHdr, &dst[blobHdr.relocation_section_offset], sizeof(relocSecHdr));
+    relocSecHdr.blob_buffer_reloc_offset = static_cast<uint32_t>(relocSecHdr.blob_buffer_reloc_offset + delta);
+    relocSecHdr.work_buffer_reloc_offset = static_cast<uint32_t>(relocSecHdr.work_buffer_reloc_offset + delta);
+    std::memcpy(&dst[blobHdr.relocation_section_offset], &relocSecHdr, sizeof(relocSecHdr));
+}
+
+}  // namespace
+
+void compressBlob(const std::vector<char>& src,
+                  const std::vector<WeightsChunkInfo>& chunks,
+                  WeightsCompression mode,
+                  std::vector<char>& dst,
+                  WeightsCompressionStats* stats) {
+    if (src.size() < sizeof(ElfN_Ehdr) + sizeof(mv_blob_header)) {
+        THROW_IE_EXCEPTION << "[VPU] Compressed weights : blob is too small";
+    }
+
+    mv_blob_header blobHdr;
+    std::memcpy(&blobHdr, &src[sizeof(ElfN_Ehdr)], sizeof(blobHdr));
+
+    if (blobHdr.magic_number != BLOB_MAGIC_NUMBER ||
+        blobHdr.blob_ver_major != BLOB_VERSION_MAJOR || blobHdr.blob_ver_minor != BLOB_VERSION_MINOR) {
+        THROW_IE_EXCEPTION << "[VPU] Compressed weights : unsupported blob version "
+                           << blobHdr.blob_ver_major << "." << blobHdr.blob_ver_minor;
+    }
+
+    if (mode == WeightsCompression::None) {
+        dst = src;
+        return;
+    }
+
+    mv_buffer_section_header bufSecHdr;
+    if (static_cast<size_t>(blobHdr.buffer_section_offset) + sizeof(bufSecHdr) > src.size()) {
+        THROW_IE_EXCEPTION << "[VPU] Compressed weights : buffer section is out of the blob";
+    }
+    std::memcpy(&bufSecHdr, &src[blobHdr.buffer_section_offset], sizeof(bufSecHdr));
+
+    auto dataBegin = static_cast<size_t>(blobHdr.buffer_section_offset) + sizeof(bufSecHdr);
+    auto dataEnd = static_cast<size_t>(blobHdr.buffer_section_offset) + bufSecHdr.buffer_section_size;
+    if (bufSecHdr.buffer_section_size < sizeof(bufSecHdr) || dataEnd > src.size()) {
+        THROW_IE_EXCEPTION << "[VPU] Compressed weights : invalid buffer section";
+    }
+
+    std::vector<char> raw(src.begin() + dataBegin, src.begin() + dataEnd);
+
+    std::vector<char> compressed;
+    compressWeights(raw, chunks, mode, compressed, stats);
+
+    // the sections after the buffer section keep their alignment
+    auto alignedSize = (compressed.size() + WEIGHTS_ALIGNMENT - 1) / WEIGHTS_ALIGNMENT * WEIGHTS_ALIGNMENT;
+    compressed.resize(alignedSize, 0);
+
+    mv_buffer_section_header newBufSecHdr = {};
+    newBufSecHdr.buffer_section_size = static_cast<uint32_t>(sizeof(newBufSecHdr) + compressed.size());
+    newBufSecHdr.compression_flags = WEIGHTS_COMPRESSED;
+    newBufSecHdr.decompressed_size = static_cast<uint32_t>(raw.size());
+    newBufSecHdr.chunk_count = static_cast<uint32_t>(chunks.size());
+
+    blobHdr.blob_ver_minor = BLOB_VERSION_MINOR_COMPRESSED_WEIGHTS;
+    replaceBufferSection(src, blobHdr, newBufSecHdr, compressed, dst);
+}
+
+void decompressBlob(const std::vector<char>& src, std::vector<char>& dst) {
+    if (!isBlobWeightsCompressed(src)) {
+        dst = src;
+        return;
+    }
+
+    mv_blob_header blobHdr;
+    std::memcpy(&blobHdr, &src[sizeof(ElfN_Ehdr)], sizeof(blobHdr));
+
+    mv_buffer_section_header bufSecHdr;
+    if (static_cast<size_t>(blobHdr.buffer_section_offset) + sizeof(bufSecHdr) > src.size()) {
+        THROW_IE_EXCEPTION << "[VPU] Compressed weights : buffer section is out of the blob";
+    }
+    std::memcpy(&bufSecHdr, &src[blobHdr.buffer_section_offset], sizeof(bufSecHdr));
+
+    auto oldBufSecEnd = static_cast<size_t>(blobHdr.buffer_section_offset) + bufSecHdr.buffer_section_size;
+    if (bufSecHdr.buffer_section_size < sizeof(bufSecHdr) || oldBufSecEnd > src.size()) {
+        THROW_IE_EXCEPTION << "[VPU] Compressed weights : invalid buffer section";
+    }
+
+    std::vector<char> raw;
+    decompressWeights(&src[blobHdr.buffer_section_offset] + sizeof(bufSecHdr),
+                      bufSecHdr.buffer_section_size - sizeof(bufSecHdr),
+                      bufSecHdr.chunk_count,
+                      raw,
+                      bufSecHdr.decompressed_size);
+
+    mv_buffer_section_header newBufSecHdr = {};
+    newBufSecHdr.buffer_section_size = static_cast<uint32_t>(sizeof(newBufSecHdr) + raw.size());
+
+    blobHdr.blob_ver_minor = BLOB_VERSION_MINOR;
+    replaceBufferSection(src, blobHdr, newBufSecHdr, raw, dst);
+}
+
+}  // namespace VPU
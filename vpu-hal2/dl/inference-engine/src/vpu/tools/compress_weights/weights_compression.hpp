@@ -0,0 +1,87 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <graph_transformer.hpp>
+
+namespace VPU {
+
+enum class WeightsCompression {
+    None,
+    Lossless,  // FP16 byte planes entropy coding
+    Palette8   // 8-bit palettized Convolution/FullyConnected weights, lossless coding for the rest
+};
+
+struct WeightsCompressionStats {
+    size_t rawSize = 0;
+    size_t compressedSize = 0;
+    size_t numChunks = 0;
+    size_t numHuffmanChunks = 0;
+    size_t numPaletteChunks = 0;
+};
+
+// Compresses the blob buffer section data. `chunks` must not overlap,
+// the gaps between them are expected to be zero filled alignment.
+void compressWeights(const std::vector<char>& raw,
+                     const std::vector<WeightsChunkInfo>& chunks,
+                     WeightsCompression mode,
+                     std::vector<char>& compressed,
+                     WeightsCompressionStats* stats = nullptr);
+
+// Host-side decoder, the reference of the chunk format for a firmware decoder.
+// The MYRIAD firmware has none, so only the offline tools produce compressed blobs.
+void decompressWeights(const char* compressed,
+                       size_t compressedSize,
+                       uint32_t numChunks,
+                       std::vector<char>& raw,
+                       size_t rawSize);
+
+bool isBlobWeightsCompressed(const std::vector<char>& blob);
+
+// Converts blob (version 2.1) to blob with compressed weights (version 2.2), `chunks` are
+// GraphTransformer::getWeightsChunks of the generate call of the blob.
+void compressBlob(const std::vector<char>& src,
+                  const std::vector<WeightsChunkInfo>& chunks,
+                  WeightsCompression mode,
+                  std::vector<char>& dst,
+                  WeightsCompressionStats* stats = nullptr);
+
+// Converts blob with compressed weights (version 2.2) to uncompressed one (version 2.1).
+// Uncompressed blobs are copied as is.
+void decompressBlob(const std::vector<char>& src, std::vector<char>& dst);
+
+}  // namespace VPU
@@ -0,0 +1,147 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+
+
+// Measures the dispatch overhead and the throughput of the Inference Engine task executors:
+//
+//   vpu_executor_benchmark [-t <workers>] [-c <cpu list>] [-s <spin count>] [-w <task us>] [-n <tasks per request>]
+//
+// Every async request is a thread starting its task and waiting for it, like StartAsync and Wait,
+// with 1 to 64 requests in flight. The task spins for the task time, 20 us by default. The dispatch
+// time is the time from startTask to the start of the task. TaskExecutor and WorkStealingTaskExecutor
+// (-t workers, one per hardware thread by default, bound in turn to the CPUs of -c) run the same load.
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+#include <cpp_interfaces/ie_task.hpp>
+#include <cpp_interfaces/ie_task_executor.hpp>
+#include <cpp_interfaces/ie_work_stealing_executor.hpp>
+
+#include "benchmark_harness.hpp"
+
+using namespace InferenceEngine;
+using namespace VPU::Tools;
+
+namespace {
+
+const int REQUESTS[] = {1, 2, 4, 8, 16, 32, 64};
+
+struct Options {
+    TaskExecutorConfig config;
+    int taskUs = 20;
+    int tasks = 2000;
+};
+
+struct Result {
+    double tasksPerSecond;
+    std::vector<double> dispatchUs;
+};
+
+Result benchmark(const ITaskExecutor::Ptr& executor, int requests, const Options& options) {
+    std::vector<std::vector<double>> dispatchUs(requests);
+    auto elapsed = runThreads(requests, [&](int r) {
+        Clock::time_point started;
+        auto task = std::make_shared<Task>([&]() {
+            started = Clock::now();
+            auto end = started + std::chrono::microseconds(options.taskUs);
+            while (Clock::now() < end) {}
+        });
+
+        auto& times = dispatchUs[r];
+        times.reserve(options.tasks);
+        for (int i = 0; i < options.tasks; ++i) {
+            auto queued = Clock::now();
+            if (!executor->startTask(task)) {
+                THROW_IE_EXCEPTION << "Failed to start the task of request " << r;
+            }
+            task->wait(-1);
+            times.push_back(toUs(started - queued));
+        }
+    });
+
+    Result result;
+    result.dispatchUs = mergeSamples(dispatchUs);
+    result.tasksPerSecond = result.dispatchUs.size() / elapsed;
+    return result;
+}
+
+void printResult(const char* name, int requests, const Result& result) {
+    printRowHeader(std::cout, requests, name, 14);
+    std::cout << std::fixed << std::setprecision(0) << std::setw(10) << result.tasksPerSecond << " tasks/s"
+              << std::defaultfloat;
+    printPercentiles(std::cout, "dispatch", result.dispatchUs);
+    std::cout << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    options.config.type = TaskExecutorConfig::WORK_STEALING;
+    CommandLine commandLine("vpu_executor_benchmark",
+                            "[-t <workers>] [-c <cpu list>] [-s <spin count>] [-w <task us>] [-n <tasks per request>]");
+    commandLine.add("-t", options.config.workers, 0u)
+               .add("-c", 1, [&](const std::vector<std::string>& values) {
+                    const auto& list = values[0];
+                    size_t pos = 0;
+                    while (pos < list.size()) {
+                        auto next = list.find(',', pos);
+                        options.config.cpus.push_back(std::stoi(list.substr(pos, next - pos)));
+                        pos = next == std::string::npos ? list.size() : next + 1;
+                    }
+                })
+               .add("-s", options.config.spinCount, 0u)
+               .add("-w", options.taskUs, 0)
+               .add("-n", options.tasks, 1);
+
+    return runBenchmark(argc, argv, commandLine, [&]() {
+        auto serial = std::make_shared<TaskExecutor>("serial");
+        auto workStealing = std::make_shared<WorkStealingTaskExecutor>(options.config, "work_stealing");
+
+        std::cout << "requests  executor       " << options.taskUs << " us tasks, "
+                  << workStealing->getWorkersNumber() << " workers" << std::endl;
+        for (auto requests : REQUESTS) {
+            printResult("serial", requests, benchmark(serial, requests, options));
+            printResult("work stealing", requests, benchmark(workStealing, requests, options));
+        }
+        return 0;
+    });
+}
@@ -0,0 +1,512 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+
+// Measures the graph traversals of graph_tools.hpp and ie_util_internal.hpp on the indexed network view,
+// against the previous implementations, as the networks grow:
+//
+//   vpu_graph_traversal_benchmark [-g <layers>...] [-n <iterations>]
+//
+// The networks are chains of blocks of 4 layers, a Convolution and a Convolution followed by a ReLU, both
+// reading the output of the previous block, and a Concat of the two, 100, 1000, 5000, 10000 and 50000 layers
+// by default. For every size the results of the helpers are first checked to be the same as the ones of the
+// previous implementations, then the best of <iterations> runs is printed, in ms:
+//   sort       - CNNNetSortTopologically
+//   inputs     - CNNNetGetAllInputLayers
+//   group      - groupSubgraphs, the Concat layers start new subgraphs
+//   traverse   - traverse::traverse forward from the inputs
+//   dfs / bfs  - CNNNetForestDFS and CNNNetBFS from the inputs
+//   3 passes   - sort, inputs and group, sharing an IndexedGraph
+// The previous implementations recurse as deep as the network, they run on a thread with a large stack.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <list>
+#include <set>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <pthread.h>
+
+#include <inference_engine.hpp>
+#include "graph_tools.hpp"
+#include "ie_util_internal.hpp"
+#include "benchmark_harness.hpp"
+
+using namespace InferenceEngine;
+using namespace InferenceEngine::details;
+using namespace VPU::Tools;
+
+namespace {
+
+const size_t LEGACY_STACK_SIZE = 1024 * 1024 * 1024;
+
+struct Options {
+    std::vector<int> layers;
+    int iterations = 5;
+};
+
+//
+// Network
+//
+
+CNNLayerPtr addLayer(CNNNetworkImpl& network, const std::string& name, const std::string& type,
+                     const std::vector<DataPtr>& inputs) {
+    auto layer = std::make_shared<CNNLayer>(LayerParams{name, type, Precision::FP32});
+    for (const auto& input : inputs) {
+        layer->insData.push_back(input);
+        input->getInputTo()[name] = layer;
+    }
+    auto output = std::make_shared<Data>(name, SizeVector{16, 16, 8, 1}, Precision::FP32, NCHW);
+    output->getCreatorLayer() = layer;
+    layer->outData.push_back(output);
+    network.getData(name) = output;
+    network.addLayer(layer);
+    return layer;
+}
+
+// Input, then blocks of conv_a, conv_b, relu_b and a Concat of conv_a and relu_b
+CNNNetworkImplPtr generateNetwork(int layers) {
+    auto network = std::make_shared<CNNNetworkImpl>();
+    network->setName("synthetic_blocks_" + std::to_string(layers));
+    network->setPrecision(Precision::FP32);
+
+    auto input = std::make_shared<InputInfo>();
+    auto x = addLayer(*network, "data", "Input", {})->outData[0];
+    input->setInputData(x);
+    network->setInputInfo(input);
+
+    for (int block = 0; block < (layers - 1) / 4; ++block) {
+        std::string suffix = std::to_string(block);
+        auto a = addLayer(*network, "conv_a" + suffix, "Convolution", {x})->outData[0];
+        auto b = addLayer(*network, "conv_b" + suffix, "Convolution", {x})->outData[0];
+        auto relu = addLayer(*network, "relu_b" + suffix, "ReLU", {b})->outData[0];
+        x = addLayer(*network, "concat" + suffix, "Concat", {a, relu})->outData[0];
+    }
+    network->resolveOutput();
+    return network;
+}
+
+bool splitAtConcat(const CNNLayerPtr&, const CNNLayerPtr& next) {
+    return next->type == "Concat";
+}
+
+std::vector<CNNLayerPtr> networkHeads(ICNNNetwork& network) {
+    InputsDataMap inputs;
+    network.getInputsInfo(inputs);
+    std::vector<CNNLayerPtr> heads;
+    for (const auto& input : inputs) {
+        for (const auto& consumer : input.second->getInputData()->getInputTo()) {
+            heads.push_back(consumer.second);
+        }
+    }
+    return heads;
+}
+
+//
+// The previous implementations
+//
+
+namespace legacy {
+
+template<class T>
+bool DFS(std::unordered_map<CNNLayer *, bool> &visited, const CNNLayerPtr &layer, const T &visit, bool visitBefore) {
+    if (layer == nullptr) {
+        return true;
+    }
+
+    if (visitBefore) visit(layer);
+    visited[layer.get()] = false;
+    for (auto &od : layer->outData) {
+        for (auto nl : od->getInputTo()) {
+            auto i = visited.find(nl.second.get());
+            if (i != visited.end()) {
+                if (!i->second) {
+                    return false;
+                }
+                continue;
+            }
+            if (!DFS(visited, nl.second, visit, visitBefore)) {
+                return false;
+            }
+        }
+    }
+    if (!visitBefore) visit(layer);
+    visited[layer.get()] = true;
+    return true;
+}
+
+template<class T>
+void UnorderedDFS(std::unordered_set<CNNLayer *> &visited, const CNNLayerPtr &layer, const T &visit, bool visitBefore) {
+    if (layer == nullptr) {
+        return;
+    }
+    if (visited.end() != visited.find(layer.get())) {
+        return;
+    }
+
+    if (visitBefore) visit(layer);
+    visited.insert(layer.get());
+
+    for (auto &od : layer->outData) {
+        for (auto nl : od->getInputTo()) {
+            UnorderedDFS(visited, nl.second, visit, visitBefore);
+        }
+    }
+
+    for (auto && input  : layer->insData) {
+        UnorderedDFS(visited, input.lock()->getCreatorLayer().lock(), visit, visitBefore);
+    }
+
+    if (!visitBefore) visit(layer);
+}
+
+template<class T>
+void BFS(CNNLayerPtr layer, const T &visit, int maxDepth) {
+    std::set<CNNLayer*> visited;
+    std::list<CNNLayerPtr> nextLayers;
+    nextLayers.push_back(layer);
+
+    int layersOnLevel = 1;
+    for (; !nextLayers.empty() && maxDepth != 0;) {
+        visit(*nextLayers.begin());
+        for (auto &od : (*nextLayers.begin())->outData) {
+            for (auto nl : od->getInputTo()) {
+                if (visited.find(nl.second.get()) == visited.end()) {
+                    nextLayers.push_back(nl.second);
+                    visited.insert(nl.second.get());
+                }
+            }
+        }
+        nextLayers.pop_front();
+        if (!--layersOnLevel) {
+            layersOnLevel = nextLayers.size();
+            maxDepth--;
+        }
+    }
+}
+
+template<class Forest, class T>
+bool ForestDFS(const Forest &heads, const T &visit, bool bVisitBefore) {
+    std::unordered_map< CNNLayer *, bool> visited;
+    for (auto & layer : heads) {
+        if (!DFS(visited, layer, visit, bVisitBefore)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+CNNLayerSet GetAllInputLayers(ICNNNetwork &network) {
+    InputsDataMap inputs;
+    network.getInputsInfo(inputs);
+
+    CNNLayerSet inputLayers;
+    std::unordered_set<CNNLayer *> allLayers;
+
+    if (inputs.empty())
+        return inputLayers;
+
+    auto & secondLayers = inputs.begin()->second->getInputData()->getInputTo();
+    if (secondLayers.empty())
+        return inputLayers;
+
+    UnorderedDFS(allLayers, secondLayers.begin()->second, [&](CNNLayerPtr layer){
+       if (layer->insData.empty()) {
+           inputLayers.insert(layer);
+       }
+    }, false);
+    return inputLayers;
+}
+
+std::vector<CNNLayerPtr> SortTopologically(ICNNNetwork & network) {
+    std::vector<CNNLayerPtr> stackOfVisited;
+    auto res = ForestDFS(GetAllInputLayers(network), [&](CNNLayerPtr  current){
+        stackOfVisited.push_back(current);
+    }, false);
+
+    if (!res) {
+        THROW_IE_EXCEPTION << "Sorting not possible, due to existed loop.";
+    }
+
+    std::reverse(std::begin(stackOfVisited), std::end(stackOfVisited));
+
+    return stackOfVisited;
+}
+
+template<typename Visitor>
+void groupSubgraphsHelper(const CNNLayerPtr& layer, Visitor&& visitor) {
+    for (auto&& out : layer->outData) {
+        for (auto&& out_link : out->getInputTo()) {
+            auto& nextLayer = out_link.second;
+            if (nullptr != nextLayer &&
+                visitor(layer, nextLayer)) {
+                groupSubgraphsHelper(nextLayer, std::forward<Visitor>(visitor));
+            }
+        }
+    }
+}
+
+std::vector<std::vector<CNNLayerPtr>> groupSubgraphs(ICNNNetwork& network,
+        std::function<bool(const CNNLayerPtr&, const CNNLayerPtr&)> splitter) {
+    std::unordered_set<CNNLayerPtr> visitedObjects;
+    std::deque<CNNLayerPtr> layersToCheck;
+    for (const auto& head : networkHeads(network)) {
+        layersToCheck.push_front(head);
+    }
+
+    std::vector<std::vector<CNNLayerPtr>> ret;
+
+    while (!layersToCheck.empty()) {
+        auto layer = layersToCheck.back();
+        layersToCheck.pop_back();
+        if (visitedObjects.find(layer) == visitedObjects.end()) {
+            visitedObjects.insert(layer);
+            std::vector<CNNLayerPtr> subgraph;
+            subgraph.push_back(layer);
+            groupSubgraphsHelper(layer, [&](const CNNLayerPtr& layer1, const CNNLayerPtr& layer2) {
+                if (visitedObjects.find(layer2) == visitedObjects.end()) {
+                    if (splitter(layer1, layer2)) {
+                        layersToCheck.push_front(layer2);
+                        return false;
+                    } else {
+                        subgraph.push_back(layer2);
+                        visitedObjects.insert(layer2);
+                        return true;
+                    }
+                }
+                return false;
+            });
+            ret.emplace_back(std::move(subgraph));
+        }
+    }
+
+    return ret;
+}
+
+// the generic traverse, with an expand function it can't index
+void traverse(ICNNNetwork& network, std::function<void(CNNLayerPtr& layer)> apply) {
+    auto heads = networkHeads(network);
+    traverse::traverse(heads, apply, [](const CNNLayerPtr& layer, std::deque<CNNLayerPtr>& layers) {
+        traverse::forward(layer, layers);
+    });
+}
+
+}  // namespace legacy
+
+//
+// Checks and measurements
+//
+
+std::vector<std::string> names(const std::vector<CNNLayerPtr>& layers) {
+    std::vector<std::string> result;
+    for (const auto& layer : layers) {
+        result.push_back(layer->name);
+    }
+    return result;
+}
+
+std::vector<std::vector<std::string>> names(const std::vector<std::vector<CNNLayerPtr>>& subgraphs) {
+    std::vector<std::vector<std::string>> result;
+    for (const auto& subgraph : subgraphs) {
+        result.push_back(names(subgraph));
+    }
+    return result;
+}
+
+void verify(CNNNetworkImpl& network) {
+    check(names(CNNNetSortTopologically(network)) == names(legacy::SortTopologically(network)),
+          "CNNNetSortTopologically order");
+
+    auto inputs = CNNNetGetAllInputLayers(network), legacyInputs = legacy::GetAllInputLayers(network);
+    check(names(std::vector<CNNLayerPtr>(inputs.begin(), inputs.end())) ==
+          names(std::vector<CNNLayerPtr>(legacyInputs.begin(), legacyInputs.end())),
+          "CNNNetGetAllInputLayers");
+
+    check(names(groupSubgraphs(network, splitAtConcat)) == names(legacy::groupSubgraphs(network, splitAtConcat)),
+          "groupSubgraphs");
+
+    std::vector<CNNLayerPtr> visited, legacyVisited;
+    ICNNNetwork& icnnNetwork = network;
+    traverse::traverse(icnnNetwork, [&](CNNLayerPtr& layer) { visited.push_back(layer); });
+    legacy::traverse(network, [&](CNNLayerPtr& layer) { legacyVisited.push_back(layer); });
+    check(names(visited) == names(legacyVisited), "traverse forward order");
+
+    visited.clear();
+    legacyVisited.clear();
+    traverse::traverse(icnnNetwork, [&](CNNLayerPtr& layer) { visited.push_back(layer); }, traverse::backward);
+    auto heads = networkHeads(network);
+    traverse::traverse(heads, [&](CNNLayerPtr& layer) { legacyVisited.push_back(layer); },
+                       [](const CNNLayerPtr& layer, std::deque<CNNLayerPtr>& layers) {
+        traverse::backward(layer, layers);
+    });
+    check(names(visited) == names(legacyVisited), "traverse backward order");
+
+    for (bool before : {true, false}) {
+        visited.clear();
+        legacyVisited.clear();
+        CNNNetForestDFS(inputs, [&](const CNNLayerPtr& layer) { visited.push_back(layer); }, before);
+        legacy::ForestDFS(inputs, [&](const CNNLayerPtr& layer) { legacyVisited.push_back(layer); }, before);
+        check(names(visited) == names(legacyVisited), "CNNNetForestDFS order");
+    }
+
+    for (int depth : {-1, 0, 3}) {
+        visited.clear();
+        legacyVisited.clear();
+        details::BFS(*inputs.begin(), [&](const CNNLayerPtr& layer) { visited.push_back(layer); }, depth);
+        legacy::BFS(*inputs.begin(), [&](const CNNLayerPtr& layer) { legacyVisited.push_back(layer); }, depth);
+        check(names(visited) == names(legacyVisited), "CNNNetBFS order");
+    }
+
+    // a loop is still found
+    auto last = network.getData("concat0")->getInputTo();
+    auto concat = network.getData("concat0")->getCreatorLayer().lock();
+    auto first = network.getData("data")->getInputTo().begin()->second;
+    concat->outData[0]->getInputTo()[first->name] = first;
+    bool thrown = false;
+    try {
+        CNNNetSortTopologically(network);
+    } catch (const details::InferenceEngineException&) {
+        thrown = true;
+    }
+    concat->outData[0]->getInputTo() = last;
+    check(thrown, "CNNNetSortTopologically finds loops");
+}
+
+struct Pass {
+    const char* name;
+    std::function<void(CNNNetworkImpl&)> current;
+    std::function<void(CNNNetworkImpl&)> legacy;
+};
+
+void benchmark(const Options& options) {
+    size_t sink = 0;
+    auto count = [&](const CNNLayerPtr&) { ++sink; };
+    const std::vector<Pass> passes = {
+        {"sort", [&](CNNNetworkImpl& n) { sink += CNNNetSortTopologically(n).size(); },
+                 [&](CNNNetworkImpl& n) { sink += legacy::SortTopologically(n).size(); }},
+        {"inputs", [&](CNNNetworkImpl& n) { sink += CNNNetGetAllInputLayers(n).size(); },
+                   [&](CNNNetworkImpl& n) { sink += legacy::GetAllInputLayers(n).size(); }},
+        {"group", [&](CNNNetworkImpl& n) { sink += groupSubgraphs(n, splitAtConcat).size(); },
+                  [&](CNNNetworkImpl& n) { sink += legacy::groupSubgraphs(n, splitAtConcat).size(); }},
+        {"traverse", [&](CNNNetworkImpl& n) { traverse::traverse(static_cast<ICNNNetwork&>(n), [&](CNNLayerPtr&) { ++sink; }); },
+                     [&](CNNNetworkImpl& n) { legacy::traverse(n, [&](CNNLayerPtr&) { ++sink; }); }},
+        {"dfs", [&](CNNNetworkImpl& n) { CNNNetForestDFS(networkHeads(n), count, false); },
+                [&](CNNNetworkImpl& n) { legacy::ForestDFS(networkHeads(n), count, false); }},
+        {"bfs", [&](CNNNetworkImpl& n) { CNNNetBFS(networkHeads(n)[0], count); },
+                [&](CNNNetworkImpl& n) { legacy::BFS(networkHeads(n)[0], count, -1); }},
+        {"3 passes", [&](CNNNetworkImpl& n) {
+                IndexedGraph graph(n);
+                sink += CNNNetSortTopologically(graph).size() + graph.inputLayers().size() +
+                        groupSubgraphs(graph, splitAtConcat).size();
+            }, [&](CNNNetworkImpl& n) {
+                sink += legacy::SortTopologically(n).size() + legacy::GetAllInputLayers(n).size() +
+                        legacy::groupSubgraphs(n, splitAtConcat).size();
+            }},
+    };
+
+    std::cout << "ms, best of " << options.iterations << ", previous / indexed" << std::endl;
+    std::cout << std::setw(8) << "layers";
+    for (const auto& pass : passes) {
+        std::cout << std::setw(18) << pass.name;
+    }
+    std::cout << std::endl;
+
+    for (int layers : options.layers) {
+        auto network = generateNetwork(layers);
+        verify(*network);
+
+        std::cout << std::setw(8) << network->layerCount() << std::fixed << std::setprecision(2);
+        for (const auto& pass : passes) {
+            double legacyMs = 1e3 * measureBest(options.iterations, [&]() { pass.legacy(*network); });
+            double currentMs = 1e3 * measureBest(options.iterations, [&]() { pass.current(*network); });
+            std::ostringstream cell;
+            cell << std::fixed << std::setprecision(2) << legacyMs << " / " << currentMs;
+            std::cout << std::setw(18) << cell.str();
+        }
+        std::cout << std::defaultfloat << std::endl;
+    }
+    if (sink == 0) std::cout << std::endl;
+}
+
+struct Run {
+    const Options* options;
+    int status;
+};
+
+void* run(void* argument) {
+    auto r = static_cast<Run*>(argument);
+    try {
+        benchmark(*r->options);
+        r->status = 0;
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        r->status = 1;
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    CommandLine commandLine("vpu_graph_traversal_benchmark", "[-g <layers>...] [-n <iterations>]");
+    commandLine.add("-g", options.layers, 5)
+               .add("-n", options.iterations, 1);
+
+    return runBenchmark(argc, argv, commandLine, [&]() {
+        if (options.layers.empty()) {
+            options.layers = {100, 1000, 5000, 10000, 50000};
+        }
+
+        Run r = {&options, 1};
+        pthread_attr_t attributes;
+        pthread_attr_init(&attributes);
+        pthread_attr_setstacksize(&attributes, LEGACY_STACK_SIZE);
+        pthread_t thread;
+        if (pthread_create(&thread, &attributes, run, &r) != 0) {
+            THROW_IE_EXCEPTION << "Cannot start the benchmark thread";
+        }
+        pthread_join(thread, nullptr);
+        pthread_attr_destroy(&attributes);
+
+        return r.status;
+    });
+}
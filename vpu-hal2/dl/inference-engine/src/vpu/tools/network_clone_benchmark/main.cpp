@@ -0,0 +1,390 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+
+// Measures the time and the memory of network copies made with cloneNet and with CopyOnWriteNetwork:
+//
+//   vpu_network_clone_benchmark [-g <layers>] [-c <copies>] [-n <iterations>]
+//
+// The network is a chain of <layers> Convolution and ReLU layers, 4000 by default. Every pipeline makes
+// <copies> copies of it, 8 by default, the way plugins and graph splitting take a private network, and runs
+// a pass on each of them:
+//   clone     - none
+//   query     - reads the layers and the inputs, like a supported layers query
+//   reshape   - sets the batch size of every other copy
+//   relu      - sets the negative slope of the ReLU layers of every other copy
+//   quantize  - rewrites the weights of every tenth Convolution of every other copy
+// Before the measurements, the copies and the mutations are checked to never show in the original network
+// or in the other copies.
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+
+#include <malloc.h>
+
+#include <inference_engine.hpp>
+#include "ie_util_internal.hpp"
+#include "benchmark_harness.hpp"
+
+using namespace InferenceEngine;
+using namespace VPU::Tools;
+using namespace InferenceEngine::details;
+
+namespace {
+
+const size_t CHANNELS = 8;
+const size_t SPATIAL = 16;
+
+struct Options {
+    int layers = 4000;
+    int copies = 8;
+    int iterations = 5;
+};
+
+std::string dims(size_t channels) {
+    std::ostringstream port;
+    port << "<dim>1</dim><dim>" << channels << "</dim><dim>" << SPATIAL << "</dim><dim>" << SPATIAL << "</dim>";
+    return port.str();
+}
+
+// Chain of 3x3 CHANNELS x CHANNELS Convolution layers, each one followed by a ReLU, with a mean value per channel
+CNNNetworkImplPtr generateNetwork(int layers) {
+    std::ostringstream xml, edges;
+    std::vector<float> weights;
+    xml << "<?xml version=\"1.0\" ?>" << std::endl
+        << "<net name=\"synthetic_conv_relu_" << layers << "\" version=\"2\" batch=\"1\">" << std::endl
+        << "<layers>" << std::endl
+        << "<layer id=\"0\" name=\"data\" precision=\"FP32\" type=\"Input\"><output><port id=\"0\">" << dims(CHANNELS)
+        << "</port></output></layer>" << std::endl;
+
+    for (int l = 1; l < layers; ++l) {
+        if (l % 2) {
+            size_t offset = weights.size() * sizeof(float);
+            size_t weightsSize = CHANNELS * CHANNELS * 3 * 3 * sizeof(float);
+            size_t biasesSize = CHANNELS * sizeof(float);
+            for (size_t i = 0; i < (weightsSize + biasesSize) / sizeof(float); ++i) {
+                weights.push_back(static_cast<float>((i + l) % 17) / 100.f);
+            }
+
+            xml << "<layer id=\"" << l << "\" name=\"conv" << l << "\" precision=\"FP32\" type=\"Convolution\">"
+                << "<data stride-x=\"1\" stride-y=\"1\" pad-x=\"1\" pad-y=\"1\" kernel-x=\"3\" kernel-y=\"3\" output=\""
+                << CHANNELS << "\" group=\"1\"/>"
+                << "<input><port id=\"0\">" << dims(CHANNELS) << "</port></input>"
+                << "<output><port id=\"1\">" << dims(CHANNELS) << "</port></output>"
+                << "<blobs><weights offset=\"" << offset << "\" size=\"" << weightsSize << "\"/>"
+                << "<biases offset=\"" << offset + weightsSize << "\" size=\"" << biasesSize << "\"/></blobs></layer>"
+                << std::endl;
+        } else {
+            xml << "<layer id=\"" << l << "\" name=\"relu" << l << "\" precision=\"FP32\" type=\"ReLU\">"
+                << "<data negative_slope=\"0.1\"/>"
+                << "<input><port id=\"0\">" << dims(CHANNELS) << "</port></input>"
+                << "<output><port id=\"1\">" << dims(CHANNELS) << "</port></output></layer>" << std::endl;
+        }
+        edges << "<edge from-layer=\"" << l - 1 << "\" from-port=\"" << (l == 1 ? 0 : 1)
+              << "\" to-layer=\"" << l << "\" to-port=\"0\"/>" << std::endl;
+    }
+    xml << "</layers>" << std::endl << "<edges>" << std::endl << edges.str() << "</edges>" << std::endl
+        << "</net>" << std::endl;
+
+    auto model = xml.str();
+    auto blob = make_shared_blob<uint8_t>(Precision::U8, C, {weights.size() * sizeof(float)});
+    blob->allocate();
+    std::memcpy(blob->buffer().as<uint8_t*>(), weights.data(), blob->byteSize());
+
+    CNNNetReader reader;
+    reader.ReadNetwork(model.data(), model.size());
+    reader.SetWeights(blob);
+
+    auto& preProcess = reader.getNetwork().getInputsInfo().begin()->second->getPreProcess();
+    preProcess.init(CHANNELS);
+    for (size_t c = 0; c < CHANNELS; ++c) {
+        preProcess[c]->meanValue = static_cast<float>(c);
+    }
+    preProcess.setVariant(MEAN_VALUE);
+
+    return cloneNet(static_cast<ICNNNetwork&>(reader.getNetwork()));
+}
+
+uint64_t checksum(const Blob::Ptr& blob) {
+    auto data = blob->cbuffer().as<const uint8_t*>();
+    uint64_t sum = 0;
+    for (size_t i = 0; i < blob->byteSize(); ++i) {
+        sum = sum * 31 + data[i];
+    }
+    return sum;
+}
+
+// Text of everything a pass can change in a network
+std::string describe(const CNNNetworkImpl& network) {
+    std::ostringstream text;
+    // getPrecision is not const
+    text << network.getName() << " " << const_cast<CNNNetworkImpl&>(network).getPrecision().name() << " batch "
+         << network.getBatchSize() << std::endl;
+
+    InputsDataMap inputs;
+    network.getInputsInfo(inputs);
+    for (const auto& input : inputs) {
+        auto& preProcess = input.second->getPreProcess();
+        text << "input " << input.first << " " << input.second->getPrecision().name() << " mean "
+             << preProcess.getMeanVariant();
+        for (size_t c = 0; c < preProcess.getNumberOfChannels(); ++c) {
+            text << " " << preProcess[c]->meanValue << "/" << preProcess[c]->stdScale;
+        }
+        text << std::endl;
+    }
+    OutputsDataMap outputs;
+    network.getOutputsInfo(outputs);
+    for (const auto& output : outputs) {
+        text << "output " << output.first << std::endl;
+    }
+
+    for (const auto& named : network.allLayers()) {
+        const auto& layer = named.second;
+        text << layer->type << " " << layer->name << " {";
+        for (const auto& param : layer->params) {
+            text << param.first << "=" << param.second << " ";
+        }
+        text << "} in:";
+        for (const auto& data : layer->insData) {
+            text << " " << data.lock()->name;
+        }
+        text << " out:";
+        for (const auto& data : layer->outData) {
+            text << " " << data->name;
+            for (auto dim : data->getDims()) {
+                text << "x" << dim;
+            }
+            for (const auto& to : data->getInputTo()) {
+                text << " ->" << to.second->name;
+            }
+        }
+        if (auto relu = std::dynamic_pointer_cast<ReLULayer>(layer)) {
+            text << " relu " << relu->negative_slope;
+        }
+        for (const auto& blob : layer->blobs) {
+            text << " " << blob.first << " " << checksum(blob.second);
+        }
+        if (auto weightable = std::dynamic_pointer_cast<WeightableLayer>(layer)) {
+            text << " " << checksum(weightable->_weights) << " " << checksum(weightable->_biases);
+        }
+        text << std::endl;
+    }
+    return text.str();
+}
+
+// Passes, a mutating pass only mutates the copies with an odd index
+
+void query(CopyOnWriteNetwork& network, size_t) {
+    std::map<std::string, size_t> types;
+    for (const auto& layer : network.get().allLayers()) {
+        types[layer.second->type]++;
+    }
+    InputsDataMap inputs;
+    network.get().getInputsInfo(inputs);
+    check(types.size() == 3 && inputs.size() == 1, "query");
+}
+
+void reshape(CopyOnWriteNetwork& network, size_t index) {
+    if (index % 2) {
+        network.mutate().setBatchSize(2);
+    }
+}
+
+void relu(CopyOnWriteNetwork& network, size_t index) {
+    if (index % 2 == 0) return;
+    for (const auto& layer : network.mutate().allLayers()) {
+        if (auto relu = std::dynamic_pointer_cast<ReLULayer>(layer.second)) {
+            relu->negative_slope = 0.f;
+            relu->params["negative_slope"] = "0";
+        }
+    }
+}
+
+void quantize(CopyOnWriteNetwork& network, size_t index) {
+    if (index % 2 == 0) return;
+    std::vector<std::string> layers;
+    size_t convolutions = 0;
+    for (const auto& layer : network.get().allLayers()) {
+        if (layer.second->type == "Convolution" && convolutions++ % 10 == 0) {
+            layers.push_back(layer.first);
+        }
+    }
+    for (const auto& layer : layers) {
+        auto weights = network.mutableBlob(layer, "weights");
+        auto data = weights->buffer().as<float*>();
+        for (size_t i = 0; i < weights->size(); ++i) {
+            data[i] = static_cast<float>(static_cast<int>(data[i] * 64.f)) / 64.f;
+        }
+    }
+}
+
+void verify(const CNNNetworkImplPtr& original) {
+    auto expected = describe(*original);
+
+    CopyOnWriteNetwork shared(original);
+    check(shared.isShared() && &shared.get() == original.get(), "a copy shares the network");
+    auto copy = shared;
+    check(&copy.get() == original.get(), "a copy of a copy shares the network");
+
+    // the first mutation clones the network, the clone is the same as the original
+    auto& cloned = copy.mutate();
+    check(&cloned != original.get() && !copy.isShared(), "mutate clones a shared network");
+    check(describe(cloned) == expected, "the clone is the same as the original");
+    check(&copy.mutate() == &cloned, "mutate clones a network once");
+
+    relu(copy, 1);
+    reshape(copy, 1);
+    check(describe(*original) == expected, "the layers and the data of the original are not modified");
+    auto mutated = describe(copy.get());
+    check(mutated != expected, "the copy is modified");
+
+    // blobs are still shared with the original, a pointer held here would be one more reference
+    auto weights = copy.mutableBlob("conv1", "weights").get();
+    check(weights == copy.mutableBlob("conv1", "weights").get(), "mutableBlob copies a blob once");
+    check(weights != original->allLayers().at("conv1")->blobs.at("weights").get(), "mutableBlob copies a shared blob");
+    quantize(copy, 1);
+    weights->buffer().as<float*>()[0] = 42.f;
+    check(describe(*original) == expected, "the blobs of the original are not modified");
+
+    // a copy of a modified copy
+    mutated = describe(copy.get());
+    auto copyOfCopy = copy;
+    check(copyOfCopy.isShared() && copy.isShared(), "both copies share the network");
+    copyOfCopy.mutableBlob("conv1", "weights")->buffer().as<float*>()[0] = 0.f;
+    copyOfCopy.mutate().addOutput("relu2");
+    check(describe(copy.get()) == mutated, "a copy of a copy does not modify the copy");
+    check(describe(*original) == expected, "a copy of a copy does not modify the original");
+    check(!copy.isShared(), "the copy holds its network alone again");
+
+    std::cout << "isolation checks passed" << std::endl;
+}
+
+size_t allocatedBytes() {
+    // mallinfo is deprecated since glibc 2.33, its int fields wrap beyond 2GB
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return mallinfo2().uordblks;
+#else
+    return static_cast<size_t>(mallinfo().uordblks);
+#endif
+}
+
+struct Result {
+    double ms = 0;
+    size_t bytes = 0;
+};
+
+// Copies the network, runs the pass on every copy and keeps the copies alive until the memory is measured
+Result runDeep(const CNNNetworkImplPtr& original, int copies, const std::function<void(CopyOnWriteNetwork&, size_t)>& pass) {
+    Result result;
+    auto before = allocatedBytes();
+    auto start = Clock::now();
+    std::vector<CopyOnWriteNetwork> networks;
+    networks.reserve(copies);
+    for (int i = 0; i < copies; ++i) {
+        networks.emplace_back(cloneNet(static_cast<const ICNNNetwork&>(*original)));
+        pass(networks.back(), i);
+    }
+    result.ms = toMs(Clock::now() - start);
+    result.bytes = allocatedBytes() - before;
+    return result;
+}
+
+Result runCopyOnWrite(const CNNNetworkImplPtr& original, int copies,
+                      const std::function<void(CopyOnWriteNetwork&, size_t)>& pass) {
+    Result result;
+    auto before = allocatedBytes();
+    auto start = Clock::now();
+    CopyOnWriteNetwork source(original);
+    std::vector<CopyOnWriteNetwork> networks;
+    networks.reserve(copies);
+    for (int i = 0; i < copies; ++i) {
+        networks.push_back(source);
+        pass(networks.back(), i);
+    }
+    result.ms = toMs(Clock::now() - start);
+    result.bytes = allocatedBytes() - before;
+    return result;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    CommandLine commandLine("vpu_network_clone_benchmark", "[-g <layers>] [-c <copies>] [-n <iterations>]");
+    commandLine.add("-g", options.layers, 2)
+               .add("-c", options.copies, 2)
+               .add("-n", options.iterations, 1);
+
+    return runBenchmark(argc, argv, commandLine, [&]() {
+        auto original = generateNetwork(options.layers);
+        auto expected = describe(*original);
+        std::cout << options.layers << " layers, " << options.copies << " copies, best of " << options.iterations
+                  << std::endl;
+        verify(original);
+
+        const std::vector<std::pair<std::string, std::function<void(CopyOnWriteNetwork&, size_t)>>> pipelines = {
+            {"clone", [](CopyOnWriteNetwork&, size_t) {}},
+            {"query", query},
+            {"reshape", reshape},
+            {"relu", relu},
+            {"quantize", quantize},
+        };
+
+        std::cout << "pipeline      cloneNet              copy-on-write" << std::endl;
+        for (const auto& pipeline : pipelines) {
+            Result deep, cow;
+            for (int i = 0; i < options.iterations; ++i) {
+                auto d = runDeep(original, options.copies, pipeline.second);
+                auto c = runCopyOnWrite(original, options.copies, pipeline.second);
+                deep.ms = i == 0 ? d.ms : std::min(deep.ms, d.ms);
+                cow.ms = i == 0 ? c.ms : std::min(cow.ms, c.ms);
+                deep.bytes = std::max(deep.bytes, d.bytes);
+                cow.bytes = std::max(cow.bytes, c.bytes);
+            }
+            std::cout << std::left << std::setw(10) << pipeline.first << std::right << std::fixed
+                      << std::setprecision(2) << std::setw(9) << deep.ms << " ms " << std::setw(7)
+                      << deep.bytes / 1024 << " KB  " << std::setw(9) << cow.ms << " ms " << std::setw(7)
+                      << cow.bytes / 1024 << " KB" << std::defaultfloat << std::endl;
+        }
+        check(describe(*original) == expected, "the pipelines do not modify the original");
+        return 0;
+    });
+}
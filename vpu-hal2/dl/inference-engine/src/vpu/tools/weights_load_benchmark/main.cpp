@@ -0,0 +1,294 @@
+//
+// INTEL CONFIDENTIAL
+// Copyright 2018 Intel Corporation.
+//
+// The source code contained or described herein and all documents
+// related to the source code ("Material") are owned by Intel Corporation
+// or its suppliers or licensors. Title to the Material remains with
+// Intel Corporation or its suppliers and licensors. The Material may
+// contain trade secrets and proprietary and confidential information
+// of Intel Corporation and its suppliers and licensors, and is protected
+// by worldwide copyright and trade secret laws and treaty provisions.
+// No part of the Material may be used, copied, reproduced, modified,
+// published, uploaded, posted, transmitted, distributed, or disclosed
+// in any way without Intel's prior express written permission.
+//
+// No license under any patent, copyright, trade secret or other
+// intellectual property right is granted to or conferred upon you by
+// disclosure or delivery of the Materials, either expressly, by implication,
+// inducement, estoppel or otherwise. Any license under such intellectual
+// property rights must be express and approved by Intel in writing.
+//
+// Include any supplier copyright notices as supplier requires Intel to use.
+//
+// Include supplier trademarks or logos as supplier requires Intel to use,
+// preceded by an asterisk. An asterisked footnote can be added as follows:
+// *Third Party trademarks are the property of their respective owners.
+//
+// Unless otherwise agreed by Intel in writing, you may not remove or alter
+// this notice or any other notice embedded in Materials by Intel or Intel's
+// suppliers or licensors in any way.
+//
+
+
+
+
+// Measures the load time and the peak RSS of the weights of large IRs:
+//
+//   vpu_weights_load_benchmark [-m <model.xml>]... [-g <MB>] [-d <dir>] [-n <iterations>]
+//
+// Every model is loaded by CNNNetReader::ReadWeights with IE_MMAP_WEIGHTS=1, which maps the .bin file, and by
+// reading the whole file into a blob given to SetWeights, like ReadWeights does by default. The weights are then read once, like
+// a plugin repacking them. Every load runs in a child process, so its peak RSS is its own. The .bin file
+// is read once before, the times are with the file in the page cache.
+// -g writes a synthetic IR of FullyConnected layers with about <MB> of weights to -d, 256 by default
+// when no model is given.
+
+#include <cstdint>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <set>
+#include <random>
+#include <chrono>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include <inference_engine.hpp>
+#include "benchmark_harness.hpp"
+
+using namespace InferenceEngine;
+using namespace VPU::Tools;
+
+namespace {
+
+const size_t FC_SIZE = 2048;
+
+struct Options {
+    std::vector<std::string> models;
+    int generateMb = 0;
+    std::string dir = ".";
+    int iterations = 3;
+};
+
+// Sent by the child process through a pipe
+struct LoadResult {
+    double loadMs;
+    double readMs;
+    long rssAfterLoadKb;
+    long peakRssKb;
+    double checksum;
+    bool isOk;
+};
+
+std::string weightsOf(const std::string& model) {
+    auto pos = model.rfind('.');
+    return (pos == std::string::npos ? model : model.substr(0, pos)) + ".bin";
+}
+
+// Chain of FC_SIZE x FC_SIZE FullyConnected layers, 16 MB of FP32 weights each
+std::string generateModel(int mb, const std::string& dir) {
+    auto layers = std::max<size_t>(1, static_cast<size_t>(mb) * 1024 * 1024 / (FC_SIZE * FC_SIZE * sizeof(float)));
+    auto name = "synthetic_fc_" + std::to_string(mb) + "mb";
+    auto model = dir + "/" + name + ".xml";
+
+    std::ofstream xml(model);
+    std::ofstream bin(weightsOf(model), std::ios::binary);
+    if (!xml || !bin) THROW_IE_EXCEPTION << "Failed to create " << model;
+
+    std::ostringstream edges;
+    xml << "<?xml version=\"1.0\" ?>" << std::endl
+        << "<net name=\"" << name << "\" version=\"2\" batch=\"1\">" << std::endl << "<layers>" << std::endl
+        << "<layer id=\"0\" name=\"data\" precision=\"FP32\" type=\"Input\"><output><port id=\"0\"><dim>1</dim><dim>"
+        << FC_SIZE << "</dim></port></output></layer>" << std::endl;
+
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<float> dist(-0.1f, 0.1f);
+    std::vector<float> values(FC_SIZE * FC_SIZE);
+    size_t offset = 0;
+    for (size_t l = 1; l <= layers; ++l) {
+        for (auto& value : values) {
+            value = dist(gen);
+        }
+        size_t weightsSize = FC_SIZE * FC_SIZE * sizeof(float);
+        size_t biasesSize = FC_SIZE * sizeof(float);
+        bin.write(reinterpret_cast<const char*>(values.data()), weightsSize);
+        bin.write(reinterpret_cast<const char*>(values.data()), biasesSize);
+
+        xml << "<layer id=\"" << l << "\" name=\"fc" << l << "\" precision=\"FP32\" type=\"FullyConnected\">"
+            << "<data out-size=\"" << FC_SIZE << "\"/>"
+            << "<input><port id=\"0\"><dim>1</dim><dim>" << FC_SIZE << "</dim></port></input>"
+            << "<output><port id=\"1\"><dim>1</dim><dim>" << FC_SIZE << "</dim></port></output>"
+            << "<blobs><weights offset=\"" << offset << "\" size=\"" << weightsSize << "\"/>"
+            << "<biases offset=\"" << offset + weightsSize << "\" size=\"" << biasesSize << "\"/></blobs></layer>" << std::endl;
+        edges << "<edge from-layer=\"" << l - 1 << "\" from-port=\"" << (l == 1 ? 0 : 1)
+              << "\" to-layer=\"" << l << "\" to-port=\"0\"/>" << std::endl;
+        offset += weightsSize + biasesSize;
+    }
+    xml << "</layers>" << std::endl << "<edges>" << std::endl << edges.str() << "</edges>" << std::endl
+        << "</net>" << std::endl;
+    if (!bin) THROW_IE_EXCEPTION << "Failed to write " << weightsOf(model);
+
+    std::cout << "generated " << model << ": " << layers << " layers, " << offset / (1024 * 1024) << " MB of weights"
+              << std::endl;
+    return model;
+}
+
+long currentRssKb() {
+    std::ifstream statm("/proc/self/statm");
+    long size = 0, resident = 0;
+    statm >> size >> resident;
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+void readFile(const std::string& fileName, void* buffer, size_t size) {
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file.read(reinterpret_cast<char*>(buffer), size)) {
+        THROW_IE_EXCEPTION << "cannot read " << size << " bytes from file " << fileName;
+    }
+}
+
+LoadResult load(const std::string& model, bool isMapped) {
+    LoadResult result = {};
+    auto start = Clock::now();
+
+    CNNNetReader reader;
+    reader.ReadNetwork(model);
+    auto weights = weightsOf(model);
+    if (isMapped) {
+        setenv("IE_MMAP_WEIGHTS", "1", 1);
+        reader.ReadWeights(weights);
+    } else {
+        std::ifstream file(weights, std::ios::binary | std::ios::ate);
+        size_t size = file.tellg();
+        auto blob = make_shared_blob<uint8_t>(Precision::U8, C, {size});
+        blob->allocate();
+        readFile(weights, blob->buffer(), size);
+        reader.SetWeights(blob);
+    }
+    auto loaded = Clock::now();
+    result.loadMs = toMs(loaded - start);
+    result.rssAfterLoadKb = currentRssKb();
+
+    // read every weight once, the blobs of a layer may be shared
+    std::set<Blob*> blobs;
+    for (auto layer : reader.getNetwork()) {
+        for (const auto& blob : layer->blobs) {
+            blobs.insert(blob.second.get());
+        }
+        if (auto weightable = std::dynamic_pointer_cast<WeightableLayer>(layer)) {
+            blobs.insert(weightable->_weights.get());
+            blobs.insert(weightable->_biases.get());
+        }
+    }
+    blobs.erase(nullptr);
+    double checksum = 0;
+    for (auto blob : blobs) {
+        auto data = blob->cbuffer().as<const uint8_t*>();
+        uint64_t sum = 0;
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= blob->byteSize(); i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            sum += word;
+        }
+        for (; i < blob->byteSize(); ++i) {
+            sum += data[i];
+        }
+        checksum += static_cast<double>(sum);
+    }
+    result.readMs = toMs(Clock::now() - loaded);
+    result.checksum = checksum;
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    result.peakRssKb = usage.ru_maxrss;
+    result.isOk = true;
+    return result;
+}
+
+LoadResult loadInChild(const std::string& model, bool isMapped) {
+    int fds[2];
+    if (pipe(fds)) THROW_IE_EXCEPTION << "Failed to create a pipe: " << strerror(errno);
+    auto pid = fork();
+    if (pid < 0) THROW_IE_EXCEPTION << "Failed to fork: " << strerror(errno);
+    if (pid == 0) {
+        close(fds[0]);
+        LoadResult result = {};
+        try {
+            result = load(model, isMapped);
+        } catch (const std::exception& ex) {
+            std::cerr << ex.what() << std::endl;
+        }
+        auto written = write(fds[1], &result, sizeof(result));
+        _exit(written == sizeof(result) ? 0 : 1);
+    }
+    close(fds[1]);
+    LoadResult result = {};
+    auto got = read(fds[0], &result, sizeof(result));
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (got != sizeof(result) || !result.isOk) THROW_IE_EXCEPTION << "Failed to load " << model;
+    return result;
+}
+
+void printResult(const char* mode, const LoadResult& result) {
+    std::cout << "  " << std::left << std::setw(6) << mode << std::right << std::fixed << std::setprecision(1)
+              << "  load " << std::setw(8) << result.loadMs << " ms, RSS " << std::setw(6) << result.rssAfterLoadKb / 1024
+              << " MB  +read weights " << std::setw(8) << result.readMs << " ms, peak RSS " << std::setw(6)
+              << result.peakRssKb / 1024 << " MB" << std::defaultfloat << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    CommandLine commandLine("vpu_weights_load_benchmark", "[-m <model.xml>]... [-g <MB>] [-d <dir>] [-n <iterations>]");
+    commandLine.add("-m", options.models)
+               .add("-g", options.generateMb, 1)
+               .add("-d", options.dir)
+               .add("-n", options.iterations, 1);
+
+    return runBenchmark(argc, argv, commandLine, [&]() {
+        if (options.models.empty() && !options.generateMb) {
+            options.generateMb = 256;
+        }
+        if (options.generateMb) {
+            options.models.push_back(generateModel(options.generateMb, options.dir));
+        }
+
+        for (const auto& model : options.models) {
+            // warm the page cache up
+            std::ifstream file(weightsOf(model), std::ios::binary);
+            std::vector<char> chunk(1 << 20);
+            while (file.read(chunk.data(), chunk.size())) {}
+
+            std::cout << model << ", best of " << options.iterations << std::endl;
+            LoadResult best[2];
+            for (int mapped = 0; mapped < 2; ++mapped) {
+                for (int i = 0; i < options.iterations; ++i) {
+                    auto result = loadInChild(model, mapped);
+                    if (i == 0 || result.loadMs + result.readMs < best[mapped].loadMs + best[mapped].readMs) {
+                        best[mapped] = result;
+                    }
+                }
+            }
+            if (best[0].checksum != best[1].checksum) {
+                THROW_IE_EXCEPTION << "The weights of " << model << " differ between the loads";
+            }
+            printResult("read", best[0]);
+            printResult("mmap", best[1]);
+        }
+        return 0;
+    });
+}
@@ -11,7 +11,8 @@ LOCAL_SRC_FILES := \
 	inference-engine/src/vpu/myriad_plugin/myriad_async_infer_request.cpp \
 	inference-engine/src/vpu/myriad_plugin/myriad_executor.cpp \
 	inference-engine/src/vpu/myriad_plugin/myriad_infer_request.cpp \
-	inference-engine/src/vpu/myriad_plugin/myriad_plugin.cpp
+	inference-engine/src/vpu/myriad_plugin/myriad_plugin.cpp \
+	inference-engine/src/vpu/myriad_plugin/myriad_thermal_monitor.cpp
 
 
 LOCAL_C_INCLUDES += \
@@ -25,6 +26,7 @@ LOCAL_C_INCLUDES += \
 	$(LOCAL_PATH)/inference-engine/src/inference_engine/cpp_interfaces/base \
 	$(LOCAL_PATH)/inference-engine/src/inference_engine/cpp_interfaces/impl \
 	$(LOCAL_PATH)/inference-engine/src/inference_engine/cpp_interfaces/interface \
+	$(LOCAL_PATH)/../ncsdk2/api/include \
 	$(LOCAL_PATH)/inference-engine/temp/myriad/include \
 	$(LOCAL_PATH)/inference-engine/src/vpu/common
 
@@ -36,6 +38,6 @@ LOCAL_CFLAGS += -DENABLE_VPU -DENABLE_MYRIAD -DAKS -DIMPLEMENT_INFERENCE_ENGINE_
 
 LOCAL_STATIC_LIBRARIES := libgraph_transformer libvpu_common
 
-LOCAL_SHARED_LIBRARIES := libmvnc libinference_engine libusb1.0 liblog
+LOCAL_SHARED_LIBRARIES := libmvnc libncresidency libinference_engine libusb1.0 liblog
 
 include $(BUILD_SHARED_LIBRARY)
@@ -34,6 +34,8 @@ typedef enum {
 typedef enum {
 	NC_RW_LOG_LEVEL = 0, // Log level, int, 0 = nothing, 1 = errors, 2 = verbose
     NC_RO_API_VER = 1,   // retruns API Version. string
+    NC_RW_MAX_PENDING_TRIGGERS = 2, // Graph triggers sent per device without waiting for the ack, int,
+                                    // 1..32, 1 = each trigger waits for the previous one. Defaults to 32
 } ncGlobalOptions_t;
 
 typedef enum {
@@ -197,6 +199,8 @@ ncStatus_t ncGraphGetOption(struct graphHandle_t *graphHandle,
                             ncOptionClass_t opClass,
                             int option, void *data,
                             unsigned int *dataLength);
+// fifoIn and fifoOut hold a FIFO per graph input and output, in the order of the tensor descriptors.
+// Every input FIFO must have an element, the user param of the first one is passed to all the outputs
 ncStatus_t ncGraphQueueInference(struct graphHandle_t *graphHandle,
                             struct fifoHandle_t** fifoIn,
                             struct fifoHandle_t** fifoOut);
@@ -222,6 +226,14 @@ ncStatus_t ncFifoWriteElem(struct fifoHandle_t* fifo, const void *inputTensor,
 ncStatus_t ncFifoReadElem(struct fifoHandle_t* fifo, void **outputData,
                           struct ncTensorDescriptor_t *outputDesc, void **userParam);
 ncStatus_t ncFifoRemoveElem(struct fifoHandle_t* fifo);
+// Reads the element to the caller's buffer, converted to the FIFO data type
+ncStatus_t ncFifoReadElemToBuffer(struct fifoHandle_t* fifo, void *outputData,
+                                  unsigned int outputLength, void **userParam);
+// Returns the FP16 element data in place, valid until ncFifoReleaseElem.
+// Several elements can be borrowed, they are released in the order of reading
+ncStatus_t ncFifoBorrowElem(struct fifoHandle_t* fifo, void **outputData,
+                            unsigned int *outputLength, void **userParam);
+ncStatus_t ncFifoReleaseElem(struct fifoHandle_t* fifo);
 #ifdef __cplusplus
 }
 #endif
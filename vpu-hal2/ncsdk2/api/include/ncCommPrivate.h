@@ -70,9 +70,18 @@ typedef struct {
     uint32_t releaseElemBuff1;
     uint32_t releaseElemBuff2;
     uint32_t executors_number;
-    uint8_t laterUse[16];
+    uint32_t seqNo; // host side trigger number, the device acks commands in the order they are received
+    // Trigger of a multi tensor graph: buffId1/buffId2 are the first input/output FIFOs,
+    // the other FIFOs follow in buffIdExt/releaseElemExt, inputs first. Zero counts mean one input and one output.
+    uint8_t inputCount;
+    uint8_t outputCount;
+    uint16_t buffIdExt[3];
+    uint8_t releaseElemExt[3];
+    uint8_t laterUse[1];
 }graphCommand_t;
 
+#define GRAPH_CMD_MAX_BUFFERS 5 // buffId1, buffId2 and buffIdExt
+
 typedef struct {
     bufferCommandType_t type;
     char name[16];
@@ -17,6 +17,8 @@
 #include <mvnc.h>
 
 #define NC_MAX_NAME_SIZE        28
+#define NC_MAX_PENDING_TRIGGERS 32
+#define NC_MAX_GRAPH_TENSORS    (GRAPH_CMD_MAX_BUFFERS - 1) // per direction, a graph has at least one input and output
 
 struct _devicePrivate_t {
     int backoff_time_normal, backoff_time_high, backoff_time_critical;
@@ -36,12 +38,25 @@ struct _devicePrivate_t {
     pthread_mutex_t dev_data_m;
     pthread_mutex_t dev_stream_m;
     pthread_mutex_t graph_streamm;
+    // Graph triggers are not waited for, trigger seq is acked once trigger_seq_acked reaches it.
+    // Output elements of the triggers in flight are kept in pending_triggers[seq % NC_MAX_PENDING_TRIGGERS].
+    // Protected by graph_streamm
+    uint32_t trigger_seq_sent;
+    uint32_t trigger_seq_acked;
+    struct _userParamPrivate_t *pending_triggers[NC_MAX_PENDING_TRIGGERS];
     deviceCapabilities_t dev_attr;
     ncDeviceState_t state;
 } *devices;
 struct _userParamPrivate_t {
     void* data;
     struct _userParamPrivate_t* next;
+    // Input element only, the write that sent it to the device
+    XLinkWriteToken_t write_token;
+    // Output element only, protected by dev->graph_streamm
+    uint32_t trigger_seq;
+    int trigger_pending;
+    ncStatus_t trigger_status;
+    struct _userParamPrivate_t* trigger_next; // element of the same trigger in the next output FIFO
 };
 struct _graphPrivate_t {
     uint32_t id;
@@ -51,8 +66,8 @@ struct _graphPrivate_t {
     int have_data;
     int input_count;
     int output_count;
-    struct ncTensorDescriptor_t input_tensor_desc;
-    struct ncTensorDescriptor_t output_tensor_desc;
+    struct ncTensorDescriptor_t input_tensor_desc[NC_MAX_GRAPH_TENSORS];
+    struct ncTensorDescriptor_t output_tensor_desc[NC_MAX_GRAPH_TENSORS];
     unsigned nstages;
     struct _devicePrivate_t *dev;
     struct _graphPrivate_t *next;
@@ -85,6 +100,14 @@ struct _fifoPrivate_t{
     int consumers_remaining;
     pthread_mutex_t fifo_mutex;
     ncFifoState_t state;
-    void* output_data;
+    void* output_data;          // num_elements FP32 slots returned by ncFifoReadElem
+    void* write_staging;        // num_elements FP16 slots, the asynchronous writes are sent from here
+    XLinkWriteToken_t* write_tokens; // last write sent from each staging slot
+    unsigned char* write_slot_held; // set while a writer fills the staging slot and sends it
+    pthread_cond_t write_slot_cond; // signaled when a writer releases its staging slot
+    unsigned int write_index;
+    unsigned int read_index;
+    int borrowed_count;         // packets borrowed by ncFifoBorrowElem, released in order
+    struct _userParamPrivate_t *user_param_free; // recycled user param nodes
 };
 #endif
@@ -0,0 +1,87 @@
+/*
+* Copyright 2017 Intel Corporation.
+* The source code, information and material ("Material") contained herein is
+* owned by Intel Corporation or its suppliers or licensors, and title to such
+* Material remains with Intel Corporation or its suppliers or licensors.
+* The Material contains proprietary information of Intel or its suppliers and
+* licensors. The Material is protected by worldwide copyright laws and treaty
+* provisions.
+* No part of the Material may be used, copied, reproduced, modified, published,
+* uploaded, posted, transmitted, distributed or disclosed in any way without
+* Intel's prior express written permission. No license under any patent,
+* copyright or other intellectual property rights in the Material is granted to
+* or conferred upon you, either expressly, by implication, inducement, estoppel
+* or otherwise.
+* Any license under such intellectual property rights must be express and
+* approved by Intel in writing.
+*/
+
+
+///
+/// @brief     Client of the device and graph residency daemon
+///
+/// ncs_residencyd keeps the devices booted and the graphs allocated across the
+/// lifetimes of the processes using them. A process attaches to a graph with its
+/// graph file: the daemon looks the graph up by the hash of the file, and only
+/// allocates it on a device if it is not resident yet. The tensors are exchanged
+/// through a shared memory region of the attachment, split in slots which each
+/// hold the inputs and the outputs of one inference in flight.
+///
+#ifndef _NC_RESIDENCY_H_
+#define _NC_RESIDENCY_H_
+#include "mvnc.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Socket of the daemon when no path is given and NC_RESIDENCY_SOCKET is not set,
+// only the user running the daemon can connect to it
+#define NC_RESIDENCY_DEFAULT_SOCKET "/tmp/ncs_residencyd.sock"
+#define NC_RESIDENCY_MAX_TENSORS 4   // inputs or outputs of a graph
+#define NC_RESIDENCY_MAX_SLOTS 32    // inferences in flight per attachment
+
+typedef struct ncResidencyGraph_t ncResidencyGraph_t;
+
+typedef struct {
+    unsigned int inputCount;
+    unsigned int outputCount;
+    struct ncTensorDescriptor_t inputs[NC_RESIDENCY_MAX_TENSORS];
+    struct ncTensorDescriptor_t outputs[NC_RESIDENCY_MAX_TENSORS];
+    unsigned int slots;
+    ncFifoDatatype_t dataType;   // of the tensors in the shared memory
+    int resident;                // the graph was allocated before the attachment
+    int deviceIndex;             // device of the daemon running the graph
+} ncResidencyGraphInfo_t;
+
+// 1 if the daemon accepts connections on socketPath (can be NULL), without logging errors
+int ncResidencyDaemonAvailable(const char* socketPath);
+
+// Attaches to the graph of the graph file, which is sent to the daemon only if the
+// graph is not resident. socketPath can be NULL. slots is the number of inferences
+// in flight, 1..NC_RESIDENCY_MAX_SLOTS, and dataType the type of the tensors in the
+// shared memory, converted from and to the FP16 ones of the graph by the daemon.
+ncStatus_t ncResidencyAttach(const char* socketPath, const void* graphFile,
+                             unsigned int graphFileLength, unsigned int slots,
+                             ncFifoDatatype_t dataType, ncResidencyGraph_t** graph);
+// Frees the attachment once its inferences are done, the graph stays resident
+ncStatus_t ncResidencyDetach(ncResidencyGraph_t* graph);
+const ncResidencyGraphInfo_t* ncResidencyGetInfo(ncResidencyGraph_t* graph);
+
+// Tensors of the slot in the shared memory, NULL for a wrong slot or index
+void* ncResidencyInputBuffer(ncResidencyGraph_t* graph, unsigned int slot, unsigned int index);
+void* ncResidencyOutputBuffer(ncResidencyGraph_t* graph, unsigned int slot, unsigned int index);
+
+// Runs the inference of the inputs of the slot, which must not be in flight
+ncStatus_t ncResidencyQueueInference(ncResidencyGraph_t* graph, unsigned int slot);
+// Waits for the oldest inference in flight, returns its slot and status. The outputs
+// of the slot are valid until it is queued again. Queue and wait can be called from
+// two threads, each one from a single thread at a time.
+ncStatus_t ncResidencyWaitInference(ncResidencyGraph_t* graph, unsigned int* slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -35,6 +35,9 @@ LOCAL_SRC_FILES := \
 	mvnc_api_highclass.c \
 	common/components/XLink/pc/UsbLinkPlatform.cpp \
 	common/components/XLink/pc/usb_boot.c \
+	common/components/XLink/pc/XLinkEmulator.c \
+	common/components/XLink/pc/XLinkLoopbackTransport.c \
+	common/components/XLink/pc/XLinkSocketTransport.c \
 	common/components/XLink/shared/XLink.c \
 	common/components/XLink/shared/XLinkDispatcher.c \
 	common/components/XLinkConsole/pc/XLinkConsole.c
@@ -55,6 +58,53 @@ LOCAL_SHARED_LIBRARIES := libusb1.0 liblog
 include $(BUILD_SHARED_LIBRARY)
 
 #include $(BUILD_STATIC_LIBRARY)
+
+# libncresidency: client of ncs_residencyd, without the device stack
+$(info LOCAL_PATH =$(LOCAL_PATH))
+include $(CLEAR_VARS)
+
+LOCAL_MODULE := libncresidency
+LOCAL_PROPRIETARY_MODULE := true
+LOCAL_MULTILIB := both
+LOCAL_MODULE_OWNER := intel
+LOCAL_SRC_FILES := \
+	residency/nc_residency_client.c \
+	residency/nc_residency_sha256.c
+
+LOCAL_C_INCLUDES += \
+	$(LOCAL_PATH)/residency \
+	$(LOCAL_PATH)/../include
+
+LOCAL_CFLAGS += -I$(MV_COMMON_BASE)/shared/include -D__PC__ -Wno-error
+LOCAL_CFLAGS += -O2 -Wall -pthread -fPIC -MMD -MP
+
+LOCAL_SHARED_LIBRARIES := liblog
+
+include $(BUILD_SHARED_LIBRARY)
+
+# ncs_residencyd: keeps the devices booted and the graphs resident
+$(info LOCAL_PATH =$(LOCAL_PATH))
+include $(CLEAR_VARS)
+
+LOCAL_MODULE := ncs_residencyd
+LOCAL_PROPRIETARY_MODULE := true
+LOCAL_MODULE_OWNER := intel
+LOCAL_SRC_FILES := \
+	residency/nc_residency_daemon.c \
+	residency/nc_residency_sha256.c
+
+LOCAL_C_INCLUDES += \
+	$(LOCAL_PATH)/residency \
+	$(LOCAL_PATH)/../include \
+	$(XLINK_BASE)/shared
+
+LOCAL_CFLAGS += -I$(MV_COMMON_BASE)/shared/include -D__PC__ -Wno-error
+LOCAL_CFLAGS += -O2 -Wall -pthread -fPIE -MMD -MP
+
+LOCAL_SHARED_LIBRARIES := libmvnc liblog
+
+include $(BUILD_EXECUTABLE)
+
 $(info LOCAL_PATH =$(LOCAL_PATH))
 include $(CLEAR_VARS)
 
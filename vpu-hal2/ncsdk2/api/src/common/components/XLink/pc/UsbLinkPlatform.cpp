@@ -98,36 +98,166 @@ static double seconds()
     return ts.tv_sec + ts.tv_nsec * 1e-9 - s;
 }
 
-static int usb_write(libusb_device_handle *f, const void *data, size_t size, unsigned int timeout)
+// Bulk transfers start at USB_MAX_TRANSFER_SIZE and are halved down to PACKET_LENGTH
+// when the host controller or usbfs can't allocate them.
+// The sizes are multiples of the max packet size, so only the last transfer of a buffer can be short.
+#define USB_MAX_TRANSFER_SIZE (4*1024*1024)
+#define USB_MAX_TRANSFERS_IN_FLIGHT 4
+
+static int usbTransferSize = USB_MAX_TRANSFER_SIZE;
+
+typedef struct
+{
+    struct libusb_transfer* transfers[USB_MAX_TRANSFERS_IN_FLIGHT];
+    volatile int completed;     // incremented by the callback, transfers of an endpoint complete in order
+    volatile int wake;          // completion flag of libusb_handle_events_completed
+    int status;                 // first error, libusb_error
+} usbTransferQueue_t;
+
+static int usb_transfer_status(struct libusb_transfer* t)
 {
-    while(size > 0)
+    switch (t->status)
     {
-        int bt, ss = size;
-        if(ss > 1024*1024*10)
-            ss = 1024*1024*10;
-        int rc = libusb_bulk_transfer(f, USB_ENDPOINT_OUT, (unsigned char *)data, ss, &bt, timeout);
-        if(rc)
-            return rc;
-        data = (char *)data + bt;
-        size -= bt;
+    case LIBUSB_TRANSFER_COMPLETED:
+        return 0;
+    case LIBUSB_TRANSFER_TIMED_OUT:
+        return LIBUSB_ERROR_TIMEOUT;
+    case LIBUSB_TRANSFER_STALL:
+        return LIBUSB_ERROR_PIPE;
+    case LIBUSB_TRANSFER_NO_DEVICE:
+        return LIBUSB_ERROR_NO_DEVICE;
+    case LIBUSB_TRANSFER_OVERFLOW:
+        return LIBUSB_ERROR_OVERFLOW;
+    case LIBUSB_TRANSFER_CANCELLED:
+        return LIBUSB_ERROR_INTERRUPTED;
+    default:
+        return LIBUSB_ERROR_IO;
     }
-    return 0;
 }
 
-static int usb_read(libusb_device_handle *f, void *data, size_t size, unsigned int timeout)
+static void LIBUSB_CALL usb_transfer_done(struct libusb_transfer* t)
 {
-    while(size > 0)
+    usbTransferQueue_t* q = (usbTransferQueue_t*)t->user_data;
+    q->completed++;
+    q->wake = 1;
+}
+
+// Waits for the completion of the submitted-th transfer of the queue, the libusb events
+// are handled by whichever waiting thread gets the event lock
+static void usb_wait_transfer(usbTransferQueue_t* q, int submitted)
+{
+    while (q->completed < submitted)
     {
-        int bt, ss = size;
-        if(ss > 1024*1024*10)
-            ss = 1024*1024*10;
-        int rc = libusb_bulk_transfer(f, USB_ENDPOINT_IN,(unsigned char *)data, ss, &bt, timeout);
-        if(rc)
-            return rc;
-        data = ((char *)data) + bt;
-        size -= bt;
+        q->wake = 0;
+        if (q->completed < submitted)
+            libusb_handle_events_completed(NULL, (int*)&q->wake);
     }
-    return 0;
+}
+
+// Transfers the buffers of iov back to back on endpoint, with up to maxInFlight bulk transfers
+// submitted at once. Returns 0 or a libusb_error.
+static int usb_transfer(libusb_device_handle *f, unsigned char endpoint, const xLinkIoVec_t* iov, int iovcnt,
+                        int maxInFlight, unsigned int timeout)
+{
+    usbTransferQueue_t q;
+    int i;
+    q.completed = 0;
+    q.wake = 0;
+    q.status = 0;
+    for (i = 0; i < maxInFlight; i++)
+    {
+        q.transfers[i] = libusb_alloc_transfer(0);
+        if (!q.transfers[i])
+        {
+            while (i--)
+                libusb_free_transfer(q.transfers[i]);
+            return LIBUSB_ERROR_NO_MEM;
+        }
+    }
+
+    int submitted = 0;
+    int vec = 0, offset = 0;            // next byte to submit
+    int lastVec = 0, lastOffset = 0;    // start of the last submitted transfer
+    for (;;)
+    {
+        while (vec < iovcnt && offset == iov[vec].size)
+        {
+            vec++;
+            offset = 0;
+        }
+        if (!q.status && vec < iovcnt && submitted - q.completed < maxInFlight)
+        {
+            int length = iov[vec].size - offset;
+            if (length > usbTransferSize)
+                length = usbTransferSize;
+            struct libusb_transfer* t = q.transfers[submitted % maxInFlight];
+            libusb_fill_bulk_transfer(t, f, endpoint, (unsigned char*)iov[vec].data + offset, length,
+                                      usb_transfer_done, &q, timeout);
+            int rc = libusb_submit_transfer(t);
+            if (rc == LIBUSB_ERROR_NO_MEM && usbTransferSize > PACKET_LENGTH)
+            {
+                usbTransferSize /= 2;
+                USBLINK_PRINT("USB transfer size reduced to %d\n", usbTransferSize);
+                continue;
+            }
+            if (rc)
+            {
+                q.status = rc;
+            }
+            else
+            {
+                lastVec = vec;
+                lastOffset = offset;
+                submitted++;
+                offset += length;
+            }
+            continue;
+        }
+        if (q.completed == submitted)
+            break;
+
+        struct libusb_transfer* t = q.transfers[q.completed % maxInFlight];
+        usb_wait_transfer(&q, q.completed + 1);
+        if (q.status)
+            continue;
+        q.status = usb_transfer_status(t);
+        if (!q.status && t->actual_length < t->length)
+        {
+            // like libusb_bulk_transfer, a short transfer is followed by one for the rest of its data,
+            // which is only possible when it was the last one submitted
+            if (q.completed == submitted)
+            {
+                vec = lastVec;
+                offset = lastOffset + t->actual_length;
+            }
+            else
+            {
+                q.status = LIBUSB_ERROR_IO;
+            }
+        }
+        if (q.status)
+        {
+            for (i = q.completed; i < submitted; i++)
+                libusb_cancel_transfer(q.transfers[i % maxInFlight]);
+        }
+    }
+    for (i = 0; i < maxInFlight; i++)
+        libusb_free_transfer(q.transfers[i]);
+    return q.status;
+}
+
+static int usb_write(libusb_device_handle *f, const xLinkIoVec_t* iov, int iovcnt, unsigned int timeout)
+{
+    return usb_transfer(f, USB_ENDPOINT_OUT, iov, iovcnt, USB_MAX_TRANSFERS_IN_FLIGHT, timeout);
+}
+
+static int usb_read(libusb_device_handle *f, void *data, size_t size, unsigned int timeout)
+{
+    // a short packet ends an IN transfer early, so the reads are not queued
+    xLinkIoVec_t iov;
+    iov.data = data;
+    iov.size = size;
+    return usb_transfer(f, USB_ENDPOINT_IN, &iov, 1, 1, timeout);
 }
 
 libusb_device_handle *usblink_open(const char *path)
@@ -214,11 +344,29 @@ int USBLinkWrite(void* fd, void* data, int size, unsigned int timeout)
     }
 #endif  /*USE_LINK_JTAG*/
 #else
-    rc = usb_write((libusb_device_handle *) fd, data, size, timeout);
+    xLinkIoVec_t iov;
+    iov.data = data;
+    iov.size = size;
+    rc = usb_write((libusb_device_handle *) fd, &iov, 1, timeout);
 #endif  /*USE_USB_VSC*/
     return rc;
 }
 
+int USBLinkWritev(void* fd, const xLinkIoVec_t* iov, int iovcnt, unsigned int timeout)
+{
+#ifndef USE_USB_VSC
+    for (int i = 0; i < iovcnt; i++)
+    {
+        int rc = USBLinkWrite(fd, iov[i].data, iov[i].size, timeout);
+        if (rc)
+            return rc;
+    }
+    return 0;
+#else
+    return usb_write((libusb_device_handle *) fd, iov, iovcnt, timeout);
+#endif  /*USE_USB_VSC*/
+}
+
  int USBLinkRead(void* fd, void* data, int size, unsigned int timeout)
 {
     //printf("%s() fd %p size %d\n", __func__, fd, size);
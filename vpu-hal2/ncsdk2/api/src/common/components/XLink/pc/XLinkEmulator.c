@@ -0,0 +1,588 @@
+/*
+* Copyright 2017 Intel Corporation.
+* The source code, information and material ("Material") contained herein is
+* owned by Intel Corporation or its suppliers or licensors, and title to such
+* Material remains with Intel Corporation or its suppliers or licensors.
+* The Material contains proprietary information of Intel or its suppliers and
+* licensors. The Material is protected by worldwide copyright laws and treaty
+* provisions.
+* No part of the Material may be used, copied, reproduced, modified, published,
+* uploaded, posted, transmitted, distributed or disclosed in any way without
+* Intel's prior express written permission. No license under any patent,
+* copyright or other intellectual property rights in the Material is granted to
+* or conferred upon you, either expressly, by implication, inducement, estoppel
+* or otherwise.
+* Any license under such intellectual property rights must be express and
+* approved by Intel in writing.
+*/
+
+
+///
+/// @brief     Emulation of the device side of an XLink link
+///
+/// A reader thread answers the requests of the host and hands its writes to the
+/// device model. The packets to the host go through a queue served by a sender
+/// thread, which applies the link latency and bandwidth and waits for space in
+/// the host side of the streams.
+///
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "XLinkEmulator.h"
+#define _USBLINK_ENABLE_PRIVATE_INCLUDE_
+#include "XLinkPrivateDefines.h"
+#define MVLOG_UNIT_NAME xLinkEmulator
+#include "mvLog.h"
+
+#define EMULATOR_MAX_STREAMS 32
+// ids of the requests sent by the device, far from the ones of the host
+#define EMULATOR_FIRST_EVENT_ID 0x40000000
+
+typedef struct emulatorMessage_t {
+    xLinkEventHeader_t header;
+    uint8_t* data;      // payload of the device writes
+    double due;
+    struct emulatorMessage_t* next;
+} emulatorMessage_t;
+
+typedef struct {
+    int used;
+    streamId_t id;
+    char name[MAX_NAME_LENGTH + 1];
+    streamPacketDesc_t packets[USB_LINK_MAX_PACKETS_PER_STREAM]; // written by the host
+    int firstPacket;
+    int packetCount;
+    int hostPackets;    // written by the device and not released by the host
+    int scanBlocked;    // an older write of the stream is waiting in the send queue
+} emulatorStream_t;
+
+struct xLinkEmulator_t {
+    xLinkEmulatorChannel_t channel;
+    xLinkEmulatorConfig_t config;
+    xLinkDeviceModel_t model;
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    pthread_t reader;
+    pthread_t sender;
+    int closed;
+
+    emulatorStream_t streams[EMULATOR_MAX_STREAMS];
+    streamId_t nextStreamId;
+    eventId_t nextEventId;
+    emulatorMessage_t* first;   // queue to the host
+    emulatorMessage_t* last;
+    uint32_t hostPacketCount;
+    uint32_t hostWriteCount;
+    double rxFreeTime;          // the link is busy with a transfer until these times
+    double txFreeTime;
+};
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void toTimespec(double t, struct timespec* ts)
+{
+    ts->tv_sec = (time_t)t;
+    ts->tv_nsec = (long)((t - ts->tv_sec) * 1e9);
+}
+
+static void sleepUntil(double t)
+{
+    struct timespec ts;
+    toTimespec(t, &ts);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL))
+        ;
+}
+
+// Occupies the calling thread for the transfer time of size bytes
+static void transfer(double* freeTime, double bandwidth, uint32_t size)
+{
+    if (bandwidth <= 0)
+        return;
+    double start = *freeTime > now() ? *freeTime : now();
+    *freeTime = start + size / (bandwidth * 1e6);
+    sleepUntil(*freeTime);
+}
+
+// Reads or writes size bytes of packet data at the link bandwidth, one USB packet at a time,
+// so that the host side transfer lasts as long as on the link
+static int pacedIo(xLinkEmulator_t* emu, int isWrite, double* freeTime, uint8_t* data, uint32_t size)
+{
+    do {
+        uint32_t chunk = size > PACKET_LENGTH ? PACKET_LENGTH : size;
+        transfer(freeTime, emu->config.bandwidth, chunk);
+        int rc = isWrite ? emu->channel.write(emu->channel.channel, data, chunk)
+                         : emu->channel.read(emu->channel.channel, data, chunk);
+        if (rc < 0)
+            return rc;
+        data += chunk;
+        size -= chunk;
+    } while (size);
+    return 0;
+}
+
+static int envInt(const char* name)
+{
+    const char* value = getenv(name);
+    return value ? atoi(value) : 0;
+}
+
+void xLinkEmulatorConfigFromEnv(xLinkEmulatorConfig_t* config)
+{
+    const char* mbps = getenv("XLINK_EMU_MBPS");
+    config->bandwidth = mbps ? atof(mbps) : 0;
+    config->latencyUs = envInt("XLINK_EMU_LATENCY_US");
+    config->nackEvery = envInt("XLINK_EMU_NACK_EVERY");
+    config->disconnectAfter = envInt("XLINK_EMU_DISCONNECT_AFTER");
+    config->bootMs = envInt("XLINK_EMU_BOOT_MS");
+}
+
+//called with the lock taken
+static emulatorStream_t* getStream(xLinkEmulator_t* emu, streamId_t id)
+{
+    int i;
+    for (i = 0; i < EMULATOR_MAX_STREAMS; i++) {
+        if (emu->streams[i].used && emu->streams[i].id == id)
+            return &emu->streams[i];
+    }
+    return NULL;
+}
+
+//called with the lock taken
+static int queueMessage(xLinkEmulator_t* emu, xLinkEventHeader_t* header,
+                        const void* data, int delayUs)
+{
+    emulatorMessage_t* msg = malloc(sizeof(*msg));
+    if (!msg)
+        return -1;
+    msg->header = *header;
+    msg->data = NULL;
+    if (data) {
+        msg->data = malloc(header->size ? header->size : 1);
+        if (!msg->data) {
+            free(msg);
+            return -1;
+        }
+        memcpy(msg->data, data, header->size);
+    }
+    msg->due = now() + (emu->config.latencyUs + delayUs) * 1e-6;
+    msg->next = NULL;
+    if (emu->last)
+        emu->last->next = msg;
+    else
+        emu->first = msg;
+    emu->last = msg;
+    pthread_cond_broadcast(&emu->cond);
+    return 0;
+}
+
+//called with the lock taken
+static void respond(xLinkEmulator_t* emu, xLinkEventHeader_t* request,
+                    xLinkEventType_t type, int ack)
+{
+    xLinkEventHeader_t resp = *request;
+    resp.type = type;
+    resp.flags.raw = 0;
+    resp.flags.bitField.ack = ack;
+    resp.flags.bitField.nack = !ack;
+    queueMessage(emu, &resp, NULL, 0);
+}
+
+//called with the lock taken, gives the space of a packet back to the host
+static void queueRelease(xLinkEmulator_t* emu, streamId_t id, uint32_t size)
+{
+    xLinkEventHeader_t rel;
+    memset(&rel, 0, sizeof(rel));
+    rel.type = USB_READ_REL_REQ;
+    rel.id = emu->nextEventId++;
+    rel.streamId = id;
+    rel.size = size;
+    queueMessage(emu, &rel, NULL, 0);
+}
+
+//called with the lock taken
+static void releasePacket(xLinkEmulator_t* emu, emulatorStream_t* stream)
+{
+    streamPacketDesc_t* packet = &stream->packets[stream->firstPacket];
+    queueRelease(emu, stream->id, packet->length);
+    free(packet->data);
+    stream->firstPacket = (stream->firstPacket + 1) % USB_LINK_MAX_PACKETS_PER_STREAM;
+    stream->packetCount--;
+}
+
+//called with the lock taken
+static void dropStreamMessages(xLinkEmulator_t* emu, streamId_t id)
+{
+    emulatorMessage_t** prev = &emu->first;
+    emu->last = NULL;
+    while (*prev) {
+        emulatorMessage_t* msg = *prev;
+        if (msg->data && msg->header.streamId == id) {
+            *prev = msg->next;
+            free(msg->data);
+            free(msg);
+        } else {
+            emu->last = msg;
+            prev = &msg->next;
+        }
+    }
+}
+
+static void closeLink(xLinkEmulator_t* emu)
+{
+    pthread_mutex_lock(&emu->lock);
+    emu->closed = 1;
+    pthread_cond_broadcast(&emu->cond);
+    pthread_mutex_unlock(&emu->lock);
+    emu->channel.close(emu->channel.channel);
+}
+
+static void handleWrite(xLinkEmulator_t* emu, xLinkEventHeader_t* header, uint8_t* data)
+{
+    pthread_mutex_lock(&emu->lock);
+    emulatorStream_t* stream = getStream(emu, header->streamId);
+    int nack = !stream || stream->packetCount == USB_LINK_MAX_PACKETS_PER_STREAM ||
+               (emu->config.nackEvery && ++emu->hostWriteCount % emu->config.nackEvery == 0);
+    if (nack) {
+        mvLog(MVLOG_DEBUG, "NACK write of %u bytes to stream %u\n", header->size, header->streamId);
+        respond(emu, header, USB_WRITE_RESP, 0);
+        // the host counts the packet in the stream until it is released
+        if (stream)
+            queueRelease(emu, stream->id, header->size);
+        free(data);
+        pthread_mutex_unlock(&emu->lock);
+        return;
+    }
+    streamPacketDesc_t* packet = &stream->packets[(stream->firstPacket + stream->packetCount) %
+                                                  USB_LINK_MAX_PACKETS_PER_STREAM];
+    packet->data = data;
+    packet->length = header->size;
+    stream->packetCount++;
+    respond(emu, header, USB_WRITE_RESP, 1);
+    if (!emu->model.dataWritten)
+        releasePacket(emu, stream);
+    pthread_mutex_unlock(&emu->lock);
+
+    if (emu->model.dataWritten)
+        emu->model.dataWritten(emu->model.ctx, emu, header->streamId);
+}
+
+static void handleCreateStream(xLinkEmulator_t* emu, xLinkEventHeader_t* header)
+{
+    char name[MAX_NAME_LENGTH + 1];
+    memcpy(name, header->streamName, MAX_NAME_LENGTH);
+    name[MAX_NAME_LENGTH] = '\0';
+
+    pthread_mutex_lock(&emu->lock);
+    emulatorStream_t* stream = NULL;
+    int i, created = 0;
+    for (i = 0; i < EMULATOR_MAX_STREAMS && !stream; i++) {
+        if (emu->streams[i].used && strcmp(emu->streams[i].name, name) == 0)
+            stream = &emu->streams[i];
+    }
+    for (i = 0; i < EMULATOR_MAX_STREAMS && !stream; i++) {
+        if (!emu->streams[i].used) {
+            stream = &emu->streams[i];
+            memset(stream, 0, sizeof(*stream));
+            stream->used = 1;
+            stream->id = emu->nextStreamId++;
+            strcpy(stream->name, name);
+            created = 1;
+        }
+    }
+    if (stream)
+        header->streamId = stream->id;
+    respond(emu, header, USB_CREATE_STREAM_RESP, stream != NULL);
+    pthread_mutex_unlock(&emu->lock);
+
+    if (created && emu->model.streamOpened)
+        emu->model.streamOpened(emu->model.ctx, emu, stream->id, name);
+}
+
+static void handleCloseStream(xLinkEmulator_t* emu, xLinkEventHeader_t* header)
+{
+    pthread_mutex_lock(&emu->lock);
+    emulatorStream_t* stream = getStream(emu, header->streamId);
+    respond(emu, header, USB_CLOSE_STREAM_RESP, 1);
+    if (stream) {
+        // the host closes a stream once the device released all its packets
+        while (stream->packetCount) {
+            free(stream->packets[stream->firstPacket].data);
+            stream->firstPacket = (stream->firstPacket + 1) % USB_LINK_MAX_PACKETS_PER_STREAM;
+            stream->packetCount--;
+        }
+        dropStreamMessages(emu, stream->id);
+        stream->used = 0;
+    }
+    pthread_mutex_unlock(&emu->lock);
+
+    if (stream && emu->model.streamClosed)
+        emu->model.streamClosed(emu->model.ctx, emu, header->streamId);
+}
+
+static void* emulatorReader(void* ctx)
+{
+    xLinkEmulator_t* emu = (xLinkEmulator_t*)ctx;
+    xLinkEventHeader_t header;
+
+    if (emu->config.bootMs)
+        usleep(emu->config.bootMs * 1000);
+    if (emu->model.connected)
+        emu->model.connected(emu->model.ctx, emu);
+    while (emu->channel.read(emu->channel.channel, &header, sizeof(header)) >= 0) {
+        if (emu->config.disconnectAfter &&
+            ++emu->hostPacketCount > (uint32_t)emu->config.disconnectAfter) {
+            mvLog(MVLOG_INFO, "Dropping the link after %d packets\n", emu->config.disconnectAfter);
+            break;
+        }
+        if (header.type == USB_WRITE_REQ) {
+            uint8_t* data = malloc(header.size ? header.size : 1);
+            if (!data || pacedIo(emu, 0, &emu->rxFreeTime, data, header.size) < 0) {
+                free(data);
+                break;
+            }
+            handleWrite(emu, &header, data);
+            continue;
+        }
+        pthread_mutex_lock(&emu->lock);
+        emulatorStream_t* stream;
+        switch (header.type) {
+        case USB_PING_REQ:
+            respond(emu, &header, USB_PING_RESP, 1);
+            break;
+        case USB_READ_REL_REQ:
+            stream = getStream(emu, header.streamId);
+            if (stream && stream->hostPackets)
+                stream->hostPackets--;
+            respond(emu, &header, USB_READ_REL_RESP, 1);
+            break;
+        case USB_RESET_REQ:
+            // the sender closes the link once the response is sent
+            respond(emu, &header, USB_RESET_RESP, 1);
+            break;
+        default: // the responses to the requests of the device
+            break;
+        }
+        pthread_mutex_unlock(&emu->lock);
+
+        if (header.type == USB_CREATE_STREAM_REQ)
+            handleCreateStream(emu, &header);
+        else if (header.type == USB_CLOSE_STREAM_REQ)
+            handleCloseStream(emu, &header);
+        else if (header.type == USB_RESET_REQ)
+            return NULL;
+    }
+    closeLink(emu);
+    return NULL;
+}
+
+//called with the lock taken, returns the next message which can be sent
+static emulatorMessage_t* nextMessage(xLinkEmulator_t* emu, double* wakeup)
+{
+    double t = now();
+    emulatorMessage_t* msg;
+    int i;
+    *wakeup = 0;
+    for (i = 0; i < EMULATOR_MAX_STREAMS; i++)
+        emu->streams[i].scanBlocked = 0;
+    for (msg = emu->first; msg; msg = msg->next) {
+        emulatorStream_t* stream = msg->data ? getStream(emu, msg->header.streamId) : NULL;
+        if (msg->due > t) {
+            if (!*wakeup || msg->due < *wakeup)
+                *wakeup = msg->due;
+            if (stream)
+                stream->scanBlocked = 1;
+            continue;
+        }
+        // device writes stay in order and wait for space on the host
+        if (stream && (stream->scanBlocked ||
+                       stream->hostPackets == USB_LINK_MAX_PACKETS_PER_STREAM)) {
+            stream->scanBlocked = 1;
+            continue;
+        }
+        return msg;
+    }
+    return NULL;
+}
+
+static void* emulatorSender(void* ctx)
+{
+    xLinkEmulator_t* emu = (xLinkEmulator_t*)ctx;
+
+    pthread_mutex_lock(&emu->lock);
+    while (!emu->closed) {
+        double wakeup;
+        emulatorMessage_t* msg = nextMessage(emu, &wakeup);
+        if (!msg) {
+            if (wakeup) {
+                struct timespec ts;
+                toTimespec(wakeup, &ts);
+                pthread_cond_timedwait(&emu->cond, &emu->lock, &ts);
+            } else {
+                pthread_cond_wait(&emu->cond, &emu->lock);
+            }
+            continue;
+        }
+        // unlink it
+        emulatorMessage_t** prev = &emu->first;
+        emulatorMessage_t* before = NULL;
+        while (*prev != msg) {
+            before = *prev;
+            prev = &(*prev)->next;
+        }
+        *prev = msg->next;
+        if (emu->last == msg)
+            emu->last = before;
+        if (msg->data) {
+            emulatorStream_t* stream = getStream(emu, msg->header.streamId);
+            if (stream)
+                stream->hostPackets++;
+        }
+        pthread_mutex_unlock(&emu->lock);
+
+        int rc = emu->channel.write(emu->channel.channel, &msg->header, sizeof(msg->header));
+        if (rc >= 0 && msg->data)
+            rc = pacedIo(emu, 1, &emu->txFreeTime, msg->data, msg->header.size);
+        int reset = msg->header.type == USB_RESET_RESP;
+        free(msg->data);
+        free(msg);
+        if (rc < 0 || reset) {
+            closeLink(emu);
+            return NULL;
+        }
+        pthread_mutex_lock(&emu->lock);
+    }
+    pthread_mutex_unlock(&emu->lock);
+    return NULL;
+}
+
+xLinkEmulator_t* xLinkEmulatorStart(const xLinkEmulatorChannel_t* channel,
+                                    const xLinkEmulatorConfig_t* config,
+                                    const xLinkDeviceModel_t* model)
+{
+    xLinkEmulator_t* emu = calloc(1, sizeof(*emu));
+    if (!emu)
+        return NULL;
+    emu->channel = *channel;
+    if (config)
+        emu->config = *config;
+    if (model)
+        emu->model = *model;
+    emu->nextEventId = EMULATOR_FIRST_EVENT_ID;
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&emu->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&emu->lock, NULL);
+
+    if (pthread_create(&emu->sender, NULL, emulatorSender, emu)) {
+        mvLog(MVLOG_ERROR, "Thread creation failed\n");
+        free(emu);
+        return NULL;
+    }
+    if (pthread_create(&emu->reader, NULL, emulatorReader, emu)) {
+        mvLog(MVLOG_ERROR, "Thread creation failed\n");
+        closeLink(emu);
+        pthread_join(emu->sender, NULL);
+        free(emu);
+        return NULL;
+    }
+    return emu;
+}
+
+void xLinkEmulatorWait(xLinkEmulator_t* emu)
+{
+    pthread_mutex_lock(&emu->lock);
+    while (!emu->closed)
+        pthread_cond_wait(&emu->cond, &emu->lock);
+    pthread_mutex_unlock(&emu->lock);
+}
+
+void xLinkEmulatorStop(xLinkEmulator_t* emu)
+{
+    closeLink(emu);
+    pthread_join(emu->reader, NULL);
+    pthread_join(emu->sender, NULL);
+
+    int i;
+    for (i = 0; i < EMULATOR_MAX_STREAMS; i++) {
+        emulatorStream_t* stream = &emu->streams[i];
+        while (stream->used && stream->packetCount) {
+            free(stream->packets[stream->firstPacket].data);
+            stream->firstPacket = (stream->firstPacket + 1) % USB_LINK_MAX_PACKETS_PER_STREAM;
+            stream->packetCount--;
+        }
+    }
+    while (emu->first) {
+        emulatorMessage_t* msg = emu->first;
+        emu->first = msg->next;
+        free(msg->data);
+        free(msg);
+    }
+    pthread_cond_destroy(&emu->cond);
+    pthread_mutex_destroy(&emu->lock);
+    free(emu);
+}
+
+streamId_t xLinkEmulatorFindStream(xLinkEmulator_t* emu, const char* name)
+{
+    streamId_t id = INVALID_STREAM_ID;
+    int i;
+    pthread_mutex_lock(&emu->lock);
+    for (i = 0; i < EMULATOR_MAX_STREAMS; i++) {
+        if (emu->streams[i].used && strcmp(emu->streams[i].name, name) == 0)
+            id = emu->streams[i].id;
+    }
+    pthread_mutex_unlock(&emu->lock);
+    return id;
+}
+
+const streamPacketDesc_t* xLinkEmulatorPeek(xLinkEmulator_t* emu, streamId_t id, int index)
+{
+    const streamPacketDesc_t* packet = NULL;
+    pthread_mutex_lock(&emu->lock);
+    emulatorStream_t* stream = getStream(emu, id);
+    if (stream && index >= 0 && index < stream->packetCount)
+        packet = &stream->packets[(stream->firstPacket + index) % USB_LINK_MAX_PACKETS_PER_STREAM];
+    pthread_mutex_unlock(&emu->lock);
+    return packet;
+}
+
+void xLinkEmulatorRelease(xLinkEmulator_t* emu, streamId_t id)
+{
+    pthread_mutex_lock(&emu->lock);
+    emulatorStream_t* stream = getStream(emu, id);
+    if (stream && stream->packetCount)
+        releasePacket(emu, stream);
+    pthread_mutex_unlock(&emu->lock);
+}
+
+int xLinkEmulatorWrite(xLinkEmulator_t* emu, streamId_t id, const void* data,
+                       uint32_t size, int delayUs)
+{
+    int rc = -1;
+    pthread_mutex_lock(&emu->lock);
+    if (!emu->closed && getStream(emu, id)) {
+        xLinkEventHeader_t header;
+        memset(&header, 0, sizeof(header));
+        header.type = USB_WRITE_REQ;
+        header.id = emu->nextEventId++;
+        header.streamId = id;
+        header.size = size;
+        rc = queueMessage(emu, &header, data, delayUs);
+    }
+    pthread_mutex_unlock(&emu->lock);
+    return rc;
+}
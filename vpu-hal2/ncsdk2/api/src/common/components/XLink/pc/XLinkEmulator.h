@@ -0,0 +1,112 @@
+/*
+* Copyright 2017 Intel Corporation.
+* The source code, information and material ("Material") contained herein is
+* owned by Intel Corporation or its suppliers or licensors, and title to such
+* Material remains with Intel Corporation or its suppliers or licensors.
+* The Material contains proprietary information of Intel or its suppliers and
+* licensors. The Material is protected by worldwide copyright laws and treaty
+* provisions.
+* No part of the Material may be used, copied, reproduced, modified, published,
+* uploaded, posted, transmitted, distributed or disclosed in any way without
+* Intel's prior express written permission. No license under any patent,
+* copyright or other intellectual property rights in the Material is granted to
+* or conferred upon you, either expressly, by implication, inducement, estoppel
+* or otherwise.
+* Any license under such intellectual property rights must be express and
+* approved by Intel in writing.
+*/
+
+
+///
+/// @brief     Emulation of the device side of an XLink link
+///
+/// Answers the XLink protocol of the host over a byte channel and hands the packets
+/// written by the host to a device model, which plays the device application.
+/// Used by the loopback transport in-process and by the xlink_emulator test app
+/// behind the socket transport.
+///
+#ifndef _XLINK_EMULATOR_H
+#define _XLINK_EMULATOR_H
+#include <stdint.h>
+#include "XLinkPublicDefines.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct xLinkEmulator_t xLinkEmulator_t;
+
+// Byte channel to the host. read and write transfer the whole buffer or return a
+// negative value once the channel is closed, close unblocks them.
+typedef struct {
+    int (*read)(void* channel, void* data, int size);
+    int (*write)(void* channel, const void* data, int size);
+    void (*close)(void* channel);
+    void* channel;
+} xLinkEmulatorChannel_t;
+
+// Characteristics of the emulated link
+typedef struct {
+    double bandwidth;        // MB/s in each direction, 0 for unlimited
+    int latencyUs;           // added to every packet sent to the host
+    int nackEvery;           // every n-th write of the host is NACKed and dropped, 0 for never
+    int disconnectAfter;     // the device drops the link after n packets of the host, 0 for never
+    int bootMs;              // the device answers the host bootMs after the link is connected,
+                             // like the firmware booting at every ncDeviceOpen
+} xLinkEmulatorConfig_t;
+
+// Application running on the emulated device. The callbacks are optional, they are
+// called one at a time from the thread reading the link and must not block.
+typedef struct {
+    void* ctx;
+    // A host connected, the model starts from a clean state
+    void (*connected)(void* ctx, xLinkEmulator_t* emu);
+    // The host opened a stream
+    void (*streamOpened)(void* ctx, xLinkEmulator_t* emu, streamId_t id, const char* name);
+    // The host wrote a packet to the stream, it is kept until xLinkEmulatorRelease.
+    // Without this callback the packets are released as they arrive.
+    void (*dataWritten)(void* ctx, xLinkEmulator_t* emu, streamId_t id);
+    // The host closed the stream
+    void (*streamClosed)(void* ctx, xLinkEmulator_t* emu, streamId_t id);
+} xLinkDeviceModel_t;
+
+// Reads the configuration from the environment: XLINK_EMU_MBPS, XLINK_EMU_LATENCY_US,
+// XLINK_EMU_NACK_EVERY, XLINK_EMU_DISCONNECT_AFTER and XLINK_EMU_BOOT_MS, all 0 by default
+void xLinkEmulatorConfigFromEnv(xLinkEmulatorConfig_t* config);
+
+// Starts serving the host on the channel, returns NULL on failure
+xLinkEmulator_t* xLinkEmulatorStart(const xLinkEmulatorChannel_t* channel,
+                                    const xLinkEmulatorConfig_t* config,
+                                    const xLinkDeviceModel_t* model);
+
+// Waits until the link is reset by the host or dropped by either side
+void xLinkEmulatorWait(xLinkEmulator_t* emu);
+
+// Closes the channel, waits for the emulator threads and frees the emulator
+void xLinkEmulatorStop(xLinkEmulator_t* emu);
+
+// Functions for the device model. The streams are identified by the id the host
+// uses, without the link id.
+streamId_t xLinkEmulatorFindStream(xLinkEmulator_t* emu, const char* name);
+
+// Packet number index of the ones written by the host and not released yet, NULL if
+// there are not so many. The oldest packet has index 0.
+const streamPacketDesc_t* xLinkEmulatorPeek(xLinkEmulator_t* emu, streamId_t id, int index);
+
+// Releases the oldest packet of the stream, which gives its space back to the host
+void xLinkEmulatorRelease(xLinkEmulator_t* emu, streamId_t id);
+
+// Writes a copy of the data to the host side of the stream after delayUs and the link
+// latency. The writes of a stream reach the host in order, they wait while the host
+// holds USB_LINK_MAX_PACKETS_PER_STREAM packets of it. Returns 0 on success.
+int xLinkEmulatorWrite(xLinkEmulator_t* emu, streamId_t id, const void* data,
+                       uint32_t size, int delayUs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/* end of include file */
@@ -0,0 +1,298 @@
+/*
+* Copyright 2017 Intel Corporation.
+* The source code, information and material ("Material") contained herein is
+* owned by Intel Corporation or its suppliers or licensors, and title to such
+* Material remains with Intel Corporation or its suppliers or licensors.
+* The Material contains proprietary information of Intel or its suppliers and
+* licensors. The Material is protected by worldwide copyright laws and treaty
+* provisions.
+* No part of the Material may be used, copied, reproduced, modified, published,
+* uploaded, posted, transmitted, distributed or disclosed in any way without
+* Intel's prior express written permission. No license under any patent,
+* copyright or other intellectual property rights in the Material is granted to
+* or conferred upon you, either expressly, by implication, inducement, estoppel
+* or otherwise.
+* Any license under such intellectual property rights must be express and
+* approved by Intel in writing.
+*/
+
+
+///
+/// @brief     In-process loopback transport of XLink
+///
+/// Two byte pipes connect the host side of XLink to an XLinkEmulator. The pipes
+/// hold one USB packet, so a write occupies the host thread like a bulk transfer.
+///
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "XLinkLoopbackTransport.h"
+#include "UsbLinkPlatform.h"
+
+#define LOOPBACK_DEVICE_NAME "loopback-emulator"
+#define LOOPBACK_PIPE_SIZE PACKET_LENGTH
+#define LOOPBACK_RESET_WAIT_MS 1000
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint8_t* data;
+    int head;
+    int count;
+    int closed;
+} bytePipe_t;
+
+typedef struct {
+    bytePipe_t toDevice;
+    bytePipe_t toHost;
+    xLinkEmulator_t* emulator;
+} loopbackLink_t;
+
+static pthread_mutex_t deviceLock = PTHREAD_MUTEX_INITIALIZER;
+static xLinkDeviceModel_t deviceModel;
+static xLinkEmulatorConfig_t deviceConfig;
+static int deviceSet;
+static loopbackLink_t* activeLink;
+
+static int pipeInit(bytePipe_t* p)
+{
+    p->data = malloc(LOOPBACK_PIPE_SIZE);
+    if (!p->data)
+        return -1;
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->cond, NULL);
+    p->head = 0;
+    p->count = 0;
+    p->closed = 0;
+    return 0;
+}
+
+static void pipeDestroy(bytePipe_t* p)
+{
+    pthread_cond_destroy(&p->cond);
+    pthread_mutex_destroy(&p->lock);
+    free(p->data);
+}
+
+static int pipeClosed(bytePipe_t* p)
+{
+    pthread_mutex_lock(&p->lock);
+    int closed = p->closed;
+    pthread_mutex_unlock(&p->lock);
+    return closed;
+}
+
+static void pipeClose(bytePipe_t* p)
+{
+    pthread_mutex_lock(&p->lock);
+    p->closed = 1;
+    pthread_cond_broadcast(&p->cond);
+    pthread_mutex_unlock(&p->lock);
+}
+
+static int pipeWrite(bytePipe_t* p, const void* data, int size)
+{
+    const uint8_t* src = (const uint8_t*)data;
+    pthread_mutex_lock(&p->lock);
+    while (size && !p->closed) {
+        while (p->count == LOOPBACK_PIPE_SIZE && !p->closed)
+            pthread_cond_wait(&p->cond, &p->lock);
+        int tail = (p->head + p->count) % LOOPBACK_PIPE_SIZE;
+        int chunk = LOOPBACK_PIPE_SIZE - p->count;
+        if (chunk > LOOPBACK_PIPE_SIZE - tail)
+            chunk = LOOPBACK_PIPE_SIZE - tail;
+        if (chunk > size)
+            chunk = size;
+        memcpy(p->data + tail, src, chunk);
+        p->count += chunk;
+        src += chunk;
+        size -= chunk;
+        pthread_cond_broadcast(&p->cond);
+    }
+    int rc = size ? -1 : 0;
+    pthread_mutex_unlock(&p->lock);
+    return rc;
+}
+
+static int pipeRead(bytePipe_t* p, void* data, int size)
+{
+    uint8_t* dst = (uint8_t*)data;
+    pthread_mutex_lock(&p->lock);
+    while (size) {
+        while (p->count == 0 && !p->closed)
+            pthread_cond_wait(&p->cond, &p->lock);
+        if (p->count == 0)
+            break;
+        int chunk = p->count;
+        if (chunk > LOOPBACK_PIPE_SIZE - p->head)
+            chunk = LOOPBACK_PIPE_SIZE - p->head;
+        if (chunk > size)
+            chunk = size;
+        memcpy(dst, p->data + p->head, chunk);
+        p->head = (p->head + chunk) % LOOPBACK_PIPE_SIZE;
+        p->count -= chunk;
+        dst += chunk;
+        size -= chunk;
+        pthread_cond_broadcast(&p->cond);
+    }
+    int rc = size ? -1 : 0;
+    pthread_mutex_unlock(&p->lock);
+    return rc;
+}
+
+// device side of the pipes
+static int deviceRead(void* channel, void* data, int size)
+{
+    return pipeRead(&((loopbackLink_t*)channel)->toDevice, data, size);
+}
+
+static int deviceWrite(void* channel, const void* data, int size)
+{
+    return pipeWrite(&((loopbackLink_t*)channel)->toHost, data, size);
+}
+
+static void deviceClose(void* channel)
+{
+    loopbackLink_t* link = (loopbackLink_t*)channel;
+    pipeClose(&link->toDevice);
+    pipeClose(&link->toHost);
+}
+
+void XLinkLoopbackSetDevice(const xLinkDeviceModel_t* model,
+                            const xLinkEmulatorConfig_t* config)
+{
+    pthread_mutex_lock(&deviceLock);
+    memset(&deviceModel, 0, sizeof(deviceModel));
+    if (model)
+        deviceModel = *model;
+    if (config)
+        deviceConfig = *config;
+    else
+        xLinkEmulatorConfigFromEnv(&deviceConfig);
+    deviceSet = 1;
+    pthread_mutex_unlock(&deviceLock);
+}
+
+static int loopbackInit(int loglevel)
+{
+    (void)loglevel;
+    pthread_mutex_lock(&deviceLock);
+    if (!deviceSet) {
+        xLinkEmulatorConfigFromEnv(&deviceConfig);
+        deviceSet = 1;
+    }
+    pthread_mutex_unlock(&deviceLock);
+    return USB_LINK_PLATFORM_SUCCESS;
+}
+
+static int loopbackGetDeviceName(int index, char* name, int nameSize)
+{
+    if (index != 0)
+        return USB_LINK_PLATFORM_DEVICE_NOT_FOUND;
+    strncpy(name, LOOPBACK_DEVICE_NAME, nameSize);
+    return USB_LINK_PLATFORM_SUCCESS;
+}
+
+static int loopbackBootRemote(const char* deviceName, const char* binaryPath)
+{
+    (void)binaryPath;
+    return strcmp(deviceName, LOOPBACK_DEVICE_NAME) == 0 ? 0 : -1;
+}
+
+static int loopbackConnect(const char* devPathRead, const char* devPathWrite, void** fd)
+{
+    (void)devPathRead;
+    if (!devPathWrite || strcmp(devPathWrite, LOOPBACK_DEVICE_NAME) != 0)
+        return -1;
+    pthread_mutex_lock(&deviceLock);
+    // one device, connected to one link at a time. A device reset by the host
+    // drops the link right after its response, like a device re-enumerating.
+    int wait;
+    for (wait = 0; activeLink && !pipeClosed(&activeLink->toHost) && wait < LOOPBACK_RESET_WAIT_MS; wait++)
+        usleep(1000);
+    if (activeLink && pipeClosed(&activeLink->toHost)) {
+        // the device was reset by the host, which keeps the fd of the link: free
+        // the emulator and the buffers only, the closed pipes fail any transfer
+        xLinkEmulatorStop(activeLink->emulator);
+        free(activeLink->toDevice.data);
+        free(activeLink->toHost.data);
+        activeLink->toDevice.data = NULL;
+        activeLink->toHost.data = NULL;
+        activeLink->toDevice.count = 0;
+        activeLink->toHost.count = 0;
+        activeLink = NULL;
+    }
+    if (activeLink) {
+        pthread_mutex_unlock(&deviceLock);
+        return -1;
+    }
+    loopbackLink_t* link = calloc(1, sizeof(*link));
+    if (!link || pipeInit(&link->toDevice)) {
+        free(link);
+        pthread_mutex_unlock(&deviceLock);
+        return -1;
+    }
+    if (pipeInit(&link->toHost)) {
+        pipeDestroy(&link->toDevice);
+        free(link);
+        pthread_mutex_unlock(&deviceLock);
+        return -1;
+    }
+    xLinkEmulatorChannel_t channel = { deviceRead, deviceWrite, deviceClose, link };
+    link->emulator = xLinkEmulatorStart(&channel, &deviceConfig, &deviceModel);
+    if (!link->emulator) {
+        pipeDestroy(&link->toDevice);
+        pipeDestroy(&link->toHost);
+        free(link);
+        pthread_mutex_unlock(&deviceLock);
+        return -1;
+    }
+    activeLink = link;
+    pthread_mutex_unlock(&deviceLock);
+    *fd = link;
+    return 0;
+}
+
+static int loopbackResetRemote(void* fd)
+{
+    loopbackLink_t* link = (loopbackLink_t*)fd;
+    pthread_mutex_lock(&deviceLock);
+    if (!link || link != activeLink) {
+        pthread_mutex_unlock(&deviceLock);
+        return -1;
+    }
+    activeLink = NULL;
+    pthread_mutex_unlock(&deviceLock);
+    xLinkEmulatorStop(link->emulator);
+    pipeDestroy(&link->toDevice);
+    pipeDestroy(&link->toHost);
+    free(link);
+    return -1;
+}
+
+static int loopbackWrite(void* fd, void* data, int size, unsigned int timeout)
+{
+    (void)timeout;
+    return pipeWrite(&((loopbackLink_t*)fd)->toDevice, data, size);
+}
+
+static int loopbackRead(void* fd, void* data, int size, unsigned int timeout)
+{
+    (void)timeout;
+    return pipeRead(&((loopbackLink_t*)fd)->toHost, data, size);
+}
+
+const xLinkTransport_t xLinkLoopbackTransport = {
+    "loopback",
+    loopbackInit,
+    loopbackGetDeviceName,
+    loopbackBootRemote,
+    loopbackConnect,
+    loopbackResetRemote,
+    loopbackWrite,
+    loopbackRead,
+    NULL
+};
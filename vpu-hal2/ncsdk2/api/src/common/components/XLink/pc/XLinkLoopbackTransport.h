@@ -0,0 +1,49 @@
+/*
+* Copyright 2017 Intel Corporation.
+* The source code, information and material ("Material") contained herein is
+* owned by Intel Corporation or its suppliers or licensors, and title to such
+* Material remains with Intel Corporation or its suppliers or licensors.
+* The Material contains proprietary information of Intel or its suppliers and
+* licensors. The Material is protected by worldwide copyright laws and treaty
+* provisions.
+* No part of the Material may be used, copied, reproduced, modified, published,
+* uploaded, posted, transmitted, distributed or disclosed in any way without
+* Intel's prior express written permission. No license under any patent,
+* copyright or other intellectual property rights in the Material is granted to
+* or conferred upon you, either expressly, by implication, inducement, estoppel
+* or otherwise.
+* Any license under such intellectual property rights must be express and
+* approved by Intel in writing.
+*/
+
+
+///
+/// @brief     In-process loopback transport of XLink
+///
+/// The device side of the link is an XLinkEmulator running in the same process,
+/// which hands the packets of the host to a device model set by the application.
+/// Selected with XLinkSetTransport(&xLinkLoopbackTransport) or XLINK_TRANSPORT=loopback.
+///
+#ifndef _XLINK_LOOPBACK_TRANSPORT_H
+#define _XLINK_LOOPBACK_TRANSPORT_H
+#include "XLinkTransport.h"
+#include "XLinkEmulator.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Device model and link characteristics of the next connection. Without a model the
+// device releases every packet it receives, without a configuration it is read from
+// the environment, see xLinkEmulatorConfigFromEnv.
+void XLinkLoopbackSetDevice(const xLinkDeviceModel_t* model,
+                            const xLinkEmulatorConfig_t* config);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/* end of include file */
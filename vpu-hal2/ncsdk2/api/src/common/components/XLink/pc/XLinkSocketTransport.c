@@ -0,0 +1,226 @@
+/*
+* Copyright 2017 Intel Corporation.
+* The source code, information and material ("Material") contained herein is
+* owned by Intel Corporation or its suppliers or licensors, and title to such
+* Material remains with Intel Corporation or its suppliers or licensors.
+* The Material contains proprietary information of Intel or its suppliers and
+* licensors. The Material is protected by worldwide copyright laws and treaty
+* provisions.
+* No part of the Material may be used, copied, reproduced, modified, published,
+* uploaded, posted, transmitted, distributed or disclosed in any way without
+* Intel's prior express written permission. No license under any patent,
+* copyright or other intellectual property rights in the Material is granted to
+* or conferred upon you, either expressly, by implication, inducement, estoppel
+* or otherwise.
+* Any license under such intellectual property rights must be express and
+* approved by Intel in writing.
+*/
+
+
+///
+/// @brief     UNIX socket transport of XLink
+///
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+
+#include "XLinkSocketTransport.h"
+#include "UsbLinkPlatform.h"
+
+#define SOCKET_DEVICE_PREFIX "socket-"
+#define SOCKET_PATH_SIZE sizeof(((struct sockaddr_un*)0)->sun_path)
+#define SOCKET_MAX_IOV 8
+
+typedef struct {
+    int sock;
+} socketLink_t;
+
+// Copies the index-th path of XLINK_SOCKET_PATH to path
+static int getSocketPath(int index, char* path, int pathSize)
+{
+    const char* list = getenv("XLINK_SOCKET_PATH");
+    if (!list || !*list)
+        list = XLINK_SOCKET_DEFAULT_PATH;
+    while (index--) {
+        list = strchr(list, ':');
+        if (!list)
+            return -1;
+        list++;
+    }
+    const char* end = strchr(list, ':');
+    int len = end ? (int)(end - list) : (int)strlen(list);
+    if (len == 0 || len >= pathSize)
+        return -1;
+    memcpy(path, list, len);
+    path[len] = '\0';
+    return 0;
+}
+
+static int isSocket(const char* path)
+{
+    struct stat st;
+    return stat(path, &st) == 0 && S_ISSOCK(st.st_mode);
+}
+
+static int socketInit(int loglevel)
+{
+    (void)loglevel;
+    return USB_LINK_PLATFORM_SUCCESS;
+}
+
+// Socket path of a device name
+static int getDevicePath(const char* name, char* path, int pathSize)
+{
+    int prefix = strlen(SOCKET_DEVICE_PREFIX);
+    if (!name || strncmp(name, SOCKET_DEVICE_PREFIX, prefix) != 0)
+        return -1;
+    return getSocketPath(atoi(name + prefix), path, pathSize);
+}
+
+static int socketGetDeviceName(int index, char* name, int nameSize)
+{
+    char path[SOCKET_PATH_SIZE];
+    int i, found = -1;
+    // the index counts the emulators which are running
+    for (i = 0; found < index && getSocketPath(i, path, sizeof(path)) == 0; i++) {
+        if (isSocket(path))
+            found++;
+    }
+    if (found < index)
+        return USB_LINK_PLATFORM_DEVICE_NOT_FOUND;
+    if (snprintf(name, nameSize, SOCKET_DEVICE_PREFIX "%d", i - 1) >= nameSize)
+        return USB_LINK_PLATFORM_ERROR;
+    return USB_LINK_PLATFORM_SUCCESS;
+}
+
+static int socketBootRemote(const char* deviceName, const char* binaryPath)
+{
+    // the emulator doesn't need firmware
+    (void)binaryPath;
+    char path[SOCKET_PATH_SIZE];
+    return getDevicePath(deviceName, path, sizeof(path)) == 0 && isSocket(path) ? 0 : -1;
+}
+
+static int socketConnect(const char* devPathRead, const char* devPathWrite, void** fd)
+{
+    (void)devPathRead;
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (getDevicePath(devPathWrite, addr.sun_path, sizeof(addr.sun_path)))
+        return -1;
+
+    socketLink_t* link = malloc(sizeof(*link));
+    if (!link)
+        return -1;
+    link->sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (link->sock < 0) {
+        free(link);
+        return -1;
+    }
+    if (connect(link->sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(link->sock);
+        free(link);
+        return -1;
+    }
+    *fd = link;
+    return 0;
+}
+
+static int socketResetRemote(void* fd)
+{
+    socketLink_t* link = (socketLink_t*)fd;
+    if (link) {
+        close(link->sock);
+        free(link);
+    }
+    return -1;
+}
+
+static int socketWrite(void* fd, void* data, int size, unsigned int timeout)
+{
+    (void)timeout;
+    socketLink_t* link = (socketLink_t*)fd;
+    const char* src = (const char*)data;
+    while (size > 0) {
+        ssize_t rc = send(link->sock, src, size, MSG_NOSIGNAL);
+        if (rc < 0 && errno == EINTR)
+            continue;
+        if (rc <= 0)
+            return -1;
+        src += rc;
+        size -= rc;
+    }
+    return 0;
+}
+
+static int socketWritev(void* fd, const xLinkIoVec_t* iov, int iovcnt, unsigned int timeout)
+{
+    (void)timeout;
+    socketLink_t* link = (socketLink_t*)fd;
+    struct iovec vec[SOCKET_MAX_IOV];
+    if (iovcnt > SOCKET_MAX_IOV)
+        return -1;
+    for (int i = 0; i < iovcnt; i++) {
+        vec[i].iov_base = iov[i].data;
+        vec[i].iov_len = iov[i].size;
+    }
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = vec;
+    msg.msg_iovlen = iovcnt;
+    while (msg.msg_iovlen) {
+        ssize_t rc = sendmsg(link->sock, &msg, MSG_NOSIGNAL);
+        if (rc < 0 && errno == EINTR)
+            continue;
+        if (rc <= 0)
+            return -1;
+        // skip what has been sent
+        while (msg.msg_iovlen && (size_t)rc >= msg.msg_iov->iov_len) {
+            rc -= msg.msg_iov->iov_len;
+            msg.msg_iov++;
+            msg.msg_iovlen--;
+        }
+        if (msg.msg_iovlen) {
+            msg.msg_iov->iov_base = (char*)msg.msg_iov->iov_base + rc;
+            msg.msg_iov->iov_len -= rc;
+        }
+    }
+    return 0;
+}
+
+static int socketRead(void* fd, void* data, int size, unsigned int timeout)
+{
+    (void)timeout;
+    socketLink_t* link = (socketLink_t*)fd;
+    char* dst = (char*)data;
+    while (size > 0) {
+        ssize_t rc = recv(link->sock, dst, size, 0);
+        if (rc < 0 && errno == EINTR)
+            continue;
+        if (rc <= 0)
+            return -1;
+        dst += rc;
+        size -= rc;
+    }
+    return 0;
+}
+
+const xLinkTransport_t xLinkSocketTransport = {
+    "socket",
+    socketInit,
+    socketGetDeviceName,
+    socketBootRemote,
+    socketConnect,
+    socketResetRemote,
+    socketWrite,
+    socketRead,
+    socketWritev
+};
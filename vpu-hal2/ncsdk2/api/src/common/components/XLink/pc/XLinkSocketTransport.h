@@ -0,0 +1,37 @@
+/*
+* Copyright 2017 Intel Corporation.
+* The source code, information and material ("Material") contained herein is
+* owned by Intel Corporation or its suppliers or licensors, and title to such
+* Material remains with Intel Corporation or its suppliers or licensors.
+* The Material contains proprietary information of Intel or its suppliers and
+* licensors. The Material is protected by worldwide copyright laws and treaty
+* provisions.
+* No part of the Material may be used, copied, reproduced, modified, published,
+* uploaded, posted, transmitted, distributed or disclosed in any way without
+* Intel's prior express written permission. No license under any patent,
+* copyright or other intellectual property rights in the Material is granted to
+* or conferred upon you, either expressly, by implication, inducement, estoppel
+* or otherwise.
+* Any license under such intellectual property rights must be express and
+* approved by Intel in writing.
+*/
+
+
+///
+/// @brief     UNIX socket transport of XLink
+///
+/// Connects to device emulator processes, see ncs-test-apps/xlink_emulator.
+/// Selected with XLinkSetTransport(&xLinkSocketTransport) or XLINK_TRANSPORT=socket.
+/// The devices are the sockets listed in XLINK_SOCKET_PATH, separated by ':',
+/// /tmp/xlink_emulator.sock by default. The device of the n-th path is named socket-<n>,
+/// the ones without a listening emulator are skipped by XLinkGetDeviceName.
+///
+#ifndef _XLINK_SOCKET_TRANSPORT_H
+#define _XLINK_SOCKET_TRANSPORT_H
+#include "XLinkTransport.h"
+
+#define XLINK_SOCKET_DEFAULT_PATH "/tmp/xlink_emulator.sock"
+
+#endif
+
+/* end of include file */
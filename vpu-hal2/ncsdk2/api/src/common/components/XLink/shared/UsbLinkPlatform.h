@@ -22,6 +22,7 @@
 #ifndef _XLINK_USBLINKPLATFORM_H
 #define _XLINK_USBLINKPLATFORM_H
 #include <stdint.h>
+#include "XLinkTransport.h"
 #ifdef __cplusplus
 extern "C"
 {
@@ -40,6 +41,7 @@ The USB specific implementation is contained in the file called UsbLinkPlatform.
 It implements the following functions:
 */
 int USBLinkWrite(void* fd, void* data, int size, unsigned int timeout);
+int USBLinkWritev(void* fd, const xLinkIoVec_t* iov, int iovcnt, unsigned int timeout);
 int USBLinkRead(void* fd, void* data, int size, unsigned int timeout);
 int UsbLinkPlatformConnect(const char* devPathRead,
                            const char* devPathWrite, void** fd);
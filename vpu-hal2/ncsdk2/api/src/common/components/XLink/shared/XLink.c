@@ -37,6 +37,7 @@
 #include <semaphore.h>
 #include "mvMacros.h"
 #include "UsbLinkPlatform.h"
+#include "XLinkTransport.h"
 #include "XLinkDispatcher.h"
 #define _USBLINK_ENABLE_PRIVATE_INCLUDE_
 #include "XLinkPrivateDefines.h"
@@ -75,11 +76,15 @@ int dispatcherEventSend(xLinkEvent_t* event);
 streamDesc_t* getStreamById(void* fd, streamId_t id);
 void releaseStream(streamDesc_t*);
 int addNewPacketToStream(streamDesc_t* stream, void* buffer, uint32_t size);
+static void waitAsyncWrites(void* fd, streamId_t streamId);
 
 struct dispatcherControlFunctions controlFunctionTbl;
 XLinkGlobalHandler_t* glHandler; //TODO EMAN need to either protect this with semaphor
                                  //or make profiling data per device
 linkId_t nextUniqueLinkId = 0; //incremental number, doesn't get decremented.
+//asynchronous write state of all streams, the dispatcher completes the writes
+static pthread_mutex_t asyncWriteLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t asyncWriteCond = PTHREAD_COND_INITIALIZER;
 //streams
 typedef struct xLinkDesc_t {
     int nextUniqueStreamId; //incremental number, doesn't get decremented.
@@ -94,6 +99,24 @@ xLinkDesc_t availableXLinks[MAX_LINKS];
 
 sem_t  pingSem; //to b used by myriad
 
+const xLinkTransport_t xLinkUsbTransport = {
+    "usb",
+    UsbLinkPlatformInit,
+    UsbLinkPlatformGetDeviceName,
+    UsbLinkPlatformBootRemote,
+    UsbLinkPlatformConnect,
+    USBLinkPlatformResetRemote,
+    USBLinkWrite,
+    USBLinkRead,
+#ifdef __PC__
+    USBLinkWritev
+#else
+    NULL
+#endif
+};
+//transport of all links, selected by the first XLink call which needs it
+static const xLinkTransport_t* transport;
+
 
 /*#################################################################################
 ###################################### INTERNAL ###################################
@@ -112,6 +135,42 @@ static float timespec_diff(struct timespec *start, struct timespec *stop)
     return start->tv_nsec/ 1000000000.0 + start->tv_sec;
 }
 
+static void profileTransfer(XLinkTransferProf_t* prof, uint32_t size, struct timespec* start)
+{
+    struct timespec end;
+    clock_gettime(CLOCK_REALTIME, &end);
+    float time = timespec_diff(start, &end);
+    prof->count++;
+    prof->bytes += size;
+    prof->totalTime += time;
+    if (time > prof->maxTime)
+        prof->maxTime = time;
+    int bucket = 0;
+    for (float us = time * 1000000; us >= 2 && bucket < XLINK_PROF_LATENCY_BUCKETS - 1; us /= 2)
+        bucket++;
+    prof->latencyHist[bucket]++;
+}
+
+static const xLinkTransport_t* getTransport()
+{
+    if (transport)
+        return transport;
+    transport = &xLinkUsbTransport;
+#ifdef __PC__
+    const char* name = getenv("XLINK_TRANSPORT");
+    if (name) {
+        if (strcmp(name, xLinkLoopbackTransport.name) == 0)
+            transport = &xLinkLoopbackTransport;
+        else if (strcmp(name, xLinkSocketTransport.name) == 0)
+            transport = &xLinkSocketTransport;
+        else if (strcmp(name, xLinkUsbTransport.name) != 0)
+            mvLog(MVLOG_WARN,"Unknown XLink transport %s, using usb\n", name);
+    }
+#endif
+    mvLog(MVLOG_DEBUG,"XLink transport %s\n", transport->name);
+    return transport;
+}
+
 int handleIncomingEvent(xLinkEvent_t* event){
     //this function will be dependent whether this is a client or a Remote
     //specific actions to this peer
@@ -133,10 +192,16 @@ int handleIncomingEvent(xLinkEvent_t* event){
             mvLog(MVLOG_FATAL,"out of memory\n");
             ASSERT_X_LINK(0);
         }
-        int sc = USBLinkRead(event->xLinkFD, buffer, event->header.size, USB_DATA_TIMEOUT);
+        struct timespec start;
+        clock_gettime(CLOCK_REALTIME, &start);
+        int sc = transport->read(event->xLinkFD, buffer, event->header.size, USB_DATA_TIMEOUT);
         if(sc < 0){
             mvLog(MVLOG_ERROR,"%s() Read failed %d\n", __func__, (int)sc);
         }
+        else if (glHandler->profEnable)
+        {
+            profileTransfer(&glHandler->profilingData.readTransfers, event->header.size, &start);
+        }
 
         event->data = buffer;
         if (addNewPacketToStream(stream, buffer, event->header.size)){
@@ -183,7 +248,7 @@ int handleIncomingEvent(xLinkEvent_t* event){
 }
  int dispatcherEventReceive(xLinkEvent_t* event){
     static xLinkEvent_t prevEvent;
-    int sc = USBLinkRead(event->xLinkFD, &event->header, sizeof(event->header), 0);
+    int sc = transport->read(event->xLinkFD, &event->header, sizeof(event->header), 0);
 
     if(sc < 0 && event->header.type == USB_RESET_RESP) {
         return sc;
@@ -431,6 +496,13 @@ streamId_t allocateNewStream(void* fd,
 
         stream->localFillLevel = 0;
         stream->closeStreamInitiated = 0;
+        stream->blockedWrites = 0;
+        stream->asyncWritesQueued = 0;
+        stream->asyncWritesDone = 0;
+        stream->asyncBytesInFlight = 0;
+        memset(stream->asyncWrites, 0, sizeof(stream->asyncWrites));
+        memset(stream->asyncWriteFailures, 0, sizeof(stream->asyncWriteFailures));
+        stream->asyncWriteFailureCount = 0;
         if (!sem_initiated) //if sem_init is called for already initiated sem, behavior is undefined
             sem_init(&stream->sem, 0, 0);
     }
@@ -456,6 +528,10 @@ int dispatcherLocalEventGetResponse(xLinkEvent_t* event, xLinkEvent_t* response)
         //in case local tries to write after it issues close (writeSize is zero)
         stream = getStreamById(event->xLinkFD, event->header.streamId);
         ASSERT_X_LINK(stream);
+        //the write comes back from the blocked ones, which are unblocked oldest first
+        int wasBlocked = event->header.flags.bitField.block;
+        if (wasBlocked)
+            stream->blockedWrites--;
         if (stream->writeSize == 0)
         {
             event->header.flags.bitField.nack = 1;
@@ -468,10 +544,13 @@ int dispatcherLocalEventGetResponse(xLinkEvent_t* event, xLinkEvent_t* response)
         event->header.flags.bitField.nack = 0;
         event->header.flags.bitField.localServe = 0;
 
-        if(!isStreamSpaceEnoughFor(stream, ALIGN_UP(event->header.size, __CACHE_LINE_SIZE))){
+        //don't overtake older writes waiting for space, asynchronous writes rely on the order
+        if((!wasBlocked && stream->blockedWrites) ||
+           !isStreamSpaceEnoughFor(stream, ALIGN_UP(event->header.size, __CACHE_LINE_SIZE))){
             mvLog(MVLOG_DEBUG,"local NACK RTS. stream is full\n");
             event->header.flags.bitField.block = 1;
             event->header.flags.bitField.localServe = 1;
+            stream->blockedWrites++;
             // TODO: easy to implement non-blocking read here, just return nack
         }else{
             event->header.flags.bitField.block = 0;
@@ -479,6 +558,9 @@ int dispatcherLocalEventGetResponse(xLinkEvent_t* event, xLinkEvent_t* response)
             stream->remoteFillPacketLevel++;
 
             mvLog(MVLOG_DEBUG,"Got local write remote fill level %ld out of %ld %ld\n", stream->remoteFillLevel, stream->writeSize, stream->readSize);
+            //the next one may fit as well
+            if (stream->blockedWrites)
+                dispatcherUnblockEvent(-1, USB_WRITE_REQ, event->header.streamId, event->xLinkFD);
         }
         releaseStream(stream);
         break;
@@ -713,7 +795,28 @@ int dispatcherRemoteEventGetResponse(xLinkEvent_t* event, xLinkEvent_t* response
 int dispatcherEventSend(xLinkEvent_t *event)
 {
     mvLog(MVLOG_DEBUG,"sending %d %d\n", (int)event->header.type,  (int)event->header.id);
-    int rc = USBLinkWrite(event->xLinkFD, &event->header, sizeof(event->header), 0);
+    struct timespec start;
+    clock_gettime(CLOCK_REALTIME, &start);
+    if (event->header.type == USB_WRITE_REQ && transport->writev)
+    {
+        //header and requested data in one go, the data is not copied behind the header
+        xLinkIoVec_t iov[2];
+        iov[0].data = &event->header;
+        iov[0].size = sizeof(event->header);
+        iov[1].data = event->data;
+        iov[1].size = event->header.size;
+        int rc = transport->writev(event->xLinkFD, iov, 2, USB_DATA_TIMEOUT);
+        if(rc < 0) {
+            mvLog(MVLOG_ERROR,"Write failed %d\n", rc);
+        }
+        else if (glHandler->profEnable)
+        {
+            profileTransfer(&glHandler->profilingData.writeTransfers,
+                            sizeof(event->header) + event->header.size, &start);
+        }
+        return 0;
+    }
+    int rc = transport->write(event->xLinkFD, &event->header, sizeof(event->header), 0);
     if(rc < 0)
     {
         mvLog(MVLOG_ERROR,"Write failed %d\n", rc);
@@ -721,11 +824,16 @@ int dispatcherEventSend(xLinkEvent_t *event)
     if (event->header.type == USB_WRITE_REQ)
     {
         //write requested data
-        rc = USBLinkWrite(event->xLinkFD, event->data,
-                          event->header.size, USB_DATA_TIMEOUT);
+        rc = transport->write(event->xLinkFD, event->data,
+                             event->header.size, USB_DATA_TIMEOUT);
         if(rc < 0) {
             mvLog(MVLOG_ERROR,"Write failed %d\n", rc);
         }
+        else if (glHandler->profEnable)
+        {
+            profileTransfer(&glHandler->profilingData.writeTransfers,
+                            sizeof(event->header) + event->header.size, &start);
+        }
     }
     // this function will send events to the remote node
     return 0;
@@ -754,7 +862,7 @@ void dispatcherCloseUsbLink(void*fd)
 
 void dispatcherResetDevice(void* fd)
 {
-    USBLinkPlatformResetRemote(fd);//TODO EMAN
+    transport->resetRemote(fd);//TODO EMAN
 }
 
 
@@ -770,7 +878,7 @@ XLinkError_t XLinkConnect(XLinkHandler_t* handler)
     xLinkDesc_t* link = &availableXLinks[index];
     mvLog(MVLOG_DEBUG,"%s() device name %s \n", __func__, handler->devicePath);
 
-    if (UsbLinkPlatformConnect(handler->devicePath2, handler->devicePath, &link->fd) == -1)
+    if (getTransport()->connect(handler->devicePath2, handler->devicePath, &link->fd) == -1)
     {
         return X_LINK_ERROR;
     }
@@ -790,13 +898,21 @@ XLinkError_t XLinkConnect(XLinkHandler_t* handler)
     return 0;
 }
 
+XLinkError_t XLinkSetTransport(const xLinkTransport_t* linkTransport)
+{
+    if (!linkTransport)
+        return X_LINK_ERROR;
+    transport = linkTransport;
+    return X_LINK_SUCCESS;
+}
+
 XLinkError_t XLinkInitialize(XLinkGlobalHandler_t* handler)
 {
     ASSERT_X_LINK(USB_LINK_MAX_STREAMS <= MAX_POOLS_ALLOC);
     glHandler = handler;
     sem_init(&pingSem,0,0);
     int i;
-    int sc = UsbLinkPlatformInit(handler->loglevel);
+    int sc = getTransport()->init(handler->loglevel);
     if (sc)
     {
        return X_LINK_COMMUNICATION_NOT_OPEN;
@@ -917,6 +1033,8 @@ XLinkError_t XLinkCloseStream(streamId_t streamId)
     if (getXLinkState(link) != USB_LINK_UP)
         return X_LINK_COMMUNICATION_NOT_OPEN;
 
+    waitAsyncWrites(link->fd, streamId);
+
     xLinkEvent_t event = {0};
     event.header.type = USB_CLOSE_STREAM_REQ;
     event.header.streamId = streamId;
@@ -947,7 +1065,7 @@ XLinkError_t XLinkGetAvailableStreams(linkId_t id)
 
 XLinkError_t XLinkGetDeviceName(int index, char* name, int nameSize)
 {
-    int rc = UsbLinkPlatformGetDeviceName(index, name, nameSize);
+    int rc = getTransport()->getDeviceName(index, name, nameSize);
     switch(rc) {
         case USB_LINK_PLATFORM_SUCCESS:
             return X_LINK_SUCCESS;
@@ -1001,15 +1119,161 @@ XLinkError_t XLinkWriteData(streamId_t streamId, const uint8_t* buffer,
         return X_LINK_COMMUNICATION_FAIL;
 }
 
-XLinkError_t XLinkAsyncWriteData()
+static void asyncWriteComplete(xLinkEvent_t* event, void* ctx)
+{
+    xLinkAsyncWrite_t* write = (xLinkAsyncWrite_t*)ctx;
+    streamDesc_t* stream = write->stream;
+    XLinkError_t status = event->header.flags.bitField.ack == 1 ?
+                          X_LINK_SUCCESS : X_LINK_COMMUNICATION_FAIL;
+
+    pthread_mutex_lock(&asyncWriteLock);
+    write->status = status;
+    write->done = 1;
+    stream->asyncBytesInFlight -= write->size;
+    while (stream->asyncWritesDone != stream->asyncWritesQueued &&
+           stream->asyncWrites[(stream->asyncWritesDone + 1) % XLINK_MAX_ASYNC_WRITES].done)
+        stream->asyncWritesDone++;
+    //the slot may be reused as soon as the lock is released
+    XLinkWriteCallback_t callback = write->callback;
+    void* userData = write->userData;
+    streamId_t streamId = write->streamId;
+    XLinkWriteToken_t token = write->token;
+    uint32_t size = write->size;
+    pthread_cond_broadcast(&asyncWriteCond);
+    pthread_mutex_unlock(&asyncWriteLock);
+
+    if (status == X_LINK_SUCCESS && glHandler->profEnable)
+        glHandler->profilingData.totalWriteBytes += size;
+    if (callback)
+        callback(streamId, token, status, userData);
+}
+
+//called with asyncWriteLock taken
+static XLinkError_t asyncWriteStatus(streamDesc_t* stream, XLinkWriteToken_t token, int wait)
 {
-    if (getXLinkState(NULL) != USB_LINK_UP)
+    if (token == 0 || token > stream->asyncWritesQueued)
+        return X_LINK_ERROR;
+    xLinkAsyncWrite_t* write = &stream->asyncWrites[token % XLINK_MAX_ASYNC_WRITES];
+    while (wait && write->token == token && !write->done)
+        pthread_cond_wait(&asyncWriteCond, &asyncWriteLock);
+    if (write->token != token) {
+        //completed and reused by a later write, only the failures are remembered
+        for (int i = 0; i < XLINK_MAX_ASYNC_WRITES; i++) {
+            if (stream->asyncWriteFailures[i] == token)
+                return X_LINK_COMMUNICATION_FAIL;
+        }
+        return X_LINK_SUCCESS;
+    }
+    return write->done ? write->status : X_LINK_TIMEOUT;
+}
+
+static streamDesc_t* getAsyncWriteStream(streamId_t streamId)
+{
+    linkId_t id;
+    EXTRACT_IDS(streamId,id);
+    xLinkDesc_t* link = getLinkById(id);
+    ASSERT_X_LINK(link != NULL);
+    streamDesc_t* stream = getStreamById(link->fd, streamId);
+    if (stream)
+        releaseStream(stream); //the async write fields use asyncWriteLock
+    return stream;
+}
+
+static void waitAsyncWrites(void* fd, streamId_t streamId)
+{
+    streamDesc_t* stream = getStreamById(fd, streamId);
+    if (!stream)
+        return;
+    releaseStream(stream);
+    pthread_mutex_lock(&asyncWriteLock);
+    while (stream->asyncWritesDone != stream->asyncWritesQueued)
+        pthread_cond_wait(&asyncWriteCond, &asyncWriteLock);
+    pthread_mutex_unlock(&asyncWriteLock);
+}
+
+XLinkError_t XLinkAsyncWriteData(streamId_t streamId, const uint8_t* buffer, int size,
+                                 XLinkWriteCallback_t callback, void* userData,
+                                 XLinkWriteToken_t* token)
+{
+    streamId_t userStreamId = streamId;
+    linkId_t id;
+    EXTRACT_IDS(streamId,id);
+    xLinkDesc_t* link = getLinkById(id);
+    ASSERT_X_LINK(link != NULL);
+    if (getXLinkState(link) != USB_LINK_UP)
     {
         return X_LINK_COMMUNICATION_NOT_OPEN;
     }
+    streamDesc_t* stream = getAsyncWriteStream(userStreamId);
+    if (!stream)
+        return X_LINK_ERROR;
+
+    pthread_mutex_lock(&asyncWriteLock);
+    //a write bigger than the stream still goes alone, it waits for remote space like XLinkWriteData
+    while (stream->asyncWritesQueued - stream->asyncWritesDone >= XLINK_MAX_ASYNC_WRITES ||
+           (stream->asyncBytesInFlight &&
+            stream->asyncBytesInFlight + (uint32_t)size > stream->writeSize))
+        pthread_cond_wait(&asyncWriteCond, &asyncWriteLock);
+
+    XLinkWriteToken_t t = stream->asyncWritesQueued + 1;
+    xLinkAsyncWrite_t* write = &stream->asyncWrites[t % XLINK_MAX_ASYNC_WRITES];
+    if (write->token && write->status != X_LINK_SUCCESS) {
+        stream->asyncWriteFailures[stream->asyncWriteFailureCount % XLINK_MAX_ASYNC_WRITES] = write->token;
+        stream->asyncWriteFailureCount++;
+    }
+    write->stream = stream;
+    write->streamId = userStreamId;
+    write->token = t;
+    write->size = size;
+    write->callback = callback;
+    write->userData = userData;
+    write->status = X_LINK_TIMEOUT;
+    write->done = 0;
+
+    xLinkEvent_t event = {0};
+    event.header.type = USB_WRITE_REQ;
+    event.header.size = size;
+    event.header.streamId = streamId;
+    event.xLinkFD = link->fd;
+    event.data = (void*)buffer;
+
+    //queued under the lock, so that the dispatcher gets the writes of a stream in token order
+    if (!dispatcherAddEventAsync(&event, asyncWriteComplete, write)) {
+        write->token = 0;
+        pthread_mutex_unlock(&asyncWriteLock);
+        return X_LINK_ERROR;
+    }
+    stream->asyncWritesQueued = t;
+    stream->asyncBytesInFlight += size;
+    pthread_mutex_unlock(&asyncWriteLock);
+
+    if (token)
+        *token = t;
     return X_LINK_SUCCESS;
 }
 
+XLinkError_t XLinkPollWrite(streamId_t streamId, XLinkWriteToken_t token)
+{
+    streamDesc_t* stream = getAsyncWriteStream(streamId);
+    if (!stream)
+        return X_LINK_ERROR;
+    pthread_mutex_lock(&asyncWriteLock);
+    XLinkError_t rc = asyncWriteStatus(stream, token, 0);
+    pthread_mutex_unlock(&asyncWriteLock);
+    return rc;
+}
+
+XLinkError_t XLinkWaitWrite(streamId_t streamId, XLinkWriteToken_t token)
+{
+    streamDesc_t* stream = getAsyncWriteStream(streamId);
+    if (!stream)
+        return X_LINK_ERROR;
+    pthread_mutex_lock(&asyncWriteLock);
+    XLinkError_t rc = asyncWriteStatus(stream, token, 1);
+    pthread_mutex_unlock(&asyncWriteLock);
+    return rc;
+}
+
 XLinkError_t XLinkReadData(streamId_t streamId, streamPacketDesc_t** packet)
 {
     linkId_t id;
@@ -1074,7 +1338,7 @@ XLinkError_t XLinkReleaseData(streamId_t streamId)
 
 XLinkError_t XLinkBootRemote(const char* deviceName, const char* binaryPath)
 {
-    if (UsbLinkPlatformBootRemote(deviceName, binaryPath) == 0)
+    if (getTransport()->bootRemote(deviceName, binaryPath) == 0)
         return X_LINK_SUCCESS;
     else
         return X_LINK_COMMUNICATION_FAIL;
@@ -1086,7 +1350,7 @@ XLinkError_t XLinkResetRemote(linkId_t id)
     ASSERT_X_LINK(link != NULL);
     if (getXLinkState(link) != USB_LINK_UP)
     {
-        USBLinkPlatformResetRemote(link->fd);
+        getTransport()->resetRemote(link->fd);
         return X_LINK_COMMUNICATION_NOT_OPEN;
     }
     xLinkEvent_t event = {0};
@@ -1130,6 +1394,8 @@ XLinkError_t XLinkProfStart()
     glHandler->profilingData.totalReadTime = 0;
     glHandler->profilingData.totalBootCount = 0;
     glHandler->profilingData.totalBootTime = 0;
+    memset(&glHandler->profilingData.writeTransfers, 0, sizeof(XLinkTransferProf_t));
+    memset(&glHandler->profilingData.readTransfers, 0, sizeof(XLinkTransferProf_t));
 
     return X_LINK_SUCCESS;
 }
@@ -1140,6 +1406,33 @@ XLinkError_t XLinkProfStop()
     return X_LINK_SUCCESS;
 }
 
+//upper bound of the latency of fraction p of the transfers, no transfer took longer than maxTime
+static float transferLatencyPercentile(const XLinkTransferProf_t* prof, float p)
+{
+    unsigned long count = 0;
+    int i;
+    for (i = 0; i < XLINK_PROF_LATENCY_BUCKETS - 1; i++) {
+        count += prof->latencyHist[i];
+        if (count >= p * prof->count)
+            break;
+    }
+    float bound = (2 << i) / 1000000.0;
+    return bound < prof->maxTime ? bound : prof->maxTime;
+}
+
+static void printTransferProf(const char* name, const XLinkTransferProf_t* prof)
+{
+    if (!prof->count || !prof->totalTime)
+        return;
+    printf("%s transfers: %lu, %f MB/Sec while transferring, latency avg %f ms, p50 <= %f ms, p99 <= %f ms, max %f ms\n",
+           name, prof->count,
+           prof->bytes / prof->totalTime / 1024.0 / 1024.0,
+           prof->totalTime / prof->count * 1000,
+           transferLatencyPercentile(prof, 0.5) * 1000,
+           transferLatencyPercentile(prof, 0.99) * 1000,
+           prof->maxTime * 1000);
+}
+
 XLinkError_t XLinkProfPrint()
 {
     printf("XLink profiling results:\n");
@@ -1165,6 +1458,8 @@ XLinkError_t XLinkProfPrint()
                glHandler->profilingData.totalBootTime /
                glHandler->profilingData.totalBootCount);
     }
+    printTransferProf("Write", &glHandler->profilingData.writeTransfers);
+    printTransferProf("Read", &glHandler->profilingData.readTransfers);
     return X_LINK_SUCCESS;
 }
 /* end of file */
@@ -32,6 +32,13 @@ extern "C"
 {
 #endif
 
+struct xLinkTransport_t;
+
+// Selects the transport of the links, to be called before any other XLink function.
+// Without it the XLINK_TRANSPORT environment variable selects one on pc:
+// usb (the default), loopback or socket, see XLinkTransport.h
+XLinkError_t XLinkSetTransport(const struct xLinkTransport_t* transport);
+
 // Initializes XLink and scheduler, on myriad it starts the dispatcher
 XLinkError_t XLinkInitialize(XLinkGlobalHandler_t* handler);
 
@@ -56,8 +63,24 @@ XLinkError_t XLinkGetDeviceName(int index, char* name, int nameSize);
 // Note that the actual size of the written data is ALIGN_UP(size, 64)
 XLinkError_t XLinkWriteData(streamId_t streamId, const uint8_t* buffer, int size);
 
-// Currently useless
-XLinkError_t XLinkAsyncWriteData();
+// Queues a write and returns without waiting for the transfer. The buffer must stay
+// valid until the write completes, which is reported to the optional callback and
+// through the returned token. Writes on a stream are sent and completed in order, and
+// are sent before any request queued on the link after them unless they have to wait
+// for space in the remote stream. Blocks while the stream has XLINK_MAX_ASYNC_WRITES
+// writes or its write size in bytes in flight.
+XLinkError_t XLinkAsyncWriteData(streamId_t streamId, const uint8_t* buffer, int size,
+                                 XLinkWriteCallback_t callback, void* userData,
+                                 XLinkWriteToken_t* token);
+
+// Status of an asynchronous write, X_LINK_TIMEOUT while it is in flight.
+// Once XLINK_MAX_ASYNC_WRITES more writes are queued on the stream, only the last
+// XLINK_MAX_ASYNC_WRITES failures are remembered, the other old tokens report X_LINK_SUCCESS.
+// Tokens never handed out report X_LINK_ERROR.
+XLinkError_t XLinkPollWrite(streamId_t streamId, XLinkWriteToken_t token);
+
+// Waits for an asynchronous write and returns its status
+XLinkError_t XLinkWaitWrite(streamId_t streamId, XLinkWriteToken_t token);
 
 // Read data from local stream. Will only have something if it was written
 // to by the remote
@@ -45,6 +45,7 @@ typedef enum {
     EVENT_BLOCKED,
     EVENT_READY,
     EVENT_SERVED,
+    EVENT_ALLOCATED,
 } xLinkEventState_t;
 
 typedef struct xLinkEventPriv_t {
@@ -52,24 +53,31 @@ typedef struct xLinkEventPriv_t {
     xLinkEventState_t isServed;
     xLinkEventOrigin_t origin;
     sem_t* sem;
-    void* data;
-    uint32_t pad;
+    eventCompleteFunction complete; // asynchronous local events, called instead of posting sem
+    void* data;                     // context of complete
+    struct xLinkEventPriv_t* next; // link in the list of the current state
 } xLinkEventPriv_t;
 
+// FIFO of events. An event is in at most one list at a time, so all lists share the link field.
+typedef struct {
+    xLinkEventPriv_t* head;
+    xLinkEventPriv_t* tail;
+} eventList_t;
+
 typedef struct {
     sem_t sem;
     pthread_t threadId;
 } localSem_t;
 
 typedef struct{
-    xLinkEventPriv_t* end;
-    xLinkEventPriv_t* base;
-
-    xLinkEventPriv_t* curProc;
-    xLinkEventPriv_t* cur;
+    eventList_t free;   // EVENT_SERVED, reused oldest first
+    eventList_t toProc; // EVENT_ALLOCATED, waiting for the dispatcher in arrival order
     __attribute__((aligned(8))) xLinkEventPriv_t q[MAX_EVENTS];
 
 }eventQueueHandler_t;
+
+#define EVENT_BUCKETS   MAX_EVENTS
+#define STREAM_BUCKETS  USB_LINK_MAX_STREAMS
 typedef struct {
     void* xLinkFD; //will be device handler
     int schedulerId;
@@ -82,23 +90,64 @@ typedef struct {
 
     eventQueueHandler_t lQueue; //local queue
     eventQueueHandler_t rQueue; //remote queue
+    // Local requests the dispatcher has already handled once. Only the dispatcher thread
+    // touches these lists, the free and toProc lists of the queues are guarded by addEventSem.
+    eventList_t readyEvents;                   // EVENT_READY, in unblock order
+    eventList_t blockedEvents[STREAM_BUCKETS]; // EVENT_BLOCKED, hashed by stream id
+    eventList_t pendingEvents[EVENT_BUCKETS];  // EVENT_PENDING, hashed by event id
     localSem_t eventSemaphores[MAXIMUM_SEMAPHORES];
 } xLinkSchedulerState_t;
 
+static void eventListPush(eventList_t* list, xLinkEventPriv_t* event)
+{
+    event->next = NULL;
+    if (list->tail)
+        list->tail->next = event;
+    else
+        list->head = event;
+    list->tail = event;
+}
+
+static void eventListPushFront(eventList_t* list, xLinkEventPriv_t* event)
+{
+    event->next = list->head;
+    list->head = event;
+    if (!list->tail)
+        list->tail = event;
+}
+
+static xLinkEventPriv_t* eventListPop(eventList_t* list)
+{
+    xLinkEventPriv_t* event = list->head;
+    if (event) {
+        list->head = event->next;
+        if (!list->head)
+            list->tail = NULL;
+    }
+    return event;
+}
+
+//prev is the element before event in the list, NULL for the head
+static void eventListUnlink(eventList_t* list, xLinkEventPriv_t* prev, xLinkEventPriv_t* event)
+{
+    if (prev)
+        prev->next = event->next;
+    else
+        list->head = event->next;
+    if (list->tail == event)
+        list->tail = prev;
+}
 
-#define CIRCULAR_INCREMENT(x, maxVal, base) \
-    { \
-        x++; \
-        if (x == maxVal) \
-            x = base; \
+static void eventQueueInit(eventQueueHandler_t* q)
+{
+    int eventIdx;
+    q->free.head = q->free.tail = NULL;
+    q->toProc.head = q->toProc.tail = NULL;
+    for (eventIdx = 0 ; eventIdx < MAX_EVENTS; eventIdx++)
+    {
+        q->q[eventIdx].isServed = EVENT_SERVED;
+        eventListPush(&q->free, &q->q[eventIdx]);
     }
-//avoid problems with unsigned. first compare and then give the nuw value
-#define CIRCULAR_DECREMENT(x, maxVal, base) \
-{ \
-    if (x == base) \
-        x = maxVal - 1; \
-    else \
-        x--; \
 }
 
 char* TypeToStr(int type)
@@ -199,24 +248,71 @@ static int isEventTypeRequest(xLinkEventPriv_t* event)
         return 0;
 }
 
-static void markEventBlocked(xLinkEventPriv_t* event)
+static eventList_t* getBlockedList(xLinkSchedulerState_t* curr, streamId_t stream)
+{
+    return &curr->blockedEvents[stream % STREAM_BUCKETS];
+}
+
+static eventList_t* getPendingList(xLinkSchedulerState_t* curr, eventId_t id)
+{
+    return &curr->pendingEvents[(uint32_t)id % EVENT_BUCKETS];
+}
+
+//gives the slot back to dispatcherAddEvent
+static void releaseEvent(xLinkEventPriv_t* event, xLinkSchedulerState_t* curr)
+{
+    eventQueueHandler_t* q = event->origin == EVENT_LOCAL ? &curr->lQueue : &curr->rQueue;
+    if (sem_wait(&curr->addEventSem)) {
+        mvLog(MVLOG_ERROR,"can't wait semaphore\n");
+    }
+    event->isServed = EVENT_SERVED;
+    eventListPush(&q->free, event);
+    if (sem_post(&curr->addEventSem)) {
+        mvLog(MVLOG_ERROR,"can't post semaphore\n");
+    }
+}
+
+static void markEventBlocked(xLinkEventPriv_t* event, xLinkSchedulerState_t* curr)
 {
+    eventList_t* blocked = getBlockedList(curr, event->packet.header.streamId);
+    //an unblocked event which blocks again was the oldest one, it keeps its place
+    if (event->isServed == EVENT_READY)
+        eventListPushFront(blocked, event);
+    else
+        eventListPush(blocked, event);
     event->isServed = EVENT_BLOCKED;
 }
 
-static void markEventReady(xLinkEventPriv_t* event)
+static void markEventPending(xLinkEventPriv_t* event, xLinkSchedulerState_t* curr)
+{
+    event->isServed = EVENT_PENDING;
+    eventListPush(getPendingList(curr, event->packet.header.id), event);
+}
+
+static void markEventReady(xLinkEventPriv_t* event, xLinkSchedulerState_t* curr)
 {
     event->isServed = EVENT_READY;
+    eventListPush(&curr->readyEvents, event);
 }
 
-static void markEventServed(xLinkEventPriv_t* event)
+static void markEventServed(xLinkEventPriv_t* event, xLinkSchedulerState_t* curr)
 {
-    if(event->sem){
+    if(event->complete){
+        event->complete(&event->packet, event->data);
+    }else if(event->sem){
         if (sem_post(event->sem)) {
             mvLog(MVLOG_ERROR,"can't post semaphore\n");
         }
     }
-    event->isServed = EVENT_SERVED;
+    releaseEvent(event, curr);
+}
+
+//the request will never be answered, let the waiting thread fail it
+static void markEventFailed(xLinkEventPriv_t* event, xLinkSchedulerState_t* curr)
+{
+    event->packet.header.flags.bitField.ack = 0;
+    event->packet.header.flags.bitField.nack = 1;
+    markEventServed(event, curr);
 }
 
 
@@ -225,14 +321,14 @@ static int dispatcherRequestServe(xLinkEventPriv_t * event, xLinkSchedulerState_
     ASSERT_X_LINK(isEventTypeRequest(event));
     xLinkEventHeader_t *header = &event->packet.header;
     if (header->flags.bitField.block){ //block is requested
-        markEventBlocked(event);
+        markEventBlocked(event, curr);
     }else if(header->flags.bitField.localServe == 1 ||
              (header->flags.bitField.ack == 0
              && header->flags.bitField.nack == 1)){ //this event is served locally, or it is failed
-        markEventServed(event);
+        markEventServed(event, curr);
     }else if (header->flags.bitField.ack == 1
               && header->flags.bitField.nack == 0){
-        event->isServed = EVENT_PENDING;
+        markEventPending(event, curr);
         mvLog(MVLOG_DEBUG,"------------------------UNserved %s\n",
               TypeToStr(event->packet.header.type));
     }else{
@@ -244,55 +340,39 @@ static int dispatcherRequestServe(xLinkEventPriv_t * event, xLinkSchedulerState_
 
 static int dispatcherResponseServe(xLinkEventPriv_t * event, xLinkSchedulerState_t* curr)
 {
-    int i = 0;
     ASSERT_X_LINK(curr != NULL);
     ASSERT_X_LINK(!isEventTypeRequest(event));
-    for (i = 0; i < MAX_EVENTS; i++)
+    xLinkEventHeader_t *evHeader = &event->packet.header;
+    eventList_t* pending = getPendingList(curr, evHeader->id);
+    xLinkEventPriv_t* prev = NULL;
+    xLinkEventPriv_t* req;
+    for (req = pending->head; req != NULL; prev = req, req = req->next)
     {
-        xLinkEventHeader_t *header = &curr->lQueue.q[i].packet.header;
-        xLinkEventHeader_t *evHeader = &event->packet.header;
+        xLinkEventHeader_t *header = &req->packet.header;
 
-        if (curr->lQueue.q[i].isServed == EVENT_PENDING &&
-                        header->id == evHeader->id &&
-                        header->type == evHeader->type - USB_REQUEST_LAST -1)
+        if (header->id == evHeader->id &&
+            header->type == evHeader->type - USB_REQUEST_LAST -1)
         {
             mvLog(MVLOG_DEBUG,"----------------------ISserved %s\n",
                     TypeToStr(header->type));
+            eventListUnlink(pending, prev, req);
             //propagate back flags
             header->flags = evHeader->flags;
-            markEventServed(&curr->lQueue.q[i]);
-            break;
+            markEventServed(req, curr);
+            return 0;
         }
     }
-    if (i == MAX_EVENTS) {
-        mvLog(MVLOG_FATAL,"no request for this response: %s %d\n", TypeToStr(event->packet.header.type), event->origin);
-        ASSERT_X_LINK(0);
-    }
+    mvLog(MVLOG_FATAL,"no request for this response: %s %d\n", TypeToStr(event->packet.header.type), event->origin);
+    ASSERT_X_LINK(0);
     return 0;
 }
 
-static inline xLinkEventPriv_t* getNextElementWithState(xLinkEventPriv_t* base, xLinkEventPriv_t* end,
-                                                        xLinkEventPriv_t* start, xLinkEventState_t state){
-    xLinkEventPriv_t* tmp = start;
-    while (start->isServed != state){
-        CIRCULAR_INCREMENT(start, end, base);
-        if(tmp == start){
-            break;
-        }
-    }
-    if(start->isServed == state){
-        return start;
-    }else{
-        return NULL;
-    }
-}
-
 static xLinkEventPriv_t* searchForReadyEvent(xLinkSchedulerState_t* curr)
 {
     ASSERT_X_LINK(curr != NULL);
     xLinkEventPriv_t* ev = NULL;
 
-    ev = getNextElementWithState(curr->lQueue.base, curr->lQueue.end, curr->lQueue.base, EVENT_READY);
+    ev = eventListPop(&curr->readyEvents);
     if(ev){
         mvLog(MVLOG_DEBUG,"ready %s %d \n",
               TypeToStr((int)ev->packet.header.type),
@@ -301,29 +381,24 @@ static xLinkEventPriv_t* searchForReadyEvent(xLinkSchedulerState_t* curr)
     return ev;
 }
 
-static xLinkEventPriv_t* getNextQueueElemToProc(eventQueueHandler_t *q ){
-    xLinkEventPriv_t* event = NULL;
-    if (q->cur != q->curProc) {
-        event = getNextElementWithState(q->base, q->end, q->curProc, EVENT_SERVED);
-        q->curProc = event;
-        CIRCULAR_INCREMENT(q->curProc, q->end, q->base);
-    }
-    return event;
-}
-
-
+//called with addEventSem taken
 static xLinkEvent_t* addNextQueueElemToProc(eventQueueHandler_t *q, xLinkEvent_t* event,
-                                                sem_t* sem, xLinkEventOrigin_t o){
-    xLinkEvent_t* ev;
-    xLinkEventPriv_t* eventP = getNextElementWithState(q->base, q->end, q->cur, EVENT_SERVED);
+                                                sem_t* sem, eventCompleteFunction complete, void* ctx,
+                                                xLinkEventOrigin_t o){
+    xLinkEventPriv_t* eventP = eventListPop(&q->free);
+    if (!eventP) {
+        mvLog(MVLOG_ERROR,"No free event for %s. Increase MAX_EVENTS\n", TypeToStr(event->header.type));
+        return NULL;
+    }
     mvLog(MVLOG_DEBUG,"received event %s %d\n",TypeToStr(event->header.type), o);
-    ev = &eventP->packet;
     eventP->sem = sem;
+    eventP->complete = complete;
+    eventP->data = ctx;
     eventP->packet = *event;
     eventP->origin = o;
-    q->cur = eventP;
-    CIRCULAR_INCREMENT(q->cur, q->end, q->base);
-    return ev;
+    eventP->isServed = EVENT_ALLOCATED;
+    eventListPush(&q->toProc, eventP);
+    return &eventP->packet;
 }
 
 static xLinkEventPriv_t* dispatcherGetNextEvent(xLinkSchedulerState_t* curr)
@@ -338,31 +413,56 @@ static xLinkEventPriv_t* dispatcherGetNextEvent(xLinkSchedulerState_t* curr)
     if (sem_wait(&curr->notifyDispatcherSem)) {
         mvLog(MVLOG_ERROR,"can't post semaphore\n");
     }
-    event = getNextQueueElemToProc(&curr->lQueue);
-    if (event) {
-        return event;
+    if (sem_wait(&curr->addEventSem)) {
+        mvLog(MVLOG_ERROR,"can't wait semaphore\n");
+    }
+    event = eventListPop(&curr->lQueue.toProc);
+    if (!event) {
+        event = eventListPop(&curr->rQueue.toProc);
+    }
+    if (sem_post(&curr->addEventSem)) {
+        mvLog(MVLOG_ERROR,"can't post semaphore\n");
     }
-    event = getNextQueueElemToProc(&curr->rQueue);
     return event;
 }
 
 static void dispatcherReset(xLinkSchedulerState_t* curr)
 {
     ASSERT_X_LINK(curr != NULL);
+    int i;
 
     glControlFunc->closeLink(curr->xLinkFD);
-    if (sem_post(&curr->notifyDispatcherSem)) {
-        mvLog(MVLOG_ERROR,"can't post semaphore\n"); //to allow us to get a NULL event
+    //nobody is going to answer the requests in flight, wake up their threads
+    xLinkEventPriv_t* event;
+    while ((event = eventListPop(&curr->readyEvents)) != NULL) {
+        markEventFailed(event, curr);
     }
-    xLinkEventPriv_t* event = dispatcherGetNextEvent(curr);
-    while (event != NULL) {
-       event = dispatcherGetNextEvent(curr);
+    for (i = 0; i < STREAM_BUCKETS; i++) {
+        while ((event = eventListPop(&curr->blockedEvents[i])) != NULL) {
+            markEventFailed(event, curr);
+        }
     }
-
-    event = getNextElementWithState(curr->lQueue.base, curr->lQueue.end, curr->lQueue.base, EVENT_SERVED);
-    while (event != NULL) {
-        markEventServed(event);
-        event = getNextElementWithState(curr->lQueue.base, curr->lQueue.end, curr->lQueue.base, EVENT_PENDING);
+    for (i = 0; i < EVENT_BUCKETS; i++) {
+        while ((event = eventListPop(&curr->pendingEvents[i])) != NULL) {
+            markEventFailed(event, curr);
+        }
+    }
+    //events which never reached the dispatcher loop
+    if (sem_wait(&curr->addEventSem)) {
+        mvLog(MVLOG_ERROR,"can't wait semaphore\n");
+    }
+    eventList_t lToProc = curr->lQueue.toProc;
+    curr->lQueue.toProc.head = curr->lQueue.toProc.tail = NULL;
+    eventList_t rToProc = curr->rQueue.toProc;
+    curr->rQueue.toProc.head = curr->rQueue.toProc.tail = NULL;
+    if (sem_post(&curr->addEventSem)) {
+        mvLog(MVLOG_ERROR,"can't post semaphore\n");
+    }
+    while ((event = eventListPop(&lToProc)) != NULL) {
+        markEventFailed(event, curr);
+    }
+    while ((event = eventListPop(&rToProc)) != NULL) {
+        releaseEvent(event, curr);
     }
     glControlFunc->resetDevice(curr->xLinkFD);
     curr->schedulerId = -1;
@@ -434,6 +534,10 @@ static void* eventSchedulerRun(void* ctx)
                 curr->resetXLink = 1;
             }
         }
+        //local requests were moved to the list of their new state by dispatcherRequestServe
+        if (event->origin == EVENT_REMOTE || !isEventTypeRequest(event)){
+            releaseEvent(event, curr);
+        }
     }
     pthread_join(readerThreadId, NULL);
     dispatcherReset(curr);
@@ -462,9 +566,8 @@ static xLinkSchedulerState_t* findCorrespondingScheduler(void* xLinkFD)
 
     return NULL;
 }
-///////////////// External Interface //////////////////////////
-/*Adds a new event with parameters and returns event id*/
-xLinkEvent_t* dispatcherAddEvent(xLinkEventOrigin_t origin, xLinkEvent_t *event)
+static xLinkEvent_t* addEvent(xLinkEventOrigin_t origin, xLinkEvent_t *event,
+                              eventCompleteFunction complete, void* ctx)
 {
     xLinkSchedulerState_t* curr = findCorrespondingScheduler(event->xLinkFD);
     ASSERT_X_LINK(curr != NULL);
@@ -480,30 +583,48 @@ xLinkEvent_t* dispatcherAddEvent(xLinkEventOrigin_t origin, xLinkEvent_t *event)
     xLinkEvent_t* ev;
     if (origin == EVENT_LOCAL) {
         event->header.id = createUniqueID();
-        sem = getCurrentSem(pthread_self(), curr);
-        if (!sem) {
+        if (!complete) {
+            sem = getCurrentSem(pthread_self(), curr);
+            if (!sem) {
 
-            sem = createSem(curr);
+                sem = createSem(curr);
+            }
         }
-        if (!sem) {
+        if (!sem && !complete) {
             mvLog(MVLOG_WARN,"No more semaphores. Increase XLink or OS resources\n");
+            if (sem_post(&curr->addEventSem)) {
+                mvLog(MVLOG_ERROR,"can't post semaphore\n");
+            }
             return NULL;
         }
         event->header.flags.raw = 0;
         event->header.flags.bitField.ack = 1;
-        ev = addNextQueueElemToProc(&curr->lQueue, event, sem, origin);
+        ev = addNextQueueElemToProc(&curr->lQueue, event, sem, complete, ctx, origin);
     } else {
-        ev = addNextQueueElemToProc(&curr->rQueue, event, NULL, origin);
+        ev = addNextQueueElemToProc(&curr->rQueue, event, NULL, NULL, NULL, origin);
     }
     if (sem_post(&curr->addEventSem)) {
         mvLog(MVLOG_ERROR,"can't post semaphore\n");
     }
-    if (sem_post(&curr->notifyDispatcherSem)) {
+    if (ev && sem_post(&curr->notifyDispatcherSem)) {
         mvLog(MVLOG_ERROR, "can't post semaphore\n");
     }
     return ev;
 }
 
+///////////////// External Interface //////////////////////////
+/*Adds a new event with parameters and returns event id*/
+xLinkEvent_t* dispatcherAddEvent(xLinkEventOrigin_t origin, xLinkEvent_t *event)
+{
+    return addEvent(origin, event, NULL, NULL);
+}
+
+xLinkEvent_t* dispatcherAddEventAsync(xLinkEvent_t *event, eventCompleteFunction complete, void* ctx)
+{
+    ASSERT_X_LINK(complete != NULL);
+    return addEvent(EVENT_LOCAL, event, complete, ctx);
+}
+
 int dispatcherWaitEventComplete(void* xLinkFD)
 {
     xLinkSchedulerState_t* curr = findCorrespondingScheduler(xLinkFD);
@@ -523,20 +644,22 @@ int dispatcherUnblockEvent(eventId_t id, xLinkEventType_t type, streamId_t strea
     ASSERT_X_LINK(curr != NULL);
 
     mvLog(MVLOG_DEBUG,"unblock\n");
+    eventList_t* blocked = getBlockedList(curr, stream);
+    xLinkEventPriv_t* prev = NULL;
     xLinkEventPriv_t* blockedEvent;
-    for (blockedEvent = curr->lQueue.q;
-         blockedEvent < curr->lQueue.q + MAX_EVENTS;
-         blockedEvent++)
+    for (blockedEvent = blocked->head;
+         blockedEvent != NULL;
+         prev = blockedEvent, blockedEvent = blockedEvent->next)
     {
-        if (blockedEvent->isServed == EVENT_BLOCKED &&
-            ((blockedEvent->packet.header.id == id || id == -1)
+        if ((blockedEvent->packet.header.id == id || id == -1)
             && blockedEvent->packet.header.type == type
-            && blockedEvent->packet.header.streamId == stream))
+            && blockedEvent->packet.header.streamId == stream)
         {
             mvLog(MVLOG_DEBUG,"unblocked**************** %d %s\n",
                   (int)blockedEvent->packet.header.id,
                   TypeToStr((int)blockedEvent->packet.header.type));
-            markEventReady(blockedEvent);
+            eventListUnlink(blocked, prev, blockedEvent);
+            markEventReady(blockedEvent, curr);
             return 1;
         } else {
             mvLog(MVLOG_DEBUG,"%d %s\n",
@@ -559,7 +682,7 @@ int findAvailableScheduler()
 int dispatcherStart(void* fd)
 {
     pthread_attr_t attr;
-    int eventIdx;
+    int i;
     if (numSchedulers >= MAX_SCHEDULERS)
     {
         mvLog(MVLOG_ERROR,"Max number Schedulers reached!\n");
@@ -573,21 +696,13 @@ int dispatcherStart(void* fd)
     schedulerState[idx].xLinkFD = fd;
     schedulerState[idx].schedulerId = idx;
 
-    schedulerState[idx].lQueue.cur = schedulerState[idx].lQueue.q;
-    schedulerState[idx].lQueue.curProc = schedulerState[idx].lQueue.q;
-    schedulerState[idx].lQueue.base = schedulerState[idx].lQueue.q;
-    schedulerState[idx].lQueue.end = &schedulerState[idx].lQueue.q[MAX_EVENTS];
-
-    schedulerState[idx].rQueue.cur = schedulerState[idx].rQueue.q;
-    schedulerState[idx].rQueue.curProc = schedulerState[idx].rQueue.q;
-    schedulerState[idx].rQueue.base = schedulerState[idx].rQueue.q;
-    schedulerState[idx].rQueue.end = &schedulerState[idx].rQueue.q[MAX_EVENTS];
-
-    for (eventIdx = 0 ; eventIdx < MAX_EVENTS; eventIdx++)
-    {
-        schedulerState[idx].rQueue.q[eventIdx].isServed = EVENT_SERVED;
-        schedulerState[idx].lQueue.q[eventIdx].isServed = EVENT_SERVED;
-    }
+    eventQueueInit(&schedulerState[idx].lQueue);
+    eventQueueInit(&schedulerState[idx].rQueue);
+    schedulerState[idx].readyEvents.head = schedulerState[idx].readyEvents.tail = NULL;
+    for (i = 0; i < STREAM_BUCKETS; i++)
+        schedulerState[idx].blockedEvents[i].head = schedulerState[idx].blockedEvents[i].tail = NULL;
+    for (i = 0; i < EVENT_BUCKETS; i++)
+        schedulerState[idx].pendingEvents[i].head = schedulerState[idx].pendingEvents[i].tail = NULL;
 
     if (sem_init(&schedulerState[idx].addEventSem, 0, 1)) {
         perror("Can't create semaphore\n");
@@ -34,9 +34,15 @@ extern "C"
 #endif
 typedef int (*getRespFunction) (xLinkEvent_t*,
                 xLinkEvent_t*);
+typedef void (*eventCompleteFunction) (xLinkEvent_t*, void* ctx);
 ///Adds a new event with parameters and returns event.header.id
 xLinkEvent_t* dispatcherAddEvent(xLinkEventOrigin_t origin,
 									xLinkEvent_t *event);
+///Adds a local event which completes by calling complete from the dispatcher thread,
+///instead of waking the thread which added it
+xLinkEvent_t* dispatcherAddEventAsync(xLinkEvent_t *event,
+									eventCompleteFunction complete,
+									void* ctx);
 
 int dispatcherWaitEventComplete(void* xlinkFD);
 int dispatcherUnblockEvent(eventId_t id,
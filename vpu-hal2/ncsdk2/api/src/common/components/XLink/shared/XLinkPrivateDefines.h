@@ -45,7 +45,9 @@ extern "C"
 #define HEADER_SIZE (64-12 -8)
 #endif
 
+#ifndef MAXIMUM_SEMAPHORES
 #define MAXIMUM_SEMAPHORES 16
+#endif
 #define __CACHE_LINE_SIZE 64
 
 #define ASSERT_X_LINK(x)   if(!(x)) { fprintf(stderr, "info: %s:%d: ", __FILE__, __LINE__); abort(); }
@@ -58,7 +60,23 @@ typedef enum {
     USB_LINK_DOWN,
 }xLinkState_t;
 
-typedef struct{
+// Asynchronous writes in flight per stream, see XLinkAsyncWriteData
+#define XLINK_MAX_ASYNC_WRITES 32
+
+struct streamDesc_t;
+
+typedef struct {
+    struct streamDesc_t* stream;
+    streamId_t streamId;  // as given to XLinkAsyncWriteData
+    XLinkWriteToken_t token;
+    uint32_t size;
+    XLinkWriteCallback_t callback;
+    void* userData;
+    XLinkError_t status;
+    uint32_t done;
+} xLinkAsyncWrite_t;
+
+typedef struct streamDesc_t{
     char name[MAX_NAME_LENGTH];
     streamId_t id;
     void* fd;
@@ -77,6 +95,16 @@ typedef struct{
     uint32_t remoteFillPacketLevel;
 
     uint32_t closeStreamInitiated;
+    uint32_t blockedWrites; // local writes waiting for space in the remote, they are sent in order
+
+    // asynchronous writes, guarded by the XLink async write lock
+    uint32_t asyncWritesQueued; // last token handed out
+    uint32_t asyncWritesDone;   // every write up to this token has completed
+    uint32_t asyncBytesInFlight;
+    xLinkAsyncWrite_t asyncWrites[XLINK_MAX_ASYNC_WRITES];
+    // tokens of the last failed writes whose slot was reused
+    uint32_t asyncWriteFailures[XLINK_MAX_ASYNC_WRITES];
+    uint32_t asyncWriteFailureCount;
 
     sem_t sem;
 }streamDesc_t;
@@ -112,7 +140,11 @@ typedef enum
     EVENT_REMOTE,
 } xLinkEventOrigin_t;
 
+// Events in flight per link and direction. Can be raised at build time (-DMAX_EVENTS=...),
+// the dispatcher cost per event doesn't depend on it.
+#ifndef MAX_EVENTS
 #define MAX_EVENTS 64
+#endif
 
 #define MAX_SCHEDULERS MAX_LINKS
 //static int eventCount;
@@ -53,6 +53,14 @@ typedef enum{
 typedef uint32_t streamId_t;
 typedef uint8_t linkId_t;
 
+// Identifies an asynchronous write within its stream, tokens start at 1
+typedef uint32_t XLinkWriteToken_t;
+
+// Completion of an asynchronous write. Called from the XLink dispatcher thread,
+// so it must not wait for other XLink requests.
+typedef void (*XLinkWriteCallback_t)(streamId_t streamId, XLinkWriteToken_t token,
+                                     XLinkError_t status, void* userData);
+
 
 typedef struct streamPacketDesc_t
 {
@@ -61,6 +69,19 @@ typedef struct streamPacketDesc_t
 
 } streamPacketDesc_t;
 
+#define XLINK_PROF_LATENCY_BUCKETS 24
+
+// Packet data moved by the transport, header included for the writes
+typedef struct XLinkTransferProf_t
+{
+    unsigned long count;
+    unsigned long bytes;
+    float totalTime;
+    float maxTime;
+    // bucket i counts the transfers of 2^i to 2^(i+1) us, bucket 0 the shorter ones too
+    unsigned long latencyHist[XLINK_PROF_LATENCY_BUCKETS];
+} XLinkTransferProf_t;
+
 typedef struct XLinkProf_t
 {
     float totalReadTime;
@@ -69,6 +90,8 @@ typedef struct XLinkProf_t
     unsigned long totalWriteBytes;
     unsigned long totalBootCount;
     float totalBootTime;
+    XLinkTransferProf_t writeTransfers;
+    XLinkTransferProf_t readTransfers;
 } XLinkProf_t;
 
 typedef struct XLinkGlobalHandler_t
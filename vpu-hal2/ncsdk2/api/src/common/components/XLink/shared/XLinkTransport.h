@@ -0,0 +1,72 @@
+/*
+* Copyright 2017 Intel Corporation.
+* The source code, information and material ("Material") contained herein is
+* owned by Intel Corporation or its suppliers or licensors, and title to such
+* Material remains with Intel Corporation or its suppliers or licensors.
+* The Material contains proprietary information of Intel or its suppliers and
+* licensors. The Material is protected by worldwide copyright laws and treaty
+* provisions.
+* No part of the Material may be used, copied, reproduced, modified, published,
+* uploaded, posted, transmitted, distributed or disclosed in any way without
+* Intel's prior express written permission. No license under any patent,
+* copyright or other intellectual property rights in the Material is granted to
+* or conferred upon you, either expressly, by implication, inducement, estoppel
+* or otherwise.
+* Any license under such intellectual property rights must be express and
+* approved by Intel in writing.
+*/
+
+
+///
+/// @brief     Transport of the XLink packets between the host and the device
+///
+#ifndef _XLINK_TRANSPORT_H
+#define _XLINK_TRANSPORT_H
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+XLink sends and receives its packets through a transport. The functions have the
+semantics of the UsbLinkPlatform ones: init, getDeviceName, bootRemote and connect return
+usbLinkPlatformErrorCode_t values, write and read transfer the whole buffer or return
+a negative value once the link is down.
+writev is optional: it writes the buffers back to back like consecutive writes would,
+without waiting for one buffer to be sent before starting the next one.
+*/
+typedef struct {
+    void* data;
+    int size;
+} xLinkIoVec_t;
+
+typedef struct xLinkTransport_t {
+    const char* name;
+    int (*init)(int loglevel);
+    int (*getDeviceName)(int index, char* name, int nameSize);
+    int (*bootRemote)(const char* deviceName, const char* binaryPath);
+    int (*connect)(const char* devPathRead, const char* devPathWrite, void** fd);
+    int (*resetRemote)(void* fd);
+    int (*write)(void* fd, void* data, int size, unsigned int timeout);
+    int (*read)(void* fd, void* data, int size, unsigned int timeout);
+    int (*writev)(void* fd, const xLinkIoVec_t* iov, int iovcnt, unsigned int timeout);
+} xLinkTransport_t;
+
+// UsbLinkPlatform, the default one
+extern const xLinkTransport_t xLinkUsbTransport;
+
+#ifdef __PC__
+// In-process device emulator, see XLinkLoopbackTransport.h
+extern const xLinkTransport_t xLinkLoopbackTransport;
+// UNIX socket to a device emulator process, see XLinkSocketTransport.h
+extern const xLinkTransport_t xLinkSocketTransport;
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/* end of include file */
@@ -61,6 +61,7 @@
 #define MAX_ITERATIONS  20
 
 static int initialized = 0;
+static int maxPendingTriggers = NC_MAX_PENDING_TRIGGERS;
 static pthread_mutex_t globalMutex = PTHREAD_MUTEX_INITIALIZER;
 static XLinkGlobalHandler_t ghandler;
 
@@ -274,8 +275,9 @@ static ncStatus_t getOptimisationList(struct _devicePrivate_t *d)
 }
 
 static ncStatus_t getThermalStats(struct _devicePrivate_t *d){
+    // the throttling level followed by the temperatures
     if (!d->thermal_stats){
-        d->thermal_stats = calloc(THERMAL_BUFFER_SIZE, 1);
+        d->thermal_stats = calloc(THERMAL_BUFFER_SIZE + sizeof(float), 1);
         if (!d->thermal_stats)
             return NC_OUT_OF_MEMORY;
     }
@@ -293,12 +295,15 @@ static ncStatus_t getThermalStats(struct _devicePrivate_t *d){
         pthread_mutex_unlock(&d->dev_stream_m);
         return NC_ERROR;
     }
-    pthread_mutex_unlock(&d->dev_stream_m);
     if( packet->length != (THERMAL_BUFFER_SIZE + sizeof(float))) {
+        XLinkReleaseData(d->device_mon_stream_id);
+        pthread_mutex_unlock(&d->dev_stream_m);
         return NC_ERROR;
     }
+    // copied under the lock, a thermal monitor thread may sample the device concurrently
     memcpy(d->thermal_stats, packet->data, packet->length);
     XLinkReleaseData(d->device_mon_stream_id);
+    pthread_mutex_unlock(&d->dev_stream_m);
     return NC_OK;
 }
 static ncStatus_t deviceGetDeviceMemory(struct _devicePrivate_t *d, uint32_t *mem) {
@@ -540,6 +545,25 @@ static int deallocateGraph(struct _graphPrivate_t *g)
 	return -!found;
 }
 
+// Frees the buffers ncFifoCreate preallocates, the FIFO can be created again afterwards
+static void freeFifoBuffers(struct _fifoPrivate_t *f)
+{
+	free(f->output_data);
+	free(f->write_staging);
+	free(f->write_tokens);
+	free(f->write_slot_held);
+	f->output_data = NULL;
+	f->write_staging = NULL;
+	f->write_tokens = NULL;
+	f->write_slot_held = NULL;
+	struct _userParamPrivate_t* temp;
+	while (f->user_param_free) {
+		temp = f->user_param_free;
+		f->user_param_free =  f->user_param_free->next;
+		free(temp);
+	}
+}
+
 static int deallocateFifo(struct _fifoPrivate_t *f)
 {
 	int found = 0;
@@ -567,7 +591,6 @@ static int deallocateFifo(struct _fifoPrivate_t *f)
 
 		//deallocate on device
 		XLinkCloseStream(f->streamId);
-		free(f->output_data);
 		struct _userParamPrivate_t* temp;
 		while (f->user_param_in) {
 			temp = f->user_param_in;
@@ -579,6 +602,7 @@ static int deallocateFifo(struct _fifoPrivate_t *f)
 			f->user_param_out =  f->user_param_out->next;
 			free(temp);
 		}
+		freeFifoBuffers(f);
 	}
 
 	return -!found;
@@ -692,6 +716,35 @@ ncStatus_t checkGraphMonitorResponse(streamId_t graphMonStream) {
     return NC_OK;
 }
 
+// Reads the acks of the graph triggers in flight until trigger seq is acknowledged.
+// The result of each trigger is stored to its output FIFO element and reported by ncFifoReadElem.
+// Must be called with graph_streamm locked.
+static ncStatus_t waitTriggerAck(struct _devicePrivate_t *d, uint32_t seq) {
+    while ((int32_t)(seq - d->trigger_seq_acked) > 0) {
+        uint32_t acked = d->trigger_seq_acked + 1;
+        ncStatus_t rc = checkGraphMonitorResponse(d->graph_monitor_stream_id);
+        if (rc == NC_ERROR) {
+            return NC_ERROR;
+        }
+        struct _userParamPrivate_t *elem = d->pending_triggers[acked % NC_MAX_PENDING_TRIGGERS];
+        d->pending_triggers[acked % NC_MAX_PENDING_TRIGGERS] = NULL;
+        d->trigger_seq_acked = acked;
+        for (; elem; elem = elem->trigger_next) {
+            elem->trigger_status = rc;
+            elem->trigger_pending = 0;
+        }
+        if (rc != NC_OK) {
+            mvLog(MVLOG_WARN, "Graph trigger %u failed", acked);
+        }
+    }
+    return NC_OK;
+}
+
+// Synchronous graph monitor requests must not take the acks of the triggers in flight
+static ncStatus_t flushTriggerAcks(struct _devicePrivate_t *d) {
+    return waitTriggerAck(d, d->trigger_seq_sent);
+}
+
 ncStatus_t ncGraphAllocate(struct deviceHandle_t *deviceHandle,
                            struct graphHandle_t *graphHandle,
                            const void *graphFile, unsigned int graphFileLength) {
@@ -764,9 +817,9 @@ ncStatus_t ncGraphAllocate(struct deviceHandle_t *deviceHandle,
 
     pthread_mutex_lock(&d->graph_streamm);
 
-    if(sendGraphMonitorRequest(d->graph_monitor_stream_id, &cmd)){
+    if(flushTriggerAcks(d) || sendGraphMonitorRequest(d->graph_monitor_stream_id, &cmd)){
         mvLog(MVLOG_WARN, "can't send graph allocation command");
-        pthread_mutex_lock(&d->graph_streamm);
+        pthread_mutex_unlock(&d->graph_streamm);
         return NC_ERROR;
     }
     if(XLinkWriteData(streamId, graphFile, graphFileLength) != 0 ){
@@ -785,29 +838,37 @@ ncStatus_t ncGraphAllocate(struct deviceHandle_t *deviceHandle,
     XLinkReadData(streamId, &tensorDescOut);
     XLinkReadData(streamId, &nstages);
 		mvLog(MVLOG_INFO, "XLinkReadData done");
-    //for now, supoprt only count 1
     if(!tensorDescIn ||
         tensorDescIn->length % sizeof(struct tensorDescriptor_t) ||
-        tensorDescIn->length / sizeof(struct tensorDescriptor_t) > 1) {
+        tensorDescIn->length / sizeof(struct tensorDescriptor_t) < 1 ||
+        tensorDescIn->length / sizeof(struct tensorDescriptor_t) > NC_MAX_GRAPH_TENSORS) {
         mvLog(MVLOG_ERROR, "Input tensor descriptors of the graph are invalid\n");
         mvLog(MVLOG_ERROR, "Received data from graph %d\n", *(int*)tensorDescIn->data);
         rc = NC_MYRIAD_ERROR;
     }
-    //for now, supoprt only count 1
     if(!tensorDescOut ||
         tensorDescOut->length % sizeof(struct tensorDescriptor_t) ||
-        tensorDescOut->length / sizeof(struct tensorDescriptor_t) > 1) {
+        tensorDescOut->length / sizeof(struct tensorDescriptor_t) < 1 ||
+        tensorDescOut->length / sizeof(struct tensorDescriptor_t) > NC_MAX_GRAPH_TENSORS) {
         mvLog(MVLOG_ERROR, "Output tensor descriptors of the graph are invalid\n");
         rc = NC_MYRIAD_ERROR;
     }
+    // All the FIFOs of a trigger must fit to one graph command
+    if(rc == NC_OK &&
+        (tensorDescIn->length + tensorDescOut->length) / sizeof(struct tensorDescriptor_t) > GRAPH_CMD_MAX_BUFFERS) {
+        mvLog(MVLOG_ERROR, "Graph has more than %d inputs and outputs\n", GRAPH_CMD_MAX_BUFFERS);
+        rc = NC_UNSUPPORTED_GRAPH_FILE;
+    }
     if (rc == NC_OK){
 			  mvLog(MVLOG_INFO, "set input/output/stages count");
         g->input_count = tensorDescIn->length / sizeof(struct tensorDescriptor_t);
-        memcpy(&g->input_tensor_desc, tensorDescIn->data,
-               sizeof(struct tensorDescriptor_t));
+        for (int i = 0; i < g->input_count; i++)
+            memcpy(&g->input_tensor_desc[i], (struct tensorDescriptor_t*) tensorDescIn->data + i,
+                   sizeof(struct tensorDescriptor_t));
         g->output_count = tensorDescOut->length / sizeof(struct tensorDescriptor_t);
-        memcpy(&g->output_tensor_desc, tensorDescOut->data,
-               sizeof(struct tensorDescriptor_t));
+        for (int i = 0; i < g->output_count; i++)
+            memcpy(&g->output_tensor_desc[i], (struct tensorDescriptor_t*) tensorDescOut->data + i,
+                   sizeof(struct tensorDescriptor_t));
         g->nstages = *(uint32_t*)nstages->data;
 				mvLog(MVLOG_INFO, "set input/output/stages count done");
     }
@@ -832,6 +893,7 @@ ncStatus_t ncGraphAllocate(struct deviceHandle_t *deviceHandle,
         return NC_ERROR;
     }
     if (rc){
+        pthread_mutex_unlock(&d->graph_streamm);
         return rc;
     }
     //TODO: this will go away once graph options are handled properly
@@ -882,10 +944,12 @@ ncStatus_t ncGraphDeallocate(struct graphHandle_t *graphHandle) {
     cmd.cmd.graphCmd.type  = GRAPH_DEALLOCATE_CMD;
     cmd.cmd.graphCmd.id  = g->id;
     pthread_mutex_lock(&d->graph_streamm);
-    if (sendGraphMonitorRequest(d->graph_monitor_stream_id, &cmd)) {
+    if (flushTriggerAcks(d) || sendGraphMonitorRequest(d->graph_monitor_stream_id, &cmd)) {
+        pthread_mutex_unlock(&d->graph_streamm);
         return NC_ERROR;
     }
     if (checkGraphMonitorResponse(d->graph_monitor_stream_id)) {
+        pthread_mutex_unlock(&d->graph_streamm);
         return NC_ERROR;
     }
     XLinkCloseStream(g->graph_stream_id);
@@ -1000,7 +1064,7 @@ static ncStatus_t getGraphOptionClass0(struct _graphPrivate_t *g,
         cmd.cmd.optionCmd.type.c0  = CLASS0_TIMING_DATA;
         pthread_mutex_lock(&g->dev->graph_streamm); //TODO: this mutex is shared with device option stream, could be separated
         //TODO: create buffer to other function
-        if (sendGraphMonitorRequest(g->dev->graph_monitor_stream_id, &cmd)){
+        if (flushTriggerAcks(g->dev) || sendGraphMonitorRequest(g->dev->graph_monitor_stream_id, &cmd)){
             pthread_mutex_unlock(&g->dev->graph_streamm);
             return NC_ERROR;
         }
@@ -1035,7 +1099,8 @@ static ncStatus_t getGraphOptionClass0(struct _graphPrivate_t *g,
         cmd.cmd.optionCmd.id  = g->id;
         //TODO: create buffer to other function
         pthread_mutex_lock(&g->dev->graph_streamm);
-        if(XLinkWriteData(g->dev->graph_monitor_stream_id, (const uint8_t*)&cmd, sizeof(cmd)) != 0 )
+        if(flushTriggerAcks(g->dev) ||
+           XLinkWriteData(g->dev->graph_monitor_stream_id, (const uint8_t*)&cmd, sizeof(cmd)) != 0 )
         {
             pthread_mutex_unlock(&g->dev->graph_streamm);
             return NC_ERROR;
@@ -1062,12 +1127,14 @@ static ncStatus_t getGraphOptionClass0(struct _graphPrivate_t *g,
         *dataLength = DEBUG_BUFFER_SIZE;
         break;
     case NC_RO_GRAPH_INPUT_TENSOR_DESCRIPTORS:
-        *(struct ncTensorDescriptor_t**) data = &g->input_tensor_desc; //TODO: should we malloc here instead
-        *dataLength = sizeof(&g->input_tensor_desc);
+        // Array of NC_RO_GRAPH_INPUT_COUNT descriptors
+        *(struct ncTensorDescriptor_t**) data = g->input_tensor_desc; //TODO: should we malloc here instead
+        *dataLength = sizeof(struct ncTensorDescriptor_t*);
         break;
     case NC_RO_GRAPH_OUTPUT_TENSOR_DESCRIPTORS:
-        *(struct ncTensorDescriptor_t**) data = &g->output_tensor_desc; //TODO: should we malloc here instead
-        *dataLength = sizeof(&g->output_tensor_desc);
+        // Array of NC_RO_GRAPH_OUTPUT_COUNT descriptors
+        *(struct ncTensorDescriptor_t**) data = g->output_tensor_desc; //TODO: should we malloc here instead
+        *dataLength = sizeof(struct ncTensorDescriptor_t*);
         break;
     case NC_RO_GRAPH_NAME:
         *(char**) data = g->name;
@@ -1166,6 +1233,13 @@ ncStatus_t ncGlobalSetOption(int option, const void *data,
 	case NC_RW_LOG_LEVEL:
 	    mvLogLevelSet(*(mvLog_t *) data);
 		break;
+	case NC_RW_MAX_PENDING_TRIGGERS:
+	    if (*(int *) data < 1 || *(int *) data > NC_MAX_PENDING_TRIGGERS) {
+	        mvLog(MVLOG_ERROR, "Pending triggers limit must be in [1, %d]", NC_MAX_PENDING_TRIGGERS);
+	        return NC_INVALID_PARAMETERS;
+	    }
+	    maxPendingTriggers = *(int *) data;
+	    break;
 	case NC_RO_API_VER:
 	    mvLog(MVLOG_ERROR, "API version is read-only");
 	    return NC_UNAUTHORIZED;
@@ -1189,6 +1263,10 @@ ncStatus_t ncGlobalGetOption(int option, void *data, unsigned int *dataLength)
 		*(int *) data = mvLogLevel_ncAPI;
 		*dataLength = sizeof(mvLogLevel_ncAPI);
 		break;
+	case NC_RW_MAX_PENDING_TRIGGERS:
+		*(int *) data = maxPendingTriggers;
+		*dataLength = sizeof(maxPendingTriggers);
+		break;
 	case NC_RO_API_VER:
 	    return NC_UNSUPPORTED_FEATURE;
 	    break;
@@ -1429,6 +1507,7 @@ ncStatus_t ncFifoInit(ncFifoType_t type, struct fifoHandle_t** fifo) {
     handle->consumer_cnt = 1; //default consumers
     handle->state = NC_FIFO_INITIALIZED;
     pthread_mutex_init(&handle->fifo_mutex, NULL);
+    pthread_cond_init(&handle->write_slot_cond, NULL);
     handle->consumed_by_graph = 0;
     handle->write_count = 0;
     handle->user_param_in = NULL;
@@ -1438,18 +1517,36 @@ ncStatus_t ncFifoInit(ncFifoType_t type, struct fifoHandle_t** fifo) {
     handle->id = fifoIdCounter++;
     handle->datatype = NC_FIFO_FP16;
     handle->num_elements = 0;
+    handle->output_data = NULL;
+    handle->write_staging = NULL;
+    handle->write_tokens = NULL;
+    handle->write_slot_held = NULL;
+    handle->write_index = 0;
+    handle->read_index = 0;
+    handle->borrowed_count = 0;
+    handle->user_param_free = NULL;
     snprintf(handle->name, 16, "FIFO%d", handle->id);
     return NC_OK;
 }
 
+// Takes a node from the FIFO free list, allocates only if more elements are in flight than preallocated
+static struct _userParamPrivate_t* allocUserParam(struct _fifoPrivate_t* fH)
+{
+    struct _userParamPrivate_t* node = fH->user_param_free;
+    if (!node)
+        return calloc(1, sizeof(struct _userParamPrivate_t));
+    fH->user_param_free = node->next;
+    memset(node, 0, sizeof(*node));
+    return node;
+}
 int pushUserParam(struct _fifoPrivate_t* fH, void* user_param, int isIn)
 {
-    struct _userParamPrivate_t* new_user_param = calloc(1, sizeof(struct _userParamPrivate_t));
-    new_user_param->next = NULL;
+    struct _userParamPrivate_t* new_user_param = allocUserParam(fH);
     if (!new_user_param) {
         mvLog(MVLOG_ERROR, "calloc failed!");
         return NC_OUT_OF_MEMORY;
     }
+    new_user_param->next = NULL;
     new_user_param->data = user_param;
     if (isIn) {
         new_user_param->next = fH->user_param_in;
@@ -1461,6 +1558,13 @@ int pushUserParam(struct _fifoPrivate_t* fH, void* user_param, int isIn)
     }
     return NC_OK;
 }
+static struct _userParamPrivate_t* peekUserParam(struct _fifoPrivate_t* fH, int isIn)
+{
+    struct _userParamPrivate_t* curr = isIn ? fH->user_param_in : fH->user_param_out;
+    while (curr && curr->next != NULL)
+        curr = curr->next;
+    return curr;
+}
 int popUserParam(struct _fifoPrivate_t* fH, void** user_param, int isIn)
 {
     struct _userParamPrivate_t* prev = NULL;
@@ -1482,7 +1586,8 @@ int popUserParam(struct _fifoPrivate_t* fH, void** user_param, int isIn)
         curr = curr->next;
     }
 
-    *user_param = curr->data;
+    if (user_param)
+        *user_param = curr->data;
 
     if (prev)
         prev->next = NULL;
@@ -1492,8 +1597,8 @@ int popUserParam(struct _fifoPrivate_t* fH, void** user_param, int isIn)
         else
             fH->user_param_out = NULL;
     }
-    free(curr);
-    curr = NULL;
+    curr->next = fH->user_param_free;
+    fH->user_param_free = curr;
     return NC_OK;
 }
 
@@ -1531,6 +1636,23 @@ ncStatus_t ncFifoCreate(struct fifoHandle_t* fifo, struct deviceHandle_t* device
     //TODO: for now, hardcode to sizeof(fp16), since tensor_descs don't yet have correct dimensions
     int sizeof_td_dt = 2; //tensor_desc->totalSize / (tensor_desc->n * tensor_desc->c * tensor_desc->w * tensor_desc->h);
     handle->output_data = calloc(1, tensor_desc->totalSize * numElem * sizeof(float) / sizeof_td_dt);	// allocate space for fp32
+    if (!handle->output_data)
+        goto out_of_memory;
+    if (fifoWriteAccess(handle)) {
+        handle->write_staging = malloc(tensor_desc->totalSize * numElem);
+        handle->write_tokens = calloc(numElem, sizeof(XLinkWriteToken_t));
+        handle->write_slot_held = calloc(numElem, 1);
+        if (!handle->write_staging || !handle->write_tokens || !handle->write_slot_held)
+            goto out_of_memory;
+    }
+    // Preallocate user param nodes for the elements written and triggered
+    for (unsigned int i = 0; i < 2 * numElem; i++) {
+        struct _userParamPrivate_t* node = calloc(1, sizeof(struct _userParamPrivate_t));
+        if (!node)
+            goto out_of_memory;
+        node->next = handle->user_param_free;
+        handle->user_param_free = node;
+    }
     handle->user_param_in = NULL;
     handle->user_param_out = NULL;
     handle->num_elements = numElem;
@@ -1579,7 +1701,7 @@ ncStatus_t ncFifoCreate(struct fifoHandle_t* fifo, struct deviceHandle_t* device
     handle->streamId = streamId;
     pthread_mutex_lock(&d->graph_streamm);
 
-    if (sendGraphMonitorRequest(d->graph_monitor_stream_id, &cmd)) {
+    if (flushTriggerAcks(d) || sendGraphMonitorRequest(d->graph_monitor_stream_id, &cmd)) {
         pthread_mutex_unlock(&d->graph_streamm);
         mvLog(MVLOG_WARN, "can't send command\n");
         return NC_ERROR;
@@ -1594,6 +1716,10 @@ ncStatus_t ncFifoCreate(struct fifoHandle_t* fifo, struct deviceHandle_t* device
     handle->state = NC_FIFO_CREATED;
     return NC_OK;
 
+out_of_memory:
+    mvLog(MVLOG_ERROR, "Memory allocation failed");
+    freeFifoBuffers(handle);
+    return NC_OUT_OF_MEMORY;
 }
 
 ncStatus_t ncFifoDelete(struct fifoHandle_t* fifo) {
@@ -1623,7 +1749,7 @@ ncStatus_t ncFifoDelete(struct fifoHandle_t* fifo) {
 
     struct _devicePrivate_t *d = handle->dev;
     pthread_mutex_lock(&d->graph_streamm);
-    if (sendGraphMonitorRequest(d->graph_monitor_stream_id, &cmd)) {
+    if (flushTriggerAcks(d) || sendGraphMonitorRequest(d->graph_monitor_stream_id, &cmd)) {
         pthread_mutex_unlock(&d->graph_streamm);
         mvLog(MVLOG_WARN, "can't send command\n");
         return NC_ERROR;
@@ -1648,6 +1774,15 @@ ncStatus_t ncFifoDelete(struct fifoHandle_t* fifo) {
 
 }
 
+// Called by XLink when a write of the FIFO is done, a failure is reported by the trigger taking the element
+static void fifoWriteComplete(streamId_t streamId, XLinkWriteToken_t token,
+                              XLinkError_t status, void* userData) {
+    struct _fifoPrivate_t* handle = (struct _fifoPrivate_t*) userData;
+    if (status != X_LINK_SUCCESS) {
+        mvLog(MVLOG_ERROR, "write %u to FIFO %s failed %d\n", token, handle->name, status);
+    }
+}
+
 ncStatus_t ncFifoWriteElem(struct fifoHandle_t* fifo, const void *inputTensor,
                            struct ncTensorDescriptor_t *inputDesc, void *userParam) {
     if (!fifo)
@@ -1656,6 +1791,9 @@ ncStatus_t ncFifoWriteElem(struct fifoHandle_t* fifo, const void *inputTensor,
     if (!fifoWriteAccess(handle)) {
         return NC_UNAUTHORIZED;
     }
+    if (handle->state != NC_FIFO_CREATED) {
+        return NC_UNAUTHORIZED;
+    }
     //default to the FIFO descriptor
     if (inputDesc == NULL){
         inputDesc = &handle->tensor_desc;
@@ -1664,29 +1802,46 @@ ncStatus_t ncFifoWriteElem(struct fifoHandle_t* fifo, const void *inputTensor,
         return NC_INVALID_PARAMETERS; // the tensor size given is bigger than the size supported by the FIFOs
     }
     unsigned int inputTensorLength = inputDesc->totalSize;
-    // Convert fp32 to fp16
+    // The tensor goes to the next staging slot and is sent from there asynchronously,
+    // so the caller can reuse its buffer right away. The slot is free once the write
+    // sent from it num_elements writes ago is done, the device FIFO can't hold more.
+    // With more concurrent writers than slots, a writer waits for the one holding its slot
+    // to store the token of its write.
+    pthread_mutex_lock(&handle->fifo_mutex);
+    unsigned int slot = handle->write_index++ % handle->num_elements;
+    while (handle->write_slot_held[slot])
+        pthread_cond_wait(&handle->write_slot_cond, &handle->fifo_mutex);
+    handle->write_slot_held[slot] = 1;
+    XLinkWriteToken_t prevToken = handle->write_tokens[slot];
+    pthread_mutex_unlock(&handle->fifo_mutex);
+    if (prevToken)
+        XLinkWaitWrite(handle->streamId, prevToken); // its status is checked by the trigger taking the element
+    unsigned char *staged = (unsigned char *)handle->write_staging + slot * handle->tensor_desc.totalSize;
     if (handle->datatype == NC_FIFO_FP32){
-        unsigned char *inputTensorFP16 = malloc(inputTensorLength);
         //TODO: for now, hardcode to sizeof(fp16), since tensor_descs don't yet have correct dimensions
         int sizeof_td_dt = 2; //inputDesc->totalSize / (inputDesc->n * inputDesc->c * inputDesc->w * inputDesc->h);
         unsigned int cnt = inputTensorLength / sizeof_td_dt;
-        floattofp16(inputTensorFP16, (float *)inputTensor, cnt);
-        inputTensor = (void *)inputTensorFP16;
+        floattofp16(staged, (float *)inputTensor, cnt);
+    } else {
+        memcpy(staged, inputTensor, inputTensorLength);
     }
-    if(XLinkWriteData(handle->streamId, inputTensor, inputTensorLength) != 0 )
-    {
-        if (handle->datatype == NC_FIFO_FP32)
-            free(inputTensor);
+    XLinkWriteToken_t token = 0;
+    int sent = XLinkAsyncWriteData(handle->streamId, staged, inputTensorLength,
+                                   fifoWriteComplete, handle, &token) == X_LINK_SUCCESS;
+    pthread_mutex_lock(&handle->fifo_mutex);
+    handle->write_tokens[slot] = sent ? token : 0;
+    handle->write_slot_held[slot] = 0;
+    pthread_cond_broadcast(&handle->write_slot_cond);
+    if (!sent) {
+        pthread_mutex_unlock(&handle->fifo_mutex);
         return NC_ERROR;
     }
-    if (handle->datatype == NC_FIFO_FP32)
-        free(inputTensor);
-    pthread_mutex_lock(&handle->fifo_mutex);
     int rc = pushUserParam(handle, userParam , 1);
     if(rc != NC_OK) {
         pthread_mutex_unlock(&handle->fifo_mutex);
         return rc;
     }
+    handle->user_param_in->write_token = token;
     handle->write_count++;
     pthread_mutex_unlock(&handle->fifo_mutex);
 
@@ -1696,34 +1851,55 @@ ncStatus_t ncFifoWriteElem(struct fifoHandle_t* fifo, const void *inputTensor,
 
 }
 
-ncStatus_t ncFifoReadElem(struct fifoHandle_t* fifo, void **outputData,
-                          struct ncTensorDescriptor_t *outputDesc, void **userParam) {
-    if (!fifo || !outputData || !outputDesc)
-        return NC_INVALID_PARAMETERS;
+// Size of the element in the FIFO data type
+static unsigned int fifoElemSize(struct _fifoPrivate_t* handle) {
+    //TODO: for now, hardcode to sizeof(fp16), since tensor_descs don't yet have correct dimensions
+    int sizeof_td_dt = 2;
+    if (handle->datatype == NC_FIFO_FP32)
+        return handle->tensor_desc.totalSize * sizeof(float) / sizeof_td_dt;
+    return handle->tensor_desc.totalSize;
+}
 
-    struct _fifoPrivate_t* handle = fifo->private_data;
-    streamPacketDesc_t * packet;
+// Waits for the next element and returns its packet. The packet must be released with XLinkReleaseData
+// and the read finished with fifoCompleteRead.
+static ncStatus_t fifoReadPacket(struct _fifoPrivate_t* handle, streamPacketDesc_t** packet,
+                                 void** userParam) {
     if (!fifoReadAccess(handle)){
         return NC_UNAUTHORIZED;
     }
     if (handle->api_read_element != 0){
         return NC_UNAUTHORIZED;
     }
-    if (!XLinkReadData(handle->streamId, &packet))
-    {
-        // Convert fp16 to fp32
-        if (handle->datatype == NC_FIFO_FP32){
-            // TODO: for now, hardcode to sizeof(fp16), since tensor_descs don't yet have correct dimensions
-            int sizeof_td_dt = 2; //outputDesc->totalSize / (outputDesc->n * outputDesc->c * outputDesc->w * outputDesc->h);
-            int cnt = packet->length / sizeof_td_dt;
-            fp16tofloat(handle->output_data, (unsigned char *)packet->data, cnt);
-        }else{
-            //TODO: memcpy for now, not needed in future
-            memcpy(handle->output_data,packet->data, packet->length); //TODO: may need to keep track of the elements and give different memory each time
-       }
-        XLinkReleaseData(handle->streamId);
+    // The element can't be read before the ack of its trigger, a failed trigger produces no data.
+    // The element is only used with both locks held (in the graph_streamm -> fifo_mutex order of
+    // ncGraphQueueInference), a concurrent read or the FIFO deallocation may free it otherwise
+    struct _devicePrivate_t *d = handle->dev;
+    pthread_mutex_lock(&d->graph_streamm);
+    pthread_mutex_lock(&handle->fifo_mutex);
+    struct _userParamPrivate_t* elem = peekUserParam(handle, 0);
+    if (elem) {
+        if (elem->trigger_pending && waitTriggerAck(d, elem->trigger_seq)) {
+            pthread_mutex_unlock(&handle->fifo_mutex);
+            pthread_mutex_unlock(&d->graph_streamm);
+            return NC_ERROR;
+        }
+        ncStatus_t triggerStatus = elem->trigger_status;
+        if (triggerStatus != NC_OK) {
+            popUserParam(handle, userParam, 0);
+            pthread_mutex_unlock(&handle->fifo_mutex);
+            pthread_mutex_unlock(&d->graph_streamm);
+            return triggerStatus;
+        }
+    }
+    pthread_mutex_unlock(&handle->fifo_mutex);
+    pthread_mutex_unlock(&d->graph_streamm);
+    if (XLinkReadData(handle->streamId, packet)) {
+        return NC_ERROR;
     }
+    return NC_OK;
+}
 
+static void fifoCompleteRead(struct _fifoPrivate_t* handle, void** userParam) {
     //As user should see an API read to be the same as Graph read, we need to wirte the element in 2 queues.
     //if we read it here, we will need to remove the element on the device side
     //to avoid sending a message just for this purpose, we can send it at the next trigger which touches this FIFO.
@@ -1740,8 +1916,44 @@ ncStatus_t ncFifoReadElem(struct fifoHandle_t* fifo, void **outputData,
     }
     popUserParam(handle, userParam ,0);
     pthread_mutex_unlock(&handle->fifo_mutex);
+}
+
+// Converts fp16 packet to the FIFO data type
+static void fifoCopyPacket(struct _fifoPrivate_t* handle, void* dst, streamPacketDesc_t* packet) {
+    if (handle->datatype == NC_FIFO_FP32){
+        //TODO: for now, hardcode to sizeof(fp16), since tensor_descs don't yet have correct dimensions
+        int sizeof_td_dt = 2;
+        fp16tofloat(dst, packet->data, packet->length / sizeof_td_dt);
+    } else {
+        memcpy(dst, packet->data, packet->length);
+    }
+}
+
+ncStatus_t ncFifoReadElem(struct fifoHandle_t* fifo, void **outputData,
+                          struct ncTensorDescriptor_t *outputDesc, void **userParam) {
+    if (!fifo || !outputData || !outputDesc)
+        return NC_INVALID_PARAMETERS;
+
+    struct _fifoPrivate_t* handle = fifo->private_data;
+    streamPacketDesc_t * packet;
+    if (handle->borrowed_count != 0){
+        return NC_UNAUTHORIZED; // XLink releases the packets in order
+    }
+    ncStatus_t rc = fifoReadPacket(handle, &packet, userParam);
+    if (rc != NC_OK)
+        return rc;
+
+    // Each read returns the next slot, the result stays valid for num_elements reads
+    pthread_mutex_lock(&handle->fifo_mutex);
+    unsigned int slot = handle->read_index++ % handle->num_elements;
+    pthread_mutex_unlock(&handle->fifo_mutex);
+    void* output = (char*)handle->output_data + slot * fifoElemSize(handle);
+    fifoCopyPacket(handle, output, packet);
+    XLinkReleaseData(handle->streamId);
+
+    fifoCompleteRead(handle, userParam);
 
-    *outputData = handle->output_data;
+    *outputData = output;
     *outputDesc = handle->tensor_desc;
     mvLog(MVLOG_DEBUG, "num_elements %d userparam %p output length %d\n",
             handle->num_elements,  userParam, outputDesc->totalSize);
@@ -1749,6 +1961,70 @@ ncStatus_t ncFifoReadElem(struct fifoHandle_t* fifo, void **outputData,
 
 }
 
+ncStatus_t ncFifoReadElemToBuffer(struct fifoHandle_t* fifo, void *outputData,
+                                  unsigned int outputLength, void **userParam) {
+    if (!fifo || !outputData)
+        return NC_INVALID_PARAMETERS;
+
+    struct _fifoPrivate_t* handle = fifo->private_data;
+    streamPacketDesc_t * packet;
+    if (outputLength < fifoElemSize(handle)){
+        return NC_INVALID_PARAMETERS;
+    }
+    if (handle->borrowed_count != 0){
+        return NC_UNAUTHORIZED; // XLink releases the packets in order
+    }
+    ncStatus_t rc = fifoReadPacket(handle, &packet, userParam);
+    if (rc != NC_OK)
+        return rc;
+
+    fifoCopyPacket(handle, outputData, packet);
+    XLinkReleaseData(handle->streamId);
+
+    fifoCompleteRead(handle, userParam);
+    return NC_OK;
+}
+
+ncStatus_t ncFifoBorrowElem(struct fifoHandle_t* fifo, void **outputData,
+                            unsigned int *outputLength, void **userParam) {
+    if (!fifo || !outputData || !outputLength)
+        return NC_INVALID_PARAMETERS;
+
+    struct _fifoPrivate_t* handle = fifo->private_data;
+    streamPacketDesc_t * packet;
+    ncStatus_t rc = fifoReadPacket(handle, &packet, userParam);
+    if (rc != NC_OK)
+        return rc;
+
+    pthread_mutex_lock(&handle->fifo_mutex);
+    handle->borrowed_count++;
+    pthread_mutex_unlock(&handle->fifo_mutex);
+
+    fifoCompleteRead(handle, userParam);
+
+    *outputData = packet->data;
+    *outputLength = packet->length;
+    return NC_OK;
+}
+
+ncStatus_t ncFifoReleaseElem(struct fifoHandle_t* fifo) {
+    if (!fifo)
+        return NC_INVALID_PARAMETERS;
+
+    struct _fifoPrivate_t* handle = fifo->private_data;
+    pthread_mutex_lock(&handle->fifo_mutex);
+    if (handle->borrowed_count == 0){
+        pthread_mutex_unlock(&handle->fifo_mutex);
+        return NC_UNAUTHORIZED;
+    }
+    handle->borrowed_count--;
+    pthread_mutex_unlock(&handle->fifo_mutex);
+
+    if (XLinkReleaseData(handle->streamId) != 0)
+        return NC_ERROR;
+    return NC_OK;
+}
+
 ncStatus_t ncFifoRemoveElem(struct fifoHandle_t* fifo) {
     if (!fifo)
         return NC_INVALID_PARAMETERS;
@@ -1885,86 +2161,222 @@ static ncStatus_t tensorCompatibility(struct ncTensorDescriptor_t* tens1,
     return NC_OK;
 }
 
+// Checks the FIFOs of one side of a trigger against the graph tensors
+static ncStatus_t checkTriggerFifos(struct fifoHandle_t** fifos, int count,
+                                    struct ncTensorDescriptor_t* graphDesc, int isIn) {
+    for (int i = 0; i < count; i++) {
+        if (!fifos[i] || !fifos[i]->private_data)
+            return NC_INVALID_PARAMETERS;
+        struct _fifoPrivate_t* f = fifos[i]->private_data;
+        if (f->state != NC_FIFO_CREATED)
+            return NC_ERROR; //TODO: could add specific error code
+        //WO fifos have no graph access
+        if (!isIn && f->type == NC_FIFO_HOST_WO){
+            //graphs have no access to one of the fifos
+            return NC_INVALID_PARAMETERS;
+        }
+        if (tensorCompatibility(&f->tensor_desc, &graphDesc[i]) != NC_OK) {
+            mvLog(MVLOG_WARN, "%s %d tensor shape is not compatible with graph", isIn ? "Input" : "Output", i);
+            return NC_ERROR; //TODO: should add specific error code
+        }
+        if (i > 0) {
+            // The other FIFOs have narrower fields in the trigger command
+            if (f->id > UINT16_MAX || f->api_read_adjust > UINT8_MAX) {
+                mvLog(MVLOG_WARN, "%s FIFO %d can't be referenced by a multi tensor trigger", isIn ? "Input" : "Output", i);
+                return NC_UNSUPPORTED_FEATURE;
+            }
+        }
+    }
+    return NC_OK;
+}
+
+// Takes the current element of an input FIFO for the graph
+static void consumeTriggerInput(struct _fifoPrivate_t* fi, void** user_param) {
+    fi->consumers_remaining--;
+    if (fi->consumer_cnt == 0) {
+        if (!fi->api_read_element && fifoReadAccess(fi)) {//the element was entirely consumed by graphs. This means we need to free it up from XLink
+            streamPacketDesc_t* packet;
+            XLinkReadData(fi->streamId, &packet);
+            XLinkReleaseData(fi->streamId);
+        }
+        fi->consumers_remaining = fi->consumer_cnt;
+        fi->api_read_element = 0;
+    }
+    popUserParam(fi, user_param , 1);
+    fi->consumed_by_graph++;
+}
+
 ncStatus_t ncGraphQueueInference(struct graphHandle_t *graphHandle,
                             struct fifoHandle_t** fifoIn,
                             struct fifoHandle_t** fifoOut) {
     mvLog(MVLOG_INFO, "trigger start\n");
-    if (!graphHandle || !fifoIn || !fifoIn[0] || !fifoOut || !fifoOut[0])
+    if (!graphHandle || !graphHandle->private_data || !fifoIn || !fifoOut)
         return NC_INVALID_PARAMETERS;
-    struct _fifoPrivate_t* fi = fifoIn[0]->private_data;
-    struct _fifoPrivate_t* fo = fifoOut[0]->private_data;
     struct _graphPrivate_t * g = graphHandle->private_data;
-    ncStatus_t rc;
-    if (fi->state != NC_FIFO_CREATED|| fo->state != NC_FIFO_CREATED)
-        return NC_ERROR; //TODO: could add specific error code
-    //WO fifos have no graph access
-    if (fo->type == NC_FIFO_HOST_WO){
-        //graphs have no access to one of the fifos
-        return NC_INVALID_PARAMETERS;
-    }
+    // fifoIn and fifoOut hold one FIFO per graph input and output
+    int inputCount = g->input_count;
+    int outputCount = g->output_count;
+    if (inputCount < 1 || outputCount < 1)
+        return NC_NOT_ALLOCATED;
+    ncStatus_t rc = checkTriggerFifos(fifoIn, inputCount, g->input_tensor_desc, 1);
+    if (rc == NC_OK)
+        rc = checkTriggerFifos(fifoOut, outputCount, g->output_tensor_desc, 0);
+    if (rc != NC_OK)
+        return rc;
 //    if (fi->type == NC_FIFO_HOST_RO && fi->consumer_cnt == 1){
 //        // if the FIFO is read only, and there is only one consumer, that should be XLink. Other FIFO types can be used for this usecase.
 //        return NC_INVALID_PARAMETERS;
 //    }//TODO: we may decide to add this limitation later.
-    if (tensorCompatibility(&fi->tensor_desc, &g->input_tensor_desc) != NC_OK ||
-                    tensorCompatibility(&fo->tensor_desc, &g->output_tensor_desc)!= NC_OK ) {
-        mvLog(MVLOG_WARN, "Input/Output tensor shape is not compatible with graph");
-        return NC_ERROR; //TODO: should add specific error code
-    }
 
     graphMonCommand_t cmd;
+    memset(&cmd, 0, sizeof(cmd));
     cmd.cmdClass = GRAPH_MON_CLASS_GRAPH_CMD;
     cmd.cmd.graphCmd.type = GRAPH_TRIGGER_CMD;
     cmd.cmd.graphCmd.id = g->id;
-    cmd.cmd.graphCmd.buffId1 = fi->id;
-    cmd.cmd.graphCmd.buffId2 = fo->id;
-
-    void* user_param;
-    pthread_mutex_lock(&fi->fifo_mutex);
-    fi->consumers_remaining--;
-    cmd.cmd.graphCmd.releaseElemBuff1 = fi->api_read_adjust;
-    fi->api_read_adjust = 0;
-    if (fi->consumer_cnt == 0) {
-        if (!fi->api_read_element && fifoReadAccess(fi)) {//the element was entirely consumed by graphs. This means we need to free it up from XLink
-            streamPacketDesc_t* packet;
-            XLinkReadData(fi->streamId, &packet);
-            XLinkReleaseData(fi->streamId);
+    cmd.cmd.graphCmd.buffId1 = ((struct _fifoPrivate_t*) fifoIn[0]->private_data)->id;
+    cmd.cmd.graphCmd.buffId2 = ((struct _fifoPrivate_t*) fifoOut[0]->private_data)->id;
+    if (inputCount > 1 || outputCount > 1) {
+        cmd.cmd.graphCmd.inputCount = inputCount;
+        cmd.cmd.graphCmd.outputCount = outputCount;
+        for (int i = 1; i < inputCount; i++)
+            cmd.cmd.graphCmd.buffIdExt[i - 1] = ((struct _fifoPrivate_t*) fifoIn[i]->private_data)->id;
+        for (int i = 1; i < outputCount; i++)
+            cmd.cmd.graphCmd.buffIdExt[inputCount + i - 2] = ((struct _fifoPrivate_t*) fifoOut[i]->private_data)->id;
+    }
+
+    // Every input must have an element, the user param of the first input goes to the outputs
+    for (int i = 0; i < inputCount; i++) {
+        struct _fifoPrivate_t* fi = fifoIn[i]->private_data;
+        pthread_mutex_lock(&fi->fifo_mutex);
+        int empty = fi->write_count <= fi->consumed_by_graph;
+        pthread_mutex_unlock(&fi->fifo_mutex);
+        if (empty) {
+            mvLog(MVLOG_WARN, "No point on triggering graph. There are no more elements in the input FIFO %d", i);
+            return NC_UNAUTHORIZED;
         }
-        fi->consumers_remaining = fi->consumer_cnt;
-        fi->api_read_element = 0;
     }
-    popUserParam(fi, &user_param , 1);
-    if (fi->write_count <= fi->consumed_by_graph){
-        mvLog(MVLOG_WARN, "No point on triggering graph. There are no more elements in the input FIFO");
+    struct _devicePrivate_t *d = g->dev;
+    pthread_mutex_lock(&d->graph_streamm);
+
+    // The input writes are queued to XLink before the trigger, so they reach the device first.
+    // If the write of an element failed, only this trigger fails: its elements are dropped from every input,
+    // the ones on the device are released by the next trigger of their FIFO with the API reads
+    int writeFailed[NC_MAX_GRAPH_TENSORS] = {0};
+    int anyWriteFailed = 0;
+    for (int i = 0; i < inputCount; i++) {
+        struct _fifoPrivate_t* fi = fifoIn[i]->private_data;
+        pthread_mutex_lock(&fi->fifo_mutex);
+        struct _userParamPrivate_t* elem = peekUserParam(fi, 1);
+        XLinkWriteToken_t token = elem ? elem->write_token : 0;
         pthread_mutex_unlock(&fi->fifo_mutex);
-        return NC_UNAUTHORIZED;
+        if (token && XLinkWaitWrite(fi->streamId, token) != X_LINK_SUCCESS) {
+            mvLog(MVLOG_ERROR, "Writing the element of the input FIFO %d failed", i);
+            writeFailed[i] = anyWriteFailed = 1;
+        }
+    }
+    if (anyWriteFailed) {
+        for (int i = 0; i < inputCount; i++) {
+            struct _fifoPrivate_t* fi = fifoIn[i]->private_data;
+            pthread_mutex_lock(&fi->fifo_mutex);
+            popUserParam(fi, NULL, 1);
+            fi->write_count--;
+            if (!writeFailed[i])
+                fi->api_read_adjust++;
+            pthread_mutex_unlock(&fi->fifo_mutex);
+        }
+        pthread_mutex_unlock(&d->graph_streamm);
+        return NC_ERROR;
     }
-    fi->consumed_by_graph++;
-    pthread_mutex_unlock(&fi->fifo_mutex);
 
-    pthread_mutex_lock(&fo->fifo_mutex);
-    cmd.cmd.graphCmd.releaseElemBuff2 = fo->api_read_adjust;
-    fo->api_read_adjust = 0;
-    rc = pushUserParam(fo, user_param , 0);
-    if(rc != NC_OK) {
-        pthread_mutex_unlock(&fo->fifo_mutex);
-        return rc;
+    // Keep at most maxPendingTriggers in flight, the acks are collected here or by ncFifoReadElem.
+    // The inputs are taken only once the trigger has a slot, so a failure leaves them queued
+    if (waitTriggerAck(d, d->trigger_seq_sent + 1 - maxPendingTriggers)) {
+        pthread_mutex_unlock(&d->graph_streamm);
+        return NC_ERROR;
     }
-    fo->write_count++;
-    pthread_mutex_unlock(&fo->fifo_mutex);
 
-    pthread_mutex_lock(&g->dev->graph_streamm);
+    void* user_param = NULL;
+    for (int i = 0; i < inputCount; i++) {
+        struct _fifoPrivate_t* fi = fifoIn[i]->private_data;
+        void* input_param;
+        pthread_mutex_lock(&fi->fifo_mutex);
+        if (i == 0)
+            cmd.cmd.graphCmd.releaseElemBuff1 = fi->api_read_adjust;
+        else
+            cmd.cmd.graphCmd.releaseElemExt[i - 1] = fi->api_read_adjust;
+        fi->api_read_adjust = 0;
+        consumeTriggerInput(fi, &input_param);
+        pthread_mutex_unlock(&fi->fifo_mutex);
+        if (i == 0)
+            user_param = input_param;
+    }
+
+    uint32_t seq = d->trigger_seq_sent + 1;
+    cmd.cmd.graphCmd.seqNo = seq;
+
+    // The output elements of the trigger are chained, the first one is kept in pending_triggers
+    struct _userParamPrivate_t *outElem = NULL;
+    struct _userParamPrivate_t **outTail = &outElem;
+    int outputsTaken = 0;
+    for (int i = 0; i < outputCount && rc == NC_OK; i++, outputsTaken++) {
+        struct _fifoPrivate_t* fo = fifoOut[i]->private_data;
+        pthread_mutex_lock(&fo->fifo_mutex);
+        if (i == 0)
+            cmd.cmd.graphCmd.releaseElemBuff2 = fo->api_read_adjust;
+        else
+            cmd.cmd.graphCmd.releaseElemExt[inputCount + i - 2] = fo->api_read_adjust;
+        fo->api_read_adjust = 0;
+        rc = pushUserParam(fo, user_param , 0);
+        if (rc == NC_OK) {
+            *outTail = fo->user_param_out;
+            outTail = &fo->user_param_out->trigger_next;
+            fo->write_count++;
+        }
+        pthread_mutex_unlock(&fo->fifo_mutex);
+    }
 
-    if(sendGraphMonitorRequest(g->dev->graph_monitor_stream_id, &cmd)) {
-        pthread_mutex_unlock(&g->dev->graph_streamm);
+    if (rc == NC_OK && sendGraphMonitorRequest(d->graph_monitor_stream_id, &cmd)) {
         mvLog(MVLOG_WARN, "Can't send trigger request");
-        return NC_ERROR;
+        rc = NC_ERROR;
+    }
+    if (rc != NC_OK) {
+        // The inputs taken stay on the device, the next trigger of each input FIFO releases them
+        // with the API reads the command carried
+        for (int i = 0; i < inputCount; i++) {
+            struct _fifoPrivate_t* fi = fifoIn[i]->private_data;
+            pthread_mutex_lock(&fi->fifo_mutex);
+            fi->api_read_adjust += 1 + (i == 0 ? cmd.cmd.graphCmd.releaseElemBuff1 :
+                                                 cmd.cmd.graphCmd.releaseElemExt[i - 1]);
+            pthread_mutex_unlock(&fi->fifo_mutex);
+        }
+        // A failed call queues no output element, the ones already pushed are the newest of their FIFOs.
+        // The readers take graph_streamm before looking at them
+        struct _userParamPrivate_t *elem = outElem;
+        for (int i = 0; i < outputsTaken; i++) {
+            struct _fifoPrivate_t* fo = fifoOut[i]->private_data;
+            pthread_mutex_lock(&fo->fifo_mutex);
+            fo->api_read_adjust += i == 0 ? cmd.cmd.graphCmd.releaseElemBuff2 :
+                                            cmd.cmd.graphCmd.releaseElemExt[inputCount + i - 2];
+            if (elem) {
+                struct _userParamPrivate_t *next = elem->trigger_next;
+                fo->user_param_out = elem->next;
+                elem->next = fo->user_param_free;
+                fo->user_param_free = elem;
+                fo->write_count--;
+                elem = next;
+            }
+            pthread_mutex_unlock(&fo->fifo_mutex);
+        }
+        pthread_mutex_unlock(&d->graph_streamm);
+        return rc;
     }
-    if(checkGraphMonitorResponse(g->dev->graph_monitor_stream_id)) {
-        pthread_mutex_unlock(&g->dev->graph_streamm);
-        return NC_ERROR;
+    for (struct _userParamPrivate_t *elem = outElem; elem; elem = elem->trigger_next) {
+        elem->trigger_seq = seq;
+        elem->trigger_pending = 1;
     }
-    pthread_mutex_unlock(&g->dev->graph_streamm);
+    d->pending_triggers[seq % NC_MAX_PENDING_TRIGGERS] = outElem;
+    d->trigger_seq_sent = seq;
+    pthread_mutex_unlock(&d->graph_streamm);
 
     mvLog(MVLOG_INFO, "trigger end\n");
     return NC_OK;
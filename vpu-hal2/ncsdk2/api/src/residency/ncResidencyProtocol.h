@@ -0,0 +1,77 @@
+/*
+* Copyright 2017 Intel Corporation.
+* The source code, information and material ("Material") contained herein is
+* owned by Intel Corporation or its suppliers or licensors, and title to such
+* Material remains with Intel Corporation or its suppliers or licensors.
+* The Material contains proprietary information of Intel or its suppliers and
+* licensors. The Material is protected by worldwide copyright laws and treaty
+* provisions.
+* No part of the Material may be used, copied, reproduced, modified, published,
+* uploaded, posted, transmitted, distributed or disclosed in any way without
+* Intel's prior express written permission. No license under any patent,
+* copyright or other intellectual property rights in the Material is granted to
+* or conferred upon you, either expressly, by implication, inducement, estoppel
+* or otherwise.
+* Any license under such intellectual property rights must be express and
+* approved by Intel in writing.
+*/
+
+
+///
+/// @brief     Messages between ncs_residencyd and its clients
+///
+/// A client connection holds one attachment:
+///   client ATTACH (SHA-256 digest and size of the graph file)
+///   daemon NEED_BLOB if the graph is not resident, client BLOB followed by the file
+///   daemon ATTACHED with the shared memory fd, or ATTACHED with an error status
+///   client INFER, daemon DONE, in order, up to the number of slots in flight
+/// Closing the connection detaches.
+///
+#ifndef _NC_RESIDENCY_PROTOCOL_H_
+#define _NC_RESIDENCY_PROTOCOL_H_
+#include <stdint.h>
+#include <stddef.h>
+#include "ncResidency.h"
+
+#define NC_RESIDENCY_DIGEST_SIZE 32
+
+typedef enum {
+    NC_RESIDENCY_ATTACH = 1,
+    NC_RESIDENCY_BLOB = 2,
+    NC_RESIDENCY_INFER = 3,
+    NC_RESIDENCY_NEED_BLOB = 4,
+    NC_RESIDENCY_ATTACHED = 5,
+    NC_RESIDENCY_DONE = 6,
+} ncResidencyMessageType_t;
+
+typedef struct {
+    uint32_t type;
+    int32_t status;             // ATTACHED, DONE
+    uint8_t digest[NC_RESIDENCY_DIGEST_SIZE];  // ATTACH
+    uint32_t blobSize;          // ATTACH, BLOB
+    uint32_t slots;             // ATTACH, ATTACHED
+    uint32_t dataType;          // ATTACH
+    uint32_t slot;              // INFER, DONE
+    // ATTACHED: the tensors of slot i are at i * slotSize + offsets[k] in the shared
+    // memory, the inputs first
+    uint32_t resident;
+    uint32_t deviceIndex;
+    uint32_t inputCount;
+    uint32_t outputCount;
+    uint32_t slotSize;
+    uint32_t offsets[2 * NC_RESIDENCY_MAX_TENSORS];
+    struct ncTensorDescriptor_t descs[2 * NC_RESIDENCY_MAX_TENSORS];
+} ncResidencyMessage_t;
+
+// SHA-256 of the graph file, graphs are looked up by digest and size. The digest stands for the
+// file: a client attaches to a resident graph without sending it, so it must not collide.
+void ncResidencyDigest(const void* data, size_t size, uint8_t digest[NC_RESIDENCY_DIGEST_SIZE]);
+
+// Size of a tensor in the shared memory, the FIFOs convert FP32 to the FP16 of the graph
+static inline uint32_t ncResidencyTensorSize(const struct ncTensorDescriptor_t* desc,
+                                             uint32_t dataType)
+{
+    return dataType == NC_FIFO_FP32 ? desc->totalSize * 2 : desc->totalSize;
+}
+
+#endif
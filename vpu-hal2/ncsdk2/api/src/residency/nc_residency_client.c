@@ -0,0 +1,259 @@
+/*
+* Copyright 2017 Intel Corporation.
+* The source code, information and material ("Material") contained herein is
+* owned by Intel Corporation or its suppliers or licensors, and title to such
+* Material remains with Intel Corporation or its suppliers or licensors.
+* The Material contains proprietary information of Intel or its suppliers and
+* licensors. The Material is protected by worldwide copyright laws and treaty
+* provisions.
+* No part of the Material may be used, copied, reproduced, modified, published,
+* uploaded, posted, transmitted, distributed or disclosed in any way without
+* Intel's prior express written permission. No license under any patent,
+* copyright or other intellectual property rights in the Material is granted to
+* or conferred upon you, either expressly, by implication, inducement, estoppel
+* or otherwise.
+* Any license under such intellectual property rights must be express and
+* approved by Intel in writing.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "ncResidency.h"
+#include "ncResidencyProtocol.h"
+
+#define MVLOG_UNIT_NAME ncResidency
+#include "mvLog.h"
+
+struct ncResidencyGraph_t {
+    int sock;
+    uint8_t* shm;
+    size_t shmSize;
+    uint32_t slotSize;
+    uint32_t offsets[2 * NC_RESIDENCY_MAX_TENSORS];
+    ncResidencyGraphInfo_t info;
+};
+
+static int sendAll(int sock, const void* data, size_t size)
+{
+    const char* src = (const char*)data;
+    while (size > 0) {
+        ssize_t rc = send(sock, src, size, MSG_NOSIGNAL);
+        if (rc < 0 && errno == EINTR)
+            continue;
+        if (rc <= 0)
+            return -1;
+        src += rc;
+        size -= rc;
+    }
+    return 0;
+}
+
+// Receives a message and the fd passed with it, if any
+static int recvMessage(int sock, ncResidencyMessage_t* msg, int* fd)
+{
+    char control[CMSG_SPACE(sizeof(int))];
+    char* dst = (char*)msg;
+    size_t size = sizeof(*msg);
+    if (fd)
+        *fd = -1;
+    while (size > 0) {
+        struct iovec iov = { dst, size };
+        struct msghdr hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        hdr.msg_iov = &iov;
+        hdr.msg_iovlen = 1;
+        hdr.msg_control = control;
+        hdr.msg_controllen = sizeof(control);
+        ssize_t rc = recvmsg(sock, &hdr, 0);
+        if (rc < 0 && errno == EINTR)
+            continue;
+        if (rc <= 0)
+            return -1;
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+        if (cmsg && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+            int received;
+            memcpy(&received, CMSG_DATA(cmsg), sizeof(received));
+            if (fd && *fd < 0)
+                *fd = received;
+            else
+                close(received);
+        }
+        dst += rc;
+        size -= rc;
+    }
+    return 0;
+}
+
+static int connectDaemon(const char* socketPath, int quiet)
+{
+    if (!socketPath)
+        socketPath = getenv("NC_RESIDENCY_SOCKET");
+    if (!socketPath || !*socketPath)
+        socketPath = NC_RESIDENCY_DEFAULT_SOCKET;
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(addr.sun_path))
+        return -1;
+    strcpy(addr.sun_path, socketPath);
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0)
+        return -1;
+    if (connect(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        if (!quiet)
+            mvLog(MVLOG_ERROR, "Can't connect to %s: %s\n", socketPath, strerror(errno));
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+// Sends ATTACH, and the graph file if the daemon asks for it
+static ncStatus_t attach(ncResidencyGraph_t* g, const void* graphFile,
+                         unsigned int graphFileLength, unsigned int slots,
+                         ncFifoDatatype_t dataType, int* shmFd)
+{
+    ncResidencyMessage_t msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.type = NC_RESIDENCY_ATTACH;
+    ncResidencyDigest(graphFile, graphFileLength, msg.digest);
+    msg.blobSize = graphFileLength;
+    msg.slots = slots;
+    msg.dataType = dataType;
+    if (sendAll(g->sock, &msg, sizeof(msg)) || recvMessage(g->sock, &msg, shmFd))
+        return NC_ERROR;
+    if (msg.type == NC_RESIDENCY_NEED_BLOB) {
+        memset(&msg, 0, sizeof(msg));
+        msg.type = NC_RESIDENCY_BLOB;
+        msg.blobSize = graphFileLength;
+        if (sendAll(g->sock, &msg, sizeof(msg)) ||
+            sendAll(g->sock, graphFile, graphFileLength) ||
+            recvMessage(g->sock, &msg, shmFd))
+            return NC_ERROR;
+    }
+    if (msg.type != NC_RESIDENCY_ATTACHED)
+        return NC_ERROR;
+    if (msg.status != NC_OK)
+        return msg.status;
+    if (*shmFd < 0 || msg.slots != slots ||
+        msg.inputCount > NC_RESIDENCY_MAX_TENSORS || msg.outputCount > NC_RESIDENCY_MAX_TENSORS)
+        return NC_ERROR;
+
+    ncResidencyGraphInfo_t* info = &g->info;
+    info->inputCount = msg.inputCount;
+    info->outputCount = msg.outputCount;
+    memcpy(info->inputs, msg.descs, msg.inputCount * sizeof(msg.descs[0]));
+    memcpy(info->outputs, msg.descs + msg.inputCount, msg.outputCount * sizeof(msg.descs[0]));
+    info->slots = slots;
+    info->dataType = dataType;
+    info->resident = msg.resident;
+    info->deviceIndex = msg.deviceIndex;
+    g->slotSize = msg.slotSize;
+    memcpy(g->offsets, msg.offsets, sizeof(g->offsets));
+    return NC_OK;
+}
+
+int ncResidencyDaemonAvailable(const char* socketPath)
+{
+    int sock = connectDaemon(socketPath, 1);
+    if (sock < 0)
+        return 0;
+    close(sock);
+    return 1;
+}
+
+ncStatus_t ncResidencyAttach(const char* socketPath, const void* graphFile,
+                             unsigned int graphFileLength, unsigned int slots,
+                             ncFifoDatatype_t dataType, ncResidencyGraph_t** graph)
+{
+    if (!graphFile || !graphFileLength || !graph ||
+        slots < 1 || slots > NC_RESIDENCY_MAX_SLOTS ||
+        (dataType != NC_FIFO_FP16 && dataType != NC_FIFO_FP32))
+        return NC_INVALID_PARAMETERS;
+
+    ncResidencyGraph_t* g = calloc(1, sizeof(*g));
+    if (!g)
+        return NC_OUT_OF_MEMORY;
+    g->sock = connectDaemon(socketPath, 0);
+    if (g->sock < 0) {
+        free(g);
+        return NC_DEVICE_NOT_FOUND;
+    }
+    int shmFd = -1;
+    ncStatus_t rc = attach(g, graphFile, graphFileLength, slots, dataType, &shmFd);
+    if (rc == NC_OK) {
+        g->shmSize = (size_t)g->slotSize * slots;
+        g->shm = mmap(NULL, g->shmSize, PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0);
+        if (g->shm == MAP_FAILED) {
+            mvLog(MVLOG_ERROR, "Can't map the tensors: %s\n", strerror(errno));
+            rc = NC_OUT_OF_MEMORY;
+        }
+    }
+    if (shmFd >= 0)
+        close(shmFd);
+    if (rc != NC_OK) {
+        close(g->sock);
+        free(g);
+        return rc;
+    }
+    *graph = g;
+    return NC_OK;
+}
+
+ncStatus_t ncResidencyDetach(ncResidencyGraph_t* graph)
+{
+    if (!graph)
+        return NC_INVALID_PARAMETERS;
+    munmap(graph->shm, graph->shmSize);
+    close(graph->sock);
+    free(graph);
+    return NC_OK;
+}
+
+const ncResidencyGraphInfo_t* ncResidencyGetInfo(ncResidencyGraph_t* graph)
+{
+    return graph ? &graph->info : NULL;
+}
+
+void* ncResidencyInputBuffer(ncResidencyGraph_t* graph, unsigned int slot, unsigned int index)
+{
+    if (!graph || slot >= graph->info.slots || index >= graph->info.inputCount)
+        return NULL;
+    return graph->shm + (size_t)slot * graph->slotSize + graph->offsets[index];
+}
+
+void* ncResidencyOutputBuffer(ncResidencyGraph_t* graph, unsigned int slot, unsigned int index)
+{
+    if (!graph || slot >= graph->info.slots || index >= graph->info.outputCount)
+        return NULL;
+    return graph->shm + (size_t)slot * graph->slotSize +
+           graph->offsets[graph->info.inputCount + index];
+}
+
+ncStatus_t ncResidencyQueueInference(ncResidencyGraph_t* graph, unsigned int slot)
+{
+    if (!graph || slot >= graph->info.slots)
+        return NC_INVALID_PARAMETERS;
+    ncResidencyMessage_t msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.type = NC_RESIDENCY_INFER;
+    msg.slot = slot;
+    return sendAll(graph->sock, &msg, sizeof(msg)) ? NC_ERROR : NC_OK;
+}
+
+ncStatus_t ncResidencyWaitInference(ncResidencyGraph_t* graph, unsigned int* slot)
+{
+    if (!graph || !slot)
+        return NC_INVALID_PARAMETERS;
+    ncResidencyMessage_t msg;
+    if (recvMessage(graph->sock, &msg, NULL) || msg.type != NC_RESIDENCY_DONE)
+        return NC_ERROR;
+    *slot = msg.slot;
+    return msg.status;
+}
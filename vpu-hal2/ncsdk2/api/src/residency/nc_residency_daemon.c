@@ -0,0 +1,925 @@
+/*
+* Copyright 2017 Intel Corporation.
+* The source code, information and material ("Material") contained herein is
+* owned by Intel Corporation or its suppliers or licensors, and title to such
+* Material remains with Intel Corporation or its suppliers or licensors.
+* The Material contains proprietary information of Intel or its suppliers and
+* licensors. The Material is protected by worldwide copyright laws and treaty
+* provisions.
+* No part of the Material may be used, copied, reproduced, modified, published,
+* uploaded, posted, transmitted, distributed or disclosed in any way without
+* Intel's prior express written permission. No license under any patent,
+* copyright or other intellectual property rights in the Material is granted to
+* or conferred upon you, either expressly, by implication, inducement, estoppel
+* or otherwise.
+* Any license under such intellectual property rights must be express and
+* approved by Intel in writing.
+*/
+
+
+///
+/// @brief     Daemon keeping the devices booted and the graphs resident
+///
+///   ncs_residencyd [-s <socket path>] [-n <devices>] [-d <FIFO elements>] [-g <graph file>]...
+///
+/// Boots the devices once and serves the clients of ncResidency.h on a UNIX socket.
+/// The graphs are allocated on the device with the fewest graphs the first time a
+/// client attaches to them, and stay allocated when the clients detach. A device out
+/// of graphs, memory or XLink streams frees its least recently used graph without
+/// attachments. -g allocates graph files at startup.
+/// The socket is only open to the user of the daemon (mode 0600), a client attaches to
+/// a resident graph by the SHA-256 of its file without sending it.
+///
+/// Every resident graph has one FIFO per input and output, shared by its attachments:
+/// a graph and its FIFOs take 1 + inputs + outputs of the USB_LINK_MAX_STREAMS streams
+/// of a link, so a device holds two graphs of one input and one output. The outputs
+/// come in the order of the inferences, the reader thread of the graph copies them to
+/// the slots of the attachments which queued them.
+///
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+
+#include "mvnc.h"
+#include "fp16.h"
+#include "ncResidency.h"
+#include "ncResidencyProtocol.h"
+#include "XLinkPublicDefines.h"
+
+#define MVLOG_UNIT_NAME ncResidencyDaemon
+#include "mvLog.h"
+
+#define DAEMON_MAX_DEVICES 8
+#define DAEMON_MAX_PRELOAD 16
+#define DEVICE_GRAPH_STREAMS (USB_LINK_MAX_STREAMS - 2)  // without the device and graph monitors
+#define GRAPH_MIN_STREAMS 3
+#define GRAPH_MAX_PENDING 256
+#define TENSOR_ALIGNMENT 64
+
+typedef enum {
+    GRAPH_LOADING,
+    GRAPH_READY,
+    GRAPH_FAILED,
+} graphState_t;
+
+typedef struct connection_t connection_t;
+
+typedef struct {
+    connection_t* conn;
+    uint32_t slot;
+} inference_t;
+
+typedef struct residentGraph_t {
+    uint8_t digest[NC_RESIDENCY_DIGEST_SIZE];
+    uint32_t size;
+    char name[20];              // first bytes of the digest in hex, for the logs
+    graphState_t state;
+    ncStatus_t status;          // of the allocation once failed
+    int device;
+    struct graphHandle_t* handle;
+    unsigned int inputCount;
+    unsigned int outputCount;
+    struct ncTensorDescriptor_t descs[2 * NC_RESIDENCY_MAX_TENSORS];
+    struct fifoHandle_t* fifos[2 * NC_RESIDENCY_MAX_TENSORS];  // inputs first, FP16
+    int attachments;
+    double lastUsed;
+    struct residentGraph_t* next;
+
+    // Held from the first input written to the inference pending, keeps the order
+    pthread_mutex_t queueLock;
+    uint8_t* inputStaging;      // FP32 inputs converted to FP16
+    // Guards the pending inferences and the inFlight counts of the attachments
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    inference_t pending[GRAPH_MAX_PENDING];
+    uint32_t queued;
+    uint32_t completed;
+    int stopping;
+    pthread_t reader;
+    uint8_t* outputStaging;
+} residentGraph_t;
+
+typedef struct {
+    struct deviceHandle_t* handle;
+    int graphs;
+    int maxGraphs;
+    int streams;                // of the resident graphs
+} residentDevice_t;
+
+struct connection_t {
+    int sock;
+    pthread_mutex_t sendLock;   // DONE is sent by the reader of the graph
+    residentGraph_t* graph;
+    uint32_t slots;
+    uint32_t dataType;
+    uint32_t slotSize;
+    uint32_t offsets[2 * NC_RESIDENCY_MAX_TENSORS];
+    uint8_t* shm;
+    size_t shmSize;
+    int inFlight;
+};
+
+static residentDevice_t devices[DAEMON_MAX_DEVICES];
+static int deviceCount;
+static int fifoDepth = 4;
+
+// The resident graphs, their references and states
+static residentGraph_t* graphs;
+static pthread_mutex_t cacheLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cacheCond = PTHREAD_COND_INITIALIZER;
+// Allocations and evictions run one at a time, they own the counts of the devices
+static pthread_mutex_t allocLock = PTHREAD_MUTEX_INITIALIZER;
+
+static volatile sig_atomic_t stopping;
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int sendAll(int sock, const void* data, size_t size)
+{
+    const char* src = (const char*)data;
+    while (size > 0) {
+        ssize_t rc = send(sock, src, size, MSG_NOSIGNAL);
+        if (rc < 0 && errno == EINTR)
+            continue;
+        if (rc <= 0)
+            return -1;
+        src += rc;
+        size -= rc;
+    }
+    return 0;
+}
+
+static int recvAll(int sock, void* data, size_t size)
+{
+    char* dst = (char*)data;
+    while (size > 0) {
+        ssize_t rc = recv(sock, dst, size, 0);
+        if (rc < 0 && errno == EINTR)
+            continue;
+        if (rc <= 0)
+            return -1;
+        dst += rc;
+        size -= rc;
+    }
+    return 0;
+}
+
+// Sends the message with the fd attached
+static int sendWithFd(int sock, const ncResidencyMessage_t* msg, int fd)
+{
+    char control[CMSG_SPACE(sizeof(int))];
+    memset(control, 0, sizeof(control));
+    struct iovec iov = { (void*)msg, sizeof(*msg) };
+    struct msghdr hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.msg_iov = &iov;
+    hdr.msg_iovlen = 1;
+    hdr.msg_control = control;
+    hdr.msg_controllen = sizeof(control);
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &fd, sizeof(fd));
+
+    ssize_t rc;
+    do {
+        rc = sendmsg(sock, &hdr, MSG_NOSIGNAL);
+    } while (rc < 0 && errno == EINTR);
+    if (rc < 0)
+        return -1;
+    // the fd went with the first byte, the rest is plain data
+    return sendAll(sock, (const char*)msg + rc, sizeof(*msg) - rc);
+}
+
+static int sendStatus(int sock, ncResidencyMessageType_t type, ncStatus_t status)
+{
+    ncResidencyMessage_t msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.type = type;
+    msg.status = status;
+    return sendAll(sock, &msg, sizeof(msg));
+}
+
+static void sendDone(connection_t* conn, uint32_t slot, ncStatus_t status)
+{
+    ncResidencyMessage_t msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.type = NC_RESIDENCY_DONE;
+    msg.slot = slot;
+    msg.status = status;
+    pthread_mutex_lock(&conn->sendLock);
+    // the client may be gone, the outputs are read anyway
+    sendAll(conn->sock, &msg, sizeof(msg));
+    pthread_mutex_unlock(&conn->sendLock);
+}
+
+// Anonymous file for the tensors of an attachment
+static int createSharedMemory(size_t size)
+{
+    int fd = -1;
+#ifdef SYS_memfd_create
+    fd = syscall(SYS_memfd_create, "ncs_residencyd", 0);
+#endif
+    if (fd < 0) {
+        static const char* dirs[] = { "/dev/shm", "/tmp" };
+        for (unsigned int i = 0; fd < 0 && i < sizeof(dirs) / sizeof(dirs[0]); i++) {
+            char path[64];
+            snprintf(path, sizeof(path), "%s/ncs_residencyd.XXXXXX", dirs[i]);
+            fd = mkstemp(path);
+            if (fd >= 0)
+                unlink(path);
+        }
+    }
+    if (fd >= 0 && ftruncate(fd, size) < 0) {
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+static uint8_t* slotTensor(connection_t* conn, uint32_t slot, unsigned int index)
+{
+    return conn->shm + (size_t)slot * conn->slotSize + conn->offsets[index];
+}
+
+// Reads the outputs of the inferences in flight to the slots which queued them
+static void* readerThread(void* ctx)
+{
+    residentGraph_t* g = (residentGraph_t*)ctx;
+    pthread_mutex_lock(&g->lock);
+    for (;;) {
+        while (g->completed == g->queued && !g->stopping)
+            pthread_cond_wait(&g->cond, &g->lock);
+        if (g->completed == g->queued)
+            break;
+        inference_t inference = g->pending[g->completed % GRAPH_MAX_PENDING];
+        pthread_mutex_unlock(&g->lock);
+
+        connection_t* conn = inference.conn;
+        ncStatus_t status = NC_OK;
+        for (unsigned int i = g->inputCount; i < g->inputCount + g->outputCount; i++) {
+            uint8_t* output = slotTensor(conn, inference.slot, i);
+            unsigned int size = g->descs[i].totalSize;
+            void* userParam;
+            ncStatus_t rc = ncFifoReadElemToBuffer(g->fifos[i],
+                conn->dataType == NC_FIFO_FP32 ? g->outputStaging : output, size, &userParam);
+            if (rc != NC_OK)
+                status = rc;
+            else if (conn->dataType == NC_FIFO_FP32)
+                fp16tofloat((float*)output, g->outputStaging, size / 2);
+        }
+        sendDone(conn, inference.slot, status);
+
+        // the connection is freed once nothing of it is in flight
+        pthread_mutex_lock(&g->lock);
+        g->completed++;
+        conn->inFlight--;
+        pthread_cond_broadcast(&g->cond);
+    }
+    pthread_mutex_unlock(&g->lock);
+    return NULL;
+}
+
+static ncStatus_t queueInference(connection_t* conn, uint32_t slot)
+{
+    residentGraph_t* g = conn->graph;
+    ncStatus_t rc = NC_OK;
+    pthread_mutex_lock(&g->queueLock);
+    pthread_mutex_lock(&g->lock);
+    while (g->queued - g->completed == GRAPH_MAX_PENDING)
+        pthread_cond_wait(&g->cond, &g->lock);
+    pthread_mutex_unlock(&g->lock);
+
+    for (unsigned int i = 0; i < g->inputCount && rc == NC_OK; i++) {
+        uint8_t* input = slotTensor(conn, slot, i);
+        if (conn->dataType == NC_FIFO_FP32) {
+            floattofp16(g->inputStaging, (float*)input, g->descs[i].totalSize / 2);
+            input = g->inputStaging;
+        }
+        // copied to the FIFO, the staging buffer can be reused
+        rc = ncFifoWriteElem(g->fifos[i], input, NULL, NULL);
+    }
+    if (rc == NC_OK)
+        rc = ncGraphQueueInference(g->handle, g->fifos, g->fifos + g->inputCount);
+    if (rc == NC_OK) {
+        pthread_mutex_lock(&g->lock);
+        g->pending[g->queued % GRAPH_MAX_PENDING].conn = conn;
+        g->pending[g->queued % GRAPH_MAX_PENDING].slot = slot;
+        g->queued++;
+        conn->inFlight++;
+        pthread_cond_broadcast(&g->cond);
+        pthread_mutex_unlock(&g->lock);
+    }
+    pthread_mutex_unlock(&g->queueLock);
+    return rc;
+}
+
+//called with cacheLock taken
+static residentGraph_t* findGraph(const uint8_t* digest, uint32_t size)
+{
+    residentGraph_t* g;
+    for (g = graphs; g; g = g->next) {
+        if (g->size == size && memcmp(g->digest, digest, NC_RESIDENCY_DIGEST_SIZE) == 0)
+            return g;
+    }
+    return NULL;
+}
+
+//called with cacheLock taken
+static void unlinkGraph(residentGraph_t* graph)
+{
+    residentGraph_t** p;
+    for (p = &graphs; *p; p = &(*p)->next) {
+        if (*p == graph) {
+            *p = graph->next;
+            return;
+        }
+    }
+}
+
+static residentGraph_t* createGraph(const uint8_t* digest, uint32_t size)
+{
+    residentGraph_t* g = calloc(1, sizeof(*g));
+    if (!g)
+        return NULL;
+    memcpy(g->digest, digest, NC_RESIDENCY_DIGEST_SIZE);
+    g->size = size;
+    for (int i = 0; i < 8; i++)
+        snprintf(g->name + 2 * i, sizeof(g->name) - 2 * i, "%02x", digest[i]);
+    g->state = GRAPH_LOADING;
+    pthread_mutex_init(&g->queueLock, NULL);
+    pthread_mutex_init(&g->lock, NULL);
+    pthread_cond_init(&g->cond, NULL);
+    return g;
+}
+
+static void freeGraph(residentGraph_t* graph)
+{
+    pthread_mutex_destroy(&graph->queueLock);
+    pthread_mutex_destroy(&graph->lock);
+    pthread_cond_destroy(&graph->cond);
+    free(graph->inputStaging);
+    free(graph->outputStaging);
+    free(graph);
+}
+
+//called with cacheLock taken. Takes a reference on the graph of the digest, once its
+//allocation in progress is over. *graph is NULL if the graph is not resident.
+static ncStatus_t referenceGraph(const uint8_t* digest, uint32_t size,
+                                 residentGraph_t** graph, int* resident)
+{
+    residentGraph_t* g = findGraph(digest, size);
+    *graph = NULL;
+    if (!g)
+        return NC_OK;
+    *resident = g->state == GRAPH_READY;
+    g->attachments++;
+    while (g->state == GRAPH_LOADING)
+        pthread_cond_wait(&cacheCond, &cacheLock);
+    if (g->state == GRAPH_FAILED) {
+        ncStatus_t status = g->status;
+        if (--g->attachments == 0)
+            freeGraph(g);
+        return status;
+    }
+    *graph = g;
+    return NC_OK;
+}
+
+static void releaseGraph(residentGraph_t* graph)
+{
+    pthread_mutex_lock(&cacheLock);
+    graph->attachments--;
+    graph->lastUsed = now();
+    pthread_mutex_unlock(&cacheLock);
+}
+
+//called with allocLock taken. Frees the reader, the FIFOs and the graph on the device.
+static void deallocateGraph(residentGraph_t* graph)
+{
+    if (graph->reader) {
+        pthread_mutex_lock(&graph->lock);
+        graph->stopping = 1;
+        pthread_cond_broadcast(&graph->cond);
+        pthread_mutex_unlock(&graph->lock);
+        pthread_join(graph->reader, NULL);
+        graph->reader = 0;
+    }
+    for (unsigned int i = 0; i < graph->inputCount + graph->outputCount; i++) {
+        if (graph->fifos[i])
+            ncFifoDelete(graph->fifos[i]);
+        graph->fifos[i] = NULL;
+    }
+    ncStatus_t rc = ncGraphDeallocate(graph->handle);
+    if (rc != NC_OK)
+        mvLog(MVLOG_WARN, "Deallocation of graph %s failed %d\n", graph->name, rc);
+    residentDevice_t* d = &devices[graph->device];
+    d->graphs--;
+    d->streams -= 1 + graph->inputCount + graph->outputCount;
+}
+
+//called with allocLock taken. Deallocates the least recently used graph of the
+//device without attachments, returns 0 if there was one.
+static int evictGraph(int device)
+{
+    residentGraph_t *g, *lru = NULL;
+    pthread_mutex_lock(&cacheLock);
+    for (g = graphs; g; g = g->next) {
+        if (g->device == device && g->state == GRAPH_READY && !g->attachments &&
+            (!lru || g->lastUsed < lru->lastUsed))
+            lru = g;
+    }
+    // no reference can be taken once it is off the list
+    if (lru)
+        unlinkGraph(lru);
+    pthread_mutex_unlock(&cacheLock);
+    if (!lru)
+        return -1;
+
+    deallocateGraph(lru);
+    printf("graph %s evicted from device %d\n", lru->name, device);
+    fflush(stdout);
+    freeGraph(lru);
+    return 0;
+}
+
+//called with allocLock taken. Creates the FIFOs and starts the reader of the graph.
+static ncStatus_t createFifos(residentGraph_t* graph, struct deviceHandle_t* device)
+{
+    unsigned int count = graph->inputCount + graph->outputCount;
+    unsigned int stagingSize = 0;
+    for (unsigned int i = 0; i < count; i++) {
+        if (graph->descs[i].totalSize > stagingSize)
+            stagingSize = graph->descs[i].totalSize;
+    }
+    graph->inputStaging = malloc(stagingSize);
+    graph->outputStaging = malloc(stagingSize);
+    if (!graph->inputStaging || !graph->outputStaging)
+        return NC_OUT_OF_MEMORY;
+
+    for (unsigned int i = 0; i < count; i++) {
+        ncFifoType_t type = i < graph->inputCount ? NC_FIFO_HOST_WO : NC_FIFO_HOST_RO;
+        ncStatus_t rc = ncFifoInit(type, &graph->fifos[i]);
+        if (rc == NC_OK)
+            rc = ncFifoCreate(graph->fifos[i], device, &graph->descs[i], fifoDepth);
+        if (rc != NC_OK) {
+            // a FIFO is linked to the device from its stream on, it is left to ncDeviceClose
+            graph->fifos[i] = NULL;
+            return rc;
+        }
+    }
+    if (pthread_create(&graph->reader, NULL, readerThread, graph)) {
+        graph->reader = 0;
+        return NC_ERROR;
+    }
+    return NC_OK;
+}
+
+//called with allocLock taken
+static ncStatus_t allocateOnDevice(residentGraph_t* graph, int device,
+                                   const void* graphFile, uint32_t size)
+{
+    residentDevice_t* d = &devices[device];
+    struct graphHandle_t* handle = graph->handle;
+    if (d->graphs >= d->maxGraphs || d->streams + GRAPH_MIN_STREAMS > DEVICE_GRAPH_STREAMS)
+        return NC_OUT_OF_MEMORY;
+    ncStatus_t rc = ncGraphAllocate(d->handle, handle, graphFile, size);
+    if (rc != NC_OK)
+        return rc;
+
+    int inputCount = 0, outputCount = 0;
+    struct ncTensorDescriptor_t *inputs, *outputs;
+    unsigned int length;
+    if (ncGraphGetOption(handle, NC_OPTION_CLASS0, NC_RO_GRAPH_INPUT_COUNT, &inputCount, &length) ||
+        ncGraphGetOption(handle, NC_OPTION_CLASS0, NC_RO_GRAPH_OUTPUT_COUNT, &outputCount, &length) ||
+        ncGraphGetOption(handle, NC_OPTION_CLASS0, NC_RO_GRAPH_INPUT_TENSOR_DESCRIPTORS, &inputs, &length) ||
+        ncGraphGetOption(handle, NC_OPTION_CLASS0, NC_RO_GRAPH_OUTPUT_TENSOR_DESCRIPTORS, &outputs, &length)) {
+        rc = NC_ERROR;
+    } else if (inputCount < 1 || inputCount > NC_RESIDENCY_MAX_TENSORS ||
+               outputCount < 1 || outputCount > NC_RESIDENCY_MAX_TENSORS) {
+        rc = NC_UNSUPPORTED_GRAPH_FILE;
+    } else if (d->streams + 1 + inputCount + outputCount > DEVICE_GRAPH_STREAMS) {
+        // XLink fails past its streams, an idle graph must go first
+        rc = NC_OUT_OF_MEMORY;
+    }
+    if (rc != NC_OK) {
+        ncGraphDeallocate(handle);
+        return rc;
+    }
+    graph->inputCount = inputCount;
+    graph->outputCount = outputCount;
+    memcpy(graph->descs, inputs, inputCount * sizeof(*inputs));
+    memcpy(graph->descs + inputCount, outputs, outputCount * sizeof(*outputs));
+    graph->device = device;
+    d->graphs++;
+    d->streams += 1 + inputCount + outputCount;
+
+    rc = createFifos(graph, d->handle);
+    if (rc != NC_OK) {
+        mvLog(MVLOG_ERROR, "Can't create the FIFOs of graph %s: %d\n", graph->name, rc);
+        deallocateGraph(graph);
+    }
+    return rc;
+}
+
+// Allocates the graph on the device with the fewest graphs, evicting idle graphs of
+// the devices which have no room for it
+static ncStatus_t allocateGraph(residentGraph_t* graph, const void* graphFile, uint32_t size)
+{
+    ncStatus_t rc = NC_OUT_OF_MEMORY;
+    unsigned int full = 0;  // devices with no room left
+    double start = now();
+    if (ncGraphInit(graph->name, &graph->handle) != NC_OK)
+        return NC_OUT_OF_MEMORY;
+
+    pthread_mutex_lock(&allocLock);
+    for (;;) {
+        int device = -1;
+        for (int i = 0; i < deviceCount; i++) {
+            if (!(full & (1u << i)) && (device < 0 || devices[i].graphs < devices[device].graphs))
+                device = i;
+        }
+        if (device < 0)
+            break;
+        rc = allocateOnDevice(graph, device, graphFile, size);
+        if (rc == NC_OK || rc == NC_INVALID_PARAMETERS || rc == NC_UNSUPPORTED_GRAPH_FILE)
+            break;
+        // retry once an idle graph is gone
+        if (evictGraph(device))
+            full |= 1u << device;
+    }
+    pthread_mutex_unlock(&allocLock);
+
+    if (rc != NC_OK) {
+        // the NC API links the graph to the device only once it is allocated
+        free(graph->handle->private_data);
+        free(graph->handle);
+        graph->handle = NULL;
+        mvLog(MVLOG_ERROR, "Allocation of graph %s failed %d\n", graph->name, rc);
+        return rc;
+    }
+    printf("graph %s (%u bytes) allocated on device %d in %.3f ms\n",
+           graph->name, size, graph->device, (now() - start) * 1000);
+    fflush(stdout);
+    return NC_OK;
+}
+
+// Takes a reference on the graph of the file, allocating it if it is not resident
+static ncStatus_t loadGraph(const uint8_t* digest, const void* graphFile, uint32_t size,
+                            residentGraph_t** graph, int* resident)
+{
+    pthread_mutex_lock(&cacheLock);
+    // another client may have sent the same graph meanwhile
+    ncStatus_t rc = referenceGraph(digest, size, graph, resident);
+    if (rc != NC_OK || *graph) {
+        pthread_mutex_unlock(&cacheLock);
+        return rc;
+    }
+    residentGraph_t* g = createGraph(digest, size);
+    if (!g) {
+        pthread_mutex_unlock(&cacheLock);
+        return NC_OUT_OF_MEMORY;
+    }
+    g->attachments = 1;
+    g->next = graphs;
+    graphs = g;
+    pthread_mutex_unlock(&cacheLock);
+
+    rc = allocateGraph(g, graphFile, size);
+
+    pthread_mutex_lock(&cacheLock);
+    if (rc == NC_OK) {
+        g->state = GRAPH_READY;
+        *graph = g;
+    } else {
+        // the waiting clients free it with their references
+        g->state = GRAPH_FAILED;
+        g->status = rc;
+        unlinkGraph(g);
+        if (--g->attachments == 0)
+            freeGraph(g);
+    }
+    *resident = 0;
+    pthread_cond_broadcast(&cacheCond);
+    pthread_mutex_unlock(&cacheLock);
+    return rc;
+}
+
+static ncStatus_t loadGraphFile(const char* path)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return NC_INVALID_PARAMETERS;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    void* data = size > 0 ? malloc(size) : NULL;
+    ncStatus_t rc = NC_INVALID_PARAMETERS;
+    if (data && fread(data, 1, size, f) == (size_t)size) {
+        residentGraph_t* graph;
+        int resident;
+        uint8_t digest[NC_RESIDENCY_DIGEST_SIZE];
+        ncResidencyDigest(data, size, digest);
+        rc = loadGraph(digest, data, size, &graph, &resident);
+        if (rc == NC_OK)
+            releaseGraph(graph);
+    }
+    free(data);
+    fclose(f);
+    return rc;
+}
+
+// Maps the shared memory of the attachment, returns its fd in *shmFd
+static ncStatus_t createAttachment(connection_t* conn, int* shmFd)
+{
+    residentGraph_t* g = conn->graph;
+    uint32_t offset = 0;
+    for (unsigned int i = 0; i < g->inputCount + g->outputCount; i++) {
+        conn->offsets[i] = offset;
+        offset += ncResidencyTensorSize(&g->descs[i], conn->dataType);
+        offset = (offset + TENSOR_ALIGNMENT - 1) & ~(TENSOR_ALIGNMENT - 1);
+    }
+    conn->slotSize = offset;
+    conn->shmSize = (size_t)offset * conn->slots;
+
+    *shmFd = createSharedMemory(conn->shmSize);
+    if (*shmFd >= 0) {
+        conn->shm = mmap(NULL, conn->shmSize, PROT_READ | PROT_WRITE, MAP_SHARED, *shmFd, 0);
+        if (conn->shm == MAP_FAILED) {
+            conn->shm = NULL;
+            close(*shmFd);
+            *shmFd = -1;
+        }
+    }
+    if (*shmFd < 0) {
+        mvLog(MVLOG_ERROR, "Can't create the shared memory: %s\n", strerror(errno));
+        return NC_OUT_OF_MEMORY;
+    }
+    return NC_OK;
+}
+
+// Attaches the client to its graph, receiving the graph file if it is not resident
+static ncStatus_t attachClient(connection_t* conn, const ncResidencyMessage_t* request,
+                               int* resident)
+{
+    if (request->type != NC_RESIDENCY_ATTACH || request->slots < 1 ||
+        request->slots > NC_RESIDENCY_MAX_SLOTS || !request->blobSize ||
+        (request->dataType != NC_FIFO_FP16 && request->dataType != NC_FIFO_FP32))
+        return NC_INVALID_PARAMETERS;
+    conn->slots = request->slots;
+    conn->dataType = request->dataType;
+
+    pthread_mutex_lock(&cacheLock);
+    ncStatus_t rc = referenceGraph(request->digest, request->blobSize, &conn->graph, resident);
+    pthread_mutex_unlock(&cacheLock);
+    if (rc != NC_OK || conn->graph)
+        return rc;
+
+    ncResidencyMessage_t msg;
+    if (sendStatus(conn->sock, NC_RESIDENCY_NEED_BLOB, NC_OK) ||
+        recvAll(conn->sock, &msg, sizeof(msg)) ||
+        msg.type != NC_RESIDENCY_BLOB || msg.blobSize != request->blobSize)
+        return NC_ERROR;
+    void* blob = malloc(msg.blobSize);
+    if (!blob)
+        return NC_OUT_OF_MEMORY;
+    if (recvAll(conn->sock, blob, msg.blobSize)) {
+        free(blob);
+        return NC_ERROR;
+    }
+    uint8_t digest[NC_RESIDENCY_DIGEST_SIZE];
+    ncResidencyDigest(blob, msg.blobSize, digest);
+    if (memcmp(digest, request->digest, sizeof(digest)) != 0)
+        rc = NC_INVALID_PARAMETERS;
+    else
+        rc = loadGraph(digest, blob, msg.blobSize, &conn->graph, resident);
+    free(blob);
+    return rc;
+}
+
+// Serves the inferences of the attachment until the client detaches
+static void serveClient(connection_t* conn, int shmFd, int resident)
+{
+    residentGraph_t* g = conn->graph;
+    ncResidencyMessage_t msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.type = NC_RESIDENCY_ATTACHED;
+    msg.status = NC_OK;
+    msg.slots = conn->slots;
+    msg.resident = resident;
+    msg.deviceIndex = g->device;
+    msg.inputCount = g->inputCount;
+    msg.outputCount = g->outputCount;
+    msg.slotSize = conn->slotSize;
+    memcpy(msg.offsets, conn->offsets, sizeof(msg.offsets));
+    memcpy(msg.descs, g->descs, sizeof(msg.descs));
+    if (sendWithFd(conn->sock, &msg, shmFd))
+        return;
+
+    while (recvAll(conn->sock, &msg, sizeof(msg)) == 0) {
+        if (msg.type != NC_RESIDENCY_INFER || msg.slot >= conn->slots) {
+            mvLog(MVLOG_ERROR, "Unexpected message %u from the client\n", msg.type);
+            break;
+        }
+        ncStatus_t rc = queueInference(conn, msg.slot);
+        if (rc != NC_OK) {
+            sendDone(conn, msg.slot, rc);
+            break;
+        }
+    }
+    // the reader writes to the shared memory until the inferences are done
+    pthread_mutex_lock(&g->lock);
+    while (conn->inFlight)
+        pthread_cond_wait(&g->cond, &g->lock);
+    pthread_mutex_unlock(&g->lock);
+}
+
+static void* connectionThread(void* ctx)
+{
+    connection_t* conn = (connection_t*)ctx;
+    ncResidencyMessage_t msg;
+    int resident = 0, shmFd = -1;
+
+    ncStatus_t rc = NC_ERROR;
+    if (recvAll(conn->sock, &msg, sizeof(msg)) == 0)
+        rc = attachClient(conn, &msg, &resident);
+    if (rc == NC_OK)
+        rc = createAttachment(conn, &shmFd);
+    if (rc == NC_OK) {
+        serveClient(conn, shmFd, resident);
+        close(shmFd);
+    } else {
+        sendStatus(conn->sock, NC_RESIDENCY_ATTACHED, rc);
+    }
+
+    if (conn->shm)
+        munmap(conn->shm, conn->shmSize);
+    if (conn->graph)
+        releaseGraph(conn->graph);
+    close(conn->sock);
+    pthread_mutex_destroy(&conn->sendLock);
+    free(conn);
+    return NULL;
+}
+
+static int openDevices(int maxDevices)
+{
+    double start = now();
+    while (deviceCount < maxDevices && deviceCount < DAEMON_MAX_DEVICES) {
+        residentDevice_t* d = &devices[deviceCount];
+        if (ncDeviceInit(deviceCount, &d->handle) != NC_OK)
+            break;
+        ncStatus_t rc = ncDeviceOpen(d->handle);
+        if (rc != NC_OK) {
+            printf("Opening device %d failed %d\n", deviceCount, rc);
+            break;
+        }
+        unsigned int length = sizeof(d->maxGraphs);
+        if (ncDeviceGetOption(d->handle, NC_OPTION_CLASS0, NC_RO_DEVICE_MAX_GRAPH_NUM,
+                              &d->maxGraphs, &length) != NC_OK || d->maxGraphs < 1)
+            d->maxGraphs = 1;
+        deviceCount++;
+    }
+    printf("%d devices booted in %.3f s\n", deviceCount, now() - start);
+    fflush(stdout);
+    return deviceCount;
+}
+
+static void onSignal(int sig)
+{
+    (void)sig;
+    stopping = 1;
+}
+
+static void usage()
+{
+    printf("Usage: ncs_residencyd [-s <socket path>] [-n <devices>] [-d <FIFO elements>]\n"
+           "                      [-g <graph file>]...\n");
+}
+
+int main(int argc, char** argv)
+{
+    const char* path = getenv("NC_RESIDENCY_SOCKET");
+    int maxDevices = DAEMON_MAX_DEVICES;
+    const char* preload[DAEMON_MAX_PRELOAD];
+    int preloadCount = 0;
+    if (!path || !*path)
+        path = NC_RESIDENCY_DEFAULT_SOCKET;
+
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc || argv[i][0] != '-' || strlen(argv[i]) != 2) {
+            usage();
+            return -1;
+        }
+        const char* value = argv[i + 1];
+        switch (argv[i][1]) {
+        case 's': path = value; break;
+        case 'n': maxDevices = atoi(value); break;
+        case 'd': fifoDepth = atoi(value); break;
+        case 'g':
+            if (preloadCount == DAEMON_MAX_PRELOAD) {
+                usage();
+                return -1;
+            }
+            preload[preloadCount++] = value;
+            break;
+        default:
+            usage();
+            return -1;
+        }
+    }
+    if (fifoDepth < 1) {
+        usage();
+        return -1;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        printf("Socket path too long: %s\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    if (openDevices(maxDevices) == 0) {
+        printf("No device found\n");
+        return -1;
+    }
+    for (int i = 0; i < preloadCount; i++) {
+        if (loadGraphFile(preload[i]) != NC_OK)
+            printf("Can't allocate %s\n", preload[i]);
+    }
+
+    // the clients can connect once the devices are ready
+    // the clients of other users would share the devices and the graphs, the socket is
+    // created 0600 rather than chmod-ed after bind
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path);
+    mode_t mask = umask(077);
+    int bound = server >= 0 && bind(server, (struct sockaddr*)&addr, sizeof(addr)) == 0;
+    umask(mask);
+    if (!bound || listen(server, 16) < 0) {
+        perror(path);
+        return -1;
+    }
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = onSignal;  // without SA_RESTART, accept returns on the signal
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    printf("ncs_residencyd on %s\n", path);
+    fflush(stdout);
+
+    while (!stopping) {
+        int fd = accept(server, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR)
+                continue;
+            perror("accept");
+            break;
+        }
+        connection_t* conn = calloc(1, sizeof(*conn));
+        pthread_t thread;
+        if (!conn) {
+            close(fd);
+            continue;
+        }
+        conn->sock = fd;
+        pthread_mutex_init(&conn->sendLock, NULL);
+        if (pthread_create(&thread, NULL, connectionThread, conn)) {
+            close(fd);
+            free(conn);
+            continue;
+        }
+        pthread_detach(thread);
+    }
+    close(server);
+    unlink(path);
+
+    // the graphs and their FIFOs go with the devices
+    for (int i = 0; i < deviceCount; i++)
+        ncDeviceClose(devices[i].handle);
+    return 0;
+}
@@ -0,0 +1,33 @@
+LOCAL_PATH:= $(call my-dir)
+
+# ==================================
+
+# executable: dispatcher_stress
+# the XLink dispatcher is linked alone, the link and the device are mocked in dispatcher_stress.c
+$(info LOCAL_PATH =$(LOCAL_PATH))
+include $(CLEAR_VARS)
+
+MVNC_SRC:= ../../../api/src
+MV_COMMON_BASE:= $(LOCAL_PATH)/$(MVNC_SRC)/common
+
+LOCAL_SRC_FILES := \
+	dispatcher_stress.c \
+	$(MVNC_SRC)/common/components/XLink/shared/XLinkDispatcher.c
+
+LOCAL_MODULE := dispatcher_stress
+
+LOCAL_C_INCLUDES += \
+	$(LOCAL_PATH) \
+	$(LOCAL_PATH)/../../../api/include \
+	$(MV_COMMON_BASE)/components/XLink/shared \
+	$(MV_COMMON_BASE)/components/XLink/pc \
+	$(MV_COMMON_BASE)/shared/include
+
+# MAX_EVENTS can be overridden here to compare queue sizes, e.g. -DMAX_EVENTS=1024
+LOCAL_CFLAGS += -D__PC__ -Wno-error
+LOCAL_CFLAGS += -O2 -Wall -pthread -fPIC -MMD -MP -fPIE
+
+LOCAL_SHARED_LIBRARIES := liblog
+LOCAL_STATIC_LIBRARIES :=
+
+include $(BUILD_EXECUTABLE)
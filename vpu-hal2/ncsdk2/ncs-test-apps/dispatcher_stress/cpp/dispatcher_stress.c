@@ -0,0 +1,257 @@
+/*
+* Copyright 2017 Intel Corporation.
+* The source code, information and material ("Material") contained herein is
+* owned by Intel Corporation or its suppliers or licensors, and title to such
+* Material remains with Intel Corporation or its suppliers or licensors.
+* The Material contains proprietary information of Intel or its suppliers and
+* licensors. The Material is protected by worldwide copyright laws and treaty
+* provisions.
+* No part of the Material may be used, copied, reproduced, modified, published,
+* uploaded, posted, transmitted, distributed or disclosed in any way without
+* Intel's prior express written permission. No license under any patent,
+* copyright or other intellectual property rights in the Material is granted to
+* or conferred upon you, either expressly, by implication, inducement, estoppel
+* or otherwise.
+* Any license under such intellectual property rights must be express and
+* approved by Intel in writing.
+*/
+
+///
+/// @brief     Stress test of the XLink event dispatcher
+///
+/// Replays synthetic events through the dispatcher over a mock link and reports
+/// the CPU time spent per event:
+///
+///   dispatcher_stress [-n <iterations>] [-t <threads>] [-s <streams>]
+///
+/// Every iteration of a client thread is a write and a read on its stream.
+/// The mock device acks the write and loops the data back as a remote write,
+/// which unblocks the read if it arrived first. So each iteration is four
+/// dispatched events: local write, remote write response, remote write and
+/// local read, plus one more when the read was blocked.
+///
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "XLinkDispatcher.h"
+#include "XLinkPrivateDefines.h"
+
+#define MOCK_WIRE_SIZE (4 * MAX_EVENTS)
+#define MOCK_MAX_STREAMS 64
+
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    xLinkEvent_t q[MOCK_WIRE_SIZE];
+    int head;
+    int count;
+} wire = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER };
+
+static int mockLink;
+static int deviceId = 0x10000;
+static int available[MOCK_MAX_STREAMS];    // looped back packets not read yet, dispatcher thread only
+static unsigned long long dispatchedEvents; // dispatcher thread only
+static unsigned long long blockedReads;
+static clockid_t dispatcherClock;
+static int dispatcherClockValid;
+
+static int iterations = 250000;
+static int threads = 8;
+static int streams = 4;
+
+static void wirePush(xLinkEvent_t* event)
+{
+    pthread_mutex_lock(&wire.lock);
+    if (wire.count == MOCK_WIRE_SIZE) {
+        fprintf(stderr, "mock wire overflow\n");
+        exit(1);
+    }
+    wire.q[(wire.head + wire.count) % MOCK_WIRE_SIZE] = *event;
+    wire.count++;
+    pthread_cond_signal(&wire.cond);
+    pthread_mutex_unlock(&wire.lock);
+}
+
+static int mockEventReceive(xLinkEvent_t* event)
+{
+    pthread_mutex_lock(&wire.lock);
+    while (wire.count == 0)
+        pthread_cond_wait(&wire.cond, &wire.lock);
+    *event = wire.q[wire.head];
+    wire.head = (wire.head + 1) % MOCK_WIRE_SIZE;
+    wire.count--;
+    pthread_mutex_unlock(&wire.lock);
+    dispatcherAddEvent(EVENT_REMOTE, event);
+    return 0;
+}
+
+// the mock device: answers every request and loops the written data back
+static int mockEventSend(xLinkEvent_t* event)
+{
+    xLinkEvent_t reply;
+    if (event->header.type >= USB_REQUEST_LAST)
+        return 0; // responses to the device's own writes
+    reply = *event;
+    reply.header.type = event->header.type + USB_REQUEST_LAST + 1;
+    reply.header.flags.raw = 0;
+    reply.header.flags.bitField.ack = 1;
+    wirePush(&reply);
+    if (event->header.type == USB_WRITE_REQ) {
+        reply = *event;
+        reply.header.id = deviceId++;
+        reply.header.flags.raw = 0;
+        wirePush(&reply);
+    }
+    return 0;
+}
+
+static int mockLocalGetResponse(xLinkEvent_t* event, xLinkEvent_t* response)
+{
+    (void)response;
+    if (!dispatcherClockValid) {
+        pthread_getcpuclockid(pthread_self(), &dispatcherClock);
+        dispatcherClockValid = 1;
+    }
+    dispatchedEvents++;
+    event->header.flags.bitField.ack = 1;
+    event->header.flags.bitField.nack = 0;
+    event->header.flags.bitField.block = 0;
+    event->header.flags.bitField.localServe = 0;
+    if (event->header.type == USB_READ_REQ) {
+        if (available[event->header.streamId]) {
+            available[event->header.streamId]--;
+        } else {
+            event->header.flags.bitField.block = 1;
+            blockedReads++;
+        }
+        event->header.flags.bitField.localServe = 1;
+    }
+    return 0;
+}
+
+static int mockRemoteGetResponse(xLinkEvent_t* event, xLinkEvent_t* response)
+{
+    dispatchedEvents++;
+    if (event->header.type == USB_WRITE_REQ) {
+        available[event->header.streamId]++;
+        dispatcherUnblockEvent(-1, USB_READ_REQ, event->header.streamId, event->xLinkFD);
+        *response = *event;
+        response->header.type = USB_WRITE_RESP;
+        response->header.flags.raw = 0;
+        response->header.flags.bitField.ack = 1;
+    }
+    return 0;
+}
+
+static void mockCloseLink(void* fd)
+{
+    (void)fd;
+}
+
+static void mockResetDevice(void* fd)
+{
+    (void)fd;
+}
+
+static struct dispatcherControlFunctions controlFunctions = {
+    mockEventSend,
+    mockEventReceive,
+    mockLocalGetResponse,
+    mockRemoteGetResponse,
+    mockCloseLink,
+    mockResetDevice,
+};
+
+static int request(xLinkEventType_t type, streamId_t stream)
+{
+    xLinkEvent_t event;
+    memset(&event, 0, sizeof(event));
+    event.header.type = type;
+    event.header.streamId = stream;
+    event.header.size = 64;
+    event.xLinkFD = &mockLink;
+    xLinkEvent_t* ev = dispatcherAddEvent(EVENT_LOCAL, &event);
+    if (!ev)
+        return -1;
+    dispatcherWaitEventComplete(&mockLink);
+    return ev->header.flags.bitField.ack ? 0 : -1;
+}
+
+static void* client(void* ctx)
+{
+    streamId_t stream = (streamId_t)(size_t)ctx % streams;
+    int i;
+    for (i = 0; i < iterations / threads; i++) {
+        if (request(USB_WRITE_REQ, stream) || request(USB_READ_REQ, stream)) {
+            fprintf(stderr, "request failed on stream %u\n", stream);
+            exit(1);
+        }
+    }
+    return NULL;
+}
+
+static double elapsed(clockid_t clock, struct timespec* start)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (ts.tv_sec - start->tv_sec) + (ts.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+int main(int argc, char** argv)
+{
+    pthread_t tids[MAXIMUM_SEMAPHORES];
+    struct timespec wallStart, cpuStart, dispStart = {0, 0};
+    int opt, i;
+
+    while ((opt = getopt(argc, argv, "n:t:s:")) != -1) {
+        switch (opt) {
+        case 'n': iterations = atoi(optarg); break;
+        case 't': threads = atoi(optarg); break;
+        case 's': streams = atoi(optarg); break;
+        default:
+            fprintf(stderr, "usage: %s [-n <iterations>] [-t <threads>] [-s <streams>]\n", argv[0]);
+            return 1;
+        }
+    }
+    // the main thread takes one of the dispatcher semaphores for the warm up
+    if (threads < 1 || threads >= MAXIMUM_SEMAPHORES || streams < 1 || streams > MOCK_MAX_STREAMS) {
+        fprintf(stderr, "threads must be 1..%d, streams 1..%d\n", MAXIMUM_SEMAPHORES - 1, MOCK_MAX_STREAMS);
+        return 1;
+    }
+
+    if (dispatcherInitialize(&controlFunctions) || dispatcherStart(&mockLink)) {
+        fprintf(stderr, "can't start the dispatcher\n");
+        return 1;
+    }
+
+    // warm up, which also picks the dispatcher thread clock
+    if (request(USB_WRITE_REQ, 0) || request(USB_READ_REQ, 0))
+        return 1;
+    unsigned long long startEvents = dispatchedEvents;
+    unsigned long long startBlocked = blockedReads;
+    clock_gettime(CLOCK_MONOTONIC, &wallStart);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpuStart);
+    clock_gettime(dispatcherClock, &dispStart);
+
+    for (i = 0; i < threads; i++)
+        pthread_create(&tids[i], NULL, client, (void*)(size_t)i);
+    for (i = 0; i < threads; i++)
+        pthread_join(tids[i], NULL);
+
+    double wall = elapsed(CLOCK_MONOTONIC, &wallStart);
+    double cpu = elapsed(CLOCK_PROCESS_CPUTIME_ID, &cpuStart);
+    double disp = elapsed(dispatcherClock, &dispStart);
+    double events = (double)(dispatchedEvents - startEvents);
+
+    printf("MAX_EVENTS %d, %d threads, %d streams\n", MAX_EVENTS, threads, streams);
+    printf("%.0f events (%llu blocked reads) in %.2f s: %.0f events/s\n",
+           events, blockedReads - startBlocked, wall, events / wall);
+    printf("CPU per event: dispatcher thread %.0f ns, process %.0f ns\n",
+           disp * 1e9 / events, cpu * 1e9 / events);
+    return 0;
+}
@@ -0,0 +1,53 @@
+LOCAL_PATH:= $(call my-dir)
+
+MVNC_SRC:= ../../../api/src
+MV_COMMON_BASE:= $(LOCAL_PATH)/$(MVNC_SRC)/common
+
+FIFO_LOOPBACK_INCLUDES := \
+	$(LOCAL_PATH) \
+	$(LOCAL_PATH)/../../../api/include \
+	$(MV_COMMON_BASE)/components/XLink/shared \
+	$(MV_COMMON_BASE)/components/XLink/pc \
+	$(MV_COMMON_BASE)/components/XLinkConsole/pc \
+	$(MV_COMMON_BASE)/shared/include
+
+FIFO_LOOPBACK_CFLAGS := -D__PC__ -DDEVICE_SHELL_ENABLED -Wno-error -O2 -Wall -pthread -fPIC -MMD -MP
+
+# ==================================
+
+# libmvnc sources with allocations and copies counted by fifo_counters.h
+$(info LOCAL_PATH =$(LOCAL_PATH))
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+	$(MVNC_SRC)/mvnc_api.c \
+	$(MVNC_SRC)/mvnc_api_highclass.c
+
+LOCAL_MODULE := libmvnc_fifo_counted
+
+LOCAL_C_INCLUDES += $(FIFO_LOOPBACK_INCLUDES)
+LOCAL_CFLAGS += $(FIFO_LOOPBACK_CFLAGS) -include $(LOCAL_PATH)/fifo_counters.h
+
+include $(BUILD_STATIC_LIBRARY)
+
+# ==================================
+
+# executable: fifo_loopback
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+	fifo_loopback.cpp \
+	fifo_counters.c \
+	../../trigger_loopback/cpp/xlink_loopback.c \
+	$(MVNC_SRC)/fp16.c \
+	$(MVNC_SRC)/common/components/XLinkConsole/pc/XLinkConsole.c
+
+LOCAL_MODULE := fifo_loopback
+
+LOCAL_C_INCLUDES += $(FIFO_LOOPBACK_INCLUDES)
+LOCAL_CFLAGS += $(FIFO_LOOPBACK_CFLAGS) -fPIE
+
+LOCAL_SHARED_LIBRARIES := liblog
+LOCAL_STATIC_LIBRARIES := libmvnc_fifo_counted
+
+include $(BUILD_EXECUTABLE)
@@ -0,0 +1,55 @@
+/*
+* Copyright 2017 Intel Corporation.
+* The source code, information and material ("Material") contained herein is
+* owned by Intel Corporation or its suppliers or licensors, and title to such
+* Material remains with Intel Corporation or its suppliers or licensors.
+* The Material contains proprietary information of Intel or its suppliers and
+* licensors. The Material is protected by worldwide copyright laws and treaty
+* provisions.
+* No part of the Material may be used, copied, reproduced, modified, published,
+* uploaded, posted, transmitted, distributed or disclosed in any way without
+* Intel's prior express written permission. No license under any patent,
+* copyright or other intellectual property rights in the Material is granted to
+* or conferred upon you, either expressly, by implication, inducement, estoppel
+* or otherwise.
+* Any license under such intellectual property rights must be express and
+* approved by Intel in writing.
+*/
+
+#define FIFO_COUNTERS_IMPL
+#include "fifo_counters.h"
+
+fifoCounters_t fifoCounters;
+
+void* countedMalloc(size_t size)
+{
+    __sync_fetch_and_add(&fifoCounters.allocs, 1);
+    return malloc(size);
+}
+
+void* countedCalloc(size_t count, size_t size)
+{
+    __sync_fetch_and_add(&fifoCounters.allocs, 1);
+    return calloc(count, size);
+}
+
+void* countedMemcpy(void* dst, const void* src, size_t size)
+{
+    __sync_fetch_and_add(&fifoCounters.copies, 1);
+    __sync_fetch_and_add(&fifoCounters.copyBytes, size);
+    return memcpy(dst, src, size);
+}
+
+void countedFloattofp16(unsigned char *dst, float *src, unsigned nelem)
+{
+    __sync_fetch_and_add(&fifoCounters.copies, 1);
+    __sync_fetch_and_add(&fifoCounters.copyBytes, nelem * sizeof(float));
+    floattofp16(dst, src, nelem);
+}
+
+void countedFp16tofloat(float *dst, unsigned char *src, unsigned nelem)
+{
+    __sync_fetch_and_add(&fifoCounters.copies, 1);
+    __sync_fetch_and_add(&fifoCounters.copyBytes, nelem * sizeof(float));
+    fp16tofloat(dst, src, nelem);
+}
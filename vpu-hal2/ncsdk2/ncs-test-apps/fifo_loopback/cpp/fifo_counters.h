@@ -0,0 +1,63 @@
+/*
+* Copyright 2017 Intel Corporation.
+* The source code, information and material ("Material") contained herein is
+* owned by Intel Corporation or its suppliers or licensors, and title to such
+* Material remains with Intel Corporation or its suppliers or licensors.
+* The Material contains proprietary information of Intel or its suppliers and
+* licensors. The Material is protected by worldwide copyright laws and treaty
+* provisions.
+* No part of the Material may be used, copied, reproduced, modified, published,
+* uploaded, posted, transmitted, distributed or disclosed in any way without
+* Intel's prior express written permission. No license under any patent,
+* copyright or other intellectual property rights in the Material is granted to
+* or conferred upon you, either expressly, by implication, inducement, estoppel
+* or otherwise.
+* Any license under such intellectual property rights must be express and
+* approved by Intel in writing.
+*/
+
+///
+/// @brief     Allocation and copy counters for libmvnc sources
+///
+/// Force-included into the libmvnc sources of the fifo_loopback example,
+/// redirects the heap allocations, memcpy and FP16 conversions to counting wrappers.
+///
+#ifndef _FIFO_COUNTERS_H_
+#define _FIFO_COUNTERS_H_
+
+#include <stdlib.h>
+#include <string.h>
+#include "fp16.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct {
+    unsigned long allocs;
+    unsigned long copies;
+    unsigned long copyBytes;
+} fifoCounters_t;
+
+extern fifoCounters_t fifoCounters;
+
+void* countedMalloc(size_t size);
+void* countedCalloc(size_t count, size_t size);
+void* countedMemcpy(void* dst, const void* src, size_t size);
+void countedFloattofp16(unsigned char *dst, float *src, unsigned nelem);
+void countedFp16tofloat(float *dst, unsigned char *src, unsigned nelem);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifndef FIFO_COUNTERS_IMPL
+#define malloc(size) countedMalloc(size)
+#define calloc(count, size) countedCalloc(count, size)
+#define memcpy(dst, src, size) countedMemcpy(dst, src, size)
+#define floattofp16(dst, src, nelem) countedFloattofp16(dst, src, nelem)
+#define fp16tofloat(dst, src, nelem) countedFp16tofloat(dst, src, nelem)
+#endif
+
+#endif
@@ -0,0 +1,163 @@
+// Copyright 2017 Intel Corporation.
+// The source code, information and material ("Material") contained herein is
+// owned by Intel Corporation or its suppliers or licensors, and title to such
+// Material remains with Intel Corporation or its suppliers or licensors.
+// The Material contains proprietary information of Intel or its suppliers and
+// licensors. The Material is protected by worldwide copyright laws and treaty
+// provisions.
+// No part of the Material may be used, copied, reproduced, modified, published,
+// uploaded, posted, transmitted, distributed or disclosed in any way without
+// Intel's prior express written permission. No license under any patent,
+// copyright or other intellectual property rights in the Material is granted to
+// or conferred upon you, either expressly, by implication, inducement, estoppel
+// or otherwise.
+// Any license under such intellectual property rights must be express and
+// approved by Intel in writing.
+
+
+// Counts host allocations and copies per inference made by libmvnc on the FP32 FIFO path,
+// for each of the read APIs, against the loopback XLink stand-in:
+//
+//   fifo_loopback [-n <inferences>] [-d <elements in flight>]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <mvnc.h>
+#include "fifo_counters.h"
+
+#define CHECK(call) \
+    do { \
+        ncStatus_t rc_ = (call); \
+        if (rc_ != NC_OK) { \
+            printf("Error - %s returned %d\n", #call, rc_); \
+            exit(-1); \
+        } \
+    } while (0)
+
+enum ReadMode {
+    READ_ELEM,
+    READ_TO_BUFFER,
+    BORROW
+};
+
+static const char* readModeNames[] = {
+    "ncFifoReadElem",
+    "ncFifoReadElemToBuffer",
+    "ncFifoBorrowElem",
+};
+
+struct Network {
+    struct graphHandle_t *graph;
+    struct fifoHandle_t *fifoIn;
+    struct fifoHandle_t *fifoOut;
+    std::vector<float> input;
+    std::vector<float> output;
+};
+
+static void readOutput(Network& net, ReadMode mode)
+{
+    void *userParam;
+    switch (mode) {
+    case READ_ELEM: {
+        void *output;
+        struct ncTensorDescriptor_t desc;
+        CHECK(ncFifoReadElem(net.fifoOut, &output, &desc, &userParam));
+        break;
+    }
+    case READ_TO_BUFFER:
+        CHECK(ncFifoReadElemToBuffer(net.fifoOut, net.output.data(),
+                                     net.output.size() * sizeof(float), &userParam));
+        break;
+    case BORROW: {
+        void *output;
+        unsigned int length;
+        CHECK(ncFifoBorrowElem(net.fifoOut, &output, &length, &userParam));
+        CHECK(ncFifoReleaseElem(net.fifoOut));
+        break;
+    }
+    }
+}
+
+static void run(Network& net, ReadMode mode, int count, int depth)
+{
+    int read = 0;
+    for (int i = 0; i < count; i++) {
+        CHECK(ncGraphQueueInferenceWithFifoElem(net.graph, &net.fifoIn, &net.fifoOut,
+                                                net.input.data(), NULL, NULL));
+        if (i + 1 - read == depth) {
+            readOutput(net, mode);
+            read++;
+        }
+    }
+    for (; read < count; read++)
+        readOutput(net, mode);
+}
+
+int main(int argc, char** argv)
+{
+    int count = 1000;
+    int depth = 4;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "-n") == 0) {
+            count = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "-d") == 0) {
+            depth = atoi(argv[i + 1]);
+        }
+    }
+    if (count < 1 || depth < 1) {
+        printf("Usage: fifo_loopback [-n <inferences>] [-d <elements in flight>]\n");
+        return -1;
+    }
+
+    int loglevel = 2;
+    CHECK(ncGlobalSetOption(NC_RW_LOG_LEVEL, &loglevel, sizeof(loglevel)));
+
+    struct deviceHandle_t *device;
+    CHECK(ncDeviceInit(0, &device));
+    CHECK(ncDeviceOpen(device));
+
+    Network net;
+    char blob[64] = {0};
+    CHECK(ncGraphInit("loopback", &net.graph));
+    CHECK(ncGraphAllocate(device, net.graph, blob, sizeof(blob)));
+
+    struct ncTensorDescriptor_t *inDesc, *outDesc;
+    unsigned int length;
+    CHECK(ncGraphGetOption(net.graph, NC_OPTION_CLASS0, NC_RO_GRAPH_INPUT_TENSOR_DESCRIPTORS, &inDesc, &length));
+    CHECK(ncGraphGetOption(net.graph, NC_OPTION_CLASS0, NC_RO_GRAPH_OUTPUT_TENSOR_DESCRIPTORS, &outDesc, &length));
+
+    int datatype = NC_FIFO_FP32;
+    CHECK(ncFifoInit(NC_FIFO_HOST_WO, &net.fifoIn));
+    CHECK(ncFifoInit(NC_FIFO_HOST_RO, &net.fifoOut));
+    CHECK(ncFifoSetOption(net.fifoIn, NC_RW_FIFO_DATA_TYPE, &datatype, sizeof(datatype)));
+    CHECK(ncFifoSetOption(net.fifoOut, NC_RW_FIFO_DATA_TYPE, &datatype, sizeof(datatype)));
+    CHECK(ncFifoCreate(net.fifoIn, device, inDesc, depth));
+    CHECK(ncFifoCreate(net.fifoOut, device, outDesc, depth));
+
+    // FP16 size in the descriptors
+    net.input.resize(inDesc->totalSize / 2);
+    net.output.resize(outDesc->totalSize / 2);
+
+    for (int mode = READ_ELEM; mode <= BORROW; mode++) {
+        run(net, (ReadMode)mode, depth, depth);  // warm up
+
+        fifoCounters_t before = fifoCounters;
+        run(net, (ReadMode)mode, count, depth);
+        fifoCounters_t after = fifoCounters;
+
+        printf("%-24s : %.2f allocations, %.2f copies, %.0f bytes copied per inference\n",
+               readModeNames[mode],
+               (double)(after.allocs - before.allocs) / count,
+               (double)(after.copies - before.copies) / count,
+               (double)(after.copyBytes - before.copyBytes) / count);
+    }
+
+    CHECK(ncFifoDelete(net.fifoIn));
+    CHECK(ncFifoDelete(net.fifoOut));
+    CHECK(ncGraphDeallocate(net.graph));
+    CHECK(ncDeviceClose(device));
+    return 0;
+}
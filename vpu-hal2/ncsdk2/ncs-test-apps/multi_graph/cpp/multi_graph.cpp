@@ -0,0 +1,200 @@
+// Copyright 2017 Intel Corporation.
+// The source code, information and material ("Material") contained herein is
+// owned by Intel Corporation or its suppliers or licensors, and title to such
+// Material remains with Intel Corporation or its suppliers or licensors.
+// The Material contains proprietary information of Intel or its suppliers and
+// licensors. The Material is protected by worldwide copyright laws and treaty
+// provisions.
+// No part of the Material may be used, copied, reproduced, modified, published,
+// uploaded, posted, transmitted, distributed or disclosed in any way without
+// Intel's prior express written permission. No license under any patent,
+// copyright or other intellectual property rights in the Material is granted to
+// or conferred upon you, either expressly, by implication, inducement, estoppel
+// or otherwise.
+// Any license under such intellectual property rights must be express and
+// approved by Intel in writing.
+
+
+// Several graphs on one device, each one driven by its own thread, like a detector and a
+// classifier per camera:
+//
+//   multi_graph [-g <graphs>] [-s <shaves per graph>] [-n <inferences per graph>]
+//               [-d <elements in flight>] [-i <inference us>]
+//
+// The graph files carry the SHAVE count of the blob header, set with -s as the MYRIAD plugin
+// sets it from KEY_VPU_FIRST_SHAVE - KEY_VPU_LAST_SHAVE. With XLINK_TRANSPORT=loopback the
+// NCS device model runs in-process and runs the inferences of the graphs concurrently while
+// they have enough free SHAVEs. The throughput of each graph and its device time (NC_RO_GRAPH_TIME_TAKEN)
+// are printed.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <thread>
+#include <vector>
+
+#include <mvnc.h>
+#include "XLinkLoopbackTransport.h"
+#include "ncs_device_model.h"
+
+// Offsets in the header of the plugin blobs, after the 34 bytes ELF header
+#define BLOB_MAGIC 8708
+#define BLOB_MAGIC_OFFSET 34
+#define BLOB_SHAVES_OFFSET 50
+#define BLOB_SIZE 64
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+#define CHECK(call) \
+    do { \
+        ncStatus_t rc_ = (call); \
+        if (rc_ != NC_OK) { \
+            printf("Error - %s returned %d\n", #call, rc_); \
+            exit(-1); \
+        } \
+    } while (0)
+
+struct Graph {
+    struct graphHandle_t *handle;
+    struct fifoHandle_t *fifoIn, *fifoOut;
+    std::vector<float> input;
+    double elapsed = 0;
+    float deviceMs = 0;
+};
+
+static void allocateGraph(struct deviceHandle_t *device, int index, uint32_t shaves, int depth, Graph& graph)
+{
+    char blob[BLOB_SIZE] = {0};
+    uint32_t magic = BLOB_MAGIC;
+    memcpy(blob + BLOB_MAGIC_OFFSET, &magic, sizeof(magic));
+    memcpy(blob + BLOB_SHAVES_OFFSET, &shaves, sizeof(shaves));
+    char name[32];
+    snprintf(name, sizeof(name), "graph%d", index);
+    CHECK(ncGraphInit(name, &graph.handle));
+    CHECK(ncGraphAllocate(device, graph.handle, blob, sizeof(blob)));
+
+    struct ncTensorDescriptor_t *inDesc, *outDesc;
+    unsigned int length;
+    CHECK(ncGraphGetOption(graph.handle, NC_OPTION_CLASS0, NC_RO_GRAPH_INPUT_TENSOR_DESCRIPTORS, &inDesc, &length));
+    CHECK(ncGraphGetOption(graph.handle, NC_OPTION_CLASS0, NC_RO_GRAPH_OUTPUT_TENSOR_DESCRIPTORS, &outDesc, &length));
+    CHECK(ncFifoInit(NC_FIFO_HOST_WO, &graph.fifoIn));
+    CHECK(ncFifoInit(NC_FIFO_HOST_RO, &graph.fifoOut));
+    CHECK(ncFifoCreate(graph.fifoIn, device, inDesc, depth));
+    CHECK(ncFifoCreate(graph.fifoOut, device, outDesc, depth));
+    // the inputs are FP32, converted to the FP16 tensor of the graph
+    graph.input.resize(inDesc->totalSize / 2);
+}
+
+static void readOutput(Graph& graph)
+{
+    void *output, *userParam;
+    struct ncTensorDescriptor_t desc;
+    CHECK(ncFifoReadElem(graph.fifoOut, &output, &desc, &userParam));
+}
+
+// Keeps depth inferences of the graph in flight
+static void runGraph(Graph& graph, int count, int depth)
+{
+    double start = now();
+    int read = 0;
+    for (int i = 0; i < count; i++) {
+        CHECK(ncGraphQueueInferenceWithFifoElem(graph.handle, &graph.fifoIn, &graph.fifoOut,
+                                                graph.input.data(), NULL, NULL));
+        if (i + 1 - read == depth) {
+            readOutput(graph);
+            read++;
+        }
+    }
+    for (; read < count; read++)
+        readOutput(graph);
+    graph.elapsed = now() - start;
+
+    // the last element is the device time of the whole graph
+    float *timeTaken;
+    unsigned int length;
+    CHECK(ncGraphGetOption(graph.handle, NC_OPTION_CLASS0, NC_RO_GRAPH_TIME_TAKEN, &timeTaken, &length));
+    if (length >= sizeof(float))
+        graph.deviceMs = timeTaken[length / sizeof(float) - 1];
+}
+
+static void usage()
+{
+    printf("Usage: multi_graph [-g <graphs>] [-s <shaves per graph>] [-n <inferences per graph>]\n"
+           "                   [-d <elements in flight>] [-i <inference us>]\n");
+}
+
+int main(int argc, char** argv)
+{
+    int graphCount = 2;
+    int shaves = 16;
+    int count = 1000;
+    int depth = 2;
+    ncsDeviceModelConfig_t model;
+    ncsDeviceModelDefaultConfig(&model);
+    model.inferUs = 2000;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc || argv[i][0] != '-' || strlen(argv[i]) != 2) {
+            usage();
+            return -1;
+        }
+        int value = atoi(argv[i + 1]);
+        switch (argv[i][1]) {
+        case 'g': graphCount = value; break;
+        case 's': shaves = value; break;
+        case 'n': count = value; break;
+        case 'd': depth = value; break;
+        case 'i': model.inferUs = value; break;
+        default:
+            usage();
+            return -1;
+        }
+    }
+    if (graphCount < 1 || shaves < 1 || count < 1 || depth < 1) {
+        usage();
+        return -1;
+    }
+
+    // only used with the loopback transport
+    xLinkDeviceModel_t deviceModel;
+    ncsDeviceModelInit(&deviceModel, &model);
+    XLinkLoopbackSetDevice(&deviceModel, NULL);
+
+    int loglevel = 2;
+    CHECK(ncGlobalSetOption(NC_RW_LOG_LEVEL, &loglevel, sizeof(loglevel)));
+
+    struct deviceHandle_t *device;
+    CHECK(ncDeviceInit(0, &device));
+    CHECK(ncDeviceOpen(device));
+
+    std::vector<Graph> graphs(graphCount);
+    for (int i = 0; i < graphCount; i++)
+        allocateGraph(device, i, shaves, depth, graphs[i]);
+
+    double start = now();
+    std::vector<std::thread> threads;
+    for (auto& graph : graphs)
+        threads.emplace_back(runGraph, std::ref(graph), count, depth);
+    for (auto& thread : threads)
+        thread.join();
+    double elapsed = now() - start;
+
+    for (int i = 0; i < graphCount; i++) {
+        printf("graph %d: %d inferences on %d SHAVEs, %.1f inferences/s, device time %.3f ms\n",
+               i, count, shaves, count / graphs[i].elapsed, graphs[i].deviceMs);
+    }
+    printf("%d graphs: %.1f inferences/s\n", graphCount, graphCount * count / elapsed);
+
+    for (auto& graph : graphs) {
+        CHECK(ncFifoDelete(graph.fifoIn));
+        CHECK(ncFifoDelete(graph.fifoOut));
+        CHECK(ncGraphDeallocate(graph.handle));
+    }
+    CHECK(ncDeviceClose(device));
+    return 0;
+}
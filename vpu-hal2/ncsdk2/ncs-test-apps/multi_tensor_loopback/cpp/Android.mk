@@ -0,0 +1,37 @@
+LOCAL_PATH:= $(call my-dir)
+
+# ==================================
+
+# executable: multi_tensor_loopback
+# libmvnc sources are linked against the loopback XLink stand-in instead of the USB transport
+$(info LOCAL_PATH =$(LOCAL_PATH))
+include $(CLEAR_VARS)
+
+MVNC_SRC:= ../../../api/src
+MV_COMMON_BASE:= $(LOCAL_PATH)/$(MVNC_SRC)/common
+
+LOCAL_SRC_FILES := \
+	multi_tensor_loopback.cpp \
+	../../trigger_loopback/cpp/xlink_loopback.c \
+	$(MVNC_SRC)/mvnc_api.c \
+	$(MVNC_SRC)/fp16.c \
+	$(MVNC_SRC)/mvnc_api_highclass.c \
+	$(MVNC_SRC)/common/components/XLinkConsole/pc/XLinkConsole.c
+
+LOCAL_MODULE := multi_tensor_loopback
+
+LOCAL_C_INCLUDES += \
+	$(LOCAL_PATH) \
+	$(LOCAL_PATH)/../../../api/include \
+	$(MV_COMMON_BASE)/components/XLink/shared \
+	$(MV_COMMON_BASE)/components/XLink/pc \
+	$(MV_COMMON_BASE)/components/XLinkConsole/pc \
+	$(MV_COMMON_BASE)/shared/include
+
+LOCAL_CFLAGS += -D__PC__ -DDEVICE_SHELL_ENABLED -Wno-error
+LOCAL_CFLAGS += -O2 -Wall -pthread -fPIC -MMD -MP -fPIE
+
+LOCAL_SHARED_LIBRARIES := liblog
+LOCAL_STATIC_LIBRARIES :=
+
+include $(BUILD_EXECUTABLE)
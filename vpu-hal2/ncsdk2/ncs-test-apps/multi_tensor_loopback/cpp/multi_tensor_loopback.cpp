@@ -0,0 +1,170 @@
+// Copyright 2017 Intel Corporation.
+// The source code, information and material ("Material") contained herein is
+// owned by Intel Corporation or its suppliers or licensors, and title to such
+// Material remains with Intel Corporation or its suppliers or licensors.
+// The Material contains proprietary information of Intel or its suppliers and
+// licensors. The Material is protected by worldwide copyright laws and treaty
+// provisions.
+// No part of the Material may be used, copied, reproduced, modified, published,
+// uploaded, posted, transmitted, distributed or disclosed in any way without
+// Intel's prior express written permission. No license under any patent,
+// copyright or other intellectual property rights in the Material is granted to
+// or conferred upon you, either expressly, by implication, inducement, estoppel
+// or otherwise.
+// Any license under such intellectual property rights must be express and
+// approved by Intel in writing.
+
+
+// Runs a graph with several inputs and outputs, a FIFO per tensor, against the loopback
+// XLink stand-in and checks that every output element comes from the inputs of its trigger:
+//
+//   LOOPBACK_INPUTS=<inputs> LOOPBACK_OUTPUTS=<outputs> multi_tensor_loopback [-n <inferences>] [-d <elements in flight>]
+//
+// LOOPBACK_OUTPUTS=2 emulates the location and confidence heads of an SSD network.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#include <mvnc.h>
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+#define CHECK(call) \
+    do { \
+        ncStatus_t rc_ = (call); \
+        if (rc_ != NC_OK) { \
+            printf("Error - %s returned %d\n", #call, rc_); \
+            exit(-1); \
+        } \
+    } while (0)
+
+struct Network {
+    struct graphHandle_t *graph;
+    std::vector<struct fifoHandle_t*> fifoIn;
+    std::vector<struct fifoHandle_t*> fifoOut;
+    std::vector<std::vector<unsigned char> > inputs;
+};
+
+// The loopback device fills output j with the sum of the first input bytes plus j
+static unsigned char expectedValue(const Network& net, int index, int output)
+{
+    unsigned char sum = 0;
+    for (size_t i = 0; i < net.inputs.size(); i++)
+        sum += (unsigned char)(index * 7 + i * 31);
+    return sum + output;
+}
+
+static void writeInputs(Network& net, int index)
+{
+    for (size_t i = 0; i < net.fifoIn.size(); i++) {
+        memset(net.inputs[i].data(), (unsigned char)(index * 7 + i * 31), net.inputs[i].size());
+        CHECK(ncFifoWriteElem(net.fifoIn[i], net.inputs[i].data(), NULL, (void*)(size_t)index));
+    }
+}
+
+// Outputs are read in the reverse order, so that the acks are collected by the last output FIFO
+static void readOutputs(Network& net, int index)
+{
+    for (int j = (int)net.fifoOut.size() - 1; j >= 0; j--) {
+        void *output, *userParam;
+        unsigned int length;
+        CHECK(ncFifoBorrowElem(net.fifoOut[j], &output, &length, &userParam));
+        if ((size_t)userParam != (size_t)index) {
+            printf("Error - output %d of element %d returned user param %zu\n", j, index, (size_t)userParam);
+            exit(-1);
+        }
+        unsigned char expected = expectedValue(net, index, j);
+        const unsigned char* data = (const unsigned char*)output;
+        for (unsigned int k = 0; k < length; k++) {
+            if (data[k] != expected) {
+                printf("Error - output %d of element %d has %d at %u, expected %d\n", j, index, data[k], k, expected);
+                exit(-1);
+            }
+        }
+        CHECK(ncFifoReleaseElem(net.fifoOut[j]));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int count = 1000;
+    int depth = 4;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "-n") == 0) {
+            count = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "-d") == 0) {
+            depth = atoi(argv[i + 1]);
+        }
+    }
+    if (count < 1 || depth < 1) {
+        printf("Usage: multi_tensor_loopback [-n <inferences>] [-d <elements in flight>]\n");
+        return -1;
+    }
+
+    int loglevel = 2;
+    CHECK(ncGlobalSetOption(NC_RW_LOG_LEVEL, &loglevel, sizeof(loglevel)));
+    CHECK(ncGlobalSetOption(NC_RW_MAX_PENDING_TRIGGERS, &depth, sizeof(depth)));
+
+    struct deviceHandle_t *device;
+    CHECK(ncDeviceInit(0, &device));
+    CHECK(ncDeviceOpen(device));
+
+    Network net;
+    char blob[64] = {0};
+    CHECK(ncGraphInit("loopback", &net.graph));
+    CHECK(ncGraphAllocate(device, net.graph, blob, sizeof(blob)));
+
+    int numInputs, numOutputs;
+    struct ncTensorDescriptor_t *inDesc, *outDesc;
+    unsigned int length;
+    CHECK(ncGraphGetOption(net.graph, NC_OPTION_CLASS0, NC_RO_GRAPH_INPUT_COUNT, &numInputs, &length));
+    CHECK(ncGraphGetOption(net.graph, NC_OPTION_CLASS0, NC_RO_GRAPH_OUTPUT_COUNT, &numOutputs, &length));
+    CHECK(ncGraphGetOption(net.graph, NC_OPTION_CLASS0, NC_RO_GRAPH_INPUT_TENSOR_DESCRIPTORS, &inDesc, &length));
+    CHECK(ncGraphGetOption(net.graph, NC_OPTION_CLASS0, NC_RO_GRAPH_OUTPUT_TENSOR_DESCRIPTORS, &outDesc, &length));
+
+    net.fifoIn.resize(numInputs);
+    net.inputs.resize(numInputs);
+    for (int i = 0; i < numInputs; i++) {
+        CHECK(ncFifoInit(NC_FIFO_HOST_WO, &net.fifoIn[i]));
+        CHECK(ncFifoCreate(net.fifoIn[i], device, &inDesc[i], depth));
+        net.inputs[i].resize(inDesc[i].totalSize);
+    }
+    net.fifoOut.resize(numOutputs);
+    for (int j = 0; j < numOutputs; j++) {
+        CHECK(ncFifoInit(NC_FIFO_HOST_RO, &net.fifoOut[j]));
+        CHECK(ncFifoCreate(net.fifoOut[j], device, &outDesc[j], depth));
+        printf("output %d : %u bytes\n", j, outDesc[j].totalSize);
+    }
+
+    int read = 0;
+    double start = now();
+    for (int i = 0; i < count; i++) {
+        writeInputs(net, i);
+        CHECK(ncGraphQueueInference(net.graph, net.fifoIn.data(), net.fifoOut.data()));
+        // Keep depth inferences in flight
+        if (i + 1 - read == depth)
+            readOutputs(net, read++);
+    }
+    while (read < count)
+        readOutputs(net, read++);
+    double elapsed = now() - start;
+
+    printf("%d inputs, %d outputs : %8.1f inferences/s, all outputs match their triggers\n",
+           numInputs, numOutputs, count / elapsed);
+
+    for (auto fifo : net.fifoIn)
+        CHECK(ncFifoDelete(fifo));
+    for (auto fifo : net.fifoOut)
+        CHECK(ncFifoDelete(fifo));
+    CHECK(ncGraphDeallocate(net.graph));
+    CHECK(ncDeviceClose(device));
+    return 0;
+}
@@ -0,0 +1,25 @@
+LOCAL_PATH:= $(call my-dir)
+
+# ==================================
+
+# executable: residency_start
+# start time with libmvnc directly or with the graphs kept resident by ncs_residencyd
+$(info LOCAL_PATH =$(LOCAL_PATH))
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+	residency_start.cpp
+
+LOCAL_MODULE := residency_start
+
+LOCAL_C_INCLUDES += \
+	$(LOCAL_PATH) \
+	$(LOCAL_PATH)/../../../api/include
+
+LOCAL_CFLAGS += -Wno-error
+LOCAL_CFLAGS += -O2 -Wall -pthread -fPIC -MMD -MP -fPIE
+
+LOCAL_SHARED_LIBRARIES := libmvnc libncresidency liblog
+LOCAL_STATIC_LIBRARIES :=
+
+include $(BUILD_EXECUTABLE)
@@ -0,0 +1,196 @@
+// Copyright 2017 Intel Corporation.
+// The source code, information and material ("Material") contained herein is
+// owned by Intel Corporation or its suppliers or licensors, and title to such
+// Material remains with Intel Corporation or its suppliers or licensors.
+// The Material contains proprietary information of Intel or its suppliers and
+// licensors. The Material is protected by worldwide copyright laws and treaty
+// provisions.
+// No part of the Material may be used, copied, reproduced, modified, published,
+// uploaded, posted, transmitted, distributed or disclosed in any way without
+// Intel's prior express written permission. No license under any patent,
+// copyright or other intellectual property rights in the Material is granted to
+// or conferred upon you, either expressly, by implication, inducement, estoppel
+// or otherwise.
+// Any license under such intellectual property rights must be express and
+// approved by Intel in writing.
+
+
+// Start time of an inference process, opening the device itself or attaching to the
+// graph kept resident by ncs_residencyd:
+//
+//   residency_start [-m direct|daemon] [-s <graph KB>] [-n <inferences>] [-d <elements in flight>]
+//
+// direct boots the device and allocates the graph like every process without the daemon,
+// daemon sends the graph file to ncs_residencyd only if it is not resident yet. The time
+// to the first output and the throughput of the following inferences are printed.
+// The graph file is a plugin blob header padded to the given size.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+
+#include <mvnc.h>
+#include <ncResidency.h>
+
+// Offsets in the header of the plugin blobs, after the 34 bytes ELF header
+#define BLOB_MAGIC 8708
+#define BLOB_MAGIC_OFFSET 34
+#define BLOB_SHAVES_OFFSET 50
+#define BLOB_HEADER_SIZE 64
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+#define CHECK(call) \
+    do { \
+        ncStatus_t rc_ = (call); \
+        if (rc_ != NC_OK) { \
+            printf("Error - %s returned %d\n", #call, rc_); \
+            exit(-1); \
+        } \
+    } while (0)
+
+static std::vector<char> makeGraphFile(int sizeKB)
+{
+    std::vector<char> blob(std::max(sizeKB * 1024, BLOB_HEADER_SIZE));
+    uint32_t magic = BLOB_MAGIC, shaves = 16;
+    memcpy(&blob[BLOB_MAGIC_OFFSET], &magic, sizeof(magic));
+    memcpy(&blob[BLOB_SHAVES_OFFSET], &shaves, sizeof(shaves));
+    for (size_t i = BLOB_HEADER_SIZE; i < blob.size(); i++)
+        blob[i] = (char)(i * 31);
+    return blob;
+}
+
+// Opens the first device and allocates the graph, then runs the inferences
+static void runDirect(const std::vector<char>& blob, int count, int depth)
+{
+    double start = now();
+    struct deviceHandle_t *device;
+    CHECK(ncDeviceInit(0, &device));
+    CHECK(ncDeviceOpen(device));
+    double opened = now();
+
+    struct graphHandle_t *graph;
+    CHECK(ncGraphInit("residency_start", &graph));
+    CHECK(ncGraphAllocate(device, graph, blob.data(), blob.size()));
+    struct ncTensorDescriptor_t *inDesc, *outDesc;
+    unsigned int length;
+    CHECK(ncGraphGetOption(graph, NC_OPTION_CLASS0, NC_RO_GRAPH_INPUT_TENSOR_DESCRIPTORS, &inDesc, &length));
+    CHECK(ncGraphGetOption(graph, NC_OPTION_CLASS0, NC_RO_GRAPH_OUTPUT_TENSOR_DESCRIPTORS, &outDesc, &length));
+    struct fifoHandle_t *fifoIn, *fifoOut;
+    CHECK(ncFifoInit(NC_FIFO_HOST_WO, &fifoIn));
+    CHECK(ncFifoInit(NC_FIFO_HOST_RO, &fifoOut));
+    CHECK(ncFifoCreate(fifoIn, device, inDesc, depth));
+    CHECK(ncFifoCreate(fifoOut, device, outDesc, depth));
+    double allocated = now();
+
+    std::vector<char> input(inDesc->totalSize), output(outDesc->totalSize);
+    void *userParam;
+    CHECK(ncGraphQueueInferenceWithFifoElem(graph, &fifoIn, &fifoOut, input.data(), NULL, NULL));
+    CHECK(ncFifoReadElemToBuffer(fifoOut, output.data(), output.size(), &userParam));
+    double first = now();
+    printf("direct: device opened in %.3f s, graph allocated in %.3f ms, first output after %.3f s\n",
+           opened - start, (allocated - opened) * 1000, first - start);
+
+    int read = 0;
+    for (int i = 0; i < count; i++) {
+        CHECK(ncGraphQueueInferenceWithFifoElem(graph, &fifoIn, &fifoOut, input.data(), NULL, NULL));
+        if (i + 1 - read == depth) {
+            CHECK(ncFifoReadElemToBuffer(fifoOut, output.data(), output.size(), &userParam));
+            read++;
+        }
+    }
+    for (; read < count; read++)
+        CHECK(ncFifoReadElemToBuffer(fifoOut, output.data(), output.size(), &userParam));
+    printf("direct: %d inferences, %.1f inferences/s\n", count, count / (now() - first));
+
+    CHECK(ncFifoDelete(fifoIn));
+    CHECK(ncFifoDelete(fifoOut));
+    CHECK(ncGraphDeallocate(graph));
+    CHECK(ncDeviceClose(device));
+}
+
+// Attaches to the graph through ncs_residencyd, then runs the inferences
+static void runDaemon(const std::vector<char>& blob, int count, int depth)
+{
+    double start = now();
+    ncResidencyGraph_t *graph;
+    CHECK(ncResidencyAttach(NULL, blob.data(), blob.size(), depth, NC_FIFO_FP16, &graph));
+    double attached = now();
+    const ncResidencyGraphInfo_t *info = ncResidencyGetInfo(graph);
+
+    unsigned int slot;
+    CHECK(ncResidencyQueueInference(graph, 0));
+    CHECK(ncResidencyWaitInference(graph, &slot));
+    double first = now();
+    printf("daemon: attached to the %s graph on device %d in %.3f ms, first output after %.3f s\n",
+           info->resident ? "resident" : "new", info->deviceIndex, (attached - start) * 1000, first - start);
+
+    // the slots are queued in turn, the oldest one is free once waited for
+    int waited = 0;
+    for (int i = 0; i < count; i++) {
+        if (i - waited == depth) {
+            CHECK(ncResidencyWaitInference(graph, &slot));
+            waited++;
+        }
+        CHECK(ncResidencyQueueInference(graph, i % depth));
+    }
+    for (; waited < count; waited++)
+        CHECK(ncResidencyWaitInference(graph, &slot));
+    printf("daemon: %d inferences, %.1f inferences/s\n", count, count / (now() - first));
+
+    CHECK(ncResidencyDetach(graph));
+}
+
+static void usage()
+{
+    printf("Usage: residency_start [-m direct|daemon] [-s <graph KB>] [-n <inferences>]\n"
+           "                       [-d <elements in flight>]\n");
+}
+
+int main(int argc, char** argv)
+{
+    const char* mode = "daemon";
+    int sizeKB = 4096;
+    int count = 200;
+    int depth = 2;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc || argv[i][0] != '-' || strlen(argv[i]) != 2) {
+            usage();
+            return -1;
+        }
+        const char* value = argv[i + 1];
+        switch (argv[i][1]) {
+        case 'm': mode = value; break;
+        case 's': sizeKB = atoi(value); break;
+        case 'n': count = atoi(value); break;
+        case 'd': depth = atoi(value); break;
+        default:
+            usage();
+            return -1;
+        }
+    }
+    if (count < 1 || depth < 1 || depth > NC_RESIDENCY_MAX_SLOTS) {
+        usage();
+        return -1;
+    }
+
+    std::vector<char> blob = makeGraphFile(sizeKB);
+    if (!strcmp(mode, "direct")) {
+        runDirect(blob, count, depth);
+    } else if (!strcmp(mode, "daemon")) {
+        runDaemon(blob, count, depth);
+    } else {
+        usage();
+        return -1;
+    }
+    return 0;
+}
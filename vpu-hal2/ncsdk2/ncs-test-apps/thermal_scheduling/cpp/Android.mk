@@ -0,0 +1,37 @@
+LOCAL_PATH:= $(call my-dir)
+
+# ==================================
+
+# executable: thermal_scheduling
+# libmvnc with the transport selected by XLINK_TRANSPORT, the thermal monitor of the MYRIAD plugin
+# and the device model of xlink_emulator
+$(info LOCAL_PATH =$(LOCAL_PATH))
+include $(CLEAR_VARS)
+
+MVNC_SRC:= ../../../api/src
+MV_COMMON_BASE:= $(LOCAL_PATH)/$(MVNC_SRC)/common
+MYRIAD_PLUGIN:= ../../../../dl/inference-engine/src/vpu/myriad_plugin
+
+LOCAL_SRC_FILES := \
+	thermal_scheduling.cpp \
+	$(MYRIAD_PLUGIN)/myriad_thermal_monitor.cpp \
+	../../xlink_emulator/cpp/ncs_device_model.c
+
+LOCAL_MODULE := thermal_scheduling
+
+LOCAL_C_INCLUDES += \
+	$(LOCAL_PATH) \
+	$(LOCAL_PATH)/$(MYRIAD_PLUGIN) \
+	$(LOCAL_PATH)/../../xlink_emulator/cpp \
+	$(LOCAL_PATH)/../../../api/include \
+	$(MV_COMMON_BASE)/components/XLink/shared \
+	$(MV_COMMON_BASE)/components/XLink/pc \
+	$(MV_COMMON_BASE)/shared/include
+
+LOCAL_CFLAGS += -D__PC__ -Wno-error
+LOCAL_CFLAGS += -O2 -Wall -pthread -fPIC -MMD -MP -fPIE
+
+LOCAL_SHARED_LIBRARIES := libmvnc liblog
+LOCAL_STATIC_LIBRARIES :=
+
+include $(BUILD_EXECUTABLE)
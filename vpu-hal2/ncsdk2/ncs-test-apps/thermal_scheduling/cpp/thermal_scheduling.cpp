@@ -0,0 +1,227 @@
+// Copyright 2017 Intel Corporation.
+// The source code, information and material ("Material") contained herein is
+// owned by Intel Corporation or its suppliers or licensors, and title to such
+// Material remains with Intel Corporation or its suppliers or licensors.
+// The Material contains proprietary information of Intel or its suppliers and
+// licensors. The Material is protected by worldwide copyright laws and treaty
+// provisions.
+// No part of the Material may be used, copied, reproduced, modified, published,
+// uploaded, posted, transmitted, distributed or disclosed in any way without
+// Intel's prior express written permission. No license under any patent,
+// copyright or other intellectual property rights in the Material is granted to
+// or conferred upon you, either expressly, by implication, inducement, estoppel
+// or otherwise.
+// Any license under such intellectual property rights must be express and
+// approved by Intel in writing.
+
+
+// Thermal aware scheduling of inferences with the thermal monitor of the MYRIAD plugin:
+//
+//   thermal_scheduling [-p none|balance|pace] [-t <target C>] [-s <seconds>] [-n <devices>]
+//                      [-d <elements in flight>] [-P <sample period ms>] [-i <inference us>]
+//
+// Inferences are submitted to the devices as fast as they complete, round robin, to the
+// coolest device (balance) or spaced to keep the devices under the target (pace). Every
+// second the temperature, throttling level and throughput of each device are printed.
+// With XLINK_TRANSPORT=loopback the NCS device model runs in-process, its temperature
+// follows the load with the NCS_MODEL_* parameters of the environment.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+#include <mvnc.h>
+#include "XLinkLoopbackTransport.h"
+#include "ncs_device_model.h"
+#include "myriad_thermal_monitor.h"
+
+using VPU::MyriadPlugin::ThermalMonitor;
+using VPU::MyriadPlugin::ThermalStatus;
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+#define CHECK(call) \
+    do { \
+        ncStatus_t rc_ = (call); \
+        if (rc_ != NC_OK) { \
+            printf("Error - %s returned %d\n", #call, rc_); \
+            exit(-1); \
+        } \
+    } while (0)
+
+struct Device {
+    struct deviceHandle_t *handle;
+    struct graphHandle_t *graph;
+    struct fifoHandle_t *fifoIn, *fifoOut;
+    std::vector<float> input;
+    int inFlight = 0;
+    long done = 0;
+    long doneReported = 0;
+    long failed = 0;
+};
+
+static void openDevice(int index, int depth, Device& dev)
+{
+    CHECK(ncDeviceInit(index, &dev.handle));
+    CHECK(ncDeviceOpen(dev.handle));
+
+    char blob[64] = {0};
+    CHECK(ncGraphInit("thermal", &dev.graph));
+    CHECK(ncGraphAllocate(dev.handle, dev.graph, blob, sizeof(blob)));
+
+    struct ncTensorDescriptor_t *inDesc, *outDesc;
+    unsigned int length;
+    CHECK(ncGraphGetOption(dev.graph, NC_OPTION_CLASS0, NC_RO_GRAPH_INPUT_TENSOR_DESCRIPTORS, &inDesc, &length));
+    CHECK(ncGraphGetOption(dev.graph, NC_OPTION_CLASS0, NC_RO_GRAPH_OUTPUT_TENSOR_DESCRIPTORS, &outDesc, &length));
+    CHECK(ncFifoInit(NC_FIFO_HOST_WO, &dev.fifoIn));
+    CHECK(ncFifoInit(NC_FIFO_HOST_RO, &dev.fifoOut));
+    CHECK(ncFifoCreate(dev.fifoIn, dev.handle, inDesc, depth));
+    CHECK(ncFifoCreate(dev.fifoOut, dev.handle, outDesc, depth));
+    // the inputs are FP32, converted to the FP16 tensor of the graph
+    dev.input.resize(inDesc->totalSize / 2);
+}
+
+static void closeDevice(Device& dev)
+{
+    CHECK(ncFifoDelete(dev.fifoIn));
+    CHECK(ncFifoDelete(dev.fifoOut));
+    CHECK(ncGraphDeallocate(dev.graph));
+    CHECK(ncDeviceClose(dev.handle));
+}
+
+static void readOutput(Device& dev)
+{
+    void *output, *userParam;
+    struct ncTensorDescriptor_t desc;
+    ncStatus_t rc = ncFifoReadElem(dev.fifoOut, &output, &desc, &userParam);
+    if (rc == NC_MYRIAD_ERROR) {
+        dev.failed++;
+    } else if (rc != NC_OK) {
+        printf("Error - ncFifoReadElem returned %d\n", rc);
+        exit(-1);
+    }
+    dev.inFlight--;
+    dev.done++;
+}
+
+static void usage()
+{
+    printf("Usage: thermal_scheduling [-p none|balance|pace] [-t <target C>] [-s <seconds>] [-n <devices>]\n"
+           "                          [-d <elements in flight>] [-P <sample period ms>] [-i <inference us>]\n");
+}
+
+int main(int argc, char** argv)
+{
+    std::string policy = "none";
+    float target = 75.f;
+    int seconds = 20;
+    int count = 1;
+    int depth = 2;
+    int periodMs = 250;
+    ncsDeviceModelConfig_t model;
+    ncsDeviceModelDefaultConfig(&model);
+    model.inferUs = 2000;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc || argv[i][0] != '-' || strlen(argv[i]) != 2) {
+            usage();
+            return -1;
+        }
+        const char* value = argv[i + 1];
+        switch (argv[i][1]) {
+        case 'p': policy = value; break;
+        case 't': target = (float)atof(value); break;
+        case 's': seconds = atoi(value); break;
+        case 'n': count = atoi(value); break;
+        case 'd': depth = atoi(value); break;
+        case 'P': periodMs = atoi(value); break;
+        case 'i': model.inferUs = atoi(value); break;
+        default:
+            usage();
+            return -1;
+        }
+    }
+    if ((policy != "none" && policy != "balance" && policy != "pace") ||
+        seconds < 1 || count < 1 || depth < 1 || periodMs < 1) {
+        usage();
+        return -1;
+    }
+
+    // only used with the loopback transport
+    xLinkDeviceModel_t deviceModel;
+    ncsDeviceModelInit(&deviceModel, &model);
+    XLinkLoopbackSetDevice(&deviceModel, NULL);
+
+    int loglevel = 2;
+    CHECK(ncGlobalSetOption(NC_RW_LOG_LEVEL, &loglevel, sizeof(loglevel)));
+    CHECK(ncGlobalSetOption(NC_RW_MAX_PENDING_TRIGGERS, &depth, sizeof(depth)));
+
+    std::vector<Device> devices(count);
+    std::vector<struct deviceHandle_t*> handles;
+    for (int i = 0; i < count; i++) {
+        openDevice(i, depth, devices[i]);
+        handles.push_back(devices[i].handle);
+    }
+
+    ThermalMonitor monitor(std::chrono::milliseconds(periodMs), target);
+    for (auto handle : handles)
+        monitor.addDevice(handle);
+
+    printf("policy %s, target %.1f C, %d device(s)\n", policy.c_str(), target, count);
+    double start = now();
+    double report = start + 1;
+    int next = 0;
+    while (now() - start < seconds) {
+        int d = policy == "balance" ? (int)monitor.selectCoolest(handles) : next;
+        next = (next + 1) % count;
+        Device& dev = devices[d];
+        if (dev.inFlight == depth)
+            readOutput(dev);
+        if (policy == "pace")
+            monitor.pace(dev.handle);
+        CHECK(ncGraphQueueInferenceWithFifoElem(dev.graph, &dev.fifoIn, &dev.fifoOut, dev.input.data(), NULL, NULL));
+        dev.inFlight++;
+
+        if (now() >= report) {
+            printf("%4.0f s", report - start);
+            for (int i = 0; i < count; i++) {
+                ThermalStatus status = monitor.getStatus(devices[i].handle);
+                printf(" | dev %d %5.1f C level %d, %5ld inf/s, interval %3.0f ms", i,
+                       status.temperature, status.throttlingLevel, devices[i].done - devices[i].doneReported,
+                       status.submissionInterval.count() / 1e3);
+                devices[i].doneReported = devices[i].done;
+            }
+            printf("\n");
+            report += 1;
+        }
+    }
+    for (auto& dev : devices) {
+        while (dev.inFlight)
+            readOutput(dev);
+    }
+    double elapsed = now() - start;
+    monitor.stop();
+
+    long total = 0;
+    for (int i = 0; i < count; i++) {
+        ThermalStatus status = monitor.getStatus(devices[i].handle);
+        printf("dev %d: %ld inferences (%ld failed), max %.1f C, throttled %lu of %lu samples, "
+               "%lu paced submissions waited %.3f s\n",
+               i, devices[i].done, devices[i].failed, status.maxTemperature,
+               (unsigned long)status.throttledSamples, (unsigned long)status.samples,
+               (unsigned long)status.pacedSubmissions, status.pacedTime.count() / 1e6);
+        total += devices[i].done;
+    }
+    printf("%.1f inferences/s\n", total / elapsed);
+
+    for (auto& dev : devices)
+        closeDevice(dev);
+    return 0;
+}
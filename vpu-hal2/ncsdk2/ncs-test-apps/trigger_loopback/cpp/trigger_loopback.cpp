@@ -0,0 +1,203 @@
+// Copyright 2017 Intel Corporation.
+// The source code, information and material ("Material") contained herein is
+// owned by Intel Corporation or its suppliers or licensors, and title to such
+// Material remains with Intel Corporation or its suppliers or licensors.
+// The Material contains proprietary information of Intel or its suppliers and
+// licensors. The Material is protected by worldwide copyright laws and treaty
+// provisions.
+// No part of the Material may be used, copied, reproduced, modified, published,
+// uploaded, posted, transmitted, distributed or disclosed in any way without
+// Intel's prior express written permission. No license under any patent,
+// copyright or other intellectual property rights in the Material is granted to
+// or conferred upon you, either expressly, by implication, inducement, estoppel
+// or otherwise.
+// Any license under such intellectual property rights must be express and
+// approved by Intel in writing.
+
+
+// Measures graph triggers per second against the loopback XLink stand-in
+// with synchronous (1 trigger in flight) and pipelined graph triggers:
+//
+//   trigger_loopback [-n <inferences>] [-d <elements in flight>]
+//
+// Link latency, inference time and trigger failures are configured with the
+// LOOPBACK_LATENCY_US, LOOPBACK_INFER_US and LOOPBACK_FAIL_EVERY environment variables.
+// Then checks that a graph can be used again after ncGraphAllocate has failed
+// to read the acks of the triggers in flight.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <mvnc.h>
+#include "xlink_loopback.h"
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+#define CHECK(call) \
+    do { \
+        ncStatus_t rc_ = (call); \
+        if (rc_ != NC_OK) { \
+            printf("Error - %s returned %d\n", #call, rc_); \
+            exit(-1); \
+        } \
+    } while (0)
+
+// Returns 1 if the trigger of the element has failed
+static int readOutput(struct fifoHandle_t *fifoOut, int index)
+{
+    void *output, *userParam;
+    struct ncTensorDescriptor_t desc;
+    ncStatus_t rc = ncFifoReadElem(fifoOut, &output, &desc, &userParam);
+    if (rc == NC_MYRIAD_ERROR)
+        return 1;
+    if (rc != NC_OK) {
+        printf("Error - ncFifoReadElem returned %d\n", rc);
+        exit(-1);
+    }
+    if ((size_t)userParam != (size_t)index) {
+        printf("Error - element %d returned user param %zu\n", index, (size_t)userParam);
+        exit(-1);
+    }
+    return 0;
+}
+
+static void run(int pendingTriggers, int count, int depth)
+{
+    CHECK(ncGlobalSetOption(NC_RW_MAX_PENDING_TRIGGERS, &pendingTriggers, sizeof(pendingTriggers)));
+
+    struct deviceHandle_t *device;
+    struct graphHandle_t *graph;
+    CHECK(ncDeviceInit(0, &device));
+    CHECK(ncDeviceOpen(device));
+
+    char blob[64] = {0};
+    CHECK(ncGraphInit("loopback", &graph));
+    CHECK(ncGraphAllocate(device, graph, blob, sizeof(blob)));
+
+    struct ncTensorDescriptor_t *inDesc, *outDesc;
+    unsigned int length;
+    CHECK(ncGraphGetOption(graph, NC_OPTION_CLASS0, NC_RO_GRAPH_INPUT_TENSOR_DESCRIPTORS, &inDesc, &length));
+    CHECK(ncGraphGetOption(graph, NC_OPTION_CLASS0, NC_RO_GRAPH_OUTPUT_TENSOR_DESCRIPTORS, &outDesc, &length));
+
+    struct fifoHandle_t *fifoIn, *fifoOut;
+    CHECK(ncFifoInit(NC_FIFO_HOST_WO, &fifoIn));
+    CHECK(ncFifoInit(NC_FIFO_HOST_RO, &fifoOut));
+    CHECK(ncFifoCreate(fifoIn, device, inDesc, depth));
+    CHECK(ncFifoCreate(fifoOut, device, outDesc, depth));
+
+    char *input = (char*)calloc(1, inDesc->totalSize);
+    int failed = 0;
+    int read = 0;
+    double start = now();
+    for (int i = 0; i < count; i++) {
+        CHECK(ncGraphQueueInferenceWithFifoElem(graph, &fifoIn, &fifoOut, input, NULL, (void*)(size_t)i));
+        // Keep depth inferences in flight
+        if (i + 1 - read == depth)
+            failed += readOutput(fifoOut, read++);
+    }
+    while (read < count)
+        failed += readOutput(fifoOut, read++);
+    double elapsed = now() - start;
+    free(input);
+
+    printf("pending triggers %2d : %8.1f triggers/s, %d failed triggers reported by ncFifoReadElem\n",
+           pendingTriggers, count / elapsed, failed);
+
+    CHECK(ncFifoDelete(fifoIn));
+    CHECK(ncFifoDelete(fifoOut));
+    CHECK(ncGraphDeallocate(graph));
+    CHECK(ncDeviceClose(device));
+}
+
+// ncGraphAllocate flushes the acks of the triggers in flight before its own request.
+// When the link fails there it must return an error and leave the graph monitor unlocked,
+// so that the calls which follow don't hang.
+static void runAllocateLinkError(int depth)
+{
+    CHECK(ncGlobalSetOption(NC_RW_MAX_PENDING_TRIGGERS, &depth, sizeof(depth)));
+
+    struct deviceHandle_t *device;
+    struct graphHandle_t *graph, *graph2;
+    CHECK(ncDeviceInit(0, &device));
+    CHECK(ncDeviceOpen(device));
+
+    char blob[64] = {0};
+    CHECK(ncGraphInit("loopback", &graph));
+    CHECK(ncGraphAllocate(device, graph, blob, sizeof(blob)));
+
+    struct ncTensorDescriptor_t *inDesc, *outDesc;
+    unsigned int length;
+    CHECK(ncGraphGetOption(graph, NC_OPTION_CLASS0, NC_RO_GRAPH_INPUT_TENSOR_DESCRIPTORS, &inDesc, &length));
+    CHECK(ncGraphGetOption(graph, NC_OPTION_CLASS0, NC_RO_GRAPH_OUTPUT_TENSOR_DESCRIPTORS, &outDesc, &length));
+
+    struct fifoHandle_t *fifoIn, *fifoOut;
+    CHECK(ncFifoInit(NC_FIFO_HOST_WO, &fifoIn));
+    CHECK(ncFifoInit(NC_FIFO_HOST_RO, &fifoOut));
+    CHECK(ncFifoCreate(fifoIn, device, inDesc, depth));
+    CHECK(ncFifoCreate(fifoOut, device, outDesc, depth));
+
+    char *input = (char*)calloc(1, inDesc->totalSize);
+    for (int i = 0; i < depth; i++)
+        CHECK(ncGraphQueueInferenceWithFifoElem(graph, &fifoIn, &fifoOut, input, NULL, (void*)(size_t)i));
+    free(input);
+
+    loopbackSetLinkDown(1);
+    CHECK(ncGraphInit("loopback2", &graph2));
+    // Killed by SIGALRM if the graph monitor is left locked
+    alarm(10);
+    if (ncGraphAllocate(device, graph2, blob, sizeof(blob)) == NC_OK) {
+        printf("Error - ncGraphAllocate succeeded on a broken link\n");
+        exit(-1);
+    }
+    if (ncGraphDeallocate(graph) == NC_OK) {
+        printf("Error - ncGraphDeallocate succeeded on a broken link\n");
+        exit(-1);
+    }
+    loopbackSetLinkDown(0);
+
+    int failed = 0;
+    for (int i = 0; i < depth; i++)
+        failed += readOutput(fifoOut, i);
+    alarm(0);
+
+    printf("ncGraphAllocate error with %d triggers in flight : OK, %d failed triggers reported by ncFifoReadElem\n",
+           depth, failed);
+
+    CHECK(ncFifoDelete(fifoIn));
+    CHECK(ncFifoDelete(fifoOut));
+    CHECK(ncGraphDeallocate(graph));
+    CHECK(ncDeviceClose(device));
+}
+
+int main(int argc, char** argv)
+{
+    int count = 1000;
+    int depth = 4;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "-n") == 0) {
+            count = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "-d") == 0) {
+            depth = atoi(argv[i + 1]);
+        }
+    }
+    if (count < 1 || depth < 1) {
+        printf("Usage: trigger_loopback [-n <inferences>] [-d <elements in flight>]\n");
+        return -1;
+    }
+
+    int loglevel = 2;
+    CHECK(ncGlobalSetOption(NC_RW_LOG_LEVEL, &loglevel, sizeof(loglevel)));
+
+    run(1, count, depth);
+    run(depth, count, depth);
+    runAllocateLinkError(depth);
+    return 0;
+}
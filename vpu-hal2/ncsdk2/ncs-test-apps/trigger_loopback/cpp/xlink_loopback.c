@@ -0,0 +1,644 @@
+/*
+* Copyright 2017 Intel Corporation.
+* The source code, information and material ("Material") contained herein is
+* owned by Intel Corporation or its suppliers or licensors, and title to such
+* Material remains with Intel Corporation or its suppliers or licensors.
+* The Material contains proprietary information of Intel or its suppliers and
+* licensors. The Material is protected by worldwide copyright laws and treaty
+* provisions.
+* No part of the Material may be used, copied, reproduced, modified, published,
+* uploaded, posted, transmitted, distributed or disclosed in any way without
+* Intel's prior express written permission. No license under any patent,
+* copyright or other intellectual property rights in the Material is granted to
+* or conferred upon you, either expressly, by implication, inducement, estoppel
+* or otherwise.
+* Any license under such intellectual property rights must be express and
+* approved by Intel in writing.
+*/
+
+///
+/// @brief     Host-side loopback stand-in for the XLink API
+///
+/// Emulates a device answering the mvnc graph/device monitor protocol in a thread,
+/// so that libmvnc host code can be exercised without hardware.
+/// Environment:
+///   LOOPBACK_LATENCY_US - one way link latency, 500 by default
+///   LOOPBACK_INFER_US   - inference time on the device, 200 by default
+///   LOOPBACK_FAIL_EVERY - every N-th graph trigger is NACKed, 0 (never) by default
+///   LOOPBACK_INPUTS     - number of graph inputs, 1 by default
+///   LOOPBACK_OUTPUTS    - number of graph outputs, 1 by default (1000 classes),
+///                         2 emulates SSD location and confidence heads
+/// Every byte of output j is the sum of the first bytes of the inputs plus j,
+/// so the routing of the tensors to their FIFOs can be checked.
+///
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+
+#include "XLink.h"
+#include "ncCommPrivate.h"
+#include "xlink_loopback.h"
+
+#define LOOPBACK_MAX_STREAMS 32
+#define LOOPBACK_MAX_PACKETS 64
+#define LOOPBACK_MAX_FIFOS 32
+#define LOOPBACK_MAX_JOBS 64
+
+#define LOOPBACK_INPUT_C 3
+#define LOOPBACK_INPUT_H 32
+#define LOOPBACK_INPUT_W 32
+#define LOOPBACK_OUTPUT_C 1000
+#define LOOPBACK_SSD_PRIORS 1917
+#define LOOPBACK_SSD_CLASSES 21
+#define LOOPBACK_FP16_SIZE 2
+#define LOOPBACK_MAX_INPUTS 3
+#define LOOPBACK_MAX_OUTPUTS 2
+
+#define LOOPBACK_THERMAL_SIZE (100 + sizeof(float))
+#define LOOPBACK_OPT_LIST_SIZE (40 * 50)
+#define LOOPBACK_DEBUG_SIZE 120
+
+typedef struct {
+    streamPacketDesc_t desc;
+    double deliverTime;
+} loopbackPacket_t;
+
+typedef struct {
+    loopbackPacket_t packets[LOOPBACK_MAX_PACKETS];
+    int head;
+    int count;
+    int reading;    // packets returned by XLinkReadData and not released yet
+} loopbackQueue_t;
+
+typedef struct {
+    int used;
+    char name[64];
+    loopbackQueue_t toDevice;
+    loopbackQueue_t toHost;
+    XLinkWriteToken_t asyncWrites;  // writes are copied when queued, so they complete at once
+} loopbackStream_t;
+
+typedef struct {
+    uint32_t id;
+    uint32_t size;
+    streamId_t stream;
+} loopbackFifo_t;
+
+typedef struct {
+    uint32_t inFifo[LOOPBACK_MAX_INPUTS];
+    uint32_t outFifo[LOOPBACK_MAX_OUTPUTS];
+    int inCount;
+    int outCount;
+} loopbackJob_t;
+
+static loopbackStream_t streams[LOOPBACK_MAX_STREAMS];
+static loopbackFifo_t fifos[LOOPBACK_MAX_FIFOS];
+static int fifoCount;
+static loopbackJob_t jobs[LOOPBACK_MAX_JOBS];
+static int jobHead, jobCount;
+static uint32_t triggerCount;
+static double deviceBusyUntil;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+static pthread_t deviceThread;
+static int deviceRunning;
+static int linkDown;
+
+static double latency, inferTime;
+static uint32_t failEvery;
+static int inputCount, outputCount;
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double envSeconds(const char* name, int defaultUs)
+{
+    const char* value = getenv(name);
+    return (value ? atoi(value) : defaultUs) * 1e-6;
+}
+
+static void waitUntil(double deadline)
+{
+    double t = deadline - now();
+    if (t > 0.01)
+        t = 0.01;
+    if (t < 1e-5)
+        t = 1e-5;
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    long nsec = ts.tv_nsec + (long)(t * 1e9);
+    ts.tv_sec += nsec / 1000000000;
+    ts.tv_nsec = nsec % 1000000000;
+    pthread_cond_timedwait(&cond, &lock, &ts);
+}
+
+static int envCount(const char* name, int maxValue)
+{
+    int value = getenv(name) ? atoi(getenv(name)) : 1;
+    return value < 1 ? 1 : value > maxValue ? maxValue : value;
+}
+
+static int push(loopbackQueue_t* q, const void* data, uint32_t length, double deliverTime)
+{
+    if (q->count == LOOPBACK_MAX_PACKETS)
+        return -1;
+    loopbackPacket_t* p = &q->packets[(q->head + q->count) % LOOPBACK_MAX_PACKETS];
+    p->desc.data = malloc(length);
+    if (!p->desc.data)
+        return -1;
+    if (data)
+        memcpy(p->desc.data, data, length);
+    else
+        memset(p->desc.data, 0, length);
+    p->desc.length = length;
+    p->deliverTime = deliverTime;
+    q->count++;
+    pthread_cond_broadcast(&cond);
+    return 0;
+}
+
+static loopbackPacket_t* peek(loopbackQueue_t* q, int index)
+{
+    if (index >= q->count)
+        return NULL;
+    loopbackPacket_t* p = &q->packets[(q->head + index) % LOOPBACK_MAX_PACKETS];
+    return p->deliverTime <= now() ? p : NULL;
+}
+
+static void pop(loopbackQueue_t* q)
+{
+    free(q->packets[q->head].desc.data);
+    q->head = (q->head + 1) % LOOPBACK_MAX_PACKETS;
+    q->count--;
+    pthread_cond_broadcast(&cond);
+}
+
+static void clearQueue(loopbackQueue_t* q)
+{
+    while (q->count)
+        pop(q);
+    q->reading = 0;
+}
+
+static streamId_t findStream(const char* name)
+{
+    for (streamId_t i = 0; i < LOOPBACK_MAX_STREAMS; i++) {
+        if (streams[i].used && strcmp(streams[i].name, name) == 0)
+            return i;
+    }
+    return INVALID_STREAM_ID;
+}
+
+static loopbackFifo_t* findFifo(uint32_t id)
+{
+    for (int i = 0; i < fifoCount; i++) {
+        if (fifos[i].id == id)
+            return &fifos[i];
+    }
+    return NULL;
+}
+
+static void reply(streamId_t id, const void* data, uint32_t length)
+{
+    push(&streams[id].toHost, data, length, now() + latency);
+}
+
+static void ack(streamId_t id, int value)
+{
+    reply(id, &value, sizeof(value));
+}
+
+//////////////////////////// Device side ////////////////////////////
+
+static void handleDeviceCommand(streamId_t id, const deviceCommand_t* cmd)
+{
+    switch (cmd->type.c0) {
+    case CLASS0_DEVICE_CAPABILITIES: {
+        deviceCapabilities_t caps;
+        memset(&caps, 0, sizeof(caps));
+        caps.max_graphs = 10;
+        caps.max_fifos = LOOPBACK_MAX_FIFOS;
+        caps.max_memory = 512 * 1024 * 1024;
+        caps.max_graph_opt_class = 1;
+        caps.max_executors = 1;
+        caps.fw_version[0] = 2;
+        reply(id, &caps, sizeof(caps));
+        break;
+    }
+    case CLASS0_DEVICE_USED_MEMORY: {
+        uint32_t used = 0;
+        reply(id, &used, sizeof(used));
+        break;
+    }
+    case CLASS0_THERMAL_STATS:
+        reply(id, NULL, LOOPBACK_THERMAL_SIZE);
+        break;
+    case CLASS0_OPT_LIST:
+        reply(id, NULL, LOOPBACK_OPT_LIST_SIZE);
+        break;
+    }
+}
+
+static void allocateGraph(streamId_t id, const graphCommand_t* cmd)
+{
+    streamId_t graphStream = findStream(cmd->streamName);
+    if (graphStream == INVALID_STREAM_ID) {
+        ack(id, 1);
+        return;
+    }
+    // The graph file follows the command
+    while (deviceRunning && !peek(&streams[graphStream].toDevice, 0))
+        waitUntil(now() + latency);
+    if (!deviceRunning)
+        return;
+    pop(&streams[graphStream].toDevice);
+
+    struct tensorDescriptor_t in[LOOPBACK_MAX_INPUTS];
+    for (int i = 0; i < inputCount; i++) {
+        struct tensorDescriptor_t desc = {1, LOOPBACK_INPUT_C, LOOPBACK_INPUT_W, LOOPBACK_INPUT_H,
+            LOOPBACK_INPUT_C * LOOPBACK_INPUT_H * LOOPBACK_INPUT_W * LOOPBACK_FP16_SIZE};
+        in[i] = desc;
+    }
+    struct tensorDescriptor_t out[LOOPBACK_MAX_OUTPUTS] = {
+        {1, LOOPBACK_OUTPUT_C, 1, 1, LOOPBACK_OUTPUT_C * LOOPBACK_FP16_SIZE}
+    };
+    if (outputCount == 2) {
+        struct tensorDescriptor_t loc = {1, LOOPBACK_SSD_PRIORS * 4, 1, 1,
+            LOOPBACK_SSD_PRIORS * 4 * LOOPBACK_FP16_SIZE};
+        struct tensorDescriptor_t conf = {1, LOOPBACK_SSD_PRIORS * LOOPBACK_SSD_CLASSES, 1, 1,
+            LOOPBACK_SSD_PRIORS * LOOPBACK_SSD_CLASSES * LOOPBACK_FP16_SIZE};
+        out[0] = loc;
+        out[1] = conf;
+    }
+    uint32_t nstages = 1;
+    reply(graphStream, in, inputCount * sizeof(in[0]));
+    reply(graphStream, out, outputCount * sizeof(out[0]));
+    reply(graphStream, &nstages, sizeof(nstages));
+    ack(id, 0);
+}
+
+static void handleGraphMonitorCommand(streamId_t id, const graphMonCommand_t* cmd)
+{
+    switch (cmd->cmdClass) {
+    case GRAPH_MON_CLASS_GRAPH_CMD:
+        if (cmd->cmd.graphCmd.type == GRAPH_ALLOCATE_CMD) {
+            allocateGraph(id, &cmd->cmd.graphCmd);
+        } else if (cmd->cmd.graphCmd.type == GRAPH_TRIGGER_CMD) {
+            triggerCount++;
+            if ((failEvery && triggerCount % failEvery == 0) || jobCount == LOOPBACK_MAX_JOBS) {
+                ack(id, 1);
+                break;
+            }
+            const graphCommand_t* trigger = &cmd->cmd.graphCmd;
+            loopbackJob_t* job = &jobs[(jobHead + jobCount) % LOOPBACK_MAX_JOBS];
+            job->inCount = trigger->inputCount ? trigger->inputCount : 1;
+            job->outCount = trigger->outputCount ? trigger->outputCount : 1;
+            if (job->inCount != inputCount || job->outCount != outputCount) {
+                ack(id, 1);
+                break;
+            }
+            int ext = 0;
+            job->inFifo[0] = trigger->buffId1;
+            for (int i = 1; i < job->inCount; i++)
+                job->inFifo[i] = trigger->buffIdExt[ext++];
+            job->outFifo[0] = trigger->buffId2;
+            for (int i = 1; i < job->outCount; i++)
+                job->outFifo[i] = trigger->buffIdExt[ext++];
+            jobCount++;
+            // Trigger is acked once queued, not when the inference is done
+            ack(id, 0);
+        } else {
+            ack(id, 0);
+        }
+        break;
+    case GRAPH_MON_CLASS_BUFFER_CMD:
+        if (cmd->cmd.buffCmd.type == BUFFER_ALLOCATE_CMD && fifoCount < LOOPBACK_MAX_FIFOS) {
+            char name[17];
+            memcpy(name, cmd->cmd.buffCmd.name, 16);
+            name[16] = '\0';
+            fifos[fifoCount].id = cmd->cmd.buffCmd.id;
+            fifos[fifoCount].size = cmd->cmd.buffCmd.desc.totalSize;
+            fifos[fifoCount].stream = findStream(name);
+            fifoCount++;
+        }
+        ack(id, 0);
+        break;
+    case GRAPH_MON_CLASS_GET_CLASS0:
+        if (cmd->cmd.optionCmd.type.c0 == CLASS0_TIMING_DATA) {
+            reply(id, NULL, sizeof(float));
+        } else {
+            reply(id, NULL, LOOPBACK_DEBUG_SIZE);
+        }
+        ack(id, 0);
+        break;
+    default:
+        ack(id, 0);
+        break;
+    }
+}
+
+static void dropJob()
+{
+    jobHead = (jobHead + 1) % LOOPBACK_MAX_JOBS;
+    jobCount--;
+}
+
+// Runs the oldest queued inference once all its inputs have arrived
+static int runInference()
+{
+    if (!jobCount || now() < deviceBusyUntil)
+        return 0;
+    loopbackJob_t* job = &jobs[jobHead];
+    loopbackFifo_t* in[LOOPBACK_MAX_INPUTS];
+    loopbackFifo_t* out[LOOPBACK_MAX_OUTPUTS];
+    for (int i = 0; i < job->inCount; i++) {
+        in[i] = findFifo(job->inFifo[i]);
+        if (!in[i] || in[i]->stream == INVALID_STREAM_ID) {
+            dropJob();
+            return 1;
+        }
+    }
+    for (int i = 0; i < job->outCount; i++) {
+        out[i] = findFifo(job->outFifo[i]);
+        if (!out[i] || out[i]->stream == INVALID_STREAM_ID) {
+            dropJob();
+            return 1;
+        }
+    }
+    uint8_t sum = 0;
+    for (int i = 0; i < job->inCount; i++) {
+        loopbackPacket_t* p = peek(&streams[in[i]->stream].toDevice, 0);
+        if (!p)
+            return 0;
+        sum += p->desc.length ? p->desc.data[0] : 0;
+    }
+    for (int i = 0; i < job->inCount; i++)
+        pop(&streams[in[i]->stream].toDevice);
+    deviceBusyUntil = now() + inferTime;
+    for (int i = 0; i < job->outCount; i++) {
+        loopbackQueue_t* q = &streams[out[i]->stream].toHost;
+        if (push(q, NULL, out[i]->size, deviceBusyUntil + latency) == 0) {
+            loopbackPacket_t* p = &q->packets[(q->head + q->count - 1) % LOOPBACK_MAX_PACKETS];
+            memset(p->desc.data, (uint8_t)(sum + i), out[i]->size);
+        }
+    }
+    dropJob();
+    return 1;
+}
+
+static void* deviceMain(void* arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&lock);
+    while (deviceRunning) {
+        int handled = 0;
+        streamId_t devMon = findStream("deviceMonitor");
+        streamId_t graphMon = findStream("graphMonitor");
+        loopbackPacket_t* p;
+
+        if (devMon != INVALID_STREAM_ID && (p = peek(&streams[devMon].toDevice, 0)) != NULL) {
+            deviceCommand_t cmd;
+            memcpy(&cmd, p->desc.data, sizeof(cmd));
+            pop(&streams[devMon].toDevice);
+            handleDeviceCommand(devMon, &cmd);
+            handled = 1;
+        }
+        if (graphMon != INVALID_STREAM_ID && (p = peek(&streams[graphMon].toDevice, 0)) != NULL) {
+            graphMonCommand_t cmd;
+            memcpy(&cmd, p->desc.data, sizeof(cmd));
+            pop(&streams[graphMon].toDevice);
+            handleGraphMonitorCommand(graphMon, &cmd);
+            handled = 1;
+        }
+        handled |= runInference();
+
+        if (!handled)
+            waitUntil(now() + 5e-5);
+    }
+    pthread_mutex_unlock(&lock);
+    return NULL;
+}
+
+void loopbackSetLinkDown(int down)
+{
+    pthread_mutex_lock(&lock);
+    linkDown = down;
+    pthread_mutex_unlock(&lock);
+}
+
+//////////////////////////// XLink API ////////////////////////////
+
+XLinkError_t XLinkInitialize(XLinkGlobalHandler_t* handler)
+{
+    (void)handler;
+    latency = envSeconds("LOOPBACK_LATENCY_US", 500);
+    inferTime = envSeconds("LOOPBACK_INFER_US", 200);
+    failEvery = getenv("LOOPBACK_FAIL_EVERY") ? atoi(getenv("LOOPBACK_FAIL_EVERY")) : 0;
+    inputCount = envCount("LOOPBACK_INPUTS", LOOPBACK_MAX_INPUTS);
+    outputCount = envCount("LOOPBACK_OUTPUTS", LOOPBACK_MAX_OUTPUTS);
+    return X_LINK_SUCCESS;
+}
+
+XLinkError_t XLinkGetDeviceName(int index, char* name, int nameSize)
+{
+    if (index != 0)
+        return X_LINK_DEVICE_NOT_FOUND;
+    strncpy(name, "loopback", nameSize);
+    return X_LINK_SUCCESS;
+}
+
+XLinkError_t XLinkBootRemote(const char* deviceName, const char* binaryPath)
+{
+    (void)deviceName;
+    (void)binaryPath;
+    pthread_mutex_lock(&lock);
+    if (!deviceRunning) {
+        memset(streams, 0, sizeof(streams));
+        fifoCount = 0;
+        jobHead = jobCount = 0;
+        triggerCount = 0;
+        deviceBusyUntil = 0;
+        deviceRunning = 1;
+        if (pthread_create(&deviceThread, NULL, deviceMain, NULL)) {
+            deviceRunning = 0;
+            pthread_mutex_unlock(&lock);
+            return X_LINK_ERROR;
+        }
+    }
+    pthread_mutex_unlock(&lock);
+    return X_LINK_SUCCESS;
+}
+
+XLinkError_t XLinkConnect(XLinkHandler_t* handler)
+{
+    handler->linkId = 0;
+    return deviceRunning ? X_LINK_SUCCESS : X_LINK_COMMUNICATION_NOT_OPEN;
+}
+
+XLinkError_t XLinkResetRemote(linkId_t id)
+{
+    (void)id;
+    pthread_mutex_lock(&lock);
+    if (!deviceRunning) {
+        pthread_mutex_unlock(&lock);
+        return X_LINK_SUCCESS;
+    }
+    deviceRunning = 0;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&lock);
+    pthread_join(deviceThread, NULL);
+
+    pthread_mutex_lock(&lock);
+    for (int i = 0; i < LOOPBACK_MAX_STREAMS; i++) {
+        clearQueue(&streams[i].toDevice);
+        clearQueue(&streams[i].toHost);
+        streams[i].used = 0;
+    }
+    pthread_mutex_unlock(&lock);
+    return X_LINK_SUCCESS;
+}
+
+XLinkError_t XLinkResetAll()
+{
+    return XLinkResetRemote(0);
+}
+
+streamId_t XLinkOpenStream(linkId_t id, const char* name, int stream_write_size)
+{
+    (void)id;
+    (void)stream_write_size;
+    pthread_mutex_lock(&lock);
+    streamId_t streamId = findStream(name);
+    for (streamId_t i = 0; streamId == INVALID_STREAM_ID && i < LOOPBACK_MAX_STREAMS; i++) {
+        if (!streams[i].used) {
+            memset(&streams[i], 0, sizeof(streams[i]));
+            strncpy(streams[i].name, name, sizeof(streams[i].name) - 1);
+            streams[i].used = 1;
+            streamId = i;
+        }
+    }
+    pthread_mutex_unlock(&lock);
+    return streamId;
+}
+
+XLinkError_t XLinkCloseStream(streamId_t streamId)
+{
+    if (streamId >= LOOPBACK_MAX_STREAMS)
+        return X_LINK_ERROR;
+    pthread_mutex_lock(&lock);
+    clearQueue(&streams[streamId].toDevice);
+    clearQueue(&streams[streamId].toHost);
+    streams[streamId].used = 0;
+    pthread_mutex_unlock(&lock);
+    return X_LINK_SUCCESS;
+}
+
+XLinkError_t XLinkWriteData(streamId_t streamId, const uint8_t* buffer, int size)
+{
+    if (streamId >= LOOPBACK_MAX_STREAMS)
+        return X_LINK_ERROR;
+    pthread_mutex_lock(&lock);
+    while (deviceRunning && streams[streamId].toDevice.count == LOOPBACK_MAX_PACKETS)
+        waitUntil(now() + latency);
+    int rc = deviceRunning && streams[streamId].used && !linkDown ?
+             push(&streams[streamId].toDevice, buffer, size, now() + latency) : -1;
+    pthread_mutex_unlock(&lock);
+    return rc ? X_LINK_COMMUNICATION_FAIL : X_LINK_SUCCESS;
+}
+
+XLinkError_t XLinkAsyncWriteData(streamId_t streamId, const uint8_t* buffer, int size,
+                                 XLinkWriteCallback_t callback, void* userData,
+                                 XLinkWriteToken_t* token)
+{
+    XLinkError_t rc = XLinkWriteData(streamId, buffer, size);
+    if (rc != X_LINK_SUCCESS)
+        return rc;
+    pthread_mutex_lock(&lock);
+    XLinkWriteToken_t t = ++streams[streamId].asyncWrites;
+    pthread_mutex_unlock(&lock);
+    if (callback)
+        callback(streamId, t, X_LINK_SUCCESS, userData);
+    if (token)
+        *token = t;
+    return X_LINK_SUCCESS;
+}
+
+XLinkError_t XLinkPollWrite(streamId_t streamId, XLinkWriteToken_t token)
+{
+    if (streamId >= LOOPBACK_MAX_STREAMS)
+        return X_LINK_ERROR;
+    pthread_mutex_lock(&lock);
+    int known = token && token <= streams[streamId].asyncWrites;
+    pthread_mutex_unlock(&lock);
+    return known ? X_LINK_SUCCESS : X_LINK_ERROR;
+}
+
+XLinkError_t XLinkWaitWrite(streamId_t streamId, XLinkWriteToken_t token)
+{
+    return XLinkPollWrite(streamId, token);
+}
+
+XLinkError_t XLinkReadData(streamId_t streamId, streamPacketDesc_t** packet)
+{
+    if (streamId >= LOOPBACK_MAX_STREAMS)
+        return X_LINK_ERROR;
+    pthread_mutex_lock(&lock);
+    if (linkDown) {
+        pthread_mutex_unlock(&lock);
+        return X_LINK_COMMUNICATION_FAIL;
+    }
+    loopbackQueue_t* q = &streams[streamId].toHost;
+    loopbackPacket_t* p;
+    while (deviceRunning && (p = peek(q, q->reading)) == NULL) {
+        double deadline = q->reading < q->count ?
+            q->packets[(q->head + q->reading) % LOOPBACK_MAX_PACKETS].deliverTime : now() + latency;
+        waitUntil(deadline);
+    }
+    if (!deviceRunning) {
+        pthread_mutex_unlock(&lock);
+        return X_LINK_COMMUNICATION_NOT_OPEN;
+    }
+    q->reading++;
+    *packet = &p->desc;
+    pthread_mutex_unlock(&lock);
+    return X_LINK_SUCCESS;
+}
+
+XLinkError_t XLinkReleaseData(streamId_t streamId)
+{
+    if (streamId >= LOOPBACK_MAX_STREAMS)
+        return X_LINK_ERROR;
+    pthread_mutex_lock(&lock);
+    loopbackQueue_t* q = &streams[streamId].toHost;
+    if (!q->reading) {
+        pthread_mutex_unlock(&lock);
+        return X_LINK_ERROR;
+    }
+    pop(q);
+    q->reading--;
+    pthread_mutex_unlock(&lock);
+    return X_LINK_SUCCESS;
+}
+
+XLinkError_t XLinkGetFillLevel(streamId_t streamId, int isRemote, int* fillLevel)
+{
+    if (streamId >= LOOPBACK_MAX_STREAMS)
+        return X_LINK_ERROR;
+    pthread_mutex_lock(&lock);
+    loopbackQueue_t* q = isRemote ? &streams[streamId].toDevice : &streams[streamId].toHost;
+    int level = 0;
+    for (int i = 0; i < q->count; i++)
+        level += q->packets[(q->head + i) % LOOPBACK_MAX_PACKETS].desc.length;
+    *fillLevel = level;
+    pthread_mutex_unlock(&lock);
+    return X_LINK_SUCCESS;
+}
@@ -0,0 +1,37 @@
+/*
+* Copyright 2017 Intel Corporation.
+* The source code, information and material ("Material") contained herein is
+* owned by Intel Corporation or its suppliers or licensors, and title to such
+* Material remains with Intel Corporation or its suppliers or licensors.
+* The Material contains proprietary information of Intel or its suppliers and
+* licensors. The Material is protected by worldwide copyright laws and treaty
+* provisions.
+* No part of the Material may be used, copied, reproduced, modified, published,
+* uploaded, posted, transmitted, distributed or disclosed in any way without
+* Intel's prior express written permission. No license under any patent,
+* copyright or other intellectual property rights in the Material is granted to
+* or conferred upon you, either expressly, by implication, inducement, estoppel
+* or otherwise.
+* Any license under such intellectual property rights must be express and
+* approved by Intel in writing.
+*/
+
+///
+/// @brief     Control of the host-side loopback stand-in for the XLink API
+///
+#ifndef _XLINK_LOOPBACK_H
+#define _XLINK_LOOPBACK_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// While the link is down XLinkReadData and XLinkWriteData fail, the queued packets are kept
+void loopbackSetLinkDown(int down);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
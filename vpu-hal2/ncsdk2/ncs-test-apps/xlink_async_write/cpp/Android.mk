@@ -0,0 +1,37 @@
+LOCAL_PATH:= $(call my-dir)
+
+# ==================================
+
+# executable: xlink_async_write
+# the XLink host sources are linked against the in-process USB loopback instead of UsbLinkPlatform.cpp
+$(info LOCAL_PATH =$(LOCAL_PATH))
+include $(CLEAR_VARS)
+
+MVNC_SRC:= ../../../api/src
+MV_COMMON_BASE:= $(LOCAL_PATH)/$(MVNC_SRC)/common
+
+LOCAL_SRC_FILES := \
+	xlink_async_write.c \
+	usb_loopback.c \
+	$(MVNC_SRC)/common/components/XLink/shared/XLink.c \
+	$(MVNC_SRC)/common/components/XLink/shared/XLinkDispatcher.c \
+	$(MVNC_SRC)/common/components/XLink/pc/XLinkEmulator.c \
+	$(MVNC_SRC)/common/components/XLink/pc/XLinkLoopbackTransport.c \
+	$(MVNC_SRC)/common/components/XLink/pc/XLinkSocketTransport.c
+
+LOCAL_MODULE := xlink_async_write
+
+LOCAL_C_INCLUDES += \
+	$(LOCAL_PATH) \
+	$(LOCAL_PATH)/../../../api/include \
+	$(MV_COMMON_BASE)/components/XLink/shared \
+	$(MV_COMMON_BASE)/components/XLink/pc \
+	$(MV_COMMON_BASE)/shared/include
+
+LOCAL_CFLAGS += -D__PC__ -Wno-error
+LOCAL_CFLAGS += -O2 -Wall -pthread -fPIC -MMD -MP -fPIE
+
+LOCAL_SHARED_LIBRARIES := liblog
+LOCAL_STATIC_LIBRARIES :=
+
+include $(BUILD_EXECUTABLE)
@@ -0,0 +1,360 @@
+/*
+* Copyright 2017 Intel Corporation.
+* The source code, information and material ("Material") contained herein is
+* owned by Intel Corporation or its suppliers or licensors, and title to such
+* Material remains with Intel Corporation or its suppliers or licensors.
+* The Material contains proprietary information of Intel or its suppliers and
+* licensors. The Material is protected by worldwide copyright laws and treaty
+* provisions.
+* No part of the Material may be used, copied, reproduced, modified, published,
+* uploaded, posted, transmitted, distributed or disclosed in any way without
+* Intel's prior express written permission. No license under any patent,
+* copyright or other intellectual property rights in the Material is granted to
+* or conferred upon you, either expressly, by implication, inducement, estoppel
+* or otherwise.
+* Any license under such intellectual property rights must be express and
+* approved by Intel in writing.
+*/
+
+
+///
+/// @brief     In-process loopback implementation of the UsbLinkPlatform functions
+///
+/// The XLink host code (XLink.c, XLinkDispatcher.c) runs unchanged on top of it.
+/// A thread plays the remote side of the XLink protocol: it answers pings, stream
+/// creation and writes, logs every write it receives and releases the written
+/// packets after a configurable time, like a device application reading them.
+/// Environment:
+///   USB_LOOPBACK_MBPS - emulated transfer rate of USBLinkWrite, 40 MB/s by default
+///
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "UsbLinkPlatform.h"
+#define _USBLINK_ENABLE_PRIVATE_INCLUDE_
+#include "XLinkPrivateDefines.h"
+#include "usb_loopback.h"
+
+#define PIPE_SIZE (1024 * 1024)
+#define MAX_PENDING_RELEASES 1024
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint8_t data[PIPE_SIZE];
+    int head;
+    int count;
+} bytePipe_t;
+
+static bytePipe_t hostToDevice = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER };
+static bytePipe_t deviceToHost = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER };
+static pthread_mutex_t deviceSendLock = PTHREAD_MUTEX_INITIALIZER;
+
+static double bytesPerUs = 40.0;
+static int releaseUs = 0;
+static int nackEvery = 0;
+static int writeCount = 0;
+static int loopbackFd; // its address is the XLink fd
+
+static pthread_mutex_t logLock = PTHREAD_MUTEX_INITIALIZER;
+static usbLoopbackWrite_t* writeLog;
+static int writeLogSize;
+static int writeLogCount;
+
+// releases scheduled by the device application
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    struct {
+        streamId_t streamId;
+        uint32_t size;
+        struct timespec due;
+    } q[MAX_PENDING_RELEASES];
+    int head;
+    int count;
+} releases = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER };
+
+static void pipeWrite(bytePipe_t* p, const void* data, int size)
+{
+    const uint8_t* src = (const uint8_t*)data;
+    pthread_mutex_lock(&p->lock);
+    while (size) {
+        while (p->count == PIPE_SIZE)
+            pthread_cond_wait(&p->cond, &p->lock);
+        int tail = (p->head + p->count) % PIPE_SIZE;
+        int chunk = PIPE_SIZE - p->count;
+        if (chunk > PIPE_SIZE - tail)
+            chunk = PIPE_SIZE - tail;
+        if (chunk > size)
+            chunk = size;
+        memcpy(p->data + tail, src, chunk);
+        p->count += chunk;
+        src += chunk;
+        size -= chunk;
+        pthread_cond_broadcast(&p->cond);
+    }
+    pthread_mutex_unlock(&p->lock);
+}
+
+static void pipeRead(bytePipe_t* p, void* data, int size)
+{
+    uint8_t* dst = (uint8_t*)data;
+    pthread_mutex_lock(&p->lock);
+    while (size) {
+        while (p->count == 0)
+            pthread_cond_wait(&p->cond, &p->lock);
+        int chunk = p->count;
+        if (chunk > PIPE_SIZE - p->head)
+            chunk = PIPE_SIZE - p->head;
+        if (chunk > size)
+            chunk = size;
+        memcpy(dst, p->data + p->head, chunk);
+        p->head = (p->head + chunk) % PIPE_SIZE;
+        p->count -= chunk;
+        dst += chunk;
+        size -= chunk;
+        pthread_cond_broadcast(&p->cond);
+    }
+    pthread_mutex_unlock(&p->lock);
+}
+
+static void deviceSend(xLinkEventHeader_t* header)
+{
+    pthread_mutex_lock(&deviceSendLock);
+    pipeWrite(&deviceToHost, header, sizeof(*header));
+    pthread_mutex_unlock(&deviceSendLock);
+}
+
+static void deviceRespondAck(xLinkEventHeader_t* request, xLinkEventType_t type, int ack)
+{
+    xLinkEventHeader_t resp = *request;
+    resp.type = type;
+    resp.flags.raw = 0;
+    resp.flags.bitField.ack = ack;
+    resp.flags.bitField.nack = !ack;
+    deviceSend(&resp);
+}
+
+static void deviceRespond(xLinkEventHeader_t* request, xLinkEventType_t type)
+{
+    deviceRespondAck(request, type, 1);
+}
+
+static void scheduleRelease(streamId_t streamId, uint32_t size)
+{
+    pthread_mutex_lock(&releases.lock);
+    if (releases.count == MAX_PENDING_RELEASES) {
+        fprintf(stderr, "usb loopback: too many packets held by the remote\n");
+        exit(1);
+    }
+    int idx = (releases.head + releases.count) % MAX_PENDING_RELEASES;
+    releases.q[idx].streamId = streamId;
+    releases.q[idx].size = size;
+    clock_gettime(CLOCK_MONOTONIC, &releases.q[idx].due);
+    releases.q[idx].due.tv_nsec += releaseUs * 1000L;
+    releases.q[idx].due.tv_sec += releases.q[idx].due.tv_nsec / 1000000000L;
+    releases.q[idx].due.tv_nsec %= 1000000000L;
+    releases.count++;
+    pthread_cond_signal(&releases.cond);
+    pthread_mutex_unlock(&releases.lock);
+}
+
+// the device application: reads and releases the written packets in order
+static void* deviceReleaser(void* ctx)
+{
+    static eventId_t releaseId = 0x40000000;
+    (void)ctx;
+    for (;;) {
+        pthread_mutex_lock(&releases.lock);
+        while (releases.count == 0)
+            pthread_cond_wait(&releases.cond, &releases.lock);
+        struct timespec due = releases.q[releases.head].due;
+        pthread_mutex_unlock(&releases.lock);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, NULL);
+
+        pthread_mutex_lock(&releases.lock);
+        xLinkEventHeader_t rel;
+        memset(&rel, 0, sizeof(rel));
+        rel.type = USB_READ_REL_REQ;
+        rel.id = releaseId++;
+        rel.streamId = releases.q[releases.head].streamId;
+        rel.size = releases.q[releases.head].size;
+        releases.head = (releases.head + 1) % MAX_PENDING_RELEASES;
+        releases.count--;
+        pthread_mutex_unlock(&releases.lock);
+        deviceSend(&rel);
+    }
+    return NULL;
+}
+
+static void* deviceRun(void* ctx)
+{
+    streamId_t nextStreamId = 0;
+    uint8_t* payload = NULL;
+    uint32_t payloadSize = 0;
+    (void)ctx;
+    for (;;) {
+        xLinkEventHeader_t header;
+        pipeRead(&hostToDevice, &header, sizeof(header));
+        switch (header.type) {
+        case USB_PING_REQ:
+            deviceRespond(&header, USB_PING_RESP);
+            break;
+        case USB_CREATE_STREAM_REQ:
+            header.streamId = nextStreamId++;
+            deviceRespond(&header, USB_CREATE_STREAM_RESP);
+            break;
+        case USB_WRITE_REQ:
+            if (header.size > payloadSize) {
+                payload = realloc(payload, header.size);
+                payloadSize = header.size;
+            }
+            pipeRead(&hostToDevice, payload, header.size);
+            if (nackEvery && ++writeCount % nackEvery == 0) {
+                // dropped, the host still counts the packet in the stream until it is released
+                deviceRespondAck(&header, USB_WRITE_RESP, 0);
+                scheduleRelease(header.streamId, header.size);
+                break;
+            }
+            pthread_mutex_lock(&logLock);
+            if (writeLogCount < writeLogSize) {
+                usbLoopbackWrite_t* w = &writeLog[writeLogCount++];
+                w->streamId = header.streamId;
+                w->size = header.size;
+                memcpy(w->head, payload, header.size < sizeof(w->head) ? header.size : sizeof(w->head));
+                w->checksum = 0;
+                for (uint32_t i = 0; i < header.size; i++)
+                    w->checksum = w->checksum * 31 + payload[i];
+            }
+            pthread_mutex_unlock(&logLock);
+            deviceRespond(&header, USB_WRITE_RESP);
+            scheduleRelease(header.streamId, header.size);
+            break;
+        case USB_CLOSE_STREAM_REQ:
+            deviceRespond(&header, USB_CLOSE_STREAM_RESP);
+            break;
+        case USB_RESET_REQ:
+            deviceRespond(&header, USB_RESET_RESP);
+            break;
+        default: // responses to the releases
+            break;
+        }
+    }
+    return NULL;
+}
+
+void usbLoopbackSetWriteLog(usbLoopbackWrite_t* log, int size)
+{
+    pthread_mutex_lock(&logLock);
+    writeLog = log;
+    writeLogSize = size;
+    writeLogCount = 0;
+    pthread_mutex_unlock(&logLock);
+}
+
+int usbLoopbackWriteLogCount()
+{
+    pthread_mutex_lock(&logLock);
+    int count = writeLogCount;
+    pthread_mutex_unlock(&logLock);
+    return count;
+}
+
+void usbLoopbackSetReleaseTime(int us)
+{
+    releaseUs = us;
+}
+
+void usbLoopbackSetNackEvery(int n)
+{
+    writeCount = 0;
+    nackEvery = n;
+}
+
+int USBLinkWrite(void* fd, void* data, int size, unsigned int timeout)
+{
+    (void)fd;
+    (void)timeout;
+    // the transfer occupies the calling thread, like a bulk transfer
+    if (size > (int)sizeof(xLinkEventHeader_t))
+        usleep((useconds_t)(size / bytesPerUs));
+    pipeWrite(&hostToDevice, data, size);
+    return 0;
+}
+
+int USBLinkWritev(void* fd, const xLinkIoVec_t* iov, int iovcnt, unsigned int timeout)
+{
+    for (int i = 0; i < iovcnt; i++)
+        USBLinkWrite(fd, iov[i].data, iov[i].size, timeout);
+    return 0;
+}
+
+int USBLinkRead(void* fd, void* data, int size, unsigned int timeout)
+{
+    (void)fd;
+    (void)timeout;
+    pipeRead(&deviceToHost, data, size);
+    return 0;
+}
+
+int UsbLinkPlatformConnect(const char* devPathRead, const char* devPathWrite, void** fd)
+{
+    static pthread_t device, releaser;
+    (void)devPathRead;
+    (void)devPathWrite;
+    if (pthread_create(&device, NULL, deviceRun, NULL) ||
+        pthread_create(&releaser, NULL, deviceReleaser, NULL))
+        return -1;
+    *fd = &loopbackFd;
+    return 0;
+}
+
+int UsbLinkPlatformInit(int loglevel)
+{
+    (void)loglevel;
+    const char* env = getenv("USB_LOOPBACK_MBPS");
+    if (env && atof(env) > 0)
+        bytesPerUs = atof(env);
+    return 0;
+}
+
+int UsbLinkPlatformGetDeviceName(int index, char* name, int nameSize)
+{
+    if (index != 0)
+        return USB_LINK_PLATFORM_DEVICE_NOT_FOUND;
+    strncpy(name, "usb-loopback", nameSize);
+    return USB_LINK_PLATFORM_SUCCESS;
+}
+
+int UsbLinkPlatformBootRemote(const char* deviceName, const char* binaryPath)
+{
+    (void)deviceName;
+    (void)binaryPath;
+    return 0;
+}
+
+int USBLinkPlatformResetRemote(void* fd)
+{
+    (void)fd;
+    return -1;
+}
+
+void* allocateData(uint32_t size, uint32_t alignment)
+{
+    void* ret = NULL;
+    if (posix_memalign(&ret, alignment, size))
+        return NULL;
+    return ret;
+}
+
+void deallocateData(void* ptr, uint32_t size, uint32_t alignment)
+{
+    (void)size;
+    (void)alignment;
+    free(ptr);
+}
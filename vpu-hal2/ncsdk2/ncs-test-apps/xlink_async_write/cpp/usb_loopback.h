@@ -0,0 +1,56 @@
+/*
+* Copyright 2017 Intel Corporation.
+* The source code, information and material ("Material") contained herein is
+* owned by Intel Corporation or its suppliers or licensors, and title to such
+* Material remains with Intel Corporation or its suppliers or licensors.
+* The Material contains proprietary information of Intel or its suppliers and
+* licensors. The Material is protected by worldwide copyright laws and treaty
+* provisions.
+* No part of the Material may be used, copied, reproduced, modified, published,
+* uploaded, posted, transmitted, distributed or disclosed in any way without
+* Intel's prior express written permission. No license under any patent,
+* copyright or other intellectual property rights in the Material is granted to
+* or conferred upon you, either expressly, by implication, inducement, estoppel
+* or otherwise.
+* Any license under such intellectual property rights must be express and
+* approved by Intel in writing.
+*/
+
+
+///
+/// @brief     Inspection and control of the in-process UsbLinkPlatform loopback
+///
+#ifndef _USB_LOOPBACK_H
+#define _USB_LOOPBACK_H
+
+#include <stdint.h>
+#include "XLinkPublicDefines.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// A write received by the remote side
+typedef struct {
+    streamId_t streamId;  // remote stream id, without the link id
+    uint32_t size;
+    uint8_t head[16];     // first bytes of the data
+    uint32_t checksum;
+} usbLoopbackWrite_t;
+
+// The remote logs the writes it receives in log, at most size of them
+void usbLoopbackSetWriteLog(usbLoopbackWrite_t* log, int size);
+int usbLoopbackWriteLogCount();
+
+// Time the remote application keeps a written packet before releasing it
+void usbLoopbackSetReleaseTime(int us);
+
+// The remote NACKs every n-th write and drops its data, 0 to accept all of them
+void usbLoopbackSetNackEvery(int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,320 @@
+/*
+* Copyright 2017 Intel Corporation.
+* The source code, information and material ("Material") contained herein is
+* owned by Intel Corporation or its suppliers or licensors, and title to such
+* Material remains with Intel Corporation or its suppliers or licensors.
+* The Material contains proprietary information of Intel or its suppliers and
+* licensors. The Material is protected by worldwide copyright laws and treaty
+* provisions.
+* No part of the Material may be used, copied, reproduced, modified, published,
+* uploaded, posted, transmitted, distributed or disclosed in any way without
+* Intel's prior express written permission. No license under any patent,
+* copyright or other intellectual property rights in the Material is granted to
+* or conferred upon you, either expressly, by implication, inducement, estoppel
+* or otherwise.
+* Any license under such intellectual property rights must be express and
+* approved by Intel in writing.
+*/
+
+
+///
+/// @brief     Tests of XLinkAsyncWriteData over the in-process USB loopback
+///
+///   xlink_async_write
+///
+/// Runs the XLink host code against usb_loopback.c and checks that asynchronous
+/// writes return before the transfer, complete in order with the right data,
+/// keep the bytes in flight under the stream write size, reach the remote before
+/// a request queued after them, report the status of old tokens and are flushed
+/// by XLinkCloseStream.
+///
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "XLink.h"
+#include "usb_loopback.h"
+
+#define FRAME_SIZE (64 * 1024)
+#define FRAMES 64
+#define LOG_SIZE 1024
+
+static int failures;
+
+#define EXPECT(cond, ...) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "FAIL %s:%d: ", __FILE__, __LINE__); \
+            fprintf(stderr, __VA_ARGS__); \
+            fprintf(stderr, "\n"); \
+            failures++; \
+        } \
+    } while (0)
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+typedef struct {
+    pthread_mutex_t lock;
+    XLinkWriteToken_t lastToken;
+    int completed;
+    int outOfOrder;
+    int failed;
+    int pending;
+    int maxPending;
+} completions_t;
+
+static void resetCompletions(completions_t* c)
+{
+    pthread_mutex_lock(&c->lock);
+    c->lastToken = 0;
+    c->completed = c->outOfOrder = c->failed = c->pending = c->maxPending = 0;
+    pthread_mutex_unlock(&c->lock);
+}
+
+static void submitted(completions_t* c)
+{
+    pthread_mutex_lock(&c->lock);
+    c->pending++;
+    if (c->pending > c->maxPending)
+        c->maxPending = c->pending;
+    pthread_mutex_unlock(&c->lock);
+}
+
+static void onWrite(streamId_t streamId, XLinkWriteToken_t token, XLinkError_t status, void* userData)
+{
+    completions_t* c = (completions_t*)userData;
+    (void)streamId;
+    pthread_mutex_lock(&c->lock);
+    if (token != c->lastToken + 1)
+        c->outOfOrder++;
+    if (status != X_LINK_SUCCESS)
+        c->failed++;
+    c->lastToken = token;
+    c->completed++;
+    c->pending--;
+    pthread_mutex_unlock(&c->lock);
+}
+
+static completions_t completions = { PTHREAD_MUTEX_INITIALIZER };
+static usbLoopbackWrite_t writeLog[LOG_SIZE];
+static uint8_t* frames[FRAMES];
+
+static uint32_t checksum(const uint8_t* data, uint32_t size)
+{
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < size; i++)
+        sum = sum * 31 + data[i];
+    return sum;
+}
+
+static uint32_t frameSeq(const uint8_t* head)
+{
+    uint32_t seq;
+    memcpy(&seq, head, sizeof(seq));
+    return seq;
+}
+
+static void testOrderAndData(linkId_t link)
+{
+    streamId_t s = XLinkOpenStream(link, "asyncData", 8 * FRAME_SIZE);
+    EXPECT(s != INVALID_STREAM_ID, "can't open stream");
+    resetCompletions(&completions);
+    usbLoopbackSetWriteLog(writeLog, LOG_SIZE);
+
+    XLinkWriteToken_t token = 0;
+    for (int i = 0; i < FRAMES; i++) {
+        submitted(&completions);
+        XLinkError_t rc = XLinkAsyncWriteData(s, frames[i], FRAME_SIZE, onWrite, &completions, &token);
+        EXPECT(rc == X_LINK_SUCCESS, "async write %d failed %d", i, rc);
+        EXPECT(token == (XLinkWriteToken_t)i + 1, "token %u for write %d", token, i);
+    }
+    EXPECT(XLinkWaitWrite(s, token) == X_LINK_SUCCESS, "wait for the last write failed");
+    EXPECT(completions.completed == FRAMES, "%d writes completed", completions.completed);
+    EXPECT(completions.outOfOrder == 0 && completions.failed == 0, "%d out of order, %d failed",
+           completions.outOfOrder, completions.failed);
+
+    int received = usbLoopbackWriteLogCount();
+    EXPECT(received == FRAMES, "remote received %d writes", received);
+    for (int i = 0; i < received && i < FRAMES; i++) {
+        EXPECT(frameSeq(writeLog[i].head) == (uint32_t)i, "remote write %d has frame %u", i, frameSeq(writeLog[i].head));
+        EXPECT(writeLog[i].checksum == checksum(frames[i], FRAME_SIZE), "frame %d corrupted", i);
+    }
+    XLinkCloseStream(s);
+    printf("order and data: %d writes\n", received);
+}
+
+static void testReturnsBeforeTransfer(linkId_t link)
+{
+    streamId_t s = XLinkOpenStream(link, "asyncTime", 8 * FRAME_SIZE);
+    EXPECT(s != INVALID_STREAM_ID, "can't open stream");
+
+    double t0 = now();
+    EXPECT(XLinkWriteData(s, frames[0], FRAME_SIZE) == X_LINK_SUCCESS, "sync write failed");
+    double syncTime = now() - t0;
+
+    XLinkWriteToken_t token;
+    t0 = now();
+    EXPECT(XLinkAsyncWriteData(s, frames[1], FRAME_SIZE, NULL, NULL, &token) == X_LINK_SUCCESS, "async write failed");
+    double asyncTime = now() - t0;
+    XLinkError_t polled = XLinkPollWrite(s, token);
+    EXPECT(polled == X_LINK_TIMEOUT, "write reported %d right after queueing", polled);
+    EXPECT(XLinkWaitWrite(s, token) == X_LINK_SUCCESS, "wait failed");
+    EXPECT(XLinkPollWrite(s, token) == X_LINK_SUCCESS, "completed write polled as %d", XLinkPollWrite(s, token));
+    EXPECT(XLinkPollWrite(s, token + 1) == X_LINK_ERROR, "unknown token accepted");
+    EXPECT(asyncTime * 4 < syncTime, "async write took %.0f us, sync %.0f us", asyncTime * 1e6, syncTime * 1e6);
+    XLinkCloseStream(s);
+    printf("write call: sync %.0f us, async %.0f us\n", syncTime * 1e6, asyncTime * 1e6);
+}
+
+static void testBoundedInFlight(linkId_t link)
+{
+    const int streamFrames = 4;
+    streamId_t s = XLinkOpenStream(link, "asyncBound", streamFrames * FRAME_SIZE);
+    EXPECT(s != INVALID_STREAM_ID, "can't open stream");
+    resetCompletions(&completions);
+    usbLoopbackSetWriteLog(writeLog, LOG_SIZE);
+    // the remote application holds every packet for 5 ms, the stream fills up
+    usbLoopbackSetReleaseTime(5000);
+
+    double t0 = now();
+    XLinkWriteToken_t token = 0;
+    for (int i = 0; i < 32; i++) {
+        submitted(&completions);
+        EXPECT(XLinkAsyncWriteData(s, frames[i], FRAME_SIZE, onWrite, &completions, &token) == X_LINK_SUCCESS,
+               "async write %d failed", i);
+    }
+    double queueTime = now() - t0;
+    EXPECT(XLinkWaitWrite(s, token) == X_LINK_SUCCESS, "wait failed");
+    usbLoopbackSetReleaseTime(0);
+
+    // pending also counts the write waiting to be queued, and a completion
+    // may still be running its callback when the next write is let in
+    EXPECT(completions.maxPending <= streamFrames + 2, "%d writes in flight", completions.maxPending);
+    // the remote frees streamFrames packets every 5 ms
+    EXPECT(queueTime > 0.005 * (32 / streamFrames - 2), "queueing didn't wait, %.1f ms", queueTime * 1e3);
+    int received = usbLoopbackWriteLogCount();
+    for (int i = 0; i < received; i++)
+        EXPECT(frameSeq(writeLog[i].head) == (uint32_t)i, "remote write %d has frame %u", i, frameSeq(writeLog[i].head));
+    EXPECT(completions.outOfOrder == 0 && completions.failed == 0, "%d out of order, %d failed",
+           completions.outOfOrder, completions.failed);
+    XLinkCloseStream(s);
+    printf("bounded: at most %d writes in flight, 32 writes queued in %.1f ms\n",
+           completions.maxPending, queueTime * 1e3);
+}
+
+static void testOrderWithTrigger(linkId_t link)
+{
+    streamId_t input = XLinkOpenStream(link, "asyncInput", 8 * FRAME_SIZE);
+    streamId_t trigger = XLinkOpenStream(link, "asyncTrigger", 64 * 64);
+    EXPECT(input != INVALID_STREAM_ID && trigger != INVALID_STREAM_ID, "can't open streams");
+    usbLoopbackSetWriteLog(writeLog, LOG_SIZE);
+
+    XLinkWriteToken_t token = 0;
+    for (uint32_t i = 0; i < FRAMES; i++) {
+        EXPECT(XLinkAsyncWriteData(input, frames[i], FRAME_SIZE, NULL, NULL, &token) == X_LINK_SUCCESS,
+               "async write %u failed", i);
+        EXPECT(XLinkWriteData(trigger, (const uint8_t*)&i, sizeof(i)) == X_LINK_SUCCESS, "trigger %u failed", i);
+    }
+    EXPECT(XLinkWaitWrite(input, token) == X_LINK_SUCCESS, "wait failed");
+
+    // every trigger must come after the input written before it
+    int received = usbLoopbackWriteLogCount();
+    uint32_t inputs = 0, triggers = 0;
+    for (int i = 0; i < received; i++) {
+        if (writeLog[i].size == FRAME_SIZE) {
+            inputs++;
+        } else {
+            EXPECT(frameSeq(writeLog[i].head) == triggers, "trigger %u out of order", triggers);
+            triggers++;
+            EXPECT(inputs >= triggers, "trigger %u before its input", triggers - 1);
+        }
+    }
+    EXPECT(inputs == FRAMES && triggers == FRAMES, "%u inputs, %u triggers", inputs, triggers);
+    XLinkCloseStream(input);
+    XLinkCloseStream(trigger);
+    printf("ordering: %u inputs and triggers\n", triggers);
+}
+
+static void testOldTokens(linkId_t link)
+{
+    const int nackEvery = 5;
+    streamId_t s = XLinkOpenStream(link, "asyncOld", 8 * FRAME_SIZE);
+    EXPECT(s != INVALID_STREAM_ID, "can't open stream");
+    usbLoopbackSetNackEvery(nackEvery);
+    XLinkWriteToken_t token = 0;
+    for (int i = 0; i < FRAMES; i++)
+        EXPECT(XLinkAsyncWriteData(s, frames[i], FRAME_SIZE, NULL, NULL, &token) == X_LINK_SUCCESS,
+               "async write %d failed", i);
+    XLinkWaitWrite(s, token);
+    usbLoopbackSetNackEvery(0);
+
+    // the slots of the first writes were reused by the later ones
+    int failed = 0;
+    for (XLinkWriteToken_t t = 1; t <= token; t++) {
+        XLinkError_t expected = t % nackEvery == 0 ? X_LINK_COMMUNICATION_FAIL : X_LINK_SUCCESS;
+        XLinkError_t status = XLinkWaitWrite(s, t);
+        EXPECT(status == expected, "write %u reported %d", t, status);
+        failed += status != X_LINK_SUCCESS;
+    }
+    XLinkCloseStream(s);
+    printf("old tokens: %u writes, %d failed\n", token, failed);
+}
+
+static void testCloseFlushes(linkId_t link)
+{
+    streamId_t s = XLinkOpenStream(link, "asyncClose", 4 * FRAME_SIZE);
+    EXPECT(s != INVALID_STREAM_ID, "can't open stream");
+    resetCompletions(&completions);
+    usbLoopbackSetReleaseTime(2000);
+    for (int i = 0; i < 8; i++) {
+        submitted(&completions);
+        EXPECT(XLinkAsyncWriteData(s, frames[i], FRAME_SIZE, onWrite, &completions, NULL) == X_LINK_SUCCESS,
+               "async write %d failed", i);
+    }
+    EXPECT(XLinkCloseStream(s) == X_LINK_SUCCESS, "close failed");
+    usbLoopbackSetReleaseTime(0);
+    EXPECT(completions.completed == 8, "%d writes completed when the stream closed", completions.completed);
+    printf("close: %d writes completed\n", completions.completed);
+}
+
+int main()
+{
+    XLinkGlobalHandler_t ghandler;
+    XLinkHandler_t handler;
+    memset(&ghandler, 0, sizeof(ghandler));
+    memset(&handler, 0, sizeof(handler));
+    handler.devicePath = "usb-loopback";
+    handler.devicePath2 = "usb-loopback";
+
+    for (int i = 0; i < FRAMES; i++) {
+        frames[i] = malloc(FRAME_SIZE);
+        for (int j = 0; j < FRAME_SIZE; j++)
+            frames[i][j] = (uint8_t)(i * 7 + j);
+        memcpy(frames[i], &i, sizeof(i));
+    }
+
+    if (XLinkInitialize(&ghandler) != X_LINK_SUCCESS || XLinkConnect(&handler) != X_LINK_SUCCESS) {
+        fprintf(stderr, "can't connect to the loopback\n");
+        return 1;
+    }
+    linkId_t link = handler.linkId;
+
+    testOrderAndData(link);
+    testReturnsBeforeTransfer(link);
+    testBoundedInFlight(link);
+    testOrderWithTrigger(link);
+    testOldTokens(link);
+    testCloseFlushes(link);
+
+    printf("xlink_async_write: %s (%d failures)\n", failures ? "FAILED" : "PASSED", failures);
+    return failures ? 1 : 0;
+}
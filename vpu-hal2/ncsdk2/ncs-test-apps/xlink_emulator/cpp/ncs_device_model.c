@@ -0,0 +1,546 @@
+/*
+* Copyright 2017 Intel Corporation.
+* The source code, information and material ("Material") contained herein is
+* owned by Intel Corporation or its suppliers or licensors, and title to such
+* Material remains with Intel Corporation or its suppliers or licensors.
+* The Material contains proprietary information of Intel or its suppliers and
+* licensors. The Material is protected by worldwide copyright laws and treaty
+* provisions.
+* No part of the Material may be used, copied, reproduced, modified, published,
+* uploaded, posted, transmitted, distributed or disclosed in any way without
+* Intel's prior express written permission. No license under any patent,
+* copyright or other intellectual property rights in the Material is granted to
+* or conferred upon you, either expressly, by implication, inducement, estoppel
+* or otherwise.
+* Any license under such intellectual property rights must be express and
+* approved by Intel in writing.
+*/
+
+
+///
+/// @brief     Model of the NCS firmware for the XLink device emulator
+///
+/// Answers the mvnc device and graph monitor protocol on top of the emulated XLink
+/// streams and runs the queued graph triggers. Every byte of output j is the sum of
+/// the first bytes of the inputs plus j, so the routing of the tensors can be checked.
+///
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+#include "ncs_device_model.h"
+#include "ncCommPrivate.h"
+
+#define MODEL_MAX_FIFOS 32
+#define MODEL_MAX_GRAPHS 10
+#define MODEL_MAX_JOBS 64
+#define MODEL_MAX_SHAVES 16
+#define MODEL_MAX_INPUTS 3
+#define MODEL_MAX_OUTPUTS 2
+
+#define MODEL_INPUT_C 3
+#define MODEL_OUTPUT_C 1000
+#define MODEL_SSD_PRIORS 1917
+#define MODEL_SSD_CLASSES 21
+#define MODEL_FP16_SIZE 2
+
+#define MODEL_THERMAL_SIZE (100 + sizeof(float))
+#define MODEL_OPT_LIST_SIZE (40 * 50)
+#define MODEL_DEBUG_SIZE 120
+
+// num_shaves of the header of the plugin blobs, after the 34 bytes ELF header
+#define MODEL_BLOB_MAGIC 8708
+#define MODEL_BLOB_MAGIC_OFFSET 34
+#define MODEL_BLOB_SHAVES_OFFSET 50
+
+typedef struct {
+    uint32_t id;
+    uint32_t size;
+    streamId_t stream;
+} modelFifo_t;
+
+typedef struct {
+    uint32_t id;
+    int shaves;
+    float lastInferMs;  // device time of the last inference, the graph timing data
+} modelGraph_t;
+
+typedef struct {
+    uint32_t graph;
+    uint32_t inFifo[MODEL_MAX_INPUTS];
+    uint32_t outFifo[MODEL_MAX_OUTPUTS];
+    int inCount;
+    int outCount;
+    int failed;     // NACKed trigger, its inputs are consumed without an inference
+    uint32_t inRelease[MODEL_MAX_INPUTS]; // elements the host dropped, released before the inputs
+} modelJob_t;
+
+// State of the link being served, only touched by the emulator callbacks
+static ncsDeviceModelConfig_t config;
+static modelFifo_t fifos[MODEL_MAX_FIFOS];
+static int fifoCount;
+static modelGraph_t graphs[MODEL_MAX_GRAPHS];
+static int graphCount;
+static modelJob_t jobs[MODEL_MAX_JOBS];
+static int jobHead, jobCount;
+static uint32_t triggerCount;
+static double shaveBusyUntil[MODEL_MAX_SHAVES];
+static float temperature;
+static double thermalUpdated;   // time of the last temperature update
+static double busyPending;      // inference time scheduled but not yet accounted in the temperature
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Integrates the thermal model up to now
+static void updateTemperature()
+{
+    double t = now();
+    double dt = t - thermalUpdated;
+    if (dt <= 0)
+        return;
+    double busy = busyPending < dt ? busyPending : dt;
+    busyPending -= busy;
+    float target = config.ambientC + (float)(busy / dt) * (config.fullLoadC - config.ambientC);
+    float tau = config.thermalTauS > 0 ? config.thermalTauS : 1e-3f;
+    temperature += (target - temperature) * (float)(1.0 - exp(-dt / tau));
+    thermalUpdated = t;
+}
+
+static int throttlingLevel()
+{
+    if (temperature >= config.throttleHigherC)
+        return 2;
+    return temperature >= config.throttleLowerC ? 1 : 0;
+}
+
+static modelGraph_t* findGraph(uint32_t id)
+{
+    for (int i = 0; i < graphCount; i++) {
+        if (graphs[i].id == id)
+            return &graphs[i];
+    }
+    return NULL;
+}
+
+// Reserves the n shaves which are free first for an inference of inferS seconds,
+// returns when it is done
+static double reserveShaves(int n, double t, double inferS)
+{
+    int picked[MODEL_MAX_SHAVES] = {0};
+    int chosen[MODEL_MAX_SHAVES];
+    double start = t;
+    for (int k = 0; k < n; k++) {
+        int best = -1;
+        for (int s = 0; s < config.shaves; s++) {
+            if (!picked[s] && (best < 0 || shaveBusyUntil[s] < shaveBusyUntil[best]))
+                best = s;
+        }
+        picked[best] = 1;
+        chosen[k] = best;
+        if (shaveBusyUntil[best] > start)
+            start = shaveBusyUntil[best];
+    }
+    for (int k = 0; k < n; k++)
+        shaveBusyUntil[chosen[k]] = start + inferS;
+    return start + inferS;
+}
+
+static modelFifo_t* findFifo(uint32_t id)
+{
+    for (int i = 0; i < fifoCount; i++) {
+        if (fifos[i].id == id)
+            return &fifos[i];
+    }
+    return NULL;
+}
+
+static modelFifo_t* findFifoByStream(streamId_t stream)
+{
+    for (int i = 0; i < fifoCount; i++) {
+        if (fifos[i].stream == stream)
+            return &fifos[i];
+    }
+    return NULL;
+}
+
+static void reply(xLinkEmulator_t* emu, streamId_t id, const void* data, uint32_t length)
+{
+    void* zeros = NULL;
+    if (!data)
+        data = zeros = calloc(1, length);
+    xLinkEmulatorWrite(emu, id, data, length, 0);
+    free(zeros);
+}
+
+static void ack(xLinkEmulator_t* emu, streamId_t id, int value)
+{
+    reply(emu, id, &value, sizeof(value));
+}
+
+static void handleDeviceCommand(xLinkEmulator_t* emu, streamId_t id, const deviceCommand_t* cmd)
+{
+    switch (cmd->type.c0) {
+    case CLASS0_DEVICE_CAPABILITIES: {
+        deviceCapabilities_t caps;
+        memset(&caps, 0, sizeof(caps));
+        caps.max_graphs = 10;
+        caps.max_fifos = MODEL_MAX_FIFOS;
+        caps.max_memory = 512 * 1024 * 1024;
+        caps.max_graph_opt_class = 1;
+        caps.max_executors = 1;
+        caps.fw_version[0] = 2;
+        reply(emu, id, &caps, sizeof(caps));
+        break;
+    }
+    case CLASS0_DEVICE_USED_MEMORY: {
+        uint32_t used = 0;
+        reply(emu, id, &used, sizeof(used));
+        break;
+    }
+    case CLASS0_THERMAL_STATS: {
+        // the throttling level followed by the temperature readings
+        float stats[MODEL_THERMAL_SIZE / sizeof(float)];
+        updateTemperature();
+        stats[0] = (float)throttlingLevel();
+        for (size_t i = 1; i < sizeof(stats) / sizeof(stats[0]); i++)
+            stats[i] = temperature;
+        reply(emu, id, stats, sizeof(stats));
+        break;
+    }
+    case CLASS0_OPT_LIST:
+        reply(emu, id, NULL, MODEL_OPT_LIST_SIZE);
+        break;
+    }
+}
+
+// Returns 0 while the graph file has not arrived yet
+static int allocateGraph(xLinkEmulator_t* emu, streamId_t id, const graphCommand_t* cmd)
+{
+    char name[sizeof(cmd->streamName) + 1];
+    memcpy(name, cmd->streamName, sizeof(cmd->streamName));
+    name[sizeof(cmd->streamName)] = '\0';
+    streamId_t graphStream = xLinkEmulatorFindStream(emu, name);
+    if (graphStream == INVALID_STREAM_ID) {
+        ack(emu, id, 1);
+        return 1;
+    }
+    // The graph file follows the command
+    const streamPacketDesc_t* file = xLinkEmulatorPeek(emu, graphStream, 0);
+    if (!file)
+        return 0;
+    if (graphCount == MODEL_MAX_GRAPHS) {
+        xLinkEmulatorRelease(emu, graphStream);
+        ack(emu, id, 1);
+        return 1;
+    }
+    modelGraph_t* graph = &graphs[graphCount++];
+    graph->id = cmd->id;
+    graph->shaves = config.shaves;
+    graph->lastInferMs = 0;
+    uint32_t magic, shaves;
+    if (file->length >= MODEL_BLOB_SHAVES_OFFSET + sizeof(shaves)) {
+        memcpy(&magic, file->data + MODEL_BLOB_MAGIC_OFFSET, sizeof(magic));
+        memcpy(&shaves, file->data + MODEL_BLOB_SHAVES_OFFSET, sizeof(shaves));
+        if (magic == MODEL_BLOB_MAGIC && shaves >= 1 && shaves <= (uint32_t)config.shaves)
+            graph->shaves = (int)shaves;
+    }
+    xLinkEmulatorRelease(emu, graphStream);
+
+    uint32_t inputSize = MODEL_INPUT_C * config.inputSide * config.inputSide * MODEL_FP16_SIZE;
+    struct tensorDescriptor_t in[MODEL_MAX_INPUTS];
+    for (int i = 0; i < config.inputs; i++) {
+        struct tensorDescriptor_t desc = {1, MODEL_INPUT_C, (uint32_t)config.inputSide,
+                                          (uint32_t)config.inputSide, inputSize};
+        in[i] = desc;
+    }
+    struct tensorDescriptor_t out[MODEL_MAX_OUTPUTS] = {
+        {1, MODEL_OUTPUT_C, 1, 1, MODEL_OUTPUT_C * MODEL_FP16_SIZE}
+    };
+    if (config.outputs == 2) {
+        struct tensorDescriptor_t loc = {1, MODEL_SSD_PRIORS * 4, 1, 1,
+            MODEL_SSD_PRIORS * 4 * MODEL_FP16_SIZE};
+        struct tensorDescriptor_t conf = {1, MODEL_SSD_PRIORS * MODEL_SSD_CLASSES, 1, 1,
+            MODEL_SSD_PRIORS * MODEL_SSD_CLASSES * MODEL_FP16_SIZE};
+        out[0] = loc;
+        out[1] = conf;
+    }
+    uint32_t nstages = 1;
+    reply(emu, graphStream, in, config.inputs * sizeof(in[0]));
+    reply(emu, graphStream, out, config.outputs * sizeof(out[0]));
+    reply(emu, graphStream, &nstages, sizeof(nstages));
+    ack(emu, id, 0);
+    return 1;
+}
+
+static void queueTrigger(xLinkEmulator_t* emu, streamId_t id, const graphCommand_t* trigger)
+{
+    triggerCount++;
+    if (jobCount == MODEL_MAX_JOBS) {
+        ack(emu, id, 1);
+        return;
+    }
+    modelJob_t* job = &jobs[(jobHead + jobCount) % MODEL_MAX_JOBS];
+    job->graph = trigger->id;
+    job->inCount = trigger->inputCount ? trigger->inputCount : 1;
+    job->outCount = trigger->outputCount ? trigger->outputCount : 1;
+    if (job->inCount != config.inputs || job->outCount != config.outputs) {
+        ack(emu, id, 1);
+        return;
+    }
+    int ext = 0;
+    job->inFifo[0] = trigger->buffId1;
+    job->inRelease[0] = trigger->releaseElemBuff1;
+    for (int i = 1; i < job->inCount; i++) {
+        job->inRelease[i] = trigger->releaseElemExt[ext];
+        job->inFifo[i] = trigger->buffIdExt[ext++];
+    }
+    job->outFifo[0] = trigger->buffId2;
+    for (int i = 1; i < job->outCount; i++)
+        job->outFifo[i] = trigger->buffIdExt[ext++];
+    job->failed = config.failEvery && triggerCount % config.failEvery == 0;
+    jobCount++;
+    // Trigger is acked once queued, not when the inference is done
+    ack(emu, id, job->failed);
+}
+
+// Returns 0 if the command has to wait for more data
+static int handleGraphMonitorCommand(xLinkEmulator_t* emu, streamId_t id, const graphMonCommand_t* cmd)
+{
+    switch (cmd->cmdClass) {
+    case GRAPH_MON_CLASS_GRAPH_CMD:
+        if (cmd->cmd.graphCmd.type == GRAPH_ALLOCATE_CMD)
+            return allocateGraph(emu, id, &cmd->cmd.graphCmd);
+        if (cmd->cmd.graphCmd.type == GRAPH_TRIGGER_CMD) {
+            queueTrigger(emu, id, &cmd->cmd.graphCmd);
+        } else {
+            modelGraph_t* graph = findGraph(cmd->cmd.graphCmd.id);
+            if (cmd->cmd.graphCmd.type == GRAPH_DEALLOCATE_CMD && graph)
+                *graph = graphs[--graphCount];
+            ack(emu, id, 0);
+        }
+        break;
+    case GRAPH_MON_CLASS_BUFFER_CMD:
+        if (cmd->cmd.buffCmd.type == BUFFER_ALLOCATE_CMD && fifoCount < MODEL_MAX_FIFOS) {
+            char name[sizeof(cmd->cmd.buffCmd.name) + 1];
+            memcpy(name, cmd->cmd.buffCmd.name, sizeof(cmd->cmd.buffCmd.name));
+            name[sizeof(cmd->cmd.buffCmd.name)] = '\0';
+            fifos[fifoCount].id = cmd->cmd.buffCmd.id;
+            fifos[fifoCount].size = cmd->cmd.buffCmd.desc.totalSize;
+            fifos[fifoCount].stream = xLinkEmulatorFindStream(emu, name);
+            fifoCount++;
+        } else if (cmd->cmd.buffCmd.type == BUFFER_DEALLOCATE_CMD) {
+            // the elements no trigger took are dropped with the buffer, like after a NACKed trigger
+            modelFifo_t* fifo = findFifo(cmd->cmd.buffCmd.id);
+            while (fifo && fifo->stream != INVALID_STREAM_ID && xLinkEmulatorPeek(emu, fifo->stream, 0))
+                xLinkEmulatorRelease(emu, fifo->stream);
+        }
+        ack(emu, id, 0);
+        break;
+    case GRAPH_MON_CLASS_GET_CLASS0:
+        if (cmd->cmd.optionCmd.type.c0 == CLASS0_TIMING_DATA) {
+            // one stage
+            modelGraph_t* graph = findGraph(cmd->cmd.optionCmd.id);
+            float ms = graph ? graph->lastInferMs : 0;
+            reply(emu, id, &ms, sizeof(ms));
+        } else
+            reply(emu, id, NULL, MODEL_DEBUG_SIZE);
+        ack(emu, id, 0);
+        break;
+    default:
+        ack(emu, id, 0);
+        break;
+    }
+    return 1;
+}
+
+static void dropJob()
+{
+    jobHead = (jobHead + 1) % MODEL_MAX_JOBS;
+    jobCount--;
+}
+
+// Runs the oldest queued inference once all its inputs have arrived
+static int runInference(xLinkEmulator_t* emu)
+{
+    if (!jobCount)
+        return 0;
+    modelJob_t* job = &jobs[jobHead];
+    modelFifo_t* in[MODEL_MAX_INPUTS];
+    modelFifo_t* out[MODEL_MAX_OUTPUTS];
+    for (int i = 0; i < job->inCount; i++) {
+        in[i] = findFifo(job->inFifo[i]);
+        if (!in[i] || in[i]->stream == INVALID_STREAM_ID) {
+            dropJob();
+            return 1;
+        }
+    }
+    for (int i = 0; i < job->outCount; i++) {
+        out[i] = findFifo(job->outFifo[i]);
+        if (!out[i] || out[i]->stream == INVALID_STREAM_ID) {
+            dropJob();
+            return 1;
+        }
+    }
+    for (int i = 0; i < job->inCount; i++) {
+        while (job->inRelease[i] && xLinkEmulatorPeek(emu, in[i]->stream, 0)) {
+            xLinkEmulatorRelease(emu, in[i]->stream);
+            job->inRelease[i]--;
+        }
+        if (job->inRelease[i])
+            return 0;
+    }
+    uint8_t sum = 0;
+    for (int i = 0; i < job->inCount; i++) {
+        const streamPacketDesc_t* p = xLinkEmulatorPeek(emu, in[i]->stream, 0);
+        if (!p)
+            return 0;
+        sum += p->length ? p->data[0] : 0;
+    }
+    for (int i = 0; i < job->inCount; i++)
+        xLinkEmulatorRelease(emu, in[i]->stream);
+    if (job->failed) {
+        dropJob();
+        return 1;
+    }
+
+    // the inference runs on the shaves of its graph as soon as they are free, the outputs
+    // are sent when it is done, a throttled device runs at half or a quarter of its speed
+    double t = now();
+    updateTemperature();
+    modelGraph_t* graph = findGraph(job->graph);
+    int shaves = graph ? graph->shaves : config.shaves;
+    double inferS = config.inferUs * 1e-6 * (1 << throttlingLevel()) *
+        ((1 - config.shaveParallelFraction) + config.shaveParallelFraction * config.shaves / shaves);
+    busyPending += inferS * shaves / config.shaves;
+    if (graph)
+        graph->lastInferMs = (float)(inferS * 1e3);
+    int delayUs = (int)((reserveShaves(shaves, t, inferS) - t) * 1e6);
+    for (int i = 0; i < job->outCount; i++) {
+        uint8_t* data = malloc(out[i]->size);
+        if (!data)
+            continue;
+        memset(data, (uint8_t)(sum + i), out[i]->size);
+        xLinkEmulatorWrite(emu, out[i]->stream, data, out[i]->size, delayUs);
+        free(data);
+    }
+    dropJob();
+    return 1;
+}
+
+// Releases the packets of the input FIFOs which are not tensors, like the message
+// stopping the FIFO thread of the firmware
+static void dropMessages(xLinkEmulator_t* emu)
+{
+    for (int i = 0; i < fifoCount; i++) {
+        const streamPacketDesc_t* p;
+        while (fifos[i].stream != INVALID_STREAM_ID &&
+               (p = xLinkEmulatorPeek(emu, fifos[i].stream, 0)) != NULL &&
+               p->length != fifos[i].size)
+            xLinkEmulatorRelease(emu, fifos[i].stream);
+    }
+}
+
+static void processCommands(xLinkEmulator_t* emu)
+{
+    streamId_t devMon = xLinkEmulatorFindStream(emu, "deviceMonitor");
+    streamId_t graphMon = xLinkEmulatorFindStream(emu, "graphMonitor");
+    const streamPacketDesc_t* p;
+
+    while (devMon != INVALID_STREAM_ID && (p = xLinkEmulatorPeek(emu, devMon, 0)) != NULL) {
+        deviceCommand_t cmd;
+        memcpy(&cmd, p->data, sizeof(cmd));
+        xLinkEmulatorRelease(emu, devMon);
+        handleDeviceCommand(emu, devMon, &cmd);
+    }
+    while (graphMon != INVALID_STREAM_ID && (p = xLinkEmulatorPeek(emu, graphMon, 0)) != NULL) {
+        graphMonCommand_t cmd;
+        memcpy(&cmd, p->data, sizeof(cmd));
+        if (!handleGraphMonitorCommand(emu, graphMon, &cmd))
+            break;
+        xLinkEmulatorRelease(emu, graphMon);
+    }
+    do {
+        dropMessages(emu);
+    } while (runInference(emu));
+}
+
+static void modelConnected(void* ctx, xLinkEmulator_t* emu)
+{
+    (void)ctx;
+    (void)emu;
+    fifoCount = 0;
+    jobHead = jobCount = 0;
+    triggerCount = 0;
+    graphCount = 0;
+    memset(shaveBusyUntil, 0, sizeof(shaveBusyUntil));
+    busyPending = 0;
+    thermalUpdated = now();
+}
+
+static void modelDataWritten(void* ctx, xLinkEmulator_t* emu, streamId_t id)
+{
+    (void)ctx;
+    (void)id;
+    processCommands(emu);
+}
+
+static void modelStreamClosed(void* ctx, xLinkEmulator_t* emu, streamId_t id)
+{
+    (void)ctx;
+    (void)emu;
+    modelFifo_t* fifo = findFifoByStream(id);
+    if (fifo)
+        fifo->stream = INVALID_STREAM_ID;
+}
+
+static float envFloat(const char* name, float def)
+{
+    const char* value = getenv(name);
+    return value && *value ? (float)atof(value) : def;
+}
+
+void ncsDeviceModelDefaultConfig(ncsDeviceModelConfig_t* cfg)
+{
+    cfg->inferUs = 200;
+    cfg->failEvery = 0;
+    cfg->inputs = 1;
+    cfg->outputs = 1;
+    cfg->inputSide = 32;
+    cfg->shaves = MODEL_MAX_SHAVES;
+    cfg->shaveParallelFraction = 0.8f;
+    cfg->ambientC = envFloat("NCS_MODEL_AMBIENT_C", 40.f);
+    cfg->fullLoadC = envFloat("NCS_MODEL_FULL_LOAD_C", 85.f);
+    cfg->thermalTauS = envFloat("NCS_MODEL_THERMAL_TAU_S", 20.f);
+    cfg->throttleLowerC = envFloat("NCS_MODEL_THROTTLE_LOWER_C", 70.f);
+    cfg->throttleHigherC = envFloat("NCS_MODEL_THROTTLE_HIGHER_C", 80.f);
+}
+
+void ncsDeviceModelInit(xLinkDeviceModel_t* model, const ncsDeviceModelConfig_t* cfg)
+{
+    config = *cfg;
+    if (config.inputs < 1 || config.inputs > MODEL_MAX_INPUTS)
+        config.inputs = 1;
+    if (config.outputs < 1 || config.outputs > MODEL_MAX_OUTPUTS)
+        config.outputs = 1;
+    if (config.inputSide < 1)
+        config.inputSide = 32;
+    if (config.shaves < 1 || config.shaves > MODEL_MAX_SHAVES)
+        config.shaves = MODEL_MAX_SHAVES;
+    if (config.shaveParallelFraction < 0 || config.shaveParallelFraction > 1)
+        config.shaveParallelFraction = 0.8f;
+    // the device keeps its temperature across links, it starts idle
+    temperature = config.ambientC;
+    thermalUpdated = now();
+    memset(model, 0, sizeof(*model));
+    model->connected = modelConnected;
+    model->dataWritten = modelDataWritten;
+    model->streamClosed = modelStreamClosed;
+}
@@ -0,0 +1,68 @@
+/*
+* Copyright 2017 Intel Corporation.
+* The source code, information and material ("Material") contained herein is
+* owned by Intel Corporation or its suppliers or licensors, and title to such
+* Material remains with Intel Corporation or its suppliers or licensors.
+* The Material contains proprietary information of Intel or its suppliers and
+* licensors. The Material is protected by worldwide copyright laws and treaty
+* provisions.
+* No part of the Material may be used, copied, reproduced, modified, published,
+* uploaded, posted, transmitted, distributed or disclosed in any way without
+* Intel's prior express written permission. No license under any patent,
+* copyright or other intellectual property rights in the Material is granted to
+* or conferred upon you, either expressly, by implication, inducement, estoppel
+* or otherwise.
+* Any license under such intellectual property rights must be express and
+* approved by Intel in writing.
+*/
+
+
+///
+/// @brief     Model of the NCS firmware for the XLink device emulator
+///
+#ifndef _NCS_DEVICE_MODEL_H
+#define _NCS_DEVICE_MODEL_H
+
+#include "XLinkEmulator.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct {
+    int inferUs;        // inference time on all the shaves
+    int failEvery;      // every n-th graph trigger is NACKed, 0 for never
+    int inputs;         // number of graph inputs, at most 3
+    int outputs;        // number of graph outputs, 1 (1000 classes) or 2 (SSD heads)
+    int inputSide;      // the inputs are 3 x side x side FP16 tensors
+    // SHAVE model: an inference takes inferUs on all the shaves of the device, and
+    // inferUs * ((1 - p) + p * shaves / n) on n shaves, p being shaveParallelFraction.
+    // Inferences of co-resident graphs run concurrently while they have enough free shaves.
+    int shaves;
+    float shaveParallelFraction;
+    // First order thermal model: the temperature moves towards
+    // ambientC + load * (fullLoadC - ambientC) with the time constant thermalTauS,
+    // load being the busy fraction of the device since the previous update
+    float ambientC;
+    float fullLoadC;
+    float thermalTauS;
+    float throttleLowerC;   // TEMP_LIM_LOWER: throttling level 1, inferences take 2x longer
+    float throttleHigherC;  // TEMP_LIM_HIGHER: throttling level 2, inferences take 4x longer
+} ncsDeviceModelConfig_t;
+
+// Default configuration: 200 us inferences, one 3x32x32 input and one output,
+// 16 shaves, 80% of the inference time scaling with the shaves,
+// 40 C idle, 85 C under full load, 20 s time constant, throttling at 70 and 80 C.
+// The thermal parameters can be overridden with NCS_MODEL_AMBIENT_C, NCS_MODEL_FULL_LOAD_C,
+// NCS_MODEL_THERMAL_TAU_S, NCS_MODEL_THROTTLE_LOWER_C and NCS_MODEL_THROTTLE_HIGHER_C.
+void ncsDeviceModelDefaultConfig(ncsDeviceModelConfig_t* config);
+
+// Fills model with the callbacks of the NCS model, which serves one link at a time
+void ncsDeviceModelInit(xLinkDeviceModel_t* model, const ncsDeviceModelConfig_t* config);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
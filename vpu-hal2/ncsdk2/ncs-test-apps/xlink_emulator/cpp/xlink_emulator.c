@@ -0,0 +1,173 @@
+/*
+* Copyright 2017 Intel Corporation.
+* The source code, information and material ("Material") contained herein is
+* owned by Intel Corporation or its suppliers or licensors, and title to such
+* Material remains with Intel Corporation or its suppliers or licensors.
+* The Material contains proprietary information of Intel or its suppliers and
+* licensors. The Material is protected by worldwide copyright laws and treaty
+* provisions.
+* No part of the Material may be used, copied, reproduced, modified, published,
+* uploaded, posted, transmitted, distributed or disclosed in any way without
+* Intel's prior express written permission. No license under any patent,
+* copyright or other intellectual property rights in the Material is granted to
+* or conferred upon you, either expressly, by implication, inducement, estoppel
+* or otherwise.
+* Any license under such intellectual property rights must be express and
+* approved by Intel in writing.
+*/
+
+
+///
+/// @brief     Emulator of a Neural Compute Stick behind a UNIX socket
+///
+/// Serves the hosts connecting with the XLink socket transport one at a time,
+/// with the NCS device model on top of the emulated link:
+///
+///   xlink_emulator [-s <socket path>] [-b <MB/s>] [-l <latency us>] [-e <nack every>]
+///                  [-x <disconnect after>] [-i <inference us>] [-f <fail every>]
+///                  [-r <input side>] [-c <connections>] [-t <boot ms>]
+///
+/// The link options default to the XLINK_EMU_* environment variables.
+///
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "XLinkEmulator.h"
+#include "XLinkSocketTransport.h"
+#include "UsbLinkPlatform.h"
+#include "ncs_device_model.h"
+
+static int socketRead(void* channel, void* data, int size)
+{
+    int fd = *(int*)channel;
+    char* dst = (char*)data;
+    while (size > 0) {
+        ssize_t rc = recv(fd, dst, size, 0);
+        if (rc < 0 && errno == EINTR)
+            continue;
+        if (rc <= 0)
+            return -1;
+        dst += rc;
+        size -= rc;
+    }
+    return 0;
+}
+
+static int socketWrite(void* channel, const void* data, int size)
+{
+    int fd = *(int*)channel;
+    const char* src = (const char*)data;
+    while (size > 0) {
+        ssize_t rc = send(fd, src, size, MSG_NOSIGNAL);
+        if (rc < 0 && errno == EINTR)
+            continue;
+        if (rc <= 0)
+            return -1;
+        src += rc;
+        size -= rc;
+    }
+    return 0;
+}
+
+static void socketClose(void* channel)
+{
+    shutdown(*(int*)channel, SHUT_RDWR);
+}
+
+static void usage()
+{
+    printf("Usage: xlink_emulator [-s <socket path>] [-b <MB/s>] [-l <latency us>] [-e <nack every>]\n"
+           "                      [-x <disconnect after>] [-i <inference us>] [-f <fail every>]\n"
+           "                      [-r <input side>] [-c <connections>] [-t <boot ms>]\n");
+}
+
+int main(int argc, char** argv)
+{
+    const char* path = XLINK_SOCKET_DEFAULT_PATH;
+    int connections = 0;
+    xLinkEmulatorConfig_t link;
+    ncsDeviceModelConfig_t device;
+    xLinkEmulatorConfigFromEnv(&link);
+    ncsDeviceModelDefaultConfig(&device);
+
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc || argv[i][0] != '-' || strlen(argv[i]) != 2) {
+            usage();
+            return -1;
+        }
+        const char* value = argv[i + 1];
+        switch (argv[i][1]) {
+        case 's': path = value; break;
+        case 'b': link.bandwidth = atof(value); break;
+        case 'l': link.latencyUs = atoi(value); break;
+        case 'e': link.nackEvery = atoi(value); break;
+        case 'x': link.disconnectAfter = atoi(value); break;
+        case 'i': device.inferUs = atoi(value); break;
+        case 'f': device.failEvery = atoi(value); break;
+        case 'r': device.inputSide = atoi(value); break;
+        case 'c': connections = atoi(value); break;
+        case 't': link.bootMs = atoi(value); break;
+        default:
+            usage();
+            return -1;
+        }
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        printf("Socket path too long: %s\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path);
+    if (server < 0 || bind(server, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(server, 1) < 0) {
+        perror(path);
+        return -1;
+    }
+
+    xLinkDeviceModel_t model;
+    ncsDeviceModelInit(&model, &device);
+    printf("xlink_emulator on %s: %.1f MB/s, %d us latency, NACK every %d writes, disconnect after %d packets\n",
+           path, link.bandwidth, link.latencyUs, link.nackEvery, link.disconnectAfter);
+    fflush(stdout);
+
+    for (int served = 0; !connections || served < connections; served++) {
+        int fd = accept(server, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR)
+                continue;
+            perror("accept");
+            break;
+        }
+        // like the USB endpoints, the socket buffers hold about one packet
+        int bufferSize = PACKET_LENGTH;
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof(bufferSize));
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+
+        xLinkEmulatorChannel_t channel = { socketRead, socketWrite, socketClose, &fd };
+        xLinkEmulator_t* emu = xLinkEmulatorStart(&channel, &link, &model);
+        if (!emu) {
+            close(fd);
+            continue;
+        }
+        printf("host connected\n");
+        fflush(stdout);
+        xLinkEmulatorWait(emu);
+        xLinkEmulatorStop(emu);
+        close(fd);
+        printf("link closed\n");
+        fflush(stdout);
+    }
+    close(server);
+    unlink(path);
+    return 0;
+}
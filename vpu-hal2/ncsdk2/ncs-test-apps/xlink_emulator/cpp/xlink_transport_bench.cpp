@@ -0,0 +1,191 @@
+// Copyright 2017 Intel Corporation.
+// The source code, information and material ("Material") contained herein is
+// owned by Intel Corporation or its suppliers or licensors, and title to such
+// Material remains with Intel Corporation or its suppliers or licensors.
+// The Material contains proprietary information of Intel or its suppliers and
+// licensors. The Material is protected by worldwide copyright laws and treaty
+// provisions.
+// No part of the Material may be used, copied, reproduced, modified, published,
+// uploaded, posted, transmitted, distributed or disclosed in any way without
+// Intel's prior express written permission. No license under any patent,
+// copyright or other intellectual property rights in the Material is granted to
+// or conferred upon you, either expressly, by implication, inducement, estoppel
+// or otherwise.
+// Any license under such intellectual property rights must be express and
+// approved by Intel in writing.
+
+
+// Throughput and latency of inferences through the whole NC API and XLink host
+// stack, on top of the loopback or the socket XLink transport:
+//
+//   XLINK_TRANSPORT=loopback xlink_transport_bench [-n <inferences>] [-d <elements in flight>]
+//                            [-i <inference us>] [-f <fail every>] [-r <input side>]
+//   XLINK_TRANSPORT=socket xlink_transport_bench [-n <inferences>] [-d <elements in flight>]
+//
+// With the loopback transport the NCS device model runs in-process with the link
+// characteristics of the XLINK_EMU_* environment variables, the socket transport
+// connects to a running xlink_emulator which has its own options.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include <mvnc.h>
+#include "XLinkLoopbackTransport.h"
+#include "ncs_device_model.h"
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+#define CHECK(call) \
+    do { \
+        ncStatus_t rc_ = (call); \
+        if (rc_ != NC_OK) { \
+            printf("Error - %s returned %d\n", #call, rc_); \
+            exit(-1); \
+        } \
+    } while (0)
+
+// Returns 1 if the inference of the element has failed
+static int readOutput(struct fifoHandle_t *fifoOut, int index, const std::vector<double>& queued,
+                      std::vector<double>& latency)
+{
+    void *output, *userParam;
+    struct ncTensorDescriptor_t desc;
+    ncStatus_t rc = ncFifoReadElem(fifoOut, &output, &desc, &userParam);
+    if (rc == NC_MYRIAD_ERROR)
+        return 1;
+    if (rc != NC_OK) {
+        printf("Error - ncFifoReadElem returned %d\n", rc);
+        exit(-1);
+    }
+    if ((size_t)userParam != (size_t)index) {
+        printf("Error - element %d returned user param %zu\n", index, (size_t)userParam);
+        exit(-1);
+    }
+    latency.push_back(now() - queued[index]);
+    return 0;
+}
+
+static double percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+    size_t i = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[i];
+}
+
+static void usage()
+{
+    printf("Usage: xlink_transport_bench [-n <inferences>] [-d <elements in flight>]\n"
+           "                             [-i <inference us>] [-f <fail every>] [-r <input side>]\n");
+}
+
+int main(int argc, char** argv)
+{
+    int count = 1000;
+    int depth = 4;
+    ncsDeviceModelConfig_t device;
+    ncsDeviceModelDefaultConfig(&device);
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc || argv[i][0] != '-' || strlen(argv[i]) != 2) {
+            usage();
+            return -1;
+        }
+        int value = atoi(argv[i + 1]);
+        switch (argv[i][1]) {
+        case 'n': count = value; break;
+        case 'd': depth = value; break;
+        case 'i': device.inferUs = value; break;
+        case 'f': device.failEvery = value; break;
+        case 'r': device.inputSide = value; break;
+        default:
+            usage();
+            return -1;
+        }
+    }
+    if (count < 1 || depth < 1) {
+        usage();
+        return -1;
+    }
+
+    // only used with the loopback transport
+    xLinkDeviceModel_t model;
+    ncsDeviceModelInit(&model, &device);
+    XLinkLoopbackSetDevice(&model, NULL);
+
+    int loglevel = 2;
+    CHECK(ncGlobalSetOption(NC_RW_LOG_LEVEL, &loglevel, sizeof(loglevel)));
+    CHECK(ncGlobalSetOption(NC_RW_MAX_PENDING_TRIGGERS, &depth, sizeof(depth)));
+
+    struct deviceHandle_t *deviceHandle;
+    struct graphHandle_t *graph;
+    CHECK(ncDeviceInit(0, &deviceHandle));
+    CHECK(ncDeviceOpen(deviceHandle));
+
+    char blob[64] = {0};
+    CHECK(ncGraphInit("bench", &graph));
+    CHECK(ncGraphAllocate(deviceHandle, graph, blob, sizeof(blob)));
+
+    struct ncTensorDescriptor_t *inDesc, *outDesc;
+    unsigned int length;
+    CHECK(ncGraphGetOption(graph, NC_OPTION_CLASS0, NC_RO_GRAPH_INPUT_TENSOR_DESCRIPTORS, &inDesc, &length));
+    CHECK(ncGraphGetOption(graph, NC_OPTION_CLASS0, NC_RO_GRAPH_OUTPUT_TENSOR_DESCRIPTORS, &outDesc, &length));
+
+    struct fifoHandle_t *fifoIn, *fifoOut;
+    CHECK(ncFifoInit(NC_FIFO_HOST_WO, &fifoIn));
+    CHECK(ncFifoInit(NC_FIFO_HOST_RO, &fifoOut));
+    CHECK(ncFifoCreate(fifoIn, deviceHandle, inDesc, depth));
+    CHECK(ncFifoCreate(fifoOut, deviceHandle, outDesc, depth));
+
+    // the inputs are FP32, converted to the FP16 tensor of the graph
+    std::vector<float> input(inDesc->totalSize / 2);
+    std::vector<double> queued(count), latency;
+    latency.reserve(count);
+    int failed = 0;
+    std::deque<int> inFlight;
+    double start = now();
+    for (int i = 0; i < count; i++) {
+        queued[i] = now();
+        ncStatus_t rc = ncGraphQueueInferenceWithFifoElem(graph, &fifoIn, &fifoOut, input.data(), NULL,
+                                                          (void*)(size_t)i);
+        // A NACKed input write fails only the inference of the element
+        if (rc == NC_ERROR) {
+            failed++;
+            continue;
+        }
+        CHECK(rc);
+        inFlight.push_back(i);
+        // Keep depth inferences in flight
+        if ((int)inFlight.size() == depth) {
+            failed += readOutput(fifoOut, inFlight.front(), queued, latency);
+            inFlight.pop_front();
+        }
+    }
+    while (!inFlight.empty()) {
+        failed += readOutput(fifoOut, inFlight.front(), queued, latency);
+        inFlight.pop_front();
+    }
+    double elapsed = now() - start;
+
+    std::sort(latency.begin(), latency.end());
+    printf("%d inferences, %d in flight, %u byte inputs: %.1f inferences/s, %.1f MB/s to the device\n",
+           count, depth, inDesc->totalSize, count / elapsed, count * inDesc->totalSize / elapsed / 1e6);
+    printf("latency: p50 %.3f ms, p99 %.3f ms, max %.3f ms, %d failed inferences\n",
+           percentile(latency, 0.5) * 1e3, percentile(latency, 0.99) * 1e3,
+           latency.empty() ? 0 : latency.back() * 1e3, failed);
+
+    CHECK(ncFifoDelete(fifoIn));
+    CHECK(ncFifoDelete(fifoOut));
+    CHECK(ncGraphDeallocate(graph));
+    CHECK(ncDeviceClose(deviceHandle));
+    return 0;
+}
@@ -0,0 +1,33 @@
+LOCAL_PATH:= $(call my-dir)
+
+# ==================================
+
+# executable: xlink_transfer_bench
+# libmvnc with the transport selected by XLINK_TRANSPORT, the device model is the one of xlink_emulator
+$(info LOCAL_PATH =$(LOCAL_PATH))
+include $(CLEAR_VARS)
+
+MVNC_SRC:= ../../../api/src
+MV_COMMON_BASE:= $(LOCAL_PATH)/$(MVNC_SRC)/common
+
+LOCAL_SRC_FILES := \
+	xlink_transfer_bench.cpp \
+	../../xlink_emulator/cpp/ncs_device_model.c
+
+LOCAL_MODULE := xlink_transfer_bench
+
+LOCAL_C_INCLUDES += \
+	$(LOCAL_PATH) \
+	$(LOCAL_PATH)/../../xlink_emulator/cpp \
+	$(LOCAL_PATH)/../../../api/include \
+	$(MV_COMMON_BASE)/components/XLink/shared \
+	$(MV_COMMON_BASE)/components/XLink/pc \
+	$(MV_COMMON_BASE)/shared/include
+
+LOCAL_CFLAGS += -D__PC__ -Wno-error
+LOCAL_CFLAGS += -O2 -Wall -pthread -fPIC -MMD -MP -fPIE
+
+LOCAL_SHARED_LIBRARIES := libmvnc liblog
+LOCAL_STATIC_LIBRARIES :=
+
+include $(BUILD_EXECUTABLE)
@@ -0,0 +1,186 @@
+// Copyright 2017 Intel Corporation.
+// The source code, information and material ("Material") contained herein is
+// owned by Intel Corporation or its suppliers or licensors, and title to such
+// Material remains with Intel Corporation or its suppliers or licensors.
+// The Material contains proprietary information of Intel or its suppliers and
+// licensors. The Material is protected by worldwide copyright laws and treaty
+// provisions.
+// No part of the Material may be used, copied, reproduced, modified, published,
+// uploaded, posted, transmitted, distributed or disclosed in any way without
+// Intel's prior express written permission. No license under any patent,
+// copyright or other intellectual property rights in the Material is granted to
+// or conferred upon you, either expressly, by implication, inducement, estoppel
+// or otherwise.
+// Any license under such intellectual property rights must be express and
+// approved by Intel in writing.
+
+
+// Reports the MB/s and the per transfer latency achieved by the XLink transport
+// with graph uploads and inference tensors:
+//
+//   xlink_transfer_bench [-g <graph file>] [-s <graph MB>] [-u <uploads>]
+//                        [-n <inferences>] [-d <elements in flight>] [-r <input side>]
+//
+// On the Neural Compute Stick a compiled graph has to be given with -g. With the
+// emulated transports (XLINK_TRANSPORT=loopback or socket, see xlink_emulator) a
+// graph of -s MB, 8 by default, is uploaded when there is no graph file.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#include <mvnc.h>
+#include "XLink.h"
+#include "XLinkLoopbackTransport.h"
+#include "ncs_device_model.h"
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+#define CHECK(call) \
+    do { \
+        ncStatus_t rc_ = (call); \
+        if (rc_ != NC_OK) { \
+            printf("Error - %s returned %d\n", #call, rc_); \
+            exit(-1); \
+        } \
+    } while (0)
+
+static bool readGraph(const char* path, std::vector<char>& graph)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f)
+        return false;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    graph.resize(size > 0 ? size : 0);
+    bool ok = size > 0 && fread(graph.data(), 1, size, f) == (size_t)size;
+    fclose(f);
+    return ok;
+}
+
+static void usage()
+{
+    printf("Usage: xlink_transfer_bench [-g <graph file>] [-s <graph MB>] [-u <uploads>]\n"
+           "                            [-n <inferences>] [-d <elements in flight>] [-r <input side>]\n");
+}
+
+int main(int argc, char** argv)
+{
+    const char* graphPath = NULL;
+    int graphMB = 8;
+    int uploads = 4;
+    int count = 200;
+    int depth = 2;
+    ncsDeviceModelConfig_t device;
+    ncsDeviceModelDefaultConfig(&device);
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc || argv[i][0] != '-' || strlen(argv[i]) != 2) {
+            usage();
+            return -1;
+        }
+        const char* value = argv[i + 1];
+        switch (argv[i][1]) {
+        case 'g': graphPath = value; break;
+        case 's': graphMB = atoi(value); break;
+        case 'u': uploads = atoi(value); break;
+        case 'n': count = atoi(value); break;
+        case 'd': depth = atoi(value); break;
+        case 'r': device.inputSide = atoi(value); break;
+        default:
+            usage();
+            return -1;
+        }
+    }
+    if (graphMB < 1 || uploads < 1 || count < 1 || depth < 1) {
+        usage();
+        return -1;
+    }
+
+    std::vector<char> graphFile;
+    if (graphPath) {
+        if (!readGraph(graphPath, graphFile)) {
+            printf("Can't read %s\n", graphPath);
+            return -1;
+        }
+    } else {
+        graphFile.resize(graphMB * 1024 * 1024);
+    }
+
+    // only used with the loopback transport
+    xLinkDeviceModel_t model;
+    ncsDeviceModelInit(&model, &device);
+    XLinkLoopbackSetDevice(&model, NULL);
+
+    int loglevel = 2;
+    CHECK(ncGlobalSetOption(NC_RW_LOG_LEVEL, &loglevel, sizeof(loglevel)));
+
+    struct deviceHandle_t *deviceHandle;
+    struct graphHandle_t *graph;
+    CHECK(ncDeviceInit(0, &deviceHandle));
+    CHECK(ncDeviceOpen(deviceHandle));
+
+    // graph uploads, one large write each
+    XLinkProfStart();
+    double start = now();
+    for (int i = 0; i < uploads; i++) {
+        CHECK(ncGraphInit("bench", &graph));
+        CHECK(ncGraphAllocate(deviceHandle, graph, graphFile.data(), graphFile.size()));
+        if (i + 1 < uploads)
+            CHECK(ncGraphDeallocate(graph));
+    }
+    double elapsed = now() - start;
+    XLinkProfStop();
+    printf("\n%d graph uploads of %.1f MB: %.1f MB/s including the allocations\n",
+           uploads, graphFile.size() / 1048576.0, uploads * graphFile.size() / elapsed / 1048576.0);
+    XLinkProfPrint();
+
+    struct ncTensorDescriptor_t *inDesc, *outDesc;
+    unsigned int length;
+    CHECK(ncGraphGetOption(graph, NC_OPTION_CLASS0, NC_RO_GRAPH_INPUT_TENSOR_DESCRIPTORS, &inDesc, &length));
+    CHECK(ncGraphGetOption(graph, NC_OPTION_CLASS0, NC_RO_GRAPH_OUTPUT_TENSOR_DESCRIPTORS, &outDesc, &length));
+
+    struct fifoHandle_t *fifoIn, *fifoOut;
+    CHECK(ncFifoInit(NC_FIFO_HOST_WO, &fifoIn));
+    CHECK(ncFifoInit(NC_FIFO_HOST_RO, &fifoOut));
+    CHECK(ncFifoCreate(fifoIn, deviceHandle, inDesc, depth));
+    CHECK(ncFifoCreate(fifoOut, deviceHandle, outDesc, depth));
+
+    // inference tensors, FP32 inputs converted to the FP16 tensor of the graph
+    std::vector<float> input(inDesc->totalSize / 2);
+    XLinkProfStart();
+    start = now();
+    int read = 0;
+    for (int i = 0; i < count; i++) {
+        CHECK(ncGraphQueueInferenceWithFifoElem(graph, &fifoIn, &fifoOut, input.data(), NULL, NULL));
+        if (i + 1 - read == depth) {
+            void *output, *userParam;
+            struct ncTensorDescriptor_t desc;
+            CHECK(ncFifoReadElem(fifoOut, &output, &desc, &userParam));
+            read++;
+        }
+    }
+    for (; read < count; read++) {
+        void *output, *userParam;
+        struct ncTensorDescriptor_t desc;
+        CHECK(ncFifoReadElem(fifoOut, &output, &desc, &userParam));
+    }
+    elapsed = now() - start;
+    XLinkProfStop();
+    printf("\n%d inferences of %u byte inputs and %u byte outputs: %.1f inferences/s\n",
+           count, inDesc->totalSize, outDesc->totalSize, count / elapsed);
+    XLinkProfPrint();
+
+    CHECK(ncFifoDelete(fifoIn));
+    CHECK(ncFifoDelete(fifoOut));
+    CHECK(ncGraphDeallocate(graph));
+    CHECK(ncDeviceClose(deviceHandle));
+    return 0;
+}